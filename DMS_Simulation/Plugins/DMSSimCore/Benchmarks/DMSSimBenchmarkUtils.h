@@ -0,0 +1,145 @@
+#pragma once
+
+// Shared inputs of the DMSSimCoreLib benchmarks: scenario files from Benchmarks/Scenarios and synthetic ground truth frames.
+// DMSSIM_SCENARIO_DIR and DMSSIM_CONFIG_PATH are set by Benchmarks/CMakeLists.txt.
+
+#include <memory>
+#include <random>
+#include <streambuf>
+#include <string>
+#include "DMSSimConfig.h"
+#include "DMSSimConfigParser.h"
+#include "DMSSimScenarioParser.h"
+
+namespace DMSSimBenchmark {
+
+constexpr int FACIAL_LANDMARK_COUNT = 68;
+constexpr int BOUNDING_BOX_3D_CORNER_COUNT = 8;
+constexpr int PUPIL_IRIS_LANDMARK_COUNT = 9;
+constexpr int OCCUPANT_COUNT = 2;
+
+/** Full path of a benchmark scenario, e.g. GetScenarioPath(L"Ada.yml") */
+inline std::wstring GetScenarioPath(const wchar_t* const Name) { return std::wstring(DMSSIM_SCENARIO_DIR) + L"/" + Name; }
+
+inline const DMSSimConfigParser& GetConfig() {
+	static const std::unique_ptr<DMSSimConfigParser> Config(DMSSimConfigParser::Create(DMSSIM_CONFIG_PATH));
+	return *Config;
+}
+
+/** Stream buffer that drops the output and counts the bytes, so the benchmarks measure formatting rather than the disk. */
+class CountingBuffer : public std::streambuf {
+public:
+	size_t GetCount() const { return Count_; }
+
+protected:
+	int_type overflow(int_type Char) override {
+		++Count_;
+		return traits_type::not_eof(Char);
+	}
+	std::streamsize xsputn(const char_type*, std::streamsize Count) override {
+		Count_ += size_t(Count);
+		return Count;
+	}
+
+private:
+	size_t Count_ = 0;
+};
+
+inline FVector RandomVector(std::mt19937& Random, const float Scale) {
+	std::uniform_real_distribution<float> Distribution(-Scale, Scale);
+	return FVector(Distribution(Random), Distribution(Random), Distribution(Random));
+}
+
+inline FVector2D RandomPixel(std::mt19937& Random) {
+	std::uniform_real_distribution<float> Distribution(0.0f, 1000.0f);
+	return FVector2D(Distribution(Random), Distribution(Random));
+}
+
+inline DMSSimGroundTruthOccupant MakeOccupant(std::mt19937& Random) {
+	DMSSimGroundTruthOccupant Occupant = {};
+	Occupant.Initialized = true;
+	FVector* const Points[] = {
+		&Occupant.NosePoint, &Occupant.LEarPoint, &Occupant.REarPoint, &Occupant.LeftEyePoint, &Occupant.RightEyePoint,
+		&Occupant.LeftGazeOrigin_inCam, &Occupant.RightGazeOrigin_inCam, &Occupant.GazeOrigin_inCam,
+		&Occupant.LeftGazeOrigin_inCar, &Occupant.RightGazeOrigin_inCar, &Occupant.GazeOrigin_inCar,
+		&Occupant.HeadOriginEyesCenter_inCam, &Occupant.HeadOriginEarsCenter_inCam, &Occupant.HeadOriginEyesCenter_inCar, &Occupant.HeadOriginEarsCenter_inCar,
+		&Occupant.LeftShoulderPoint, &Occupant.RightShoulderPoint, &Occupant.LeftElbowPoint, &Occupant.RightElbowPoint,
+		&Occupant.LeftWristPoint, &Occupant.RightWristPoint, &Occupant.LeftPinkyKnucklePoint, &Occupant.RightPinkyKnucklePoint,
+		&Occupant.LeftIndexKnucklePoint, &Occupant.RightIndexKnucklePoint, &Occupant.LeftThumbKnucklePoint, &Occupant.RightThumbKnucklePoint,
+		&Occupant.LeftHipPoint, &Occupant.RightHipPoint, &Occupant.LeftKneePoint, &Occupant.RightKneePoint,
+		&Occupant.LeftAnklePoint, &Occupant.RightAnklePoint, &Occupant.LeftHeelPoint, &Occupant.RightHeelPoint,
+		&Occupant.LeftFootIndexPoint, &Occupant.RightFootIndexPoint,
+	};
+	for (auto* const Point : Points) { *Point = RandomVector(Random, 100.0f); }
+	FVector* const Directions[] = {
+		&Occupant.LeftGazeDirection_inCam, &Occupant.RightGazeDirection_inCam, &Occupant.GazeDirection_inCam,
+		&Occupant.LeftGazeDirection_inCar, &Occupant.RightGazeDirection_inCar, &Occupant.GazeDirection_inCar,
+		&Occupant.HeadDirection_inCam, &Occupant.HeadDirection_inCar,
+	};
+	for (auto* const Direction : Directions) { *Direction = RandomVector(Random, 1.0f).GetSafeNormal(); }
+	Occupant.HeadRotation_inCam = FRotator(10.0f, -20.0f, 5.0f);
+	Occupant.HeadRotation_inCar = FRotator(-5.0f, 15.0f, 2.0f);
+	Occupant.HorizontalMouthOpening = 2.5f;
+	Occupant.VerticalMouthOpening = 0.5f;
+
+	for (int i = 0; i < FACIAL_LANDMARK_COUNT; ++i) {
+		Occupant.FacialLandmarksVisible.Add(i % 7 != 0);
+		Occupant.FacialLandmarks3D_inCam.Add(RandomVector(Random, 100.0f));
+		Occupant.FacialLandmarks2D.Add(RandomPixel(Random));
+	}
+	for (int i = 0; i < BOUNDING_BOX_3D_CORNER_COUNT; ++i) { Occupant.FaceBoundingBox3D_inCam.Add(RandomVector(Random, 100.0f)); }
+	Occupant.FaceBoundingBox3DVisible = true;
+	Occupant.FaceBoundingBox2DVisible = true;
+	Occupant.FaceBoundingBox2D = { RandomPixel(Random), 200.0f, 250.0f };
+	Occupant.RightEyeBoundingBox2DVisible = true;
+	Occupant.RightEyeBoundingBox2D = { RandomPixel(Random), 40.0f, 20.0f };
+	Occupant.LeftEyeBoundingBox2DVisible = true;
+	Occupant.LeftEyeBoundingBox2D = { RandomPixel(Random), 40.0f, 20.0f };
+	for (int i = 0; i < PUPIL_IRIS_LANDMARK_COUNT; ++i) {
+		Occupant.RightEyePupilLandmarks2D.Add(RandomPixel(Random));
+		Occupant.RightEyeIrisLandmarks2D.Add(RandomPixel(Random));
+		Occupant.LeftEyePupilLandmarks2D.Add(RandomPixel(Random));
+		Occupant.LeftEyeIrisLandmarks2D.Add(RandomPixel(Random));
+	}
+	for (int i = 0; i < 4 * PUPIL_IRIS_LANDMARK_COUNT; ++i) { Occupant.PupilIrisLandmarksVisible.Add(i % 5 != 0); }
+	Occupant.LeftEyeOpening = Occupant.RightEyeOpening = 0.9f;
+	Occupant.LeftEyeLidVisibilityPerc = Occupant.RightEyeLidVisibilityPerc = 95.0f;
+	Occupant.LeftEyePupilVisibilityPerc = Occupant.RightEyePupilVisibilityPerc = 80.0f;
+	return Occupant;
+}
+
+/** Scenario constants with a driver and a front passenger. */
+inline DMSSimGroundTruthScenarioConstantsPtr MakeGroundTruthScenario() {
+	const auto Scenario = MakeShared<DMSSimGroundTruthScenarioConstants, ESPMode::ThreadSafe>();
+	Scenario->VersionMajor = 1;
+	Scenario->Description = "benchmark";
+	Scenario->Environment = "Urban";
+	Scenario->CarModel = "VW_Touareg";
+	Scenario->Camera.FOV = 45.0f;
+	Scenario->Camera.FrameSize = FIntPoint(1312, 1008);
+	Scenario->Camera.FrameRate = 60;
+	Scenario->Camera.Position_inCar = FVector(20.0f, 0.0f, 110.0f);
+	Scenario->Camera.Rotation_inCar = FRotator(-10.0f, 180.0f, 0.0f);
+	Scenario->OccupantCount = OCCUPANT_COUNT;
+	const FDMSSimOccupantType Types[OCCUPANT_COUNT] = { FDMSSimOccupantType::Driver, FDMSSimOccupantType::PassengerFront };
+	for (const auto Type : Types) {
+		FDMSSimOccupant Occupant;
+		Occupant.Type = Type;
+		Occupant.Character = TEXT("Ada");
+		Scenario->Occupants.Add(Occupant);
+	}
+	return Scenario;
+}
+
+/** A frame of the MakeGroundTruthScenario scenario, filled with random but plausible values. */
+inline TSharedPtr<DMSSimGroundTruthFrame> MakeGroundTruthFrame(const uint32_t Seed) {
+	std::mt19937 Random(Seed);
+	TSharedPtr<DMSSimGroundTruthFrame> Frame = MakeShareable(new DMSSimGroundTruthFrame());
+	Frame->Scenario = MakeGroundTruthScenario();
+	Frame->Data.CarPosition_inWorld = FVector(100.0f, 200.0f, 0.0f);
+	Frame->Data.CarRotation_inWorld = FRotator(0.0f, 30.0f, 0.0f);
+	for (const auto& Occupant : Frame->Scenario->Occupants) { Frame->Data.Occupants[static_cast<uint8>(Occupant.Type)] = MakeOccupant(Random); }
+	return Frame;
+}
+
+} // namespace DMSSimBenchmark
@@ -0,0 +1,100 @@
+// Benchmark of the ground truth snapshot the renderer takes on every frame.
+// BM_SnapshotLegacy copies the frame with the scenario data in it twice, for the ground truth writer and the labelers, as before.
+// BM_SnapshotPooled takes one frame from DMSSimGroundTruthFramePool, which shares the scenario constants.
+// The bytes_per_frame counter is the number of bytes copied per rendered frame.
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include "DMSSimBenchmarkUtils.h"
+#include "DMSSimGroundTruthFrameLegacy.h"
+#include "DMSSimGroundTruthFramePool.h"
+
+namespace {
+
+constexpr int SNAPSHOTS_PER_FRAME_LEGACY = 2;
+constexpr size_t POOLED_FRAMES = 4;
+
+template <typename T> size_t GetHeapSize(const TArray<T>& Array) { return size_t(Array.Num()) * sizeof(T); }
+
+size_t GetHeapSize(const FString& String) { return size_t(String.Len()) * sizeof(TCHAR); }
+
+template <typename T, int32 Capacity> void CopyArray(const DMSSimFixedArray<T, Capacity>& Source, TArray<T>& Target) {
+	for (const auto& Value : Source) { Target.Add(Value); }
+}
+
+/** The legacy frame with the scenario and the landmarks of Frame, the scalar values are left zero. */
+DMSSimGroundTruthFrameLegacy MakeLegacyFrame(const DMSSimGroundTruthFrame& Frame) {
+	DMSSimGroundTruthFrameLegacy Legacy = {};
+	const auto& Scenario = Frame.GetScenario();
+	Legacy.Common.VersionMajor = Scenario.VersionMajor;
+	Legacy.Common.Description = Scenario.Description;
+	Legacy.Common.Environment = Scenario.Environment;
+	Legacy.Common.CarModel = Scenario.CarModel;
+	Legacy.Common.Camera = Scenario.Camera;
+	Legacy.Common.CarPosition_inWorld = Frame.Data.CarPosition_inWorld;
+	Legacy.Common.CarRotation_inWorld = Frame.Data.CarRotation_inWorld;
+	Legacy.Common.OccupantCount = Scenario.OccupantCount;
+	Legacy.Common.Occupants = Scenario.Occupants;
+	for (const auto& Occupant : Scenario.Occupants) {
+		const auto Type = static_cast<uint8>(Occupant.Type);
+		const auto& Source = Frame.Data.Occupants[Type];
+		auto& Target = Legacy.Occupants[Type];
+		Target.Initialized = Source.Initialized;
+		CopyArray(Source.FacialLandmarksVisible, Target.FacialLandmarksVisible);
+		CopyArray(Source.FacialLandmarks3D_inCam, Target.FacialLandmarks3D_inCam);
+		CopyArray(Source.FacialLandmarks2D, Target.FacialLandmarks2D);
+		CopyArray(Source.FaceBoundingBox3D_inCam, Target.FaceBoundingBox3D_inCam);
+		CopyArray(Source.RightEyePupilLandmarks2D, Target.RightEyePupilLandmarks2D);
+		CopyArray(Source.RightEyeIrisLandmarks2D, Target.RightEyeIrisLandmarks2D);
+		CopyArray(Source.LeftEyePupilLandmarks2D, Target.LeftEyePupilLandmarks2D);
+		CopyArray(Source.LeftEyeIrisLandmarks2D, Target.LeftEyeIrisLandmarks2D);
+		CopyArray(Source.PupilIrisLandmarksVisible, Target.PupilIrisLandmarksVisible);
+	}
+	return Legacy;
+}
+
+/** Bytes copied with the legacy frame: the struct and the heap blocks of its arrays. The short strings fit into the std::string objects. */
+size_t GetCopiedBytes(const DMSSimGroundTruthFrameLegacy& Frame) {
+	size_t Bytes = sizeof(Frame) + GetHeapSize(Frame.Common.Occupants);
+	for (const auto& Occupant : Frame.Common.Occupants) {
+		Bytes += GetHeapSize(Occupant.Character) + GetHeapSize(Occupant.Uppercloth) + GetHeapSize(Occupant.IrisColor);
+	}
+	for (const auto& Occupant : Frame.Occupants) {
+		Bytes += GetHeapSize(Occupant.FacialLandmarksVisible) + GetHeapSize(Occupant.FacialLandmarks3D_inCam) + GetHeapSize(Occupant.FacialLandmarks2D)
+			+ GetHeapSize(Occupant.FaceBoundingBox3D_inCam) + GetHeapSize(Occupant.RightEyePupilLandmarks2D) + GetHeapSize(Occupant.RightEyeIrisLandmarks2D)
+			+ GetHeapSize(Occupant.LeftEyePupilLandmarks2D) + GetHeapSize(Occupant.LeftEyeIrisLandmarks2D) + GetHeapSize(Occupant.PupilIrisLandmarksVisible);
+	}
+	return Bytes;
+}
+
+void SetBytesPerFrame(benchmark::State& State, const size_t BytesPerFrame) {
+	State.counters["bytes_per_frame"] = double(BytesPerFrame);
+	State.SetBytesProcessed(int64_t(State.iterations() * BytesPerFrame));
+}
+
+void BM_SnapshotLegacy(benchmark::State& State) {
+	const auto Source = MakeLegacyFrame(*DMSSimBenchmark::MakeGroundTruthFrame(42));
+	for (auto _ : State) {
+		for (int i = 0; i < SNAPSHOTS_PER_FRAME_LEGACY; ++i) {
+			const auto Snapshot = MakeShared<DMSSimGroundTruthFrameLegacy, ESPMode::ThreadSafe>(Source);
+			benchmark::DoNotOptimize(Snapshot.Get());
+		}
+	}
+	SetBytesPerFrame(State, SNAPSHOTS_PER_FRAME_LEGACY * GetCopiedBytes(Source));
+}
+BENCHMARK(BM_SnapshotLegacy);
+
+void BM_SnapshotPooled(benchmark::State& State) {
+	const auto Source = DMSSimBenchmark::MakeGroundTruthFrame(42);
+	DMSSimGroundTruthFramePool Pool(POOLED_FRAMES);
+	for (auto _ : State) {
+		const auto Snapshot = Pool.Acquire(*Source);
+		benchmark::DoNotOptimize(Snapshot.Get());
+	}
+	SetBytesPerFrame(State, sizeof(DMSSimGroundTruthFrame));
+}
+BENCHMARK(BM_SnapshotPooled);
+
+} // anonymous namespace
+
+BENCHMARK_MAIN();
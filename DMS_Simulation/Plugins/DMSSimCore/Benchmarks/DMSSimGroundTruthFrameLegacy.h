@@ -0,0 +1,113 @@
+#pragma once
+
+#include "DMSSimConfig.h"
+
+// The ground truth frame before the split into the shared scenario constants and the per frame data,
+// the baseline of the ground truth frame benchmark. The renderer copied it twice per frame, for the ground truth writer and the labelers.
+
+struct DMSSimGroundTruthCommonLegacy
+{
+	int32 ScenarioIdx;
+	int32 ScenariosCount;
+	int32 VersionMajor;
+	int32 VersionMinor;
+	std::string Description;
+	std::string Environment;
+	bool RandomMovements;
+	std::string CarModel;
+	float CarSpeed;
+	DMSSimSunLight SunLight;
+	DMSCamera Camera;
+	DMSSimCustomLight CameraLight;
+	DMSBlendoutDefaults BlendoutDefaults;
+	FVector  CarPosition_inWorld;
+	FRotator CarRotation_inWorld;
+	int	OccupantCount;
+	TArray<FDMSSimOccupant> Occupants;
+	DMSGroundTruthSettings GroundTruthSettings;
+};
+
+struct DMSSimGroundTruthOccupantLegacy
+{
+	bool     Initialized;
+	FVector  NosePoint;
+	FVector  LEarPoint;
+	FVector  REarPoint;
+	FVector  LeftEyePoint;
+	FVector  RightEyePoint;
+	FVector  LeftGazeOrigin_inCam;
+	FVector  RightGazeOrigin_inCam;
+	FVector  GazeOrigin_inCam;
+	FVector  LeftGazeDirection_inCam;
+	FVector  RightGazeDirection_inCam;
+	FVector  GazeDirection_inCam;
+	FVector  LeftGazeOrigin_inCar;
+	FVector  RightGazeOrigin_inCar;
+	FVector  GazeOrigin_inCar;
+	FVector  LeftGazeDirection_inCar;
+	FVector  RightGazeDirection_inCar;
+	FVector  GazeDirection_inCar;
+	FVector  HeadOriginEyesCenter_inCam;
+	FVector  HeadOriginEarsCenter_inCam;
+	FVector  HeadDirection_inCam;
+	FRotator HeadRotation_inCam;
+	FVector  HeadOriginEyesCenter_inCar;
+	FVector  HeadOriginEarsCenter_inCar;
+	FVector  HeadDirection_inCar;
+	FRotator HeadRotation_inCar;
+	FVector  LeftShoulderPoint;
+	FVector  RightShoulderPoint;
+	FVector  LeftElbowPoint;
+	FVector  RightElbowPoint;
+	FVector  LeftWristPoint;
+	FVector  RightWristPoint;
+	FVector  LeftPinkyKnucklePoint;
+	FVector  RightPinkyKnucklePoint;
+	FVector  LeftIndexKnucklePoint;
+	FVector  RightIndexKnucklePoint;
+	FVector  LeftThumbKnucklePoint;
+	FVector  RightThumbKnucklePoint;
+	FVector  LeftHipPoint;
+	FVector  RightHipPoint;
+	FVector  LeftKneePoint;
+	FVector  RightKneePoint;
+	FVector  LeftAnklePoint;
+	FVector  RightAnklePoint;
+	FVector  LeftHeelPoint;
+	FVector  RightHeelPoint;
+	FVector  LeftFootIndexPoint;
+	FVector  RightFootIndexPoint;
+
+	float    HorizontalMouthOpening;
+	float    VerticalMouthOpening;
+
+	TArray<bool> FacialLandmarksVisible;
+	TArray<FVector> FacialLandmarks3D_inCam;
+	TArray<FVector2D> FacialLandmarks2D;
+	bool FaceBoundingBox3DVisible;
+	TArray<FVector> FaceBoundingBox3D_inCam;
+	bool FaceBoundingBox2DVisible;
+	FDMSBoundingBox2D FaceBoundingBox2D;
+	bool RightEyeBoundingBox2DVisible;
+	FDMSBoundingBox2D RightEyeBoundingBox2D;
+	bool LeftEyeBoundingBox2DVisible;
+	FDMSBoundingBox2D LeftEyeBoundingBox2D;
+	TArray<FVector2D> RightEyePupilLandmarks2D;
+	TArray<FVector2D> RightEyeIrisLandmarks2D;
+	TArray<FVector2D> LeftEyePupilLandmarks2D;
+	TArray<FVector2D> LeftEyeIrisLandmarks2D;
+	TArray<bool> PupilIrisLandmarksVisible;
+
+	float LeftEyeOpening;
+	float RightEyeOpening;
+	float LeftEyeLidVisibilityPerc;
+	float RightEyeLidVisibilityPerc;
+	float LeftEyePupilVisibilityPerc;
+	float RightEyePupilVisibilityPerc;
+};
+
+struct DMSSimGroundTruthFrameLegacy
+{
+	DMSSimGroundTruthCommonLegacy Common;
+	DMSSimGroundTruthOccupantLegacy Occupants[static_cast<size_t>(FDMSSimOccupantType::PassengerCount)];
+};
@@ -0,0 +1,148 @@
+// Benchmark of the ground truth CSV formatting. The rows go to a counting stream buffer, so the disk is not measured.
+// The *Legacy benchmarks run the iostream based recorder from DMSSimGroundTruthRecorderLegacy.cpp for comparison.
+// BM_ComputeOccupants measures the conversion of the occupants alone, the items are occupants.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ostream>
+#include <sstream>
+#include "DMSSimBenchmarkUtils.h"
+#include "DMSSimGroundTruthColumnarWriter.h"
+#include "DMSSimGroundTruthRecorder.h"
+#include "DMSSimGroundTruthRecorderLegacy.h"
+
+namespace {
+
+constexpr int COMPARED_FRAME_COUNT = 20;
+constexpr double COMPARED_TOLERANCE = 1e-5; // relative to values above 1
+
+typedef void (*AddHeaderFunc)(std::ostream& Stream);
+typedef void (*AddFrameFunc)(std::ostream& Stream, double Time, const DMSSimGroundTruthFrame& Frame);
+
+std::string RecordFrames(const AddHeaderFunc AddHeader, const AddFrameFunc AddFrame) {
+	std::ostringstream Stream;
+	AddHeader(Stream);
+	for (int i = 0; i < COMPARED_FRAME_COUNT; ++i) {
+		const auto Frame = DMSSimBenchmark::MakeGroundTruthFrame(uint32_t(i));
+		AddFrame(Stream, 3599.0 + i * 0.137, *Frame);
+	}
+	return Stream.str();
+}
+
+/** The value of a quoted CSV field, the fields of the time and the counters are compared as text. */
+bool ParseField(const std::string& Field, double& Value) {
+	const std::string Text = Field.size() >= 2 && Field.front() == '"' ? Field.substr(1, Field.size() - 2) : Field;
+	char* End = nullptr;
+	Value = std::strtod(Text.c_str(), &End);
+	return !Text.empty() && *End == '\0';
+}
+
+/**
+ * The benchmarks only compare like with like if both recorders write the same file. The values are converted
+ * with one matrix per frame instead of the separate steps of the legacy recorder, so they may differ in the last digits.
+ */
+bool IsOutputEquivalent() {
+	const std::string Output = RecordFrames(DMSSimGroundTruthRecorder::AddHeader, DMSSimGroundTruthRecorder::AddFrame);
+	const std::string LegacyOutput = RecordFrames(DMSSimGroundTruthRecorderLegacy::AddHeader, DMSSimGroundTruthRecorderLegacy::AddFrame);
+	std::istringstream Lines(Output);
+	std::istringstream LegacyLines(LegacyOutput);
+	std::string Line, LegacyLine;
+	for (size_t LineNo = 1; std::getline(LegacyLines, LegacyLine); ++LineNo) {
+		if (!std::getline(Lines, Line)) {
+			std::fprintf(stderr, "Ground truth output has no line %zu\n", LineNo);
+			return false;
+		}
+		std::istringstream Fields(Line);
+		std::istringstream LegacyFields(LegacyLine);
+		std::string Field, LegacyField;
+		for (size_t Column = 0; std::getline(LegacyFields, LegacyField, ';'); ++Column) {
+			const bool HasField = bool(std::getline(Fields, Field, ';'));
+			double Value = 0.0, LegacyValue = 0.0;
+			if (HasField && (Field == LegacyField || (LineNo > 1 && ParseField(Field, Value) && ParseField(LegacyField, LegacyValue) &&
+				std::abs(Value - LegacyValue) <= COMPARED_TOLERANCE * std::max(1.0, std::abs(LegacyValue))))) { continue; }
+			std::fprintf(stderr, "Ground truth output differs from the legacy recorder in line %zu, column %zu:\n  new:    %s\n  legacy: %s\n",
+				LineNo, Column, HasField ? Field.c_str() : "", LegacyField.c_str());
+			return false;
+		}
+		if (std::getline(Fields, Field, ';')) {
+			std::fprintf(stderr, "Ground truth output has more columns than the legacy recorder in line %zu\n", LineNo);
+			return false;
+		}
+	}
+	return !std::getline(Lines, Line);
+}
+
+template <AddHeaderFunc AddHeader>
+void BM_AddHeader(benchmark::State& State) {
+	DMSSimBenchmark::CountingBuffer Buffer;
+	std::ostream Stream(&Buffer);
+	for (auto _ : State) { AddHeader(Stream); }
+	State.SetBytesProcessed(int64_t(Buffer.GetCount()));
+}
+BENCHMARK_TEMPLATE(BM_AddHeader, DMSSimGroundTruthRecorder::AddHeader)->Name("BM_AddHeader");
+BENCHMARK_TEMPLATE(BM_AddHeader, DMSSimGroundTruthRecorderLegacy::AddHeader)->Name("BM_AddHeaderLegacy");
+
+template <AddFrameFunc AddFrame>
+void BM_AddFrame(benchmark::State& State) {
+	const auto Frame = DMSSimBenchmark::MakeGroundTruthFrame(42);
+	DMSSimBenchmark::CountingBuffer Buffer;
+	std::ostream Stream(&Buffer);
+	double Time = 0.0;
+	for (auto _ : State) {
+		AddFrame(Stream, Time, *Frame);
+		Time += 1.0 / 60.0;
+	}
+	// items are rows, so the rows per second of both recorders can be read off directly
+	State.SetItemsProcessed(int64_t(State.iterations()));
+	State.SetBytesProcessed(int64_t(Buffer.GetCount()));
+}
+BENCHMARK_TEMPLATE(BM_AddFrame, DMSSimGroundTruthRecorder::AddFrame)->Name("BM_AddFrame");
+BENCHMARK_TEMPLATE(BM_AddFrame, DMSSimGroundTruthRecorderLegacy::AddFrame)->Name("BM_AddFrameLegacy");
+
+typedef size_t (*ComputeOccupantsFunc)(double Time, const DMSSimGroundTruthFrame& Frame);
+
+/** The conversion of the occupants' points into the base coordinate space, without the formatting. */
+template <ComputeOccupantsFunc ComputeOccupants>
+void BM_ComputeOccupants(benchmark::State& State) {
+	const auto Frame = DMSSimBenchmark::MakeGroundTruthFrame(42);
+	size_t Occupants = 0;
+	double Time = 0.0;
+	for (auto _ : State) {
+		Occupants += ComputeOccupants(Time, *Frame);
+		Time += 1.0 / 60.0;
+	}
+	State.SetItemsProcessed(int64_t(Occupants));
+}
+BENCHMARK_TEMPLATE(BM_ComputeOccupants, DMSSimGroundTruthRecorder::ComputeOccupants)->Name("BM_ComputeOccupants");
+BENCHMARK_TEMPLATE(BM_ComputeOccupants, DMSSimGroundTruthRecorderLegacy::ComputeOccupants)->Name("BM_ComputeOccupantsLegacy");
+
+void BM_AddFrameColumnar(benchmark::State& State) {
+	const auto Frame = DMSSimBenchmark::MakeGroundTruthFrame(42);
+	DMSSimBenchmark::CountingBuffer Buffer;
+	std::ostream Stream(&Buffer);
+	DMSSimGroundTruthColumnarWriter Writer(Stream);
+	DMSSimGroundTruthRecorder::AddHeader(Writer);
+	double Time = 0.0;
+	for (auto _ : State) {
+		DMSSimGroundTruthRecorder::AddFrame(Writer, Time, *Frame);
+		Time += 1.0 / 60.0;
+	}
+	Writer.Flush();
+	State.SetItemsProcessed(int64_t(State.iterations()));
+	State.SetBytesProcessed(int64_t(Buffer.GetCount()));
+}
+BENCHMARK(BM_AddFrameColumnar);
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+	if (!IsOutputEquivalent()) { return 1; }
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv)) { return 1; }
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
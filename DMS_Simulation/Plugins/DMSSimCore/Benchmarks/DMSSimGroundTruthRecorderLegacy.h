@@ -0,0 +1,11 @@
+#pragma once
+
+#include "DMSSimConfig.h"
+#include <ostream>
+
+/** The iostream based ground truth recorder before the column plan, the baseline of the recorder benchmark. */
+namespace DMSSimGroundTruthRecorderLegacy {
+	void AddHeader(std::ostream& Stream);
+	void AddFrame(std::ostream& Stream, double Time, const DMSSimGroundTruthFrame& Frame);
+	size_t ComputeOccupants(double Time, const DMSSimGroundTruthFrame& Frame);
+} // namespace DMSSimGroundTruthRecorderLegacy
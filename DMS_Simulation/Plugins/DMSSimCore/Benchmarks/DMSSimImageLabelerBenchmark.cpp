@@ -0,0 +1,208 @@
+// Benchmark of the OpenLABEL json output, both labeler versions with a file per frame and the labeler in the streaming mode
+// with one file for all frames, as well as the binary CBOR labeler. The files are written to a temporary directory.
+// The counters are the bytes on disk per frame and the number of files per 1000 frames.
+// BM_LabelWriter runs all labelers through DMSSimLabelWriter with the number of serialization threads as the argument,
+// every iteration writes a batch of frames and waits for the writer to finish. The counters are the mean and max queue depths.
+// BM_RecordingSinks runs the label sinks of DMSSimRecordingSinkRegistry as the recording thread does, with both labelers
+// as selected by default, with the legacy-free selection of ground_truth_settings: sinks: [openlabel] and with the CBOR sink.
+// BM_SerializeFrame only serializes the labels of a frame into memory, in both modes of the json labeler, the part of
+// AddFrame that the scenario's static labels were taken out of.
+// BM_MovingFrames writes a recording whose occupants move a little from frame to frame, as in a real scenario, with the
+// streaming json labeler and with the delta labeler, exact and with an epsilon of half a pixel / millimeter.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <filesystem>
+#include "DMSSimBenchmarkUtils.h"
+#include "DMSSimImageLabeler.h"
+#include "DMSSimLabelWriter.h"
+#include "DMSSimRecordingSink.h"
+
+namespace {
+
+/** Creates an empty directory for the labels and removes it with its content at the end of the benchmark. */
+class LabelDirectory {
+public:
+	explicit LabelDirectory(const char* const Name) : Path_(std::filesystem::temp_directory_path() / Name) {
+		std::filesystem::remove_all(Path_);
+		std::filesystem::create_directories(Path_);
+		BaseFileName_ = (Path_ / "frame").wstring();
+	}
+	~LabelDirectory() {
+		std::error_code Error;
+		std::filesystem::remove_all(Path_, Error);
+	}
+
+	const std::wstring& GetBaseFileName() const { return BaseFileName_; }
+
+	/** Sets the counters from the files in the directory, which hold the labels of FrameCount frames. */
+	void SetCounters(benchmark::State& State, const int64_t FrameCount) const {
+		size_t Files = 0;
+		uintmax_t Bytes = 0;
+		for (const auto& Entry : std::filesystem::directory_iterator(Path_)) {
+			++Files;
+			Bytes += Entry.file_size();
+		}
+		if (FrameCount == 0) { return; }
+		State.counters["bytes_per_frame"] = double(Bytes) / double(FrameCount);
+		State.counters["files_per_1k_frames"] = double(Files) * 1000.0 / double(FrameCount);
+	}
+
+private:
+	std::filesystem::path Path_;
+	std::wstring          BaseFileName_;
+};
+
+constexpr int FILE_NAME_COUNT = 1000;
+constexpr int LABEL_WRITER_BATCH = 64;
+
+template <typename TLabeler>
+void BM_AddFrame(benchmark::State& State, const LabelDirectory& Directory, TLabeler& Labeler, const bool Streaming) {
+	const auto PrevFrame = DMSSimBenchmark::MakeGroundTruthFrame(1);
+	const auto Frame = DMSSimBenchmark::MakeGroundTruthFrame(2);
+	int FrameIdx = 0;
+	for (auto _ : State) {
+		// a file per frame uses a bounded set of file names, so long runs do not fill the disk
+		Labeler.AddFrame(PrevFrame, Frame, Streaming ? FrameIdx++ : FrameIdx++ % FILE_NAME_COUNT);
+	}
+	Labeler.Finalize();
+	State.SetItemsProcessed(int64_t(State.iterations()));
+	Directory.SetCounters(State, Streaming ? int64_t(State.iterations()) : std::min(int64_t(State.iterations()), int64_t(FILE_NAME_COUNT)));
+}
+
+void BM_ImageLabeler(benchmark::State& State) {
+	const LabelDirectory Directory("DMSSimImageLabelerBenchmark");
+	DMSSimImageLabelerImpl Labeler(Directory.GetBaseFileName());
+	BM_AddFrame(State, Directory, Labeler, false);
+}
+BENCHMARK(BM_ImageLabeler)->Unit(benchmark::kMicrosecond);
+
+void BM_ImageLabelerStream(benchmark::State& State) {
+	const LabelDirectory Directory("DMSSimImageLabelerStreamBenchmark");
+	DMSSimImageLabelerImpl Labeler(Directory.GetBaseFileName(), true);
+	BM_AddFrame(State, Directory, Labeler, true);
+}
+BENCHMARK(BM_ImageLabelerStream)->Unit(benchmark::kMicrosecond);
+
+void BM_ImageLabelerCbor(benchmark::State& State) {
+	const LabelDirectory Directory("DMSSimImageLabelerCborBenchmark");
+	DMSSimImageLabelerCborImpl Labeler(Directory.GetBaseFileName());
+	BM_AddFrame(State, Directory, Labeler, true);
+}
+BENCHMARK(BM_ImageLabelerCbor)->Unit(benchmark::kMicrosecond);
+
+void BM_ImageLabelerOld(benchmark::State& State) {
+	const LabelDirectory Directory("DMSSimImageLabelerOldBenchmark");
+	DMSSimImageLabelerOldImpl Labeler(Directory.GetBaseFileName());
+	BM_AddFrame(State, Directory, Labeler, false);
+}
+BENCHMARK(BM_ImageLabelerOld)->Unit(benchmark::kMicrosecond);
+
+void BM_SerializeFrame(benchmark::State& State, const bool Streaming) {
+	const std::wstring BaseFileName = L"unused";
+	DMSSimImageLabelerImpl Labeler(BaseFileName, Streaming);
+	const auto PrevFrame = DMSSimBenchmark::MakeGroundTruthFrame(1);
+	const auto Frame = DMSSimBenchmark::MakeGroundTruthFrame(2);
+	rapidjson::StringBuffer Json;
+	for (auto _ : State) {
+		Json.Clear();
+		Labeler.SerializeFrame(PrevFrame, Frame, Json);
+		benchmark::DoNotOptimize(Json.GetString());
+	}
+	State.SetItemsProcessed(int64_t(State.iterations()));
+	State.counters["bytes_per_frame"] = double(Json.GetSize());
+}
+BENCHMARK_CAPTURE(BM_SerializeFrame, FrameFile, false)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_SerializeFrame, Stream, true)->Unit(benchmark::kMicrosecond);
+
+constexpr int MOVING_FRAME_COUNT = 120;
+
+/** Frames of one scenario in which the occupants slowly turn their heads and blink every second. */
+std::vector<TSharedPtr<DMSSimGroundTruthFrame>> MakeMovingFrames() {
+	std::vector<TSharedPtr<DMSSimGroundTruthFrame>> Frames;
+	for (int k = 0; k < MOVING_FRAME_COUNT; ++k) {
+		auto Frame = DMSSimBenchmark::MakeGroundTruthFrame(1);
+		if (!Frames.empty()) { Frame->Scenario = Frames.front()->Scenario; }
+		for (auto& Occupant : Frame->Data.Occupants) {
+			for (auto& Landmark : Occupant.FacialLandmarks2D) { Landmark += FVector2D(0.2f * k, 0.1f * k); }
+			for (auto& Landmark : Occupant.FacialLandmarks3D_inCam) { Landmark += FVector(0.02f * k, 0.0f, 0.01f * k); }
+			for (auto& Landmark : Occupant.LeftEyePupilLandmarks2D) { Landmark += FVector2D(0.2f * k, 0.1f * k); }
+			for (auto& Landmark : Occupant.RightEyePupilLandmarks2D) { Landmark += FVector2D(0.2f * k, 0.1f * k); }
+			Occupant.HeadRotation_inCam.Yaw += 0.1f * k;
+			if (k % 60 == 59) { Occupant.LeftEyeOpening = Occupant.RightEyeOpening = 0.1f; }
+		}
+		Frames.push_back(Frame);
+	}
+	return Frames;
+}
+
+template <typename TLabeler>
+void BM_MovingFrames(benchmark::State& State, TLabeler& Labeler, const LabelDirectory& Directory) {
+	const auto Frames = MakeMovingFrames();
+	int FrameIdx = 0;
+	for (auto _ : State) {
+		Labeler.AddFrame(Frames[FrameIdx % MOVING_FRAME_COUNT], Frames[(FrameIdx + 1) % MOVING_FRAME_COUNT], FrameIdx);
+		++FrameIdx;
+	}
+	Labeler.Finalize();
+	State.SetItemsProcessed(int64_t(State.iterations()));
+	Directory.SetCounters(State, int64_t(State.iterations()));
+}
+
+void BM_MovingFramesStream(benchmark::State& State) {
+	const LabelDirectory Directory("DMSSimMovingFramesStreamBenchmark");
+	DMSSimImageLabelerImpl Labeler(Directory.GetBaseFileName(), true);
+	BM_MovingFrames(State, Labeler, Directory);
+}
+BENCHMARK(BM_MovingFramesStream)->Unit(benchmark::kMicrosecond);
+
+void BM_MovingFramesDelta(benchmark::State& State, const float Epsilon) {
+	const LabelDirectory Directory("DMSSimMovingFramesDeltaBenchmark");
+	DMSSimImageLabelerDeltaImpl Labeler(Directory.GetBaseFileName(), Epsilon);
+	BM_MovingFrames(State, Labeler, Directory);
+}
+BENCHMARK_CAPTURE(BM_MovingFramesDelta, Exact, 0.0f)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_MovingFramesDelta, HalfPixel, 0.5f)->Unit(benchmark::kMicrosecond);
+
+void BM_LabelWriter(benchmark::State& State) {
+	const LabelDirectory Directory("DMSSimLabelWriterBenchmark");
+	const auto PrevFrame = DMSSimBenchmark::MakeGroundTruthFrame(1);
+	const auto Frame = DMSSimBenchmark::MakeGroundTruthFrame(2);
+	DMSSimLabelWriter::Stats Stats;
+	for (auto _ : State) {
+		DMSSimLabelWriter Writer(Directory.GetBaseFileName(), DMSSimLabelWriter::AllLabels, false, int(State.range(0)));
+		for (int FrameIdx = 0; FrameIdx < LABEL_WRITER_BATCH; ++FrameIdx) { Writer.AddFrame(PrevFrame, Frame, FrameIdx); }
+		Writer.Finalize();
+		Stats = Writer.GetStats();
+	}
+	State.SetItemsProcessed(int64_t(State.iterations()) * LABEL_WRITER_BATCH);
+	State.counters["queue_depth_mean"] = Stats.MeanQueueDepth;
+	State.counters["queue_depth_max"] = double(Stats.MaxQueueDepth);
+	State.counters["commit_depth_mean"] = Stats.MeanCommitDepth;
+	State.counters["commit_depth_max"] = double(Stats.MaxCommitDepth);
+}
+BENCHMARK(BM_LabelWriter)->Arg(0)->Arg(1)->Arg(2)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+void BM_RecordingSinks(benchmark::State& State, const std::vector<std::string>& Names, const bool Streaming) {
+	const LabelDirectory Directory("DMSSimRecordingSinkBenchmark");
+	const DMSSimRecordingSinkSettings Settings{ Directory.GetBaseFileName() };
+	auto Sinks = DMSSimRecordingSinkRegistry::Get().CreateSinks(Names, Settings);
+	const auto PrevFrame = DMSSimBenchmark::MakeGroundTruthFrame(1);
+	const auto Frame = DMSSimBenchmark::MakeGroundTruthFrame(2);
+	const TArray<FColor> Image;
+	int FrameIdx = 0;
+	for (auto _ : State) {
+		for (auto& Sink : Sinks) { Sink->AddFrame(Image, PrevFrame, Frame, Streaming ? FrameIdx : FrameIdx % FILE_NAME_COUNT); }
+		++FrameIdx;
+	}
+	for (auto& Sink : Sinks) { Sink->Finalize(); }
+	State.SetItemsProcessed(int64_t(State.iterations()));
+	Directory.SetCounters(State, Streaming ? int64_t(State.iterations()) : std::min(int64_t(State.iterations()), int64_t(FILE_NAME_COUNT)));
+}
+BENCHMARK_CAPTURE(BM_RecordingSinks, Default, std::vector<std::string>{ DMSSIM_SINK_OPENLABEL, DMSSIM_SINK_OPENLABEL_OLD }, false)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RecordingSinks, LegacyFree, std::vector<std::string>{ DMSSIM_SINK_OPENLABEL }, false)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_RecordingSinks, Cbor, std::vector<std::string>{ DMSSIM_SINK_OPENLABEL_CBOR }, true)->Unit(benchmark::kMicrosecond);
+
+} // anonymous namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,109 @@
+// Microbenchmark of the landmark projection with lens distortion: the batched functions against the scalar reference,
+// for the labels of the occupants of a frame and for a large batch of points.
+// Built by Benchmarks/CMakeLists.txt together with the other DMSSimCoreLib benchmarks.
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "DMSSimLandmarkProjection.h"
+
+namespace {
+constexpr int FRAME_OCCUPANTS = 2;
+constexpr int BATCH_POINTS = 4096;
+const float LENS_DISTORTION[DMSSIM_DISTORTION_COEFFICIENT_COUNT] = { -0.28f, 0.09f, 0.0012f, -0.0007f, -0.015f };
+
+const DMSSimCameraIntrinsics& GetIntrinsics() {
+	static const auto Intrinsics = DMSSimCameraIntrinsics::Create(1312, 1008, 43.6f, false, LENS_DISTORTION);
+	return Intrinsics;
+}
+
+/** An occupant with all 2D labels the projection recomputes, the landmarks 40 - 90 cm in front of the camera. */
+DMSSimGroundTruthOccupant MakeOccupant(const uint32_t Seed) {
+	std::mt19937 Random(Seed);
+	std::uniform_real_distribution<float> Depth(40.0f, 90.0f);
+	std::uniform_real_distribution<float> Side(-25.0f, 25.0f);
+	std::uniform_real_distribution<float> Pixel(300.0f, 900.0f);
+	DMSSimGroundTruthOccupant Occupant = {};
+	for (int i = 0; i < MAX_FACIAL_LANDMARKS; ++i) { Occupant.FacialLandmarks3D_inCam.Add(FVector(Depth(Random), Side(Random), Side(Random))); }
+	for (int i = 0; i < MAX_PUPIL_IRIS_LANDMARKS; ++i) {
+		Occupant.RightEyePupilLandmarks2D.Add(FVector2D(Pixel(Random), Pixel(Random)));
+		Occupant.RightEyeIrisLandmarks2D.Add(FVector2D(Pixel(Random), Pixel(Random)));
+		Occupant.LeftEyePupilLandmarks2D.Add(FVector2D(Pixel(Random), Pixel(Random)));
+		Occupant.LeftEyeIrisLandmarks2D.Add(FVector2D(Pixel(Random), Pixel(Random)));
+	}
+	Occupant.FaceBoundingBox2D = { FVector2D(650.0f, 480.0f), 420.0f, 500.0f };
+	Occupant.RightEyeBoundingBox2D = { FVector2D(560.0f, 420.0f), 60.0f, 30.0f };
+	Occupant.LeftEyeBoundingBox2D = { FVector2D(740.0f, 420.0f), 60.0f, 30.0f };
+	return Occupant;
+}
+
+FDMSBoundingBox2D DistortBoundingBox(const DMSSimCameraIntrinsics& Intrinsics, const FDMSBoundingBox2D& BoundingBox) {
+	const auto TopLeft = DMSSimLandmarkProjection::DistortPixel(Intrinsics, BoundingBox.Center - FVector2D(BoundingBox.Width, BoundingBox.Height) * 0.5f);
+	const auto BottomRight = DMSSimLandmarkProjection::DistortPixel(Intrinsics, BoundingBox.Center + FVector2D(BoundingBox.Width, BoundingBox.Height) * 0.5f);
+	return { (TopLeft + BottomRight) * 0.5f, BottomRight.X - TopLeft.X, BottomRight.Y - TopLeft.Y };
+}
+
+/** The labels of the occupant projected point by point, the way the batch is checked by the tests. */
+void ProjectOccupantScalar(const DMSSimCameraIntrinsics& Intrinsics, DMSSimGroundTruthOccupant& Occupant) {
+	Occupant.FacialLandmarks2D.SetNum(Occupant.FacialLandmarks3D_inCam.Num());
+	for (int i = 0; i < Occupant.FacialLandmarks3D_inCam.Num(); ++i) {
+		Occupant.FacialLandmarks2D[i] = DMSSimLandmarkProjection::ProjectPoint(Intrinsics, Occupant.FacialLandmarks3D_inCam[i]);
+	}
+	for (auto* Landmarks : { &Occupant.RightEyePupilLandmarks2D, &Occupant.RightEyeIrisLandmarks2D, &Occupant.LeftEyePupilLandmarks2D, &Occupant.LeftEyeIrisLandmarks2D }) {
+		for (auto& Pixel : *Landmarks) { Pixel = DMSSimLandmarkProjection::DistortPixel(Intrinsics, Pixel); }
+	}
+	Occupant.FaceBoundingBox2D = DistortBoundingBox(Intrinsics, Occupant.FaceBoundingBox2D);
+	Occupant.RightEyeBoundingBox2D = DistortBoundingBox(Intrinsics, Occupant.RightEyeBoundingBox2D);
+	Occupant.LeftEyeBoundingBox2D = DistortBoundingBox(Intrinsics, Occupant.LeftEyeBoundingBox2D);
+}
+
+void BM_ProjectFrame(benchmark::State& State) {
+	const bool Batched = State.range(0) != 0;
+	const auto& Intrinsics = GetIntrinsics();
+	DMSSimGroundTruthOccupant Occupants[FRAME_OCCUPANTS];
+	for (int i = 0; i < FRAME_OCCUPANTS; ++i) { Occupants[i] = MakeOccupant(i + 1); }
+	for (auto _ : State) {
+		// every iteration projects the pinhole labels of the Blueprint again
+		for (const auto& Occupant : Occupants) {
+			DMSSimGroundTruthOccupant Frame = Occupant;
+			if (Batched) { DMSSimLandmarkProjection::ProjectOccupant(Intrinsics, Frame); }
+			else { ProjectOccupantScalar(Intrinsics, Frame); }
+			benchmark::DoNotOptimize(Frame);
+		}
+	}
+	State.SetLabel(Batched ? "Batched" : "Scalar");
+	State.SetItemsProcessed(int64_t(State.iterations()) * FRAME_OCCUPANTS);
+}
+
+void BM_ProjectPoints(benchmark::State& State) {
+	const bool Batched = State.range(0) != 0;
+	const auto& Intrinsics = GetIntrinsics();
+	std::mt19937 Random(42);
+	std::uniform_real_distribution<float> Depth(40.0f, 90.0f);
+	std::uniform_real_distribution<float> Side(-25.0f, 25.0f);
+	std::vector<float> X(BATCH_POINTS), Y(BATCH_POINTS), Z(BATCH_POINTS), U(BATCH_POINTS), V(BATCH_POINTS);
+	for (int i = 0; i < BATCH_POINTS; ++i) {
+		X[i] = Depth(Random);
+		Y[i] = Side(Random);
+		Z[i] = Side(Random);
+	}
+	for (auto _ : State) {
+		if (Batched) { DMSSimLandmarkProjection::ProjectPoints(Intrinsics, X.data(), Y.data(), Z.data(), BATCH_POINTS, U.data(), V.data()); }
+		else {
+			for (int i = 0; i < BATCH_POINTS; ++i) {
+				const auto Pixel = DMSSimLandmarkProjection::ProjectPoint(Intrinsics, FVector(X[i], Y[i], Z[i]));
+				U[i] = Pixel.X;
+				V[i] = Pixel.Y;
+			}
+		}
+		benchmark::ClobberMemory();
+	}
+	State.SetLabel(Batched ? "Batched" : "Scalar");
+	State.SetItemsProcessed(int64_t(State.iterations()) * BATCH_POINTS);
+}
+} // anonymous namespace
+
+BENCHMARK(BM_ProjectFrame)->Arg(0)->Arg(1);
+BENCHMARK(BM_ProjectPoints)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,83 @@
+// Microbenchmark of the lens distortion remap at the frame size used by the scenarios in ymls/ (2400x1770):
+// the bilinear gather of a frame with each kernel, on one thread and in row tiles, and the computation of the lookup table.
+// Built by Benchmarks/CMakeLists.txt together with the other DMSSimCoreLib benchmarks.
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include "DMSSimLensRemap.h"
+
+namespace {
+constexpr size_t FRAME_WIDTH = 2400;
+constexpr size_t FRAME_HEIGHT = 1770;
+const float LENS_DISTORTION[DMSSIM_DISTORTION_COEFFICIENT_COUNT] = { -0.28f, 0.09f, 0.0012f, -0.0007f, -0.015f };
+
+using DMSSimPixelConversion::SimdLevel;
+
+const DMSSimCameraIntrinsics& GetIntrinsics() {
+	static const auto Intrinsics = DMSSimCameraIntrinsics::Create(FRAME_WIDTH, FRAME_HEIGHT, 60.0f, false, LENS_DISTORTION);
+	return Intrinsics;
+}
+
+const DMSSimLensRemap& GetRemap() {
+	static const DMSSimLensRemap Remap(GetIntrinsics(), FRAME_WIDTH, FRAME_HEIGHT);
+	return Remap;
+}
+
+const TArray<FColor>& GetFrame() {
+	static const TArray<FColor> Frame = []() {
+		TArray<FColor> Pixels;
+		Pixels.SetNumUninitialized(int32(FRAME_WIDTH * FRAME_HEIGHT));
+		std::mt19937 Random(42);
+		for (auto& Pixel : Pixels) { Pixel = FColor(uint8(Random()), uint8(Random()), uint8(Random()), 255); }
+		return Pixels;
+	}();
+	return Frame;
+}
+
+bool SkipUnsupported(benchmark::State& State, SimdLevel Level) {
+	if (Level <= DMSSimPixelConversion::GetSupportedSimdLevel()) { return false; }
+	State.SkipWithError("instruction set is not supported by the CPU");
+	return true;
+}
+
+void BM_RemapRows(benchmark::State& State) {
+	const auto Level = SimdLevel(State.range(0));
+	if (SkipUnsupported(State, Level)) { return; }
+	const auto& Remap = GetRemap();
+	const auto& Frame = GetFrame();
+	TArray<FColor> Remapped;
+	Remapped.SetNumUninitialized(Frame.Num());
+	for (auto _ : State) {
+		Remap.RemapRows(Frame.GetData(), Remapped.GetData(), 0, FRAME_HEIGHT, Level);
+		benchmark::ClobberMemory();
+	}
+	State.SetLabel(DMSSimPixelConversion::GetSimdLevelName(Level));
+	State.SetBytesProcessed(int64_t(State.iterations()) * Frame.Num() * sizeof(FColor));
+}
+
+/** The frame in row tiles with ParallelFor, like the recording thread. */
+void BM_Remap(benchmark::State& State) {
+	const auto& Remap = GetRemap();
+	const auto& Frame = GetFrame();
+	TArray<FColor> Remapped;
+	for (auto _ : State) {
+		Remap.Remap(Frame, Remapped);
+		benchmark::ClobberMemory();
+	}
+	State.SetLabel(DMSSimPixelConversion::GetSimdLevelName(DMSSimPixelConversion::GetSupportedSimdLevel()));
+	State.SetBytesProcessed(int64_t(State.iterations()) * Frame.Num() * sizeof(FColor));
+}
+
+void BM_BuildTable(benchmark::State& State) {
+	for (auto _ : State) {
+		DMSSimLensRemap Remap(GetIntrinsics(), FRAME_WIDTH, FRAME_HEIGHT);
+		benchmark::DoNotOptimize(Remap.GetEntry(0, 0));
+	}
+}
+} // anonymous namespace
+
+BENCHMARK(BM_RemapRows)->DenseRange(int(SimdLevel::Scalar), int(SimdLevel::AVX2))->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Remap)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_BuildTable)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,139 @@
+// Benchmark of the montage building for every occupant and channel of a scenario.
+// The asset registry and the environment are in-memory fakes, every animation of the scenario resolves to a 5 seconds long sequence.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "DMSSimAssetRegistry.h"
+#include "DMSSimBenchmarkUtils.h"
+#include "DMSSimMontageBuilder.h"
+
+namespace {
+
+constexpr float ANIMATION_LENGTH = 5.0f;
+
+class ResourceSet : public DMSSimResourceSet {
+public:
+	~ResourceSet() override {}
+
+	void Add(std::string Name) {
+		std::transform(Name.begin(), Name.end(), Name.begin(), [](unsigned char Char) { return char(std::tolower(Char)); });
+		if (std::find(Names_.begin(), Names_.end(), Name) == Names_.end()) {
+			Paths_.push_back("/Game/Animations/" + Name);
+			Names_.push_back(std::move(Name));
+		}
+	}
+
+	size_t GetResourceCount() const override { return Names_.size(); }
+	const char* GetResourceName(size_t Index) const override { return Names_[Index].c_str(); }
+	const char* GetResourcePath(size_t Index) const override { return Paths_[Index].c_str(); }
+
+private:
+	std::vector<std::string> Names_;
+	std::vector<std::string> Paths_;
+};
+
+/** Registers every animation name used by the scenario, the head animation variants included. */
+class AssetRegistry : public DMSSimAssetRegistry {
+public:
+	explicit AssetRegistry(const DMSSimScenarioParser& Parser) {
+		for (size_t i = 0; i < Parser.GetOccupantScenarioCount(); ++i) {
+			const auto& Scenario = Parser.GetOccupantScenario(i);
+			for (size_t j = 0; j < Scenario.GetMotionCount(); ++j) { AddMotion(Scenario.GetMotion(j)); }
+			for (size_t j = 0; j < Scenario.GetChannelCount(); ++j) {
+				const auto& Channel = Scenario.GetChannel(j);
+				for (size_t k = 0; k < Channel.GetMotionCount(); ++k) { AddMotion(Channel.GetMotion(k)); }
+			}
+		}
+	}
+
+	const DMSSimResourceSet& GetAnimations() const override { return Animations_; }
+	const DMSSimResourceSet& GetGroomAssets() const override { return Empty_; }
+	const DMSSimResourceSet& GetBlueprintAssets() const override { return Empty_; }
+
+private:
+	void AddMotion(const DMSSimMotion& Motion) {
+		const char* const Name = Motion.GetAnimationName();
+		if (!Name || !*Name) { return; }
+		Animations_.Add(Name);
+		Animations_.Add(std::string(Name) + DMSSIM_HEAD_ANIMATION_POSTFIX);
+	}
+
+	ResourceSet Animations_;
+	ResourceSet Empty_;
+};
+
+class Environment : public DMSSimMontageBuilder::TEnvironment {
+public:
+	~Environment() override {}
+
+	UAnimMontage* CreateMontage() override { return NewObject<UAnimMontage>(); }
+
+	UAnimSequenceBase* LoadAnimationSequence(DMSSimAnimationChannelType TargetChannel, const char* Name, const char* Path, bool* ExactMatch) override {
+		if (ExactMatch) { *ExactMatch = true; }
+		auto& Sequence = Sequences_[Path ? Path : Name];
+		if (!Sequence) {
+			Sequence = std::make_unique<UAnimSequence>();
+			Sequence->SequenceLength = ANIMATION_LENGTH;
+		}
+		return Sequence.get();
+	}
+
+	FSlotAnimationTrack* GetMontageSlot(DMSSimAnimationChannelType TargetChannel, UAnimMontage* Montage) override {
+		const FString SlotName = TargetChannel == DMSSimAnimationChannelCommon ? FAnimSlotGroup::DefaultSlotName : FString(L"Slot" + std::to_wstring(int(TargetChannel)));
+		for (auto& Track : Montage->SlotAnimTracks) {
+			if (Track.SlotName == SlotName) { return &Track; }
+		}
+		return &Montage->AddSlot(SlotName);
+	}
+
+	void AddMontageSection(DMSSimAnimationChannelType TargetChannel, UAnimMontage* Montage) override {
+		FCompositeSection Section;
+		Section.SectionName = FString(L"Section" + std::to_wstring(int(TargetChannel)));
+		Montage->CompositeSections.Add(std::move(Section));
+	}
+
+	std::vector<std::string> GetNotifyEvents(UAnimSequenceBase* Sequence) override { return {}; }
+
+private:
+	std::map<std::string, std::unique_ptr<UAnimSequenceBase>> Sequences_;
+};
+
+void BM_BuildMontages(benchmark::State& State) {
+	const auto FilePath = DMSSimBenchmark::GetScenarioPath(L"Ada.yml");
+	const std::unique_ptr<DMSSimScenarioParser> Parser(DMSSimScenarioParser::Create(FilePath.c_str(), DMSSimBenchmark::GetConfig()));
+	if (!Parser) {
+		State.SkipWithError("failed to parse Ada.yml");
+		return;
+	}
+	const AssetRegistry Registry(*Parser);
+	Environment Env;
+	USkeleton Skeleton;
+	int64_t MontageCount = 0;
+	for (auto _ : State) {
+		for (size_t i = 0; i < Parser->GetOccupantScenarioCount(); ++i) {
+			const auto Occupant = Parser->GetOccupantScenario(i).GetType();
+			for (int Channel = DMSSimAnimationChannelCommon; Channel < DMSSimAnimationChannelCount; ++Channel) {
+				TArray<DMSSimMontageBuilder::TMontage> Montages;
+				try {
+					DMSSimMontageBuilder::Build(Env, Parser.get(), &Registry, Occupant, DMSSimAnimationChannelType(Channel), &Skeleton, Montages);
+				} catch (const std::exception&) {
+					// channels the scenario does not animate the way the builder expects are skipped, as in the game
+				}
+				MontageCount += Montages.Num();
+				for (const auto& Montage : Montages) { delete Montage.Montage; }
+			}
+		}
+	}
+	State.SetItemsProcessed(MontageCount);
+}
+BENCHMARK(BM_BuildMontages)->Unit(benchmark::kMicrosecond);
+
+} // anonymous namespace
+
+BENCHMARK_MAIN();
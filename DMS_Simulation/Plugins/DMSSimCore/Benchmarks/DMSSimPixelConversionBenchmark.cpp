@@ -0,0 +1,76 @@
+// Microbenchmark of the BGRA conversion kernels at the frame size used by the scenarios in ymls/ (2400x1770).
+// Built by Benchmarks/CMakeLists.txt together with the other DMSSimCoreLib benchmarks.
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "DMSSimPixelConversion.h"
+
+namespace {
+constexpr size_t FRAME_WIDTH = 2400;
+constexpr size_t FRAME_HEIGHT = 1770;
+
+using DMSSimPixelConversion::SimdLevel;
+
+const std::vector<uint8_t>& GetFrame() {
+	static const std::vector<uint8_t> Frame = []() {
+		std::vector<uint8_t> Pixels(FRAME_WIDTH * FRAME_HEIGHT * 4);
+		std::mt19937 Random(42);
+		for (auto& Value : Pixels) { Value = uint8_t(Random()); }
+		return Pixels;
+	}();
+	return Frame;
+}
+
+bool SkipUnsupported(benchmark::State& State, SimdLevel Level) {
+	if (Level <= DMSSimPixelConversion::GetSupportedSimdLevel()) { return false; }
+	State.SkipWithError("instruction set is not supported by the CPU");
+	return true;
+}
+
+void BM_BGRAToYUV420P(benchmark::State& State) {
+	const auto Level = SimdLevel(State.range(0));
+	if (SkipUnsupported(State, Level)) { return; }
+	const auto& Frame = GetFrame();
+	std::vector<uint8_t> Y(FRAME_WIDTH * FRAME_HEIGHT), U(FRAME_WIDTH * FRAME_HEIGHT / 4), V(FRAME_WIDTH * FRAME_HEIGHT / 4);
+	for (auto _ : State) {
+		DMSSimPixelConversion::BGRAToYUV420P(Frame.data(), FRAME_WIDTH * 4, Y.data(), FRAME_WIDTH, U.data(), FRAME_WIDTH / 2, V.data(), FRAME_WIDTH / 2,
+			FRAME_WIDTH, FRAME_HEIGHT, 0, FRAME_HEIGHT, Level);
+		benchmark::ClobberMemory();
+	}
+	State.SetLabel(DMSSimPixelConversion::GetSimdLevelName(Level));
+	State.SetBytesProcessed(int64_t(State.iterations()) * Frame.size());
+}
+
+void BM_BGRAToGray8(benchmark::State& State) {
+	const auto Level = SimdLevel(State.range(0));
+	if (SkipUnsupported(State, Level)) { return; }
+	const auto& Frame = GetFrame();
+	std::vector<uint8_t> Gray(FRAME_WIDTH * FRAME_HEIGHT);
+	for (auto _ : State) {
+		DMSSimPixelConversion::BGRAToGray8(Frame.data(), FRAME_WIDTH * 4, Gray.data(), FRAME_WIDTH, FRAME_WIDTH, 0, FRAME_HEIGHT, Level);
+		benchmark::ClobberMemory();
+	}
+	State.SetLabel(DMSSimPixelConversion::GetSimdLevelName(Level));
+	State.SetBytesProcessed(int64_t(State.iterations()) * Frame.size());
+}
+
+void BM_BGRAToGray16LE(benchmark::State& State) {
+	const auto Level = SimdLevel(State.range(0));
+	if (SkipUnsupported(State, Level)) { return; }
+	const auto& Frame = GetFrame();
+	std::vector<uint8_t> Gray(FRAME_WIDTH * FRAME_HEIGHT * 2);
+	for (auto _ : State) {
+		DMSSimPixelConversion::BGRAToGray16LE(Frame.data(), FRAME_WIDTH * 4, Gray.data(), FRAME_WIDTH * 2, FRAME_WIDTH, 0, FRAME_HEIGHT, Level);
+		benchmark::ClobberMemory();
+	}
+	State.SetLabel(DMSSimPixelConversion::GetSimdLevelName(Level));
+	State.SetBytesProcessed(int64_t(State.iterations()) * Frame.size());
+}
+} // anonymous namespace
+
+BENCHMARK(BM_BGRAToYUV420P)->DenseRange(int(SimdLevel::Scalar), int(SimdLevel::AVX2))->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BGRAToGray8)->DenseRange(int(SimdLevel::Scalar), int(SimdLevel::AVX2))->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BGRAToGray16LE)->DenseRange(int(SimdLevel::Scalar), int(SimdLevel::AVX2))->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,255 @@
+// Benchmark of scenario loading: a single scenario, every scenario of the directory, a synthetic corpus of 10k scenarios
+// made from them and the configuration file, and the loading of the corpus directory, parsed in parallel or only indexed.
+// A generated scenario of 50k lines measures the parse of long files, with and without a syntax error at its end.
+// The compiled scenarios are loaded from memory and through the cache directory, against the parse of the same files.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "DMSSimBenchmarkUtils.h"
+#include "DMSSimScenarioParserUtils.h"
+
+namespace {
+
+std::vector<std::wstring> GetScenarioFiles() {
+	std::vector<std::wstring> Files;
+	for (const auto& Entry : std::filesystem::directory_iterator(DMSSIM_SCENARIO_DIR)) {
+		if (Entry.path().extension() == ".yml") { Files.push_back(Entry.path().wstring()); }
+	}
+	return Files;
+}
+
+constexpr size_t SYNTHETIC_SCENARIO_COUNT = 10000;
+
+const std::filesystem::path& GetSyntheticScenarioDirectory() {
+	static const auto Directory = std::filesystem::temp_directory_path() / "dmssim_scenario_corpus";
+	return Directory;
+}
+
+/**
+ * The scenarios of the directory written round robin into a temporary directory, SYNTHETIC_SCENARIO_COUNT files,
+ * each with its own description, so the corpus is not served from a handful of cached files. The directory has the config too.
+ */
+const std::vector<std::wstring>& GetSyntheticScenarioFiles() {
+	static const std::vector<std::wstring> Files = []() {
+		std::vector<std::string> Sources;
+		for (const auto& File : GetScenarioFiles()) {
+			std::ifstream Stream{ std::filesystem::path(File) };
+			std::stringstream Text;
+			Text << Stream.rdbuf();
+			Sources.push_back(Text.str());
+		}
+		const auto& Directory = GetSyntheticScenarioDirectory();
+		std::filesystem::create_directories(Directory);
+		std::filesystem::copy_file(DMSSIM_CONFIG_PATH, Directory / "config.yml", std::filesystem::copy_options::overwrite_existing);
+		std::vector<std::wstring> Paths;
+		for (size_t i = 0; i < SYNTHETIC_SCENARIO_COUNT && !Sources.empty(); ++i) {
+			std::string Text = Sources[i % Sources.size()];
+			const auto Description = Text.find("description: \"\"");
+			if (Description != std::string::npos) { Text.replace(Description, 15, "description: \"synthetic " + std::to_string(i) + "\""); }
+			const auto Path = Directory / ("Scenario_" + std::to_string(i) + ".yml");
+			std::ofstream(Path, std::ios::binary) << Text;
+			Paths.push_back(Path.wstring());
+		}
+		return Paths;
+	}();
+	return Files;
+}
+
+void BM_ParseConfig(benchmark::State& State) {
+	for (auto _ : State) {
+		std::unique_ptr<DMSSimConfigParser> Config(DMSSimConfigParser::Create(DMSSIM_CONFIG_PATH));
+		benchmark::DoNotOptimize(Config.get());
+	}
+}
+BENCHMARK(BM_ParseConfig);
+
+void BM_ParseScenario(benchmark::State& State) {
+	const auto& Config = DMSSimBenchmark::GetConfig();
+	const auto FilePath = DMSSimBenchmark::GetScenarioPath(L"Ada.yml");
+	for (auto _ : State) {
+		std::unique_ptr<DMSSimScenarioParser> Parser(DMSSimScenarioParser::Create(FilePath.c_str(), Config));
+		if (!Parser) {
+			State.SkipWithError("failed to parse Ada.yml");
+			break;
+		}
+		benchmark::DoNotOptimize(Parser.get());
+	}
+}
+BENCHMARK(BM_ParseScenario);
+
+void BM_ParseScenarioDirectory(benchmark::State& State) {
+	const auto& Config = DMSSimBenchmark::GetConfig();
+	const auto Files = GetScenarioFiles();
+	for (auto _ : State) {
+		for (const auto& File : Files) {
+			std::unique_ptr<DMSSimScenarioParser> Parser(DMSSimScenarioParser::Create(File.c_str(), Config));
+			benchmark::DoNotOptimize(Parser.get());
+		}
+	}
+	State.SetItemsProcessed(int64_t(State.iterations()) * int64_t(Files.size()));
+}
+BENCHMARK(BM_ParseScenarioDirectory)->Unit(benchmark::kMillisecond);
+
+/** Load of the compiled scenarios of the directory from memory, what a cache hit does instead of BM_ParseScenarioDirectory. */
+void BM_LoadCompiledScenarioDirectory(benchmark::State& State) {
+	const auto& Config = DMSSimBenchmark::GetConfig();
+	std::vector<std::string> CompiledScenarios;
+	for (const auto& File : GetScenarioFiles()) {
+		std::unique_ptr<DMSSimScenarioParser> Parser(DMSSimScenarioParser::Create(File.c_str(), Config));
+		CompiledScenarios.push_back(Parser->Compile());
+	}
+	for (auto _ : State) {
+		for (const auto& Compiled : CompiledScenarios) {
+			std::unique_ptr<DMSSimScenarioParser> Parser(DMSSimScenarioParser::Load(Compiled.data(), Compiled.size()));
+			if (!Parser) {
+				State.SkipWithError("failed to load a compiled scenario");
+				return;
+			}
+			benchmark::DoNotOptimize(Parser.get());
+		}
+	}
+	State.SetItemsProcessed(int64_t(State.iterations()) * int64_t(CompiledScenarios.size()));
+}
+BENCHMARK(BM_LoadCompiledScenarioDirectory)->Unit(benchmark::kMillisecond);
+
+constexpr size_t LARGE_SCENARIO_LINES = 50000;
+
+/**
+ * Ada.yml with the animation sequence of the driver repeated up to LARGE_SCENARIO_LINES lines, followed by comment lines.
+ * With SyntaxError the last motion has a property with two values, a YAML syntax error at the end of the file.
+ */
+std::wstring MakeLargeScenario(const bool SyntaxError) {
+	std::ifstream Stream{ std::filesystem::path(DMSSimBenchmark::GetScenarioPath(L"Ada.yml")) };
+	std::stringstream Text;
+	Text << Stream.rdbuf();
+	std::string Scenario = Text.str();
+	const auto Sequence = Scenario.find("  passenger_rear_left:\n    sequence:");
+	if (Sequence == std::string::npos) { return std::wstring(); }
+	Scenario.resize(Sequence);
+
+	std::string Lines = Scenario;
+	size_t LineCount = size_t(std::count(Scenario.begin(), Scenario.end(), '\n'));
+	const size_t TrailingComments = 100;
+	for (size_t i = 0; LineCount + 5 + TrailingComments < LARGE_SCENARIO_LINES; ++i, LineCount += 5) {
+		Lines += "      - animation: normal_blink_no_yawn_head_straight_KE10RT28 # motion " + std::to_string(i) + "\n";
+		Lines += "        blend_out: 0.25\n";
+		Lines += "        start_pos: 0.5\n";
+		Lines += "        end_pos: 1.75\n";
+		Lines += "        duration: 2.0\n";
+	}
+	if (SyntaxError) { Lines += "        blend_out: 0.25: 0.5\n        duration: 2.0\n"; }
+	for (size_t i = 0; i < TrailingComments; ++i) { Lines += "# trailing comment " + std::to_string(i) + "\n"; }
+
+	const auto Path = std::filesystem::temp_directory_path() / (SyntaxError ? "dmssim_large_scenario_error.yml" : "dmssim_large_scenario.yml");
+	std::ofstream(Path, std::ios::binary) << Lines;
+	return Path.wstring();
+}
+
+void BM_ParseLargeScenario(benchmark::State& State) {
+	const auto& Config = DMSSimBenchmark::GetConfig();
+	const auto FilePath = MakeLargeScenario(false);
+	for (auto _ : State) {
+		std::unique_ptr<DMSSimScenarioParser> Parser(DMSSimScenarioParser::Create(FilePath.c_str(), Config));
+		if (!Parser) {
+			State.SkipWithError("failed to parse the large scenario");
+			break;
+		}
+		benchmark::DoNotOptimize(Parser.get());
+	}
+	State.SetItemsProcessed(int64_t(State.iterations()) * int64_t(LARGE_SCENARIO_LINES));
+}
+BENCHMARK(BM_ParseLargeScenario)->Unit(benchmark::kMillisecond);
+
+/** The parse up to the syntax error and the error message, which quotes the line before the error. */
+void BM_ParseLargeScenarioError(benchmark::State& State) {
+	const auto& Config = DMSSimBenchmark::GetConfig();
+	const auto FilePath = MakeLargeScenario(true);
+	for (auto _ : State) {
+		try {
+			std::unique_ptr<DMSSimScenarioParser> Parser(DMSSimScenarioParser::Create(FilePath.c_str(), Config));
+			State.SkipWithError("the syntax error of the large scenario wasn't detected");
+			break;
+		}
+		catch (const std::runtime_error& Error) { benchmark::DoNotOptimize(Error.what()); }
+	}
+	State.SetItemsProcessed(int64_t(State.iterations()) * int64_t(LARGE_SCENARIO_LINES));
+}
+BENCHMARK(BM_ParseLargeScenarioError)->Unit(benchmark::kMillisecond);
+
+void BM_ParseSyntheticCorpus(benchmark::State& State) {
+	const auto& Config = DMSSimBenchmark::GetConfig();
+	const auto& Files = GetSyntheticScenarioFiles();
+	for (auto _ : State) {
+		for (const auto& File : Files) {
+			std::unique_ptr<DMSSimScenarioParser> Parser(DMSSimScenarioParser::Create(File.c_str(), Config));
+			if (!Parser) {
+				State.SkipWithError("failed to parse the synthetic corpus");
+				return;
+			}
+			benchmark::DoNotOptimize(Parser.get());
+		}
+	}
+	State.SetItemsProcessed(int64_t(State.iterations()) * int64_t(Files.size()));
+}
+BENCHMARK(BM_ParseSyntheticCorpus)->Unit(benchmark::kMillisecond)->Iterations(1);
+
+/** CreateScenarioParsers of the corpus directory, the files parsed in parallel. */
+void BM_CreateScenarioParsers(benchmark::State& State) {
+	const auto Count = GetSyntheticScenarioFiles().size();
+	const FString Directory(GetSyntheticScenarioDirectory().wstring().c_str());
+	for (auto _ : State) {
+		const auto Parsers = CreateScenarioParsers(Directory);
+		if (Parsers.size() != Count) {
+			State.SkipWithError("failed to load the synthetic corpus");
+			return;
+		}
+	}
+	State.SetItemsProcessed(int64_t(State.iterations()) * int64_t(Count));
+}
+BENCHMARK(BM_CreateScenarioParsers)->Unit(benchmark::kMillisecond)->Iterations(1)->UseRealTime();
+
+/** IndexScenarioParsers of the corpus directory, the time to the first frame of a lazily loaded directory. */
+void BM_IndexScenarioParsers(benchmark::State& State) {
+	const auto Count = GetSyntheticScenarioFiles().size();
+	const FString Directory(GetSyntheticScenarioDirectory().wstring().c_str());
+	for (auto _ : State) {
+		const auto Entries = IndexScenarioParsers(Directory);
+		if (Entries.size() != Count) {
+			State.SkipWithError("failed to index the synthetic corpus");
+			return;
+		}
+	}
+	State.SetItemsProcessed(int64_t(State.iterations()) * int64_t(Count));
+}
+BENCHMARK(BM_IndexScenarioParsers)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/**
+ * CreateScenarioParser of as many corpus files as there are scenarios in the directory, range 0 - without the cache,
+ * 1 - with a warm cache directory, every scenario read, hashed and loaded from its compiled scenario.
+ */
+void BM_CreateScenarioParserCache(benchmark::State& State) {
+	const auto& Corpus = GetSyntheticScenarioFiles();
+	const std::vector<std::wstring> Files(Corpus.begin(), Corpus.begin() + std::min(Corpus.size(), GetScenarioFiles().size()));
+	const auto CacheDirectory = std::filesystem::temp_directory_path() / "dmssim_scenario_cache";
+	const FString CachePath = State.range(0) ? FString(CacheDirectory.wstring().c_str()) : FString();
+	for (const auto& File : Files) { CreateScenarioParser(FString(File.c_str()), CachePath); }
+	for (auto _ : State) {
+		for (const auto& File : Files) {
+			const auto Parser = CreateScenarioParser(FString(File.c_str()), CachePath);
+			benchmark::DoNotOptimize(Parser.Get());
+		}
+	}
+	State.SetItemsProcessed(int64_t(State.iterations()) * int64_t(Files.size()));
+}
+BENCHMARK(BM_CreateScenarioParserCache)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+} // anonymous namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,46 @@
+// Benchmark of the video encoders on synthetic frames, with and without rescaling. Built only when FFmpeg is found.
+
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <random>
+#include "DMSSimBenchmarkUtils.h"
+#include "DMSSimVideoEncoder.h"
+
+namespace {
+
+constexpr size_t FRAME_WIDTH = 1312;
+constexpr size_t FRAME_HEIGHT = 1008;
+constexpr size_t FRAME_RATE = 30;
+
+TArray<FColor> MakeImage() {
+	TArray<FColor> Image;
+	Image.SetNum(int32(FRAME_WIDTH * FRAME_HEIGHT));
+	std::mt19937 Random(42);
+	for (auto& Pixel : Image) { Pixel = FColor(uint8(Random()), uint8(Random()), uint8(Random()), 255); }
+	return Image;
+}
+
+void BM_EncodeVideo(benchmark::State& State) {
+	const size_t DstWidth = size_t(State.range(0));
+	const size_t DstHeight = size_t(State.range(1));
+	const std::wstring FileName = (std::filesystem::temp_directory_path() / "DMSSimVideoEncoderBenchmark.avi").wstring();
+	const auto Image = MakeImage();
+	const auto Frame = DMSSimBenchmark::MakeGroundTruthFrame(42);
+	auto Encoder = DMSSimVideoEncoder::CreateVideoEncoder(FileName, FRAME_WIDTH, FRAME_HEIGHT, DstWidth, DstHeight, FRAME_RATE, false, false);
+	if (!Encoder) {
+		State.SkipWithError("failed to create the video encoder");
+		return;
+	}
+	int FrameIdx = 0;
+	for (auto _ : State) { Encoder->AddFrame(Image, Frame, Frame, FrameIdx++); }
+	Encoder->Finalize();
+	Encoder.Reset();
+	std::error_code Error;
+	std::filesystem::remove(FileName, Error);
+	State.SetItemsProcessed(int64_t(State.iterations()));
+}
+BENCHMARK(BM_EncodeVideo)->Args({ int(FRAME_WIDTH), int(FRAME_HEIGHT) })->Args({ 1280, 960 })->Unit(benchmark::kMillisecond);
+
+} // anonymous namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "DMSSimUnrealShim.h"
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Minimal Unreal automation test framework, so the plugin tests in Private/Tests run as a plain executable.
+ * IMPLEMENT_SIMPLE_AUTOMATION_TEST registers the test in FAutomationTestFramework, the Test* checks record the failures.
+ */
+
+namespace EAutomationTestFlags {
+enum Type : uint32 {
+	EditorContext = 0x1,
+	ClientContext = 0x2,
+	ServerContext = 0x4,
+	CommandletContext = 0x8,
+	ApplicationContextMask = EditorContext | ClientContext | ServerContext | CommandletContext,
+	SmokeFilter = 0x1000000,
+	EngineFilter = 0x2000000,
+	ProductFilter = 0x4000000,
+};
+} // namespace EAutomationTestFlags
+
+class FAutomationTestBase {
+public:
+	explicit FAutomationTestBase(const FString& InName);
+	virtual ~FAutomationTestBase() {}
+
+	virtual bool RunTest(const FString& Parameters) = 0;
+
+	const FString& GetTestName() const { return Name_; }
+	const TArray<FString>& GetErrors() const { return Errors_; }
+	void ClearErrors() { Errors_.Empty(); }
+
+	void AddError(const FString& Error) { Errors_.Add(Error); }
+	bool TestTrue(const FString& What, bool Value) { if (!Value) { AddError(What + TEXT(": expected true")); } return Value; }
+	bool TestFalse(const FString& What, bool Value) { if (Value) { AddError(What + TEXT(": expected false")); } return !Value; }
+	bool TestEqual(const FString& What, float Actual, float Expected, float Tolerance = KINDA_SMALL_NUMBER) {
+		return TestTrue(What, FMath::Abs(Actual - Expected) <= Tolerance);
+	}
+	bool TestEqual(const FString& What, double Actual, double Expected, double Tolerance = KINDA_SMALL_NUMBER) {
+		return TestTrue(What, std::abs(Actual - Expected) <= Tolerance);
+	}
+	template <typename TActual, typename TExpected>
+	bool TestEqual(const FString& What, const TActual& Actual, const TExpected& Expected) { return TestTrue(What, Actual == Expected); }
+	template <typename TActual, typename TExpected>
+	bool TestNotEqual(const FString& What, const TActual& Actual, const TExpected& Expected) { return TestFalse(What, Actual == Expected); }
+	template <typename T>
+	bool TestNotNull(const FString& What, const T* Pointer) { return TestTrue(What, Pointer != nullptr); }
+
+private:
+	FString         Name_;
+	TArray<FString> Errors_;
+};
+
+class FAutomationTestFramework {
+public:
+	static FAutomationTestFramework& Get() {
+		static FAutomationTestFramework Framework;
+		return Framework;
+	}
+
+	void RegisterAutomationTest(FAutomationTestBase* Test) { Tests_.push_back(Test); }
+	const std::vector<FAutomationTestBase*>& GetTests() const { return Tests_; }
+
+private:
+	std::vector<FAutomationTestBase*> Tests_;
+};
+
+inline FAutomationTestBase::FAutomationTestBase(const FString& InName) : Name_(InName) { FAutomationTestFramework::Get().RegisterAutomationTest(this); }
+
+#define IMPLEMENT_SIMPLE_AUTOMATION_TEST(TClass, PrettyName, TFlags) \
+	class TClass : public FAutomationTestBase { \
+	public: \
+		TClass() : FAutomationTestBase(FString(PrettyName)) {} \
+		bool RunTest(const FString& Parameters) override; \
+	}; \
+	static TClass TClass##AutomationTestInstance;
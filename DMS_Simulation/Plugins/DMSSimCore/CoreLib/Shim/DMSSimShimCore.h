@@ -0,0 +1,400 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <cwctype>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Minimal replacements of the Unreal core types used by the DMSSimCore sources, for the standalone DMSSimCoreLib build.
+ * Only the subset of the API the plugin uses is provided. The semantics follow Unreal where the output depends on them
+ * (case-insensitive FString comparison, row-vector matrices, degrees in FRotator), everything else is kept simple.
+ */
+
+using uint8 = uint8_t;
+using uint16 = uint16_t;
+using uint32 = uint32_t;
+using uint64 = uint64_t;
+using int8 = int8_t;
+using int16 = int16_t;
+using int32 = int32_t;
+using int64 = int64_t;
+using TCHAR = wchar_t;
+using ANSICHAR = char;
+using UTF8CHAR = char;
+
+#define TEXT(x) L##x
+#define INDEX_NONE (-1)
+#define FORCEINLINE inline
+#define WITH_EDITOR 0
+#ifndef WITH_DEV_AUTOMATION_TESTS
+#define WITH_DEV_AUTOMATION_TESTS 0
+#endif
+#define DMSSIMCORE_API
+#define check(Expr) assert(Expr)
+#define ensure(Expr) (!!(Expr))
+
+// reflection markup is ignored
+#define UENUM(...)
+#define UMETA(...)
+#define USTRUCT(...)
+#define UCLASS(...)
+#define UPROPERTY(...)
+#define UFUNCTION(...)
+#define GENERATED_BODY()
+#define GENERATED_UCLASS_BODY()
+
+// logging goes through DMSSimLog only
+namespace ELogVerbosity {
+enum Type : uint8 { NoLogging, Fatal, Error, Warning, Display, Log, Verbose, VeryVerbose };
+}
+#define DECLARE_LOG_CATEGORY_EXTERN(...)
+#define DEFINE_LOG_CATEGORY(...)
+#define DEFINE_LOG_CATEGORY_STATIC(...)
+#define UE_LOG(...) ((void)0)
+
+template <typename T>
+constexpr typename std::remove_reference<T>::type&& MoveTemp(T&& Value) { return static_cast<typename std::remove_reference<T>::type&&>(Value); }
+
+namespace DMSSimShim {
+/** Allocator that default-initializes elements, so resizing arrays of trivial types doesn't clear the memory, like TArray::SetNumUninitialized. */
+template <typename T>
+struct DefaultInitAllocator : std::allocator<T> {
+	template <typename U> struct rebind { using other = DefaultInitAllocator<U>; };
+	DefaultInitAllocator() = default;
+	template <typename U> DefaultInitAllocator(const DefaultInitAllocator<U>&) noexcept {}
+	template <typename U> void construct(U* Ptr) noexcept(std::is_nothrow_default_constructible<U>::value) { ::new (static_cast<void*>(Ptr)) U; }
+	template <typename U, typename... Args> void construct(U* Ptr, Args&&... Arguments) { ::new (static_cast<void*>(Ptr)) U(std::forward<Args>(Arguments)...); }
+};
+
+/** Element stored by TArray<bool>: std::vector<bool> packs bits and can't hand out bool references. */
+struct FBoolElement {
+	FBoolElement() = default;
+	FBoolElement(bool InValue) : Value(InValue) {}
+	operator bool&() { return Value; }
+	operator const bool&() const { return Value; }
+
+	bool Value;
+};
+static_assert(sizeof(FBoolElement) == sizeof(bool), "FBoolElement must have the layout of bool");
+
+template <typename T> struct TArrayElement { using Type = T; };
+template <> struct TArrayElement<bool> { using Type = FBoolElement; };
+
+std::string WideToUtf8(const wchar_t* Str);
+std::wstring Utf8ToWide(const char* Str);
+
+struct FUtf8Buffer {
+	explicit FUtf8Buffer(const wchar_t* Str) : Data(WideToUtf8(Str)) {}
+	const char* Get() const { return Data.c_str(); }
+	std::string Data;
+};
+
+struct FWideBuffer {
+	explicit FWideBuffer(const char* Str) : Data(Utf8ToWide(Str)) {}
+	const wchar_t* Get() const { return Data.c_str(); }
+	std::wstring Data;
+};
+} // namespace DMSSimShim
+
+#define TCHAR_TO_UTF8(Str) (DMSSimShim::FUtf8Buffer(Str).Get())
+#define TCHAR_TO_ANSI(Str) (DMSSimShim::FUtf8Buffer(Str).Get())
+#define UTF8_TO_TCHAR(Str) (DMSSimShim::FWideBuffer(Str).Get())
+#define ANSI_TO_TCHAR(Str) (DMSSimShim::FWideBuffer(Str).Get())
+
+/**
+ * @class TArray
+ * @brief Dynamic array over std::vector. Num() is int32 like in Unreal. Unlike std::vector<bool>, TArray<bool> stores real bools, so elements can be referenced.
+ */
+template <typename T>
+class TArray {
+	using StorageElement = typename DMSSimShim::TArrayElement<T>::Type;
+	using Storage = std::vector<StorageElement, DMSSimShim::DefaultInitAllocator<StorageElement>>;
+public:
+	using ElementType = T;
+	using iterator = T*;
+	using const_iterator = const T*;
+
+	TArray() = default;
+	TArray(std::initializer_list<T> Items) : Data_(Items.begin(), Items.end()) {}
+	TArray(const T* Items, int32 Count) : Data_(Items, Items + Count) {}
+
+	int32 Num() const { return int32(Data_.size()); }
+	bool IsEmpty() const { return Data_.empty(); }
+	bool IsValidIndex(int32 Index) const { return Index >= 0 && Index < Num(); }
+	T* GetData() { return reinterpret_cast<T*>(Data_.data()); }
+	const T* GetData() const { return reinterpret_cast<const T*>(Data_.data()); }
+	size_t GetTypeSize() const { return sizeof(T); }
+	int32 Max() const { return int32(Data_.capacity()); }
+
+	T& operator[](int32 Index) { return GetData()[Index]; }
+	const T& operator[](int32 Index) const { return GetData()[Index]; }
+	T& Last(int32 IndexFromEnd = 0) { return GetData()[Data_.size() - 1 - IndexFromEnd]; }
+	const T& Last(int32 IndexFromEnd = 0) const { return GetData()[Data_.size() - 1 - IndexFromEnd]; }
+	T& Top() { return Last(); }
+
+	int32 Add(const T& Item) { Data_.push_back(Item); return Num() - 1; }
+	int32 Add(T&& Item) { Data_.push_back(std::move(Item)); return Num() - 1; }
+	template <typename... Args> int32 Emplace(Args&&... Arguments) { Data_.emplace_back(std::forward<Args>(Arguments)...); return Num() - 1; }
+	template <typename... Args> T& Emplace_GetRef(Args&&... Arguments) { Data_.emplace_back(std::forward<Args>(Arguments)...); return Last(); }
+	int32 AddUnique(const T& Item) { const int32 Index = Find(Item); return Index != INDEX_NONE ? Index : Add(Item); }
+	int32 AddDefaulted(int32 Count = 1) { const int32 Index = Num(); Data_.resize(Data_.size() + Count); return Index; }
+	T& AddDefaulted_GetRef() { Data_.emplace_back(); return Last(); }
+	int32 AddZeroed(int32 Count = 1) { const int32 Index = Num(); Data_.resize(Data_.size() + Count, T{}); return Index; }
+	int32 AddUninitialized(int32 Count = 1) { return AddDefaulted(Count); }
+	void Append(const TArray& Other) { Data_.insert(Data_.end(), Other.Data_.begin(), Other.Data_.end()); }
+	void Append(const T* Items, int32 Count) { Data_.insert(Data_.end(), Items, Items + Count); }
+	int32 Insert(const T& Item, int32 Index) { Data_.insert(Data_.begin() + Index, Item); return Index; }
+	T Pop() { T Item = std::move(Last()); Data_.pop_back(); return Item; }
+	void Push(const T& Item) { Add(Item); }
+
+	void RemoveAt(int32 Index, int32 Count = 1, bool AllowShrinking = true) { Data_.erase(Data_.begin() + Index, Data_.begin() + Index + Count); }
+	void RemoveAtSwap(int32 Index, int32 Count = 1, bool AllowShrinking = true) { RemoveAt(Index, Count); }
+	int32 Remove(const T& Item) {
+		const auto OldNum = Data_.size();
+		Data_.erase(std::remove(Data_.begin(), Data_.end(), Item), Data_.end());
+		return int32(OldNum - Data_.size());
+	}
+	template <typename Predicate> int32 RemoveAll(Predicate Pred) {
+		const auto OldNum = Data_.size();
+		Data_.erase(std::remove_if(Data_.begin(), Data_.end(), Pred), Data_.end());
+		return int32(OldNum - Data_.size());
+	}
+
+	void Empty(int32 Slack = 0) { Data_.clear(); Data_.shrink_to_fit(); Data_.reserve(Slack); }
+	void Reset(int32 NewSize = 0) { Data_.clear(); Data_.reserve(NewSize); }
+	void Reserve(int32 Count) { Data_.reserve(Count); }
+	void Shrink() { Data_.shrink_to_fit(); }
+	void SetNum(int32 NewNum, bool AllowShrinking = true) { Data_.resize(NewNum); }
+	void SetNumUninitialized(int32 NewNum, bool AllowShrinking = true) { Data_.resize(NewNum); }
+	void SetNumZeroed(int32 NewNum, bool AllowShrinking = true) { Data_.resize(NewNum, T{}); }
+	void Init(const T& Item, int32 Count) { Data_.assign(Count, Item); }
+
+	int32 Find(const T& Item) const {
+		const auto It = std::find(begin(), end(), Item);
+		return It == end() ? INDEX_NONE : int32(It - begin());
+	}
+	bool Find(const T& Item, int32& Index) const { Index = Find(Item); return Index != INDEX_NONE; }
+	bool Contains(const T& Item) const { return Find(Item) != INDEX_NONE; }
+	template <typename Predicate> T* FindByPredicate(Predicate Pred) {
+		const auto It = std::find_if(begin(), end(), Pred);
+		return It == end() ? nullptr : It;
+	}
+	template <typename Predicate> const T* FindByPredicate(Predicate Pred) const {
+		const auto It = std::find_if(begin(), end(), Pred);
+		return It == end() ? nullptr : It;
+	}
+	template <typename Predicate> int32 IndexOfByPredicate(Predicate Pred) const {
+		const auto It = std::find_if(begin(), end(), Pred);
+		return It == end() ? INDEX_NONE : int32(It - begin());
+	}
+	template <typename Predicate> bool ContainsByPredicate(Predicate Pred) const { return IndexOfByPredicate(Pred) != INDEX_NONE; }
+
+	void Sort() { std::sort(begin(), end()); }
+	template <typename Predicate> void Sort(Predicate Pred) { std::sort(begin(), end(), Pred); }
+	template <typename Predicate> void StableSort(Predicate Pred) { std::stable_sort(begin(), end(), Pred); }
+
+	bool operator==(const TArray& Other) const { return Data_ == Other.Data_; }
+	bool operator!=(const TArray& Other) const { return Data_ != Other.Data_; }
+
+	iterator begin() { return GetData(); }
+	iterator end() { return GetData() + Data_.size(); }
+	const_iterator begin() const { return GetData(); }
+	const_iterator end() const { return GetData() + Data_.size(); }
+
+private:
+	Storage Data_;
+};
+
+/**
+ * @class FString
+ * @brief Wide string. Comparisons are case-insensitive like in Unreal.
+ */
+class FString {
+public:
+	FString() = default;
+	FString(const wchar_t* Str) : Data_(Str ? Str : L"") {}
+	FString(const char* Str) : Data_(DMSSimShim::Utf8ToWide(Str ? Str : "")) {}
+	FString(const std::wstring& Str) : Data_(Str) {}
+	FString(int32 Len, const wchar_t* Str) : Data_(Str, Len) {}
+
+	const TCHAR* operator*() const { return Data_.c_str(); }
+	int32 Len() const { return int32(Data_.size()); }
+	bool IsEmpty() const { return Data_.empty(); }
+	void Empty() { Data_.clear(); }
+	void Reset() { Data_.clear(); }
+
+	TCHAR& operator[](int32 Index) { return Data_[Index]; }
+	const TCHAR& operator[](int32 Index) const { return Data_[Index]; }
+	std::wstring::iterator begin() { return Data_.begin(); }
+	std::wstring::iterator end() { return Data_.end(); }
+	std::wstring::const_iterator begin() const { return Data_.begin(); }
+	std::wstring::const_iterator end() const { return Data_.end(); }
+
+	FString& Append(const FString& Str) { Data_ += Str.Data_; return *this; }
+	FString& Append(const TCHAR* Str) { Data_ += Str; return *this; }
+	FString& Append(const char* Str) { return Append(FString(Str)); }
+	FString& AppendChar(TCHAR Char) { Data_ += Char; return *this; }
+	FString& operator+=(const FString& Str) { return Append(Str); }
+	FString& operator+=(const TCHAR* Str) { return Append(Str); }
+	FString& operator+=(TCHAR Char) { return AppendChar(Char); }
+	friend FString operator+(FString Left, const FString& Right) { return Left.Append(Right); }
+	friend FString operator+(FString Left, const TCHAR* Right) { return Left.Append(Right); }
+	friend FString operator+(const TCHAR* Left, const FString& Right) { return FString(Left).Append(Right); }
+	friend FString operator/(const FString& Left, const FString& Right) {
+		FString Result(Left);
+		if (!Result.IsEmpty() && Result.Data_.back() != L'/') { Result.Data_ += L'/'; }
+		return Result.Append(Right);
+	}
+
+	friend bool operator==(const FString& Left, const FString& Right) { return Compare(Left, Right) == 0; }
+	friend bool operator!=(const FString& Left, const FString& Right) { return Compare(Left, Right) != 0; }
+	friend bool operator<(const FString& Left, const FString& Right) { return Compare(Left, Right) < 0; }
+	friend bool operator==(const FString& Left, const TCHAR* Right) { return Compare(Left, Right) == 0; }
+	friend bool operator!=(const FString& Left, const TCHAR* Right) { return Compare(Left, Right) != 0; }
+	bool Equals(const FString& Other) const { return Data_ == Other.Data_; }
+
+	FString ToLower() const {
+		FString Result(*this);
+		for (auto& Char : Result.Data_) { Char = TCHAR(std::towlower(Char)); }
+		return Result;
+	}
+	FString ToUpper() const {
+		FString Result(*this);
+		for (auto& Char : Result.Data_) { Char = TCHAR(std::towupper(Char)); }
+		return Result;
+	}
+	bool IsNumeric() const {
+		if (Data_.empty()) { return false; }
+		wchar_t* End = nullptr;
+		std::wcstod(Data_.c_str(), &End);
+		return End && *End == 0;
+	}
+	bool Contains(const FString& Str) const { return Find(Str) != INDEX_NONE; }
+	int32 Find(const FString& Str) const {
+		const auto Pos = ToLower().Data_.find(Str.ToLower().Data_);
+		return Pos == std::wstring::npos ? INDEX_NONE : int32(Pos);
+	}
+	bool StartsWith(const FString& Str) const { return Len() >= Str.Len() && Left(Str.Len()) == Str; }
+	bool EndsWith(const FString& Str) const { return Len() >= Str.Len() && Right(Str.Len()) == Str; }
+	FString Left(int32 Count) const { return FString(Data_.substr(0, std::max(0, std::min(Count, Len())))); }
+	FString Right(int32 Count) const { return FString(Data_.substr(Len() - std::max(0, std::min(Count, Len())))); }
+	FString Mid(int32 Start, int32 Count = INT32_MAX) const { return Start >= Len() ? FString() : FString(Data_.substr(Start, Count)); }
+	FString TrimStartAndEnd() const {
+		size_t Begin = 0, End = Data_.size();
+		while (Begin < End && std::iswspace(Data_[Begin])) { ++Begin; }
+		while (End > Begin && std::iswspace(Data_[End - 1])) { --End; }
+		return FString(Data_.substr(Begin, End - Begin));
+	}
+	const std::wstring& GetStdString() const { return Data_; }
+
+	static FString FromInt(int32 Value) { return FString(std::to_wstring(Value)); }
+	static FString SanitizeFloat(double Value) { return FString(std::to_wstring(Value)); }
+
+private:
+	static int Compare(const FString& Left, const FString& Right) { return wcscasecmp(Left.Data_.c_str(), Right.Data_.c_str()); }
+
+	std::wstring Data_;
+};
+
+struct FCString {
+	static int32 Atoi(const TCHAR* Str) { return int32(std::wcstol(Str, nullptr, 10)); }
+	static int64 Atoi64(const TCHAR* Str) { return int64(std::wcstoll(Str, nullptr, 10)); }
+	static float Atof(const TCHAR* Str) { return float(std::wcstod(Str, nullptr)); }
+	static int32 Strlen(const TCHAR* Str) { return int32(std::wcslen(Str)); }
+	static int32 Stricmp(const TCHAR* Left, const TCHAR* Right) { return wcscasecmp(Left, Right); }
+};
+
+enum class ESPMode { NotThreadSafe, ThreadSafe, Fast = ThreadSafe };
+
+template <typename T, ESPMode Mode = ESPMode::ThreadSafe> class TSharedPtr;
+template <typename T, ESPMode Mode = ESPMode::ThreadSafe> class TSharedRef;
+template <typename T, ESPMode Mode = ESPMode::ThreadSafe> class TWeakPtr;
+
+namespace DMSSimShim {
+template <typename T> struct FRawPtrProxy { T* Object; };
+template <typename T, typename Deleter> struct FRawPtrProxyWithDeleter { T* Object; Deleter Delete; };
+} // namespace DMSSimShim
+
+template <typename T> DMSSimShim::FRawPtrProxy<T> MakeShareable(T* Object) { return { Object }; }
+template <typename T, typename Deleter> DMSSimShim::FRawPtrProxyWithDeleter<T, Deleter> MakeShareable(T* Object, Deleter Delete) { return { Object, std::move(Delete) }; }
+
+/** Nullable shared pointer, reference counting is always thread safe. */
+template <typename T, ESPMode Mode>
+class TSharedPtr : public std::shared_ptr<T> {
+	using Base = std::shared_ptr<T>;
+public:
+	TSharedPtr() = default;
+	TSharedPtr(std::nullptr_t) {}
+	explicit TSharedPtr(T* Object) : Base(Object) {}
+	TSharedPtr(std::shared_ptr<T> Other) : Base(std::move(Other)) {}
+	template <typename U> TSharedPtr(const DMSSimShim::FRawPtrProxy<U>& Proxy) : Base(Proxy.Object) {}
+	template <typename U, typename D> TSharedPtr(const DMSSimShim::FRawPtrProxyWithDeleter<U, D>& Proxy) : Base(Proxy.Object, Proxy.Delete) {}
+	template <typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+	TSharedPtr(const TSharedPtr<U, Mode>& Other) : Base(Other) {}
+	template <typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+	TSharedPtr(const TSharedRef<U, Mode>& Other) : Base(Other) {}
+
+	T* Get() const { return Base::get(); }
+	bool IsValid() const { return Base::get() != nullptr; }
+	void Reset() { Base::reset(); }
+	TSharedRef<T, Mode> ToSharedRef() const { check(IsValid()); return TSharedRef<T, Mode>(*this); }
+};
+
+/** Non-nullable shared pointer. */
+template <typename T, ESPMode Mode>
+class TSharedRef : public std::shared_ptr<T> {
+	using Base = std::shared_ptr<T>;
+public:
+	explicit TSharedRef(std::shared_ptr<T> Other) : Base(std::move(Other)) { check(Base::get()); }
+	template <typename U> TSharedRef(const DMSSimShim::FRawPtrProxy<U>& Proxy) : Base(Proxy.Object) {}
+	template <typename U, typename D> TSharedRef(const DMSSimShim::FRawPtrProxyWithDeleter<U, D>& Proxy) : Base(Proxy.Object, Proxy.Delete) {}
+	template <typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+	TSharedRef(const TSharedRef<U, Mode>& Other) : Base(Other) {}
+
+	T* Get() const { return Base::get(); }
+	bool IsValid() const { return true; }
+};
+
+template <typename T, ESPMode Mode>
+class TWeakPtr : public std::weak_ptr<T> {
+	using Base = std::weak_ptr<T>;
+public:
+	TWeakPtr() = default;
+	TWeakPtr(const TSharedPtr<T, Mode>& Other) : Base(Other) {}
+	TWeakPtr(const TSharedRef<T, Mode>& Other) : Base(Other) {}
+
+	TSharedPtr<T, Mode> Pin() const { return TSharedPtr<T, Mode>(Base::lock()); }
+	bool IsValid() const { return !Base::expired(); }
+	void Reset() { Base::reset(); }
+};
+
+template <typename T, ESPMode Mode = ESPMode::ThreadSafe, typename... Args>
+TSharedRef<T, Mode> MakeShared(Args&&... Arguments) { return TSharedRef<T, Mode>(std::make_shared<T>(std::forward<Args>(Arguments)...)); }
+
+template <typename T>
+class TUniquePtr : public std::unique_ptr<T> {
+	using Base = std::unique_ptr<T>;
+public:
+	using Base::Base;
+	TUniquePtr() = default;
+	template <typename U, typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+	TUniquePtr(TUniquePtr<U>&& Other) : Base(Other.release()) {}
+
+	T* Get() const { return Base::get(); }
+	bool IsValid() const { return Base::get() != nullptr; }
+	void Reset(T* Object = nullptr) { Base::reset(Object); }
+	T* Release() { return Base::release(); }
+};
+
+template <typename T, typename... Args>
+TUniquePtr<T> MakeUnique(Args&&... Arguments) { return TUniquePtr<T>(new T(std::forward<Args>(Arguments)...)); }
@@ -0,0 +1,396 @@
+#pragma once
+
+#include "DMSSimShimCore.h"
+#include <cmath>
+
+/**
+ * @brief Unreal math types in single precision (UE 4.27 layout).
+ * Matrices use Unreal's row-vector convention: a point is transformed as P' = P * M, the rows of a rotation matrix are its axes.
+ */
+
+#ifndef PI
+#define PI (3.1415926535897932f)
+#endif
+#define SMALL_NUMBER (1.e-8f)
+#define KINDA_SMALL_NUMBER (1.e-4f)
+
+struct FMath {
+	template <typename T> static constexpr T Min(const T A, const T B) { return A < B ? A : B; }
+	template <typename T> static constexpr T Max(const T A, const T B) { return A > B ? A : B; }
+	template <typename T> static constexpr T Clamp(const T X, const T MinValue, const T MaxValue) { return X < MinValue ? MinValue : X < MaxValue ? X : MaxValue; }
+	template <typename T> static constexpr T Abs(const T A) { return A >= T(0) ? A : -A; }
+	template <typename T> static constexpr T Square(const T A) { return A * A; }
+	template <typename T> static constexpr T Sign(const T A) { return A > T(0) ? T(1) : A < T(0) ? T(-1) : T(0); }
+	template <typename T, typename U> static T Lerp(const T& A, const T& B, const U& Alpha) { return T(A + Alpha * (B - A)); }
+	template <typename T> static auto RadiansToDegrees(const T& Value) -> decltype(Value * (180.f / PI)) { return Value * (180.f / PI); }
+	template <typename T> static auto DegreesToRadians(const T& Value) -> decltype(Value * (PI / 180.f)) { return Value * (PI / 180.f); }
+	static float Sqrt(float Value) { return std::sqrt(Value); }
+	static float InvSqrt(float Value) { return 1.f / std::sqrt(Value); }
+	static float Sin(float Value) { return std::sin(Value); }
+	static float Cos(float Value) { return std::cos(Value); }
+	static float Tan(float Value) { return std::tan(Value); }
+	static float Acos(float Value) { return std::acos(Clamp(Value, -1.f, 1.f)); }
+	static float Atan2(float Y, float X) { return std::atan2(Y, X); }
+	static float Fmod(float X, float Y) { return std::fmod(X, Y); }
+	static void SinCos(float* ScalarSin, float* ScalarCos, float Value) { *ScalarSin = std::sin(Value); *ScalarCos = std::cos(Value); }
+	static int32 FloorToInt(float Value) { return int32(std::floor(Value)); }
+	static int32 CeilToInt(float Value) { return int32(std::ceil(Value)); }
+	static int32 RoundToInt(float Value) { return int32(std::floor(Value + 0.5f)); }
+	static float FloorToFloat(float Value) { return std::floor(Value); }
+	static float RoundToFloat(float Value) { return std::floor(Value + 0.5f); }
+	static int32 TruncToInt(float Value) { return int32(Value); }
+	static bool IsNearlyEqual(float A, float B, float Tolerance = SMALL_NUMBER) { return Abs(A - B) <= Tolerance; }
+	static bool IsNearlyZero(float Value, float Tolerance = SMALL_NUMBER) { return Abs(Value) <= Tolerance; }
+	static bool IsPowerOfTwo(uint32 Value) { return Value && !(Value & (Value - 1)); }
+	static int32 DivideAndRoundUp(int32 Dividend, int32 Divisor) { return (Dividend + Divisor - 1) / Divisor; }
+};
+
+struct FVector {
+	float X;
+	float Y;
+	float Z;
+
+	FVector() = default;
+	constexpr FVector(float InX, float InY, float InZ) : X(InX), Y(InY), Z(InZ) {}
+	explicit constexpr FVector(float InF) : X(InF), Y(InF), Z(InF) {}
+
+	static const FVector ZeroVector;
+	static const FVector OneVector;
+	static const FVector ForwardVector;
+	static const FVector RightVector;
+	static const FVector UpVector;
+
+	FVector operator+(const FVector& V) const { return FVector(X + V.X, Y + V.Y, Z + V.Z); }
+	FVector operator-(const FVector& V) const { return FVector(X - V.X, Y - V.Y, Z - V.Z); }
+	FVector operator*(const FVector& V) const { return FVector(X * V.X, Y * V.Y, Z * V.Z); }
+	FVector operator/(const FVector& V) const { return FVector(X / V.X, Y / V.Y, Z / V.Z); }
+	FVector operator*(float Scale) const { return FVector(X * Scale, Y * Scale, Z * Scale); }
+	FVector operator/(float Scale) const { const float RScale = 1.f / Scale; return FVector(X * RScale, Y * RScale, Z * RScale); }
+	FVector operator+(float Bias) const { return FVector(X + Bias, Y + Bias, Z + Bias); }
+	FVector operator-(float Bias) const { return FVector(X - Bias, Y - Bias, Z - Bias); }
+	FVector operator-() const { return FVector(-X, -Y, -Z); }
+	FVector& operator+=(const FVector& V) { X += V.X; Y += V.Y; Z += V.Z; return *this; }
+	FVector& operator-=(const FVector& V) { X -= V.X; Y -= V.Y; Z -= V.Z; return *this; }
+	FVector& operator*=(const FVector& V) { X *= V.X; Y *= V.Y; Z *= V.Z; return *this; }
+	FVector& operator/=(const FVector& V) { X /= V.X; Y /= V.Y; Z /= V.Z; return *this; }
+	FVector& operator*=(float Scale) { X *= Scale; Y *= Scale; Z *= Scale; return *this; }
+	FVector& operator/=(float Scale) { const float RScale = 1.f / Scale; X *= RScale; Y *= RScale; Z *= RScale; return *this; }
+	bool operator==(const FVector& V) const { return X == V.X && Y == V.Y && Z == V.Z; }
+	bool operator!=(const FVector& V) const { return !(*this == V); }
+	float& operator[](int32 Index) { return (&X)[Index]; }
+	float operator[](int32 Index) const { return (&X)[Index]; }
+
+	/** Dot product */
+	float operator|(const FVector& V) const { return X * V.X + Y * V.Y + Z * V.Z; }
+	/** Cross product */
+	FVector operator^(const FVector& V) const { return FVector(Y * V.Z - Z * V.Y, Z * V.X - X * V.Z, X * V.Y - Y * V.X); }
+	static float DotProduct(const FVector& A, const FVector& B) { return A | B; }
+	static FVector CrossProduct(const FVector& A, const FVector& B) { return A ^ B; }
+	static float Dist(const FVector& A, const FVector& B) { return (A - B).Size(); }
+	static float Distance(const FVector& A, const FVector& B) { return Dist(A, B); }
+	static float DistSquared(const FVector& A, const FVector& B) { return (A - B).SizeSquared(); }
+
+	float Size() const { return std::sqrt(X * X + Y * Y + Z * Z); }
+	float SizeSquared() const { return X * X + Y * Y + Z * Z; }
+	float Size2D() const { return std::sqrt(X * X + Y * Y); }
+	bool IsZero() const { return X == 0.f && Y == 0.f && Z == 0.f; }
+	bool IsNearlyZero(float Tolerance = KINDA_SMALL_NUMBER) const { return FMath::Abs(X) <= Tolerance && FMath::Abs(Y) <= Tolerance && FMath::Abs(Z) <= Tolerance; }
+	bool Equals(const FVector& V, float Tolerance = KINDA_SMALL_NUMBER) const { return FMath::Abs(X - V.X) <= Tolerance && FMath::Abs(Y - V.Y) <= Tolerance && FMath::Abs(Z - V.Z) <= Tolerance; }
+	bool Normalize(float Tolerance = SMALL_NUMBER) {
+		const float SquareSum = SizeSquared();
+		if (SquareSum > Tolerance) {
+			*this *= FMath::InvSqrt(SquareSum);
+			return true;
+		}
+		return false;
+	}
+	FVector GetSafeNormal(float Tolerance = SMALL_NUMBER) const {
+		FVector Result(*this);
+		return Result.Normalize(Tolerance) ? Result : ZeroVector;
+	}
+	FVector GetUnsafeNormal() const { return *this * FMath::InvSqrt(SizeSquared()); }
+	struct FRotator Rotation() const;
+};
+
+inline FVector operator*(float Scale, const FVector& V) { return V * Scale; }
+
+inline const FVector FVector::ZeroVector(0.f, 0.f, 0.f);
+inline const FVector FVector::OneVector(1.f, 1.f, 1.f);
+inline const FVector FVector::ForwardVector(1.f, 0.f, 0.f);
+inline const FVector FVector::RightVector(0.f, 1.f, 0.f);
+inline const FVector FVector::UpVector(0.f, 0.f, 1.f);
+
+struct FVector2D {
+	float X;
+	float Y;
+
+	FVector2D() = default;
+	constexpr FVector2D(float InX, float InY) : X(InX), Y(InY) {}
+
+	static const FVector2D ZeroVector;
+
+	FVector2D operator+(const FVector2D& V) const { return FVector2D(X + V.X, Y + V.Y); }
+	FVector2D operator-(const FVector2D& V) const { return FVector2D(X - V.X, Y - V.Y); }
+	FVector2D operator*(float Scale) const { return FVector2D(X * Scale, Y * Scale); }
+	FVector2D operator/(float Scale) const { return FVector2D(X / Scale, Y / Scale); }
+	FVector2D& operator+=(const FVector2D& V) { X += V.X; Y += V.Y; return *this; }
+	FVector2D& operator-=(const FVector2D& V) { X -= V.X; Y -= V.Y; return *this; }
+	FVector2D& operator*=(float Scale) { X *= Scale; Y *= Scale; return *this; }
+	bool operator==(const FVector2D& V) const { return X == V.X && Y == V.Y; }
+	bool operator!=(const FVector2D& V) const { return !(*this == V); }
+	float Size() const { return std::sqrt(X * X + Y * Y); }
+};
+
+inline const FVector2D FVector2D::ZeroVector(0.f, 0.f);
+
+struct FIntPoint {
+	int32 X = 0;
+	int32 Y = 0;
+
+	FIntPoint() = default;
+	constexpr FIntPoint(int32 InX, int32 InY) : X(InX), Y(InY) {}
+
+	bool operator==(const FIntPoint& Other) const { return X == Other.X && Y == Other.Y; }
+	bool operator!=(const FIntPoint& Other) const { return !(*this == Other); }
+};
+
+struct FRotator {
+	/** Rotation around the right axis, degrees */
+	float Pitch;
+	/** Rotation around the up axis, degrees */
+	float Yaw;
+	/** Rotation around the forward axis, degrees */
+	float Roll;
+
+	FRotator() = default;
+	constexpr FRotator(float InPitch, float InYaw, float InRoll) : Pitch(InPitch), Yaw(InYaw), Roll(InRoll) {}
+	explicit constexpr FRotator(float InF) : Pitch(InF), Yaw(InF), Roll(InF) {}
+
+	static const FRotator ZeroRotator;
+
+	FRotator operator+(const FRotator& R) const { return FRotator(Pitch + R.Pitch, Yaw + R.Yaw, Roll + R.Roll); }
+	FRotator operator-(const FRotator& R) const { return FRotator(Pitch - R.Pitch, Yaw - R.Yaw, Roll - R.Roll); }
+	FRotator operator*(float Scale) const { return FRotator(Pitch * Scale, Yaw * Scale, Roll * Scale); }
+	FRotator& operator*=(float Scale) { Pitch *= Scale; Yaw *= Scale; Roll *= Scale; return *this; }
+	FRotator& operator+=(const FRotator& R) { Pitch += R.Pitch; Yaw += R.Yaw; Roll += R.Roll; return *this; }
+	bool operator==(const FRotator& R) const { return Pitch == R.Pitch && Yaw == R.Yaw && Roll == R.Roll; }
+	bool operator!=(const FRotator& R) const { return !(*this == R); }
+	bool IsZero() const { return Pitch == 0.f && Yaw == 0.f && Roll == 0.f; }
+	bool Equals(const FRotator& R, float Tolerance = KINDA_SMALL_NUMBER) const {
+		return FMath::Abs(Pitch - R.Pitch) <= Tolerance && FMath::Abs(Yaw - R.Yaw) <= Tolerance && FMath::Abs(Roll - R.Roll) <= Tolerance;
+	}
+
+	FVector RotateVector(const FVector& V) const;
+	FVector UnrotateVector(const FVector& V) const;
+	FVector Vector() const;
+	FVector Euler() const { return FVector(Roll, Pitch, Yaw); }
+};
+
+inline FRotator operator*(float Scale, const FRotator& R) { return R * Scale; }
+
+inline const FRotator FRotator::ZeroRotator(0.f, 0.f, 0.f);
+
+struct FPlane : FVector {
+	float W;
+
+	FPlane() = default;
+	constexpr FPlane(float InX, float InY, float InZ, float InW) : FVector(InX, InY, InZ), W(InW) {}
+	constexpr FPlane(const FVector& V, float InW) : FVector(V), W(InW) {}
+};
+
+namespace EAxis {
+enum Type { None, X, Y, Z };
+}
+
+struct FMatrix {
+	alignas(16) float M[4][4];
+
+	FMatrix() = default;
+	FMatrix(const FPlane& InX, const FPlane& InY, const FPlane& InZ, const FPlane& InW) {
+		const FPlane* const Rows[] = { &InX, &InY, &InZ, &InW };
+		for (int32 i = 0; i < 4; ++i) { M[i][0] = Rows[i]->X; M[i][1] = Rows[i]->Y; M[i][2] = Rows[i]->Z; M[i][3] = Rows[i]->W; }
+	}
+	FMatrix(const FVector& InX, const FVector& InY, const FVector& InZ, const FVector& InW)
+		: FMatrix(FPlane(InX, 0.f), FPlane(InY, 0.f), FPlane(InZ, 0.f), FPlane(InW, 1.f)) {}
+
+	static const FMatrix Identity;
+
+	FMatrix operator*(const FMatrix& Other) const {
+		FMatrix Result;
+		for (int32 i = 0; i < 4; ++i) {
+			for (int32 j = 0; j < 4; ++j) {
+				Result.M[i][j] = M[i][0] * Other.M[0][j] + M[i][1] * Other.M[1][j] + M[i][2] * Other.M[2][j] + M[i][3] * Other.M[3][j];
+			}
+		}
+		return Result;
+	}
+	FVector TransformPosition(const FVector& V) const {
+		return FVector(
+			V.X * M[0][0] + V.Y * M[1][0] + V.Z * M[2][0] + M[3][0],
+			V.X * M[0][1] + V.Y * M[1][1] + V.Z * M[2][1] + M[3][1],
+			V.X * M[0][2] + V.Y * M[1][2] + V.Z * M[2][2] + M[3][2]);
+	}
+	FVector TransformVector(const FVector& V) const {
+		return FVector(
+			V.X * M[0][0] + V.Y * M[1][0] + V.Z * M[2][0],
+			V.X * M[0][1] + V.Y * M[1][1] + V.Z * M[2][1],
+			V.X * M[0][2] + V.Y * M[1][2] + V.Z * M[2][2]);
+	}
+	FMatrix GetTransposed() const {
+		FMatrix Result;
+		for (int32 i = 0; i < 4; ++i) {
+			for (int32 j = 0; j < 4; ++j) { Result.M[i][j] = M[j][i]; }
+		}
+		return Result;
+	}
+	FVector GetScaledAxis(EAxis::Type Axis) const {
+		const int32 Row = Axis == EAxis::X ? 0 : Axis == EAxis::Y ? 1 : 2;
+		return FVector(M[Row][0], M[Row][1], M[Row][2]);
+	}
+	FVector GetOrigin() const { return FVector(M[3][0], M[3][1], M[3][2]); }
+	FRotator Rotator() const;
+};
+
+/** Rotation + translation matrix, the formulas match FRotationTranslationMatrix of UE 4.27. */
+struct FRotationTranslationMatrix : FMatrix {
+	FRotationTranslationMatrix(const FRotator& Rot, const FVector& Origin) {
+		float SP, CP, SY, CY, SR, CR;
+		FMath::SinCos(&SP, &CP, FMath::DegreesToRadians(Rot.Pitch));
+		FMath::SinCos(&SY, &CY, FMath::DegreesToRadians(Rot.Yaw));
+		FMath::SinCos(&SR, &CR, FMath::DegreesToRadians(Rot.Roll));
+
+		M[0][0] = CP * CY;
+		M[0][1] = CP * SY;
+		M[0][2] = SP;
+		M[0][3] = 0.f;
+
+		M[1][0] = SR * SP * CY - CR * SY;
+		M[1][1] = SR * SP * SY + CR * CY;
+		M[1][2] = -SR * CP;
+		M[1][3] = 0.f;
+
+		M[2][0] = -(CR * SP * CY + SR * SY);
+		M[2][1] = CY * SR - CR * SP * SY;
+		M[2][2] = CR * CP;
+		M[2][3] = 0.f;
+
+		M[3][0] = Origin.X;
+		M[3][1] = Origin.Y;
+		M[3][2] = Origin.Z;
+		M[3][3] = 1.f;
+	}
+};
+
+struct FRotationMatrix : FRotationTranslationMatrix {
+	explicit FRotationMatrix(const FRotator& Rot) : FRotationTranslationMatrix(Rot, FVector::ZeroVector) {}
+};
+
+inline const FMatrix FMatrix::Identity(FPlane(1, 0, 0, 0), FPlane(0, 1, 0, 0), FPlane(0, 0, 1, 0), FPlane(0, 0, 0, 1));
+
+inline FRotator FMatrix::Rotator() const {
+	const FVector XAxis = GetScaledAxis(EAxis::X);
+	const FVector YAxis = GetScaledAxis(EAxis::Y);
+	const FVector ZAxis = GetScaledAxis(EAxis::Z);
+
+	FRotator Rotator(
+		FMath::RadiansToDegrees(std::atan2(XAxis.Z, std::sqrt(FMath::Square(XAxis.X) + FMath::Square(XAxis.Y)))),
+		FMath::RadiansToDegrees(std::atan2(XAxis.Y, XAxis.X)),
+		0.f);
+
+	const FVector SYAxis = FRotationMatrix(Rotator).GetScaledAxis(EAxis::Y);
+	Rotator.Roll = FMath::RadiansToDegrees(std::atan2(ZAxis | SYAxis, YAxis | SYAxis));
+	return Rotator;
+}
+
+inline FVector FRotator::RotateVector(const FVector& V) const { return FRotationMatrix(*this).TransformVector(V); }
+inline FVector FRotator::UnrotateVector(const FVector& V) const { return FRotationMatrix(*this).GetTransposed().TransformVector(V); }
+inline FVector FRotator::Vector() const { return FRotationMatrix(*this).GetScaledAxis(EAxis::X); }
+
+inline FRotator FVector::Rotation() const {
+	return FRotator(FMath::RadiansToDegrees(std::atan2(Z, std::sqrt(X * X + Y * Y))), FMath::RadiansToDegrees(std::atan2(Y, X)), 0.f);
+}
+
+/**
+ * @class FTransform
+ * @brief Rotation, translation and 3D scale. The rotation is kept as a matrix rather than a quaternion,
+ * Rotator() therefore matches Unreal up to the float rounding.
+ */
+class FTransform {
+public:
+	FTransform() : Rotation_(FMatrix::Identity), Translation_(FVector::ZeroVector), Scale3D_(FVector::OneVector) {}
+	explicit FTransform(const FRotator& Rotation, const FVector& Translation = FVector::ZeroVector, const FVector& Scale3D = FVector::OneVector)
+		: Rotation_(FRotationMatrix(Rotation)), Translation_(Translation), Scale3D_(Scale3D) {}
+	FTransform(const FVector& InX, const FVector& InY, const FVector& InZ, const FVector& InTranslation) : Translation_(InTranslation) {
+		const FVector Axes[] = { InX, InY, InZ };
+		Rotation_ = FMatrix::Identity;
+		for (int32 i = 0; i < 3; ++i) {
+			Scale3D_[i] = Axes[i].Size();
+			const FVector Axis = Scale3D_[i] > SMALL_NUMBER ? Axes[i] / Scale3D_[i] : FVector::ZeroVector;
+			Rotation_.M[i][0] = Axis.X;
+			Rotation_.M[i][1] = Axis.Y;
+			Rotation_.M[i][2] = Axis.Z;
+		}
+	}
+
+	FRotator Rotator() const { return Rotation_.Rotator(); }
+	FVector GetTranslation() const { return Translation_; }
+	FVector GetLocation() const { return Translation_; }
+	FVector GetScale3D() const { return Scale3D_; }
+	void SetTranslation(const FVector& Translation) { Translation_ = Translation; }
+
+	FMatrix ToMatrixWithScale() const {
+		FMatrix Result(Rotation_);
+		for (int32 i = 0; i < 3; ++i) {
+			for (int32 j = 0; j < 3; ++j) { Result.M[i][j] *= Scale3D_[i]; }
+		}
+		Result.M[3][0] = Translation_.X;
+		Result.M[3][1] = Translation_.Y;
+		Result.M[3][2] = Translation_.Z;
+		return Result;
+	}
+	FVector TransformPosition(const FVector& V) const { return ToMatrixWithScale().TransformPosition(V); }
+	FVector TransformVector(const FVector& V) const { return ToMatrixWithScale().TransformVector(V); }
+
+private:
+	FMatrix Rotation_;
+	FVector Translation_;
+	FVector Scale3D_;
+};
+
+/** 8 bit color in the memory layout of Unreal's FColor (BGRA). */
+struct FColor {
+	uint8 B;
+	uint8 G;
+	uint8 R;
+	uint8 A;
+
+	FColor() = default;
+	constexpr FColor(uint8 InR, uint8 InG, uint8 InB, uint8 InA = 255) : B(InB), G(InG), R(InR), A(InA) {}
+
+	bool operator==(const FColor& C) const { return B == C.B && G == C.G && R == C.R && A == C.A; }
+	bool operator!=(const FColor& C) const { return !(*this == C); }
+
+	static const FColor White;
+	static const FColor Black;
+	static const FColor Red;
+	static const FColor Green;
+	static const FColor Blue;
+	static const FColor Yellow;
+};
+
+inline const FColor FColor::White(255, 255, 255);
+inline const FColor FColor::Black(0, 0, 0);
+inline const FColor FColor::Red(255, 0, 0);
+inline const FColor FColor::Green(0, 255, 0);
+inline const FColor FColor::Blue(0, 0, 255);
+inline const FColor FColor::Yellow(255, 255, 0);
+
+struct FLinearColor {
+	float R = 0.f;
+	float G = 0.f;
+	float B = 0.f;
+	float A = 1.f;
+
+	FLinearColor() = default;
+	constexpr FLinearColor(float InR, float InG, float InB, float InA = 1.f) : R(InR), G(InG), B(InB), A(InA) {}
+};
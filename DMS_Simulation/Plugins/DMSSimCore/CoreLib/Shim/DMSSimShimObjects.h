@@ -0,0 +1,144 @@
+#pragma once
+
+#include "DMSSimShimMath.h"
+
+/**
+ * @brief Engine objects referenced by the core sources. They only carry the data the core code reads or writes,
+ * there is no garbage collector: objects made with NewObject are owned by the caller.
+ */
+
+class UObject {
+public:
+	virtual ~UObject() {}
+	virtual void PostLoad() {}
+};
+
+class UClass;
+
+template <typename T>
+T* NewObject(UObject* Outer = nullptr) { return new T(); }
+
+template <typename TEnum>
+class TEnumAsByte {
+public:
+	TEnumAsByte() = default;
+	TEnumAsByte(TEnum InValue) : Value_(uint8(InValue)) {}
+
+	operator TEnum() const { return TEnum(Value_); }
+	TEnum GetValue() const { return TEnum(Value_); }
+
+private:
+	uint8 Value_ = 0;
+};
+
+class UBlueprintFunctionLibrary : public UObject {};
+
+class USkeleton : public UObject {};
+
+class UCurveVector : public UObject {};
+
+struct FMinimalViewInfo {
+	FVector  Location = FVector::ZeroVector;
+	FRotator Rotation = FRotator::ZeroRotator;
+	float    FOV = 90.f;
+	float    AspectRatio = 1.33333333f;
+};
+
+class UCameraComponent : public UObject {
+public:
+	float FieldOfView = 90.f;
+	float AspectRatio = 1.777778f;
+
+	void SetFieldOfView(float InFieldOfView) { FieldOfView = InFieldOfView; }
+	void SetAspectRatio(float InAspectRatio) { AspectRatio = InAspectRatio; }
+	void SetRelativeLocation(const FVector& InLocation) { RelativeLocation = InLocation; }
+	void SetRelativeRotation(const FRotator& InRotation) { RelativeRotation = InRotation; }
+
+	FVector  RelativeLocation = FVector::ZeroVector;
+	FRotator RelativeRotation = FRotator::ZeroRotator;
+};
+
+class UAnimSequenceBase : public UObject {
+public:
+	virtual float GetPlayLength() const { return SequenceLength; }
+
+	float SequenceLength = 0.f;
+};
+
+class UAnimSequence : public UAnimSequenceBase {};
+
+struct FAnimSegment {
+	UAnimSequenceBase* AnimReference = nullptr;
+	float StartPos = 0.f;
+	float AnimStartTime = 0.f;
+	float AnimEndTime = 0.f;
+	float AnimPlayRate = 1.f;
+	int32 LoopingCount = 1;
+
+	float GetLength() const { return LoopingCount * (AnimEndTime - AnimStartTime) / FMath::Abs(AnimPlayRate); }
+};
+
+struct FAnimTrack {
+	TArray<FAnimSegment> AnimSegments;
+};
+
+struct FSlotAnimationTrack {
+	FString    SlotName;
+	FAnimTrack AnimTrack;
+};
+
+struct FCompositeSection {
+	FString SectionName;
+	float   StartTime = 0.f;
+	FString NextSectionName;
+
+	void SetTime(float InTime) { StartTime = InTime; }
+	float GetTime() const { return StartTime; }
+};
+
+struct FAnimSlotGroup {
+	static inline const FString DefaultSlotName = TEXT("DefaultSlot");
+};
+
+class UAnimMontage : public UAnimSequenceBase {
+public:
+	FSlotAnimationTrack& AddSlot(const FString& SlotName) {
+		FSlotAnimationTrack& Slot = SlotAnimTracks.AddDefaulted_GetRef();
+		Slot.SlotName = SlotName;
+		return Slot;
+	}
+	void SetSkeleton(USkeleton* InSkeleton) { Skeleton_ = InSkeleton; }
+	USkeleton* GetSkeleton() const { return Skeleton_; }
+	float GetPlayLength() const override {
+		float Length = 0.f;
+		for (const auto& Slot : SlotAnimTracks) {
+			for (const auto& Segment : Slot.AnimTrack.AnimSegments) { Length = FMath::Max(Length, Segment.StartPos + Segment.GetLength()); }
+		}
+		return Length;
+	}
+
+	float                       BlendIn = 0.25f;
+	float                       BlendOut = 0.25f;
+	float                       BlendOutTriggerTime = -1.f;
+	bool                        bEnableAutoBlendOut = true;
+	TArray<FSlotAnimationTrack> SlotAnimTracks;
+	TArray<FCompositeSection>   CompositeSections;
+
+private:
+	USkeleton* Skeleton_ = nullptr;
+};
+
+/** Render fences complete immediately, there is no render thread. */
+class FRenderCommandFence {
+public:
+	void BeginFence() {}
+	bool IsFenceComplete() const { return true; }
+	void Wait() const {}
+};
+
+class UEngine {
+public:
+	void AddOnScreenDebugMessage(int32 Key, float TimeToDisplay, FColor DisplayColor, const FString& DebugMessage, bool NewerOnTop = true) {}
+};
+
+extern UEngine* GEngine;
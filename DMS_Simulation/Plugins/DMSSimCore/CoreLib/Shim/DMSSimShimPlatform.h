@@ -0,0 +1,147 @@
+#pragma once
+
+#include "DMSSimShimCore.h"
+#include <cerrno>
+#include <ctime>
+#include <functional>
+#include <thread>
+
+/**
+ * @brief Platform layer of the shim: time, file system, command line and threads, implemented over the C++ standard library.
+ */
+
+struct FPlatformTime {
+	static double Seconds();
+};
+
+struct FGenericPlatformMisc {
+	static int32 NumberOfCores();
+	static int32 NumberOfCoresIncludingHyperthreads() { return NumberOfCores(); }
+	static FString GetEnvironmentVariable(const TCHAR* VariableName);
+};
+
+using FPlatformMisc = FGenericPlatformMisc;
+
+/** The MSVC CRT function used by DMSSimLog. */
+inline int ctime_s(char* Buffer, size_t BufferSize, const std::time_t* Time) {
+	char Result[26];
+	if (!Buffer || BufferSize < sizeof(Result) || !ctime_r(Time, Result)) { return EINVAL; }
+	std::memcpy(Buffer, Result, sizeof(Result));
+	return 0;
+}
+
+struct FPlatformProcess {
+	static void Sleep(float Seconds);
+};
+
+namespace ETimespan {
+constexpr int64 TicksPerSecond = 10000000;
+}
+
+struct FDateTime {
+	static FDateTime Now();
+	/** Formats the time like Unreal's default: yyyy.mm.dd-hh.mm.ss */
+	FString ToString() const;
+	/** 100 nanosecond ticks as in Unreal, although the shim's time has a resolution of a second. */
+	int64 GetTicks() const { return Seconds_ * ETimespan::TicksPerSecond; }
+	int32 GetYear() const;
+	int32 GetMonth() const;
+	int32 GetDay() const;
+	int32 GetHour() const;
+	int32 GetMinute() const;
+	int32 GetSecond() const;
+
+	int64 Seconds_ = 0;
+};
+
+struct FPaths {
+	static FString ProjectDir();
+	static FString ProjectContentDir() { return ProjectDir() + TEXT("Content/"); }
+	static FString ConvertRelativePathToFull(const FString& Path);
+	static FString ConvertRelativePathToFull(const FString& BasePath, const FString& Path) { return ConvertRelativePathToFull(BasePath / Path); }
+	static bool FileExists(const FString& Path);
+	static bool DirectoryExists(const FString& Path);
+	static FString GetPath(const FString& Path);
+	static FString GetCleanFilename(const FString& Path);
+	static FString GetBaseFilename(const FString& Path);
+	static FString GetExtension(const FString& Path);
+	static FString Combine(const FString& A, const FString& B) { return A / B; }
+};
+
+/** File system interface. There is a single platform file, so GetLowerLevel() returns the object itself. */
+class IPlatformFile {
+public:
+	using FDirectoryVisitorFunc = std::function<bool(const TCHAR*, bool)>;
+
+	bool FileExists(const TCHAR* Filename);
+	bool DirectoryExists(const TCHAR* Directory);
+	bool CreateDirectory(const TCHAR* Directory);
+	bool CreateDirectoryTree(const TCHAR* Directory);
+	bool DeleteFile(const TCHAR* Filename);
+	bool MoveFile(const TCHAR* To, const TCHAR* From);
+	int64 FileSize(const TCHAR* Filename);
+	/** Calls Visitor(Path, IsDirectory) for every entry of the directory until it returns false. */
+	bool IterateDirectory(const TCHAR* Directory, FDirectoryVisitorFunc Visitor);
+	IPlatformFile* GetLowerLevel() { return this; }
+};
+
+class FPlatformFileManager {
+public:
+	static FPlatformFileManager& Get();
+	IPlatformFile& GetPlatformFile() { return PlatformFile_; }
+
+private:
+	IPlatformFile PlatformFile_;
+};
+
+/** The process command line, set by the host application with FCommandLine::Set(). */
+struct FCommandLine {
+	static const TCHAR* Get();
+	static bool Set(const TCHAR* NewCommandLine);
+	/** Splits the command line by spaces, double quotes group words. Switches (tokens with a leading '-') are put into both arrays, without the dash. */
+	static void Parse(const TCHAR* CmdLine, TArray<FString>& Tokens, TArray<FString>& Switches);
+};
+
+enum EThreadPriority {
+	TPri_Normal,
+	TPri_AboveNormal,
+	TPri_BelowNormal,
+	TPri_Highest,
+	TPri_Lowest,
+};
+
+class FRunnable {
+public:
+	virtual ~FRunnable() {}
+	virtual bool Init() { return true; }
+	virtual uint32 Run() = 0;
+	virtual void Stop() {}
+	virtual void Exit() {}
+};
+
+/** Runs FRunnable::Init/Run/Exit on a std::thread. */
+class FRunnableThread {
+public:
+	static FRunnableThread* Create(FRunnable* Runnable, const TCHAR* ThreadName, uint32 StackSize = 0, EThreadPriority Priority = TPri_Normal);
+	virtual ~FRunnableThread();
+
+	/** Stops the runnable, with ShouldWait also joins the thread. */
+	bool Kill(bool ShouldWait = true);
+	void WaitForCompletion();
+
+private:
+	explicit FRunnableThread(FRunnable* Runnable);
+
+	FRunnable*  Runnable_;
+	std::thread Thread_;
+};
+
+enum class EParallelForFlags {
+	None = 0,
+	ForceSingleThread = 1,
+	Unbalanced = 2,
+};
+
+/** Splits [0, Num) into one contiguous chunk per core and calls Body for every index. */
+void ParallelFor(int32 Num, const std::function<void(int32)>& Body, bool ForceSingleThread = false);
+inline void ParallelFor(int32 Num, const std::function<void(int32)>& Body, EParallelForFlags Flags) { ParallelFor(Num, Body, Flags == EParallelForFlags::ForceSingleThread); }
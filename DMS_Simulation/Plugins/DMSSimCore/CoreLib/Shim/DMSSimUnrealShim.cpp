@@ -0,0 +1,270 @@
+#include "DMSSimUnrealShim.h"
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <mutex>
+
+namespace fs = std::filesystem;
+
+UEngine* GEngine = nullptr;
+
+namespace {
+
+// wchar_t is UTF-32 on the platforms DMSSimCoreLib is built for
+static_assert(sizeof(wchar_t) == 4, "wchar_t is expected to be UTF-32");
+
+std::wstring CommandLine_;
+std::mutex   CommandLineMutex_;
+
+FString ToGenericPath(const fs::path& Path) { return FString(Path.generic_wstring()); }
+
+int32 FindLastSeparator(const FString& Path) {
+	for (int32 i = Path.Len() - 1; i >= 0; --i) {
+		if (Path[i] == TEXT('/') || Path[i] == TEXT('\\')) { return i; }
+	}
+	return INDEX_NONE;
+}
+
+} // anonymous namespace
+
+namespace DMSSimShim {
+
+std::string WideToUtf8(const wchar_t* Str) {
+	std::string Result;
+	for (; Str && *Str; ++Str) {
+		const uint32 Code = uint32(*Str);
+		if (Code < 0x80) {
+			Result += char(Code);
+		} else if (Code < 0x800) {
+			Result += char(0xC0 | (Code >> 6));
+			Result += char(0x80 | (Code & 0x3F));
+		} else if (Code < 0x10000) {
+			Result += char(0xE0 | (Code >> 12));
+			Result += char(0x80 | ((Code >> 6) & 0x3F));
+			Result += char(0x80 | (Code & 0x3F));
+		} else {
+			Result += char(0xF0 | (Code >> 18));
+			Result += char(0x80 | ((Code >> 12) & 0x3F));
+			Result += char(0x80 | ((Code >> 6) & 0x3F));
+			Result += char(0x80 | (Code & 0x3F));
+		}
+	}
+	return Result;
+}
+
+std::wstring Utf8ToWide(const char* Str) {
+	std::wstring Result;
+	const auto* Bytes = reinterpret_cast<const unsigned char*>(Str);
+	while (Bytes && *Bytes) {
+		uint32 Code = *Bytes++;
+		int32 Continuation = 0;
+		if (Code >= 0xF0) { Code &= 0x07; Continuation = 3; }
+		else if (Code >= 0xE0) { Code &= 0x0F; Continuation = 2; }
+		else if (Code >= 0xC0) { Code &= 0x1F; Continuation = 1; }
+		for (; Continuation > 0 && (*Bytes & 0xC0) == 0x80; --Continuation) { Code = (Code << 6) | (*Bytes++ & 0x3F); }
+		Result += wchar_t(Code);
+	}
+	return Result;
+}
+
+} // namespace DMSSimShim
+
+double FPlatformTime::Seconds() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int32 FGenericPlatformMisc::NumberOfCores() { return int32(FMath::Max(std::thread::hardware_concurrency(), 1u)); }
+
+FString FGenericPlatformMisc::GetEnvironmentVariable(const TCHAR* VariableName) {
+	const char* const Value = std::getenv(TCHAR_TO_UTF8(VariableName));
+	return Value ? FString(Value) : FString();
+}
+
+void FPlatformProcess::Sleep(float Seconds) { std::this_thread::sleep_for(std::chrono::duration<float>(Seconds)); }
+
+FDateTime FDateTime::Now() {
+	FDateTime Result;
+	Result.Seconds_ = int64(std::time(nullptr));
+	return Result;
+}
+
+static std::tm ToLocalTime(const int64 Seconds) {
+	const std::time_t Time = std::time_t(Seconds);
+	std::tm LocalTime = {};
+	localtime_r(&Time, &LocalTime);
+	return LocalTime;
+}
+
+FString FDateTime::ToString() const {
+	const std::tm LocalTime = ToLocalTime(Seconds_);
+	char Buffer[32];
+	std::strftime(Buffer, sizeof(Buffer), "%Y.%m.%d-%H.%M.%S", &LocalTime);
+	return FString(Buffer);
+}
+
+int32 FDateTime::GetYear() const { return ToLocalTime(Seconds_).tm_year + 1900; }
+int32 FDateTime::GetMonth() const { return ToLocalTime(Seconds_).tm_mon + 1; }
+int32 FDateTime::GetDay() const { return ToLocalTime(Seconds_).tm_mday; }
+int32 FDateTime::GetHour() const { return ToLocalTime(Seconds_).tm_hour; }
+int32 FDateTime::GetMinute() const { return ToLocalTime(Seconds_).tm_min; }
+int32 FDateTime::GetSecond() const { return ToLocalTime(Seconds_).tm_sec; }
+
+FString FPaths::ProjectDir() { return ToGenericPath(fs::current_path()) + TEXT("/"); }
+
+FString FPaths::ConvertRelativePathToFull(const FString& Path) {
+	const bool TrailingSlash = Path.EndsWith(TEXT("/")) || Path.EndsWith(TEXT("\\"));
+	FString Result = ToGenericPath(fs::absolute(fs::path(Path.GetStdString())).lexically_normal());
+	if (!TrailingSlash && Result.EndsWith(TEXT("/"))) { Result = Result.Left(Result.Len() - 1); }
+	return Result;
+}
+
+bool FPaths::FileExists(const FString& Path) {
+	std::error_code Error;
+	return fs::is_regular_file(fs::path(Path.GetStdString()), Error);
+}
+
+bool FPaths::DirectoryExists(const FString& Path) {
+	std::error_code Error;
+	return fs::is_directory(fs::path(Path.GetStdString()), Error);
+}
+
+FString FPaths::GetPath(const FString& Path) {
+	const int32 Separator = FindLastSeparator(Path);
+	return Separator == INDEX_NONE ? FString() : Path.Left(Separator);
+}
+
+FString FPaths::GetCleanFilename(const FString& Path) { return Path.Mid(FindLastSeparator(Path) + 1); }
+
+FString FPaths::GetBaseFilename(const FString& Path) {
+	const FString Filename = GetCleanFilename(Path);
+	const auto Dot = Filename.GetStdString().rfind(L'.');
+	return Dot == std::wstring::npos ? Filename : Filename.Left(int32(Dot));
+}
+
+FString FPaths::GetExtension(const FString& Path) {
+	const FString Filename = GetCleanFilename(Path);
+	const auto Dot = Filename.GetStdString().rfind(L'.');
+	return Dot == std::wstring::npos ? FString() : Filename.Mid(int32(Dot) + 1);
+}
+
+bool IPlatformFile::FileExists(const TCHAR* Filename) { return FPaths::FileExists(Filename); }
+
+bool IPlatformFile::DirectoryExists(const TCHAR* Directory) { return FPaths::DirectoryExists(Directory); }
+
+bool IPlatformFile::CreateDirectory(const TCHAR* Directory) {
+	std::error_code Error;
+	fs::create_directory(fs::path(Directory), Error);
+	return DirectoryExists(Directory);
+}
+
+bool IPlatformFile::CreateDirectoryTree(const TCHAR* Directory) {
+	std::error_code Error;
+	fs::create_directories(fs::path(Directory), Error);
+	return DirectoryExists(Directory);
+}
+
+bool IPlatformFile::DeleteFile(const TCHAR* Filename) {
+	std::error_code Error;
+	return fs::remove(fs::path(Filename), Error);
+}
+
+bool IPlatformFile::MoveFile(const TCHAR* To, const TCHAR* From) {
+	std::error_code Error;
+	fs::rename(fs::path(From), fs::path(To), Error);
+	return !Error;
+}
+
+int64 IPlatformFile::FileSize(const TCHAR* Filename) {
+	std::error_code Error;
+	const auto Size = fs::file_size(fs::path(Filename), Error);
+	return Error ? -1 : int64(Size);
+}
+
+bool IPlatformFile::IterateDirectory(const TCHAR* Directory, FDirectoryVisitorFunc Visitor) {
+	std::error_code Error;
+	// like the engine, the entries are visited in the unspecified order of the file system, callers sort them if they need an order
+	for (const auto& Entry : fs::directory_iterator(fs::path(Directory), Error)) {
+		if (!Visitor(ToGenericPath(Entry.path()).GetStdString().c_str(), Entry.is_directory(Error))) { return false; }
+	}
+	return !Error;
+}
+
+FPlatformFileManager& FPlatformFileManager::Get() {
+	static FPlatformFileManager Manager;
+	return Manager;
+}
+
+const TCHAR* FCommandLine::Get() {
+	std::lock_guard<std::mutex> Lock(CommandLineMutex_);
+	return CommandLine_.c_str();
+}
+
+bool FCommandLine::Set(const TCHAR* NewCommandLine) {
+	std::lock_guard<std::mutex> Lock(CommandLineMutex_);
+	CommandLine_ = NewCommandLine ? NewCommandLine : L"";
+	return true;
+}
+
+void FCommandLine::Parse(const TCHAR* CmdLine, TArray<FString>& Tokens, TArray<FString>& Switches) {
+	const std::wstring Line(CmdLine ? CmdLine : L"");
+	size_t Pos = 0;
+	while (Pos < Line.size()) {
+		while (Pos < Line.size() && std::iswspace(Line[Pos])) { ++Pos; }
+		if (Pos == Line.size()) { break; }
+		std::wstring Token;
+		bool Quoted = false;
+		for (; Pos < Line.size() && (Quoted || !std::iswspace(Line[Pos])); ++Pos) {
+			if (Line[Pos] == L'"') { Quoted = !Quoted; }
+			else { Token += Line[Pos]; }
+		}
+		if (!Token.empty() && Token[0] == L'-') {
+			Switches.Add(FString(Token.substr(1)));
+			Tokens.Add(FString(Token.substr(1)));
+		} else {
+			Tokens.Add(FString(Token));
+		}
+	}
+}
+
+FRunnableThread::FRunnableThread(FRunnable* Runnable) : Runnable_(Runnable) {}
+
+FRunnableThread* FRunnableThread::Create(FRunnable* Runnable, const TCHAR* ThreadName, uint32 StackSize, EThreadPriority Priority) {
+	auto* const Thread = new FRunnableThread(Runnable);
+	Thread->Thread_ = std::thread([Runnable]() {
+		if (Runnable->Init()) {
+			Runnable->Run();
+			Runnable->Exit();
+		}
+	});
+	return Thread;
+}
+
+FRunnableThread::~FRunnableThread() { Kill(true); }
+
+bool FRunnableThread::Kill(bool ShouldWait) {
+	if (Runnable_) { Runnable_->Stop(); }
+	if (ShouldWait) { WaitForCompletion(); }
+	return true;
+}
+
+void FRunnableThread::WaitForCompletion() {
+	if (Thread_.joinable()) { Thread_.join(); }
+}
+
+void ParallelFor(int32 Num, const std::function<void(int32)>& Body, bool ForceSingleThread) {
+	const int32 NumThreads = ForceSingleThread ? 1 : FMath::Min(Num, FPlatformMisc::NumberOfCores());
+	if (NumThreads <= 1) {
+		for (int32 i = 0; i < Num; ++i) { Body(i); }
+		return;
+	}
+	std::vector<std::thread> Threads;
+	Threads.reserve(NumThreads - 1);
+	const auto RunChunk = [&](int32 Chunk) {
+		const int32 Begin = int32(int64(Num) * Chunk / NumThreads);
+		const int32 End = int32(int64(Num) * (Chunk + 1) / NumThreads);
+		for (int32 i = Begin; i < End; ++i) { Body(i); }
+	};
+	for (int32 Chunk = 1; Chunk < NumThreads; ++Chunk) { Threads.emplace_back(RunChunk, Chunk); }
+	RunChunk(0);
+	for (auto& Thread : Threads) { Thread.join(); }
+}
@@ -0,0 +1,11 @@
+/**
+ * @brief Thin replacement of the Unreal Engine API for building the UE-free parts of DMSSimCore as the standalone DMSSimCoreLib.
+ * The header is force-included into every DMSSimCoreLib source, like Unreal's precompiled header, and the Unreal include paths
+ * used by the sources (CoreMinimal.h, Math/Vector.h, ...) resolve to stubs in Shim/Unreal which only include this file.
+ */
+#pragma once
+
+#include "DMSSimShimCore.h"
+#include "DMSSimShimMath.h"
+#include "DMSSimShimPlatform.h"
+#include "DMSSimShimObjects.h"
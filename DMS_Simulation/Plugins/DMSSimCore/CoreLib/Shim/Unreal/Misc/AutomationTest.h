@@ -0,0 +1,3 @@
+#pragma once
+#include "DMSSimUnrealShim.h"
+#include "DMSSimShimAutomationTest.h"
@@ -0,0 +1,29 @@
+// Runs the Unreal automation tests of the plugin compiled against the shim.
+// Usage: DMSSimCoreTests [name prefix], e.g. DMSSimCoreTests DMSSim.GroundTruthRecorder
+
+#include "Misc/AutomationTest.h"
+#include <iostream>
+
+int main(int argc, char** argv) {
+	const FString Prefix(argc > 1 ? argv[1] : "");
+	int Failed = 0;
+	int Run = 0;
+	for (FAutomationTestBase* const Test : FAutomationTestFramework::Get().GetTests()) {
+		const std::string Name = TCHAR_TO_UTF8(*Test->GetTestName());
+		if (!Prefix.IsEmpty() && Name.compare(0, Prefix.Len(), TCHAR_TO_UTF8(*Prefix)) != 0) { continue; }
+		++Run;
+		Test->ClearErrors();
+		bool Passed = false;
+		try {
+			Passed = Test->RunTest(FString());
+		} catch (const std::exception& Exception) {
+			Test->AddError(FString(Exception.what()));
+		}
+		Passed = Passed && Test->GetErrors().Num() == 0;
+		std::cout << (Passed ? "[  PASSED  ] " : "[  FAILED  ] ") << Name << std::endl;
+		for (const FString& Error : Test->GetErrors()) { std::cout << "    " << TCHAR_TO_UTF8(*Error) << std::endl; }
+		if (!Passed) { ++Failed; }
+	}
+	std::cout << Run - Failed << " of " << Run << " tests passed" << std::endl;
+	return Failed == 0 && Run > 0 ? 0 : 1;
+}
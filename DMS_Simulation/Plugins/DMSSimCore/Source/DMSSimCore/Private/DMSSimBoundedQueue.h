@@ -0,0 +1,88 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include "HAL/PlatformTime.h"
+
+/**
+ * @class DMSSimBoundedQueue
+ * @brief Blocking FIFO queue with a fixed capacity, used to pass work between the game thread and worker threads.
+ * Push blocks while the queue is full (backpressure on the producer), Pop blocks while it is empty.
+ * After Close is called, Push rejects new items and Pop drains the remaining items before returning false.
+ * The time each side spends blocked is accumulated and can be queried for profiling.
+ */
+template <typename T>
+class DMSSimBoundedQueue
+{
+public:
+	explicit DMSSimBoundedQueue(size_t Capacity) : Capacity_(Capacity > 0 ? Capacity : 1) {}
+	DMSSimBoundedQueue(const DMSSimBoundedQueue&) = delete;
+	DMSSimBoundedQueue& operator=(const DMSSimBoundedQueue&) = delete;
+
+	/**
+	 * Adds an item to the queue, waits while the queue is full.
+	 * @return false, if the queue was closed and the item was not added.
+	 */
+	bool Push(T&& Item) {
+		std::unique_lock<std::mutex> Lock(Mutex_);
+		if (!Closed_ && Items_.size() >= Capacity_) {
+			const double WaitStart = FPlatformTime::Seconds();
+			NotFull_.wait(Lock, [this]() { return Closed_ || Items_.size() < Capacity_; });
+			PushBlockedTime_ += FPlatformTime::Seconds() - WaitStart;
+		}
+		if (Closed_) { return false; }
+		Items_.push_back(std::move(Item));
+		Lock.unlock();
+		NotEmpty_.notify_one();
+		return true;
+	}
+
+	/**
+	 * Takes the oldest item from the queue, waits while the queue is empty.
+	 * @return false, if the queue was closed and there are no more items left.
+	 */
+	bool Pop(T& Item) {
+		std::unique_lock<std::mutex> Lock(Mutex_);
+		if (!Closed_ && Items_.empty()) {
+			const double WaitStart = FPlatformTime::Seconds();
+			NotEmpty_.wait(Lock, [this]() { return Closed_ || !Items_.empty(); });
+			PopBlockedTime_ += FPlatformTime::Seconds() - WaitStart;
+		}
+		if (Items_.empty()) { return false; }
+		Item = std::move(Items_.front());
+		Items_.pop_front();
+		Lock.unlock();
+		NotFull_.notify_one();
+		return true;
+	}
+
+	/** Rejects further pushes and wakes up all waiting threads. */
+	void Close() {
+		{
+			std::lock_guard<std::mutex> Lock(Mutex_);
+			Closed_ = true;
+		}
+		NotEmpty_.notify_all();
+		NotFull_.notify_all();
+	}
+
+	size_t Num() const { std::lock_guard<std::mutex> Lock(Mutex_); return Items_.size(); }
+	size_t GetCapacity() const { return Capacity_; }
+
+	/** Total time in seconds the producer was blocked on a full queue. */
+	double GetPushBlockedTime() const { std::lock_guard<std::mutex> Lock(Mutex_); return PushBlockedTime_; }
+
+	/** Total time in seconds the consumer was blocked on an empty queue. */
+	double GetPopBlockedTime() const { std::lock_guard<std::mutex> Lock(Mutex_); return PopBlockedTime_; }
+
+private:
+	mutable std::mutex      Mutex_;
+	std::condition_variable NotEmpty_;
+	std::condition_variable NotFull_;
+	std::deque<T>           Items_;
+	const size_t            Capacity_;
+	double                  PushBlockedTime_ = 0.0;
+	double                  PopBlockedTime_ = 0.0;
+	bool                    Closed_ = false;
+};
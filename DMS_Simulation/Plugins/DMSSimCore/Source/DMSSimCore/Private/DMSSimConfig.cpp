@@ -12,7 +12,7 @@
 namespace DMSSimConfig {
 namespace {
 bool Recording = false;
-std::vector<TSharedPtr<DMSSimScenarioParser>> ScenarioParsers_;
+std::vector<DMSSimScenarioEntry> ScenarioParsers_;
 TSharedPtr<DMSSimScenarioParser> CurrentScenarioParser_;
 
 std::string ScenarioParserErrorMessage;
@@ -22,6 +22,7 @@ std::wstring OutputDirectory;
 float FrameTime = 0.0f;
 int   FrameIndex = 0;
 int NumRemainingFrames_ = 0;
+size_t FrameQueueCapacity_ = DEFAULT_FRAME_QUEUE_CAPACITY;
 CameraSetCallback CameraCallback;
 
 std::wstring MakeDateTimeStr()
@@ -40,12 +41,12 @@ std::wstring MakeDateTimeStr()
 const TSharedPtr<DMSSimScenarioParser> GetScenarioParser(const int32 index) {
 	DMSSimLog::Info() << "Get Scenario Parser " << index << " from " << ScenarioParsers_.size() << FL;
 	if (index >= ScenarioParsers_.size()) { return nullptr; }
-	return ScenarioParsers_[index];
+	return ScenarioParsers_[index].Get();
 }
 
 void SetCurrentScenarioParser(const TSharedPtr<DMSSimScenarioParser> Parser) { CurrentScenarioParser_ = Parser; }
 
-void SetScenarioParsers(const std::vector<TSharedPtr<DMSSimScenarioParser>> Parsers) { ScenarioParsers_ = Parsers; }
+void SetScenarioParsers(const std::vector<TSharedPtr<DMSSimScenarioParser>> Parsers) { ScenarioParsers_.assign(Parsers.begin(), Parsers.end()); }
 
 void ResetScenarioParsers() { ScenarioParsers_.clear(); }
 
@@ -87,6 +88,8 @@ void SetNumRemainingFrames(int NumFrames) { NumRemainingFrames_ = NumFrames; }
 
 int GetNumRemainingFrames() { return NumRemainingFrames_; }
 
+size_t GetFrameQueueCapacity() { return FrameQueueCapacity_; }
+
 bool StartRecording() {
 	if (!Recording) {
 		Recording = true;
@@ -116,15 +119,25 @@ void SetCameraComponent(UCameraComponent* const Camera) { if (CameraCallback) {
 
 void SetCameraCallback(const CameraSetCallback& Callback) { CameraCallback = Callback; }
 
-void ResetGroundTruthData() { memset(&GroundTruthFrame, 0, sizeof(GroundTruthFrame)); }
+void ResetGroundTruthData() {
+	GroundTruthFrame.Scenario.Reset();
+	memset(&GroundTruthFrame.Data, 0, sizeof(GroundTruthFrame.Data));
+}
 
 const DMSSimGroundTruthFrame& GetGroundTruthFrame() { return GroundTruthFrame; }
 
-void SetGroundTruthCommonData(const DMSSimGroundTruthCommon& CommonData) { GroundTruthFrame.Common = CommonData; }
+void ResetGroundTruthScenario() { GroundTruthFrame.Scenario.Reset(); }
+
+void SetGroundTruthScenario(const DMSSimGroundTruthScenarioConstantsPtr& Scenario) { GroundTruthFrame.Scenario = Scenario; }
+
+void SetGroundTruthCarPose(const FVector& CarPosition_inWorld, const FRotator& CarRotation_inWorld) {
+	GroundTruthFrame.Data.CarPosition_inWorld = CarPosition_inWorld;
+	GroundTruthFrame.Data.CarRotation_inWorld = CarRotation_inWorld;
+}
 
 void SetGroundTruthOccupantData(FDMSSimOccupantType OccupantType, const DMSSimGroundTruthOccupant& OccupantData) {
 	assert(OccupantType < FDMSSimOccupantType::PassengerCount);
-	GroundTruthFrame.Occupants[static_cast<uint8>(OccupantType)] = OccupantData;
+	GroundTruthFrame.Data.Occupants[static_cast<uint8>(OccupantType)] = OccupantData;
 }
 
 bool IsOutputDirectoryPresent() { return !!OutputDirectoryPtr; }
@@ -155,6 +168,7 @@ void Initialize() {
 
 	std::wstring ScenarioPath;
 	std::wstring OutDir;
+	bool IndexScenarios = false;
 	for (size_t i = 0; i < Tokens.Num(); ++i) {
 		const auto ArgSwitch = Tokens[i].ToLower();
 		const auto ArgValue = ((i + 1) < Tokens.Num())? Tokens[i + 1] : FString();
@@ -192,6 +206,16 @@ void Initialize() {
 			DMSSimLog::Info() << "Output directory: " << OutDir << FL;
 			++i;
 			break;
+		case TEXT('q'):
+			if (ArgValue.IsNumeric() && FCString::Atoi(*ArgValue) > 0) { FrameQueueCapacity_ = FCString::Atoi(*ArgValue); }
+			else { DMSSimLog::Warn() << "Invalid frame queue capacity: " << ArgValue << FL; }
+			DMSSimLog::Info() << "Frame queue capacity: " << FrameQueueCapacity_ << FL;
+			++i;
+			break;
+		case TEXT('i'): // parse the scenarios of a directory just before they run
+			IndexScenarios = true;
+			DMSSimLog::Info() << "Scenarios are parsed when they run" << FL;
+			break;
 		case TEXT('p'): // skip profile (handled in the profile selection module)
 			++i;
 			break;
@@ -235,10 +259,11 @@ void Initialize() {
 	try {
 		if (FileManager.FileExists(ScenarioPath.c_str())) {
 			DMSSimLog::Info() << "Loading scenario: " << ScenarioPath << FL;
-			ScenarioParsers_.emplace_back(CreateScenarioParser(ScenarioPath.c_str()));
+			for (const auto& Scenario : CreateScenarioSweep(ScenarioPath.c_str())) { ScenarioParsers_.emplace_back(Scenario); }
 		} else if (FileManager.DirectoryExists(ScenarioPath.c_str())) {
 			DMSSimLog::Info() << "Loading all scenarios from directory: " << ScenarioPath << FL;
-			ScenarioParsers_ = CreateScenarioParsers(ScenarioPath.c_str());
+			if (IndexScenarios) { ScenarioParsers_ = IndexScenarioParsers(ScenarioPath.c_str()); }
+			else { SetScenarioParsers(CreateScenarioParsers(ScenarioPath.c_str())); }
 		} else {
 			DMSSimLog::Warn() << "No scenario path specified" << FL;
 			return;
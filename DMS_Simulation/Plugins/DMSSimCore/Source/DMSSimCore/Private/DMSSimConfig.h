@@ -6,12 +6,24 @@
 
 #include <functional>
 #include <string>
+#include <type_traits>
 #include <vector>
+#include "DMSSimFixedArray.h"
 #include "DMSSimScenarioParser.h"
 #include "DMSSimScenarioBlueprint.h"
 
 
 constexpr size_t NUMBER_OF_FRAMES_TO_SKIP = 3; // to make sure all resources are properly loaded
+constexpr size_t DEFAULT_FRAME_QUEUE_CAPACITY = 8; // max number of frames waiting for the recording thread, before the renderer blocks
+constexpr size_t FRAME_BUFFERS_IN_FLIGHT = 4; // frame buffers held outside the frame queue: render requests, previous and current frame of the recorder
+constexpr size_t DEFAULT_GROUND_TRUTH_QUEUE_CAPACITY = 64; // max number of ground truth rows waiting for the CSV writer thread, before the renderer blocks
+constexpr size_t LABEL_STREAM_BUFFER_SIZE = 64 * 1024; // write buffer of the streamed OpenLABEL file
+constexpr size_t LABEL_POOL_INITIAL_SIZE = 256 * 1024; // initial buffer of the memory pool the labelers build the json values of a frame in
+constexpr size_t DEFAULT_LABEL_COMMIT_WINDOW = 16; // max number of frames the label workers serialize ahead of the oldest frame not written yet
+
+constexpr int32 MAX_FACIAL_LANDMARKS = 72; // the 68 facial landmarks and the middles of the upper and lower eyelids
+constexpr int32 FACE_BOUNDING_BOX_3D_CORNERS = 8;
+constexpr int32 MAX_PUPIL_IRIS_LANDMARKS = 9; // per pupil and iris of an eye
 
 struct DMSSimCustomLight
 {
@@ -56,6 +68,7 @@ struct DMSCamera
 	float Contrast;
 	float BloomIntensity;
 	float FocusOffset;
+	float Distortion[DMSSIM_DISTORTION_COEFFICIENT_COUNT] = {}; // k1, k2, p1, p2, k3, all 0 without lens distortion
 };
 
 struct DMSBlendoutDefaults
@@ -71,7 +84,39 @@ struct DMSBlendoutDefaults
 	float SteeringWheel;
 };
 
-struct DMSSimGroundTruthCommon
+/**
+ * @class DMSSimGroundTruthCoordinateSpace
+ * @brief Copy of the coordinate space of a scenario, kept in its ground truth constants, so the ground truth threads
+ * don't read the scenario parser, which the game thread replaces. Without a scenario, it is the default coordinate space.
+ */
+class DMSSimGroundTruthCoordinateSpace : public DMSSimCoordinateSpace
+{
+public:
+	DMSSimGroundTruthCoordinateSpace() : DMSSimGroundTruthCoordinateSpace(DMSSimScenarioParser::GetDefaultCoordinateSpace()) {}
+	DMSSimGroundTruthCoordinateSpace(const DMSSimGroundTruthCoordinateSpace&) = default;
+	explicit DMSSimGroundTruthCoordinateSpace(const DMSSimCoordinateSpace& Space) :
+		CarModel_(Space.GetCarModel() ? Space.GetCarModel() : ""), Rotation_(Space.GetRotation()), Translation_(Space.GetTranslation()), Scale_(Space.GetScale()) {}
+	DMSSimGroundTruthCoordinateSpace& operator=(const DMSSimGroundTruthCoordinateSpace&) = default;
+	virtual ~DMSSimGroundTruthCoordinateSpace() {}
+
+	const char* GetCarModel() const override { return CarModel_.c_str(); }
+	FRotator GetRotation() const override { return Rotation_; }
+	FVector  GetTranslation() const override { return Translation_; }
+	FVector  GetScale() const override { return Scale_; }
+
+private:
+	std::string CarModel_;
+	FRotator    Rotation_;
+	FVector     Translation_;
+	FVector     Scale_;
+};
+
+/**
+ * @struct DMSSimGroundTruthScenarioConstants
+ * @brief Ground truth that doesn't change during a scenario: the scenario description, camera, lights, occupants and coordinate space.
+ * It is created once per scenario and shared by all its frames, so it must not be modified once it is set.
+ */
+struct DMSSimGroundTruthScenarioConstants
 {
 	int32 ScenarioIdx;
 	int32 ScenariosCount;
@@ -86,13 +131,16 @@ struct DMSSimGroundTruthCommon
 	DMSCamera Camera;
 	DMSSimCustomLight CameraLight;
 	DMSBlendoutDefaults BlendoutDefaults;
-	FVector  CarPosition_inWorld;
-	FRotator CarRotation_inWorld;
 	int	OccupantCount;
 	TArray<FDMSSimOccupant> Occupants;
 	DMSGroundTruthSettings GroundTruthSettings;
+	DMSSimGroundTruthCoordinateSpace CoordinateSpace;
 };
 
+/**
+ * @struct DMSSimGroundTruthOccupant
+ * @brief Ground truth of an occupant in a frame. The landmarks are stored inline, so the struct can be copied with memcpy.
+ */
 struct DMSSimGroundTruthOccupant
 {
 	bool     Initialized;
@@ -147,22 +195,22 @@ struct DMSSimGroundTruthOccupant
 	float    HorizontalMouthOpening;
 	float    VerticalMouthOpening;
 
-	TArray<bool> FacialLandmarksVisible;
-	TArray<FVector> FacialLandmarks3D_inCam;
-	TArray<FVector2D> FacialLandmarks2D;
+	DMSSimFixedArray<bool, MAX_FACIAL_LANDMARKS> FacialLandmarksVisible;
+	DMSSimFixedArray<FVector, MAX_FACIAL_LANDMARKS> FacialLandmarks3D_inCam;
+	DMSSimFixedArray<FVector2D, MAX_FACIAL_LANDMARKS> FacialLandmarks2D;
 	bool FaceBoundingBox3DVisible;
-	TArray<FVector> FaceBoundingBox3D_inCam;
+	DMSSimFixedArray<FVector, FACE_BOUNDING_BOX_3D_CORNERS> FaceBoundingBox3D_inCam;
 	bool FaceBoundingBox2DVisible;
 	FDMSBoundingBox2D FaceBoundingBox2D;
 	bool RightEyeBoundingBox2DVisible;
 	FDMSBoundingBox2D RightEyeBoundingBox2D;
 	bool LeftEyeBoundingBox2DVisible;
 	FDMSBoundingBox2D LeftEyeBoundingBox2D;
-	TArray<FVector2D> RightEyePupilLandmarks2D;
-	TArray<FVector2D> RightEyeIrisLandmarks2D;
-	TArray<FVector2D> LeftEyePupilLandmarks2D;
-	TArray<FVector2D> LeftEyeIrisLandmarks2D;
-	TArray<bool> PupilIrisLandmarksVisible;
+	DMSSimFixedArray<FVector2D, MAX_PUPIL_IRIS_LANDMARKS> RightEyePupilLandmarks2D;
+	DMSSimFixedArray<FVector2D, MAX_PUPIL_IRIS_LANDMARKS> RightEyeIrisLandmarks2D;
+	DMSSimFixedArray<FVector2D, MAX_PUPIL_IRIS_LANDMARKS> LeftEyePupilLandmarks2D;
+	DMSSimFixedArray<FVector2D, MAX_PUPIL_IRIS_LANDMARKS> LeftEyeIrisLandmarks2D;
+	DMSSimFixedArray<bool, 4 * MAX_PUPIL_IRIS_LANDMARKS> PupilIrisLandmarksVisible; // right pupil, right iris, left iris, left pupil
 
 	float LeftEyeOpening;
 	float RightEyeOpening;
@@ -172,10 +220,35 @@ struct DMSSimGroundTruthOccupant
 	float RightEyePupilVisibilityPerc;
 };
 
+/**
+ * @struct DMSSimGroundTruthFrameData
+ * @brief The part of the ground truth that changes from frame to frame.
+ */
+struct DMSSimGroundTruthFrameData
+{
+	FVector  CarPosition_inWorld;
+	FRotator CarRotation_inWorld;
+	DMSSimGroundTruthOccupant Occupants[static_cast<size_t>(FDMSSimOccupantType::PassengerCount)];
+};
+static_assert(std::is_trivially_copyable<DMSSimGroundTruthFrameData>::value, "the frame data is copied once per rendered frame");
+
+using DMSSimGroundTruthScenarioConstantsPtr = TSharedPtr<const DMSSimGroundTruthScenarioConstants, ESPMode::ThreadSafe>;
+
+/**
+ * @struct DMSSimGroundTruthFrame
+ * @brief Ground truth of a frame: the constants of its scenario, shared with the other frames, and the data of the frame.
+ * Copying a frame copies the frame data and a reference to the scenario constants.
+ */
 struct DMSSimGroundTruthFrame
 {
-	DMSSimGroundTruthCommon Common;
-	DMSSimGroundTruthOccupant Occupants[FDMSSimOccupantType::PassengerCount];
+	DMSSimGroundTruthScenarioConstantsPtr Scenario;
+	DMSSimGroundTruthFrameData            Data;
+
+	/** The scenario constants, empty ones if the frame doesn't have a scenario yet. */
+	const DMSSimGroundTruthScenarioConstants& GetScenario() const {
+		static const DMSSimGroundTruthScenarioConstants EmptyScenario = {};
+		return Scenario ? *Scenario : EmptyScenario;
+	}
 };
 
 class DMSSimScenarioParser;
@@ -210,6 +283,8 @@ bool IsRecording();
 void SetNumRemainingFrames(int NumFrames);
 int GetNumRemainingFrames();
 
+size_t GetFrameQueueCapacity();
+
 void SetCameraCallback(const CameraSetCallback& Callback);
 void SetCameraComponent(UCameraComponent* Camera);
 
@@ -219,7 +294,10 @@ float GetCurrentTime();
 
 void ResetGroundTruthData();
 const DMSSimGroundTruthFrame& GetGroundTruthFrame();
-void SetGroundTruthCommonData(const DMSSimGroundTruthCommon& CommonData);
+/** Drops the scenario constants, so they are created anew by the next UDMSSimGroundTruthBlueprint::StoreDmsGroundTruthCommonData. */
+void ResetGroundTruthScenario();
+void SetGroundTruthScenario(const DMSSimGroundTruthScenarioConstantsPtr& Scenario);
+void SetGroundTruthCarPose(const FVector& CarPosition_inWorld, const FRotator& CarRotation_inWorld);
 void SetGroundTruthOccupantData(FDMSSimOccupantType OccupantType, const DMSSimGroundTruthOccupant& OccupantData);
 
 } // namespace DMSSimConfig
@@ -2,6 +2,7 @@
 #include "DMSSimParserBase.h"
 #include "DMSSimYamlObj.h"
 #include <cassert>
+#include <iterator>
 #include <memory>
 #include <stack>
 #include <string>
@@ -95,7 +96,7 @@ namespace {
 			const char* const          Name;
 			ProcessConfigYamlEventFunc Func;
 		}
-		const ConfigEventHandlers[] = {
+		constexpr ConfigEventHandlers[] = {
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(version)
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(project)
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(transform_base_to_project)
@@ -105,6 +106,8 @@ namespace {
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(scale)
 		};
 #undef DMSSIM_DEFINE_YAML_EVENT_HANDLER
+
+		constexpr DMSSimEventHandlerIndex<int(std::size(ConfigEventHandlers))> ConfigEventHandlerIndex(ConfigEventHandlers);
 	} // anonymous namespace
 
 	bool DMSSimConfigParserImpl::Initialize(const wchar_t* const FilePath) {
@@ -118,7 +121,7 @@ namespace {
 			const auto Name = reinterpret_cast<const char*>(Event.data.scalar.value);
 			if (IsCarName(Name)) { return Name; } 
 		}
-		const auto* const Info = FindEventHandlerEx(Event, ConfigEventHandlers);
+		const auto* const Info = FindEventHandlerEx(Event, ConfigEventHandlers, ConfigEventHandlerIndex);
 		if (Info) { return Info->Name; }
 		return nullptr;
 	}
@@ -127,7 +130,7 @@ namespace {
 		if (!YamlObjStack_.empty() && YamlObjStack_.top() && YamlObjStack_.top()->GetYamlType() == YamlObjTypeTransformList) {
 			if (IsCarName(FuncName)) { return EventHandler_car_coordinate_space(&Event, Obj, Enter); }
 		}
-		const auto* const Info = FindEventHandler(FuncName, ConfigEventHandlers);
+		const auto* const Info = FindEventHandler(FuncName, ConfigEventHandlers, ConfigEventHandlerIndex);
 		if (Info) { return (this->*Info->Func)(&Event, Obj, Enter); }
 		return nullptr;
 	}
@@ -1,6 +1,8 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "DMSSimCore.h"
+#include "DMSSimRecordingSink.h"
+#include "DMSSimVideoEncoder.h"
 #include "Modules/ModuleManager.h"
 #include "Interfaces/IPluginManager.h"
 
@@ -36,6 +38,7 @@ void FDMSSimCoreModule::StartupModule()
 			}
 		}
 	}
+	DMSSimVideoEncoder::RegisterSinks(DMSSimRecordingSinkRegistry::Get());
 }
 
 void FDMSSimCoreModule::ShutdownModule()
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+
+/**
+ * @class DMSSimFixedArray
+ * @brief Array with a fixed capacity and a variable number of elements, stored inline.
+ * It has the part of the TArray interface the ground truth uses, but no heap allocation,
+ * so a struct of fixed arrays of trivially copyable elements is trivially copyable itself.
+ * The elements beyond Num() are undefined.
+ */
+template <typename T, int32 Capacity>
+class DMSSimFixedArray
+{
+public:
+	static constexpr int32 GetCapacity() { return Capacity; }
+
+	int32 Num() const { return Num_; }
+	bool IsValidIndex(const int32 Index) const { return Index >= 0 && Index < Num_; }
+
+	T& operator[](const int32 Index) {
+		assert(IsValidIndex(Index));
+		return Data_[Index];
+	}
+	const T& operator[](const int32 Index) const {
+		assert(IsValidIndex(Index));
+		return Data_[Index];
+	}
+
+	T* begin() { return Data_; }
+	T* end() { return Data_ + Num_; }
+	const T* begin() const { return Data_; }
+	const T* end() const { return Data_ + Num_; }
+
+	void Empty() { Num_ = 0; }
+
+	/** Sets the number of elements, new elements are value initialized. Clamped to the capacity. */
+	void SetNum(const int32 NewNum) {
+		const int32 ClampedNum = std::min(std::max(NewNum, 0), Capacity);
+		std::fill(Data_ + std::min(Num_, ClampedNum), Data_ + ClampedNum, T());
+		Num_ = ClampedNum;
+	}
+
+	/** Appends an element, returns false if the array is full. */
+	bool Add(const T& Value) {
+		if (Num_ == Capacity) { return false; }
+		Data_[Num_++] = Value;
+		return true;
+	}
+
+	/** Replaces the elements with those of Source, returns false if they didn't all fit. */
+	bool Assign(const TArray<T>& Source) {
+		Num_ = std::min(static_cast<int32>(Source.Num()), Capacity);
+		std::copy(Source.GetData(), Source.GetData() + Num_, Data_);
+		return Source.Num() <= Capacity;
+	}
+
+private:
+	int32 Num_ = 0;
+	T     Data_[Capacity];
+};
@@ -0,0 +1,102 @@
+#include "DMSSimFrameBufferPool.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <vector>
+#include "DMSSimLog.h"
+
+namespace {
+size_t GetSizeClass(size_t NumPixels) {
+	const size_t Granularity = DMSSimFrameBufferPool::SizeClassGranularity;
+	return ((std::max<size_t>(NumPixels, 1) + Granularity - 1) / Granularity) * Granularity;
+}
+} // anonymous namespace
+
+struct DMSSimFrameBufferPool::PoolState
+{
+	using Buffer = TArray<FColor>;
+
+	explicit PoolState(size_t MaxBuffersPerSize) : MaxBuffersPerSize_(MaxBuffersPerSize) {}
+
+	~PoolState() {
+		for (auto& FreeList : FreeLists_) {
+			for (const auto FreeBuffer : FreeList.second) { delete FreeBuffer; }
+		}
+	}
+
+	void Release(Buffer* const ReleasedBuffer, size_t SizeClass) {
+		{
+			std::lock_guard<std::mutex> Lock(Mutex_);
+			--Outstanding_;
+			auto& FreeList = FreeLists_[SizeClass];
+			if (FreeList.size() < MaxBuffersPerSize_) {
+				FreeList.push_back(ReleasedBuffer);
+				return;
+			}
+		}
+		delete ReleasedBuffer;
+	}
+
+	mutable std::mutex                     Mutex_;
+	std::map<size_t, std::vector<Buffer*>> FreeLists_;
+	const size_t                           MaxBuffersPerSize_;
+	uint64                                 Hits_ = 0;
+	uint64                                 Misses_ = 0;
+	int32                                  Outstanding_ = 0;
+	int32                                  PeakOutstanding_ = 0;
+};
+
+DMSSimFrameBufferPool::DMSSimFrameBufferPool(size_t MaxBuffersPerSize) :
+	State_(MakeShared<PoolState, ESPMode::ThreadSafe>(MaxBuffersPerSize))
+{
+}
+
+void DMSSimFrameBufferPool::Preallocate(size_t NumPixels, size_t Count) {
+	const size_t SizeClass = GetSizeClass(NumPixels);
+	std::lock_guard<std::mutex> Lock(State_->Mutex_);
+	auto& FreeList = State_->FreeLists_[SizeClass];
+	while (FreeList.size() < std::min(Count, State_->MaxBuffersPerSize_)) {
+		auto NewBuffer = new PoolState::Buffer;
+		NewBuffer->Reserve(SizeClass);
+		FreeList.push_back(NewBuffer);
+	}
+}
+
+DMSSimFrameBufferPool::ImagePtr DMSSimFrameBufferPool::Acquire(size_t NumPixels) {
+	const size_t SizeClass = GetSizeClass(NumPixels);
+	PoolState::Buffer* Buffer = nullptr;
+	{
+		std::lock_guard<std::mutex> Lock(State_->Mutex_);
+		auto& FreeList = State_->FreeLists_[SizeClass];
+		if (!FreeList.empty()) {
+			Buffer = FreeList.back();
+			FreeList.pop_back();
+			++State_->Hits_;
+		}
+		else { ++State_->Misses_; }
+		State_->PeakOutstanding_ = std::max(State_->PeakOutstanding_, ++State_->Outstanding_);
+	}
+
+	if (!Buffer) {
+		Buffer = new PoolState::Buffer;
+		Buffer->Reserve(SizeClass);
+	}
+	Buffer->SetNumUninitialized(NumPixels, false);
+
+	const TWeakPtr<PoolState, ESPMode::ThreadSafe> WeakState = State_;
+	return MakeShareable(Buffer, [WeakState, SizeClass](PoolState::Buffer* const ReleasedBuffer) {
+		if (const auto State = WeakState.Pin()) { State->Release(ReleasedBuffer, SizeClass); }
+		else { delete ReleasedBuffer; }
+	});
+}
+
+DMSSimFrameBufferPool::Stats DMSSimFrameBufferPool::GetStats() const {
+	std::lock_guard<std::mutex> Lock(State_->Mutex_);
+	return Stats{ State_->Hits_, State_->Misses_, State_->Outstanding_, State_->PeakOutstanding_ };
+}
+
+void DMSSimFrameBufferPool::LogStats() const {
+	const auto PoolStats = GetStats();
+	DMSSimLog::Info() << "Frame buffer pool -- hits: " << PoolStats.Hits << ", misses: " << PoolStats.Misses
+		<< ", outstanding: " << PoolStats.Outstanding << ", peak outstanding: " << PoolStats.PeakOutstanding << FL;
+}
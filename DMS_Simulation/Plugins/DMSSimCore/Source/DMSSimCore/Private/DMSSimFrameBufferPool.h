@@ -0,0 +1,52 @@
+#pragma once
+
+#include "DMSSimRenderRequest.h"
+
+/**
+ * @class DMSSimFrameBufferPool
+ * @brief Pool of preallocated pixel buffers for the rendered frames.
+ * Buffers are grouped by size class, the size class is the number of pixels rounded up to DMSSimFrameBufferPool::SizeClassGranularity.
+ * A buffer handed out by Acquire returns to the pool automatically, once the last reference to it is released,
+ * i.e. after the recording thread has passed it to the encoder and the labelers.
+ * The pool keeps at most MaxBuffersPerSize free buffers per size class, extra buffers are freed.
+ * Buffers that are still in use when the pool is destroyed are freed by their last owner.
+ */
+class DMSSimFrameBufferPool
+{
+public:
+	using ImagePtr = FDMSSimRenderRequest::ImagePtr;
+
+	static constexpr size_t SizeClassGranularity = 4096;
+
+	struct Stats {
+		uint64 Hits;
+		uint64 Misses;
+		int32  Outstanding;
+		int32  PeakOutstanding;
+	};
+
+	explicit DMSSimFrameBufferPool(size_t MaxBuffersPerSize);
+	DMSSimFrameBufferPool(const DMSSimFrameBufferPool&) = delete;
+	DMSSimFrameBufferPool& operator=(const DMSSimFrameBufferPool&) = delete;
+
+	/**
+	 * Allocates Count free buffers of the size class that fits NumPixels pixels.
+	 * Does not go beyond MaxBuffersPerSize.
+	 */
+	void Preallocate(size_t NumPixels, size_t Count);
+
+	/**
+	 * Returns a buffer with NumPixels uninitialized pixels.
+	 * Takes a free buffer of the matching size class (a hit) or allocates a new one (a miss).
+	 */
+	ImagePtr Acquire(size_t NumPixels);
+
+	Stats GetStats() const;
+
+	/** Writes the pool statistics to the log. */
+	void LogStats() const;
+
+private:
+	struct PoolState;
+	TSharedRef<PoolState, ESPMode::ThreadSafe> State_;
+};
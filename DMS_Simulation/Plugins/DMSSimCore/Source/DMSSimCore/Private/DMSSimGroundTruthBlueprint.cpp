@@ -1,9 +1,11 @@
 #include "DMSSimGroundTruthBlueprint.h"
 #include "DMSSimConfig.h"
+#include "DMSSimLandmarkProjection.h"
 #include "DMSSimLog.h"
 #include "DMSSimConstants.h"
 
 #define DMS_GT_COPY_VALUE(NAME) Frame.##NAME = NAME;
+#define DMS_GT_COPY_ARRAY(NAME) if (!Frame.##NAME.Assign(NAME)) { DMSSimLog::Warn() << #NAME << ": " << NAME.Num() << " values, only " << Frame.##NAME.GetCapacity() << " are stored" << FL; }
 
 static constexpr size_t R_EYELID_UPPER_MID = 68;
 static constexpr size_t R_EYELID_LOWER_MID = 69;
@@ -41,9 +43,22 @@ void UDMSSimGroundTruthBlueprint::StoreDmsGroundTruthCommonData(
 	const int& OccupantCount,
 	const TArray<FDMSSimOccupant>& Occupants)
 {
-	DMSSimGroundTruthCommon GroundTruth;
+	DMSSimConfig::SetGroundTruthCarPose(ToOutputFormat(CarPosition_inWorld), ToOutputFormat(CarRotation_inWorld));
 
-	// Directly map the properties from FDMSScenario to DMSSimGroundTruthCommon
+	// the rest doesn't change during a scenario, it is shared by all frames until the next scenario is loaded
+	const FVector CameraPosition_inCar = ToOutputFormat(CameraLocation_inCar);
+	const FVector CameraLightPosition_inCar = ToOutputFormat(IlluminationLocation_inCar);
+	const auto& Current = DMSSimConfig::GetGroundTruthFrame().Scenario;
+	if (Current && Current->ScenarioIdx == Scenario.ScenarioIdx && Current->OccupantCount == OccupantCount &&
+		Current->Camera.Position_inCar == CameraPosition_inCar && Current->Camera.Rotation_inCar == CameraRotation_inCar &&
+		Current->CameraLight.Position == CameraLightPosition_inCar && Current->CameraLight.Rotation == IlluminationRotation_inCar) {
+		return;
+	}
+
+	const auto GroundTruthPtr = MakeShared<DMSSimGroundTruthScenarioConstants, ESPMode::ThreadSafe>();
+	auto& GroundTruth = *GroundTruthPtr;
+
+	// Directly map the properties from FDMSScenario to DMSSimGroundTruthScenarioConstants
 	GroundTruth.ScenarioIdx = Scenario.ScenarioIdx;
 	GroundTruth.ScenariosCount = Scenario.ScenariosCount;
 	GroundTruth.VersionMajor = Scenario.VersionMajor;
@@ -55,8 +70,6 @@ void UDMSSimGroundTruthBlueprint::StoreDmsGroundTruthCommonData(
 	GroundTruth.RandomMovements = RM.Blinking || RM.Smiling || RM.Head || RM.Body || RM.Gaze;
 	GroundTruth.CarModel = std::string(TCHAR_TO_UTF8(*Scenario.CarModel));
 	GroundTruth.CarSpeed = Scenario.CarSpeed;
-	GroundTruth.CarPosition_inWorld = ToOutputFormat(CarPosition_inWorld);
-	GroundTruth.CarRotation_inWorld = ToOutputFormat(CarRotation_inWorld);
 
 	// Convert FDMSSimSunLight to DMSSimSunLight
 	GroundTruth.SunLight.Intensity = Scenario.SunLight.Intensity;
@@ -64,7 +77,7 @@ void UDMSSimGroundTruthBlueprint::StoreDmsGroundTruthCommonData(
 	GroundTruth.SunLight.Rotation = ToOutputFormat(Scenario.SunLight.Rotation);
 
 	// Convert FDMSCamera to DMSCamera
-	GroundTruth.Camera.Position_inCar = ToOutputFormat(CameraLocation_inCar);
+	GroundTruth.Camera.Position_inCar = CameraPosition_inCar;
 	GroundTruth.Camera.Rotation_inCar = CameraRotation_inCar;
 	GroundTruth.Camera.FOV = Scenario.Camera.MinimalViewInfo.FOV;
 	GroundTruth.Camera.AspectRatio = Scenario.Camera.MinimalViewInfo.AspectRatio;
@@ -79,6 +92,10 @@ void UDMSSimGroundTruthBlueprint::StoreDmsGroundTruthCommonData(
 	GroundTruth.Camera.Contrast = Scenario.Camera.Contrast;
 	GroundTruth.Camera.BloomIntensity = Scenario.Camera.BloomIntensity;
 	GroundTruth.Camera.FocusOffset = Scenario.Camera.FocusOffset;
+	const auto& ScenarioCamera = DMSSimConfig::GetCamera();
+	for (size_t i = 0; i < DMSSIM_DISTORTION_COEFFICIENT_COUNT; ++i) {
+		GroundTruth.Camera.Distortion[i] = i < ScenarioCamera.GetDistortionCount() ? ScenarioCamera.GetDistortion(i) : 0.0f;
+	}
 
 	// Convert FDMSSimCustomLight to DMSSimCustomLight
 	GroundTruth.CameraLight.Intensity = Scenario.CameraLight.Intensity;
@@ -86,7 +103,7 @@ void UDMSSimGroundTruthBlueprint::StoreDmsGroundTruthCommonData(
 	GroundTruth.CameraLight.SourceRadius = Scenario.CameraLight.SourceRadius;
 	GroundTruth.CameraLight.InnerConeAngle = Scenario.CameraLight.InnerConeAngle;
 	GroundTruth.CameraLight.OuterConeAngle = Scenario.CameraLight.OuterConeAngle;
-	GroundTruth.CameraLight.Position = ToOutputFormat(IlluminationLocation_inCar);
+	GroundTruth.CameraLight.Position = CameraLightPosition_inCar;
 	GroundTruth.CameraLight.Rotation = IlluminationRotation_inCar;
 
 	// Convert FDMSBlendoutDefaults to DMSBlendoutDefaults
@@ -105,11 +122,12 @@ void UDMSSimGroundTruthBlueprint::StoreDmsGroundTruthCommonData(
 	GroundTruth.GroundTruthSettings.EyeBoundingBoxHeightFactor = Scenario.GroundTruthSettings.EyeBoundingBoxHeightFactor;
 	GroundTruth.GroundTruthSettings.EyeBoundingBoxDepth = Scenario.GroundTruthSettings.EyeBoundingBoxDepth;
 
-	// Directly map remaining properties to DMSSimGroundTruthCommon
+	// Directly map remaining properties to DMSSimGroundTruthScenarioConstants
 	GroundTruth.Occupants = Occupants;
 	GroundTruth.OccupantCount = OccupantCount;
+	GroundTruth.CoordinateSpace = DMSSimGroundTruthCoordinateSpace(DMSSimConfig::GetCoordinateSpace());
 
-	DMSSimConfig::SetGroundTruthCommonData(GroundTruth);
+	DMSSimConfig::SetGroundTruthScenario(GroundTruthPtr);
 }
 
 void UDMSSimGroundTruthBlueprint::StoreDmsGroundTruthFrame(
@@ -239,10 +257,10 @@ void UDMSSimGroundTruthBlueprint::StoreDmsGroundTruthFrame(
 	DMS_GT_COPY_VALUE(RightFootIndexPoint)
 	DMS_GT_COPY_VALUE(HorizontalMouthOpening);
 	DMS_GT_COPY_VALUE(VerticalMouthOpening);
-	DMS_GT_COPY_VALUE(FacialLandmarksVisible);
-	DMS_GT_COPY_VALUE(FacialLandmarks3D_inCam);
-	DMS_GT_COPY_VALUE(FacialLandmarks2D);
-	DMS_GT_COPY_VALUE(FaceBoundingBox3D_inCam);
+	DMS_GT_COPY_ARRAY(FacialLandmarksVisible);
+	DMS_GT_COPY_ARRAY(FacialLandmarks3D_inCam);
+	DMS_GT_COPY_ARRAY(FacialLandmarks2D);
+	DMS_GT_COPY_ARRAY(FaceBoundingBox3D_inCam);
 	DMS_GT_COPY_VALUE(FaceBoundingBox3DVisible);
 	DMS_GT_COPY_VALUE(FaceBoundingBox2D);
 	DMS_GT_COPY_VALUE(FaceBoundingBox2DVisible);
@@ -250,11 +268,11 @@ void UDMSSimGroundTruthBlueprint::StoreDmsGroundTruthFrame(
 	DMS_GT_COPY_VALUE(RightEyeBoundingBox2DVisible);
 	DMS_GT_COPY_VALUE(LeftEyeBoundingBox2D);
 	DMS_GT_COPY_VALUE(LeftEyeBoundingBox2DVisible);
-	DMS_GT_COPY_VALUE(RightEyePupilLandmarks2D);
-	DMS_GT_COPY_VALUE(RightEyeIrisLandmarks2D);
-	DMS_GT_COPY_VALUE(LeftEyePupilLandmarks2D);
-	DMS_GT_COPY_VALUE(LeftEyeIrisLandmarks2D);
-	DMS_GT_COPY_VALUE(PupilIrisLandmarksVisible);
+	DMS_GT_COPY_ARRAY(RightEyePupilLandmarks2D);
+	DMS_GT_COPY_ARRAY(RightEyeIrisLandmarks2D);
+	DMS_GT_COPY_ARRAY(LeftEyePupilLandmarks2D);
+	DMS_GT_COPY_ARRAY(LeftEyeIrisLandmarks2D);
+	DMS_GT_COPY_ARRAY(PupilIrisLandmarksVisible);
 	DMS_GT_COPY_VALUE(LeftEyeLidVisibilityPerc);
 	DMS_GT_COPY_VALUE(RightEyeLidVisibilityPerc);
 	DMS_GT_COPY_VALUE(LeftEyePupilVisibilityPerc);
@@ -262,9 +280,14 @@ void UDMSSimGroundTruthBlueprint::StoreDmsGroundTruthFrame(
 
 	Frame.LeftEyeOpening = ComputeEyeOpening(FacialLandmarks3D_inCam[L_EYELID_UPPER_MID], FacialLandmarks3D_inCam[L_EYELID_LOWER_MID]);
 	Frame.RightEyeOpening = ComputeEyeOpening(FacialLandmarks3D_inCam[R_EYELID_UPPER_MID], FacialLandmarks3D_inCam[R_EYELID_LOWER_MID]);
+
+	// the 2D labels of the Blueprint are pinhole projections, with a lens distortion they are all projected again in one batch
+	const auto Intrinsics = DMSSimCameraIntrinsics::FromCamera(DMSSimConfig::GetCamera());
+	if (Intrinsics.Distorted) { DMSSimLandmarkProjection::ProjectOccupant(Intrinsics, Frame); }
 	DMSSimConfig::SetGroundTruthOccupantData(OccupantType, Frame);
 }
 #undef DMS_GT_COPY_VALUE
+#undef DMS_GT_COPY_ARRAY
 
 void UDMSSimGroundTruthBlueprint::ResetGroundTruthData() { DMSSimConfig::ResetGroundTruthData(); }
 
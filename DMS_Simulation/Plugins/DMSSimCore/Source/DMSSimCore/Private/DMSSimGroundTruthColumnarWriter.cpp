@@ -0,0 +1,70 @@
+#include "DMSSimGroundTruthColumnarWriter.h"
+#include <algorithm>
+
+using namespace DMSSimGroundTruthFormat;
+
+DMSSimGroundTruthColumnarWriter::DMSSimGroundTruthColumnarWriter(std::ostream& Stream, const uint32_t RowGroupSize) :
+	Stream_(Stream),
+	RowGroupSize_(std::max<uint32_t>(RowGroupSize, 1))
+{
+}
+
+DMSSimGroundTruthColumnarWriter::~DMSSimGroundTruthColumnarWriter() { Flush(); }
+
+void DMSSimGroundTruthColumnarWriter::WriteHeader(const std::vector<ColumnInfo>& Columns) {
+	Columns_ = Columns;
+
+	FileHeader Header = {};
+	std::memcpy(Header.Magic, COLUMNAR_MAGIC, sizeof(Header.Magic));
+	Header.Version = COLUMNAR_VERSION;
+	Header.ColumnCount = static_cast<uint32_t>(Columns_.size());
+	Header.RowGroupSize = RowGroupSize_;
+	Stream_.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+
+	size_t SchemaSize = 0;
+	for (const ColumnInfo& Column : Columns_) {
+		ColumnHeader Info = {};
+		Info.Type = static_cast<uint8_t>(Column.Type);
+		Info.NameLength = static_cast<uint16_t>(Column.Name.size());
+		Info.Group = Column.Group;
+		Stream_.write(reinterpret_cast<const char*>(&Info), sizeof(Info));
+		Stream_.write(Column.Name.data(), Info.NameLength);
+		SchemaSize += sizeof(Info) + Info.NameLength;
+	}
+	const char Padding[8] = {};
+	Stream_.write(Padding, static_cast<std::streamsize>(AlignTo8(SchemaSize) - SchemaSize));
+
+	MissingRow_.resize(Columns_.size());
+	for (size_t i = 0; i < Columns_.size(); ++i) {
+		MissingRow_[i] = Columns_[i].Type == ColumnType::Float32 ? MISSING_FLOAT32_BITS : static_cast<uint32_t>(MISSING_INT32);
+	}
+	Row_.resize(Columns_.size());
+	RowGroup_.resize(Columns_.size() * size_t(RowGroupSize_));
+}
+
+uint32_t* DMSSimGroundTruthColumnarWriter::BeginRow() {
+	std::copy(MissingRow_.begin(), MissingRow_.end(), Row_.begin());
+	return Row_.data();
+}
+
+void DMSSimGroundTruthColumnarWriter::EndRow() {
+	for (size_t Column = 0; Column < Row_.size(); ++Column) { RowGroup_[Column * RowGroupSize_ + RowGroupRowCount_] = Row_[Column]; }
+	++RowCount_;
+	if (++RowGroupRowCount_ == RowGroupSize_) { WriteRowGroup(); }
+}
+
+void DMSSimGroundTruthColumnarWriter::Flush() {
+	if (RowGroupRowCount_ > 0) { WriteRowGroup(); }
+	Stream_.flush();
+}
+
+void DMSSimGroundTruthColumnarWriter::WriteRowGroup() {
+	RowGroupHeader Header = {};
+	std::memcpy(Header.Magic, ROW_GROUP_MAGIC, sizeof(Header.Magic));
+	Header.RowCount = RowGroupRowCount_;
+	Stream_.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+	for (size_t Column = 0; Column < Columns_.size(); ++Column) {
+		Stream_.write(reinterpret_cast<const char*>(&RowGroup_[Column * RowGroupSize_]), static_cast<std::streamsize>(RowGroupRowCount_ * sizeof(uint32_t)));
+	}
+	RowGroupRowCount_ = 0;
+}
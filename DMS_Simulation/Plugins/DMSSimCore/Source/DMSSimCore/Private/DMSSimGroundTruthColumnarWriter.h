@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "DMSSimGroundTruthFormat.h"
+
+/**
+ * @class DMSSimGroundTruthColumnarWriter
+ * @brief Writes a binary columnar ground truth file (see DMSSimGroundTruthFormat.h) to a stream.
+ * The rows are collected column by column and written as a row group, once RowGroupSize rows are complete.
+ * The values of a row are set as raw 32 bit cells, which start as missing values.
+ */
+class DMSSimGroundTruthColumnarWriter
+{
+public:
+	explicit DMSSimGroundTruthColumnarWriter(std::ostream& Stream, uint32_t RowGroupSize = DMSSimGroundTruthFormat::DEFAULT_ROW_GROUP_SIZE);
+	DMSSimGroundTruthColumnarWriter(const DMSSimGroundTruthColumnarWriter&) = delete;
+	DMSSimGroundTruthColumnarWriter& operator=(const DMSSimGroundTruthColumnarWriter&) = delete;
+	/** Writes the incomplete row group. */
+	~DMSSimGroundTruthColumnarWriter();
+
+	/** Writes the file header and the schema, must be called once, before the first row. */
+	void WriteHeader(const std::vector<DMSSimGroundTruthFormat::ColumnInfo>& Columns);
+
+	const std::vector<DMSSimGroundTruthFormat::ColumnInfo>& GetColumns() const { return Columns_; }
+
+	/** Returns the cells of a new row, one per column, all set to the missing value of the column type. */
+	uint32_t* BeginRow();
+
+	/** Adds the row started with BeginRow to the row group, writes the row group if it is complete. */
+	void EndRow();
+
+	/** Writes the rows of the incomplete row group as a shorter row group and flushes the stream. */
+	void Flush();
+
+	uint64_t GetRowCount() const { return RowCount_; }
+
+private:
+	void WriteRowGroup();
+
+	std::ostream&                                    Stream_;
+	const uint32_t                                   RowGroupSize_;
+	std::vector<DMSSimGroundTruthFormat::ColumnInfo> Columns_;
+	std::vector<uint32_t>                            MissingRow_;
+	std::vector<uint32_t>                            Row_;
+	std::vector<uint32_t>                            RowGroup_;     // column after column, RowGroupSize_ cells each
+	uint32_t                                         RowGroupRowCount_ = 0;
+	uint64_t                                         RowCount_ = 0;
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+// Only the C++ standard library is used here, the header is shared with the ground truth reader of Tools/GroundTruthColumnar.
+
+#include <charconv>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/**
+ * @brief File formats of the ground truth: the text of the CSV values and the layout of the binary columnar file.
+ *
+ * The binary columnar file (*.dmsgt) has the same columns as the CSV, stored as fixed width little endian 32 bit values
+ * in row groups, so a reader can map the file and use the column data in place:
+ *
+ *   FileHeader
+ *   FileHeader::ColumnCount x { ColumnHeader, ColumnHeader::NameLength bytes of the name }, zero padded to a multiple of 8 bytes
+ *   row groups, each a RowGroupHeader followed by RowGroupHeader::RowCount values of every column, column after column
+ *
+ * A row group holds at most FileHeader::RowGroupSize rows. Values a frame doesn't have, e.g. the landmarks of an empty seat,
+ * are MISSING_INT32 or MISSING_FLOAT32_BITS. The CSV has a single empty field for a group of columns without values.
+ */
+namespace DMSSimGroundTruthFormat {
+
+constexpr int      FLOAT_PRECISION = 8; // significant digits of the CSV floats, the same as std::setprecision(8)
+constexpr size_t   MAX_VALUE_LENGTH = 32;
+
+constexpr char     CSV_EXTENSION[] = ".csv";
+constexpr char     COLUMNAR_EXTENSION[] = ".dmsgt";
+constexpr char     COLUMNAR_MAGIC[8] = { 'D', 'M', 'S', 'G', 'T', 'C', 'O', 'L' };
+constexpr char     ROW_GROUP_MAGIC[4] = { 'R', 'G', 'R', 'P' };
+constexpr uint32_t COLUMNAR_VERSION = 1;
+constexpr uint32_t DEFAULT_ROW_GROUP_SIZE = 1024;
+constexpr int32_t  MISSING_INT32 = INT32_MIN;
+constexpr uint32_t MISSING_FLOAT32_BITS = 0x7FC00001u; // a quiet NaN, different from the NaN the arithmetic produces
+
+enum class FileFormat : uint8_t {
+	Csv,
+	Columnar,
+};
+
+enum class ColumnType : uint8_t {
+	Int32 = 0,
+	Float32 = 1,
+	TimeMs = 2,  // int32 milliseconds, hh:mm:ss.fff in the CSV
+};
+
+struct FileHeader {
+	char     Magic[8];
+	uint32_t Version;
+	uint32_t ColumnCount;
+	uint32_t RowGroupSize;
+	uint32_t Reserved;
+};
+static_assert(sizeof(FileHeader) == 24, "FileHeader is part of the file format");
+
+struct ColumnHeader {
+	uint8_t  Type;       // ColumnType
+	uint8_t  Reserved;
+	uint16_t NameLength;
+	uint32_t Group;      // columns written by the same CSV field group share the group, e.g. all values of FacialLandmarks
+};
+static_assert(sizeof(ColumnHeader) == 8, "ColumnHeader is part of the file format");
+
+struct RowGroupHeader {
+	char     Magic[4];
+	uint32_t RowCount;
+	uint64_t Reserved;
+};
+static_assert(sizeof(RowGroupHeader) == 16, "RowGroupHeader is part of the file format");
+
+/** A column of the ground truth, in the order of the CSV header. */
+struct ColumnInfo {
+	std::string Name;
+	ColumnType  Type;
+	uint32_t    Group;
+};
+
+inline size_t AlignTo8(const size_t Size) { return (Size + 7) & ~size_t(7); }
+
+inline uint32_t FloatToBits(const float Value) {
+	uint32_t Bits;
+	std::memcpy(&Bits, &Value, sizeof(Bits));
+	return Bits;
+}
+
+inline float BitsToFloat(const uint32_t Bits) {
+	float Value;
+	std::memcpy(&Value, &Bits, sizeof(Value));
+	return Value;
+}
+
+/** Time in seconds as the whole milliseconds of the CSV time column, the fraction is truncated. */
+inline int32_t TimeToMilliseconds(const double Time) {
+	const int64_t Seconds = static_cast<int64_t>(Time);
+	return static_cast<int32_t>(Seconds * 1000 + static_cast<int>((Time - static_cast<double>(Seconds)) * 1000));
+}
+
+/** Writes the value right-aligned in Width characters, filled with '0' on the left, like std::setw with std::setfill('0'). */
+inline char* FormatPadded(char* const Dst, const int Value, const int Width) {
+	char Digits[16];
+	const auto Result = std::to_chars(Digits, Digits + sizeof(Digits), Value);
+	const int Length = static_cast<int>(Result.ptr - Digits);
+	char* End = Dst;
+	for (int i = Length; i < Width; ++i) { *End++ = '0'; }
+	std::memcpy(End, Digits, Length);
+	return End + Length;
+}
+
+/** Time as hh:mm:ss.fff. Dst must have room for MAX_VALUE_LENGTH characters, returns the end of the text. */
+inline char* FormatTime(char* const Dst, const int32_t Milliseconds) {
+	const int SecondsTotal = Milliseconds / 1000;
+	const int MinutesTotal = SecondsTotal / 60;
+	char* End = FormatPadded(Dst, MinutesTotal / 60, 2);
+	*End++ = ':';
+	End = FormatPadded(End, MinutesTotal % 60, 2);
+	*End++ = ':';
+	End = FormatPadded(End, SecondsTotal % 60, 2);
+	*End++ = '.';
+	return FormatPadded(End, Milliseconds % 1000, 3);
+}
+
+/** Float with FLOAT_PRECISION significant digits. Dst must have room for MAX_VALUE_LENGTH characters, returns the end of the text. */
+inline char* FormatFloat(char* const Dst, const float Value) {
+	return std::to_chars(Dst, Dst + MAX_VALUE_LENGTH, Value, std::chars_format::general, FLOAT_PRECISION).ptr;
+}
+
+inline char* FormatInt(char* const Dst, const int64_t Value) { return std::to_chars(Dst, Dst + MAX_VALUE_LENGTH, Value).ptr; }
+
+} // namespace DMSSimGroundTruthFormat
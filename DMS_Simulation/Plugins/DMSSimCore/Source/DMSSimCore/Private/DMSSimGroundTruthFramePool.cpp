@@ -0,0 +1,63 @@
+#include "DMSSimGroundTruthFramePool.h"
+#include <mutex>
+#include <vector>
+
+struct DMSSimGroundTruthFramePool::PoolState
+{
+	explicit PoolState(size_t MaxFrames) : MaxFrames_(MaxFrames) {}
+
+	~PoolState() {
+		for (const auto FreeFrame : FreeFrames_) { delete FreeFrame; }
+	}
+
+	void Release(DMSSimGroundTruthFrame* const ReleasedFrame) {
+		// the scenario constants must not outlive the frames that use them
+		ReleasedFrame->Scenario.Reset();
+		{
+			std::lock_guard<std::mutex> Lock(Mutex_);
+			if (FreeFrames_.size() < MaxFrames_) {
+				FreeFrames_.push_back(ReleasedFrame);
+				return;
+			}
+		}
+		delete ReleasedFrame;
+	}
+
+	mutable std::mutex                   Mutex_;
+	std::vector<DMSSimGroundTruthFrame*> FreeFrames_;
+	const size_t                         MaxFrames_;
+	uint64                               Hits_ = 0;
+	uint64                               Misses_ = 0;
+};
+
+DMSSimGroundTruthFramePool::DMSSimGroundTruthFramePool(size_t MaxFrames) :
+	State_(MakeShared<PoolState, ESPMode::ThreadSafe>(MaxFrames))
+{
+}
+
+DMSSimGroundTruthFramePool::FramePtr DMSSimGroundTruthFramePool::Acquire(const DMSSimGroundTruthFrame& Source) {
+	DMSSimGroundTruthFrame* Frame = nullptr;
+	{
+		std::lock_guard<std::mutex> Lock(State_->Mutex_);
+		if (!State_->FreeFrames_.empty()) {
+			Frame = State_->FreeFrames_.back();
+			State_->FreeFrames_.pop_back();
+			++State_->Hits_;
+		}
+		else { ++State_->Misses_; }
+	}
+
+	if (!Frame) { Frame = new DMSSimGroundTruthFrame; }
+	*Frame = Source;
+
+	const TWeakPtr<PoolState, ESPMode::ThreadSafe> WeakState = State_;
+	return MakeShareable(Frame, [WeakState](DMSSimGroundTruthFrame* const ReleasedFrame) {
+		if (const auto State = WeakState.Pin()) { State->Release(ReleasedFrame); }
+		else { delete ReleasedFrame; }
+	});
+}
+
+DMSSimGroundTruthFramePool::Stats DMSSimGroundTruthFramePool::GetStats() const {
+	std::lock_guard<std::mutex> Lock(State_->Mutex_);
+	return Stats{ State_->Hits_, State_->Misses_ };
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "DMSSimConfig.h"
+
+/**
+ * @class DMSSimGroundTruthFramePool
+ * @brief Pool of ground truth frames for the renderer, so a rendered frame costs a copy of the frame data rather than an allocation.
+ * A frame handed out by Acquire returns to the pool automatically, once the last reference to it is released,
+ * i.e. after the ground truth writer and the labelers are done with it. The pool keeps at most MaxFrames free frames,
+ * extra frames are freed. Frames that are still in use when the pool is destroyed are freed by their last owner.
+ */
+class DMSSimGroundTruthFramePool
+{
+public:
+	using FramePtr = TSharedPtr<DMSSimGroundTruthFrame, ESPMode::ThreadSafe>;
+
+	struct Stats {
+		uint64 Hits;
+		uint64 Misses;
+	};
+
+	explicit DMSSimGroundTruthFramePool(size_t MaxFrames);
+	DMSSimGroundTruthFramePool(const DMSSimGroundTruthFramePool&) = delete;
+	DMSSimGroundTruthFramePool& operator=(const DMSSimGroundTruthFramePool&) = delete;
+
+	/**
+	 * Returns a copy of Source in a free frame (a hit) or a new one (a miss).
+	 * The copy shares the scenario constants of Source.
+	 */
+	FramePtr Acquire(const DMSSimGroundTruthFrame& Source);
+
+	Stats GetStats() const;
+
+private:
+	struct PoolState;
+	TSharedRef<PoolState, ESPMode::ThreadSafe> State_;
+};
@@ -2,11 +2,16 @@
 #include "DMSSimGroundTruthBlueprint.h"
 #include "DMSSimConfig.h"
 #include "DMSSimConstants.h"
+#include "DMSSimGroundTruthColumnarWriter.h"
+#include "DMSSimGroundTruthFormat.h"
+#include "DMSSimGroundTruthTransform.h"
+#include <charconv>
 #include <cmath>
-#include <fstream>
-#include <iomanip>
+#include <cstring>
 #include <string>
-#include <regex>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
 namespace {
 
@@ -14,6 +19,10 @@ constexpr bool PRINT_ALL_COLUMNS = false;
 
 thread_local size_t FrameNumber_ = 0;
 
+/**
+ * The values of an occupant in a row. The landmarks are fixed arrays like those of the occupant,
+ * so the struct is trivially copyable and is cleared with memset.
+ */
 struct DMSSimFrameComputed {
 	double   Time;
 	FVector  HeadPosition;
@@ -54,10 +63,10 @@ struct DMSSimFrameComputed {
 
 	float    HorizontalMouthOpening;
 	float    VerticalMouthOpening;
-	TArray <bool> FacialLandmarksVisible;
-	TArray <FVector> FacialLandmarks3D;
-	TArray <FVector2D> FacialLandmarks2D;
-	TArray<FVector> FaceBoundingBox3D;
+	decltype(DMSSimGroundTruthOccupant::FacialLandmarksVisible) FacialLandmarksVisible;
+	decltype(DMSSimGroundTruthOccupant::FacialLandmarks3D_inCam) FacialLandmarks3D;
+	decltype(DMSSimGroundTruthOccupant::FacialLandmarks2D) FacialLandmarks2D;
+	decltype(DMSSimGroundTruthOccupant::FaceBoundingBox3D_inCam) FaceBoundingBox3D;
 	bool FaceBoundingBox3DVisible;
 	FDMSBoundingBox2D FaceBoundingBox2D;
 	bool FaceBoundingBox2DVisible;
@@ -65,10 +74,137 @@ struct DMSSimFrameComputed {
 	bool RightEyeBoundingBox2DVisible;
 	FDMSBoundingBox2D LeftEyeBoundingBox2D;
 	bool LeftEyeBoundingBox2DVisible;
+};
+static_assert(std::is_trivially_copyable<DMSSimFrameComputed>::value, "DMSSimFrameComputed is cleared with memset");
+
+/*
+ * The row writers receive the values of a ground truth row from the column handlers: BeginColumn, EndColumn, AddFloat, AddInt,
+ * AddBool and AddTime. A column of the column table can have several values, e.g. all the facial landmarks, their positions
+ * in the row are given by BeginColumn. The handlers are templates on the writer, so the calls per value are resolved at compile time.
+ */
+
+/**
+ * Formats a CSV row into a reusable buffer. Every value is a quoted field and the fields are separated by ';'.
+ * The values are formatted by DMSSimGroundTruthFormat, floats with std::to_chars, which gives the same text
+ * as the stream with std::setprecision(DMSSimGroundTruthFormat::FLOAT_PRECISION).
+ */
+class CsvRowWriter {
+public:
+	void BeginRow() {
+		Buffer_.clear();
+		FieldCount_ = 0;
+	}
+
+	void EndRow() { Buffer_ += '\n'; }
+
+	/** Every column of the column table writes at least one field, an empty one if the handler has no values. */
+	void BeginColumn(size_t, size_t) { ColumnFieldCount_ = FieldCount_; }
+	void EndColumn() { if (FieldCount_ == ColumnFieldCount_) { AddText("", 0); } }
+
+	void AddFloat(const float Value) {
+		char Text[DMSSimGroundTruthFormat::MAX_VALUE_LENGTH];
+		AddText(Text, DMSSimGroundTruthFormat::FormatFloat(Text, Value) - Text);
+	}
+
+	void AddInt(const int64 Value) {
+		char Text[DMSSimGroundTruthFormat::MAX_VALUE_LENGTH];
+		AddText(Text, DMSSimGroundTruthFormat::FormatInt(Text, Value) - Text);
+	}
 
+	void AddBool(const bool Value) { AddText(Value ? "1" : "0", 1); }
+
+	/** Time as hh:mm:ss.fff, the milliseconds are truncated. */
+	void AddTime(const double Time) {
+		char Text[DMSSimGroundTruthFormat::MAX_VALUE_LENGTH];
+		AddText(Text, DMSSimGroundTruthFormat::FormatTime(Text, DMSSimGroundTruthFormat::TimeToMilliseconds(Time)) - Text);
+	}
+
+	void AddText(const char* const Text, const size_t Length) {
+		if (FieldCount_ > 0) { Buffer_ += ';'; }
+		Buffer_ += '"';
+		Buffer_.append(Text, Length);
+		Buffer_ += '"';
+		++FieldCount_;
+	}
+
+	const std::string& GetRow() const { return Buffer_; }
+
+private:
+	std::string Buffer_;
+	size_t      FieldCount_ = 0;
+	size_t      ColumnFieldCount_ = 0;
 };
 
-typedef void (*ColumnHandlerFunc)(std::ostream& Stream, const DMSSimFrameComputed& Frame);
+/**
+ * Stores the values of a row into the 32 bit cells of a binary columnar row, converted to the column types.
+ * Values beyond the columns of a column table entry are dropped, values the handler doesn't write stay missing.
+ */
+class ColumnarRowWriter {
+public:
+	ColumnarRowWriter(uint32* const Cells, const std::vector<DMSSimGroundTruthFormat::ColumnInfo>& Columns) : Cells_(Cells), Columns_(Columns) {}
+
+	void BeginColumn(const size_t FirstValue, const size_t ValueCount) {
+		Next_ = FirstValue;
+		End_ = FirstValue + ValueCount;
+	}
+
+	void EndColumn() {}
+
+	void AddFloat(const float Value) {
+		if (Next_ == End_) { return; }
+		const auto Type = Columns_[Next_].Type;
+		Cells_[Next_++] = Type == DMSSimGroundTruthFormat::ColumnType::Float32 ? DMSSimGroundTruthFormat::FloatToBits(Value) : static_cast<uint32>(static_cast<int32>(Value));
+	}
+
+	void AddInt(const int64 Value) {
+		if (Next_ == End_) { return; }
+		const auto Type = Columns_[Next_].Type;
+		Cells_[Next_++] = Type == DMSSimGroundTruthFormat::ColumnType::Float32 ? DMSSimGroundTruthFormat::FloatToBits(static_cast<float>(Value)) : static_cast<uint32>(static_cast<int32>(Value));
+	}
+
+	void AddBool(const bool Value) { AddInt(Value ? 1 : 0); }
+
+	void AddTime(const double Time) {
+		if (Next_ == End_) { return; }
+		Cells_[Next_++] = static_cast<uint32>(DMSSimGroundTruthFormat::TimeToMilliseconds(Time));
+	}
+
+private:
+	uint32* const                                           Cells_;
+	const std::vector<DMSSimGroundTruthFormat::ColumnInfo>& Columns_;
+	size_t                                                  Next_ = 0;
+	size_t                                                  End_ = 0;
+};
+
+/** Records the type of the first value of a column handler, for the schema of the binary columnar format. */
+class TypeProbeRowWriter {
+public:
+	void BeginColumn(size_t, size_t) {}
+	void EndColumn() {}
+	void AddFloat(float) { SetType(DMSSimGroundTruthFormat::ColumnType::Float32); }
+	void AddInt(int64) { SetType(DMSSimGroundTruthFormat::ColumnType::Int32); }
+	void AddBool(bool) { SetType(DMSSimGroundTruthFormat::ColumnType::Int32); }
+	void AddTime(double) { SetType(DMSSimGroundTruthFormat::ColumnType::TimeMs); }
+
+	DMSSimGroundTruthFormat::ColumnType GetType() const { return Type_; }
+
+private:
+	void SetType(const DMSSimGroundTruthFormat::ColumnType Type) {
+		if (!HasValue_) { Type_ = Type; }
+		HasValue_ = true;
+	}
+
+	DMSSimGroundTruthFormat::ColumnType Type_ = DMSSimGroundTruthFormat::ColumnType::Int32;
+	bool                                HasValue_ = false;
+};
+
+template <typename TRow>
+using ColumnHandlerFunc = void (*)(TRow& Row, const DMSSimFrameComputed& Frame);
+
+/** A column handler instantiated for every row writer, the one of a writer is std::get<ColumnHandlerFunc<TRow>>. */
+using ColumnHandlerFuncs = std::tuple<ColumnHandlerFunc<CsvRowWriter>, ColumnHandlerFunc<ColumnarRowWriter>, ColumnHandlerFunc<TypeProbeRowWriter>>;
+
+#define COLUMN_HANDLER(Func) ColumnHandlerFuncs(&Func<CsvRowWriter>, &Func<ColumnarRowWriter>, &Func<TypeProbeRowWriter>)
 
 struct OccupantInfo {
 	FDMSSimOccupantType Occupant;
@@ -85,67 +221,31 @@ const OccupantInfo GTOccupantInfos[] =
 };
 
 struct ColumnHandler {
-	const char*       ColumnName;
-	ColumnHandlerFunc Func;
-	bool              DriverOnly;
-	bool              WithoutPrefix;
+	const char*        ColumnName;
+	ColumnHandlerFuncs Func;
+	bool               DriverOnly;
+	bool               WithoutPrefix;
 };
-std::ostream& PrintBool(std::ostream& Stream, const bool Value) {
-	Stream << int(Value);
-	return Stream;
-}
-std::ostream& PrintFloat(std::ostream& Stream, const float Value) {
-	Stream << std::setprecision(8) << Value;
-	return Stream;
-}
-
-std::ostream& PrintInt(std::ostream& Stream, const int Value) {
-	Stream << Value;
-	return Stream;
-}
 
 void NormalizeVectorInCM(FVector& V) {
 	V.Normalize();
 	V *= 100.0f;
 }
 
-std::ostream& PrintFloatDiv100(std::ostream& Stream, const float Value) {
-	Stream << std::setprecision(8) << (Value / 100.0f);
-	return Stream;
-}
-
-std::ostream& PrintAngleFloat(std::ostream& Stream, const float Value) {
-	const float ValueRad = static_cast<float>((PI * Value) / 180.0);
-	return PrintFloat(Stream, ValueRad);
-}
+float ToRadians(const float Value) { return static_cast<float>((PI * Value) / 180.0); }
 
-void ColumnHandler_Time(std::ostream& Stream, const DMSSimFrameComputed& Frame) {
-	double FullSeconds = 0.0f;
-	const double FracSeconds = std::modf(Frame.Time, &FullSeconds);
-	const int SecondsTotal = static_cast<int>(FullSeconds);
-	const int Seconds = SecondsTotal % 60;
-	const int MinutesTotal = SecondsTotal / 60;
-	const int Minutes = MinutesTotal % 60;
-	const int Hours = MinutesTotal / 60;
-
-	const int Fraction = static_cast<int>(FracSeconds * 1000);
-
-	Stream << std::setfill('0') << std::setw(2) << Hours;
-	Stream << ":";
-	Stream << std::setfill('0') << std::setw(2) << Minutes;
-	Stream << ":";
-	Stream << std::setfill('0') << std::setw(2) << Seconds;
-	Stream << ".";
-	Stream << std::setfill('0') << std::setw(3) << Fraction;
-}
+template <typename TRow>
+void ColumnHandler_Time(TRow& Row, const DMSSimFrameComputed& Frame) { Row.AddTime(Frame.Time); }
 
-void ColumnHandler_Availability(std::ostream& Stream, const DMSSimFrameComputed& Frame) { Stream << 1; }
+template <typename TRow>
+void ColumnHandler_Availability(TRow& Row, const DMSSimFrameComputed& Frame) { Row.AddInt(1); }
 
-void ColumnHandler_FrameNumber(std::ostream& Stream, const DMSSimFrameComputed& Frame) { Stream << FrameNumber_; }
+template <typename TRow>
+void ColumnHandler_FrameNumber(TRow& Row, const DMSSimFrameComputed& Frame) { Row.AddInt(FrameNumber_); }
 
-#define DMS_POSITION_EXTRACTOR(NAME, COMPONENT) void ColumnHandler_DM_##NAME##COMPONENT(std::ostream& Stream, const DMSSimFrameComputed& Frame)\
+#define DMS_POSITION_EXTRACTOR(NAME, COMPONENT) template <typename TRow> void ColumnHandler_DM_##NAME##COMPONENT(TRow& Row, const DMSSimFrameComputed& Frame)\
 {\
-	PrintFloat(Stream, Frame.##NAME##.##COMPONENT);\
+	Row.AddFloat(Frame.NAME.COMPONENT);\
 }
 
 #define DMS_POSITION_EXTRACTOR_SET(NAME) DMS_POSITION_EXTRACTOR(NAME, X)\
@@ -185,163 +285,143 @@ DMS_POSITION_EXTRACTOR_SET(GazeDirection_inCam)
 DMS_POSITION_EXTRACTOR_SET(LeftGazeDirection_inCam)
 DMS_POSITION_EXTRACTOR_SET(RightGazeDirection_inCam)
 
-void ColumnHandler_DM_HeadRotationYaw(std::ostream& Stream, const DMSSimFrameComputed& Frame) { PrintAngleFloat(Stream, Frame.HeadRotation.Yaw); }
+template <typename TRow>
+void ColumnHandler_DM_HeadRotationYaw(TRow& Row, const DMSSimFrameComputed& Frame) { Row.AddFloat(ToRadians(Frame.HeadRotation.Yaw)); }
 
-void ColumnHandler_DM_HeadRotationPitch(std::ostream& Stream, const DMSSimFrameComputed& Frame) { PrintAngleFloat(Stream, Frame.HeadRotation.Pitch); }
+template <typename TRow>
+void ColumnHandler_DM_HeadRotationPitch(TRow& Row, const DMSSimFrameComputed& Frame) { Row.AddFloat(ToRadians(Frame.HeadRotation.Pitch)); }
 
-void ColumnHandler_DM_HeadRotationRoll(std::ostream& Stream, const DMSSimFrameComputed& Frame) { PrintAngleFloat(Stream, Frame.HeadRotation.Roll); }
+template <typename TRow>
+void ColumnHandler_DM_HeadRotationRoll(TRow& Row, const DMSSimFrameComputed& Frame) { Row.AddFloat(ToRadians(Frame.HeadRotation.Roll)); }
 
-#define DMS_POSITION_IN_SM_EXTRACTOR_EYE_OPEN(NAME) void ColumnHandler_DM_##NAME##EyeOpen(std::ostream& Stream, const DMSSimFrameComputed& Frame)\
+#define DMS_POSITION_IN_SM_EXTRACTOR_EYE_OPEN(NAME) template <typename TRow> void ColumnHandler_DM_##NAME##EyeOpen(TRow& Row, const DMSSimFrameComputed& Frame)\
 {\
 	const int Value = (Frame.NAME##EyeOpen > 0)? 1 : 0;\
-	PrintInt(Stream, Value);\
+	Row.AddInt(Value);\
 }
 
-#define DMS_POSITION_IN_SM_EXTRACTOR_EYE_CLOSED(NAME) void ColumnHandler_DM_##NAME##EyeClosed(std::ostream& Stream, const DMSSimFrameComputed& Frame)\
+#define DMS_POSITION_IN_SM_EXTRACTOR_EYE_CLOSED(NAME) template <typename TRow> void ColumnHandler_DM_##NAME##EyeClosed(TRow& Row, const DMSSimFrameComputed& Frame)\
 {\
 	const int Value = (Frame.NAME##EyeOpen > 0)? 0 : 1;\
-	PrintInt(Stream, Value);\
+	Row.AddInt(Value);\
 }
 
-void ColumnHandler_DM_HorizontalMouthOpening(std::ostream& Stream, const DMSSimFrameComputed& Frame) { PrintFloatDiv100(Stream, Frame.HorizontalMouthOpening); }
+template <typename TRow>
+void ColumnHandler_DM_HorizontalMouthOpening(TRow& Row, const DMSSimFrameComputed& Frame) { Row.AddFloat(Frame.HorizontalMouthOpening / 100.0f); }
 
-void ColumnHandler_DM_VerticalMouthOpening(std::ostream& Stream, const DMSSimFrameComputed& Frame) { PrintFloatDiv100(Stream, Frame.VerticalMouthOpening); }
+template <typename TRow>
+void ColumnHandler_DM_VerticalMouthOpening(TRow& Row, const DMSSimFrameComputed& Frame) { Row.AddFloat(Frame.VerticalMouthOpening / 100.0f); }
 
-void ColumnHandler_FaceBB3DVisible(std::ostream& Stream, const DMSSimFrameComputed& Frame) { PrintBool(Stream, Frame.FaceBoundingBox3DVisible); }
+template <typename TRow>
+void ColumnHandler_FaceBB3DVisible(TRow& Row, const DMSSimFrameComputed& Frame) { Row.AddBool(Frame.FaceBoundingBox3DVisible); }
 
-void ColumnHandler_FaceBB2DVisible(std::ostream& Stream, const DMSSimFrameComputed& Frame) { PrintBool(Stream, Frame.FaceBoundingBox2DVisible); }
+template <typename TRow>
+void ColumnHandler_FaceBB2DVisible(TRow& Row, const DMSSimFrameComputed& Frame) { Row.AddBool(Frame.FaceBoundingBox2DVisible); }
 
-void ColumnHandler_RightEyeBB2DVisible(std::ostream& Stream, const DMSSimFrameComputed& Frame) { PrintBool(Stream, Frame.RightEyeBoundingBox2DVisible); }
+template <typename TRow>
+void ColumnHandler_RightEyeBB2DVisible(TRow& Row, const DMSSimFrameComputed& Frame) { Row.AddBool(Frame.RightEyeBoundingBox2DVisible); }
 
-void ColumnHandler_LeftEyeBB2DVisible(std::ostream& Stream, const DMSSimFrameComputed& Frame) { PrintBool(Stream, Frame.LeftEyeBoundingBox2DVisible); }
+template <typename TRow>
+void ColumnHandler_LeftEyeBB2DVisible(TRow& Row, const DMSSimFrameComputed& Frame) { Row.AddBool(Frame.LeftEyeBoundingBox2DVisible); }
 
-void ColumnHandler_FillFacialLandmarks(std::ostream& Stream, const DMSSimFrameComputed& Frame) {
+template <typename TRow>
+void ColumnHandler_FillFacialLandmarks(TRow& Row, const DMSSimFrameComputed& Frame) {
 	// Print each facial landmark in the csv file like:
-	// "<FacialLandmark_0_x>"; "<FacialLandmark_0_y>"; "<FacialLandmark_0_z>";
-	bool firstLandmark = true;
+	// "<FacialLandmark_0_visible>";"<FacialLandmark_0_x>";"<FacialLandmark_0_y>";"<FacialLandmark_0_z>";"<FacialLandmark_0_u>";"<FacialLandmark_0_v>"
 	for (auto i = 0; i < Frame.FacialLandmarks3D.Num(); i++) {
-		if (!firstLandmark) { Stream << ";\""; }
-		PrintBool(Stream, Frame.FacialLandmarksVisible[i]);
-		Stream << "\";\"";
-		PrintFloat(Stream, Frame.FacialLandmarks3D[i].X);
-		Stream << "\";\"";
-		PrintFloat(Stream, Frame.FacialLandmarks3D[i].Y);
-		Stream << "\";\"";
-		PrintFloat(Stream, Frame.FacialLandmarks3D[i].Z);
-		Stream << "\";\"";
-		PrintInt(Stream, int(Frame.FacialLandmarks2D[i].X));
-		Stream << "\";\"";
-		PrintInt(Stream, int(Frame.FacialLandmarks2D[i].Y));
-
-		bool lastLandmark = i == Frame.FacialLandmarks3D.Num() - 1;
-		if (!lastLandmark) { Stream << "\""; }
-		firstLandmark = false;
-	}
-}
-
-void PrintVectorArray(std::ostream& Stream, const TArray<FVector> VectorArray) {
-	bool firstElement = true;
-	for (auto i = 0; i < VectorArray.Num(); i++) {
-		if (!firstElement) { Stream << ";\""; }
-		PrintFloat(Stream, VectorArray[i].X);
-		Stream << "\";\"";
-		PrintFloat(Stream, VectorArray[i].Y);
-		Stream << "\";\"";
-		PrintFloat(Stream, VectorArray[i].Z);
-
-		bool lastElement = i == VectorArray.Num() - 1;
-		if (!lastElement) {	Stream << "\""; }
-		firstElement = false;
+		Row.AddBool(Frame.FacialLandmarksVisible[i]);
+		Row.AddFloat(Frame.FacialLandmarks3D[i].X);
+		Row.AddFloat(Frame.FacialLandmarks3D[i].Y);
+		Row.AddFloat(Frame.FacialLandmarks3D[i].Z);
+		Row.AddInt(int(Frame.FacialLandmarks2D[i].X));
+		Row.AddInt(int(Frame.FacialLandmarks2D[i].Y));
 	}
 }
 
-void PrintVector2DArray(std::ostream& Stream, const TArray<FVector2D> VectorArray) {
-	bool firstElement = true;
-	for (auto i = 0; i < VectorArray.Num(); i++) {
-		if (!firstElement) { Stream << ";\""; }
-		PrintFloat(Stream, VectorArray[i].X);
-		Stream << "\";\"";
-		PrintFloat(Stream, VectorArray[i].Y);
-
-		bool lastElement = i == VectorArray.Num() - 1;
-		if (!lastElement) { Stream << "\""; }
-		firstElement = false;
+template <typename TRow>
+void AddVectorArray(TRow& Row, const decltype(DMSSimFrameComputed::FaceBoundingBox3D)& VectorArray) {
+	for (const FVector& Vector : VectorArray) {
+		Row.AddFloat(Vector.X);
+		Row.AddFloat(Vector.Y);
+		Row.AddFloat(Vector.Z);
 	}
 }
 
-void PrintBoundingBox2D(std::ostream& Stream, const FDMSBoundingBox2D BoundingBox) {
-	PrintFloat(Stream, BoundingBox.Center.X);
-	Stream << "\";\"";
-	PrintFloat(Stream, BoundingBox.Center.Y);
-	Stream << "\";\"";
-	PrintFloat(Stream, BoundingBox.Width);
-	Stream << "\";\"";
-	PrintFloat(Stream, BoundingBox.Height);
+template <typename TRow>
+void AddBoundingBox2D(TRow& Row, const FDMSBoundingBox2D& BoundingBox) {
+	Row.AddFloat(BoundingBox.Center.X);
+	Row.AddFloat(BoundingBox.Center.Y);
+	Row.AddFloat(BoundingBox.Width);
+	Row.AddFloat(BoundingBox.Height);
 }
 
-void ColumnHandler_FillFaceBoundingBox3D(std::ostream& Stream, const DMSSimFrameComputed& Frame) { PrintVectorArray(Stream, Frame.FaceBoundingBox3D); }
+template <typename TRow>
+void ColumnHandler_FillFaceBoundingBox3D(TRow& Row, const DMSSimFrameComputed& Frame) { AddVectorArray(Row, Frame.FaceBoundingBox3D); }
 
-void ColumnHandler_FillFaceBoundingBox2D(std::ostream& Stream, const DMSSimFrameComputed& Frame) { PrintBoundingBox2D(Stream, Frame.FaceBoundingBox2D); }
+template <typename TRow>
+void ColumnHandler_FillFaceBoundingBox2D(TRow& Row, const DMSSimFrameComputed& Frame) { AddBoundingBox2D(Row, Frame.FaceBoundingBox2D); }
 
-void ColumnHandler_FillRightEyeBoundingBox2D(std::ostream& Stream, const DMSSimFrameComputed& Frame) { PrintBoundingBox2D(Stream, Frame.RightEyeBoundingBox2D); }
+template <typename TRow>
+void ColumnHandler_FillRightEyeBoundingBox2D(TRow& Row, const DMSSimFrameComputed& Frame) { AddBoundingBox2D(Row, Frame.RightEyeBoundingBox2D); }
 
-void ColumnHandler_FillLeftEyeBoundingBox2D(std::ostream& Stream, const DMSSimFrameComputed& Frame) { PrintBoundingBox2D(Stream, Frame.LeftEyeBoundingBox2D); }
+template <typename TRow>
+void ColumnHandler_FillLeftEyeBoundingBox2D(TRow& Row, const DMSSimFrameComputed& Frame) { AddBoundingBox2D(Row, Frame.LeftEyeBoundingBox2D); }
 
 #define QUOTE_STR_INRL(x) #x
 #define QUOTE_STR(x) QUOTE_STR_INRL(x)
 #define CONCAT_STR_INRL(a, b) a##b
 #define CONCAT_STR(a, b) CONCAT_STR_INRL(a, b)
 
-#define SET_COLUMN_PROCESSOR_POINT_COMPONENT(name, comp) { QUOTE_STR(CONCAT_STR(name, comp)), CONCAT_STR(CONCAT_STR(&ColumnHandler_DM_, name), comp) },
+#define SET_COLUMN_PROCESSOR_POINT_COMPONENT(name, comp) { QUOTE_STR(CONCAT_STR(name, comp)), COLUMN_HANDLER(CONCAT_STR(CONCAT_STR(ColumnHandler_DM_, name), comp)) },
 #define SET_COLUMN_PROCESSOR_POINT(name)  SET_COLUMN_PROCESSOR_POINT_COMPONENT(name, X) SET_COLUMN_PROCESSOR_POINT_COMPONENT(name, Y) SET_COLUMN_PROCESSOR_POINT_COMPONENT(name, Z)
 
 ColumnHandler Columns[] = {
-	{ "Time", &ColumnHandler_Time, true, true},
-	{ "LeftEyePositionX", &ColumnHandler_DM_LeftEyePointX },
-	{ "LeftEyePositionY", &ColumnHandler_DM_LeftEyePointY },
-	{ "LeftEyePositionZ", &ColumnHandler_DM_LeftEyePointZ },
-	{ "RightEyePositionX", &ColumnHandler_DM_RightEyePointX },
-	{ "RightEyePositionY", &ColumnHandler_DM_RightEyePointY },
-	{ "RightEyePositionZ", &ColumnHandler_DM_RightEyePointZ },
-	{ "LeftGazeOriginX", &ColumnHandler_DM_LeftGazeOrigin_inCamX },
-	{ "LeftGazeOriginY", &ColumnHandler_DM_LeftGazeOrigin_inCamY },
-	{ "LeftGazeOriginZ", &ColumnHandler_DM_LeftGazeOrigin_inCamZ },
-	{ "RightGazeOriginX", &ColumnHandler_DM_RightGazeOrigin_inCamX },
-	{ "RightGazeOriginY", &ColumnHandler_DM_RightGazeOrigin_inCamY },
-	{ "RightGazeOriginZ", &ColumnHandler_DM_RightGazeOrigin_inCamZ },
-	{ "LeftGazeDirectionX", &ColumnHandler_DM_LeftGazeDirection_inCamX },
-	{ "LeftGazeDirectionY", &ColumnHandler_DM_LeftGazeDirection_inCamY },
-	{ "LeftGazeDirectionZ", &ColumnHandler_DM_LeftGazeDirection_inCamZ },
-	{ "RightGazeDirectionX", &ColumnHandler_DM_RightGazeDirection_inCamX },
-	{ "RightGazeDirectionY", &ColumnHandler_DM_RightGazeDirection_inCamY },
-	{ "RightGazeDirectionZ", &ColumnHandler_DM_RightGazeDirection_inCamZ },
-	{ "GazeOriginX", &ColumnHandler_DM_GazeOrigin_inCamX },
-	{ "GazeOriginY", &ColumnHandler_DM_GazeOrigin_inCamY },
-	{ "GazeOriginZ", &ColumnHandler_DM_GazeOrigin_inCamZ },
-	{ "GazeVectorX", &ColumnHandler_DM_GazeDirection_inCamX },
-	{ "GazeVectorY", &ColumnHandler_DM_GazeDirection_inCamY },
-	{ "GazeVectorZ", &ColumnHandler_DM_GazeDirection_inCamZ },
-	{ "HeadPositionX", &ColumnHandler_DM_HeadPositionX },
-	{ "HeadPositionY", &ColumnHandler_DM_HeadPositionY },
-	{ "HeadPositionZ", &ColumnHandler_DM_HeadPositionZ },
-	{ "HeadRotationYaw", &ColumnHandler_DM_HeadRotationYaw },
-	{ "HeadRotationPitch", &ColumnHandler_DM_HeadRotationPitch },
-	{ "HeadRotationRoll", &ColumnHandler_DM_HeadRotationRoll },
-	{ "CameraPositionZ", &ColumnHandler_DM_CameraPositionZ, true},
-	{ "CameraPositionX", &ColumnHandler_DM_CameraPositionX, true},
-	{ "CameraPositionY", &ColumnHandler_DM_CameraPositionY, true},
-	{ "Availability", &ColumnHandler_Availability, true},
-	{ "HorizontalMouthOpening", &ColumnHandler_DM_HorizontalMouthOpening },
-	{ "VerticalMouthOpening",   &ColumnHandler_DM_VerticalMouthOpening },
-	{ "FacialLandmarks_$LX68$", &ColumnHandler_FillFacialLandmarks, false, true },
-	{ "FaceBoundingBox3DVisible", &ColumnHandler_FaceBB3DVisible, false, true },
-	{ "FaceBoundingBox3D_$V3DX8$", &ColumnHandler_FillFaceBoundingBox3D, false, true },
-	{ "FaceBoundingBox2DVisible", &ColumnHandler_FaceBB2DVisible, false, true },
-	{ "FaceBoundingBox2D_$BB2D$", &ColumnHandler_FillFaceBoundingBox2D, false, true },
-	{ "RightEyeBoundingBox2DVisible", &ColumnHandler_RightEyeBB2DVisible, false, true},
-	{ "RightEyeBoundingBox2D_$BB2D$", &ColumnHandler_FillRightEyeBoundingBox2D, false, true },
-	{ "LeftEyeBoundingBox2DVisible", &ColumnHandler_LeftEyeBB2DVisible, false, true},
-	{ "LeftEyeBoundingBox2D_$BB2D$", &ColumnHandler_FillLeftEyeBoundingBox2D, false, true },
+	{ "Time", COLUMN_HANDLER(ColumnHandler_Time), true, true},
+	{ "LeftEyePositionX", COLUMN_HANDLER(ColumnHandler_DM_LeftEyePointX) },
+	{ "LeftEyePositionY", COLUMN_HANDLER(ColumnHandler_DM_LeftEyePointY) },
+	{ "LeftEyePositionZ", COLUMN_HANDLER(ColumnHandler_DM_LeftEyePointZ) },
+	{ "RightEyePositionX", COLUMN_HANDLER(ColumnHandler_DM_RightEyePointX) },
+	{ "RightEyePositionY", COLUMN_HANDLER(ColumnHandler_DM_RightEyePointY) },
+	{ "RightEyePositionZ", COLUMN_HANDLER(ColumnHandler_DM_RightEyePointZ) },
+	{ "LeftGazeOriginX", COLUMN_HANDLER(ColumnHandler_DM_LeftGazeOrigin_inCamX) },
+	{ "LeftGazeOriginY", COLUMN_HANDLER(ColumnHandler_DM_LeftGazeOrigin_inCamY) },
+	{ "LeftGazeOriginZ", COLUMN_HANDLER(ColumnHandler_DM_LeftGazeOrigin_inCamZ) },
+	{ "RightGazeOriginX", COLUMN_HANDLER(ColumnHandler_DM_RightGazeOrigin_inCamX) },
+	{ "RightGazeOriginY", COLUMN_HANDLER(ColumnHandler_DM_RightGazeOrigin_inCamY) },
+	{ "RightGazeOriginZ", COLUMN_HANDLER(ColumnHandler_DM_RightGazeOrigin_inCamZ) },
+	{ "LeftGazeDirectionX", COLUMN_HANDLER(ColumnHandler_DM_LeftGazeDirection_inCamX) },
+	{ "LeftGazeDirectionY", COLUMN_HANDLER(ColumnHandler_DM_LeftGazeDirection_inCamY) },
+	{ "LeftGazeDirectionZ", COLUMN_HANDLER(ColumnHandler_DM_LeftGazeDirection_inCamZ) },
+	{ "RightGazeDirectionX", COLUMN_HANDLER(ColumnHandler_DM_RightGazeDirection_inCamX) },
+	{ "RightGazeDirectionY", COLUMN_HANDLER(ColumnHandler_DM_RightGazeDirection_inCamY) },
+	{ "RightGazeDirectionZ", COLUMN_HANDLER(ColumnHandler_DM_RightGazeDirection_inCamZ) },
+	{ "GazeOriginX", COLUMN_HANDLER(ColumnHandler_DM_GazeOrigin_inCamX) },
+	{ "GazeOriginY", COLUMN_HANDLER(ColumnHandler_DM_GazeOrigin_inCamY) },
+	{ "GazeOriginZ", COLUMN_HANDLER(ColumnHandler_DM_GazeOrigin_inCamZ) },
+	{ "GazeVectorX", COLUMN_HANDLER(ColumnHandler_DM_GazeDirection_inCamX) },
+	{ "GazeVectorY", COLUMN_HANDLER(ColumnHandler_DM_GazeDirection_inCamY) },
+	{ "GazeVectorZ", COLUMN_HANDLER(ColumnHandler_DM_GazeDirection_inCamZ) },
+	{ "HeadPositionX", COLUMN_HANDLER(ColumnHandler_DM_HeadPositionX) },
+	{ "HeadPositionY", COLUMN_HANDLER(ColumnHandler_DM_HeadPositionY) },
+	{ "HeadPositionZ", COLUMN_HANDLER(ColumnHandler_DM_HeadPositionZ) },
+	{ "HeadRotationYaw", COLUMN_HANDLER(ColumnHandler_DM_HeadRotationYaw) },
+	{ "HeadRotationPitch", COLUMN_HANDLER(ColumnHandler_DM_HeadRotationPitch) },
+	{ "HeadRotationRoll", COLUMN_HANDLER(ColumnHandler_DM_HeadRotationRoll) },
+	{ "CameraPositionZ", COLUMN_HANDLER(ColumnHandler_DM_CameraPositionZ), true},
+	{ "CameraPositionX", COLUMN_HANDLER(ColumnHandler_DM_CameraPositionX), true},
+	{ "CameraPositionY", COLUMN_HANDLER(ColumnHandler_DM_CameraPositionY), true},
+	{ "Availability", COLUMN_HANDLER(ColumnHandler_Availability), true},
+	{ "HorizontalMouthOpening", COLUMN_HANDLER(ColumnHandler_DM_HorizontalMouthOpening) },
+	{ "VerticalMouthOpening",   COLUMN_HANDLER(ColumnHandler_DM_VerticalMouthOpening) },
+	{ "FacialLandmarks_$LX68$", COLUMN_HANDLER(ColumnHandler_FillFacialLandmarks), false, true },
+	{ "FaceBoundingBox3DVisible", COLUMN_HANDLER(ColumnHandler_FaceBB3DVisible), false, true },
+	{ "FaceBoundingBox3D_$V3DX8$", COLUMN_HANDLER(ColumnHandler_FillFaceBoundingBox3D), false, true },
+	{ "FaceBoundingBox2DVisible", COLUMN_HANDLER(ColumnHandler_FaceBB2DVisible), false, true },
+	{ "FaceBoundingBox2D_$BB2D$", COLUMN_HANDLER(ColumnHandler_FillFaceBoundingBox2D), false, true },
+	{ "RightEyeBoundingBox2DVisible", COLUMN_HANDLER(ColumnHandler_RightEyeBB2DVisible), false, true},
+	{ "RightEyeBoundingBox2D_$BB2D$", COLUMN_HANDLER(ColumnHandler_FillRightEyeBoundingBox2D), false, true },
+	{ "LeftEyeBoundingBox2DVisible", COLUMN_HANDLER(ColumnHandler_LeftEyeBB2DVisible), false, true},
+	{ "LeftEyeBoundingBox2D_$BB2D$", COLUMN_HANDLER(ColumnHandler_FillLeftEyeBoundingBox2D), false, true },
 
 	SET_COLUMN_PROCESSOR_POINT(LeftShoulderPoint)
 	SET_COLUMN_PROCESSOR_POINT(RightShoulderPoint)
@@ -367,111 +447,101 @@ ColumnHandler Columns[] = {
 	SET_COLUMN_PROCESSOR_POINT(RightFootIndexPoint)
 };
 
-FVector ConvertPointToBaseCoordinateSpace(const DMSSimCoordinateSpace& CoordinateSpace, const FVector& Point) {
-	FVector NewPoint(Point);
-	const auto Rotation = CoordinateSpace.GetRotation();
-	const auto Translation = CoordinateSpace.GetTranslation();
-	const auto Scale = CoordinateSpace.GetScale();
-	NewPoint /= DMSSIM_M_TO_CM;
-	NewPoint /= Scale;
-	NewPoint = Rotation.UnrotateVector(NewPoint);
-	NewPoint -= Translation;
-	return NewPoint;
-}
+/** The world points of an occupant that are converted into the base coordinate space, in one pass over their coordinates. */
+struct TransformedPoint {
+	FVector DMSSimGroundTruthOccupant::* Source;
+	FVector DMSSimFrameComputed::*         Target;
+};
 
-FVector ConvertVectorToBaseCoordinateSpace(const DMSSimCoordinateSpace& CoordinateSpace, const FVector& Vector) {
-	FVector NewVector(Vector);
-	const auto Rotation = CoordinateSpace.GetRotation();
-	const auto Translation = CoordinateSpace.GetTranslation();
-	const auto Scale = CoordinateSpace.GetScale();
-	NewVector /= Scale;
-	NewVector = Rotation.UnrotateVector(NewVector);
-	NewVector.Normalize();
-	return NewVector;
-}
+#define TRANSFORMED_POINT(x) { &DMSSimGroundTruthOccupant::x, &DMSSimFrameComputed::x },
+
+const TransformedPoint TransformedPoints[] = {
+	{ &DMSSimGroundTruthOccupant::HeadOriginEyesCenter_inCam, &DMSSimFrameComputed::HeadPosition },
+	TRANSFORMED_POINT(LeftEyePoint)
+	TRANSFORMED_POINT(RightEyePoint)
+	TRANSFORMED_POINT(LeftGazeOrigin_inCam)
+	TRANSFORMED_POINT(RightGazeOrigin_inCam)
+	TRANSFORMED_POINT(LeftShoulderPoint)
+	TRANSFORMED_POINT(RightShoulderPoint)
+	TRANSFORMED_POINT(LeftElbowPoint)
+	TRANSFORMED_POINT(RightElbowPoint)
+	TRANSFORMED_POINT(LeftWristPoint)
+	TRANSFORMED_POINT(RightWristPoint)
+	TRANSFORMED_POINT(LeftPinkyKnucklePoint)
+	TRANSFORMED_POINT(RightPinkyKnucklePoint)
+	TRANSFORMED_POINT(LeftIndexKnucklePoint)
+	TRANSFORMED_POINT(RightIndexKnucklePoint)
+	TRANSFORMED_POINT(LeftThumbKnucklePoint)
+	TRANSFORMED_POINT(RightThumbKnucklePoint)
+	TRANSFORMED_POINT(LeftHipPoint)
+	TRANSFORMED_POINT(RightHipPoint)
+	TRANSFORMED_POINT(LeftKneePoint)
+	TRANSFORMED_POINT(RightKneePoint)
+	TRANSFORMED_POINT(LeftAnklePoint)
+	TRANSFORMED_POINT(RightAnklePoint)
+	TRANSFORMED_POINT(LeftHeelPoint)
+	TRANSFORMED_POINT(RightHeelPoint)
+	TRANSFORMED_POINT(LeftFootIndexPoint)
+	TRANSFORMED_POINT(RightFootIndexPoint)
+};
 
-void ComputeGroundTruthData(const double Time, const DMSSimGroundTruthCommon& Common, const DMSSimGroundTruthOccupant& Frame, DMSSimFrameComputed& DMSSimFrameComputed) {
+#undef TRANSFORMED_POINT
+
+constexpr int32 TRANSFORMED_POINT_COUNT = int32(sizeof(TransformedPoints) / sizeof(TransformedPoints[0])) + 1; // and the camera position
+
+void ComputeGroundTruthData(const double Time, const DMSSimGroundTruthTransform& Transform, const DMSSimGroundTruthFrame& GroundTruth, const DMSSimGroundTruthOccupant& Frame, DMSSimFrameComputed& DMSSimFrameComputed) {
 	memset(&DMSSimFrameComputed, 0, sizeof(DMSSimFrameComputed));
 	if (!Frame.Initialized) { return; }
 	DMSSimFrameComputed.Time = Time;
 
-	FVector CoordinateOffset(-256.275f, 0.0f, -159.9f); // temporary hardcoded offset
-	const auto& CarRotation_inWorld = Common.CarRotation_inWorld;
-	const auto& FrontAxleMidPoint = Common.CarPosition_inWorld;
-	const auto& CoordinateSpace = DMSSimConfig::GetCoordinateSpace();
-	const auto& Camera = DMSSimConfig::GetCamera();
 	const FVector BetweenEarsPoint = (Frame.LEarPoint + Frame.REarPoint) / 2;
 	FVector Forward = (Frame.NosePoint - BetweenEarsPoint);
 	Forward.Normalize();
 	FVector Right = (Frame.REarPoint - Frame.LEarPoint);
 	Right.Normalize();
 	FVector Up = Forward ^ Right;
-	Forward = ConvertVectorToBaseCoordinateSpace(CoordinateSpace, CarRotation_inWorld.UnrotateVector(Forward));
-	Right = ConvertVectorToBaseCoordinateSpace(CoordinateSpace, CarRotation_inWorld.UnrotateVector(Right));
-	Up = ConvertVectorToBaseCoordinateSpace(CoordinateSpace, CarRotation_inWorld.UnrotateVector(Up));
+	Forward = Transform.TransformDirection(Forward);
+	Right = Transform.TransformDirection(Right);
+	Up = Transform.TransformDirection(Up);
 	DMSSimFrameComputed.HeadRotation = FTransform(Forward, Right, Up, FVector(0, 0, 0)).Rotator();
 	DMSSimFrameComputed.HeadRotation *= -1.0f;
-	if (Camera.GetMirrored()) { DMSSimFrameComputed.HeadRotation.Yaw *= -1.0f; }
-
-	const auto TransformPoint = [&CoordinateSpace, &CarRotation_inWorld, FrontAxleMidPoint](const FVector& Point) {
-		return ConvertPointToBaseCoordinateSpace(CoordinateSpace, CarRotation_inWorld.UnrotateVector(Point - FrontAxleMidPoint));
-	};
-
-#define TRANSFORM_POINT(x) DMSSimFrameComputed.##x = TransformPoint(Frame.##x);
-
-	DMSSimFrameComputed.HeadPosition = TransformPoint(Frame.HeadOriginEyesCenter_inCam);
-	DMSSimFrameComputed.CameraPosition = TransformPoint(Common.Camera.Position_inCar);
+	if (GroundTruth.GetScenario().Camera.Mirrored) { DMSSimFrameComputed.HeadRotation.Yaw *= -1.0f; }
+
+	alignas(32) float X[TRANSFORMED_POINT_COUNT], Y[TRANSFORMED_POINT_COUNT], Z[TRANSFORMED_POINT_COUNT];
+	alignas(32) float OutX[TRANSFORMED_POINT_COUNT], OutY[TRANSFORMED_POINT_COUNT], OutZ[TRANSFORMED_POINT_COUNT];
+	int32 Count = 0;
+	for (const auto& Point : TransformedPoints) {
+		const FVector& Source = Frame.*Point.Source;
+		X[Count] = Source.X;
+		Y[Count] = Source.Y;
+		Z[Count] = Source.Z;
+		++Count;
+	}
+	const FVector& CameraPosition = GroundTruth.GetScenario().Camera.Position_inCar;
+	X[Count] = CameraPosition.X;
+	Y[Count] = CameraPosition.Y;
+	Z[Count] = CameraPosition.Z;
+	Transform.TransformPoints(X, Y, Z, TRANSFORMED_POINT_COUNT, OutX, OutY, OutZ);
+	Count = 0;
+	for (const auto& Point : TransformedPoints) {
+		DMSSimFrameComputed.*Point.Target = FVector(OutX[Count], OutY[Count], OutZ[Count]);
+		++Count;
+	}
+	DMSSimFrameComputed.CameraPosition = FVector(OutX[Count], OutY[Count], OutZ[Count]);
 	DMSSimFrameComputed.CameraRotation = FRotator(0, 0, 0); // Identity
 
-	TRANSFORM_POINT(LeftEyePoint)
-	TRANSFORM_POINT(RightEyePoint)
-	TRANSFORM_POINT(LeftGazeOrigin_inCam)
-	TRANSFORM_POINT(RightGazeOrigin_inCam)
-	TRANSFORM_POINT(LeftShoulderPoint)
-	TRANSFORM_POINT(RightShoulderPoint)
-	TRANSFORM_POINT(LeftElbowPoint)
-	TRANSFORM_POINT(RightElbowPoint)
-	TRANSFORM_POINT(LeftWristPoint)
-	TRANSFORM_POINT(RightWristPoint)
-	TRANSFORM_POINT(LeftPinkyKnucklePoint)
-	TRANSFORM_POINT(RightPinkyKnucklePoint)
-	TRANSFORM_POINT(LeftIndexKnucklePoint)
-	TRANSFORM_POINT(RightIndexKnucklePoint)
-	TRANSFORM_POINT(LeftThumbKnucklePoint)
-	TRANSFORM_POINT(RightThumbKnucklePoint)
-	TRANSFORM_POINT(LeftHipPoint)
-	TRANSFORM_POINT(RightHipPoint)
-	TRANSFORM_POINT(LeftKneePoint)
-	TRANSFORM_POINT(RightKneePoint)
-	TRANSFORM_POINT(LeftAnklePoint)
-	TRANSFORM_POINT(RightAnklePoint)
-	TRANSFORM_POINT(LeftHeelPoint)
-	TRANSFORM_POINT(RightHeelPoint)
-	TRANSFORM_POINT(LeftFootIndexPoint)
-	TRANSFORM_POINT(RightFootIndexPoint)
-
-#undef TRANSFORM_POINT
-
 	DMSSimFrameComputed.GazeOrigin_inCam = (DMSSimFrameComputed.LeftGazeOrigin_inCam + DMSSimFrameComputed.RightGazeOrigin_inCam) * 0.5f;
-	DMSSimFrameComputed.LeftGazeDirection_inCam = ConvertVectorToBaseCoordinateSpace(CoordinateSpace, CarRotation_inWorld.UnrotateVector(Frame.LeftGazeDirection_inCam));
-	DMSSimFrameComputed.RightGazeDirection_inCam = ConvertVectorToBaseCoordinateSpace(CoordinateSpace, CarRotation_inWorld.UnrotateVector(Frame.RightGazeDirection_inCam));
+	DMSSimFrameComputed.LeftGazeDirection_inCam = Transform.TransformDirection(Frame.LeftGazeDirection_inCam);
+	DMSSimFrameComputed.RightGazeDirection_inCam = Transform.TransformDirection(Frame.RightGazeDirection_inCam);
 	DMSSimFrameComputed.GazeDirection_inCam = (DMSSimFrameComputed.LeftGazeDirection_inCam + DMSSimFrameComputed.RightGazeDirection_inCam);
 	DMSSimFrameComputed.GazeDirection_inCam.Normalize();
 	DMSSimFrameComputed.HorizontalMouthOpening = Frame.HorizontalMouthOpening;
 	DMSSimFrameComputed.VerticalMouthOpening = Frame.VerticalMouthOpening;
-	
-	// Transform facial landmarks and save them.
-	DMSSimFrameComputed.FacialLandmarksVisible.Empty();
-	for (bool landmarkVisble : Frame.FacialLandmarksVisible){ DMSSimFrameComputed.FacialLandmarksVisible.Add(landmarkVisble); }
-
-	DMSSimFrameComputed.FacialLandmarks3D.Empty();
-	for (FVector landmark : Frame.FacialLandmarks3D_inCam){ DMSSimFrameComputed.FacialLandmarks3D.Add(landmark); }
-	
-	DMSSimFrameComputed.FacialLandmarks2D.Empty();
-	for (FVector2D landmark : Frame.FacialLandmarks2D){ DMSSimFrameComputed.FacialLandmarks2D.Add(landmark); }
-
-	DMSSimFrameComputed.FaceBoundingBox3D.Empty();
-	for (FVector landmark : Frame.FaceBoundingBox3D_inCam){ DMSSimFrameComputed.FaceBoundingBox3D.Add(landmark); }
+
+	DMSSimFrameComputed.FacialLandmarksVisible = Frame.FacialLandmarksVisible;
+	DMSSimFrameComputed.FacialLandmarks3D = Frame.FacialLandmarks3D_inCam;
+	DMSSimFrameComputed.FacialLandmarks2D = Frame.FacialLandmarks2D;
+	DMSSimFrameComputed.FaceBoundingBox3D = Frame.FaceBoundingBox3D_inCam;
 	DMSSimFrameComputed.FaceBoundingBox3DVisible = Frame.FaceBoundingBox3DVisible;
 	DMSSimFrameComputed.FaceBoundingBox2DVisible = Frame.FaceBoundingBox2DVisible;
 	DMSSimFrameComputed.FaceBoundingBox2D = Frame.FaceBoundingBox2D;
@@ -479,115 +549,202 @@ void ComputeGroundTruthData(const double Time, const DMSSimGroundTruthCommon& Co
 	DMSSimFrameComputed.RightEyeBoundingBox2D = Frame.RightEyeBoundingBox2D;
 	DMSSimFrameComputed.LeftEyeBoundingBox2DVisible = Frame.LeftEyeBoundingBox2DVisible;
 	DMSSimFrameComputed.LeftEyeBoundingBox2D = Frame.LeftEyeBoundingBox2D;
+}
+
+/**
+ * Component names and types of the repeated columns of the column table, e.g. FacialLandmarks_$LX68$ is expanded into
+ * FacialLandmarks_1_visible, FacialLandmarks_1_x, ... FacialLandmarks_68_v.
+ */
+struct RepeatedColumnKind {
+	const char* Kind;
+	int         FirstIndex;  // -1 - the column is not numbered, e.g. FaceBoundingBox2D_x
+	struct Component {
+		const char*                         Name;
+		DMSSimGroundTruthFormat::ColumnType Type;
+	};
+	std::vector<Component> Components;
+};
+
+const RepeatedColumnKind RepeatedColumnKinds[] =
+{
+	{ "LX", 1, { { "visible", DMSSimGroundTruthFormat::ColumnType::Int32 }, { "x", DMSSimGroundTruthFormat::ColumnType::Float32 },
+		{ "y", DMSSimGroundTruthFormat::ColumnType::Float32 }, { "z", DMSSimGroundTruthFormat::ColumnType::Float32 },
+		{ "u", DMSSimGroundTruthFormat::ColumnType::Int32 }, { "v", DMSSimGroundTruthFormat::ColumnType::Int32 } } },
+	{ "V3DX", 0, { { "x", DMSSimGroundTruthFormat::ColumnType::Float32 }, { "y", DMSSimGroundTruthFormat::ColumnType::Float32 },
+		{ "z", DMSSimGroundTruthFormat::ColumnType::Float32 } } },
+	{ "V2DX", 0, { { "x", DMSSimGroundTruthFormat::ColumnType::Float32 }, { "y", DMSSimGroundTruthFormat::ColumnType::Float32 } } },
+	{ "BB2D", -1, { { "x", DMSSimGroundTruthFormat::ColumnType::Float32 }, { "y", DMSSimGroundTruthFormat::ColumnType::Float32 },
+		{ "w", DMSSimGroundTruthFormat::ColumnType::Float32 }, { "h", DMSSimGroundTruthFormat::ColumnType::Float32 } } },
+};
 
+/**
+ * Columns and handlers of all occupants, in the order of the CSV file. A handler writes the values of Columns[FirstValue]
+ * to Columns[FirstValue + ValueCount - 1], several for the repeated columns of the table.
+ */
+struct ColumnPlan {
+	struct PlannedHandler {
+		ColumnHandlerFuncs Func;
+		size_t             FirstValue;
+		size_t             ValueCount;
+	};
+	struct OccupantColumns {
+		FDMSSimOccupantType         Occupant;
+		std::vector<PlannedHandler> Handlers;
+	};
+
+	std::vector<DMSSimGroundTruthFormat::ColumnInfo> Columns;
+	std::string                                      Header;
+	std::vector<OccupantColumns>                     Occupants;
+};
+
+/**
+ * Splits a column name with a repetition suffix, e.g. "FacialLandmarks_$LX68$" into "FacialLandmarks", "LX" and 68.
+ * @return false, if the name has no suffix.
+ */
+bool ParseRepeatedColumn(const char* const ColumnName, std::string& BaseName, std::string& Kind, int& Count) {
+	const char* const Suffix = std::strstr(ColumnName, "_$");
+	if (!Suffix) { return false; }
+	const char* const KindBegin = Suffix + 2;
+	const char* const KindEnd = std::strchr(KindBegin, '$');
+	if (!KindEnd) { return false; }
+	// the count is the trailing number, the kind itself may contain digits (V3DX8)
+	const char* CountBegin = KindEnd;
+	while (CountBegin > KindBegin && CountBegin[-1] >= '0' && CountBegin[-1] <= '9') { --CountBegin; }
+	BaseName.assign(ColumnName, Suffix);
+	Kind.assign(KindBegin, CountBegin);
+	Count = 0;
+	std::from_chars(CountBegin, KindEnd, Count);
+	return true;
 }
-} // anonymous namespace
 
-namespace RegexPatterns {
-	inline const std::regex& Landmark() {
-		static const std::regex instance(R"(((\w+)_\$LX(\d+)\$))");
-		return instance;
-	}
-	inline const std::regex& Vector() {
-		static const std::regex instance(R"(((\w+)_\$V3DX(\d+)\$))");
-		return instance;
-	}
-	inline const std::regex& Vector2D() {
-		static const std::regex instance(R"(((\w+)_\$V2DX(\d+)\$))");
-		return instance;
-	}	
-	inline const std::regex& BoundingBox2D() {
-		static const std::regex instance(R"(((\w+)_\$BB2D\$))");
-		return instance;
+const RepeatedColumnKind* FindRepeatedColumnKind(const std::string& Kind) {
+	for (const auto& RepeatedKind : RepeatedColumnKinds) {
+		if (Kind == RepeatedKind.Kind) { return &RepeatedKind; }
 	}
+	return nullptr;
 }
-void DMSSimGroundTruthRecorder::AddHeader(std::ostream& Stream) {
-	FrameNumber_ = 0;
 
-	bool RowStarted = false;
+/** Type of the single value a handler writes, found by calling it on an empty frame. */
+DMSSimGroundTruthFormat::ColumnType GetHandlerType(const ColumnHandlerFuncs& Func) {
+	TypeProbeRowWriter Probe;
+	if (const auto ProbeFunc = std::get<ColumnHandlerFunc<TypeProbeRowWriter>>(Func)) { ProbeFunc(Probe, DMSSimFrameComputed{}); }
+	return Probe.GetType();
+}
+
+ColumnPlan CompileColumnPlan() {
+	ColumnPlan Plan;
+	uint32 Group = 0;
+	const auto AddColumn = [&Plan, &Group](const std::string& ColumnName, const bool ColumnWithoutPrefix, const OccupantInfo& Occupant,
+		const DMSSimGroundTruthFormat::ColumnType Type) {
+		std::string Name = ColumnWithoutPrefix ? "" : "s_DM_";
+		Name += Occupant.Prefix;
+		Name += ColumnName;
+		Plan.Columns.push_back({ std::move(Name), Type, Group });
+	};
+
+	std::string BaseName;
+	std::string Kind;
+	int Count = 0;
 	for (const auto& Occupant : GTOccupantInfos) {
+		ColumnPlan::OccupantColumns& Entry = Plan.Occupants.emplace_back();
+		Entry.Occupant = Occupant.Occupant;
 		for (const ColumnHandler& Column : Columns) {
 			if (Column.DriverOnly && Occupant.Occupant != FDMSSimOccupantType::Driver) { continue; }
-			if (PRINT_ALL_COLUMNS || Column.Func) {
-				auto AddColumn = [&Stream, &RowStarted](const std::string& columnName, bool columnWithoutPrefix, const auto& Occupant) {
-					if (RowStarted) { Stream << ";"; }
-					Stream << "\"";
-					if (!columnWithoutPrefix) { Stream << "s_DM_"; }
-					Stream << Occupant.Prefix;
-					Stream << columnName << "\"";
-					RowStarted = true;
-				};
-				std::smatch match;
-				std::string columnName = Column.ColumnName;
-				bool columnWithoutPrefix = Column.WithoutPrefix;
-				
-				if (std::regex_search(columnName, match, RegexPatterns::Landmark()) && match.size() > 3) {
-					std::string baseName = match[2].str();			// Captures e.g. "FacialLandmarks"
-					int numLandmarks = std::stoi(match[3].str());	// Captures "10" and converts to int
-					for (int i = 1; i <= numLandmarks; i++) {
-						AddColumn(baseName + "_" + std::to_string(i) + "_" + "visible", columnWithoutPrefix, Occupant);
-						AddColumn(baseName + "_" + std::to_string(i) + "_" + "x", columnWithoutPrefix, Occupant);
-						AddColumn(baseName + "_" + std::to_string(i) + "_" + "y", columnWithoutPrefix, Occupant);
-						AddColumn(baseName + "_" + std::to_string(i) + "_" + "z", columnWithoutPrefix, Occupant);
-						AddColumn(baseName + "_" + std::to_string(i) + "_" + "u", columnWithoutPrefix, Occupant);
-						AddColumn(baseName + "_" + std::to_string(i) + "_" + "v", columnWithoutPrefix, Occupant);
+			if (!PRINT_ALL_COLUMNS && !std::get<0>(Column.Func)) { continue; }
+			const size_t FirstValue = Plan.Columns.size();
+
+			const bool WithoutPrefix = Column.WithoutPrefix;
+			const RepeatedColumnKind* const RepeatedKind = ParseRepeatedColumn(Column.ColumnName, BaseName, Kind, Count) ? FindRepeatedColumnKind(Kind) : nullptr;
+			if (!RepeatedKind) {
+				AddColumn(Column.ColumnName, WithoutPrefix, Occupant, GetHandlerType(Column.Func));
+			} else if (RepeatedKind->FirstIndex < 0) {
+				for (const auto& Component : RepeatedKind->Components) { AddColumn(BaseName + "_" + Component.Name, WithoutPrefix, Occupant, Component.Type); }
+			} else {
+				for (int i = RepeatedKind->FirstIndex; i < RepeatedKind->FirstIndex + Count; i++) {
+					for (const auto& Component : RepeatedKind->Components) {
+						AddColumn(BaseName + "_" + std::to_string(i) + "_" + Component.Name, WithoutPrefix, Occupant, Component.Type);
 					}
 				}
-				else if (std::regex_search(columnName, match, RegexPatterns::Vector()) && match.size() > 3) {
-					std::string baseName = match[2].str();			// Captures e.g. "FacialLandmarks"
-					int numVectors = std::stoi(match[3].str());	// Captures "10" and converts to int
-					for (int i = 0; i < numVectors; i++) {
-						AddColumn(baseName + "_" + std::to_string(i) + "_" + "x", columnWithoutPrefix, Occupant);
-						AddColumn(baseName + "_" + std::to_string(i) + "_" + "y", columnWithoutPrefix, Occupant);
-						AddColumn(baseName + "_" + std::to_string(i) + "_" + "z", columnWithoutPrefix, Occupant);
-					}
-				}
-				else if (std::regex_search(columnName, match, RegexPatterns::Vector2D()) && match.size() > 3) {
-					std::string baseName = match[2].str();			// Captures e.g. "FacialLandmarks"
-					int numVectors = std::stoi(match[3].str());	// Captures "10" and converts to int
-					for (int i = 0; i < numVectors; i++) {
-						AddColumn(baseName + "_" + std::to_string(i) + "_" + "x", columnWithoutPrefix, Occupant);
-						AddColumn(baseName + "_" + std::to_string(i) + "_" + "y", columnWithoutPrefix, Occupant);
-					}
-				}
-				else if (std::regex_search(columnName, match, RegexPatterns::BoundingBox2D())) {
-					std::string baseName = match[2].str();			// Captures e.g. "FacialLandmarks"
-
-					AddColumn(baseName + "_" + "x", columnWithoutPrefix, Occupant);
-					AddColumn(baseName + "_" + "y", columnWithoutPrefix, Occupant);
-					AddColumn(baseName + "_" + "w", columnWithoutPrefix, Occupant);
-					AddColumn(baseName + "_" + "h", columnWithoutPrefix, Occupant);
-				}
-				else {
-					AddColumn(columnName, columnWithoutPrefix, Occupant);
-				}				
 			}
+			Entry.Handlers.push_back({ Column.Func, FirstValue, Plan.Columns.size() - FirstValue });
+			++Group;
+		}
+	}
+
+	for (const auto& Column : Plan.Columns) {
+		if (!Plan.Header.empty()) { Plan.Header += ';'; }
+		Plan.Header += '"';
+		Plan.Header += Column.Name;
+		Plan.Header += '"';
+	}
+	Plan.Header += '\n';
+	return Plan;
+}
+
+/** The column set is fixed, so the plan is compiled once, by the first call that needs it. */
+const ColumnPlan& GetColumnPlan() {
+	static const ColumnPlan Plan = CompileColumnPlan();
+	return Plan;
+}
+
+template <typename TRow>
+void AddRow(TRow& Row, const double Time, const DMSSimGroundTruthFrame& Frame) {
+	// the occupants share the car, so the transform is created once per frame
+	const auto Transform = DMSSimGroundTruthTransform::Create(Frame.GetScenario().CoordinateSpace, Frame.Data.CarRotation_inWorld, Frame.Data.CarPosition_inWorld);
+	thread_local DMSSimFrameComputed FrameComputed;
+	for (const auto& Occupant : GetColumnPlan().Occupants) {
+		ComputeGroundTruthData(Time, Transform, Frame, Frame.Data.Occupants[static_cast<uint8>(Occupant.Occupant)], FrameComputed);
+		for (const auto& Handler : Occupant.Handlers) {
+			Row.BeginColumn(Handler.FirstValue, Handler.ValueCount);
+			if (const auto Func = std::get<ColumnHandlerFunc<TRow>>(Handler.Func)) { Func(Row, FrameComputed); }
+			else { Row.AddInt(0); }
+			Row.EndColumn();
 		}
 	}
-	Stream << std::endl;
+}
+
+} // anonymous namespace
+
+const std::vector<DMSSimGroundTruthFormat::ColumnInfo>& DMSSimGroundTruthRecorder::GetColumns() { return GetColumnPlan().Columns; }
+
+void DMSSimGroundTruthRecorder::AddHeader(std::ostream& Stream) {
+	FrameNumber_ = 0;
+	const std::string& Header = GetColumnPlan().Header;
+	Stream.write(Header.data(), static_cast<std::streamsize>(Header.size()));
 }
 
 void DMSSimGroundTruthRecorder::AddFrame(std::ostream& Stream, const double Time, const DMSSimGroundTruthFrame& Frame) {
 	if (!Stream.good()) { return; }
 
-	bool RowStarted = false;
-	for (const auto& Occupant : GTOccupantInfos) {
-		DMSSimFrameComputed FrameComputed{};
+	thread_local CsvRowWriter Row;
+	Row.BeginRow();
+	AddRow(Row, Time, Frame);
+	Row.EndRow();
+	const std::string& Text = Row.GetRow();
+	Stream.write(Text.data(), static_cast<std::streamsize>(Text.size()));
+	++FrameNumber_;
+}
 
-		ComputeGroundTruthData(Time, Frame.Common, Frame.Occupants[static_cast<uint8>(Occupant.Occupant)], FrameComputed);
-		for (const auto& Column : Columns) {
-			if (Column.DriverOnly && Occupant.Occupant != FDMSSimOccupantType::Driver) { continue; }
+void DMSSimGroundTruthRecorder::AddHeader(DMSSimGroundTruthColumnarWriter& Writer) {
+	FrameNumber_ = 0;
+	Writer.WriteHeader(GetColumnPlan().Columns);
+}
 
-			if (PRINT_ALL_COLUMNS || Column.Func) {
-				if (RowStarted) { Stream << ";"; }
-				Stream << "\"";
-				if (Column.Func) { Column.Func(Stream, FrameComputed); }
-				else { Stream << "0"; }
-				Stream << "\"";
-				RowStarted = true;
-			}
-		}
-	}
-	Stream << std::endl;
+void DMSSimGroundTruthRecorder::AddFrame(DMSSimGroundTruthColumnarWriter& Writer, const double Time, const DMSSimGroundTruthFrame& Frame) {
+	ColumnarRowWriter Row(Writer.BeginRow(), Writer.GetColumns());
+	AddRow(Row, Time, Frame);
+	Writer.EndRow();
 	++FrameNumber_;
-}
\ No newline at end of file
+}
+
+size_t DMSSimGroundTruthRecorder::ComputeOccupants(const double Time, const DMSSimGroundTruthFrame& Frame) {
+	const auto Transform = DMSSimGroundTruthTransform::Create(Frame.GetScenario().CoordinateSpace, Frame.Data.CarRotation_inWorld, Frame.Data.CarPosition_inWorld);
+	thread_local DMSSimFrameComputed FrameComputed;
+	size_t Count = 0;
+	for (const auto& Occupant : GTOccupantInfos) {
+		const auto& Data = Frame.Data.Occupants[static_cast<uint8>(Occupant.Occupant)];
+		ComputeGroundTruthData(Time, Transform, Frame, Data, FrameComputed);
+		Count += Data.Initialized ? 1 : 0;
+	}
+	return Count;
+}
@@ -1,9 +1,18 @@
 #pragma once
 
 #include "DMSSimConfig.h"
+#include "DMSSimGroundTruthFormat.h"
 #include <ostream>
+#include <vector>
+
+class DMSSimGroundTruthColumnarWriter;
 
 namespace DMSSimGroundTruthRecorder{
+	/**
+	 * Columns of the ground truth in the order of the CSV header, with their type in the binary columnar format.
+	 */
+	const std::vector<DMSSimGroundTruthFormat::ColumnInfo>& GetColumns();
+
 	/**
 	 * Adds header to the ground truth CSV file.
 	 */
@@ -13,4 +22,20 @@ namespace DMSSimGroundTruthRecorder{
 	 * Adds a data row to the ground truth CSV file.
 	 */
 	void AddFrame(std::ostream& Stream, double Time, const DMSSimGroundTruthFrame& Frame);
-} // namespace DMSSimGroundTruthRecorder
\ No newline at end of file
+
+	/**
+	 * Writes the schema of the binary columnar ground truth file.
+	 */
+	void AddHeader(DMSSimGroundTruthColumnarWriter& Writer);
+
+	/**
+	 * Adds a row to the binary columnar ground truth file, with the same values as the CSV row.
+	 */
+	void AddFrame(DMSSimGroundTruthColumnarWriter& Writer, double Time, const DMSSimGroundTruthFrame& Frame);
+
+	/**
+	 * Computes the values of the occupants of a row without writing them, the part of AddFrame the recorder benchmark measures.
+	 * @return the number of initialized occupants
+	 */
+	size_t ComputeOccupants(double Time, const DMSSimGroundTruthFrame& Frame);
+} // namespace DMSSimGroundTruthRecorder
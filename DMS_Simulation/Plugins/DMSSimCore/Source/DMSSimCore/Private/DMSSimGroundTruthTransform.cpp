@@ -0,0 +1,69 @@
+#include "DMSSimGroundTruthTransform.h"
+#include "DMSSimConstants.h"
+
+namespace {
+
+/** UnrotateVector of the rotator as a matrix in double, row i gives the component i of the unrotated vector. */
+void GetUnrotation(const FRotator& Rotation, double (&Unrotation)[3][3]) {
+	const FRotationMatrix Rotated(Rotation);
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) { Unrotation[i][j] = Rotated.M[i][j]; }
+	}
+}
+
+} // anonymous namespace
+
+DMSSimGroundTruthTransform DMSSimGroundTruthTransform::Create(const DMSSimCoordinateSpace& CoordinateSpace, const FRotator& CarRotation_inWorld, const FVector& CarPosition_inWorld) {
+	double CarUnrotation[3][3];
+	double SpaceUnrotation[3][3];
+	GetUnrotation(CarRotation_inWorld, CarUnrotation);
+	GetUnrotation(CoordinateSpace.GetRotation(), SpaceUnrotation);
+	const FVector Scale = CoordinateSpace.GetScale();
+	const double InvScale[3] = { 1.0 / (DMSSIM_M_TO_CM * double(Scale.X)), 1.0 / (DMSSIM_M_TO_CM * double(Scale.Y)), 1.0 / (DMSSIM_M_TO_CM * double(Scale.Z)) };
+
+	DMSSimGroundTruthTransform Transform;
+	Transform.Origin = CarPosition_inWorld;
+	Transform.Translation = CoordinateSpace.GetTranslation();
+	for (int i = 0; i < 3; ++i) {
+		for (int j = 0; j < 3; ++j) {
+			double Value = 0.0;
+			for (int k = 0; k < 3; ++k) { Value += SpaceUnrotation[i][k] * InvScale[k] * CarUnrotation[k][j]; }
+			Transform.Matrix[i][j] = float(Value);
+		}
+	}
+	return Transform;
+}
+
+FVector DMSSimGroundTruthTransform::TransformPoint(const FVector& Point) const {
+	const FVector Local = Point - Origin;
+	return FVector(
+		Matrix[0][0] * Local.X + Matrix[0][1] * Local.Y + Matrix[0][2] * Local.Z - Translation.X,
+		Matrix[1][0] * Local.X + Matrix[1][1] * Local.Y + Matrix[1][2] * Local.Z - Translation.Y,
+		Matrix[2][0] * Local.X + Matrix[2][1] * Local.Y + Matrix[2][2] * Local.Z - Translation.Z);
+}
+
+FVector DMSSimGroundTruthTransform::TransformDirection(const FVector& Vector) const {
+	FVector Direction(
+		Matrix[0][0] * Vector.X + Matrix[0][1] * Vector.Y + Matrix[0][2] * Vector.Z,
+		Matrix[1][0] * Vector.X + Matrix[1][1] * Vector.Y + Matrix[1][2] * Vector.Z,
+		Matrix[2][0] * Vector.X + Matrix[2][1] * Vector.Y + Matrix[2][2] * Vector.Z);
+	Direction.Normalize();
+	return Direction;
+}
+
+void DMSSimGroundTruthTransform::TransformPoints(const float* __restrict X, const float* __restrict Y, const float* __restrict Z, const int32 Count,
+	float* __restrict OutX, float* __restrict OutY, float* __restrict OutZ) const {
+	const float M00 = Matrix[0][0], M01 = Matrix[0][1], M02 = Matrix[0][2];
+	const float M10 = Matrix[1][0], M11 = Matrix[1][1], M12 = Matrix[1][2];
+	const float M20 = Matrix[2][0], M21 = Matrix[2][1], M22 = Matrix[2][2];
+	const float Ox = Origin.X, Oy = Origin.Y, Oz = Origin.Z;
+	const float Tx = Translation.X, Ty = Translation.Y, Tz = Translation.Z;
+	for (int32 i = 0; i < Count; ++i) {
+		const float Lx = X[i] - Ox;
+		const float Ly = Y[i] - Oy;
+		const float Lz = Z[i] - Oz;
+		OutX[i] = M00 * Lx + M01 * Ly + M02 * Lz - Tx;
+		OutY[i] = M10 * Lx + M11 * Ly + M12 * Lz - Ty;
+		OutZ[i] = M20 * Lx + M21 * Ly + M22 * Lz - Tz;
+	}
+}
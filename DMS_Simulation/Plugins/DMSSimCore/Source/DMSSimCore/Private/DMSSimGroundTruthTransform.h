@@ -0,0 +1,27 @@
+#pragma once
+
+#include "DMSSimConfig.h"
+
+/**
+ * @struct DMSSimGroundTruthTransform
+ * @brief Conversion of the world points of a ground truth frame into the base coordinate space of the car model, in meters.
+ * The steps of the conversion, the inverse rotation of the car, cm to m, the scale and the inverse rotation of the coordinate space,
+ * are combined into one matrix when the transform is created, once per frame. The origin of the car is subtracted before the matrix,
+ * so the points far away from the world origin keep their precision.
+ */
+struct DMSSimGroundTruthTransform
+{
+	FVector Origin;      // of the car in the world, cm
+	float   Matrix[3][3]; // row i gives the component i of the converted point
+	FVector Translation; // of the coordinate space, subtracted after the matrix
+
+	static DMSSimGroundTruthTransform Create(const DMSSimCoordinateSpace& CoordinateSpace, const FRotator& CarRotation_inWorld, const FVector& CarPosition_inWorld);
+
+	FVector TransformPoint(const FVector& Point) const;
+
+	/** The direction of a world vector in the base coordinate space, normalized. */
+	FVector TransformDirection(const FVector& Vector) const;
+
+	/** TransformPoint of all points, in one pass over separate coordinate arrays, which the compiler vectorizes. The arrays must not overlap. */
+	void TransformPoints(const float* X, const float* Y, const float* Z, int32 Count, float* OutX, float* OutY, float* OutZ) const;
+};
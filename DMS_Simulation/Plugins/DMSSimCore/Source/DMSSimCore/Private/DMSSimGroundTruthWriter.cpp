@@ -0,0 +1,65 @@
+#include "DMSSimGroundTruthWriter.h"
+#include "DMSSimGroundTruthRecorder.h"
+#include "DMSSimLog.h"
+
+DMSSimGroundTruthWriter::DMSSimGroundTruthWriter(std::ostream& Stream, const size_t QueueCapacity, const DMSSimGroundTruthFormat::FileFormat Format) :
+	Stream_(Stream),
+	RowQueue_(QueueCapacity)
+{
+	if (Format == DMSSimGroundTruthFormat::FileFormat::Columnar) { ColumnarWriter_ = MakeUnique<DMSSimGroundTruthColumnarWriter>(Stream_); }
+	Thread_ = FRunnableThread::Create(this, TEXT("DMS Sim Ground Truth Writer Thread"));
+	// the recorder's frame counter is per thread, so the header is written by the thread that writes the rows
+	if (!Thread_) { WriteHeader(); }
+}
+
+DMSSimGroundTruthWriter::~DMSSimGroundTruthWriter() { Finalize(); }
+
+uint32 DMSSimGroundTruthWriter::Run() {
+	WriteHeader();
+	RowEntry Entry;
+	size_t RowCount = 0;
+	while (RowQueue_.Pop(Entry)) {
+		if (Entry.Frame) {
+			WriteRow(Entry.Time, *Entry.Frame);
+			++RowCount;
+		}
+	}
+	if (ColumnarWriter_) { ColumnarWriter_->Flush(); }
+	Stream_.flush();
+	DMSSimLog::Info() << "DMSSimGroundTruthWriter  -- " << "Rows: " << RowCount
+		<< ", game thread blocked: " << GetProducerBlockedTime() << " s"
+		<< ", writer blocked: " << RowQueue_.GetPopBlockedTime() << " s" << FL;
+	return 0;
+}
+
+bool DMSSimGroundTruthWriter::AddFrame(const double Time, FramePtr Frame) {
+	if (Finalized_ || !Frame) { return false; }
+	if (!Thread_) {
+		WriteRow(Time, *Frame);
+		return true;
+	}
+	return RowQueue_.Push(RowEntry{ Time, MoveTemp(Frame) });
+}
+
+void DMSSimGroundTruthWriter::Finalize() {
+	if (Finalized_) { return; }
+	Finalized_ = true;
+	RowQueue_.Close();
+	if (Thread_) {
+		Thread_->WaitForCompletion();
+		delete Thread_;
+		Thread_ = nullptr;
+	}
+	if (ColumnarWriter_) { ColumnarWriter_->Flush(); }
+	Stream_.flush();
+}
+
+void DMSSimGroundTruthWriter::WriteHeader() {
+	if (ColumnarWriter_) { DMSSimGroundTruthRecorder::AddHeader(*ColumnarWriter_); }
+	else { DMSSimGroundTruthRecorder::AddHeader(Stream_); }
+}
+
+void DMSSimGroundTruthWriter::WriteRow(const double Time, const DMSSimGroundTruthFrame& Frame) {
+	if (ColumnarWriter_) { DMSSimGroundTruthRecorder::AddFrame(*ColumnarWriter_, Time, Frame); }
+	else { DMSSimGroundTruthRecorder::AddFrame(Stream_, Time, Frame); }
+}
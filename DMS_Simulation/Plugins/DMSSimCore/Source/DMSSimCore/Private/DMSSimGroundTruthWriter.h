@@ -0,0 +1,71 @@
+#pragma once
+
+#include <ostream>
+#include "DMSSimBoundedQueue.h"
+#include "DMSSimConfig.h"
+#include "DMSSimGroundTruthColumnarWriter.h"
+#include "DMSSimGroundTruthFormat.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+
+/**
+ * @class DMSSimGroundTruthWriter
+ * @brief Writes the ground truth file on its own thread, so the game thread neither computes nor formats the rows.
+ * The game thread passes immutable ground truth snapshots with AddFrame, the writer thread writes the header
+ * and then one row per snapshot, in the order they were added. The output is identical to calling
+ * DMSSimGroundTruthRecorder::AddHeader and DMSSimGroundTruthRecorder::AddFrame directly, on the stream for the CSV
+ * or on a DMSSimGroundTruthColumnarWriter for the binary columnar format.
+ * AddFrame blocks while the queue is full. If no thread can be created, the rows are written by the caller.
+ */
+class DMSSimGroundTruthWriter : public FRunnable
+{
+public:
+	using FramePtr = TSharedPtr<const DMSSimGroundTruthFrame, ESPMode::ThreadSafe>;
+
+	/**
+	 * Starts the writer thread, which writes the header first.
+	 * The stream must stay open until Finalize returns, it must be opened in binary mode for the columnar format.
+	 */
+	explicit DMSSimGroundTruthWriter(std::ostream& Stream, size_t QueueCapacity = DEFAULT_GROUND_TRUTH_QUEUE_CAPACITY,
+		DMSSimGroundTruthFormat::FileFormat Format = DMSSimGroundTruthFormat::FileFormat::Csv);
+	DMSSimGroundTruthWriter(const DMSSimGroundTruthWriter&) = delete;
+	DMSSimGroundTruthWriter& operator=(const DMSSimGroundTruthWriter&) = delete;
+	virtual ~DMSSimGroundTruthWriter();
+
+	uint32 Run() override;
+	void Stop() override { RowQueue_.Close(); }
+
+	/**
+	 * Queues a row for the ground truth snapshot.
+	 *
+	 * @param[in] Time  Time of the frame since the start of the recording, in seconds
+	 * @param[in] Frame Snapshot of the ground truth, it must not be modified afterwards
+	 *
+	 * @return false, if the writer was already finalized.
+	 */
+	bool AddFrame(double Time, FramePtr Frame);
+
+	/**
+	 * Writes the rows still in the queue, flushes the stream and stops the writer thread.
+	 * No rows can be added afterwards. Called on destruction, if it wasn't called explicitly.
+	 */
+	void Finalize();
+
+	/** Time in seconds the game thread spent waiting for a free slot in the queue. */
+	double GetProducerBlockedTime() const { return RowQueue_.GetPushBlockedTime(); }
+
+private:
+	void WriteHeader();
+	void WriteRow(double Time, const DMSSimGroundTruthFrame& Frame);
+
+	struct RowEntry {
+		double   Time;
+		FramePtr Frame;
+	};
+
+	std::ostream&                               Stream_;
+	TUniquePtr<DMSSimGroundTruthColumnarWriter> ColumnarWriter_;     // only for the columnar format
+	DMSSimBoundedQueue<RowEntry>                RowQueue_;
+	FRunnableThread*                            Thread_ = nullptr;
+	bool                                        Finalized_ = false;
+};
@@ -1,26 +1,30 @@
 #include "DMSSimImageLabeler.h"
 #include "DMSSimConstants.h"
+#include "DMSSimLandmarkProjection.h"
 #include "DMSSimLog.h"
 
+#include <array>
 #include <sstream>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <cmath>
+#include <cstring>
 
 #include <rapidjson/document.h>
 #include <rapidjson/prettywriter.h>
 #include <rapidjson/stringbuffer.h>
 
-using BoolAttributes = std::vector<std::pair<std::string, bool>>;
-using NumAttributes = std::vector<std::pair<std::string, float>>;
-using TextAttributes = std::vector<std::pair<std::string, std::string>>;
+using BoolAttributes = LabelAttributes<bool>;
+using NumAttributes = LabelAttributes<float>;
+using TextAttributes = LabelAttributes<std::string_view>;
 
-const auto SOURCE_SDT_ATTR = std::pair<std::string, std::string>{ "source", "sdt" };
-const auto STATE_LABELED_ATTR = std::pair<std::string, std::string>{ "state", "labeled" };
-const auto QUALITY_SDT_ATTR = std::pair<std::string, float>{"quality", SDT_QUALITY};
+constexpr auto SOURCE_SDT_ATTR = std::pair<std::string_view, std::string_view>{ "source", "sdt" };
+constexpr auto STATE_LABELED_ATTR = std::pair<std::string_view, std::string_view>{ "state", "labeled" };
+constexpr auto QUALITY_SDT_ATTR = std::pair<std::string_view, float>{"quality", SDT_QUALITY};
 
-const auto DEFAULT_ATTRS_TEXT = TextAttributes{ SOURCE_SDT_ATTR, STATE_LABELED_ATTR };
-const auto DEFAULT_ATTRS_NUM = NumAttributes{ QUALITY_SDT_ATTR};
+constexpr std::pair<std::string_view, std::string_view> DEFAULT_ATTRS_TEXT[] = { SOURCE_SDT_ATTR, STATE_LABELED_ATTR };
+constexpr std::pair<std::string_view, float> DEFAULT_ATTRS_NUM[] = { QUALITY_SDT_ATTR };
 
 
 struct OccupantBasicCharacterictics {
@@ -33,7 +37,7 @@ struct OccupantBasicCharacterictics {
 	std::string DeleteToken;
 };
 
-static std::map<FString, OccupantBasicCharacterictics> MetahumanCharacterictics = {
+static const std::map<FString, OccupantBasicCharacterictics> MetahumanCharacterictics = {
 	{"Gavin", {172, 72, 41, "adult", "male", "3_olive", "SYNTH00001"}},
 	{"Hana", {152, 46, 21, "adult", "female", "2_fair", "SYNTH00002"}},
 	{"Ada", {160, 54, 29, "adult", "female", "5_brown", "SYNTH00003"}},
@@ -55,6 +59,13 @@ static std::map<FString, OccupantBasicCharacterictics> MetahumanCharacterictics
 	{"Trey", {184, 84, 28, "adult", "male", "5_brown", "SYNTH00019"}}
 };
 
+// Doesn't insert unknown characters, the labelers of DMSSimLabelWriter read the table on several threads
+static const OccupantBasicCharacterictics& GetCharacterictics(const FString& Character) {
+	static const OccupantBasicCharacterictics Unknown = {};
+	const auto Found = MetahumanCharacterictics.find(Character);
+	return Found != MetahumanCharacterictics.end() ? Found->second : Unknown;
+}
+
 const std::map<int, std::string> EyeLandmarksNames{
 	{37, "right_eye_corner_out_eyelid"},
 	{38, "right_eye_up_out_eyelid"},
@@ -70,13 +81,13 @@ const std::map<int, std::string> EyeLandmarksNames{
 	{48, "left_eye_down_in_eyelid"},
 };
 
-static std::string GetEyeStatus(const float PupilVisibility, const float EyelidVisibility) {
+static std::string_view GetEyeStatus(const float PupilVisibility, const float EyelidVisibility) {
 	if (EyelidVisibility < UNKNOWN_STATE_VISIBILITY_THRESHOLD) { return "unknown"; }
 	if (PupilVisibility > 0.0) { return "open"; }
 	return "closed";
 }
 
-static std::string GetSeatPositionString(FDMSSimOccupantType Type) {
+static std::string_view GetSeatPositionString(FDMSSimOccupantType Type) {
 	switch (Type) {
 	case FDMSSimOccupantType::Driver:
 		return "driver";
@@ -93,7 +104,7 @@ static std::string GetSeatPositionString(FDMSSimOccupantType Type) {
 	}
 }
 
-static std::string GetGlasses(const int type) {
+static std::string_view GetGlasses(const int type) {
 	switch (type) {
 	case 7:
 	case 8:
@@ -121,7 +132,7 @@ static std::string GetGlasses(const int type) {
 	}
 }
 
-static std::string GetHeadGear(const int type) {
+static std::string_view GetHeadGear(const int type) {
 	switch (type) {
 	case 1:
 	case 5:
@@ -138,7 +149,7 @@ static std::string GetHeadGear(const int type) {
 	}
 }
 
-static std::string GetFaceMask(const int type) {
+static std::string_view GetFaceMask(const int type) {
 	switch (type) {
 	case 1:
 	case 2:
@@ -154,6 +165,19 @@ static std::string GetFaceMask(const int type) {
 	}
 }
 
+// Label names of the pupil landmarks, empty for the landmarks without a label
+static std::array<std::string, MAX_PUPIL_IRIS_LANDMARKS> MakePupilLabelNames(const std::string_view Prefix) {
+	std::array<std::string, MAX_PUPIL_IRIS_LANDMARKS> Names;
+	for (int k = 0; k < MAX_PUPIL_IRIS_LANDMARKS; k++) {
+		const auto Name = LandmarkPupilIrisNames[k];
+		if (Name == "up" || Name == "down" || Name == "in" || Name == "out" || Name == "center") { Names[k] = std::string(Prefix).append(Name); }
+	}
+	return Names;
+}
+
+static const auto LeftPupilLabelNames = MakePupilLabelNames("left_pupil_");
+static const auto RightPupilLabelNames = MakePupilLabelNames("right_pupil_");
+
 static rapidjson::Value CreateJsonBBoxes(const DMSSimGroundTruthOccupant& PrevGtOccupant, const DMSSimGroundTruthOccupant& GtOccupant, rapidjson::Document::AllocatorType& allocator) {
 	rapidjson::Value BBox(rapidjson::kArrayType);
 	AddLabelWithCoordinatesAndAttributes(BBox, "face_bbox", PrevGtOccupant.FaceBoundingBox2D, "frame", allocator, BoolAttributes{ {"visible", GtOccupant.FaceBoundingBox2DVisible} }, DEFAULT_ATTRS_NUM, DEFAULT_ATTRS_TEXT);
@@ -173,15 +197,15 @@ static rapidjson::Value CreateJsonVec(const DMSSimGroundTruthOccupant& PrevGtOcc
 
 	for (int k = 0; k < PrevGtOccupant.LeftEyePupilLandmarks2D.Num(); k++) {
 		const bool visible = PrevGtOccupant.PupilIrisLandmarksVisible[k + 25];
-		if (LandmarkPupilIrisNames[k] == "up" || LandmarkPupilIrisNames[k] == "down" || LandmarkPupilIrisNames[k] == "in" || LandmarkPupilIrisNames[k] == "out" || LandmarkPupilIrisNames[k] == "center") {
-			AddLabelWithCoordinatesAndAttributes(Vec, "left_pupil_" + LandmarkPupilIrisNames[k], PrevGtOccupant.LeftEyePupilLandmarks2D[k], "frame", allocator, BoolAttributes{ {"visible", visible} }, DEFAULT_ATTRS_NUM, DEFAULT_ATTRS_TEXT);
+		if (!LeftPupilLabelNames[k].empty()) {
+			AddLabelWithCoordinatesAndAttributes(Vec, LeftPupilLabelNames[k], PrevGtOccupant.LeftEyePupilLandmarks2D[k], "frame", allocator, BoolAttributes{ {"visible", visible} }, DEFAULT_ATTRS_NUM, DEFAULT_ATTRS_TEXT);
 		}
 	}
 
 	for (int k = 0; k < PrevGtOccupant.RightEyePupilLandmarks2D.Num(); k++) {
 		const bool visible = PrevGtOccupant.PupilIrisLandmarksVisible[k + 8];
-		if (LandmarkPupilIrisNames[k] == "up" || LandmarkPupilIrisNames[k] == "down" || LandmarkPupilIrisNames[k] == "in" || LandmarkPupilIrisNames[k] == "out" || LandmarkPupilIrisNames[k] == "center") {
-			AddLabelWithCoordinatesAndAttributes(Vec, "right_pupil_" + LandmarkPupilIrisNames[k], PrevGtOccupant.RightEyePupilLandmarks2D[k], "frame", allocator, BoolAttributes{ {"visible", visible} }, DEFAULT_ATTRS_NUM, DEFAULT_ATTRS_TEXT);
+		if (!RightPupilLabelNames[k].empty()) {
+			AddLabelWithCoordinatesAndAttributes(Vec, RightPupilLabelNames[k], PrevGtOccupant.RightEyePupilLandmarks2D[k], "frame", allocator, BoolAttributes{ {"visible", visible} }, DEFAULT_ATTRS_NUM, DEFAULT_ATTRS_TEXT);
 		}
 	}
 
@@ -230,24 +254,29 @@ static rapidjson::Value CreateJsonVec(const DMSSimGroundTruthOccupant& PrevGtOcc
 	return Vec;
 }
 
+// The text labels of a frame that are the same for the whole scenario
+static void AddOccupantFrameText(rapidjson::Value& Text, const FDMSSimOccupant& Occupant, rapidjson::Document::AllocatorType& allocator) {
+	AddLabel(Text, "face_expression", std::string_view("neutral"), allocator);
+	AddLabel(Text, "face_occlusion", std::string_view("no_accessory"), allocator);
+	AddLabel(Text, "glasses", GetGlasses(Occupant.Glasses.Model), allocator);
+	AddLabel(Text, "headgear", GetHeadGear(Occupant.Headgear), allocator);
+	AddLabel(Text, "face_mask", GetFaceMask(Occupant.Mask), allocator);
+}
+
 static rapidjson::Value CreateDynamicOccupant(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, const int i, rapidjson::Document::AllocatorType& allocator) {
-	const uint8 Type =static_cast<uint8>(PrevGroundTruth->Common.Occupants[i].Type);
-	const auto& PrevGtOccupant = PrevGroundTruth->Occupants[Type];
-	const auto& GtOccupant = GroundTruth->Occupants[Type];
-	const auto& PrevFDMSSimOccupant = PrevGroundTruth->Common.Occupants[i];
+	const uint8 Type =static_cast<uint8>(PrevGroundTruth->GetScenario().Occupants[i].Type);
+	const auto& PrevGtOccupant = PrevGroundTruth->Data.Occupants[Type];
+	const auto& GtOccupant = GroundTruth->Data.Occupants[Type];
+	const auto& PrevFDMSSimOccupant = PrevGroundTruth->GetScenario().Occupants[i];
 
 	rapidjson::Value Occupant(rapidjson::kObjectType);
 	rapidjson::Value ObjectData(rapidjson::kObjectType);
 
 	// Text data
 	rapidjson::Value Text(rapidjson::kArrayType);
-	AddLabel(Text, "right_eye_status", std::string(GetEyeStatus(PrevGtOccupant.RightEyePupilVisibilityPerc, PrevGtOccupant.RightEyeLidVisibilityPerc)), allocator);
-	AddLabel(Text, "left_eye_status", std::string(GetEyeStatus(PrevGtOccupant.LeftEyePupilVisibilityPerc, PrevGtOccupant.LeftEyeLidVisibilityPerc)), allocator);
-	AddLabel(Text, "face_expression", std::string("neutral"), allocator);
-	AddLabel(Text, "face_occlusion", std::string("no_accessory"), allocator);
-	AddLabel(Text, "glasses", GetGlasses(PrevGroundTruth->Common.Occupants[i].Glasses.Model), allocator);
-	AddLabel(Text, "headgear", GetHeadGear(PrevGroundTruth->Common.Occupants[i].Headgear), allocator);
-	AddLabel(Text, "face_mask", GetFaceMask(PrevGroundTruth->Common.Occupants[i].Mask), allocator);
+	AddLabel(Text, "right_eye_status", GetEyeStatus(PrevGtOccupant.RightEyePupilVisibilityPerc, PrevGtOccupant.RightEyeLidVisibilityPerc), allocator);
+	AddLabel(Text, "left_eye_status", GetEyeStatus(PrevGtOccupant.LeftEyePupilVisibilityPerc, PrevGtOccupant.LeftEyeLidVisibilityPerc), allocator);
+	AddOccupantFrameText(Text, PrevFDMSSimOccupant, allocator);
 	ObjectData.AddMember("text", Text, allocator);
 
 	// Num data (opening, eye visibility, pupil visibility)
@@ -267,9 +296,8 @@ static rapidjson::Value CreateDynamicOccupant(const TSharedPtr<DMSSimGroundTruth
 	return Occupant;
 }
 
-static rapidjson::Value CreateFrames(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, rapidjson::Document::AllocatorType& allocator) {
-	const auto& Camera = PrevGroundTruth->Common.Camera;
-
+// The streams of the frame properties, they only depend on the camera of the scenario
+static rapidjson::Value CreateFrameStreams(const DMSCamera& Camera, rapidjson::Document::AllocatorType& allocator) {
 	//intrinsics custom
 	rapidjson::Value IntrinsicsCustom(rapidjson::kObjectType);
 	rapidjson::Value CamMatrix3x3(rapidjson::kArrayType);
@@ -281,11 +309,11 @@ static rapidjson::Value CreateFrames(const TSharedPtr<DMSSimGroundTruthFrame>& P
 	Row2.PushBack(0.0, allocator).PushBack(0.0, allocator).PushBack(0.0, allocator);
 	CamMatrix3x3.PushBack(Row0, allocator).PushBack(Row1, allocator).PushBack(Row2, allocator);
 	rapidjson::Value Distortion(rapidjson::kArrayType);
-	Distortion.PushBack(0.0, allocator).PushBack(0.0, allocator).PushBack(0.0, allocator).PushBack(0.0, allocator).PushBack(0.0, allocator);
+	for (const float Coefficient : Camera.Distortion) { Distortion.PushBack(Coefficient, allocator); }
 	IntrinsicsCustom.AddMember("camera_matrix", CamMatrix3x3, allocator);
 	IntrinsicsCustom.AddMember("distortion_coeffs", Distortion, allocator);
-	IntrinsicsCustom.AddMember("height_px", PrevGroundTruth->Common.Camera.FrameSize.Y, allocator);
-	IntrinsicsCustom.AddMember("width_px", PrevGroundTruth->Common.Camera.FrameSize.X, allocator);
+	IntrinsicsCustom.AddMember("height_px", Camera.FrameSize.Y, allocator);
+	IntrinsicsCustom.AddMember("width_px", Camera.FrameSize.X, allocator);
 
 	//sensor position rotation
 	rapidjson::Value Position(rapidjson::kArrayType);
@@ -315,15 +343,18 @@ static rapidjson::Value CreateFrames(const TSharedPtr<DMSSimGroundTruthFrame>& P
 	//streams
 	rapidjson::Value Streams(rapidjson::kObjectType);
 	Streams.AddMember("ifcd_sdt", IfcdSdt, allocator);
-	
+	return Streams;
+}
+
+static rapidjson::Value CreateFrame(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, const std::string_view Timestamp, rapidjson::Document::AllocatorType& allocator) {
 	//frame properties
 	rapidjson::Value FrameProperties(rapidjson::kObjectType);
-	FrameProperties.AddMember("timestamp", rapidjson::Value(TCHAR_TO_UTF8(*FDateTime::Now().ToString()), allocator), allocator);
-	FrameProperties.AddMember("streams", Streams, allocator);
+	FrameProperties.AddMember("timestamp", CreateLabelValue(Timestamp, allocator), allocator);
+	FrameProperties.AddMember("streams", CreateFrameStreams(PrevGroundTruth->GetScenario().Camera, allocator), allocator);
 
 	//objects
 	rapidjson::Value Objects(rapidjson::kObjectType);
-	for (int i = 0; i < PrevGroundTruth->Common.OccupantCount; i++) {
+	for (int i = 0; i < PrevGroundTruth->GetScenario().OccupantCount; i++) {
 		auto Occupant = CreateDynamicOccupant(PrevGroundTruth, GroundTruth, i, allocator);
 		Objects.AddMember(rapidjson::Value(std::to_string(i).c_str(), allocator), Occupant, allocator);
 	}
@@ -331,35 +362,34 @@ static rapidjson::Value CreateFrames(const TSharedPtr<DMSSimGroundTruthFrame>& P
 	rapidjson::Value Frame(rapidjson::kObjectType);
 	Frame.AddMember("frame_properties", FrameProperties, allocator);
 	Frame.AddMember("objects", Objects, allocator);
-
-	rapidjson::Value Frames(rapidjson::kObjectType);
-	Frames.AddMember("0", Frame, allocator);
-	return Frames;
+	return Frame;
 }
 
 static rapidjson::Value CreateStaticOccupant(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const int i, rapidjson::Document::AllocatorType& allocator) {
-	const auto Character = PrevGroundTruth->Common.Occupants[i].Character;
+	const auto Character = PrevGroundTruth->GetScenario().Occupants[i].Character;
 
 	rapidjson::Value Occupant(rapidjson::kObjectType);
 	Occupant.AddMember("name", rapidjson::Value(TCHAR_TO_UTF8(*Character), allocator), allocator);
 	Occupant.AddMember("type", "metahuman", allocator);
 
+	const auto& Characterictics = GetCharacterictics(Character);
+
 	rapidjson::Value TextData(rapidjson::kArrayType);
-	AddLabel(TextData, "age_category", MetahumanCharacterictics[Character].AgeCategory, allocator);
-	AddLabel(TextData, "contact_lenses", std::string("no_contact_lenses"), allocator);
-	AddLabel(TextData, "delete_token", MetahumanCharacterictics[Character].DeleteToken, allocator);
-	AddLabel(TextData, "gender", MetahumanCharacterictics[Character].Gender, allocator);
-	AddLabel(TextData, "seat_position", GetSeatPositionString(PrevGroundTruth->Common.Occupants[i].Type), allocator);
-	AddLabel(TextData, "skin_tone", MetahumanCharacterictics[Character].SkinTone, allocator);
-	AddLabel(TextData, "eye_makeup", std::string("no_makeup_or_light"), allocator);
-	AddLabel(TextData, "facial_accessories", std::string("no_accessories"), allocator);
-	AddLabel(TextData, "facial_hair", std::string("no_facial_hair"), allocator);
+	AddLabel(TextData, "age_category", Characterictics.AgeCategory, allocator);
+	AddLabel(TextData, "contact_lenses", std::string_view("no_contact_lenses"), allocator);
+	AddLabel(TextData, "delete_token", Characterictics.DeleteToken, allocator);
+	AddLabel(TextData, "gender", Characterictics.Gender, allocator);
+	AddLabel(TextData, "seat_position", GetSeatPositionString(PrevGroundTruth->GetScenario().Occupants[i].Type), allocator);
+	AddLabel(TextData, "skin_tone", Characterictics.SkinTone, allocator);
+	AddLabel(TextData, "eye_makeup", std::string_view("no_makeup_or_light"), allocator);
+	AddLabel(TextData, "facial_accessories", std::string_view("no_accessories"), allocator);
+	AddLabel(TextData, "facial_hair", std::string_view("no_facial_hair"), allocator);
 
 	rapidjson::Value NumData(rapidjson::kArrayType);
-	AddLabel(NumData, "age", MetahumanCharacterictics[Character].Age, allocator);
-	AddLabel(NumData, "height", MetahumanCharacterictics[Character].Height, allocator);
-	AddLabel(NumData, "weight", MetahumanCharacterictics[Character].Weight, allocator);
-	AddLabel(NumData, "eye_opening", (MaxLeftEyeOpenings[Character] + MaxRightEyeOpenings[Character]) * 0.5 * DMSSIM_CM_TO_MM, allocator);
+	AddLabel(NumData, "age", Characterictics.Age, allocator);
+	AddLabel(NumData, "height", Characterictics.Height, allocator);
+	AddLabel(NumData, "weight", Characterictics.Weight, allocator);
+	AddLabel(NumData, "eye_opening", (GetMaxEyeOpening(MaxLeftEyeOpenings, Character) + GetMaxEyeOpening(MaxRightEyeOpenings, Character)) * 0.5 * DMSSIM_CM_TO_MM, allocator);
 
 	rapidjson::Value ObjectData(rapidjson::kObjectType);
 	ObjectData.AddMember("text", TextData, allocator);
@@ -370,14 +400,15 @@ static rapidjson::Value CreateStaticOccupant(const TSharedPtr<DMSSimGroundTruthF
 }
 
 static rapidjson::Value CreateStreams(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, rapidjson::Document::AllocatorType& allocator) {
-	const auto& Camera = PrevGroundTruth->Common.Camera;
+	const auto& Camera = PrevGroundTruth->GetScenario().Camera;
 
 	//intrinsics custom
 	rapidjson::Value IntrinsicsCustom(rapidjson::kObjectType);
 	rapidjson::Value CamMatrix3x3(rapidjson::kArrayType);
-	float focal_len = DMSSimConfig::GetCamera().GetFrameWidth() * 0.5f / std::tan(FMath::DegreesToRadians(DMSSimConfig::GetCamera().GetFOV() * 0.5));
-	float cx = DMSSimConfig::GetCamera().GetFrameWidth() * 0.5f;
-	float cy = DMSSimConfig::GetCamera().GetFrameHeight() * 0.5f;
+	const auto Intrinsics = DMSSimCameraIntrinsics::FromCamera(DMSSimConfig::GetCamera());
+	const float focal_len = Intrinsics.FocalLength;
+	const float cx = Intrinsics.Cx;
+	const float cy = Intrinsics.Cy;
 	rapidjson::Value Row0(rapidjson::kArrayType);
 	rapidjson::Value Row1(rapidjson::kArrayType);
 	rapidjson::Value Row2(rapidjson::kArrayType);
@@ -386,11 +417,11 @@ static rapidjson::Value CreateStreams(const TSharedPtr<DMSSimGroundTruthFrame>&
 	Row2.PushBack(0.0, allocator).PushBack(0.0, allocator).PushBack(1.0, allocator);
 	CamMatrix3x3.PushBack(Row0, allocator).PushBack(Row1, allocator).PushBack(Row2, allocator);
 	rapidjson::Value Distortion(rapidjson::kArrayType);
-	Distortion.PushBack(0.0, allocator).PushBack(0.0, allocator).PushBack(0.0, allocator).PushBack(0.0, allocator).PushBack(0.0, allocator);
+	for (const float Coefficient : Camera.Distortion) { Distortion.PushBack(Coefficient, allocator); }
 	IntrinsicsCustom.AddMember("camera_matrix", CamMatrix3x3, allocator);
 	IntrinsicsCustom.AddMember("distortion_coeffs", Distortion, allocator);
-	IntrinsicsCustom.AddMember("height_px", PrevGroundTruth->Common.Camera.FrameSize.Y, allocator);
-	IntrinsicsCustom.AddMember("width_px", PrevGroundTruth->Common.Camera.FrameSize.X, allocator);
+	IntrinsicsCustom.AddMember("height_px", PrevGroundTruth->GetScenario().Camera.FrameSize.Y, allocator);
+	IntrinsicsCustom.AddMember("width_px", PrevGroundTruth->GetScenario().Camera.FrameSize.X, allocator);
 
 	//sensor position rotation
 	rapidjson::Value Position(rapidjson::kArrayType);
@@ -424,7 +455,7 @@ static rapidjson::Value CreateStreams(const TSharedPtr<DMSSimGroundTruthFrame>&
 static rapidjson::Value CreateObjects(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, rapidjson::Document::AllocatorType& allocator) {
 	rapidjson::Value Objects(rapidjson::kObjectType);
 
-	const auto OccupantCount = PrevGroundTruth->Common.OccupantCount;
+	const auto OccupantCount = PrevGroundTruth->GetScenario().OccupantCount;
 	for (int i = 0; i < OccupantCount; i++) {
 		auto Occupant = CreateStaticOccupant(PrevGroundTruth, i, allocator);
 		Objects.AddMember(rapidjson::Value(std::to_string(i).c_str(), allocator), Occupant, allocator);
@@ -433,7 +464,7 @@ static rapidjson::Value CreateObjects(const TSharedPtr<DMSSimGroundTruthFrame>&
 	return Objects;
 }
 
-static rapidjson::Value CreateCoordinateSystems(const DMSSimGroundTruthCommon& GT, rapidjson::Document::AllocatorType& allocator) {
+static rapidjson::Value CreateCoordinateSystems(const DMSSimGroundTruthScenarioConstants& GT, rapidjson::Document::AllocatorType& allocator) {
 	//vehicle coordinate sys
 	rapidjson::Value CoordSysVeh(rapidjson::kObjectType);
 	rapidjson::Value ChildrenVehCoord(rapidjson::kArrayType);
@@ -461,9 +492,10 @@ static rapidjson::Value CreateCoordinateSystems(const DMSSimGroundTruthCommon& G
 	//frame coordinate sys (x beeing optical axis of the camera)
 	rapidjson::Value CoordSysFrame(rapidjson::kObjectType);
 	rapidjson::Value Mat3x4Frame(rapidjson::kArrayType);
-	float focal_len = DMSSimConfig::GetCamera().GetFrameWidth() * 0.5f / std::tan(FMath::DegreesToRadians(DMSSimConfig::GetCamera().GetFOV() * 0.5));
-	float cx = DMSSimConfig::GetCamera().GetFrameWidth() * 0.5f;
-	float cy = DMSSimConfig::GetCamera().GetFrameHeight() * 0.5f;
+	const auto Intrinsics = DMSSimCameraIntrinsics::FromCamera(DMSSimConfig::GetCamera());
+	const float focal_len = Intrinsics.FocalLength;
+	const float cx = Intrinsics.Cx;
+	const float cy = Intrinsics.Cy;
 	Mat3x4Frame.PushBack(cx, allocator).PushBack(-focal_len, allocator).PushBack(0.0, allocator).PushBack(0.0, allocator);
 	Mat3x4Frame.PushBack(cy, allocator).PushBack(0.0, allocator).PushBack(-focal_len, allocator).PushBack(0.0, allocator);
 	Mat3x4Frame.PushBack(1.0, allocator).PushBack(0.0, allocator).PushBack(0.0, allocator).PushBack(0.0, allocator);
@@ -481,7 +513,7 @@ static rapidjson::Value CreateCoordinateSystems(const DMSSimGroundTruthCommon& G
 	return CoordSys;
 }
 
-static rapidjson::Value CreateMetadata(const DMSSimGroundTruthCommon& GT, rapidjson::Document::AllocatorType& allocator) {
+static rapidjson::Value CreateMetadata(const DMSSimGroundTruthScenarioConstants& GT, rapidjson::Document::AllocatorType& allocator) {
 	rapidjson::Value Metadata;
 	Metadata.SetObject();
 
@@ -497,37 +529,341 @@ static rapidjson::Value CreateMetadata(const DMSSimGroundTruthCommon& GT, rapidj
 	return Metadata;
 }
 
-void DMSSimImageLabelerImpl::AddFrame(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, int FrameIdx) {
-	std::wstringstream ss;
-	ss << BaseFileName_ << L"_" << std::setw(5) << std::setfill(L'0') << FrameIdx << L".json";
+// Depth of the streams of the frame properties in a frame file: root, openlabel, frames, the frame and its properties
+constexpr int FRAME_FILE_STREAMS_DEPTH = 5;
+constexpr int PRETTY_INDENT = 4;
 
-	// Serialize JSON to string
-	rapidjson::StringBuffer buffer;
-	rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
-	CreateLabelFile(PrevGroundTruth, GroundTruth).Accept(writer);
-	std::ofstream JsonFile(ss.str());
-	if (JsonFile.is_open()) {
-		JsonFile << buffer.GetString();
-		JsonFile.close();
+static std::string SerializeCompact(const rapidjson::Value& Value) {
+	rapidjson::StringBuffer Json;
+	rapidjson::Writer<rapidjson::StringBuffer> Writer(Json);
+	Value.Accept(Writer);
+	return std::string(Json.GetString(), Json.GetSize());
+}
+
+// The pretty json of the value as the PrettyWriter writes it at Depth of a document. The strings of the json
+// have no line breaks, so the nesting only adds the indentation of the depth to every line after the first
+static std::string SerializePretty(const rapidjson::Value& Value, const int Depth) {
+	rapidjson::StringBuffer Json;
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> Writer(Json);
+	Value.Accept(Writer);
+	const std::string Indent(size_t(Depth) * PRETTY_INDENT, ' ');
+	std::string Result;
+	for (const char* c = Json.GetString(); *c; ++c) {
+		Result += *c;
+		if (*c == '\n') { Result += Indent; }
 	}
-	else { DMSSimLog::Info() << "fail at creating json file" << FL; }
-}
-
-rapidjson::Document DMSSimImageLabelerImpl::CreateLabelFile(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth) {
-	rapidjson::Document Root;
-	Root.SetObject();
-	rapidjson::Document::AllocatorType& allocator = Root.GetAllocator();
-	Root.AddMember("openlabel", rapidjson::Value(rapidjson::kObjectType), allocator);
-
-	rapidjson::Value Metadata = CreateMetadata(PrevGroundTruth->Common, allocator);
-	rapidjson::Value CoordinateSystems = CreateCoordinateSystems(PrevGroundTruth->Common, allocator);
-	rapidjson::Value Objects = CreateObjects(PrevGroundTruth, allocator);
-	rapidjson::Value Streams = CreateStreams(PrevGroundTruth, allocator);
-	rapidjson::Value Frames = CreateFrames(PrevGroundTruth, GroundTruth, allocator);
-	Root["openlabel"].AddMember("metadata", Metadata, allocator);
-	Root["openlabel"].AddMember("coordinate_systems", CoordinateSystems, allocator);
-	Root["openlabel"].AddMember("objects", Objects, allocator);
-	Root["openlabel"].AddMember("streams", Streams, allocator);
-	Root["openlabel"].AddMember("frames", Frames, allocator);
-	return Root;
-}
\ No newline at end of file
+	return Result;
+}
+
+const DMSSimImageLabelerImpl::ScenarioFragments& DMSSimImageLabelerImpl::GetScenarioFragments(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth) {
+	if (Fragments_.Built && Fragments_.Scenario == PrevGroundTruth->Scenario) { return Fragments_; }
+
+	// built outside of the label pool, it's reset after every frame
+	rapidjson::Document::AllocatorType allocator;
+	const auto& Scenario = PrevGroundTruth->GetScenario();
+	Fragments_.Scenario = PrevGroundTruth->Scenario;
+	Fragments_.Built = true;
+	Fragments_.ObjectKeys.clear();
+	for (int i = 0; i < Scenario.OccupantCount; i++) { Fragments_.ObjectKeys.push_back(std::to_string(i)); }
+	if (Streaming_) {
+		Fragments_.FrameStreams = SerializeCompact(CreateFrameStreams(Scenario.Camera, allocator));
+		return Fragments_;
+	}
+	Fragments_.FrameStreams = SerializePretty(CreateFrameStreams(Scenario.Camera, allocator), FRAME_FILE_STREAMS_DEPTH);
+
+	rapidjson::StringBuffer Prefix;
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> Writer(Prefix);
+	Writer.StartObject();
+	Writer.Key("openlabel");
+	Writer.StartObject();
+	Writer.Key("metadata");
+	CreateMetadata(Scenario, allocator).Accept(Writer);
+	Writer.Key("coordinate_systems");
+	CreateCoordinateSystems(Scenario, allocator).Accept(Writer);
+	Writer.Key("objects");
+	CreateObjects(PrevGroundTruth, allocator).Accept(Writer);
+	Writer.Key("streams");
+	CreateStreams(PrevGroundTruth, allocator).Accept(Writer);
+	Writer.Key("frames");
+	Writer.StartObject();
+	Writer.Key("0");
+	Fragments_.FilePrefix.assign(Prefix.GetString(), Prefix.GetSize());
+	return Fragments_;
+}
+
+template <typename TWriter>
+void DMSSimImageLabelerImpl::WriteFrame(TWriter& Writer, const ScenarioFragments& Fragments, const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth) {
+	const std::string_view Timestamp = GetTimestamp();
+	Writer.StartObject();
+	Writer.Key("frame_properties");
+	Writer.StartObject();
+	Writer.Key("timestamp");
+	Writer.String(Timestamp.data(), static_cast<rapidjson::SizeType>(Timestamp.size()));
+	Writer.Key("streams");
+	Writer.RawValue(Fragments.FrameStreams.data(), Fragments.FrameStreams.size(), rapidjson::kObjectType);
+	Writer.EndObject();
+	Writer.Key("objects");
+	Writer.StartObject();
+	for (int i = 0; i < PrevGroundTruth->GetScenario().OccupantCount; i++) {
+		Writer.Key(Fragments.ObjectKeys[i].data(), static_cast<rapidjson::SizeType>(Fragments.ObjectKeys[i].size()));
+		CreateDynamicOccupant(PrevGroundTruth, GroundTruth, i, GetLabelAllocator()).Accept(Writer);
+	}
+	Writer.EndObject();
+	Writer.EndObject();
+}
+
+void DMSSimImageLabelerImpl::CreateFrameJson(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, rapidjson::StringBuffer& Json) {
+	const ScenarioFragments& Fragments = GetScenarioFragments(PrevGroundTruth);
+	if (Streaming_) {
+		WriteFrame(StartCompact(Json), Fragments, PrevGroundTruth, GroundTruth);
+		return;
+	}
+
+	// the frame is written as the only frame of a document, whose start is replaced with the static sections
+	auto& Writer = StartPretty(Json);
+	const size_t Start = Json.GetSize();
+	Writer.StartObject();
+	Writer.Key("openlabel");
+	Writer.StartObject();
+	Writer.Key("frames");
+	Writer.StartObject();
+	Writer.Key("0");
+	Json.Pop(Json.GetSize() - Start);
+	std::memcpy(Json.Push(Fragments.FilePrefix.size()), Fragments.FilePrefix.data(), Fragments.FilePrefix.size());
+	WriteFrame(Writer, Fragments, PrevGroundTruth, GroundTruth);
+	Writer.EndObject(); // frames
+	Writer.EndObject(); // openlabel
+	Writer.EndObject();
+}
+
+void DMSSimImageLabelerImpl::WriteFrameJson(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const int FrameIdx, const char* const Json, const size_t Length) {
+	if (!Streaming_) {
+		WriteFrameFile(Json, Length, FrameIdx, L"");
+		return;
+	}
+	if (StreamFailed_ || (!StreamWriter_ && !OpenStream(PrevGroundTruth))) { return; }
+
+	const std::string Key = std::to_string(FrameIdx);
+	StreamWriter_->Key(Key.c_str(), static_cast<rapidjson::SizeType>(Key.size()), true);
+	StreamWriter_->RawValue(Json, Length, rapidjson::kObjectType);
+}
+
+static FILE* OpenStreamFile(const std::filesystem::path& FilePath) {
+#if defined(_WIN32)
+	FILE* const File = _wfopen(FilePath.c_str(), L"wb");
+#else
+	FILE* const File = fopen(FilePath.c_str(), "wb");
+#endif
+	if (!File) { DMSSimLog::Error() << "fail at creating label file " << FilePath.string() << FL; }
+	return File;
+}
+
+bool DMSSimImageLabelerImpl::OpenStream(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth) {
+	StreamFile_ = OpenStreamFile(std::filesystem::path(BaseFileName_ + L".json"));
+	if (!StreamFile_) {
+		StreamFailed_ = true;
+		return false;
+	}
+	// the stream buffers the labels itself, a second buffer of the file would only be allocated on the first flush
+	setvbuf(StreamFile_, nullptr, _IONBF, 0);
+	StreamBuffer_.resize(LABEL_STREAM_BUFFER_SIZE);
+	Stream_ = MakeUnique<rapidjson::FileWriteStream>(StreamFile_, StreamBuffer_.data(), StreamBuffer_.size());
+	StreamWriter_ = MakeUnique<StreamWriter>(*Stream_);
+
+	// the static sections, written once for the whole scenario. They are built outside of the label pool,
+	// the stream is opened by the committing labeler, which doesn't serialize frames in DMSSimLabelWriter
+	rapidjson::Document::AllocatorType allocator;
+	StreamWriter_->StartObject();
+	StreamWriter_->Key("openlabel");
+	StreamWriter_->StartObject();
+	StreamWriter_->Key("metadata");
+	CreateMetadata(PrevGroundTruth->GetScenario(), allocator).Accept(*StreamWriter_);
+	StreamWriter_->Key("coordinate_systems");
+	CreateCoordinateSystems(PrevGroundTruth->GetScenario(), allocator).Accept(*StreamWriter_);
+	StreamWriter_->Key("objects");
+	CreateObjects(PrevGroundTruth, allocator).Accept(*StreamWriter_);
+	StreamWriter_->Key("streams");
+	CreateStreams(PrevGroundTruth, allocator).Accept(*StreamWriter_);
+	StreamWriter_->Key("frames");
+	StreamWriter_->StartObject();
+	return true;
+}
+
+void DMSSimImageLabelerImpl::Finalize() {
+	if (!StreamFile_) { return; }
+	if (StreamWriter_) {
+		StreamWriter_->EndObject(); // frames
+		StreamWriter_->EndObject(); // openlabel
+		StreamWriter_->EndObject();
+		StreamWriter_.Reset();
+	}
+	if (Stream_) {
+		Stream_->Flush();
+		Stream_.Reset();
+	}
+	if (fclose(StreamFile_) != 0) { DMSSimLog::Error() << "fail at closing json file" << FL; }
+	StreamFile_ = nullptr;
+}
+
+void DMSSimImageLabelerCborImpl::CreateFrameJson(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, rapidjson::StringBuffer& Cbor) {
+	CborWriter_.WriteNamespace(CreateFrame(PrevGroundTruth, GroundTruth, GetTimestamp(), GetLabelAllocator()), Cbor);
+}
+
+void DMSSimImageLabelerCborImpl::WriteFrameJson(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const int FrameIdx, const char* const Cbor, const size_t Length) {
+	if (StreamFailed_ || (!StreamFile_ && !OpenStream(PrevGroundTruth))) { return; }
+
+	char Key[16];
+	const int KeyLength = std::snprintf(Key, sizeof(Key), "%d", FrameIdx);
+	FrameKey_.Clear();
+	DMSSimLabelCborWriter::WriteText(std::string_view(Key, static_cast<size_t>(KeyLength)), FrameKey_);
+	WriteStream(FrameKey_.GetString(), FrameKey_.GetSize());
+	WriteStream(Cbor, Length);
+}
+
+bool DMSSimImageLabelerCborImpl::OpenStream(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth) {
+	StreamFile_ = OpenStreamFile(std::filesystem::path(BaseFileName_ + L".cbor"));
+	if (!StreamFile_) {
+		StreamFailed_ = true;
+		return false;
+	}
+	StreamBuffer_.resize(LABEL_STREAM_BUFFER_SIZE);
+	setvbuf(StreamFile_, StreamBuffer_.data(), _IOFBF, StreamBuffer_.size());
+
+	// the same sections as the json stream, every one a namespace of its own
+	rapidjson::Document::AllocatorType allocator;
+	DMSSimLabelCborWriter SectionWriter;
+	rapidjson::StringBuffer Header;
+	DMSSimLabelCborWriter::WriteHead(DMSSimLabelFormat::MAJOR_TAG, DMSSimLabelFormat::TAG_SELF_DESCRIBED, Header);
+	DMSSimLabelCborWriter::StartIndefiniteMap(Header);
+	DMSSimLabelCborWriter::WriteText("openlabel", Header);
+	DMSSimLabelCborWriter::StartIndefiniteMap(Header);
+	DMSSimLabelCborWriter::WriteText("metadata", Header);
+	SectionWriter.WriteNamespace(CreateMetadata(PrevGroundTruth->GetScenario(), allocator), Header);
+	DMSSimLabelCborWriter::WriteText("coordinate_systems", Header);
+	SectionWriter.WriteNamespace(CreateCoordinateSystems(PrevGroundTruth->GetScenario(), allocator), Header);
+	DMSSimLabelCborWriter::WriteText("objects", Header);
+	SectionWriter.WriteNamespace(CreateObjects(PrevGroundTruth, allocator), Header);
+	DMSSimLabelCborWriter::WriteText("streams", Header);
+	SectionWriter.WriteNamespace(CreateStreams(PrevGroundTruth, allocator), Header);
+	DMSSimLabelCborWriter::WriteText("frames", Header);
+	DMSSimLabelCborWriter::StartIndefiniteMap(Header);
+	WriteStream(Header.GetString(), Header.GetSize());
+	return true;
+}
+
+void DMSSimImageLabelerCborImpl::WriteStream(const char* const Cbor, const size_t Length) {
+	if (fwrite(Cbor, 1, Length, StreamFile_) != Length && !StreamFailed_) {
+		DMSSimLog::Error() << "fail at writing label file" << FL;
+		StreamFailed_ = true;
+	}
+}
+
+void DMSSimImageLabelerCborImpl::Finalize() {
+	if (!StreamFile_) { return; }
+	const char End[] = { char(DMSSimLabelFormat::BREAK), char(DMSSimLabelFormat::BREAK), char(DMSSimLabelFormat::BREAK) }; // frames, openlabel, root
+	WriteStream(End, sizeof(End));
+	if (fclose(StreamFile_) != 0) { DMSSimLog::Error() << "fail at closing label file" << FL; }
+	StreamFile_ = nullptr;
+}
+
+void DMSSimImageLabelerDeltaImpl::CreateFrameJson(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, rapidjson::StringBuffer& Json) {
+	WriteCompact(CreateFrame(PrevGroundTruth, GroundTruth, GetTimestamp(), GetLabelAllocator()), Json);
+}
+
+void DMSSimImageLabelerDeltaImpl::WriteFrameJson(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const int FrameIdx, const char* const Json, const size_t Length) {
+	if (StreamFailed_) { return; }
+	if (!StreamWriter_) {
+		if (!OpenStream(PrevGroundTruth)) { return; }
+		FirstFrame_ = FrameIdx;
+	}
+
+	FrameAllocator_.Clear();
+	rapidjson::Document Frame(&FrameAllocator_);
+	Frame.Parse(Json, Length);
+	if (Frame.HasParseError()) {
+		DMSSimLog::Error() << "fail at reading the labels of frame " << FrameIdx << FL;
+		return;
+	}
+	Encoder_.EncodeFrame(Frame, FrameAllocator_);
+
+	const std::string Key = std::to_string(FrameIdx);
+	StreamWriter_->Key(Key.c_str(), static_cast<rapidjson::SizeType>(Key.size()), true);
+	Frame.Accept(*StreamWriter_);
+	LastFrame_ = FrameIdx;
+}
+
+bool DMSSimImageLabelerDeltaImpl::OpenStream(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth) {
+	StreamFile_ = OpenStreamFile(std::filesystem::path(BaseFileName_ + L"_delta.json"));
+	if (!StreamFile_) {
+		StreamFailed_ = true;
+		return false;
+	}
+	StreamBuffer_.resize(LABEL_STREAM_BUFFER_SIZE);
+	Stream_ = MakeUnique<rapidjson::FileWriteStream>(StreamFile_, StreamBuffer_.data(), StreamBuffer_.size());
+	StreamWriter_ = MakeUnique<StreamWriter>(*Stream_);
+
+	// the objects have the labels of the occupants that are the same in every frame, the frames only have them if they change
+	auto& ObjectsAllocator = Objects_.GetAllocator();
+	Objects_.SetObject();
+	for (int i = 0; i < PrevGroundTruth->GetScenario().OccupantCount; i++) {
+		rapidjson::Value Static = CreateStaticOccupant(PrevGroundTruth, i, ObjectsAllocator);
+		auto& ObjectData = Static["object_data"];
+		AddOccupantFrameText(ObjectData["text"], PrevGroundTruth->GetScenario().Occupants[i], ObjectsAllocator);
+		const std::string Key = std::to_string(i);
+		Encoder_.AddObjectLabels(Key, ObjectData);
+
+		rapidjson::Value Occupant(rapidjson::kObjectType);
+		Occupant.AddMember("name", Static["name"], ObjectsAllocator);
+		Occupant.AddMember("type", Static["type"], ObjectsAllocator);
+		Occupant.AddMember("frame_intervals", rapidjson::Value(rapidjson::kArrayType), ObjectsAllocator);
+		Occupant.AddMember("object_data", ObjectData, ObjectsAllocator);
+		Objects_.AddMember(rapidjson::Value(Key.c_str(), ObjectsAllocator), Occupant, ObjectsAllocator);
+	}
+
+	rapidjson::Document::AllocatorType allocator;
+	rapidjson::Value Metadata = CreateMetadata(PrevGroundTruth->GetScenario(), allocator);
+	Metadata.AddMember(rapidjson::StringRef(DMSSimLabelDelta::EPSILON_KEY), Epsilon_, allocator);
+	StreamWriter_->StartObject();
+	StreamWriter_->Key("openlabel");
+	StreamWriter_->StartObject();
+	StreamWriter_->Key("metadata");
+	Metadata.Accept(*StreamWriter_);
+	StreamWriter_->Key("coordinate_systems");
+	CreateCoordinateSystems(PrevGroundTruth->GetScenario(), allocator).Accept(*StreamWriter_);
+	StreamWriter_->Key("streams");
+	CreateStreams(PrevGroundTruth, allocator).Accept(*StreamWriter_);
+	StreamWriter_->Key("frames");
+	StreamWriter_->StartObject();
+	return true;
+}
+
+static rapidjson::Value CreateFrameIntervals(const int FirstFrame, const int LastFrame, rapidjson::Document::AllocatorType& allocator) {
+	rapidjson::Value Interval(rapidjson::kObjectType);
+	Interval.AddMember("frame_start", FirstFrame, allocator);
+	Interval.AddMember("frame_end", LastFrame, allocator);
+	rapidjson::Value Intervals(rapidjson::kArrayType);
+	Intervals.PushBack(Interval, allocator);
+	return Intervals;
+}
+
+void DMSSimImageLabelerDeltaImpl::Finalize() {
+	if (!StreamFile_) { return; }
+	if (StreamWriter_) {
+		StreamWriter_->EndObject(); // frames
+		auto& ObjectsAllocator = Objects_.GetAllocator();
+		StreamWriter_->Key("frame_intervals");
+		CreateFrameIntervals(FirstFrame_, LastFrame_, ObjectsAllocator).Accept(*StreamWriter_);
+		for (auto& Object : Objects_.GetObject()) { Object.value["frame_intervals"] = CreateFrameIntervals(FirstFrame_, LastFrame_, ObjectsAllocator); }
+		StreamWriter_->Key("objects");
+		Objects_.Accept(*StreamWriter_);
+		StreamWriter_->EndObject(); // openlabel
+		StreamWriter_->EndObject();
+		StreamWriter_.Reset();
+	}
+	if (Stream_) {
+		Stream_->Flush();
+		Stream_.Reset();
+	}
+	if (fclose(StreamFile_) != 0) { DMSSimLog::Error() << "fail at closing json file" << FL; }
+	StreamFile_ = nullptr;
+}
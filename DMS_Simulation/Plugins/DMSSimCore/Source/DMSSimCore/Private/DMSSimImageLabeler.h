@@ -1,19 +1,48 @@
 #pragma once
 #include "DMSSimConfig.h"
-
+#include "DMSSimLabelCborWriter.h"
+#include "DMSSimLabelDelta.h"
+#include "DMSSimLog.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iomanip>
 #include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <rapidjson/document.h>
+#include <rapidjson/filewritestream.h>
 #include <rapidjson/prettywriter.h>
 #include <rapidjson/stringbuffer.h>
-
+#include <rapidjson/writer.h>
+
+/**
+ * @class DMSSimImageLabeler
+ * @brief Base of the labelers. The json values of a frame are built in a memory pool of the labeler, which is reset
+ * after every frame. The pool starts with a buffer of LABEL_POOL_INITIAL_SIZE bytes and grows it when a frame didn't fit,
+ * so once the buffer is large enough, building the labels allocates no memory.
+ */
 template<typename Derived>
 class DMSSimImageLabeler {
 protected:
 	~DMSSimImageLabeler() = default;
 
 public:
+	using LabelAllocator = rapidjson::Document::AllocatorType;
+
+	struct Stats {
+		int64 Frames = 0;
+		int64 AllocatingFrames = 0; // frames whose labels didn't fit into the pool buffer
+	};
+
 	DMSSimImageLabeler(const std::wstring& FileName): BaseFileName_(FileName) {};
 
 	Derived& derived() { return static_cast<Derived&>(*this); }
@@ -21,21 +50,213 @@ public:
 
 	// NOTE: We are saving the json to the previous image frame. That's why we are using mainly PrevGroundTruth.
 	// ONLY The occlusion / visibility data is lagging one frame behind, which is why we are using the ground truth from the future (here "GroundTruth")
-	void AddFrame(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, int FrameIdx) {  derived().AddFrame(PrevGroundTruth, GroundTruth, FrameIdx); }
+	void AddFrame(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, int FrameIdx) {
+		FrameBuffer_.Clear();
+		SerializeFrame(PrevGroundTruth, GroundTruth, FrameBuffer_);
+		CommitFrame(PrevGroundTruth, FrameIdx, FrameBuffer_.GetString(), FrameBuffer_.GetSize());
+	}
+
+	/**
+	 * Appends the json of the frame's labels to Json. The frames are independent of each other,
+	 * so several labelers can serialize frames in parallel, as DMSSimLabelWriter does.
+	 */
+	void SerializeFrame(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, rapidjson::StringBuffer& Json) {
+		derived().CreateFrameJson(PrevGroundTruth, GroundTruth, Json);
+		ResetLabelAllocator();
+	}
+
+	/** Writes the serialized labels of a frame. The frames of a scenario are committed in order by one labeler. */
+	void CommitFrame(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, int FrameIdx, const char* Json, size_t Length) {
+		derived().WriteFrameJson(PrevGroundTruth, FrameIdx, Json, Length);
+	}
+
+	// Completes the label output after the last frame
+	void Finalize() { derived().Finalize(); }
+
+	const Stats& GetLabelPoolStats() const { return LabelPoolStats_; }
 
 protected:
+	LabelAllocator& GetLabelAllocator() { return LabelAllocator_; }
+
+	/** Releases the values of the frame. If they didn't fit into the buffer, the buffer is grown for the next frame. */
+	void ResetLabelAllocator() {
+		++LabelPoolStats_.Frames;
+		if (LabelAllocator_.Capacity() > LabelBufferCapacity_) {
+			++LabelPoolStats_.AllocatingFrames;
+			std::vector<char> Buffer(std::max(LabelBuffer_.size() * 2, LabelAllocator_.Size() * 3 / 2));
+			LabelAllocator_ = LabelAllocator(Buffer.data(), Buffer.size());
+			LabelBuffer_.swap(Buffer);
+			LabelBufferCapacity_ = LabelAllocator_.Capacity();
+		}
+		else { LabelAllocator_.Clear(); }
+	}
+
+	rapidjson::PrettyWriter<rapidjson::StringBuffer>& StartPretty(rapidjson::StringBuffer& Json) {
+		PrettyWriter_.Reset(Json);
+		return PrettyWriter_;
+	}
+
+	rapidjson::Writer<rapidjson::StringBuffer>& StartCompact(rapidjson::StringBuffer& Json) {
+		CompactWriter_.Reset(Json);
+		return CompactWriter_;
+	}
+
+	void WritePretty(const rapidjson::Value& Labels, rapidjson::StringBuffer& Json) { Labels.Accept(StartPretty(Json)); }
+
+	void WriteCompact(const rapidjson::Value& Labels, rapidjson::StringBuffer& Json) { Labels.Accept(StartCompact(Json)); }
+
+	/**
+	 * The timestamp of the frame, formatted like FDateTime::ToString. It has a resolution of a second, so it's only formatted again
+	 * when the second changed, into a fixed buffer, so it doesn't allocate either.
+	 */
+	std::string_view GetTimestamp() {
+		const FDateTime Now = FDateTime::Now();
+		const int64 Second = Now.GetTicks() / ETimespan::TicksPerSecond;
+		if (TimestampLength_ == 0 || Second != TimestampSecond_) {
+			TimestampSecond_ = Second;
+			const int Length = std::snprintf(Timestamp_, sizeof(Timestamp_), "%04d.%02d.%02d-%02d.%02d.%02d",
+				Now.GetYear(), Now.GetMonth(), Now.GetDay(), Now.GetHour(), Now.GetMinute(), Now.GetSecond());
+			TimestampLength_ = std::min(size_t(std::max(Length, 0)), sizeof(Timestamp_) - 1);
+		}
+		return std::string_view(Timestamp_, TimestampLength_);
+	}
+
+	/** Writes the json to <BaseFileName>_<FrameIdx><Suffix>.json. */
+	void WriteFrameFile(const char* const Json, const size_t Length, const int FrameIdx, const wchar_t* const Suffix) {
+		std::wstringstream ss;
+		ss << BaseFileName_ << L"_" << std::setw(5) << std::setfill(L'0') << FrameIdx << Suffix << L".json";
+		std::ofstream JsonFile(std::filesystem::path(ss.str()));
+		if (JsonFile.is_open()) {
+			JsonFile.write(Json, static_cast<std::streamsize>(Length));
+			JsonFile.close();
+		}
+		else { DMSSimLog::Info() << "fail at creating json file" << FL; }
+	}
+
 	const std::wstring&    BaseFileName_;
+
+private:
+	std::vector<char>                               LabelBuffer_ = std::vector<char>(LABEL_POOL_INITIAL_SIZE);
+	LabelAllocator                                  LabelAllocator_{ LabelBuffer_.data(), LabelBuffer_.size() };
+	size_t                                          LabelBufferCapacity_ = LabelAllocator_.Capacity();
+	Stats                                           LabelPoolStats_;
+	rapidjson::StringBuffer                         FrameBuffer_;
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> PrettyWriter_{ FrameBuffer_ };
+	rapidjson::Writer<rapidjson::StringBuffer>      CompactWriter_{ FrameBuffer_ };
+	char                                            Timestamp_[32] = {};
+	size_t                                          TimestampLength_ = 0;
+	int64                                           TimestampSecond_ = 0;
 };
 
+/**
+ * @class DMSSimImageLabelerImpl
+ * @brief Writes the OpenLABEL json of the frames.
+ * By default every frame goes to its own pretty printed file <BaseFileName>_<FrameIdx>.json with all sections.
+ * In the streaming mode there is one compact file <BaseFileName>.json per scenario: metadata, coordinate systems,
+ * objects and streams are written once with the first frame, the frames are appended under openlabel.frames
+ * keyed by their index, and Finalize closes the document.
+ * The labels that only depend on the scenario are serialized once with its first frame and spliced into every frame.
+ */
 class DMSSimImageLabelerImpl : public DMSSimImageLabeler<DMSSimImageLabelerImpl> {
 public:
-	DMSSimImageLabelerImpl(const std::wstring& FileName) : DMSSimImageLabeler<DMSSimImageLabelerImpl>(FileName) {};
-	~DMSSimImageLabelerImpl() {};
+	DMSSimImageLabelerImpl(const std::wstring& FileName, bool Streaming = false) : DMSSimImageLabeler<DMSSimImageLabelerImpl>(FileName), Streaming_(Streaming) {};
+	~DMSSimImageLabelerImpl() { Finalize(); };
 
-	void AddFrame(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, int FrameIdx);
+	void Finalize();
 
 private:
-	rapidjson::Document CreateLabelFile(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth);
+	friend class DMSSimImageLabeler<DMSSimImageLabelerImpl>;
+
+	void CreateFrameJson(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, rapidjson::StringBuffer& Json);
+	void WriteFrameJson(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, int FrameIdx, const char* Json, size_t Length);
+	bool OpenStream(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth);
+
+	/** The json of the labels that are the same in every frame of the scenario, in the format of the labeler's mode. */
+	struct ScenarioFragments {
+		DMSSimGroundTruthScenarioConstantsPtr Scenario;
+		bool                                  Built = false; // Scenario alone doesn't tell, a frame may have no scenario
+		std::string                           FilePrefix;   // a frame file up to the key of its frame, "0"
+		std::string                           FrameStreams; // the streams of the frame properties
+		std::vector<std::string>              ObjectKeys;   // the keys of the occupants
+	};
+
+	const ScenarioFragments& GetScenarioFragments(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth);
+
+	template <typename TWriter>
+	void WriteFrame(TWriter& Writer, const ScenarioFragments& Fragments, const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth);
+
+	using StreamWriter = rapidjson::Writer<rapidjson::FileWriteStream>;
+
+	const bool                                  Streaming_;
+	ScenarioFragments                           Fragments_;
+	bool                                        StreamFailed_ = false;
+	FILE*                                       StreamFile_ = nullptr;
+	std::vector<char>                           StreamBuffer_;
+	TUniquePtr<rapidjson::FileWriteStream>      Stream_;
+	TUniquePtr<StreamWriter>                    StreamWriter_;
+};
+
+/**
+ * @class DMSSimImageLabelerCborImpl
+ * @brief Writes the labels of DMSSimImageLabelerImpl in the streaming mode as CBOR into one file <BaseFileName>.cbor
+ * per scenario, see DMSSimLabelFormat.h. Tools/LabelCbor converts the file to the json of the streaming mode.
+ */
+class DMSSimImageLabelerCborImpl : public DMSSimImageLabeler<DMSSimImageLabelerCborImpl> {
+public:
+	DMSSimImageLabelerCborImpl(const std::wstring& FileName) : DMSSimImageLabeler<DMSSimImageLabelerCborImpl>(FileName) {};
+	~DMSSimImageLabelerCborImpl() { Finalize(); };
+
+	void Finalize();
+
+private:
+	friend class DMSSimImageLabeler<DMSSimImageLabelerCborImpl>;
+
+	void CreateFrameJson(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, rapidjson::StringBuffer& Cbor);
+	void WriteFrameJson(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, int FrameIdx, const char* Cbor, size_t Length);
+	bool OpenStream(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth);
+	void WriteStream(const char* Cbor, size_t Length);
+
+	DMSSimLabelCborWriter                       CborWriter_;
+	bool                                        StreamFailed_ = false;
+	FILE*                                       StreamFile_ = nullptr;
+	std::vector<char>                           StreamBuffer_;
+	rapidjson::StringBuffer                     FrameKey_;
+};
+
+/**
+ * @class DMSSimImageLabelerDeltaImpl
+ * @brief Writes the labels of DMSSimImageLabelerImpl in the streaming mode delta encoded into one file
+ * <BaseFileName>_delta.json per scenario, see DMSSimLabelDelta.h. The frames are serialized in full, in parallel in
+ * DMSSimLabelWriter, and reduced to their changes in order when committed. Tools/LabelDelta reconstructs the frames.
+ */
+class DMSSimImageLabelerDeltaImpl : public DMSSimImageLabeler<DMSSimImageLabelerDeltaImpl> {
+public:
+	DMSSimImageLabelerDeltaImpl(const std::wstring& FileName, float Epsilon = DMSSIM_DEFAULT_LABEL_DELTA_EPSILON) :
+		DMSSimImageLabeler<DMSSimImageLabelerDeltaImpl>(FileName), Epsilon_(Epsilon), Encoder_(Epsilon) {};
+	~DMSSimImageLabelerDeltaImpl() { Finalize(); };
+
+	void Finalize();
+
+private:
+	friend class DMSSimImageLabeler<DMSSimImageLabelerDeltaImpl>;
+
+	void CreateFrameJson(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, rapidjson::StringBuffer& Json);
+	void WriteFrameJson(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, int FrameIdx, const char* Json, size_t Length);
+	bool OpenStream(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth);
+
+	using StreamWriter = rapidjson::Writer<rapidjson::FileWriteStream>;
+
+	const float                                 Epsilon_;
+	DMSSimLabelDeltaEncoder                     Encoder_;
+	LabelAllocator                              FrameAllocator_{ LABEL_POOL_INITIAL_SIZE }; // the parsed frame, cleared after every frame
+	rapidjson::Document                         Objects_;                                   // the objects, written by Finalize
+	int                                         FirstFrame_ = 0;
+	int                                         LastFrame_ = 0;
+	bool                                        StreamFailed_ = false;
+	FILE*                                       StreamFile_ = nullptr;
+	std::vector<char>                           StreamBuffer_;
+	TUniquePtr<rapidjson::FileWriteStream>      Stream_;
+	TUniquePtr<StreamWriter>                    StreamWriter_;
 };
 
 class DMSSimImageLabelerOldImpl : public DMSSimImageLabeler<DMSSimImageLabelerOldImpl> {
@@ -43,13 +264,17 @@ public:
 	DMSSimImageLabelerOldImpl(const std::wstring& FileName) : DMSSimImageLabeler<DMSSimImageLabelerOldImpl>(FileName) {};
 	~DMSSimImageLabelerOldImpl() {};
 
-	void AddFrame(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, int FrameIdx);
+	void Finalize() {};
 
 private:
+	friend class DMSSimImageLabeler<DMSSimImageLabelerOldImpl>;
+
+	void CreateFrameJson(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, rapidjson::StringBuffer& Json);
+	void WriteFrameJson(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, int FrameIdx, const char* Json, size_t Length);
 	rapidjson::Document CreateLabelFileOld(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth);
 };
 
-const std::string     LandmarkPupilIrisNames[9] = {
+constexpr std::string_view LandmarkPupilIrisNames[MAX_PUPIL_IRIS_LANDMARKS] = {
 	"out",
 	"out up",
 	"up",
@@ -61,7 +286,7 @@ const std::string     LandmarkPupilIrisNames[9] = {
 	"center"
 };
 
-static std::map<FString, float> MaxLeftEyeOpenings = {
+static const std::map<FString, float> MaxLeftEyeOpenings = {
 	{"Gavin", 1.061462f},
 	{"Hana", 1.031548f},
 	{"Ada", 1.114868f},
@@ -83,7 +308,7 @@ static std::map<FString, float> MaxLeftEyeOpenings = {
 	{"Trey", 1.105499f}
 };
 
-static std::map<FString, float> MaxRightEyeOpenings = {
+static const std::map<FString, float> MaxRightEyeOpenings = {
 	{"Gavin", 1.058929f},
 	{"Hana", 1.035683f},
 	{"Ada", 1.099243f},
@@ -105,82 +330,86 @@ static std::map<FString, float> MaxRightEyeOpenings = {
 	{"Trey", 1.09491f}
 };
 
+// The value of the character in one of the tables, 0 for unknown characters. The tables are never modified, so the labelers can read them on several threads
+inline float GetMaxEyeOpening(const std::map<FString, float>& EyeOpenings, const FString& Character) {
+	const auto Found = EyeOpenings.find(Character);
+	return Found != EyeOpenings.end() ? Found->second : 0.0f;
+}
 
-template<typename T>
-inline rapidjson::Value CreateLabel(std::string LabelName, T LabelValue, rapidjson::Document::AllocatorType& allocator) {
-	rapidjson::Value NewLabel(rapidjson::kObjectType);
-	NewLabel.AddMember("name", rapidjson::Value(LabelName.c_str(), allocator).Move(), allocator);
-	NewLabel.AddMember("val", LabelValue, allocator);
-	return NewLabel;
+
+// Names of labels, attributes and coordinate systems are referenced, not copied, so they have to outlive the labels:
+// literals or entries of static tables. Values are copied into the allocator.
+template <typename T>
+using LabelAttributes = std::initializer_list<std::pair<std::string_view, T>>;
+
+inline rapidjson::Value::StringRefType LabelNameRef(const std::string_view Name) {
+	return rapidjson::StringRef(Name.data(), static_cast<rapidjson::SizeType>(Name.size()));
+}
+
+template<typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+inline rapidjson::Value CreateLabelValue(const T LabelValue, rapidjson::Document::AllocatorType&) {
+	return rapidjson::Value(LabelValue);
 };
 
-template<>
-inline rapidjson::Value CreateLabel<std::string>(std::string LabelName, std::string LabelValue, rapidjson::Document::AllocatorType& allocator) {
-	rapidjson::Value NewLabel(rapidjson::kObjectType);
-	NewLabel.AddMember("name", rapidjson::Value(LabelName.c_str(), allocator).Move(), allocator);
-	NewLabel.AddMember("val", rapidjson::Value(LabelValue.c_str(), allocator).Move(), allocator);
-	return NewLabel;
+inline rapidjson::Value CreateLabelValue(const std::string_view LabelValue, rapidjson::Document::AllocatorType& allocator) {
+	return rapidjson::Value(LabelValue.data(), static_cast<rapidjson::SizeType>(LabelValue.size()), allocator);
 };
 
-template<>
-inline rapidjson::Value CreateLabel<FVector>(std::string LabelName, FVector LabelValue, rapidjson::Document::AllocatorType& allocator) {
-	rapidjson::Value NewLabel(rapidjson::kObjectType);
-	NewLabel.AddMember("name", rapidjson::Value(LabelName.c_str(), allocator).Move(), allocator);
+inline rapidjson::Value CreateLabelValue(const FVector& LabelValue, rapidjson::Document::AllocatorType& allocator) {
 	rapidjson::Value ArrayValue(rapidjson::kArrayType);
+	ArrayValue.Reserve(3, allocator);
 	ArrayValue.PushBack(LabelValue.X, allocator);
 	ArrayValue.PushBack(LabelValue.Y, allocator);
 	ArrayValue.PushBack(LabelValue.Z, allocator);
-	NewLabel.AddMember("val", ArrayValue.Move(), allocator);
-	return NewLabel;
+	return ArrayValue;
 };
 
-template<>
-inline rapidjson::Value CreateLabel<FRotator>(std::string LabelName, FRotator LabelValue, rapidjson::Document::AllocatorType& allocator) {
+inline rapidjson::Value CreateLabelValue(const FRotator& LabelValue, rapidjson::Document::AllocatorType& allocator) {
 	// roll, pitch, yaw
-	rapidjson::Value NewLabel(rapidjson::kObjectType);
-	NewLabel.AddMember("name", rapidjson::Value(LabelName.c_str(), allocator).Move(), allocator);
 	rapidjson::Value ArrayValue(rapidjson::kArrayType);
+	ArrayValue.Reserve(3, allocator);
 	ArrayValue.PushBack(LabelValue.Roll, allocator);
 	ArrayValue.PushBack(LabelValue.Pitch, allocator);
 	ArrayValue.PushBack(LabelValue.Yaw, allocator);
-	NewLabel.AddMember("val", ArrayValue.Move(), allocator);
-	return NewLabel;
+	return ArrayValue;
 };
 
-template<>
-inline rapidjson::Value CreateLabel<FVector2D>(std::string LabelName, FVector2D LabelValue, rapidjson::Document::AllocatorType& allocator) {
-	rapidjson::Value NewLabel(rapidjson::kObjectType);
-	NewLabel.AddMember("name", rapidjson::Value(LabelName.c_str(), allocator).Move(), allocator);
+inline rapidjson::Value CreateLabelValue(const FVector2D& LabelValue, rapidjson::Document::AllocatorType& allocator) {
 	rapidjson::Value ArrayValue(rapidjson::kArrayType);
+	ArrayValue.Reserve(2, allocator);
 	ArrayValue.PushBack(static_cast<int>(LabelValue.X + 0.5), allocator);
 	ArrayValue.PushBack(static_cast<int>(LabelValue.Y + 0.5), allocator);
-	NewLabel.AddMember("val", ArrayValue, allocator);
-	return NewLabel;
+	return ArrayValue;
 };
 
-template<>
-inline rapidjson::Value CreateLabel<FDMSBoundingBox2D>(std::string LabelName, FDMSBoundingBox2D LabelValue, rapidjson::Document::AllocatorType& allocator) {
-	rapidjson::Value NewLabel(rapidjson::kObjectType);
-	NewLabel.AddMember("name", rapidjson::Value(LabelName.c_str(), allocator).Move(), allocator);
+inline rapidjson::Value CreateLabelValue(const FDMSBoundingBox2D& LabelValue, rapidjson::Document::AllocatorType& allocator) {
 	rapidjson::Value ArrayValue(rapidjson::kArrayType);
+	ArrayValue.Reserve(4, allocator);
 	ArrayValue.PushBack(static_cast<int>(LabelValue.Center.X + 0.5), allocator);
 	ArrayValue.PushBack(static_cast<int>(LabelValue.Center.Y + 0.5), allocator);
 	ArrayValue.PushBack(static_cast<int>(LabelValue.Width + 0.5), allocator);
 	ArrayValue.PushBack(static_cast<int>(LabelValue.Height + 0.5), allocator);
-	NewLabel.AddMember("val", ArrayValue, allocator);
+	return ArrayValue;
+};
+
+template<typename T>
+inline rapidjson::Value CreateLabel(const std::string_view LabelName, const T& LabelValue, rapidjson::Document::AllocatorType& allocator) {
+	rapidjson::Value NewLabel(rapidjson::kObjectType);
+	NewLabel.AddMember("name", rapidjson::Value(LabelNameRef(LabelName)), allocator);
+	NewLabel.AddMember("val", CreateLabelValue(LabelValue, allocator), allocator);
 	return NewLabel;
 };
 
 template<typename T>
-inline void AddLabel(rapidjson::Value& ParentArray, std::string LabelName, T LabelValue, rapidjson::Document::AllocatorType& allocator) {
-	rapidjson::Value NewLabel = CreateLabel(std::move(LabelName), std::move(LabelValue), allocator);
+inline void AddLabel(rapidjson::Value& ParentArray, const std::string_view LabelName, const T& LabelValue, rapidjson::Document::AllocatorType& allocator) {
+	rapidjson::Value NewLabel = CreateLabel(LabelName, LabelValue, allocator);
 	ParentArray.PushBack(NewLabel, allocator);
 };
 
 template<typename T>
-inline void AddLabelWithCoordinates(rapidjson::Value& ParentArray, std::string LabelName, T LabelValue, std::string CoordinateSystem, rapidjson::Document::AllocatorType& allocator) {
-	rapidjson::Value NewLabel = CreateLabel(std::move(LabelName), std::move(LabelValue), allocator);
-	NewLabel.AddMember("coordinate_system", rapidjson::Value(std::move(CoordinateSystem).c_str(), allocator), allocator);
+inline void AddLabelWithCoordinates(rapidjson::Value& ParentArray, const std::string_view LabelName, const T& LabelValue, const std::string_view CoordinateSystem, rapidjson::Document::AllocatorType& allocator) {
+	rapidjson::Value NewLabel = CreateLabel(LabelName, LabelValue, allocator);
+	NewLabel.AddMember("coordinate_system", rapidjson::Value(LabelNameRef(CoordinateSystem)), allocator);
 	ParentArray.PushBack(NewLabel, allocator);
 };
 
@@ -196,34 +425,32 @@ struct IsVectorOfNumbers<std::vector<T>> {
 
 // Function to get the type category of the second element in a pair
 template <typename T>
-std::string GetSecondElementType() {
+constexpr const char* GetSecondElementType() {
 	if (std::is_same<T, bool>::value) { return "boolean"; }
-	else if (std::is_integral<T>::value || std::is_floating_point<T>::value) { return "num"; }	
-	else if (std::is_same<T, std::string>::value) { return "text"; }
+	else if (std::is_integral<T>::value || std::is_floating_point<T>::value) { return "num"; }
+	else if (std::is_same<T, std::string_view>::value || std::is_same<T, std::string>::value) { return "text"; }
 	else if (IsVectorOfNumbers<T>::value || std::is_same<T, FVector>::value) { return "vec"; }
 	return "unknown";
 };
 
+// Attrs is a LabelAttributes list or an array of name / value pairs
 template<typename A>
-inline void AddAttributes(rapidjson::Value& Label, rapidjson::Document::AllocatorType& allocator, A Attrs) {
+inline void AddAttributes(rapidjson::Value& Label, rapidjson::Document::AllocatorType& allocator, const A& Attrs) {
 	rapidjson::Value ArrayOfAttrs(rapidjson::kArrayType);
-	for (auto& Attr : Attrs) { AddLabel(ArrayOfAttrs, Attr.first, Attr.second, allocator); }
-	std::string NameOfType = GetSecondElementType<typename decltype(Attrs.begin()->second)>();
-	Label.AddMember(rapidjson::Value(NameOfType.c_str(), allocator), ArrayOfAttrs, allocator);
+	for (const auto& Attr : Attrs) { AddLabel(ArrayOfAttrs, Attr.first, Attr.second, allocator); }
+	const char* const NameOfType = GetSecondElementType<std::decay_t<decltype(std::begin(Attrs)->second)>>();
+	Label.AddMember(rapidjson::StringRef(NameOfType), ArrayOfAttrs, allocator);
 };
 
 template<typename A, typename... As>
-inline void AddAttributes(rapidjson::Value& Label, rapidjson::Document::AllocatorType& allocator, A Attrs, As... OtherAttrs) {
-	rapidjson::Value ArrayOfAttrs(rapidjson::kArrayType);
-	for (auto& Attr : Attrs) { AddLabel(ArrayOfAttrs, Attr.first, Attr.second, allocator); }
-	auto NameOfType = GetSecondElementType<decltype(Attrs.begin()->second)>();
-	Label.AddMember(rapidjson::Value(NameOfType.c_str(), allocator), ArrayOfAttrs, allocator);
+inline void AddAttributes(rapidjson::Value& Label, rapidjson::Document::AllocatorType& allocator, const A& Attrs, const As&... OtherAttrs) {
+	AddAttributes(Label, allocator, Attrs);
 	AddAttributes(Label, allocator, OtherAttrs...);
 };
 
 template<typename T, typename... As>
-inline void AddLabelWithAttributes(rapidjson::Value& ParentArray, std::string LabelName, T LabelValue, rapidjson::Document::AllocatorType& allocator, As... Attrs) {
-	rapidjson::Value NewLabel = CreateLabel(std::move(LabelName), LabelValue, allocator);
+inline void AddLabelWithAttributes(rapidjson::Value& ParentArray, const std::string_view LabelName, const T& LabelValue, rapidjson::Document::AllocatorType& allocator, const As&... Attrs) {
+	rapidjson::Value NewLabel = CreateLabel(LabelName, LabelValue, allocator);
 	rapidjson::Value Attributes(rapidjson::kObjectType);
 	AddAttributes(Attributes, allocator, Attrs...);
 	NewLabel.AddMember("attributes", Attributes, allocator);
@@ -231,11 +458,11 @@ inline void AddLabelWithAttributes(rapidjson::Value& ParentArray, std::string La
 };
 
 template<typename T, typename... As>
-inline void AddLabelWithCoordinatesAndAttributes(rapidjson::Value& ParentArray, std::string LabelName, T LabelValue, std::string CoordinateSystem, rapidjson::Document::AllocatorType& allocator, As... Attrs) {
-	rapidjson::Value NewLabel = CreateLabel(std::move(LabelName), LabelValue, allocator);
+inline void AddLabelWithCoordinatesAndAttributes(rapidjson::Value& ParentArray, const std::string_view LabelName, const T& LabelValue, const std::string_view CoordinateSystem, rapidjson::Document::AllocatorType& allocator, const As&... Attrs) {
+	rapidjson::Value NewLabel = CreateLabel(LabelName, LabelValue, allocator);
 	rapidjson::Value Attributes(rapidjson::kObjectType);
 	AddAttributes(Attributes, allocator, Attrs...);
-	NewLabel.AddMember("coordinate_system", rapidjson::Value(std::move(CoordinateSystem).c_str(), allocator), allocator);
+	NewLabel.AddMember("coordinate_system", rapidjson::Value(LabelNameRef(CoordinateSystem)), allocator);
 	NewLabel.AddMember("attributes", Attributes, allocator);
 	ParentArray.PushBack(NewLabel, allocator);
-};
\ No newline at end of file
+};
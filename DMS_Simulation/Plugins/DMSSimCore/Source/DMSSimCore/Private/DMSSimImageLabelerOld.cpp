@@ -2,7 +2,9 @@
 #include "DMSSimConstants.h"
 #include "DMSSimLog.h"
 
+#include <array>
 #include <sstream>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 
@@ -13,7 +15,7 @@
 
 static bool IsEyeOpened(const float EyeOpening, const float MaxEyeOpening, const float EyesOpenThreshhold) { return EyeOpening / MaxEyeOpening > EyesOpenThreshhold; }
 
-static std::string GetSeatPositionString(uint8 Type) {
+static std::string_view GetSeatPositionString(uint8 Type) {
 	switch (Type) {
 	case 0:
 		return "driver";
@@ -30,9 +32,27 @@ static std::string GetSeatPositionString(uint8 Type) {
 	}
 }
 
-static rapidjson::Document CreateJsonMetadataOld(const DMSSimGroundTruthCommon& GT, rapidjson::Document::AllocatorType& allocator) {
-	rapidjson::Document Metadata;
-	Metadata.SetObject();
+// Landmark names, built once
+static std::array<std::string, MAX_FACIAL_LANDMARKS> MakeFacialLandmarkNames() {
+	std::array<std::string, MAX_FACIAL_LANDMARKS> Names;
+	for (int k = 0; k < MAX_FACIAL_LANDMARKS; k++) { Names[k] = "Landmark" + std::to_string(k); }
+	return Names;
+}
+
+static std::array<std::string, MAX_PUPIL_IRIS_LANDMARKS> MakePupilIrisNames(const std::string_view Prefix) {
+	std::array<std::string, MAX_PUPIL_IRIS_LANDMARKS> Names;
+	for (int k = 0; k < MAX_PUPIL_IRIS_LANDMARKS; k++) { Names[k] = std::string(Prefix).append(LandmarkPupilIrisNames[k]); }
+	return Names;
+}
+
+static const auto FacialLandmarkNames = MakeFacialLandmarkNames();
+static const auto LeftPupilNames = MakePupilIrisNames("left eye pupil ");
+static const auto LeftIrisNames = MakePupilIrisNames("left eye iris ");
+static const auto RightPupilNames = MakePupilIrisNames("right eye pupil ");
+static const auto RightIrisNames = MakePupilIrisNames("right eye iris ");
+
+static rapidjson::Value CreateJsonMetadataOld(const DMSSimGroundTruthScenarioConstants& GT, const DMSSimGroundTruthFrameData& FrameData, rapidjson::Document::AllocatorType& allocator) {
+	rapidjson::Value Metadata(rapidjson::kObjectType);
 
 	// Schema version
 	std::string schemaVersion = std::to_string(GT.VersionMajor) + "." + std::to_string(GT.VersionMinor);
@@ -138,17 +158,17 @@ static rapidjson::Document CreateJsonMetadataOld(const DMSSimGroundTruthCommon&
 
 	// Car Base
 	rapidjson::Value CarPosition_inWorld(rapidjson::kObjectType);
-	CarPosition_inWorld.AddMember("x", GT.CarPosition_inWorld.X, allocator);
-	CarPosition_inWorld.AddMember("y", GT.CarPosition_inWorld.Y, allocator);
-	CarPosition_inWorld.AddMember("z", GT.CarPosition_inWorld.Z, allocator);
+	CarPosition_inWorld.AddMember("x", FrameData.CarPosition_inWorld.X, allocator);
+	CarPosition_inWorld.AddMember("y", FrameData.CarPosition_inWorld.Y, allocator);
+	CarPosition_inWorld.AddMember("z", FrameData.CarPosition_inWorld.Z, allocator);
 
 	Metadata.AddMember("car_location", CarPosition_inWorld, allocator);
 
 	// Car Rotation
 	rapidjson::Value CarRotation_inWorld(rapidjson::kObjectType);
-	CarRotation_inWorld.AddMember("roll", GT.CarRotation_inWorld.Roll, allocator);
-	CarRotation_inWorld.AddMember("pitch", GT.CarRotation_inWorld.Pitch, allocator);
-	CarRotation_inWorld.AddMember("yaw", GT.CarRotation_inWorld.Yaw, allocator);
+	CarRotation_inWorld.AddMember("roll", FrameData.CarRotation_inWorld.Roll, allocator);
+	CarRotation_inWorld.AddMember("pitch", FrameData.CarRotation_inWorld.Pitch, allocator);
+	CarRotation_inWorld.AddMember("yaw", FrameData.CarRotation_inWorld.Yaw, allocator);
 
 	Metadata.AddMember("car_rotation", CarRotation_inWorld, allocator);
 
@@ -159,7 +179,7 @@ static rapidjson::Value CreateJsonTextForOccupantOld(const int Type, rapidjson::
 	rapidjson::Value Text(rapidjson::kArrayType);
 	rapidjson::Value SeatPosition(rapidjson::kObjectType);
 	SeatPosition.AddMember("name", rapidjson::Value("seat position", allocator), allocator);
-	SeatPosition.AddMember("val", rapidjson::Value(GetSeatPositionString(Type).c_str(), allocator), allocator);
+	SeatPosition.AddMember("val", CreateLabelValue(GetSeatPositionString(Type), allocator), allocator);
 	Text.PushBack(SeatPosition, allocator);
 	return Text;
 }
@@ -214,7 +234,7 @@ static rapidjson::Value CreateJsonBBoxesOld(const DMSSimGroundTruthOccupant& Pre
 
 	rapidjson::Value EyeLeftOpen(rapidjson::kObjectType);
 	EyeLeftOpen.AddMember("name", rapidjson::Value("open", allocator), allocator);
-	EyeLeftOpen.AddMember("val", IsEyeOpened(PrevGtOccupant.LeftEyeOpening, MaxLeftEyeOpenings[Character], EYE_OPENING_THRESHOLD), allocator);
+	EyeLeftOpen.AddMember("val", IsEyeOpened(PrevGtOccupant.LeftEyeOpening, GetMaxEyeOpening(MaxLeftEyeOpenings, Character), EYE_OPENING_THRESHOLD), allocator);
 
 	EyeLeftBooleanArray.PushBack(EyeLeftVisible, allocator).PushBack(EyeLeftOpen, allocator);
 
@@ -263,7 +283,7 @@ static rapidjson::Value CreateJsonBBoxesOld(const DMSSimGroundTruthOccupant& Pre
 
 	rapidjson::Value EyeRightOpen(rapidjson::kObjectType);
 	EyeRightOpen.AddMember("name", rapidjson::Value("open", allocator), allocator);
-	EyeRightOpen.AddMember("val", IsEyeOpened(PrevGtOccupant.RightEyeOpening, MaxRightEyeOpenings[Character], EYE_OPENING_THRESHOLD), allocator);
+	EyeRightOpen.AddMember("val", IsEyeOpened(PrevGtOccupant.RightEyeOpening, GetMaxEyeOpening(MaxRightEyeOpenings, Character), EYE_OPENING_THRESHOLD), allocator);
 
 	EyeRightBooleanArray.PushBack(EyeRightVisible, allocator).PushBack(EyeRightOpen, allocator);
 
@@ -299,7 +319,7 @@ static rapidjson::Value CreateJsonPoints2dOld(const DMSSimGroundTruthOccupant& P
 
 	for (int k = 0; k < PrevGtOccupant.FacialLandmarks2D.Num(); k++) {
 		rapidjson::Value Landmark(rapidjson::kObjectType);
-		Landmark.AddMember("name", rapidjson::Value(("Landmark" + std::to_string(k)).c_str(), allocator), allocator);
+		Landmark.AddMember("name", rapidjson::Value(LabelNameRef(FacialLandmarkNames[k])), allocator);
 
 		rapidjson::Value LandmarkVal(rapidjson::kArrayType);
 		LandmarkVal.PushBack(static_cast<int>(PrevGtOccupant.FacialLandmarks2D[k].X + 0.5f), allocator).PushBack(static_cast<int>(PrevGtOccupant.FacialLandmarks2D[k].Y + 0.5f), allocator);
@@ -322,7 +342,7 @@ static rapidjson::Value CreateJsonPoints2dOld(const DMSSimGroundTruthOccupant& P
 
 	for (int k = 0; k < PrevGtOccupant.LeftEyePupilLandmarks2D.Num(); k++) {
 		rapidjson::Value PupilLandmark(rapidjson::kObjectType);
-		PupilLandmark.AddMember("name", rapidjson::Value(("left eye pupil " + LandmarkPupilIrisNames[k]).c_str(), allocator), allocator);
+		PupilLandmark.AddMember("name", rapidjson::Value(LabelNameRef(LeftPupilNames[k])), allocator);
 
 		rapidjson::Value PupilVal(rapidjson::kArrayType);
 		PupilVal.PushBack(static_cast<int>(PrevGtOccupant.LeftEyePupilLandmarks2D[k].X + 0.5f), allocator).PushBack(static_cast<int>(PrevGtOccupant.LeftEyePupilLandmarks2D[k].Y + 0.5f), allocator);
@@ -346,7 +366,7 @@ static rapidjson::Value CreateJsonPoints2dOld(const DMSSimGroundTruthOccupant& P
 
 	for (int k = 0; k < PrevGtOccupant.LeftEyeIrisLandmarks2D.Num(); k++) {
 		rapidjson::Value IrisLandmark(rapidjson::kObjectType);
-		IrisLandmark.AddMember("name", rapidjson::Value(("left eye iris " + LandmarkPupilIrisNames[k]).c_str(), allocator), allocator);
+		IrisLandmark.AddMember("name", rapidjson::Value(LabelNameRef(LeftIrisNames[k])), allocator);
 
 		rapidjson::Value IrisVal(rapidjson::kArrayType);
 		IrisVal.PushBack(static_cast<int>(PrevGtOccupant.LeftEyeIrisLandmarks2D[k].X + 0.5f), allocator).PushBack(static_cast<int>(PrevGtOccupant.LeftEyeIrisLandmarks2D[k].Y + 0.5f), allocator);
@@ -370,7 +390,7 @@ static rapidjson::Value CreateJsonPoints2dOld(const DMSSimGroundTruthOccupant& P
 
 	for (int k = 0; k < PrevGtOccupant.RightEyePupilLandmarks2D.Num(); k++) {
 		rapidjson::Value PupilLandmark(rapidjson::kObjectType);
-		PupilLandmark.AddMember("name", rapidjson::Value(("right eye pupil " + LandmarkPupilIrisNames[k]).c_str(), allocator), allocator);
+		PupilLandmark.AddMember("name", rapidjson::Value(LabelNameRef(RightPupilNames[k])), allocator);
 
 		rapidjson::Value PupilVal(rapidjson::kArrayType);
 		PupilVal.PushBack(static_cast<int>(PrevGtOccupant.RightEyePupilLandmarks2D[k].X + 0.5f), allocator).PushBack(static_cast<int>(PrevGtOccupant.RightEyePupilLandmarks2D[k].Y + 0.5f), allocator);
@@ -394,7 +414,7 @@ static rapidjson::Value CreateJsonPoints2dOld(const DMSSimGroundTruthOccupant& P
 
 	for (int k = 0; k < PrevGtOccupant.RightEyeIrisLandmarks2D.Num(); k++) {
 		rapidjson::Value IrisLandmark(rapidjson::kObjectType);
-		IrisLandmark.AddMember("name", rapidjson::Value(("right eye iris " + LandmarkPupilIrisNames[k]).c_str(), allocator), allocator);
+		IrisLandmark.AddMember("name", rapidjson::Value(LabelNameRef(RightIrisNames[k])), allocator);
 
 		rapidjson::Value IrisVal(rapidjson::kArrayType);
 		IrisVal.PushBack(static_cast<int>(PrevGtOccupant.RightEyeIrisLandmarks2D[k].X + 0.5f), allocator).PushBack(static_cast<int>(PrevGtOccupant.RightEyeIrisLandmarks2D[k].Y + 0.5f), allocator);
@@ -551,10 +571,10 @@ static rapidjson::Value CreateJsonEyeAndSkinAttrsForOccupantOld(const FDMSSimOcc
 }
 
 static rapidjson::Value CreateJsonOccupantOld(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, const int i, rapidjson::Document::AllocatorType& allocator) {
-	const uint8 Type = static_cast<uint8>(PrevGroundTruth->Common.Occupants[i].Type);
-	const auto& PrevGtOccupant = PrevGroundTruth.Get()->Occupants[Type];
-	const auto& GtOccupant = GroundTruth.Get()->Occupants[Type];
-	const auto& PrevFDMSSimOccupant = PrevGroundTruth->Common.Occupants[i];
+	const uint8 Type = static_cast<uint8>(PrevGroundTruth->GetScenario().Occupants[i].Type);
+	const auto& PrevGtOccupant = PrevGroundTruth->Data.Occupants[Type];
+	const auto& GtOccupant = GroundTruth->Data.Occupants[Type];
+	const auto& PrevFDMSSimOccupant = PrevGroundTruth->GetScenario().Occupants[i];
 
 	rapidjson::Value Occupant(rapidjson::kObjectType);
 	Occupant.AddMember("name", rapidjson::Value(TCHAR_TO_UTF8(*PrevFDMSSimOccupant.Character), allocator), allocator);
@@ -586,31 +606,24 @@ static rapidjson::Value CreateJsonOccupantOld(const TSharedPtr<DMSSimGroundTruth
 }
 
 
-void DMSSimImageLabelerOldImpl::AddFrame(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, int FrameIdx) {
-	std::wstringstream ss;
-	ss << BaseFileName_ << L"_" << std::setw(5) << std::setfill(L'0') << FrameIdx << L"_old" << L".json";
-	// Serialize JSON to string
-	rapidjson::StringBuffer buffer;
-	rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
-	CreateLabelFileOld(PrevGroundTruth, GroundTruth).Accept(writer);
-	std::ofstream JsonFile(ss.str());
-	if (JsonFile.is_open()) {
-		JsonFile << buffer.GetString();
-		JsonFile.close();
-	}
-	else { DMSSimLog::Info() << "fail at creating json file" << FL; }
+void DMSSimImageLabelerOldImpl::CreateFrameJson(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, rapidjson::StringBuffer& Json) {
+	WritePretty(CreateLabelFileOld(PrevGroundTruth, GroundTruth), Json);
+}
+
+void DMSSimImageLabelerOldImpl::WriteFrameJson(const TSharedPtr<DMSSimGroundTruthFrame>&, const int FrameIdx, const char* const Json, const size_t Length) {
+	WriteFrameFile(Json, Length, FrameIdx, L"_old");
 }
 
 rapidjson::Document DMSSimImageLabelerOldImpl::CreateLabelFileOld(const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth) {
-	rapidjson::Document Root;
+	rapidjson::Document Root(&GetLabelAllocator());
 	Root.SetObject();
 	rapidjson::Document::AllocatorType& allocator = Root.GetAllocator();
 
 	// Assign metadata to openlabel
-	Root.AddMember("openlabel", rapidjson::Value(rapidjson::kObjectType).AddMember("metadata", CreateJsonMetadataOld(PrevGroundTruth->Common, allocator), allocator), allocator);
+	Root.AddMember("openlabel", rapidjson::Value(rapidjson::kObjectType).AddMember("metadata", CreateJsonMetadataOld(PrevGroundTruth->GetScenario(), PrevGroundTruth->Data, allocator), allocator), allocator);
 
 	rapidjson::Value Objects(rapidjson::kObjectType);
-	for (int i = 0; i < PrevGroundTruth->Common.OccupantCount; i++) {
+	for (int i = 0; i < PrevGroundTruth->GetScenario().OccupantCount; i++) {
 		auto Occupant = CreateJsonOccupantOld(PrevGroundTruth, GroundTruth, i, allocator);
 		Objects.AddMember(rapidjson::Value(std::to_string(i).c_str(), allocator), Occupant, allocator);
 	}
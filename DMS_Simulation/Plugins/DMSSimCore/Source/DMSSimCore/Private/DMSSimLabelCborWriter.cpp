@@ -0,0 +1,183 @@
+#include "DMSSimLabelCborWriter.h"
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+
+using namespace DMSSimLabelFormat;
+
+namespace {
+
+constexpr size_t INITIAL_STRING_TABLE_SIZE = 256;
+
+template <typename T>
+void PutBigEndian(const T Value, rapidjson::StringBuffer& Cbor) {
+	char* const Out = Cbor.Push(sizeof(T));
+	for (size_t i = 0; i < sizeof(T); ++i) { Out[i] = static_cast<char>(Value >> (8 * (sizeof(T) - 1 - i))); }
+}
+
+void PutLittleEndian(const uint32_t Value, char* const Out) {
+	for (size_t i = 0; i < sizeof(Value); ++i) { Out[i] = static_cast<char>(Value >> (8 * i)); }
+}
+
+uint32_t FloatBits(const float Value) {
+	uint32_t Bits;
+	std::memcpy(&Bits, &Value, sizeof(Bits));
+	return Bits;
+}
+
+const std::unordered_map<std::string_view, uint64_t>& GetLabelKeyIndices() {
+	static const std::unordered_map<std::string_view, uint64_t> Indices = []() {
+		std::unordered_map<std::string_view, uint64_t> Keys;
+		for (size_t i = 0; i < LABEL_KEY_COUNT; ++i) { Keys.emplace(LABEL_KEYS[i], i); }
+		return Keys;
+	}();
+	return Indices;
+}
+
+bool IsFloat(const double Value) { return static_cast<double>(static_cast<float>(Value)) == Value; }
+
+} // anonymous namespace
+
+DMSSimLabelCborWriter::DMSSimLabelCborWriter() : Strings_(INITIAL_STRING_TABLE_SIZE) {}
+
+void DMSSimLabelCborWriter::WriteHead(const uint8_t Major, const uint64_t Argument, rapidjson::StringBuffer& Cbor) {
+	const char Initial = static_cast<char>(Major << 5);
+	if (Argument < INFO_UINT8) { Cbor.Put(static_cast<char>(Initial | Argument)); }
+	else if (Argument <= UINT8_MAX) {
+		Cbor.Put(static_cast<char>(Initial | INFO_UINT8));
+		Cbor.Put(static_cast<char>(Argument));
+	}
+	else if (Argument <= UINT16_MAX) {
+		Cbor.Put(static_cast<char>(Initial | INFO_UINT16));
+		PutBigEndian(static_cast<uint16_t>(Argument), Cbor);
+	}
+	else if (Argument <= UINT32_MAX) {
+		Cbor.Put(static_cast<char>(Initial | INFO_UINT32));
+		PutBigEndian(static_cast<uint32_t>(Argument), Cbor);
+	}
+	else {
+		Cbor.Put(static_cast<char>(Initial | INFO_UINT64));
+		PutBigEndian(Argument, Cbor);
+	}
+}
+
+void DMSSimLabelCborWriter::WriteText(const std::string_view Text, rapidjson::StringBuffer& Cbor) {
+	WriteHead(MAJOR_TEXT, Text.size(), Cbor);
+	std::memcpy(Cbor.Push(Text.size()), Text.data(), Text.size());
+}
+
+void DMSSimLabelCborWriter::StartIndefiniteMap(rapidjson::StringBuffer& Cbor) { Cbor.Put(static_cast<char>((MAJOR_MAP << 5) | INFO_INDEFINITE)); }
+
+void DMSSimLabelCborWriter::WriteBreak(rapidjson::StringBuffer& Cbor) { Cbor.Put(static_cast<char>(BREAK)); }
+
+void DMSSimLabelCborWriter::WriteNamespace(const rapidjson::Value& Value, rapidjson::StringBuffer& Cbor) {
+	// a new generation empties the string table without touching the entries
+	if (++Generation_ == 0) {
+		for (auto& Entry : Strings_) { Entry.Generation = 0; }
+		Generation_ = 1;
+	}
+	StringCount_ = 0;
+	NextIndex_ = 0;
+	WriteHead(MAJOR_TAG, TAG_STRINGREF_NAMESPACE, Cbor);
+	WriteValue(Value, Cbor);
+}
+
+void DMSSimLabelCborWriter::WriteValue(const rapidjson::Value& Value, rapidjson::StringBuffer& Cbor) {
+	switch (Value.GetType()) {
+	case rapidjson::kNullType: Cbor.Put(static_cast<char>(SIMPLE_NULL)); break;
+	case rapidjson::kFalseType: Cbor.Put(static_cast<char>(SIMPLE_FALSE)); break;
+	case rapidjson::kTrueType: Cbor.Put(static_cast<char>(SIMPLE_TRUE)); break;
+	case rapidjson::kStringType: WriteString(Value.GetString(), Value.GetStringLength(), Cbor); break;
+	case rapidjson::kObjectType:
+		WriteHead(MAJOR_MAP, Value.MemberCount(), Cbor);
+		for (const auto& Member : Value.GetObject()) {
+			WriteKey(Member.name, Cbor);
+			WriteValue(Member.value, Cbor);
+		}
+		break;
+	case rapidjson::kArrayType:
+		if (WriteTypedArray(Value, Cbor)) { break; }
+		WriteHead(MAJOR_ARRAY, Value.Size(), Cbor);
+		for (const auto& Element : Value.GetArray()) { WriteValue(Element, Cbor); }
+		break;
+	case rapidjson::kNumberType:
+		if (Value.IsDouble()) {
+			// the floats of the labels are doubles in rapidjson, the json of a float and of the same double is the same
+			const double Number = Value.GetDouble();
+			if (IsFloat(Number)) {
+				Cbor.Put(static_cast<char>(FLOAT32));
+				PutBigEndian(FloatBits(static_cast<float>(Number)), Cbor);
+			}
+			else {
+				uint64_t Bits;
+				std::memcpy(&Bits, &Number, sizeof(Bits));
+				Cbor.Put(static_cast<char>(FLOAT64));
+				PutBigEndian(Bits, Cbor);
+			}
+		}
+		else if (Value.IsUint64()) { WriteHead(MAJOR_UNSIGNED, Value.GetUint64(), Cbor); }
+		else { WriteHead(MAJOR_NEGATIVE, static_cast<uint64_t>(-(Value.GetInt64() + 1)), Cbor); }
+		break;
+	}
+}
+
+void DMSSimLabelCborWriter::WriteKey(const rapidjson::Value& Name, rapidjson::StringBuffer& Cbor) {
+	const auto& KeyIndices = GetLabelKeyIndices();
+	const auto Found = KeyIndices.find(std::string_view(Name.GetString(), Name.GetStringLength()));
+	if (Found != KeyIndices.end()) { WriteHead(MAJOR_UNSIGNED, Found->second, Cbor); }
+	else { WriteString(Name.GetString(), Name.GetStringLength(), Cbor); }
+}
+
+void DMSSimLabelCborWriter::WriteString(const char* const Data, const uint32_t Length, rapidjson::StringBuffer& Cbor) {
+	StringEntry& Entry = FindString(Data, Length);
+	if (Entry.Generation == Generation_) {
+		WriteHead(MAJOR_TAG, TAG_STRINGREF, Cbor);
+		WriteHead(MAJOR_UNSIGNED, Entry.Index, Cbor);
+		return;
+	}
+	WriteText(std::string_view(Data, Length), Cbor);
+	if (!IsStringReferenced(Length, NextIndex_)) { return; }
+	Entry = StringEntry{ Data, Length, Generation_, NextIndex_++ };
+	if (++StringCount_ * 2 > Strings_.size()) { GrowStringTable(); }
+}
+
+bool DMSSimLabelCborWriter::WriteTypedArray(const rapidjson::Value& Array, rapidjson::StringBuffer& Cbor) {
+	const rapidjson::SizeType Size = Array.Size();
+	if (Size < 2) { return false; }
+	bool AllFloats = true;
+	bool AllInts = true;
+	for (const auto& Element : Array.GetArray()) {
+		AllFloats = AllFloats && Element.IsDouble() && IsFloat(Element.GetDouble());
+		AllInts = AllInts && Element.IsInt();
+		if (!AllFloats && !AllInts) { return false; }
+	}
+
+	WriteHead(MAJOR_TAG, AllFloats ? TAG_FLOAT32_ARRAY : TAG_INT32_ARRAY, Cbor);
+	WriteHead(MAJOR_BYTES, size_t(Size) * 4, Cbor);
+	char* Out = Cbor.Push(size_t(Size) * 4);
+	for (const auto& Element : Array.GetArray()) {
+		PutLittleEndian(AllFloats ? FloatBits(static_cast<float>(Element.GetDouble())) : static_cast<uint32_t>(Element.GetInt()), Out);
+		Out += 4;
+	}
+	// the byte string takes an index of the string table, although it's never referenced
+	if (IsStringReferenced(size_t(Size) * 4, NextIndex_)) { ++NextIndex_; }
+	return true;
+}
+
+DMSSimLabelCborWriter::StringEntry& DMSSimLabelCborWriter::FindString(const char* const Data, const uint32_t Length) {
+	const size_t Mask = Strings_.size() - 1;
+	size_t Slot = std::hash<std::string_view>()(std::string_view(Data, Length)) & Mask;
+	for (;; Slot = (Slot + 1) & Mask) {
+		StringEntry& Entry = Strings_[Slot];
+		if (Entry.Generation != Generation_) { return Entry; }
+		if (Entry.Length == Length && std::memcmp(Entry.Data, Data, Length) == 0) { return Entry; }
+	}
+}
+
+void DMSSimLabelCborWriter::GrowStringTable() {
+	std::vector<StringEntry> Entries(Strings_.size() * 2);
+	Entries.swap(Strings_);
+	for (const auto& Entry : Entries) {
+		if (Entry.Generation == Generation_) { FindString(Entry.Data, Entry.Length) = Entry; }
+	}
+}
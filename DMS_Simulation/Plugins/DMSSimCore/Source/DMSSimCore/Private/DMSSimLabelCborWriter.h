@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "DMSSimLabelFormat.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+
+/**
+ * @class DMSSimLabelCborWriter
+ * @brief Encodes the json values of the labelers as CBOR, see DMSSimLabelFormat.h for the layout.
+ * The string table of the namespaces is kept between the calls, so encoding a frame allocates no memory
+ * once the table is large enough. The names are looked up by their text, the values they reference
+ * only have to live until the value is written.
+ */
+class DMSSimLabelCborWriter
+{
+public:
+	DMSSimLabelCborWriter();
+
+	/** Appends the value to Cbor as a string reference namespace of its own. */
+	void WriteNamespace(const rapidjson::Value& Value, rapidjson::StringBuffer& Cbor);
+
+	// Items outside of the namespaces, for the envelope of the file
+	static void WriteHead(uint8_t Major, uint64_t Argument, rapidjson::StringBuffer& Cbor);
+	static void WriteText(std::string_view Text, rapidjson::StringBuffer& Cbor);
+	static void StartIndefiniteMap(rapidjson::StringBuffer& Cbor);
+	static void WriteBreak(rapidjson::StringBuffer& Cbor);
+
+private:
+	struct StringEntry {
+		const char* Data = nullptr;
+		uint32_t    Length = 0;
+		uint32_t    Generation = 0; // the entry belongs to the current namespace if it has its generation
+		uint64_t    Index = 0;
+	};
+
+	void WriteValue(const rapidjson::Value& Value, rapidjson::StringBuffer& Cbor);
+	void WriteKey(const rapidjson::Value& Name, rapidjson::StringBuffer& Cbor);
+	void WriteString(const char* Data, uint32_t Length, rapidjson::StringBuffer& Cbor);
+	bool WriteTypedArray(const rapidjson::Value& Array, rapidjson::StringBuffer& Cbor);
+	StringEntry& FindString(const char* Data, uint32_t Length);
+	void GrowStringTable();
+
+	std::vector<StringEntry> Strings_;    // open addressing, the size is a power of 2
+	size_t                   StringCount_ = 0;
+	uint32_t                 Generation_ = 0;
+	uint64_t                 NextIndex_ = 0;
+};
@@ -0,0 +1,150 @@
+#include "DMSSimLabelDelta.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+std::string_view ToView(const rapidjson::Value& String) { return std::string_view(String.GetString(), String.GetStringLength()); }
+
+bool IsNumeric(const rapidjson::Value& Value) {
+	if (Value.IsNumber()) { return true; }
+	if (!Value.IsArray()) { return false; }
+	for (const auto& Element : Value.GetArray()) {
+		if (!Element.IsNumber()) { return false; }
+	}
+	return true;
+}
+
+} // anonymous namespace
+
+void DMSSimLabelDeltaEncoder::AddObjectLabels(const std::string_view ObjectKey, const rapidjson::Value& ObjectData) {
+	for (const auto& Typed : ObjectData.GetObject()) {
+		if (!Typed.value.IsArray()) { continue; }
+		for (const auto& Label : Typed.value.GetArray()) {
+			bool Found = false;
+			LabelState& State = FindLabel(ObjectKey, ToView(Typed.name), Label, Found);
+			const auto Value = Label.FindMember("val");
+			if (Value != Label.MemberEnd()) { UpdateValue(State.Value, Value->value, true); }
+		}
+	}
+}
+
+void DMSSimLabelDeltaEncoder::EncodeFrame(rapidjson::Value& Frame, rapidjson::Document::AllocatorType& Allocator) {
+	rapidjson::Value Delta(rapidjson::kObjectType);
+	if (!Frame.IsObject()) {
+		Frame = Delta;
+		return;
+	}
+
+	const auto Properties = Frame.FindMember("frame_properties");
+	if (Properties != Frame.MemberEnd() && Properties->value.IsObject()) {
+		rapidjson::Value ChangedProperties(rapidjson::kObjectType);
+		for (auto& Property : Properties->value.GetObject()) {
+			Key_.assign(ToView(Property.name));
+			auto Found = FrameProperties_.find(Key_);
+			const bool IsNew = Found == FrameProperties_.end();
+			if (IsNew) { Found = FrameProperties_.emplace(Key_, ValueState()).first; }
+			if (UpdateValue(Found->second, Property.value, IsNew)) { ChangedProperties.AddMember(Property.name, Property.value, Allocator); }
+		}
+		if (!ChangedProperties.ObjectEmpty()) { Delta.AddMember("frame_properties", ChangedProperties, Allocator); }
+	}
+
+	const auto Objects = Frame.FindMember("objects");
+	if (Objects != Frame.MemberEnd() && Objects->value.IsObject()) {
+		rapidjson::Value ChangedObjects(rapidjson::kObjectType);
+		for (auto& Object : Objects->value.GetObject()) {
+			const auto ObjectData = Object.value.FindMember("object_data");
+			if (ObjectData == Object.value.MemberEnd() || !ObjectData->value.IsObject()) { continue; }
+			rapidjson::Value ChangedData(rapidjson::kObjectType);
+			for (auto& Typed : ObjectData->value.GetObject()) {
+				if (!Typed.value.IsArray()) { continue; }
+				rapidjson::Value ChangedLabels(rapidjson::kArrayType);
+				for (auto& Label : Typed.value.GetArray()) {
+					if (Label.IsObject() && EncodeLabel(ToView(Object.name), ToView(Typed.name), Label, Allocator)) { ChangedLabels.PushBack(Label, Allocator); }
+				}
+				if (!ChangedLabels.Empty()) { ChangedData.AddMember(Typed.name, ChangedLabels, Allocator); }
+			}
+			if (ChangedData.ObjectEmpty()) { continue; }
+			rapidjson::Value ChangedObject(rapidjson::kObjectType);
+			ChangedObject.AddMember("object_data", ChangedData, Allocator);
+			ChangedObjects.AddMember(Object.name, ChangedObject, Allocator);
+		}
+		if (!ChangedObjects.ObjectEmpty()) { Delta.AddMember("objects", ChangedObjects, Allocator); }
+	}
+	Frame = Delta;
+}
+
+bool DMSSimLabelDeltaEncoder::EncodeLabel(const std::string_view ObjectKey, const std::string_view Type, rapidjson::Value& Label, rapidjson::Document::AllocatorType& Allocator) {
+	bool Found = false;
+	LabelState& State = FindLabel(ObjectKey, Type, Label, Found);
+	const auto Value = Label.FindMember("val");
+	const bool ValueChanged = Value != Label.MemberEnd() && UpdateValue(State.Value, Value->value, !Found);
+
+	bool AttributesChanged = false;
+	const auto Attributes = Label.FindMember("attributes");
+	if (Attributes != Label.MemberEnd() && Attributes->value.IsObject()) {
+		rapidjson::Value ChangedAttributes(rapidjson::kObjectType);
+		for (auto& Typed : Attributes->value.GetObject()) {
+			if (!Typed.value.IsArray()) { continue; }
+			rapidjson::Value ChangedOfType(rapidjson::kArrayType);
+			for (auto& Attribute : Typed.value.GetArray()) {
+				const auto Name = Attribute.FindMember("name");
+				const auto AttributeValue = Attribute.FindMember("val");
+				if (Name == Attribute.MemberEnd() || AttributeValue == Attribute.MemberEnd()) { continue; }
+				Key_.assign(ToView(Typed.name)).append("/").append(ToView(Name->value));
+				auto Entry = std::find_if(State.Attributes.begin(), State.Attributes.end(), [this](const auto& Entry) { return Entry.first == Key_; });
+				const bool IsNew = Entry == State.Attributes.end();
+				if (IsNew) { Entry = State.Attributes.emplace(State.Attributes.end(), Key_, ValueState()); }
+				if (UpdateValue(Entry->second, AttributeValue->value, IsNew)) { ChangedOfType.PushBack(Attribute, Allocator); }
+			}
+			if (!ChangedOfType.Empty()) { ChangedAttributes.AddMember(Typed.name, ChangedOfType, Allocator); }
+		}
+		AttributesChanged = !ChangedAttributes.ObjectEmpty();
+		if (AttributesChanged) { Attributes->value = ChangedAttributes; }
+		else { Label.EraseMember(Attributes); }
+	}
+
+	if (!ValueChanged && !AttributesChanged) { return false; }
+	// the label is written with its current value, which becomes the one the next frames are compared to
+	if (!ValueChanged && Value != Label.MemberEnd()) { UpdateValue(State.Value, Value->value, true); }
+	return true;
+}
+
+bool DMSSimLabelDeltaEncoder::UpdateValue(ValueState& State, const rapidjson::Value& Value, const bool Force) {
+	if (IsNumeric(Value)) {
+		const rapidjson::SizeType Count = Value.IsArray() ? Value.Size() : 1;
+		const auto Number = [&Value](const rapidjson::SizeType i) { return (Value.IsArray() ? Value[i] : Value).GetDouble(); };
+		bool Changed = Force || !State.IsNumeric || State.Numbers.size() != Count;
+		// NaN is always a change
+		for (rapidjson::SizeType i = 0; i < Count && !Changed; ++i) { Changed = !(std::fabs(Number(i) - State.Numbers[i]) <= Epsilon_); }
+		if (!Changed) { return false; }
+		State.IsNumeric = true;
+		State.Json.clear();
+		State.Numbers.resize(Count);
+		for (rapidjson::SizeType i = 0; i < Count; ++i) { State.Numbers[i] = Number(i); }
+		return true;
+	}
+
+	Json_.Clear();
+	Writer_.Reset(Json_);
+	Value.Accept(Writer_);
+	const std::string_view Json(Json_.GetString(), Json_.GetSize());
+	if (!Force && !State.IsNumeric && State.Json == Json) { return false; }
+	State.IsNumeric = false;
+	State.Numbers.clear();
+	State.Json.assign(Json);
+	return true;
+}
+
+DMSSimLabelDeltaEncoder::LabelState& DMSSimLabelDeltaEncoder::FindLabel(const std::string_view ObjectKey, const std::string_view Type, const rapidjson::Value& Label, bool& Found) {
+	Key_.assign(ObjectKey).append("/").append(Type);
+	const auto Name = Label.FindMember("name");
+	if (Name != Label.MemberEnd() && Name->value.IsString()) { Key_.append("/").append(ToView(Name->value)); }
+	const auto CoordinateSystem = Label.FindMember("coordinate_system");
+	if (CoordinateSystem != Label.MemberEnd() && CoordinateSystem->value.IsString()) { Key_.append("/").append(ToView(CoordinateSystem->value)); }
+
+	auto Entry = Labels_.find(Key_);
+	Found = Entry != Labels_.end();
+	if (!Found) { Entry = Labels_.emplace(Key_, LabelState()).first; }
+	return Entry->second;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+/**
+ * @brief Layout of the delta OpenLABEL file (<BaseFileName>_delta.json) of DMSSimImageLabelerDeltaImpl.
+ *
+ * The file has the sections of the streamed json file of DMSSimImageLabelerImpl, but every frame only has the labels
+ * that changed since they were last written:
+ *
+ *   { "openlabel": { "metadata": ..., "coordinate_systems": ..., "streams": ...,
+ *                    "frames": { "<FrameIdx>": delta frame, ... },
+ *                    "frame_intervals": [ { "frame_start": first, "frame_end": last } ],
+ *                    "objects": { "<i>": { "name", "type", "frame_intervals": [...], "object_data": ... } } } }
+ *
+ * The objects follow the frames, as their frame intervals are only known at the end. Their object data has the labels
+ * of the occupant that are the same for the whole scenario: the characteristics and the accessories.
+ *
+ * A label of a frame is identified by its object, its data type (text, num, bbox, vec), its name and coordinate system.
+ * It's written when its value or one of its attributes changed by more than the epsilon of the metadata
+ * (label_delta_epsilon), numbers are compared one by one, text exactly. The label has its name, value and coordinate
+ * system, but only the attributes that changed. The members of frame_properties are written when they changed.
+ * Frames and objects without changes are empty, so every frame of the recording is in the file.
+ * A reader keeps the last value of every label, Tools/LabelDelta reconstructs the frames.
+ */
+namespace DMSSimLabelDelta {
+	constexpr char DELTA_SUFFIX[] = "_delta";
+	constexpr char EPSILON_KEY[] = "label_delta_epsilon"; // member of the metadata
+}
+
+/**
+ * @class DMSSimLabelDeltaEncoder
+ * @brief Reduces the frames of the streamed json to the labels that changed, see DMSSimLabelDelta.
+ * The frames have to be encoded in order. The last written value of every label is kept, not the one of the previous frame,
+ * so the values of a reader never differ from the labels by more than the epsilon.
+ */
+class DMSSimLabelDeltaEncoder
+{
+public:
+	explicit DMSSimLabelDeltaEncoder(double Epsilon) : Epsilon_(Epsilon) {}
+
+	/** Takes the labels of the object data as written, the frames only have them if they change. */
+	void AddObjectLabels(std::string_view ObjectKey, const rapidjson::Value& ObjectData);
+
+	/** Replaces the frame with its delta. The values of the frame are moved into the delta, Allocator is the one of the frame. */
+	void EncodeFrame(rapidjson::Value& Frame, rapidjson::Document::AllocatorType& Allocator);
+
+private:
+	/** The value as numbers, if it's a number or an array of numbers, otherwise as compact json. */
+	struct ValueState {
+		std::vector<double> Numbers;
+		std::string         Json;
+		bool                IsNumeric = false;
+	};
+
+	struct LabelState {
+		ValueState                                      Value;
+		std::vector<std::pair<std::string, ValueState>> Attributes; // by "<type>/<name>"
+	};
+
+	/** Reduces the label to its changes, false if nothing changed. */
+	bool EncodeLabel(std::string_view ObjectKey, std::string_view Type, rapidjson::Value& Label, rapidjson::Document::AllocatorType& Allocator);
+	bool UpdateValue(ValueState& State, const rapidjson::Value& Value, bool Force);
+	LabelState& FindLabel(std::string_view ObjectKey, std::string_view Type, const rapidjson::Value& Label, bool& Found);
+
+	const double                                Epsilon_;
+	std::unordered_map<std::string, LabelState> Labels_;
+	std::unordered_map<std::string, ValueState> FrameProperties_;
+	std::string                                 Key_;
+	rapidjson::StringBuffer                     Json_;
+	rapidjson::Writer<rapidjson::StringBuffer>  Writer_{ Json_ };
+};
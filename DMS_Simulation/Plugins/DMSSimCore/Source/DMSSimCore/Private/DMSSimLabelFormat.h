@@ -0,0 +1,76 @@
+#pragma once
+
+// Only the C++ standard library is used here, the header is shared with the label converter of Tools/LabelCbor.
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Layout of the binary OpenLABEL file (*.cbor) of DMSSimImageLabelerCborImpl.
+ *
+ * The file is a single CBOR item (RFC 8949) with the same objects, attributes and member order as the streamed json file
+ * of DMSSimImageLabelerImpl, so Tools/LabelCbor converts it to that json byte for byte:
+ *
+ *   self-described CBOR tag, then the indefinite length maps
+ *   { "openlabel": { "metadata": ..., "coordinate_systems": ..., "objects": ..., "streams": ...,
+ *                    "frames": { "<FrameIdx>": frame, ... } } }
+ *
+ * Every section and every frame is a string reference namespace of its own, so the frames can be encoded in parallel.
+ * Within a namespace, a repeated name or text value is a reference to its first occurrence. The member names of LABEL_KEYS
+ * are written as their index in the table instead, as the integer keys of COSE and CWT.
+ * Arrays of numbers are typed arrays: the floats of the labels are float32 values in the json as well, so they are stored
+ * as float32, integers as int32. Arrays whose values don't fit, e.g. a double that isn't a float, are regular arrays.
+ */
+namespace DMSSimLabelFormat {
+
+constexpr char     CBOR_EXTENSION[] = ".cbor";
+
+// major types, the upper 3 bits of the initial byte
+constexpr uint8_t  MAJOR_UNSIGNED = 0;
+constexpr uint8_t  MAJOR_NEGATIVE = 1;
+constexpr uint8_t  MAJOR_BYTES = 2;
+constexpr uint8_t  MAJOR_TEXT = 3;
+constexpr uint8_t  MAJOR_ARRAY = 4;
+constexpr uint8_t  MAJOR_MAP = 5;
+constexpr uint8_t  MAJOR_TAG = 6;
+constexpr uint8_t  MAJOR_SIMPLE = 7;
+
+// additional information of the initial byte
+constexpr uint8_t  INFO_UINT8 = 24;
+constexpr uint8_t  INFO_UINT16 = 25;
+constexpr uint8_t  INFO_UINT32 = 26;
+constexpr uint8_t  INFO_UINT64 = 27;
+constexpr uint8_t  INFO_INDEFINITE = 31;
+
+constexpr uint8_t  SIMPLE_FALSE = 0xF4;
+constexpr uint8_t  SIMPLE_TRUE = 0xF5;
+constexpr uint8_t  SIMPLE_NULL = 0xF6;
+constexpr uint8_t  FLOAT32 = 0xFA;
+constexpr uint8_t  FLOAT64 = 0xFB;
+constexpr uint8_t  BREAK = 0xFF;
+
+constexpr uint64_t TAG_STRINGREF = 25;           // index of a string of the namespace
+constexpr uint64_t TAG_INT32_ARRAY = 78;         // RFC 8746 sint32 little endian
+constexpr uint64_t TAG_FLOAT32_ARRAY = 85;       // RFC 8746 float32 little endian
+constexpr uint64_t TAG_STRINGREF_NAMESPACE = 256;
+constexpr uint64_t TAG_SELF_DESCRIBED = 55799;   // the magic number of the file, D9 D9 F7
+
+/** Member names written as their index, the first 24 take a single byte. Names are only appended, the indices are part of the format. */
+constexpr std::string_view LABEL_KEYS[] = {
+	"name", "val", "coordinate_system", "attributes", "boolean", "num", "text", "vec",
+	"bbox", "object_data", "objects", "frame_properties", "timestamp", "streams", "stream_properties", "intrinsics_custom",
+	"camera_matrix", "distortion_coeffs", "height_px", "width_px", "sensor_position", "sensor_rotation", "holder", "description",
+	"steering_column_adjusted", "acc_intrinsics", "type", "parent", "children", "pose_wrt_parent",
+};
+constexpr size_t LABEL_KEY_COUNT = sizeof(LABEL_KEYS) / sizeof(LABEL_KEYS[0]);
+
+/**
+ * Whether a string with the index is added to the string table of the namespace: only strings longer than a reference
+ * to them, as defined by the stringref tag. Byte strings count as well, the encoder and the decoder have to agree.
+ */
+constexpr bool IsStringReferenced(const size_t Length, const uint64_t Index) {
+	return Length >= (Index < 24 ? 3 : Index < 256 ? 4 : Index < 65536 ? 5 : Index < 4294967296ull ? 7 : 11);
+}
+
+} // namespace DMSSimLabelFormat
@@ -0,0 +1,205 @@
+#include "DMSSimLabelWriter.h"
+#include "DMSSimLog.h"
+
+DMSSimLabelWriter::Worker::Worker(DMSSimLabelWriter& Writer, const std::wstring& BaseFileName, const uint8 Labels, const bool Streaming, const float DeltaEpsilon) :
+	Writer_(Writer)
+{
+	if (Labels & OpenLabel) { Labeler_ = MakeUnique<DMSSimImageLabelerImpl>(BaseFileName, Streaming); }
+	if (Labels & OpenLabelOld) { LabelerOld_ = MakeUnique<DMSSimImageLabelerOldImpl>(BaseFileName); }
+	if (Labels & OpenLabelCbor) { LabelerCbor_ = MakeUnique<DMSSimImageLabelerCborImpl>(BaseFileName); }
+	if (Labels & OpenLabelDelta) { LabelerDelta_ = MakeUnique<DMSSimImageLabelerDeltaImpl>(BaseFileName, DeltaEpsilon); }
+}
+
+DMSSimLabelWriter::Worker::~Worker() { Join(); }
+
+bool DMSSimLabelWriter::Worker::Start() {
+	Thread_ = FRunnableThread::Create(this, TEXT("DMS Sim Label Serializer Thread"));
+	return Thread_ != nullptr;
+}
+
+void DMSSimLabelWriter::Worker::Join() {
+	if (!Thread_) { return; }
+	Thread_->WaitForCompletion();
+	delete Thread_;
+	Thread_ = nullptr;
+}
+
+uint32 DMSSimLabelWriter::Worker::Run() {
+	Job Entry;
+	while (Writer_.JobQueue_.Pop(Entry)) {
+		// the labeler of the worker only serializes, the stream file is opened by the committing labeler
+		Slot& Serialized = Writer_.AcquireSlot(Entry.Seq, BlockedTime_);
+		Serialized.Json.Clear();
+		Serialized.JsonOld.Clear();
+		Serialized.Cbor.Clear();
+		Serialized.JsonDelta.Clear();
+		if (Labeler_) { Labeler_->SerializeFrame(Entry.PrevGroundTruth, Entry.GroundTruth, Serialized.Json); }
+		if (LabelerOld_) { LabelerOld_->SerializeFrame(Entry.PrevGroundTruth, Entry.GroundTruth, Serialized.JsonOld); }
+		if (LabelerCbor_) { LabelerCbor_->SerializeFrame(Entry.PrevGroundTruth, Entry.GroundTruth, Serialized.Cbor); }
+		if (LabelerDelta_) { LabelerDelta_->SerializeFrame(Entry.PrevGroundTruth, Entry.GroundTruth, Serialized.JsonDelta); }
+		Serialized.PrevGroundTruth = MoveTemp(Entry.PrevGroundTruth);
+		Serialized.FrameIdx = Entry.FrameIdx;
+		Entry.GroundTruth.Reset();
+		Writer_.PublishSlot(Serialized);
+	}
+	return 0;
+}
+
+DMSSimLabelWriter::DMSSimLabelWriter(const std::wstring& BaseFileName, const uint8 Labels, const bool Streaming, const int WorkerCount, const size_t CommitWindow, const float DeltaEpsilon) :
+	BaseFileName_(BaseFileName),
+	JobQueue_(CommitWindow),
+	Slots_(CommitWindow > 0 ? CommitWindow : 1)
+{
+	if (Labels & OpenLabel) { Labeler_ = MakeUnique<DMSSimImageLabelerImpl>(BaseFileName_, Streaming); }
+	if (Labels & OpenLabelOld) { LabelerOld_ = MakeUnique<DMSSimImageLabelerOldImpl>(BaseFileName_); }
+	if (Labels & OpenLabelCbor) { LabelerCbor_ = MakeUnique<DMSSimImageLabelerCborImpl>(BaseFileName_); }
+	if (Labels & OpenLabelDelta) { LabelerDelta_ = MakeUnique<DMSSimImageLabelerDeltaImpl>(BaseFileName_, DeltaEpsilon); }
+	for (int i = 0; i < WorkerCount; ++i) {
+		auto NewWorker = MakeUnique<Worker>(*this, BaseFileName_, Labels, Streaming, DeltaEpsilon);
+		if (!NewWorker->Start()) { break; }
+		Workers_.push_back(MoveTemp(NewWorker));
+	}
+	if (!Workers_.empty()) { Thread_ = FRunnableThread::Create(this, TEXT("DMS Sim Label Writer Thread")); }
+	if (!Thread_) {
+		StopWorkers();
+		if (WorkerCount > 0) { DMSSimLog::Warn() << "DMSSimLabelWriter  -- " << "no label threads, the labels are written by the recording thread" << FL; }
+	}
+}
+
+DMSSimLabelWriter::~DMSSimLabelWriter() { Finalize(); }
+
+uint32 DMSSimLabelWriter::Run() {
+	std::unique_lock<std::mutex> Lock(Mutex_);
+	for (;;) {
+		Slot& Serialized = Slots_[Committed_ % Slots_.size()];
+		if (!Serialized.Ready && !(Closed_ && Committed_ == NextSeq_)) {
+			const double WaitStart = FPlatformTime::Seconds();
+			SlotReady_.wait(Lock, [this, &Serialized]() { return Serialized.Ready || (Closed_ && Committed_ == NextSeq_); });
+			CommitBlockedTime_ += FPlatformTime::Seconds() - WaitStart;
+		}
+		if (!Serialized.Ready) { break; }
+		const size_t CommitDepth = static_cast<size_t>(Serialized_ - Committed_ - 1);
+		CommitDepthSum_ += CommitDepth;
+		MaxCommitDepth_ = std::max(MaxCommitDepth_, CommitDepth);
+		Lock.unlock();
+
+		if (Labeler_) { Labeler_->CommitFrame(Serialized.PrevGroundTruth, Serialized.FrameIdx, Serialized.Json.GetString(), Serialized.Json.GetSize()); }
+		if (LabelerOld_) { LabelerOld_->CommitFrame(Serialized.PrevGroundTruth, Serialized.FrameIdx, Serialized.JsonOld.GetString(), Serialized.JsonOld.GetSize()); }
+		if (LabelerCbor_) { LabelerCbor_->CommitFrame(Serialized.PrevGroundTruth, Serialized.FrameIdx, Serialized.Cbor.GetString(), Serialized.Cbor.GetSize()); }
+		if (LabelerDelta_) { LabelerDelta_->CommitFrame(Serialized.PrevGroundTruth, Serialized.FrameIdx, Serialized.JsonDelta.GetString(), Serialized.JsonDelta.GetSize()); }
+		Serialized.PrevGroundTruth.Reset();
+
+		Lock.lock();
+		Serialized.Ready = false;
+		++Committed_;
+		SlotFree_.notify_all();
+	}
+	Lock.unlock();
+
+	FinalizeLabelers();
+	const Stats WriterStats = GetStats();
+	DMSSimLog::Info() << "DMSSimLabelWriter  -- " << "Frames: " << WriterStats.Frames << ", workers: " << Workers_.size()
+		<< ", queue depth max: " << WriterStats.MaxQueueDepth << " mean: " << WriterStats.MeanQueueDepth
+		<< ", commit depth max: " << WriterStats.MaxCommitDepth << " mean: " << WriterStats.MeanCommitDepth
+		<< ", recorder blocked: " << WriterStats.ProducerBlockedTime << " s"
+		<< ", workers blocked: " << WriterStats.WorkerBlockedTime << " s"
+		<< ", writer blocked: " << WriterStats.CommitBlockedTime << " s" << FL;
+	return 0;
+}
+
+void DMSSimLabelWriter::Stop() { JobQueue_.Close(); }
+
+bool DMSSimLabelWriter::AddFrame(FramePtr PrevGroundTruth, FramePtr GroundTruth, const int FrameIdx) {
+	if (Finalized_ || !PrevGroundTruth || !GroundTruth) { return false; }
+	if (!Thread_) {
+		if (Labeler_) { Labeler_->AddFrame(PrevGroundTruth, GroundTruth, FrameIdx); }
+		if (LabelerOld_) { LabelerOld_->AddFrame(PrevGroundTruth, GroundTruth, FrameIdx); }
+		if (LabelerCbor_) { LabelerCbor_->AddFrame(PrevGroundTruth, GroundTruth, FrameIdx); }
+		if (LabelerDelta_) { LabelerDelta_->AddFrame(PrevGroundTruth, GroundTruth, FrameIdx); }
+		std::lock_guard<std::mutex> Lock(Mutex_);
+		++NextSeq_;
+		++Committed_;
+		return true;
+	}
+
+	int64 Seq = 0;
+	{
+		std::lock_guard<std::mutex> Lock(Mutex_);
+		Seq = NextSeq_++;
+		const size_t QueueDepth = JobQueue_.Num();
+		QueueDepthSum_ += QueueDepth;
+		MaxQueueDepth_ = std::max(MaxQueueDepth_, QueueDepth);
+	}
+	if (JobQueue_.Push(Job{ Seq, MoveTemp(PrevGroundTruth), MoveTemp(GroundTruth), FrameIdx })) { return true; }
+
+	// stopped, no worker got the sequence number
+	std::lock_guard<std::mutex> Lock(Mutex_);
+	--NextSeq_;
+	return false;
+}
+
+void DMSSimLabelWriter::Finalize() {
+	if (Finalized_) { return; }
+	Finalized_ = true;
+	if (!Thread_) {
+		FinalizeLabelers();
+		return;
+	}
+	StopWorkers();
+	{
+		std::lock_guard<std::mutex> Lock(Mutex_);
+		Closed_ = true;
+	}
+	SlotReady_.notify_all();
+	Thread_->WaitForCompletion();
+	delete Thread_;
+	Thread_ = nullptr;
+}
+
+DMSSimLabelWriter::Stats DMSSimLabelWriter::GetStats() const {
+	std::lock_guard<std::mutex> Lock(Mutex_);
+	Stats Result;
+	Result.Frames = Committed_;
+	Result.MaxQueueDepth = MaxQueueDepth_;
+	Result.MeanQueueDepth = NextSeq_ > 0 ? double(QueueDepthSum_) / double(NextSeq_) : 0.0;
+	Result.MaxCommitDepth = MaxCommitDepth_;
+	Result.MeanCommitDepth = Committed_ > 0 ? double(CommitDepthSum_) / double(Committed_) : 0.0;
+	Result.ProducerBlockedTime = JobQueue_.GetPushBlockedTime();
+	Result.WorkerBlockedTime = JobQueue_.GetPopBlockedTime();
+	for (const auto& Serializer : Workers_) { Result.WorkerBlockedTime += Serializer->GetBlockedTime(); }
+	Result.CommitBlockedTime = CommitBlockedTime_;
+	return Result;
+}
+
+DMSSimLabelWriter::Slot& DMSSimLabelWriter::AcquireSlot(const int64 Seq, double& BlockedTime) {
+	std::unique_lock<std::mutex> Lock(Mutex_);
+	const int64 Window = static_cast<int64>(Slots_.size());
+	if (Seq >= Committed_ + Window) {
+		const double WaitStart = FPlatformTime::Seconds();
+		SlotFree_.wait(Lock, [this, Seq, Window]() { return Seq < Committed_ + Window; });
+		BlockedTime += FPlatformTime::Seconds() - WaitStart;
+	}
+	return Slots_[Seq % Window];
+}
+
+void DMSSimLabelWriter::PublishSlot(Slot& Serialized) {
+	{
+		std::lock_guard<std::mutex> Lock(Mutex_);
+		Serialized.Ready = true;
+		++Serialized_;
+	}
+	SlotReady_.notify_one();
+}
+
+void DMSSimLabelWriter::FinalizeLabelers() {
+	if (Labeler_) { Labeler_->Finalize(); }
+	if (LabelerOld_) { LabelerOld_->Finalize(); }
+	if (LabelerCbor_) { LabelerCbor_->Finalize(); }
+	if (LabelerDelta_) { LabelerDelta_->Finalize(); }
+}
+
+void DMSSimLabelWriter::StopWorkers() {
+	// the queued frames are still serialized, the workers stop once the queue is empty
+	JobQueue_.Close();
+	for (auto& Serializer : Workers_) { Serializer->Join(); }
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "DMSSimBoundedQueue.h"
+#include "DMSSimConfig.h"
+#include "DMSSimImageLabeler.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+
+/**
+ * @class DMSSimLabelWriter
+ * @brief Serializes the labels of the selected labelers on a pool of worker threads and writes them in frame order.
+ * Every worker has its own labelers and serializes whole frames, the writer thread commits the serialized
+ * frames in the order they were added, so the files are identical to running the labelers on the caller's thread.
+ * At most the commit window of frames are serialized ahead of the oldest uncommitted frame.
+ * AddFrame blocks while the queue is full. With no workers, or if the threads can't be created, the labels are written by the caller.
+ */
+class DMSSimLabelWriter : public FRunnable
+{
+public:
+	using FramePtr = TSharedPtr<DMSSimGroundTruthFrame>;
+
+	/** The labelers to run, a combination of the flags. */
+	enum Labels : uint8 {
+		OpenLabel = 1 << 0,     // DMSSimImageLabelerImpl
+		OpenLabelOld = 1 << 1,  // DMSSimImageLabelerOldImpl, the _old.json files
+		OpenLabelCbor = 1 << 2, // DMSSimImageLabelerCborImpl, the .cbor file
+		OpenLabelDelta = 1 << 3, // DMSSimImageLabelerDeltaImpl, the _delta.json file
+		AllLabels = OpenLabel | OpenLabelOld | OpenLabelCbor | OpenLabelDelta
+	};
+
+	struct Stats {
+		int64  Frames = 0;
+		size_t MaxQueueDepth = 0;        // frames waiting for a worker
+		double MeanQueueDepth = 0.0;
+		size_t MaxCommitDepth = 0;       // serialized frames waiting for an older frame to be committed
+		double MeanCommitDepth = 0.0;
+		double ProducerBlockedTime = 0.0;
+		double WorkerBlockedTime = 0.0;  // waiting for frames and for a free slot of the commit window, summed over the workers
+		double CommitBlockedTime = 0.0;
+	};
+
+	/**
+	 * Starts the workers and the writer thread.
+	 *
+	 * @param[in] BaseFileName   Path of the label files without the frame index and extension
+	 * @param[in] Labels         The labelers to run, combination of Labels
+	 * @param[in] Streaming      Whether DMSSimImageLabelerImpl writes one file per scenario
+	 * @param[in] WorkerCount    Number of serialization threads, 0 - everything is done by the caller
+	 * @param[in] CommitWindow   Max number of frames serialized, but not written yet
+	 * @param[in] DeltaEpsilon   Max change of a label value DMSSimImageLabelerDeltaImpl doesn't write
+	 */
+	DMSSimLabelWriter(const std::wstring& BaseFileName, uint8 Labels, bool Streaming, int WorkerCount, size_t CommitWindow = DEFAULT_LABEL_COMMIT_WINDOW,
+		float DeltaEpsilon = DMSSIM_DEFAULT_LABEL_DELTA_EPSILON);
+	DMSSimLabelWriter(const DMSSimLabelWriter&) = delete;
+	DMSSimLabelWriter& operator=(const DMSSimLabelWriter&) = delete;
+	virtual ~DMSSimLabelWriter();
+
+	uint32 Run() override;
+	void Stop() override;
+
+	/**
+	 * Queues the labels of a frame, see DMSSimImageLabeler::AddFrame.
+	 * @return false, if the writer was already finalized.
+	 */
+	bool AddFrame(FramePtr PrevGroundTruth, FramePtr GroundTruth, int FrameIdx);
+
+	/**
+	 * Writes the frames still in flight, completes the label files and stops the threads.
+	 * No frames can be added afterwards. Called on destruction, if it wasn't called explicitly.
+	 */
+	void Finalize();
+
+	int GetWorkerCount() const { return static_cast<int>(Workers_.size()); }
+
+	/** Queue depths sampled on every frame and the blocked times, complete after Finalize. */
+	Stats GetStats() const;
+
+private:
+	struct Job {
+		int64    Seq = 0;
+		FramePtr PrevGroundTruth;
+		FramePtr GroundTruth;
+		int      FrameIdx = 0;
+	};
+
+	struct Slot {
+		FramePtr                PrevGroundTruth;
+		int                     FrameIdx = 0;
+		rapidjson::StringBuffer Json;
+		rapidjson::StringBuffer JsonOld;
+		rapidjson::StringBuffer Cbor;
+		rapidjson::StringBuffer JsonDelta;
+		bool                    Ready = false;
+	};
+
+	class Worker : public FRunnable
+	{
+	public:
+		Worker(DMSSimLabelWriter& Writer, const std::wstring& BaseFileName, uint8 Labels, bool Streaming, float DeltaEpsilon);
+		~Worker();
+
+		bool Start();
+		void Join();
+		uint32 Run() override;
+
+		double GetBlockedTime() const { return BlockedTime_; }
+
+	private:
+		DMSSimLabelWriter&                     Writer_;
+		TUniquePtr<DMSSimImageLabelerImpl>     Labeler_;
+		TUniquePtr<DMSSimImageLabelerOldImpl>  LabelerOld_;
+		TUniquePtr<DMSSimImageLabelerCborImpl> LabelerCbor_;
+		TUniquePtr<DMSSimImageLabelerDeltaImpl> LabelerDelta_;
+		FRunnableThread*                       Thread_ = nullptr;
+		double                                 BlockedTime_ = 0.0;
+	};
+
+	Slot& AcquireSlot(int64 Seq, double& BlockedTime);
+	void PublishSlot(Slot& Serialized);
+	void FinalizeLabelers();
+	void StopWorkers();
+
+	const std::wstring                     BaseFileName_;
+	TUniquePtr<DMSSimImageLabelerImpl>     Labeler_;        // commit the frames, or do everything without workers
+	TUniquePtr<DMSSimImageLabelerOldImpl>  LabelerOld_;
+	TUniquePtr<DMSSimImageLabelerCborImpl> LabelerCbor_;
+	TUniquePtr<DMSSimImageLabelerDeltaImpl> LabelerDelta_;
+	DMSSimBoundedQueue<Job>                JobQueue_;
+	std::vector<TUniquePtr<Worker>>        Workers_;
+	std::vector<Slot>                      Slots_;
+	mutable std::mutex                     Mutex_;
+	std::condition_variable                SlotReady_;
+	std::condition_variable                SlotFree_;
+	int64                                  NextSeq_ = 0;    // guarded by Mutex_, as all members below up to Thread_
+	int64                                  Committed_ = 0;
+	int64                                  Serialized_ = 0;
+	bool                                   Closed_ = false;
+	size_t                                 QueueDepthSum_ = 0;
+	size_t                                 MaxQueueDepth_ = 0;
+	size_t                                 CommitDepthSum_ = 0;
+	size_t                                 MaxCommitDepth_ = 0;
+	double                                 CommitBlockedTime_ = 0.0;
+	FRunnableThread*                       Thread_ = nullptr;
+	bool                                   Finalized_ = false;
+};
@@ -0,0 +1,235 @@
+#include "DMSSimLandmarkProjection.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr int32 BOUNDING_BOX_CORNERS = 4;
+constexpr int32 MAX_PROJECTED_POINTS = MAX_FACIAL_LANDMARKS + 4 * MAX_PUPIL_IRIS_LANDMARKS + 3 * BOUNDING_BOX_CORNERS;
+constexpr int32 UNDISTORT_ITERATIONS = 20;
+constexpr double UNDISTORT_EPSILON = 1e-9; // of the normalized coordinates, far below 1/128 pixel
+constexpr int32 PROJECTION_BLOCK_SIZE = 128; // points of the public batched functions normalized at once on the stack
+
+/** The points of an occupant, the facial landmarks first. */
+struct ProjectionBatch {
+	alignas(32) float X[MAX_FACIAL_LANDMARKS];
+	alignas(32) float Y[MAX_FACIAL_LANDMARKS];
+	alignas(32) float Z[MAX_FACIAL_LANDMARKS];
+	alignas(32) float U[MAX_PROJECTED_POINTS];
+	alignas(32) float V[MAX_PROJECTED_POINTS];
+	alignas(32) float Xn[MAX_PROJECTED_POINTS]; // normalized image coordinates, before the distortion
+	alignas(32) float Yn[MAX_PROJECTED_POINTS];
+	int32 Count = 0;
+};
+
+/** 1 / X in front of the camera, 0 behind it, so the point ends up on the principal point instead of producing infinities. */
+inline float InverseDepth(const float X) { return X > 0.0f ? 1.0f / X : 0.0f; }
+
+/** X of the image before the mirroring, the mirroring is its own inverse. */
+inline float Mirror(const DMSSimCameraIntrinsics& Intrinsics, const float U) { return Intrinsics.Mirrored ? Intrinsics.Width - U : U; }
+
+inline void Distort(const DMSSimCameraIntrinsics& Intrinsics, const float Xn, const float Yn, float& Xd, float& Yd) {
+	const float R2 = Xn * Xn + Yn * Yn;
+	const float Radial = 1.0f + R2 * (Intrinsics.K1 + R2 * (Intrinsics.K2 + R2 * Intrinsics.K3));
+	const float XY2 = 2.0f * Xn * Yn;
+	Xd = Xn * Radial + Intrinsics.P1 * XY2 + Intrinsics.P2 * (R2 + 2.0f * Xn * Xn);
+	Yd = Yn * Radial + Intrinsics.P1 * (R2 + 2.0f * Yn * Yn) + Intrinsics.P2 * XY2;
+}
+
+// The loops below are kept free of branches and calls so the compiler vectorizes them,
+// the mirroring is a multiply-add with MirrorSign = -1 and MirrorOffset = Width for a mirrored camera.
+
+void NormalizePoints(const float* __restrict X, const float* __restrict Y, const float* __restrict Z, const int32 Count, float* __restrict Xn, float* __restrict Yn) {
+	for (int32 i = 0; i < Count; ++i) {
+		const float InvX = InverseDepth(X[i]);
+		Xn[i] = Y[i] * InvX;
+		Yn[i] = -Z[i] * InvX;
+	}
+}
+
+void NormalizePixels(const DMSSimCameraIntrinsics& Intrinsics, const float* __restrict U, const float* __restrict V, const int32 Count, float* __restrict Xn, float* __restrict Yn) {
+	const float InvFocalLength = 1.0f / Intrinsics.FocalLength;
+	const float MirrorSign = Intrinsics.Mirrored ? -1.0f : 1.0f;
+	const float MirrorOffset = Intrinsics.Mirrored ? Intrinsics.Width : 0.0f;
+	const float Cx = Intrinsics.Cx;
+	const float Cy = Intrinsics.Cy;
+	for (int32 i = 0; i < Count; ++i) {
+		Xn[i] = (MirrorOffset + MirrorSign * U[i] - Cx) * InvFocalLength;
+		Yn[i] = (V[i] - Cy) * InvFocalLength;
+	}
+}
+
+void DistortToPixels(const DMSSimCameraIntrinsics& Intrinsics, const float* __restrict Xn, const float* __restrict Yn, const int32 Count, float* __restrict U, float* __restrict V) {
+	const DMSSimCameraIntrinsics Lens = Intrinsics; // a local copy, the stores can't change the coefficients
+	const float MirrorSign = Intrinsics.Mirrored ? -1.0f : 1.0f;
+	const float MirrorOffset = Intrinsics.Mirrored ? Intrinsics.Width : 0.0f;
+	const float FocalLength = Intrinsics.FocalLength;
+	const float Cx = Intrinsics.Cx;
+	const float Cy = Intrinsics.Cy;
+	for (int32 i = 0; i < Count; ++i) {
+		float Xd, Yd;
+		Distort(Lens, Xn[i], Yn[i], Xd, Yd);
+		U[i] = MirrorOffset + MirrorSign * (Cx + FocalLength * Xd);
+		V[i] = Cy + FocalLength * Yd;
+	}
+}
+
+void AddPixels(ProjectionBatch& Batch, const FVector2D* const Pixels, const int32 Count) {
+	for (int32 i = 0; i < Count; ++i) {
+		Batch.U[Batch.Count + i] = Pixels[i].X;
+		Batch.V[Batch.Count + i] = Pixels[i].Y;
+	}
+	Batch.Count += Count;
+}
+
+void AddBoundingBox(ProjectionBatch& Batch, const FDMSBoundingBox2D& BoundingBox) {
+	const float HalfWidth = BoundingBox.Width * 0.5f;
+	const float HalfHeight = BoundingBox.Height * 0.5f;
+	const FVector2D Corners[BOUNDING_BOX_CORNERS] = {
+		{ BoundingBox.Center.X - HalfWidth, BoundingBox.Center.Y - HalfHeight },
+		{ BoundingBox.Center.X + HalfWidth, BoundingBox.Center.Y - HalfHeight },
+		{ BoundingBox.Center.X - HalfWidth, BoundingBox.Center.Y + HalfHeight },
+		{ BoundingBox.Center.X + HalfWidth, BoundingBox.Center.Y + HalfHeight },
+	};
+	AddPixels(Batch, Corners, BOUNDING_BOX_CORNERS);
+}
+
+template <int32 Capacity>
+int32 ReadPixels(const ProjectionBatch& Batch, int32 First, DMSSimFixedArray<FVector2D, Capacity>& Pixels) {
+	for (auto& Pixel : Pixels) {
+		Pixel = FVector2D(Batch.U[First], Batch.V[First]);
+		++First;
+	}
+	return First;
+}
+
+int32 ReadBoundingBox(const ProjectionBatch& Batch, const int32 First, FDMSBoundingBox2D& BoundingBox) {
+	const auto U = std::minmax_element(Batch.U + First, Batch.U + First + BOUNDING_BOX_CORNERS);
+	const auto V = std::minmax_element(Batch.V + First, Batch.V + First + BOUNDING_BOX_CORNERS);
+	BoundingBox.Center = FVector2D((*U.first + *U.second) * 0.5f, (*V.first + *V.second) * 0.5f);
+	BoundingBox.Width = *U.second - *U.first;
+	BoundingBox.Height = *V.second - *V.first;
+	return First + BOUNDING_BOX_CORNERS;
+}
+
+} // anonymous namespace
+
+DMSSimCameraIntrinsics DMSSimCameraIntrinsics::Create(const unsigned FrameWidth, const unsigned FrameHeight, const float FOV, const bool Mirrored, const float* const Distortion) {
+	DMSSimCameraIntrinsics Intrinsics;
+	// the same expressions as the camera_matrix of the labels, so both have the same rounding
+	Intrinsics.FocalLength = FrameWidth * 0.5f / std::tan(FMath::DegreesToRadians(FOV * 0.5));
+	Intrinsics.Cx = FrameWidth * 0.5f;
+	Intrinsics.Cy = FrameHeight * 0.5f;
+	Intrinsics.Width = static_cast<float>(FrameWidth);
+	Intrinsics.Mirrored = Mirrored;
+	if (Distortion) {
+		Intrinsics.K1 = Distortion[0];
+		Intrinsics.K2 = Distortion[1];
+		Intrinsics.P1 = Distortion[2];
+		Intrinsics.P2 = Distortion[3];
+		Intrinsics.K3 = Distortion[4];
+		Intrinsics.Distorted = std::any_of(Distortion, Distortion + DMSSIM_DISTORTION_COEFFICIENT_COUNT, [](const float Coefficient) { return Coefficient != 0.0f; });
+	}
+	return Intrinsics;
+}
+
+DMSSimCameraIntrinsics DMSSimCameraIntrinsics::FromCamera(const DMSSimCamera& Camera) {
+	float Distortion[DMSSIM_DISTORTION_COEFFICIENT_COUNT] = {};
+	const bool HasDistortion = Camera.GetDistortionCount() == DMSSIM_DISTORTION_COEFFICIENT_COUNT;
+	for (size_t i = 0; HasDistortion && i < DMSSIM_DISTORTION_COEFFICIENT_COUNT; ++i) { Distortion[i] = Camera.GetDistortion(i); }
+	return Create(Camera.GetFrameWidth(), Camera.GetFrameHeight(), Camera.GetFOV(), Camera.GetMirrored(), HasDistortion ? Distortion : nullptr);
+}
+
+namespace DMSSimLandmarkProjection {
+
+FVector2D ProjectPoint(const DMSSimCameraIntrinsics& Intrinsics, const FVector& Point) {
+	const float InvX = InverseDepth(Point.X);
+	float Xd, Yd;
+	Distort(Intrinsics, Point.Y * InvX, -Point.Z * InvX, Xd, Yd);
+	return FVector2D(Mirror(Intrinsics, Intrinsics.Cx + Intrinsics.FocalLength * Xd), Intrinsics.Cy + Intrinsics.FocalLength * Yd);
+}
+
+FVector2D DistortPixel(const DMSSimCameraIntrinsics& Intrinsics, const FVector2D& Pixel) {
+	const float InvFocalLength = 1.0f / Intrinsics.FocalLength;
+	float Xd, Yd;
+	Distort(Intrinsics, (Mirror(Intrinsics, Pixel.X) - Intrinsics.Cx) * InvFocalLength, (Pixel.Y - Intrinsics.Cy) * InvFocalLength, Xd, Yd);
+	return FVector2D(Mirror(Intrinsics, Intrinsics.Cx + Intrinsics.FocalLength * Xd), Intrinsics.Cy + Intrinsics.FocalLength * Yd);
+}
+
+FVector2D UndistortPixel(const DMSSimCameraIntrinsics& Intrinsics, const FVector2D& Pixel) {
+	if (!Intrinsics.Distorted) { return Pixel; }
+	// in double, the remap tables are built from it and shouldn't depend on the rounding of the iterations
+	const double Xd = (Mirror(Intrinsics, Pixel.X) - Intrinsics.Cx) / double(Intrinsics.FocalLength);
+	const double Yd = (Pixel.Y - Intrinsics.Cy) / double(Intrinsics.FocalLength);
+	double Xn = Xd;
+	double Yn = Yd;
+	for (int32 i = 0; i < UNDISTORT_ITERATIONS; ++i) {
+		const double R2 = Xn * Xn + Yn * Yn;
+		const double InvRadial = 1.0 / (1.0 + R2 * (Intrinsics.K1 + R2 * (Intrinsics.K2 + R2 * Intrinsics.K3)));
+		const double XY2 = 2.0 * Xn * Yn;
+		const double DeltaX = Intrinsics.P1 * XY2 + Intrinsics.P2 * (R2 + 2.0 * Xn * Xn);
+		const double DeltaY = Intrinsics.P1 * (R2 + 2.0 * Yn * Yn) + Intrinsics.P2 * XY2;
+		const double NextXn = (Xd - DeltaX) * InvRadial;
+		const double NextYn = (Yd - DeltaY) * InvRadial;
+		const bool Converged = std::abs(NextXn - Xn) + std::abs(NextYn - Yn) < UNDISTORT_EPSILON;
+		Xn = NextXn;
+		Yn = NextYn;
+		if (Converged) { break; }
+	}
+	return FVector2D(Mirror(Intrinsics, float(Intrinsics.Cx + Intrinsics.FocalLength * Xn)), float(Intrinsics.Cy + Intrinsics.FocalLength * Yn));
+}
+
+void ProjectPoints(const DMSSimCameraIntrinsics& Intrinsics, const float* X, const float* Y, const float* Z, const int32 Count, float* U, float* V) {
+	alignas(32) float Xn[PROJECTION_BLOCK_SIZE];
+	alignas(32) float Yn[PROJECTION_BLOCK_SIZE];
+	for (int32 First = 0; First < Count; First += PROJECTION_BLOCK_SIZE) {
+		const int32 BlockCount = std::min(Count - First, PROJECTION_BLOCK_SIZE);
+		NormalizePoints(X + First, Y + First, Z + First, BlockCount, Xn, Yn);
+		DistortToPixels(Intrinsics, Xn, Yn, BlockCount, U + First, V + First);
+	}
+}
+
+void DistortPixels(const DMSSimCameraIntrinsics& Intrinsics, float* U, float* V, const int32 Count) {
+	alignas(32) float Xn[PROJECTION_BLOCK_SIZE];
+	alignas(32) float Yn[PROJECTION_BLOCK_SIZE];
+	for (int32 First = 0; First < Count; First += PROJECTION_BLOCK_SIZE) {
+		const int32 BlockCount = std::min(Count - First, PROJECTION_BLOCK_SIZE);
+		NormalizePixels(Intrinsics, U + First, V + First, BlockCount, Xn, Yn);
+		DistortToPixels(Intrinsics, Xn, Yn, BlockCount, U + First, V + First);
+	}
+}
+
+void ProjectOccupant(const DMSSimCameraIntrinsics& Intrinsics, DMSSimGroundTruthOccupant& Occupant) {
+	ProjectionBatch Batch;
+	const int32 LandmarkCount = Occupant.FacialLandmarks3D_inCam.Num();
+	for (int32 i = 0; i < LandmarkCount; ++i) {
+		const FVector& Point = Occupant.FacialLandmarks3D_inCam[i];
+		Batch.X[i] = Point.X;
+		Batch.Y[i] = Point.Y;
+		Batch.Z[i] = Point.Z;
+	}
+	Batch.Count = LandmarkCount;
+	AddPixels(Batch, Occupant.RightEyePupilLandmarks2D.begin(), Occupant.RightEyePupilLandmarks2D.Num());
+	AddPixels(Batch, Occupant.RightEyeIrisLandmarks2D.begin(), Occupant.RightEyeIrisLandmarks2D.Num());
+	AddPixels(Batch, Occupant.LeftEyePupilLandmarks2D.begin(), Occupant.LeftEyePupilLandmarks2D.Num());
+	AddPixels(Batch, Occupant.LeftEyeIrisLandmarks2D.begin(), Occupant.LeftEyeIrisLandmarks2D.Num());
+	AddBoundingBox(Batch, Occupant.FaceBoundingBox2D);
+	AddBoundingBox(Batch, Occupant.RightEyeBoundingBox2D);
+	AddBoundingBox(Batch, Occupant.LeftEyeBoundingBox2D);
+
+	NormalizePoints(Batch.X, Batch.Y, Batch.Z, LandmarkCount, Batch.Xn, Batch.Yn);
+	NormalizePixels(Intrinsics, Batch.U + LandmarkCount, Batch.V + LandmarkCount, Batch.Count - LandmarkCount, Batch.Xn + LandmarkCount, Batch.Yn + LandmarkCount);
+	DistortToPixels(Intrinsics, Batch.Xn, Batch.Yn, Batch.Count, Batch.U, Batch.V);
+
+	Occupant.FacialLandmarks2D.SetNum(LandmarkCount);
+	int32 Next = ReadPixels(Batch, 0, Occupant.FacialLandmarks2D);
+	Next = ReadPixels(Batch, Next, Occupant.RightEyePupilLandmarks2D);
+	Next = ReadPixels(Batch, Next, Occupant.RightEyeIrisLandmarks2D);
+	Next = ReadPixels(Batch, Next, Occupant.LeftEyePupilLandmarks2D);
+	Next = ReadPixels(Batch, Next, Occupant.LeftEyeIrisLandmarks2D);
+	Next = ReadBoundingBox(Batch, Next, Occupant.FaceBoundingBox2D);
+	Next = ReadBoundingBox(Batch, Next, Occupant.RightEyeBoundingBox2D);
+	ReadBoundingBox(Batch, Next, Occupant.LeftEyeBoundingBox2D);
+}
+
+} // namespace DMSSimLandmarkProjection
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "DMSSimConfig.h"
+
+/**
+ * @struct DMSSimCameraIntrinsics
+ * @brief Pinhole model of the scenario camera, the one the labeler writes into the camera_matrix and the frame coordinate system,
+ * with an optional Brown-Conrady lens distortion.
+ */
+struct DMSSimCameraIntrinsics
+{
+	float FocalLength = 0.0f; // in pixels, the same for both axes
+	float Cx = 0.0f;
+	float Cy = 0.0f;
+	float Width = 0.0f;
+	bool  Mirrored = false;   // the image is flipped horizontally after the lens
+	bool  Distorted = false;  // any of the coefficients isn't zero
+	float K1 = 0.0f, K2 = 0.0f, P1 = 0.0f, P2 = 0.0f, K3 = 0.0f;
+
+	/** @param Distortion nullptr or the DMSSIM_DISTORTION_COEFFICIENT_COUNT coefficients */
+	static DMSSimCameraIntrinsics Create(unsigned FrameWidth, unsigned FrameHeight, float FOV, bool Mirrored, const float* Distortion = nullptr);
+	static DMSSimCameraIntrinsics FromCamera(const DMSSimCamera& Camera);
+};
+
+/**
+ * @brief Projection of the ground truth points into the image with the camera intrinsics.
+ * The batched functions take the coordinates as separate arrays (structure of arrays), their loops have no branches
+ * and are vectorized by the compiler. The scalar functions are the reference the batched ones are tested against.
+ *
+ * The 3D points are in the Unreal camera space of the ..._inCam landmarks: X along the optical axis, Y to the right, Z up, any unit.
+ * Points with X <= 0 are behind the camera and are projected onto the principal point.
+ */
+namespace DMSSimLandmarkProjection {
+
+FVector2D ProjectPoint(const DMSSimCameraIntrinsics& Intrinsics, const FVector& Point);
+
+/** Moves a pixel of the pinhole image to where the lens distortion puts it. */
+FVector2D DistortPixel(const DMSSimCameraIntrinsics& Intrinsics, const FVector2D& Pixel);
+
+/**
+ * The pixel of the pinhole image the lens distortion moves to Pixel, the inverse of DistortPixel.
+ * It's solved by fixed point iteration, like OpenCV's undistortPoints, which converges for the distortion of real lenses within the image.
+ */
+FVector2D UndistortPixel(const DMSSimCameraIntrinsics& Intrinsics, const FVector2D& Pixel);
+
+void ProjectPoints(const DMSSimCameraIntrinsics& Intrinsics, const float* X, const float* Y, const float* Z, int32 Count, float* U, float* V);
+
+/** In place version of DistortPixel. */
+void DistortPixels(const DMSSimCameraIntrinsics& Intrinsics, float* U, float* V, int32 Count);
+
+/**
+ * Recomputes the 2D labels of the occupant in one batch: the facial landmarks are projected from FacialLandmarks3D_inCam,
+ * the pupil and iris landmarks and the corners of the face and eye bounding boxes have no 3D points and are moved by the distortion
+ * from their pinhole positions. The bounding boxes become the bounds of their moved corners.
+ */
+void ProjectOccupant(const DMSSimCameraIntrinsics& Intrinsics, DMSSimGroundTruthOccupant& Occupant);
+
+} // namespace DMSSimLandmarkProjection
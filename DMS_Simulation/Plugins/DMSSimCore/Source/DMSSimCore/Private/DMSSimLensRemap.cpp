@@ -0,0 +1,186 @@
+#include "DMSSimLensRemap.h"
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include "Async/ParallelFor.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define DMSSIM_LENS_REMAP_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define DMSSIM_TARGET_SSE41
+#define DMSSIM_TARGET_AVX2
+#else
+#define DMSSIM_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define DMSSIM_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define DMSSIM_LENS_REMAP_X86 0
+#endif
+
+using DMSSimPixelConversion::SimdLevel;
+
+namespace {
+
+constexpr int32_t FRACTION_ONE = 1 << DMSSimLensRemap::REMAP_FRACTION_BITS;
+constexpr int     WEIGHT_SHIFT = 2 * DMSSimLensRemap::REMAP_FRACTION_BITS;
+constexpr int32_t WEIGHT_ROUNDING = 1 << (WEIGHT_SHIFT - 1);
+
+/** The bilinear weights of the 2x2 pixels, the top ones in Top, the bottom ones in Bottom, left in the low 16 bits. */
+inline void GetWeights(const DMSSimLensRemap::Entry& Entry, int32_t& Top, int32_t& Bottom) {
+	const int32_t Fx = Entry.FractionX;
+	const int32_t Fy = Entry.FractionY;
+	const int32_t Valid = Entry.Valid;
+	const int32_t W00 = (FRACTION_ONE - Fx) * (FRACTION_ONE - Fy) * Valid;
+	const int32_t W01 = Fx * (FRACTION_ONE - Fy) * Valid;
+	const int32_t W10 = (FRACTION_ONE - Fx) * Fy * Valid;
+	const int32_t W11 = Fx * Fy * Valid;
+	Top = W00 | (W01 << 16);
+	Bottom = W10 | (W11 << 16);
+}
+
+void RemapRow_Scalar(const uint8_t* Src, size_t Stride, const DMSSimLensRemap::Entry* Table, uint8_t* Dst, size_t Begin, size_t Width) {
+	for (size_t X = Begin; X < Width; ++X) {
+		int32_t Top, Bottom;
+		GetWeights(Table[X], Top, Bottom);
+		const int32_t W00 = Top & 0xFFFF, W01 = Top >> 16, W10 = Bottom & 0xFFFF, W11 = Bottom >> 16;
+		const uint8_t* const P0 = Src + size_t(Table[X].Offset) * 4;
+		const uint8_t* const P1 = P0 + Stride;
+		for (int C = 0; C < 4; ++C) {
+			Dst[X * 4 + C] = uint8_t((W00 * P0[C] + W01 * P0[4 + C] + W10 * P1[C] + W11 * P1[4 + C] + WEIGHT_ROUNDING) >> WEIGHT_SHIFT);
+		}
+	}
+}
+
+#if DMSSIM_LENS_REMAP_X86
+
+/** The channel sums of a pixel as 4 int32, from the interleaved pixel pairs B0 B1 G0 G1 R0 R1 A0 A1 of the top and bottom row. */
+DMSSIM_TARGET_SSE41 inline __m128i RemapPixel_SSE41(const uint8_t* Src, size_t Stride, const DMSSimLensRemap::Entry& Entry, __m128i Interleave) {
+	const uint8_t* const P0 = Src + size_t(Entry.Offset) * 4;
+	const __m128i Top = _mm_cvtepu8_epi16(_mm_shuffle_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(P0)), Interleave));
+	const __m128i Bottom = _mm_cvtepu8_epi16(_mm_shuffle_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(P0 + Stride)), Interleave));
+	int32_t WeightsTop, WeightsBottom;
+	GetWeights(Entry, WeightsTop, WeightsBottom);
+	const __m128i Sum = _mm_add_epi32(_mm_madd_epi16(Top, _mm_set1_epi32(WeightsTop)), _mm_madd_epi16(Bottom, _mm_set1_epi32(WeightsBottom)));
+	return _mm_srai_epi32(_mm_add_epi32(Sum, _mm_set1_epi32(WEIGHT_ROUNDING)), WEIGHT_SHIFT);
+}
+
+DMSSIM_TARGET_SSE41 void RemapRow_SSE41(const uint8_t* Src, size_t Stride, const DMSSimLensRemap::Entry* Table, uint8_t* Dst, size_t Width) {
+	const __m128i Interleave = _mm_setr_epi8(0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15);
+	size_t X = 0;
+	for (; X + 4 <= Width; X += 4) {
+		const __m128i Pixels01 = _mm_packs_epi32(RemapPixel_SSE41(Src, Stride, Table[X], Interleave), RemapPixel_SSE41(Src, Stride, Table[X + 1], Interleave));
+		const __m128i Pixels23 = _mm_packs_epi32(RemapPixel_SSE41(Src, Stride, Table[X + 2], Interleave), RemapPixel_SSE41(Src, Stride, Table[X + 3], Interleave));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + X * 4), _mm_packus_epi16(Pixels01, Pixels23));
+	}
+	RemapRow_Scalar(Src, Stride, Table, Dst, X, Width);
+}
+
+/** The channel sums of two pixels, one per lane. */
+DMSSIM_TARGET_AVX2 inline __m256i RemapPixels_AVX2(const uint8_t* Src, size_t Stride, const DMSSimLensRemap::Entry* Entries, __m128i Interleave) {
+	const uint8_t* const A = Src + size_t(Entries[0].Offset) * 4;
+	const uint8_t* const B = Src + size_t(Entries[1].Offset) * 4;
+	const __m128i Top = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(A)), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(B)));
+	const __m128i Bottom = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(A + Stride)), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(B + Stride)));
+	int32_t WeightsTopA, WeightsBottomA, WeightsTopB, WeightsBottomB;
+	GetWeights(Entries[0], WeightsTopA, WeightsBottomA);
+	GetWeights(Entries[1], WeightsTopB, WeightsBottomB);
+	const __m256i Sum = _mm256_add_epi32(
+		_mm256_madd_epi16(_mm256_cvtepu8_epi16(_mm_shuffle_epi8(Top, Interleave)), _mm256_set_m128i(_mm_set1_epi32(WeightsTopB), _mm_set1_epi32(WeightsTopA))),
+		_mm256_madd_epi16(_mm256_cvtepu8_epi16(_mm_shuffle_epi8(Bottom, Interleave)), _mm256_set_m128i(_mm_set1_epi32(WeightsBottomB), _mm_set1_epi32(WeightsBottomA))));
+	return _mm256_srai_epi32(_mm256_add_epi32(Sum, _mm256_set1_epi32(WEIGHT_ROUNDING)), WEIGHT_SHIFT);
+}
+
+/**
+ * Two pixels per register, the pairs are loaded like in the SSE4.1 kernel.
+ * The AVX2 gathers of the pairs are slower than the separate loads on the CPUs we measured.
+ */
+DMSSIM_TARGET_AVX2 void RemapRow_AVX2(const uint8_t* Src, size_t Stride, const DMSSimLensRemap::Entry* Table, uint8_t* Dst, size_t Width) {
+	const __m128i Interleave = _mm_setr_epi8(0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15);
+	const __m256i Order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	size_t X = 0;
+	for (; X + 8 <= Width; X += 8) {
+		const __m256i Words0 = _mm256_packs_epi32(RemapPixels_AVX2(Src, Stride, Table + X, Interleave), RemapPixels_AVX2(Src, Stride, Table + X + 2, Interleave));
+		const __m256i Words1 = _mm256_packs_epi32(RemapPixels_AVX2(Src, Stride, Table + X + 4, Interleave), RemapPixels_AVX2(Src, Stride, Table + X + 6, Interleave));
+		// pixels 0, 2, 4, 6 in the low lane, 1, 3, 5, 7 in the high one
+		const __m256i Bytes = _mm256_packus_epi16(Words0, Words1);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Dst + X * 4), _mm256_permutevar8x32_epi32(Bytes, Order));
+	}
+	RemapRow_SSE41(Src, Stride, Table + X, Dst + X * 4, Width - X);
+}
+
+#endif // DMSSIM_LENS_REMAP_X86
+
+bool IsSameCamera(const DMSSimCameraIntrinsics& A, const DMSSimCameraIntrinsics& B) {
+	return A.FocalLength == B.FocalLength && A.Cx == B.Cx && A.Cy == B.Cy && A.Width == B.Width && A.Mirrored == B.Mirrored &&
+		A.K1 == B.K1 && A.K2 == B.K2 && A.P1 == B.P1 && A.P2 == B.P2 && A.K3 == B.K3;
+}
+
+} // anonymous namespace
+
+DMSSimLensRemap::DMSSimLensRemap(const DMSSimCameraIntrinsics& Intrinsics, const size_t Width, const size_t Height) :
+	Intrinsics_(Intrinsics),
+	Width_(Width),
+	Height_(Height),
+	Table_(Width * Height)
+{
+	const double MaxX = double(Width - 1);
+	const double MaxY = double(Height - 1);
+	ParallelFor(int32(Height), [&](int32 Y) {
+		for (size_t X = 0; X < Width; ++X) {
+			Entry& Cell = Table_[Y * Width + X];
+			Cell = {};
+			const FVector2D Source = DMSSimLandmarkProjection::UndistortPixel(Intrinsics, FVector2D(float(X), float(Y)));
+			if (!(Source.X >= 0.0 && Source.Y >= 0.0 && Source.X <= MaxX && Source.Y <= MaxY)) { continue; }
+			const int64_t FixedX = std::llround(Source.X * FRACTION_ONE);
+			const int64_t FixedY = std::llround(Source.Y * FRACTION_ONE);
+			// the right and bottom pixels are always read, the last column and row are interpolated from the one before with the full weight
+			const int64_t X0 = FMath::Min(FixedX >> REMAP_FRACTION_BITS, int64_t(Width - 2));
+			const int64_t Y0 = FMath::Min(FixedY >> REMAP_FRACTION_BITS, int64_t(Height - 2));
+			Cell.Offset = int32_t(Y0 * int64_t(Width) + X0);
+			Cell.FractionX = uint8_t(FixedX - (X0 << REMAP_FRACTION_BITS));
+			Cell.FractionY = uint8_t(FixedY - (Y0 << REMAP_FRACTION_BITS));
+			Cell.Valid = 1;
+		}
+	});
+}
+
+TSharedPtr<const DMSSimLensRemap> DMSSimLensRemap::Get(const DMSSimCameraIntrinsics& Intrinsics, const size_t Width, const size_t Height) {
+	static std::mutex Mutex;
+	static TSharedPtr<const DMSSimLensRemap> Last;
+	if (!Intrinsics.Distorted || Width < 2 || Height < 2) { return nullptr; }
+	std::lock_guard<std::mutex> Lock(Mutex);
+	if (!Last || !Last->IsFor(Intrinsics, Width, Height)) { Last = MakeShared<const DMSSimLensRemap, ESPMode::ThreadSafe>(Intrinsics, Width, Height); }
+	return Last;
+}
+
+bool DMSSimLensRemap::IsFor(const DMSSimCameraIntrinsics& Intrinsics, const size_t Width, const size_t Height) const {
+	return Width == Width_ && Height == Height_ && IsSameCamera(Intrinsics, Intrinsics_);
+}
+
+void DMSSimLensRemap::RemapRows(const FColor* const Src, FColor* const Dst, const size_t RowBegin, const size_t RowEnd, const SimdLevel Level) const {
+	const uint8_t* const SrcBytes = reinterpret_cast<const uint8_t*>(Src);
+	const size_t Stride = Width_ * 4;
+	for (size_t Y = RowBegin; Y < RowEnd; ++Y) {
+		uint8_t* const Row = reinterpret_cast<uint8_t*>(Dst + Y * Width_);
+		const Entry* const Table = Table_.data() + Y * Width_;
+#if DMSSIM_LENS_REMAP_X86
+		if (Level == SimdLevel::AVX2) { RemapRow_AVX2(SrcBytes, Stride, Table, Row, Width_); continue; }
+		if (Level == SimdLevel::SSE41) { RemapRow_SSE41(SrcBytes, Stride, Table, Row, Width_); continue; }
+#endif
+		RemapRow_Scalar(SrcBytes, Stride, Table, Row, 0, Width_);
+	}
+}
+
+void DMSSimLensRemap::Remap(const TArray<FColor>& Src, TArray<FColor>& Dst) const {
+	Dst.SetNumUninitialized(int32(Width_ * Height_));
+	if (Src.Num() < int64(Width_ * Height_)) {
+		std::memset(Dst.GetData(), 0, Dst.Num() * sizeof(FColor));
+		return;
+	}
+	const int32 NumTiles = int32((Height_ + REMAP_TILE_ROWS - 1) / REMAP_TILE_ROWS);
+	ParallelFor(NumTiles, [&](int32 Tile) {
+		const size_t RowBegin = Tile * REMAP_TILE_ROWS;
+		RemapRows(Src.GetData(), Dst.GetData(), RowBegin, FMath::Min(RowBegin + REMAP_TILE_ROWS, Height_));
+	});
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "DMSSimLandmarkProjection.h"
+#include "DMSSimPixelConversion.h"
+
+/**
+ * @class DMSSimLensRemap
+ * @brief Applies the lens distortion of the camera to the rendered pinhole frames, so the images match the distorted 2D labels.
+ * The lookup table is computed once per camera: for every pixel of the distorted image, the offset of the top left of the 2x2 pinhole
+ * pixels it's interpolated from and the fixed point fractions of the bilinear weights (REMAP_FRACTION_BITS per axis).
+ * Pixels that come from outside the rendered frame are black with 0 alpha.
+ *
+ * The remap processes the rows [RowBegin, RowEnd) only, so a frame can be split into row tiles and remapped by several threads.
+ * Like DMSSimPixelConversion, it has scalar, SSE4.1 and AVX2 implementations which produce identical results.
+ */
+class DMSSimLensRemap
+{
+public:
+	static constexpr int    REMAP_FRACTION_BITS = 7; // 1/128 pixel, the weights of a pixel add up to 1 << 14
+	static constexpr size_t REMAP_TILE_ROWS = 64;
+
+	/** @param Intrinsics The intrinsics of the camera for frames of Width x Height, both at least 2 */
+	DMSSimLensRemap(const DMSSimCameraIntrinsics& Intrinsics, size_t Width, size_t Height);
+
+	/**
+	 * The table of the camera, the one of the previous call if the camera didn't change, so the scenarios of a camera share it.
+	 * nullptr if the camera has no distortion.
+	 */
+	static TSharedPtr<const DMSSimLensRemap> Get(const DMSSimCameraIntrinsics& Intrinsics, size_t Width, size_t Height);
+
+	size_t GetWidth() const { return Width_; }
+	size_t GetHeight() const { return Height_; }
+
+	/** Remaps the rows [RowBegin, RowEnd) of Dst, both frames are BGRA with Width x Height pixels and no padding. */
+	void RemapRows(const FColor* Src, FColor* Dst, size_t RowBegin, size_t RowEnd, DMSSimPixelConversion::SimdLevel Level = DMSSimPixelConversion::GetSupportedSimdLevel()) const;
+
+	/** Remaps the frame in row tiles of REMAP_TILE_ROWS with ParallelFor, Dst is resized to the frame. */
+	void Remap(const TArray<FColor>& Src, TArray<FColor>& Dst) const;
+
+	/** The camera and frame size the table was computed for. */
+	bool IsFor(const DMSSimCameraIntrinsics& Intrinsics, size_t Width, size_t Height) const;
+
+	/** The source pixel of a table entry in REMAP_FRACTION_BITS fixed point, for the tests. */
+	struct Entry {
+		int32_t Offset;   // of the top left pixel
+		uint8_t FractionX;
+		uint8_t FractionY;
+		uint8_t Valid;    // 0 - outside of the rendered frame, all weights are 0
+		uint8_t Padding;
+	};
+	const Entry& GetEntry(size_t X, size_t Y) const { return Table_[Y * Width_ + X]; }
+
+private:
+	DMSSimCameraIntrinsics Intrinsics_;
+	size_t                 Width_;
+	size_t                 Height_;
+	std::vector<Entry>     Table_;
+};
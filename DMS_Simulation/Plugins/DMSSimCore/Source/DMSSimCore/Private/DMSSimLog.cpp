@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <chrono>
 #include <ctime>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <mutex>
@@ -95,7 +96,7 @@ void InitLogFile() {
 		PlatformFile->MoveFile(FileName.c_str(), CurrentLogPath.c_str());
 	}
 	CurrentLogPath = FileName;
-	LogFile.open(FileName, std::ios::app);
+	LogFile.open(std::filesystem::path(FileName), std::ios::app);
 }
 
 void WriteLogMessage(std::ostream& Stream, const char* Type, const char* Time, const std::string& Message) { Stream << std::setw(10) << std::left << Type << Time << ": " << Message << std::endl; }
@@ -5,6 +5,7 @@
 #include <cassert>
 #include <string>
 #include <sstream>
+#include <stdexcept>
 #include <vector>
 
 namespace DMSSimMontageBuilder
@@ -236,14 +237,14 @@ bool AddMontageSlotSegmentAnimation(
 	const char* AnimationPath = FindAnimation(AssetRegistry, AnimationName.c_str());
 	if (!AnimationPath)
 	{
-		throw std::exception((std::string("Animation ") + AnimationName + " not found!").c_str());
+		throw std::runtime_error((std::string("Animation ") + AnimationName + " not found!").c_str());
 	}
 
 	bool ExactMatch = false;
 	UAnimSequenceBase* const AnimSequence = Environment.LoadAnimationSequence(TargetChannel, AnimationName.c_str(), AnimationPath, &ExactMatch);
 	if (!AnimSequence)
 	{
-		throw std::exception((std::string("Failed to load ") + AnimationName + " animation sequence!").c_str());
+		throw std::runtime_error((std::string("Failed to load ") + AnimationName + " animation sequence!").c_str());
 	}
 
 	const float AnimLength = AnimSequence->GetPlayLength();
@@ -382,7 +383,7 @@ bool BuildParametricAnimationMontage(
 
 	if (TargetChannel == DMSSimAnimationChannelCommon || !CommonChannel)
 	{
-		throw std::exception((std::string("Common channel cannot contain parametric animations. Animation - ") + AnimationName + ".").c_str());
+		throw std::runtime_error((std::string("Common channel cannot contain parametric animations. Animation - ") + AnimationName + ".").c_str());
 	}
 
 	struct
@@ -410,7 +411,7 @@ bool BuildParametricAnimationMontage(
 
 	if (!ChannelMatched)
 	{
-		throw std::exception((std::string(AnimationName) + " does not match the target channel").c_str());
+		throw std::runtime_error((std::string(AnimationName) + " does not match the target channel").c_str());
 	}
 
 	auto& Curve = MontageInfo.Curve;
@@ -499,7 +500,7 @@ bool BuildAnimationMontage(
 
 	if (TargetChannel == DMSSimAnimationChannelSteeringWheel)
 	{
-		throw std::exception("Steering Wheel channel doesn't support recorded animations!");
+		throw std::runtime_error("Steering Wheel channel doesn't support recorded animations!");
 	}
 
 	bool Result = true;
@@ -624,7 +625,7 @@ bool BuildPurePassivePauseMontage(
 
 	if (TargetChannel == DMSSimAnimationChannelSteeringWheel)
 	{
-		throw std::exception("Steering Wheel animation channel starting with a passive pause is not supported!");
+		throw std::runtime_error("Steering Wheel animation channel starting with a passive pause is not supported!");
 	}
 
 	UAnimMontage* const Montage = Environment.CreateMontage();
@@ -637,7 +638,7 @@ bool BuildPurePassivePauseMontage(
 
 	if (Time < 0.0)
 	{
-		throw std::exception("Negative passive pause duration!");
+		throw std::runtime_error("Negative passive pause duration!");
 	}
 
 	TimeFull = Time;
@@ -822,11 +823,11 @@ bool BuildInternal(
 			switch (Channel.GetType())
 			{
 			case DMSSimAnimationChannelCommon:
-				throw std::exception("Common channel cannot contain active pauses.");
+				throw std::runtime_error("Common channel cannot contain active pauses.");
 				break;
 
 			case DMSSimAnimationChannelSteeringWheel:
-				throw std::exception("Steering Wheel channel can contain only compatible animations.");
+				throw std::runtime_error("Steering Wheel channel can contain only compatible animations.");
 				break;
 			default:
 				break;
@@ -863,14 +864,14 @@ bool BuildInternal(
 		case DMSSimMotionPauseActive:
 			if (!CommonChannel)
 			{
-				throw std::exception("Active pauses require the common channel!");
+				throw std::runtime_error("Active pauses require the common channel!");
 			}
 			else
 			{
 				const float PauseDuration = Motion.GetDuration();
 				if (PauseDuration < 0.0)
 				{
-					throw std::exception("Negative active pause duration!");
+					throw std::runtime_error("Negative active pause duration!");
 				}
 
 				TArray<TMontage> NewMontageList;
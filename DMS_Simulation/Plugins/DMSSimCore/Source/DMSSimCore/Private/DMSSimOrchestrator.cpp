@@ -2,6 +2,7 @@
 #include "DMSSimConstants.h"
 #include <cassert>
 #include <regex>
+#include <stdexcept>
 
 int DMSSimOrchestrator::FindAssetIndex(const DMSSimResourceSet& ResourceSet, const char* const Name) {
 	if (Name == nullptr) { return 0; }
@@ -22,7 +23,7 @@ int DMSSimOrchestrator::FindAssetIndex(const DMSSimResourceSet& ResourceSet, con
 			}
 		}
 	}
-	throw std::exception((std::string("Could not find asset \"") + Name + "\"!").c_str());
+	throw std::runtime_error((std::string("Could not find asset \"") + Name + "\"!").c_str());
 	return 0;
 }
 
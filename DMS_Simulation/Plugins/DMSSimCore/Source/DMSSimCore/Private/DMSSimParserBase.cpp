@@ -2,10 +2,18 @@
 #include "DMSSimYamlObj.h"
 #include <algorithm>
 #include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <functional>
 #include <regex>
 #include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 
 using namespace DMSSimParserBaseHelpers;
@@ -24,45 +32,47 @@ namespace {
 
 	std::string& Trim(std::string& s) { return LTrim(RTrim(s)); }
 
-	bool CheckEndOfScenario(const std::string& Text, size_t LineIndex) {
-		size_t StartPos = 0;
-		for (size_t i = 0; i < LineIndex; ++i) {
-			StartPos = Text.find('\n', StartPos);
-			if (StartPos == std::string::npos) { return false; }
-			++StartPos;
+	/** Start offsets of the lines of a buffer, built once per parse so the lines are found without rescanning the buffer. */
+	class LineIndex {
+	public:
+		explicit LineIndex(const std::string& Text) : Text_(Text) {
+			LineStarts_.push_back(0);
+			const char* const Begin = Text.data();
+			const char* const End = Begin + Text.size();
+			for (const char* Pos = Begin; (Pos = static_cast<const char*>(memchr(Pos, '\n', End - Pos))) != nullptr;) { LineStarts_.push_back(++Pos - Begin); }
 		}
 
-		for (;;) {
-			size_t NextPos = Text.find('\n', StartPos);
-			std::string Line = Text.substr(StartPos, (NextPos != std::string::npos) ? (NextPos - StartPos) : std::string::npos);
+		size_t GetLineCount() const { return LineStarts_.size(); }
 
-			const size_t CommentStart = Line.find('#');
-			if (CommentStart != std::string::npos) { Line = Line.substr(0, CommentStart); }
+		/** The line without its line break, LineIndex must be less than GetLineCount(). */
+		std::string_view GetLine(const size_t LineIndex) const {
+			const size_t Start = LineStarts_[LineIndex];
+			const size_t End = (LineIndex + 1 < LineStarts_.size()) ? LineStarts_[LineIndex + 1] - 1 : Text_.size();
+			return std::string_view(Text_).substr(Start, End - Start);
+		}
 
-			Trim(Line);
+	private:
+		const std::string&  Text_;
+		std::vector<size_t> LineStarts_;
+	};
 
-			if (!Line.empty())
-				return false;
+	std::string_view StripComment(std::string_view Line) {
+		const size_t CommentStart = Line.find('#');
+		return (CommentStart != std::string_view::npos) ? Line.substr(0, CommentStart) : Line;
+	}
 
-			if (NextPos == std::string::npos) { break; }
-			StartPos = NextPos;
-			++StartPos;
+	bool CheckEndOfScenario(const LineIndex& Lines, size_t LineIndex) {
+		if (LineIndex >= Lines.GetLineCount()) { return false; }
+		for (; LineIndex < Lines.GetLineCount(); ++LineIndex) {
+			const auto Line = StripComment(Lines.GetLine(LineIndex));
+			if (!std::all_of(Line.begin(), Line.end(), [](const char C) { return std::isspace(static_cast<unsigned char>(C)); })) { return false; }
 		}
 		return true;
 	}
 
-	std::string ExtractLineSubstring(const std::string& Text, size_t LineIndex, size_t Column, size_t MaxLen) {
-		std::string Result;
-		size_t StartPos = 0;
-		for (size_t i = 0; i < LineIndex; ++i) {
-			StartPos = Text.find('\n', StartPos);
-			if (StartPos == std::string::npos) { return Result; }
-			++StartPos;
-		}
-		const size_t EndPos = Text.find('\n', StartPos + 1);
-		Result = (EndPos != std::string::npos) ? Text.substr(StartPos, EndPos - StartPos) : Text.substr(StartPos);
-		const size_t CommentStart = Result.find('#');
-		if (CommentStart != std::string::npos) { Result = Result.substr(0, CommentStart); }
+	std::string ExtractLineSubstring(const LineIndex& Lines, size_t LineIndex, size_t Column, size_t MaxLen) {
+		if (LineIndex >= Lines.GetLineCount()) { return std::string(); }
+		std::string Result(StripComment(Lines.GetLine(LineIndex)));
 		Trim(Result);
 		if (Column < Result.length()) {
 			while (Column > 0) {
@@ -80,10 +90,14 @@ namespace {
 	template <class TNumber>
 	TNumber ParseNumber(const yaml_event_t* const Event, const yaml_char_t* const StrY, const char* const Name) {
 		const auto Str = reinterpret_cast<const char*>(StrY);
-		std::istringstream NumberStream(Str);
+		const char* const End = Str + strlen(Str);
+		// from_chars doesn't take the plus sign of the stream extraction, and it takes inf and nan, which the stream doesn't
+		const char* const Begin = (Str[0] == '+' && Str[1] != '-') ? Str + 1 : Str;
 		TNumber Value = 0;
-		NumberStream >> std::noskipws >> Value;
-		if (!NumberStream.eof() || NumberStream.fail()) {
+		const auto Result = std::from_chars(Begin, End, Value);
+		bool Valid = Begin != End && Result.ec == std::errc() && Result.ptr == End;
+		if constexpr (std::is_floating_point<TNumber>::value) { Valid = Valid && std::isfinite(Value); }
+		if (!Valid) {
 			std::string Message("Invalid number format of ");
 			Message += Name;
 			Message += ": ";
@@ -115,7 +129,7 @@ namespace {
 	}
 
 	std::string LoadFile(const wchar_t* FileName) {
-		std::ifstream File(FileName);
+		std::ifstream File{ std::filesystem::path(FileName) };
 		std::string Content((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
 		return Content;
 	}
@@ -126,12 +140,13 @@ namespace {
 	}
 } // anonymous namespace
 
-bool DMSSimParserBase::InitializeInternal(const wchar_t* const FilePath) {
+bool DMSSimParserBase::InitializeInternal(const wchar_t* const FilePath) { return InitializeInternal(LoadFile(FilePath)); }
+
+bool DMSSimParserBase::InitializeInternal(const std::string& ScenarioStr) {
 	assert(YamlObjStack_.size() == 0);
-	const std::string ScenarioStr = LoadFile(FilePath);
-	if (ScenarioStr.empty()) { throw std::exception("failed to load scenario"); }
+	if (ScenarioStr.empty()) { throw std::runtime_error("failed to load scenario"); }
 
-	const size_t NumberOfLines = std::count(ScenarioStr.begin(), ScenarioStr.end(), '\n') + 1;
+	const LineIndex Lines(ScenarioStr);
 	yaml_parser_t Parser = {};
 	yaml_parser_initialize(&Parser);
 	yaml_parser_set_input_string(&Parser, (unsigned char*)ScenarioStr.c_str(), ScenarioStr.length());
@@ -148,13 +163,13 @@ bool DMSSimParserBase::InitializeInternal(const wchar_t* const FilePath) {
 
 		if (!Status || Event.type == YAML_NO_EVENT) {
 			const size_t PrevLine = PrevEndMark.line;
-			if ((PrevLine + 1) < NumberOfLines && !CheckEndOfScenario(ScenarioStr, PrevLine + 1)) {
+			if ((PrevLine + 1) < Lines.GetLineCount() && !CheckEndOfScenario(Lines, PrevLine + 1)) {
 				std::stringstream ErrorMessage;
 				ErrorMessage << "Line " << (PrevLine + 1) << ": ";
 				ErrorMessage << "Yaml syntax error after ";
-				const auto LineExample = ExtractLineSubstring(ScenarioStr, PrevLine, PrevEndMark.column, 12);
+				const auto LineExample = ExtractLineSubstring(Lines, PrevLine, PrevEndMark.column, 12);
 				if (!LineExample.empty()) { ErrorMessage << LineExample << "..."; }
-				throw std::exception(ErrorMessage.str().c_str());
+				throw std::runtime_error(ErrorMessage.str().c_str());
 			}
 			break;
 		}
@@ -258,12 +273,12 @@ void ThrowExceptionWithLineN_Internal(const char* const Text, const yaml_mark_t&
 	TextStr += std::to_string(StartMark.line + 1);
 	TextStr += ": ";
 	TextStr += Text;
-	throw std::exception(TextStr.c_str());
+	throw std::runtime_error(TextStr.c_str());
 }
 
 void ThrowExceptionWithLineN(const char* const Text, const yaml_event_t* const Event) {
 	if (Event) { ThrowExceptionWithLineN_Internal(Text, Event->start_mark); }
-	throw std::exception(Text);
+	throw std::runtime_error(Text);
 }
 
 } // DMSSimParserBaseHelpers namespace
\ No newline at end of file
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <stack>
+#include <string>
 #include <vector>
 #include <Math/Rotator.h>
 #include <Math/Vector.h>
@@ -21,6 +25,53 @@ struct DMSSimParserVector {
 	yaml_mark_t        Mark_ = {};
 };
 
+/**
+ * @class DMSSimEventHandlerIndex
+ * @brief Lookup of the event handlers of a parser by name, built at compile time from its handler table.
+ * The names are keyed by their length and FNV-1a hash and sorted by the key, so a lookup is one pass over the name,
+ * a binary search of the keys and a single strcmp to confirm the handler.
+ */
+template <int Count>
+class DMSSimEventHandlerIndex {
+public:
+	template <class TEventHandlerInfo>
+	constexpr explicit DMSSimEventHandlerIndex(TEventHandlerInfo (&Handlers)[Count]) {
+		for (int i = 0; i < Count; ++i) {
+			const uint64_t Key = GetKey(Handlers[i].Name);
+			int j = i;
+			for (; j > 0 && Keys_[j - 1] > Key; --j) {
+				Keys_[j] = Keys_[j - 1];
+				Indices_[j] = Indices_[j - 1];
+			}
+			Keys_[j] = Key;
+			Indices_[j] = i;
+		}
+	}
+
+	/** Length of the name in the upper 32 bits, its FNV-1a hash in the lower ones. */
+	static constexpr uint64_t GetKey(const char* const Name) {
+		uint32_t Hash = 2166136261u;
+		uint32_t Length = 0;
+		for (; Name[Length] != '\0'; ++Length) { Hash = (Hash ^ uint8_t(Name[Length])) * 16777619u; }
+		return (uint64_t(Length) << 32) | Hash;
+	}
+
+	/** Position of the handler in the table, -1 if there is no handler of that name. */
+	template <class TEventHandlerInfo>
+	int Find(const char* const Name, TEventHandlerInfo (&Handlers)[Count]) const {
+		const uint64_t Key = GetKey(Name);
+		for (auto It = std::lower_bound(Keys_, Keys_ + Count, Key); It != Keys_ + Count && *It == Key; ++It) {
+			const int Index = Indices_[It - Keys_];
+			if (strcmp(Handlers[Index].Name, Name) == 0) { return Index; }
+		}
+		return -1;
+	}
+
+private:
+	uint64_t Keys_[Count] = {};
+	int      Indices_[Count] = {};
+};
+
 /**
  * @class DMSSimParserBase
  * @brief Parent class for YAML parsers
@@ -41,21 +92,20 @@ protected:
 	static int ParseIntEx(const yaml_event_t* Event, const yaml_char_t* StrY, const char* Name, int MinValue, int MaxValue);
 
 	bool InitializeInternal(const wchar_t* const FilePath);
+	bool InitializeInternal(const std::string& ScenarioStr);
 	virtual const char* FindFunction(const yaml_event_t& Event) const = 0;
 	virtual YamlObj* ProcessEvent(const char* FuncName, const yaml_event_t& Event, YamlObj* Obj, bool Enter) = 0;
 
 	template <class TEventHandlerInfo, int Count>
-	static TEventHandlerInfo* FindEventHandler(const char* const EventName, TEventHandlerInfo (&Handlers)[Count]) {
-		for (const auto& Info : Handlers) {
-			if (strcmp(Info.Name, EventName) == 0) { return &Info; }
-		}
-		return nullptr;
+	static TEventHandlerInfo* FindEventHandler(const char* const EventName, TEventHandlerInfo (&Handlers)[Count], const DMSSimEventHandlerIndex<Count>& Index) {
+		const int Found = Index.Find(EventName, Handlers);
+		return Found >= 0 ? &Handlers[Found] : nullptr;
 	}
 
 	template <class TEventHandlerInfo, int Count>
-	static TEventHandlerInfo* FindEventHandlerEx(const yaml_event_t& Event, TEventHandlerInfo(&Handlers)[Count]) {
+	static TEventHandlerInfo* FindEventHandlerEx(const yaml_event_t& Event, TEventHandlerInfo(&Handlers)[Count], const DMSSimEventHandlerIndex<Count>& Index) {
 		const char* const EventName = reinterpret_cast<const char*>(Event.data.scalar.value);
-		const auto* Handler = FindEventHandler(EventName, Handlers);
+		const auto* Handler = FindEventHandler(EventName, Handlers, Index);
 		if (Handler) { return Handler; }
 		DMSSimParserBaseHelpers::ThrowExceptionWithLineN((std::string("Invalid property [") + EventName + "]").c_str(), &Event);
 		return nullptr;
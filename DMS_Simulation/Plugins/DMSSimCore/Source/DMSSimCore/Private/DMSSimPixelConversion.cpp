@@ -0,0 +1,362 @@
+#include "DMSSimPixelConversion.h"
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define DMSSIM_PIXEL_CONVERSION_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define DMSSIM_TARGET_SSE41
+#define DMSSIM_TARGET_AVX2
+#else
+#define DMSSIM_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define DMSSIM_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define DMSSIM_PIXEL_CONVERSION_X86 0
+#endif
+
+namespace DMSSimPixelConversion {
+namespace {
+
+constexpr int FIXED_POINT_SHIFT = 15;
+constexpr int32_t ROUNDING = 1 << (FIXED_POINT_SHIFT - 1);
+
+// Full range luma, the coefficients sum up to 1 << 15
+constexpr int32_t FULL_RY = 9798;
+constexpr int32_t FULL_GY = 19234;
+constexpr int32_t FULL_BY = 3736;
+
+// Limited range BT.601
+constexpr int32_t RY = 8414;
+constexpr int32_t GY = 16519;
+constexpr int32_t BY = 3208;
+constexpr int32_t RU = -4857;
+constexpr int32_t GU = -9535;
+constexpr int32_t BU = 14392;
+constexpr int32_t RV = 14392;
+constexpr int32_t GV = -12051;
+constexpr int32_t BV = -2341;
+
+constexpr int32_t Y_BIAS = (16 << FIXED_POINT_SHIFT) + ROUNDING;
+// chroma is computed from the sum of 4 pixels, hence 2 extra bits of the shift
+constexpr int CHROMA_SHIFT = FIXED_POINT_SHIFT + 2;
+constexpr int32_t CHROMA_BIAS = (128 << CHROMA_SHIFT) + (1 << (CHROMA_SHIFT - 1));
+
+enum { B = 0, G = 1, R = 2 };
+
+inline int32_t FullLuma(const uint8_t* Pixel) { return FULL_RY * Pixel[R] + FULL_GY * Pixel[G] + FULL_BY * Pixel[B]; }
+
+inline uint8_t Gray8(const uint8_t* Pixel) { return uint8_t((FullLuma(Pixel) + ROUNDING) >> FIXED_POINT_SHIFT); }
+
+inline uint16_t Gray16(const uint8_t* Pixel) { return uint16_t((FullLuma(Pixel) * 257 + ROUNDING) >> FIXED_POINT_SHIFT); }
+
+inline uint8_t LimitedLuma(const uint8_t* Pixel) { return uint8_t((RY * Pixel[R] + GY * Pixel[G] + BY * Pixel[B] + Y_BIAS) >> FIXED_POINT_SHIFT); }
+
+inline void StoreGray16(uint8_t* Dst, uint16_t Value) {
+	Dst[0] = uint8_t(Value & 0xff);
+	Dst[1] = uint8_t(Value >> 8);
+}
+
+void Gray8Row_Scalar(const uint8_t* Src, uint8_t* Dst, size_t Begin, size_t End) {
+	for (size_t X = Begin; X < End; ++X) { Dst[X] = Gray8(Src + X * 4); }
+}
+
+void Gray16Row_Scalar(const uint8_t* Src, uint8_t* Dst, size_t Begin, size_t End) {
+	for (size_t X = Begin; X < End; ++X) { StoreGray16(Dst + X * 2, Gray16(Src + X * 4)); }
+}
+
+void LumaRow_Scalar(const uint8_t* Src, uint8_t* Dst, size_t Begin, size_t End) {
+	for (size_t X = Begin; X < End; ++X) { Dst[X] = LimitedLuma(Src + X * 4); }
+}
+
+/** Chroma samples [Begin, End) from two source rows; Width is the width of the rows in pixels. */
+void ChromaRow_Scalar(const uint8_t* Src0, const uint8_t* Src1, uint8_t* DstU, uint8_t* DstV, size_t Width, size_t Begin, size_t End) {
+	for (size_t X = Begin; X < End; ++X) {
+		const size_t X0 = X * 2;
+		const size_t X1 = (X0 + 1 < Width) ? X0 + 1 : X0;
+		const int32_t SumB = Src0[X0 * 4 + B] + Src0[X1 * 4 + B] + Src1[X0 * 4 + B] + Src1[X1 * 4 + B];
+		const int32_t SumG = Src0[X0 * 4 + G] + Src0[X1 * 4 + G] + Src1[X0 * 4 + G] + Src1[X1 * 4 + G];
+		const int32_t SumR = Src0[X0 * 4 + R] + Src0[X1 * 4 + R] + Src1[X0 * 4 + R] + Src1[X1 * 4 + R];
+		DstU[X] = uint8_t((RU * SumR + GU * SumG + BU * SumB + CHROMA_BIAS) >> CHROMA_SHIFT);
+		DstV[X] = uint8_t((RV * SumR + GV * SumG + BV * SumB + CHROMA_BIAS) >> CHROMA_SHIFT);
+	}
+}
+
+#if DMSSIM_PIXEL_CONVERSION_X86
+
+/** Weighted sums of 4 BGRA pixels, the weights are in the 16 bit pairs of Coefs: (B, G), (R, 0). */
+DMSSIM_TARGET_SSE41 inline __m128i WeightedSum4_SSE41(const uint8_t* Src, __m128i Coefs) {
+	const __m128i Pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src));
+	const __m128i Lo = _mm_madd_epi16(_mm_cvtepu8_epi16(Pixels), Coefs);
+	const __m128i Hi = _mm_madd_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(Pixels, 8)), Coefs);
+	return _mm_hadd_epi32(Lo, Hi);
+}
+
+DMSSIM_TARGET_SSE41 inline __m128i MakeCoefs_SSE41(int32_t CoefR, int32_t CoefG, int32_t CoefB) {
+	return _mm_setr_epi16(int16_t(CoefB), int16_t(CoefG), int16_t(CoefR), 0, int16_t(CoefB), int16_t(CoefG), int16_t(CoefR), 0);
+}
+
+/** Converts 16 pixels to 8 bit luma with the given coefficients and bias. */
+DMSSIM_TARGET_SSE41 inline void Luma16_SSE41(const uint8_t* Src, uint8_t* Dst, __m128i Coefs, __m128i Bias) {
+	__m128i Sums[4];
+	for (int I = 0; I < 4; ++I) { Sums[I] = _mm_srai_epi32(_mm_add_epi32(WeightedSum4_SSE41(Src + I * 16, Coefs), Bias), FIXED_POINT_SHIFT); }
+	const __m128i Words0 = _mm_packs_epi32(Sums[0], Sums[1]);
+	const __m128i Words1 = _mm_packs_epi32(Sums[2], Sums[3]);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst), _mm_packus_epi16(Words0, Words1));
+}
+
+DMSSIM_TARGET_SSE41 void Gray8Row_SSE41(const uint8_t* Src, uint8_t* Dst, size_t Width) {
+	const __m128i Coefs = MakeCoefs_SSE41(FULL_RY, FULL_GY, FULL_BY);
+	const __m128i Bias = _mm_set1_epi32(ROUNDING);
+	size_t X = 0;
+	for (; X + 16 <= Width; X += 16) { Luma16_SSE41(Src + X * 4, Dst + X, Coefs, Bias); }
+	Gray8Row_Scalar(Src, Dst, X, Width);
+}
+
+DMSSIM_TARGET_SSE41 void Gray16Row_SSE41(const uint8_t* Src, uint8_t* Dst, size_t Width) {
+	const __m128i Coefs = MakeCoefs_SSE41(FULL_RY, FULL_GY, FULL_BY);
+	const __m128i Bias = _mm_set1_epi32(ROUNDING);
+	const __m128i Scale = _mm_set1_epi32(257);
+	size_t X = 0;
+	for (; X + 8 <= Width; X += 8) {
+		const __m128i Sum0 = _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(WeightedSum4_SSE41(Src + X * 4, Coefs), Scale), Bias), FIXED_POINT_SHIFT);
+		const __m128i Sum1 = _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(WeightedSum4_SSE41(Src + X * 4 + 16, Coefs), Scale), Bias), FIXED_POINT_SHIFT);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + X * 2), _mm_packus_epi32(Sum0, Sum1));
+	}
+	Gray16Row_Scalar(Src, Dst, X, Width);
+}
+
+DMSSIM_TARGET_SSE41 void LumaRow_SSE41(const uint8_t* Src, uint8_t* Dst, size_t Width) {
+	const __m128i Coefs = MakeCoefs_SSE41(RY, GY, BY);
+	const __m128i Bias = _mm_set1_epi32(Y_BIAS);
+	size_t X = 0;
+	for (; X + 16 <= Width; X += 16) { Luma16_SSE41(Src + X * 4, Dst + X, Coefs, Bias); }
+	LumaRow_Scalar(Src, Dst, X, Width);
+}
+
+/** Per channel sums of the 2x2 blocks of 4 pixels (8 source pixels of two rows): B0 G0 R0 A0 B1 G1 R1 A1. */
+DMSSIM_TARGET_SSE41 inline __m128i BlockSums2_SSE41(const uint8_t* Src0, const uint8_t* Src1) {
+	const __m128i Row0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src0));
+	const __m128i Row1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src1));
+	const __m128i Lo = _mm_add_epi16(_mm_cvtepu8_epi16(Row0), _mm_cvtepu8_epi16(Row1));
+	const __m128i Hi = _mm_add_epi16(_mm_cvtepu8_epi16(_mm_srli_si128(Row0, 8)), _mm_cvtepu8_epi16(_mm_srli_si128(Row1, 8)));
+	return _mm_unpacklo_epi64(_mm_add_epi16(Lo, _mm_srli_si128(Lo, 8)), _mm_add_epi16(Hi, _mm_srli_si128(Hi, 8)));
+}
+
+DMSSIM_TARGET_SSE41 void ChromaRow_SSE41(const uint8_t* Src0, const uint8_t* Src1, uint8_t* DstU, uint8_t* DstV, size_t Width) {
+	const __m128i CoefsU = MakeCoefs_SSE41(RU, GU, BU);
+	const __m128i CoefsV = MakeCoefs_SSE41(RV, GV, BV);
+	const __m128i Bias = _mm_set1_epi32(CHROMA_BIAS);
+	const size_t ChromaWidth = (Width + 1) / 2;
+	size_t X = 0;
+	// 8 source pixels -> 4 chroma samples
+	for (; X * 2 + 8 <= Width; X += 4) {
+		const __m128i Sums01 = BlockSums2_SSE41(Src0 + X * 8, Src1 + X * 8);
+		const __m128i Sums23 = BlockSums2_SSE41(Src0 + X * 8 + 16, Src1 + X * 8 + 16);
+		const __m128i U = _mm_srai_epi32(_mm_add_epi32(_mm_hadd_epi32(_mm_madd_epi16(Sums01, CoefsU), _mm_madd_epi16(Sums23, CoefsU)), Bias), CHROMA_SHIFT);
+		const __m128i V = _mm_srai_epi32(_mm_add_epi32(_mm_hadd_epi32(_mm_madd_epi16(Sums01, CoefsV), _mm_madd_epi16(Sums23, CoefsV)), Bias), CHROMA_SHIFT);
+		const __m128i Bytes = _mm_packus_epi16(_mm_packs_epi32(U, V), _mm_setzero_si128());
+		const int32_t BytesU = _mm_cvtsi128_si32(Bytes);
+		const int32_t BytesV = _mm_extract_epi32(Bytes, 1);
+		memcpy(DstU + X, &BytesU, 4);
+		memcpy(DstV + X, &BytesV, 4);
+	}
+	ChromaRow_Scalar(Src0, Src1, DstU, DstV, Width, X, ChromaWidth);
+}
+
+/** Weighted sums of 8 BGRA pixels in order, see WeightedSum4_SSE41. */
+DMSSIM_TARGET_AVX2 inline __m256i WeightedSum8_AVX2(const uint8_t* Src, __m256i Coefs) {
+	const __m256i Lo = _mm256_madd_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Src))), Coefs);
+	const __m256i Hi = _mm256_madd_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + 16))), Coefs);
+	// hadd works within 128 bit lanes: [0 1 4 5 | 2 3 6 7]
+	return _mm256_permute4x64_epi64(_mm256_hadd_epi32(Lo, Hi), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+DMSSIM_TARGET_AVX2 inline __m256i MakeCoefs_AVX2(int32_t CoefR, int32_t CoefG, int32_t CoefB) {
+	return _mm256_setr_epi16(int16_t(CoefB), int16_t(CoefG), int16_t(CoefR), 0, int16_t(CoefB), int16_t(CoefG), int16_t(CoefR), 0,
+		int16_t(CoefB), int16_t(CoefG), int16_t(CoefR), 0, int16_t(CoefB), int16_t(CoefG), int16_t(CoefR), 0);
+}
+
+/** Converts 16 pixels to 8 bit luma with the given coefficients and bias. */
+DMSSIM_TARGET_AVX2 inline void Luma16_AVX2(const uint8_t* Src, uint8_t* Dst, __m256i Coefs, __m256i Bias) {
+	const __m256i Sum0 = _mm256_srai_epi32(_mm256_add_epi32(WeightedSum8_AVX2(Src, Coefs), Bias), FIXED_POINT_SHIFT);
+	const __m256i Sum1 = _mm256_srai_epi32(_mm256_add_epi32(WeightedSum8_AVX2(Src + 32, Coefs), Bias), FIXED_POINT_SHIFT);
+	const __m256i Words = _mm256_permute4x64_epi64(_mm256_packs_epi32(Sum0, Sum1), _MM_SHUFFLE(3, 1, 2, 0));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst), _mm_packus_epi16(_mm256_castsi256_si128(Words), _mm256_extracti128_si256(Words, 1)));
+}
+
+DMSSIM_TARGET_AVX2 void Gray8Row_AVX2(const uint8_t* Src, uint8_t* Dst, size_t Width) {
+	const __m256i Coefs = MakeCoefs_AVX2(FULL_RY, FULL_GY, FULL_BY);
+	const __m256i Bias = _mm256_set1_epi32(ROUNDING);
+	size_t X = 0;
+	for (; X + 16 <= Width; X += 16) { Luma16_AVX2(Src + X * 4, Dst + X, Coefs, Bias); }
+	Gray8Row_Scalar(Src, Dst, X, Width);
+}
+
+DMSSIM_TARGET_AVX2 void Gray16Row_AVX2(const uint8_t* Src, uint8_t* Dst, size_t Width) {
+	const __m256i Coefs = MakeCoefs_AVX2(FULL_RY, FULL_GY, FULL_BY);
+	const __m256i Bias = _mm256_set1_epi32(ROUNDING);
+	const __m256i Scale = _mm256_set1_epi32(257);
+	size_t X = 0;
+	for (; X + 16 <= Width; X += 16) {
+		const __m256i Sum0 = _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(WeightedSum8_AVX2(Src + X * 4, Coefs), Scale), Bias), FIXED_POINT_SHIFT);
+		const __m256i Sum1 = _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(WeightedSum8_AVX2(Src + X * 4 + 32, Coefs), Scale), Bias), FIXED_POINT_SHIFT);
+		const __m256i Words = _mm256_permute4x64_epi64(_mm256_packus_epi32(Sum0, Sum1), _MM_SHUFFLE(3, 1, 2, 0));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(Dst + X * 2), Words);
+	}
+	Gray16Row_Scalar(Src, Dst, X, Width);
+}
+
+DMSSIM_TARGET_AVX2 void LumaRow_AVX2(const uint8_t* Src, uint8_t* Dst, size_t Width) {
+	const __m256i Coefs = MakeCoefs_AVX2(RY, GY, BY);
+	const __m256i Bias = _mm256_set1_epi32(Y_BIAS);
+	size_t X = 0;
+	for (; X + 16 <= Width; X += 16) { Luma16_AVX2(Src + X * 4, Dst + X, Coefs, Bias); }
+	LumaRow_Scalar(Src, Dst, X, Width);
+}
+
+/** Per channel sums of 4 2x2 blocks (16 source pixels of two rows), in the lane order [0 2 | 1 3]. */
+DMSSIM_TARGET_AVX2 inline __m256i BlockSums4_AVX2(const uint8_t* Src0, const uint8_t* Src1) {
+	const __m256i Sums0 = _mm256_add_epi16(
+		_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Src0))),
+		_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Src1))));
+	const __m256i Sums1 = _mm256_add_epi16(
+		_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Src0 + 16))),
+		_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Src1 + 16))));
+	return _mm256_unpacklo_epi64(_mm256_add_epi16(Sums0, _mm256_srli_si256(Sums0, 8)), _mm256_add_epi16(Sums1, _mm256_srli_si256(Sums1, 8)));
+}
+
+/** Computes 8 chroma samples from the block sums, the result is in 32 bit lanes in order. */
+DMSSIM_TARGET_AVX2 inline __m128i Chroma8_AVX2(__m256i Sums0123, __m256i Sums4567, __m256i Coefs, __m256i Bias) {
+	// [0 2 4 6 | 1 3 5 7]
+	const __m256i Values = _mm256_srai_epi32(_mm256_add_epi32(_mm256_hadd_epi32(_mm256_madd_epi16(Sums0123, Coefs), _mm256_madd_epi16(Sums4567, Coefs)), Bias), CHROMA_SHIFT);
+	const __m128i Even = _mm256_castsi256_si128(Values);
+	const __m128i Odd = _mm256_extracti128_si256(Values, 1);
+	return _mm_packs_epi32(_mm_unpacklo_epi32(Even, Odd), _mm_unpackhi_epi32(Even, Odd));
+}
+
+DMSSIM_TARGET_AVX2 void ChromaRow_AVX2(const uint8_t* Src0, const uint8_t* Src1, uint8_t* DstU, uint8_t* DstV, size_t Width) {
+	const __m256i CoefsU = MakeCoefs_AVX2(RU, GU, BU);
+	const __m256i CoefsV = MakeCoefs_AVX2(RV, GV, BV);
+	const __m256i Bias = _mm256_set1_epi32(CHROMA_BIAS);
+	const size_t ChromaWidth = (Width + 1) / 2;
+	size_t X = 0;
+	// 16 source pixels -> 8 chroma samples
+	for (; X * 2 + 16 <= Width; X += 8) {
+		const __m256i Sums0123 = BlockSums4_AVX2(Src0 + X * 8, Src1 + X * 8);
+		const __m256i Sums4567 = BlockSums4_AVX2(Src0 + X * 8 + 32, Src1 + X * 8 + 32);
+		const __m128i Bytes = _mm_packus_epi16(Chroma8_AVX2(Sums0123, Sums4567, CoefsU, Bias), Chroma8_AVX2(Sums0123, Sums4567, CoefsV, Bias));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(DstU + X), Bytes);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(DstV + X), _mm_srli_si128(Bytes, 8));
+	}
+	ChromaRow_Scalar(Src0, Src1, DstU, DstV, Width, X, ChromaWidth);
+}
+
+#endif // DMSSIM_PIXEL_CONVERSION_X86
+
+using RowFunc = void (*)(const uint8_t*, uint8_t*, size_t);
+using ChromaRowFunc = void (*)(const uint8_t*, const uint8_t*, uint8_t*, uint8_t*, size_t);
+
+void Gray8Row(const uint8_t* Src, uint8_t* Dst, size_t Width) { Gray8Row_Scalar(Src, Dst, 0, Width); }
+void Gray16Row(const uint8_t* Src, uint8_t* Dst, size_t Width) { Gray16Row_Scalar(Src, Dst, 0, Width); }
+void LumaRow(const uint8_t* Src, uint8_t* Dst, size_t Width) { LumaRow_Scalar(Src, Dst, 0, Width); }
+void ChromaRow(const uint8_t* Src0, const uint8_t* Src1, uint8_t* DstU, uint8_t* DstV, size_t Width) { ChromaRow_Scalar(Src0, Src1, DstU, DstV, Width, 0, (Width + 1) / 2); }
+
+RowFunc SelectGray8Row(SimdLevel Level) {
+#if DMSSIM_PIXEL_CONVERSION_X86
+	if (Level == SimdLevel::AVX2) { return Gray8Row_AVX2; }
+	if (Level == SimdLevel::SSE41) { return Gray8Row_SSE41; }
+#endif
+	return Gray8Row;
+}
+
+RowFunc SelectGray16Row(SimdLevel Level) {
+#if DMSSIM_PIXEL_CONVERSION_X86
+	if (Level == SimdLevel::AVX2) { return Gray16Row_AVX2; }
+	if (Level == SimdLevel::SSE41) { return Gray16Row_SSE41; }
+#endif
+	return Gray16Row;
+}
+
+RowFunc SelectLumaRow(SimdLevel Level) {
+#if DMSSIM_PIXEL_CONVERSION_X86
+	if (Level == SimdLevel::AVX2) { return LumaRow_AVX2; }
+	if (Level == SimdLevel::SSE41) { return LumaRow_SSE41; }
+#endif
+	return LumaRow;
+}
+
+ChromaRowFunc SelectChromaRow(SimdLevel Level) {
+#if DMSSIM_PIXEL_CONVERSION_X86
+	if (Level == SimdLevel::AVX2) { return ChromaRow_AVX2; }
+	if (Level == SimdLevel::SSE41) { return ChromaRow_SSE41; }
+#endif
+	return ChromaRow;
+}
+
+SimdLevel DetectSimdLevel() {
+#if DMSSIM_PIXEL_CONVERSION_X86
+#if defined(_MSC_VER)
+	int Info[4] = {};
+	__cpuid(Info, 0);
+	const int MaxLeaf = Info[0];
+	__cpuid(Info, 1);
+	const bool HasSSE41 = (Info[2] & (1 << 19)) != 0;
+	const bool HasOSXSAVE = (Info[2] & (1 << 27)) != 0;
+	const bool HasAVX = (Info[2] & (1 << 28)) != 0;
+	bool HasAVX2 = false;
+	if (MaxLeaf >= 7 && HasOSXSAVE && HasAVX && (_xgetbv(0) & 0x6) == 0x6) {
+		__cpuidex(Info, 7, 0);
+		HasAVX2 = (Info[1] & (1 << 5)) != 0;
+	}
+#else
+	__builtin_cpu_init();
+	const bool HasSSE41 = __builtin_cpu_supports("sse4.1");
+	const bool HasAVX2 = __builtin_cpu_supports("avx2");
+#endif
+	if (HasAVX2) { return SimdLevel::AVX2; }
+	if (HasSSE41) { return SimdLevel::SSE41; }
+#endif
+	return SimdLevel::Scalar;
+}
+
+} // anonymous namespace
+
+SimdLevel GetSupportedSimdLevel() {
+	static const SimdLevel Level = DetectSimdLevel();
+	return Level;
+}
+
+const char* GetSimdLevelName(SimdLevel Level) {
+	switch (Level) {
+	case SimdLevel::AVX2:  return "AVX2";
+	case SimdLevel::SSE41: return "SSE4.1";
+	default:               return "Scalar";
+	}
+}
+
+void BGRAToGray8(const uint8_t* Src, size_t SrcStride, uint8_t* Dst, size_t DstStride, size_t Width, size_t RowBegin, size_t RowEnd, SimdLevel Level) {
+	const RowFunc Row = SelectGray8Row(Level);
+	for (size_t Y = RowBegin; Y < RowEnd; ++Y) { Row(Src + Y * SrcStride, Dst + Y * DstStride, Width); }
+}
+
+void BGRAToGray16LE(const uint8_t* Src, size_t SrcStride, uint8_t* Dst, size_t DstStride, size_t Width, size_t RowBegin, size_t RowEnd, SimdLevel Level) {
+	const RowFunc Row = SelectGray16Row(Level);
+	for (size_t Y = RowBegin; Y < RowEnd; ++Y) { Row(Src + Y * SrcStride, Dst + Y * DstStride, Width); }
+}
+
+void BGRAToYUV420P(const uint8_t* Src, size_t SrcStride, uint8_t* DstY, size_t StrideY, uint8_t* DstU, size_t StrideU, uint8_t* DstV, size_t StrideV,
+	size_t Width, size_t Height, size_t RowBegin, size_t RowEnd, SimdLevel Level) {
+	const RowFunc Luma = SelectLumaRow(Level);
+	const ChromaRowFunc Chroma = SelectChromaRow(Level);
+	for (size_t Y = RowBegin; Y < RowEnd; Y += 2) {
+		const uint8_t* const Src0 = Src + Y * SrcStride;
+		const uint8_t* const Src1 = (Y + 1 < Height) ? Src0 + SrcStride : Src0;
+		Luma(Src0, DstY + Y * StrideY, Width);
+		if (Y + 1 < RowEnd) { Luma(Src1, DstY + (Y + 1) * StrideY, Width); }
+		Chroma(Src0, Src1, DstU + (Y / 2) * StrideU, DstV + (Y / 2) * StrideV, Width);
+	}
+}
+
+} // namespace DMSSimPixelConversion
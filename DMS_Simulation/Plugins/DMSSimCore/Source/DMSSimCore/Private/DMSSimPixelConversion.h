@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Conversion kernels from 8 bit BGRA (FColor) frames to the pixel formats of the encoders, for the case when no rescaling is needed.
+ * Every kernel processes the rows [RowBegin, RowEnd) only, so one frame can be split into row tiles and converted by several threads.
+ * Strides are in bytes. The kernels have scalar, SSE4.1 and AVX2 implementations which produce identical results,
+ * the best implementation supported by the CPU is used by default.
+ *
+ * Luma is computed in 15 bit fixed point with BT.601 coefficients, like libswscale does:
+ * - GRAY8 and GRAY16LE are full range (gray input pixels stay unchanged, GRAY16 value = GRAY8 value * 257),
+ * - YUV420P is limited range, chroma is the average of each 2x2 block.
+ * Gray input pixels give the same output as libswscale. Colored input pixels can differ by 1 LSB, because libswscale rounds
+ * its intermediates differently, so only the NIR images are converted by the kernels.
+ */
+namespace DMSSimPixelConversion {
+
+enum class SimdLevel {
+	Scalar,
+	SSE41,
+	AVX2,
+};
+
+/** Returns the best instruction set supported by the CPU. */
+SimdLevel GetSupportedSimdLevel();
+
+const char* GetSimdLevelName(SimdLevel Level);
+
+void BGRAToGray8(const uint8_t* Src, size_t SrcStride, uint8_t* Dst, size_t DstStride, size_t Width, size_t RowBegin, size_t RowEnd, SimdLevel Level = GetSupportedSimdLevel());
+
+void BGRAToGray16LE(const uint8_t* Src, size_t SrcStride, uint8_t* Dst, size_t DstStride, size_t Width, size_t RowBegin, size_t RowEnd, SimdLevel Level = GetSupportedSimdLevel());
+
+/**
+ * Converts rows [RowBegin, RowEnd) into the Y plane and the matching chroma rows into the U and V planes.
+ * RowBegin must be even. For odd Width / Height the last column / row is repeated for the chroma.
+ */
+void BGRAToYUV420P(const uint8_t* Src, size_t SrcStride, uint8_t* DstY, size_t StrideY, uint8_t* DstU, size_t StrideU, uint8_t* DstV, size_t StrideV,
+	size_t Width, size_t Height, size_t RowBegin, size_t RowEnd, SimdLevel Level = GetSupportedSimdLevel());
+
+} // namespace DMSSimPixelConversion
@@ -0,0 +1,95 @@
+#include "DMSSimRecordingSink.h"
+#include <algorithm>
+#include "DMSSimLabelWriter.h"
+#include "DMSSimLog.h"
+
+namespace {
+
+/** Runs the labelers of the sink through a DMSSimLabelWriter. */
+class DMSSimLabelSink : public DMSSimRecordingSink
+{
+public:
+	DMSSimLabelSink(const DMSSimRecordingSinkSettings& Settings, const uint8 Labels) :
+		Writer_(Settings.BaseFileName, Labels, Settings.LabelStream, Settings.LabelThreadCount, DEFAULT_LABEL_COMMIT_WINDOW, Settings.LabelDeltaEpsilon) {}
+
+	void AddFrame(const TArray<FColor>&, const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, const int FrameIdx) override {
+		Writer_.AddFrame(PrevGroundTruth, GroundTruth, FrameIdx);
+	}
+	void Finalize() override { Writer_.Finalize(); }
+
+private:
+	DMSSimLabelWriter Writer_;
+};
+
+} // anonymous namespace
+
+DMSSimRecordingSinkRegistry& DMSSimRecordingSinkRegistry::Get() {
+	static DMSSimRecordingSinkRegistry Registry;
+	return Registry;
+}
+
+DMSSimRecordingSinkRegistry::DMSSimRecordingSinkRegistry() {
+	Factories_[DMSSIM_SINK_OPENLABEL] = [](const DMSSimRecordingSinkSettings& Settings) -> TUniquePtr<DMSSimRecordingSink> {
+		return MakeUnique<DMSSimLabelSink>(Settings, DMSSimLabelWriter::OpenLabel);
+	};
+	Factories_[DMSSIM_SINK_OPENLABEL_OLD] = [](const DMSSimRecordingSinkSettings& Settings) -> TUniquePtr<DMSSimRecordingSink> {
+		return MakeUnique<DMSSimLabelSink>(Settings, DMSSimLabelWriter::OpenLabelOld);
+	};
+	Factories_[DMSSIM_SINK_OPENLABEL_CBOR] = [](const DMSSimRecordingSinkSettings& Settings) -> TUniquePtr<DMSSimRecordingSink> {
+		return MakeUnique<DMSSimLabelSink>(Settings, DMSSimLabelWriter::OpenLabelCbor);
+	};
+	Factories_[DMSSIM_SINK_OPENLABEL_DELTA] = [](const DMSSimRecordingSinkSettings& Settings) -> TUniquePtr<DMSSimRecordingSink> {
+		return MakeUnique<DMSSimLabelSink>(Settings, DMSSimLabelWriter::OpenLabelDelta);
+	};
+	// the rows are written on the game thread, with the time of the frame, the entry only makes the name known
+	Factories_[DMSSIM_SINK_CSV] = [](const DMSSimRecordingSinkSettings&) { return TUniquePtr<DMSSimRecordingSink>(); };
+}
+
+void DMSSimRecordingSinkRegistry::Register(const std::string& Name, SinkFactory Factory) {
+	std::lock_guard<std::mutex> Lock(Mutex_);
+	Factories_[Name] = MoveTemp(Factory);
+}
+
+void DMSSimRecordingSinkRegistry::Unregister(const std::string& Name) {
+	std::lock_guard<std::mutex> Lock(Mutex_);
+	Factories_.erase(Name);
+}
+
+bool DMSSimRecordingSinkRegistry::IsRegistered(const std::string& Name) const {
+	std::lock_guard<std::mutex> Lock(Mutex_);
+	return Factories_.find(Name) != Factories_.end();
+}
+
+std::vector<TUniquePtr<DMSSimRecordingSink>> DMSSimRecordingSinkRegistry::CreateSinks(const std::vector<std::string>& Names, const DMSSimRecordingSinkSettings& Settings) const {
+	std::vector<TUniquePtr<DMSSimRecordingSink>> Sinks;
+	for (const auto& Name : Names) {
+		SinkFactory Factory;
+		{
+			std::lock_guard<std::mutex> Lock(Mutex_);
+			const auto Found = Factories_.find(Name);
+			if (Found != Factories_.end()) { Factory = Found->second; }
+		}
+		if (!Factory) {
+			DMSSimLog::Error() << "DMSSimRecordingSinkRegistry  -- " << "unknown sink: " << Name << FL;
+			continue;
+		}
+		if (auto Sink = Factory(Settings)) { Sinks.push_back(MoveTemp(Sink)); }
+	}
+	return Sinks;
+}
+
+std::vector<std::string> DMSSimRecordingSinkRegistry::GetSelectedSinks(const DMSSimScenarioParser& Scenario) {
+	const auto& GroundTruthSettings = Scenario.GetGroundTruthSettings();
+	std::vector<std::string> Names;
+	for (size_t i = 0; i < GroundTruthSettings.GetSinkCount(); ++i) { Names.emplace_back(GroundTruthSettings.GetSink(i)); }
+	if (!Names.empty()) { return Names; }
+
+	const auto& Camera = Scenario.GetCamera();
+	Names = { Camera.GetVideoOut() ? DMSSIM_SINK_VIDEO : DMSSIM_SINK_IMAGES, DMSSIM_SINK_OPENLABEL, DMSSIM_SINK_OPENLABEL_OLD };
+	if (Camera.GetCsvOut()) { Names.emplace_back(DMSSIM_SINK_CSV); }
+	return Names;
+}
+
+bool DMSSimRecordingSinkRegistry::IsSelected(const std::vector<std::string>& Names, const char* const Name) {
+	return std::find(Names.begin(), Names.end(), Name) != Names.end();
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "DMSSimConfig.h"
+
+constexpr char DMSSIM_SINK_VIDEO[] = "video";                   // DMSSimVideoEncoder, the video file
+constexpr char DMSSIM_SINK_IMAGES[] = "images";                 // DMSSimVideoEncoder, an image file per frame
+constexpr char DMSSIM_SINK_OPENLABEL[] = "openlabel";           // DMSSimImageLabelerImpl
+constexpr char DMSSIM_SINK_OPENLABEL_OLD[] = "openlabel_old";   // DMSSimImageLabelerOldImpl, the _old.json files
+constexpr char DMSSIM_SINK_OPENLABEL_CBOR[] = "openlabel_cbor"; // DMSSimImageLabelerCborImpl, the labels as binary .cbor file
+constexpr char DMSSIM_SINK_OPENLABEL_DELTA[] = "openlabel_delta"; // DMSSimImageLabelerDeltaImpl, the _delta.json file with the changed labels
+constexpr char DMSSIM_SINK_CSV[] = "csv";                       // the ground truth file, written by the renderer's DMSSimGroundTruthWriter
+
+/**
+ * @struct DMSSimRecordingSinkSettings
+ * @brief Parameters of the recording the sinks are created with.
+ * The file name must outlive the sinks, the encoders and labelers keep a reference to it.
+ */
+struct DMSSimRecordingSinkSettings
+{
+	const std::wstring& BaseFileName;
+	size_t SrcWidth = 0;
+	size_t SrcHeight = 0;
+	size_t DstWidth = 0;
+	size_t DstHeight = 0;
+	size_t FrameRate = 0;
+	bool   Depth16Bit = false;
+	bool   Nir = false;
+	bool   LabelStream = false;   // label_mode: stream
+	int    LabelThreadCount = 0;  // label_thread_count
+	float  LabelDeltaEpsilon = DMSSIM_DEFAULT_LABEL_DELTA_EPSILON; // label_delta_epsilon
+};
+
+/**
+ * @class DMSSimRecordingSink
+ * @brief Output of the video recording thread, which passes every recorded frame to the sinks selected for the scenario.
+ * As with the labelers, the image is the one of PrevGroundTruth, GroundTruth is the ground truth of the following frame.
+ */
+class DMSSimRecordingSink
+{
+public:
+	virtual ~DMSSimRecordingSink() {}
+
+	virtual void AddFrame(const TArray<FColor>& PrevImage, const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, int FrameIdx) = 0;
+
+	/** Completes the output after the last frame, no frames can be added afterwards. */
+	virtual void Finalize() {}
+};
+
+/**
+ * @class DMSSimRecordingSinkRegistry
+ * @brief Factories of the recording sinks by name. The scenario selects the sinks in the sinks list of ground_truth_settings,
+ * only the selected ones are created. The labeler sinks are registered by the registry itself, the encoder sinks
+ * by the module on start-up, as the encoders need FFmpeg. New sinks are added with Register.
+ */
+class DMSSimRecordingSinkRegistry
+{
+public:
+	using SinkFactory = std::function<TUniquePtr<DMSSimRecordingSink>(const DMSSimRecordingSinkSettings&)>;
+
+	static DMSSimRecordingSinkRegistry& Get();
+
+	/**
+	 * Registers the factory of a sink, replaces a factory registered with the same name before.
+	 * A factory may return nullptr, if the output is written elsewhere or can't be created.
+	 */
+	void Register(const std::string& Name, SinkFactory Factory);
+	void Unregister(const std::string& Name);
+	bool IsRegistered(const std::string& Name) const;
+
+	/** Creates the sinks in the order of the names. Unknown names are logged and skipped. */
+	std::vector<TUniquePtr<DMSSimRecordingSink>> CreateSinks(const std::vector<std::string>& Names, const DMSSimRecordingSinkSettings& Settings) const;
+
+	/**
+	 * Names of the sinks selected by the scenario. Without a sinks list in the ground truth settings,
+	 * these are the video or the images as by video_out, both labelers and the csv, if csv_out is set.
+	 */
+	static std::vector<std::string> GetSelectedSinks(const DMSSimScenarioParser& Scenario);
+	static bool IsSelected(const std::vector<std::string>& Names, const char* Name);
+
+private:
+	DMSSimRecordingSinkRegistry();
+
+	mutable std::mutex                 Mutex_;
+	std::map<std::string, SinkFactory> Factories_;
+};
@@ -1,7 +1,8 @@
 #include "DMSSimRenderer.h"
 #include "DMSSimConfig.h"
 #include "DMSSimLog.h"
-#include "DMSSimGroundTruthRecorder.h"
+#include "DMSSimGroundTruthWriter.h"
+#include "DMSSimRecordingSink.h"
 #include "DMSSimScenarioParser.h"
 #include "DMSSimVideoEncoder.h"
 #include "DMSSimVideoRecordingRunable.h"
@@ -74,6 +75,11 @@ void UDMSSimRenderer::RenderFrame() {
 	const float UnpausedTime = World_->UnpausedTimeSeconds;
 	bool ScenarioChange = false;
 
+	// the ground truth of the frame, shared by the ground truth writer and the labelers
+	const DMSSimGroundTruthFramePool::FramePtr GroundTruth = GroundTruthFramePool_
+		? GroundTruthFramePool_->Acquire(DMSSimConfig::GetGroundTruthFrame())
+		: MakeShared<DMSSimGroundTruthFrame, ESPMode::ThreadSafe>(DMSSimConfig::GetGroundTruthFrame());
+
 	// Take next requests from the queues and pass to recording thread
 	if (VideoRecorder_) {
 		DMSSimVideoRecordingRunable* const VideoRecorder = static_cast<DMSSimVideoRecordingRunable*>(VideoRecorder_.Get());
@@ -84,18 +90,16 @@ void UDMSSimRenderer::RenderFrame() {
 			GroundTruthRequestQueue_.Peek(NextGroundTruthRequest);
 			NextRenderRequest->RenderFence.Wait(true);
 			if (NextRenderRequest && NextRenderRequest->RenderFence.IsFenceComplete() && NextGroundTruthRequest) {
-				ScenarioChange = ScenarioIdxPrev_ < NextGroundTruthRequest->Common.ScenarioIdx;
-				if (!ScenarioChange) {
-					VideoRecorder->AddFrame(NextRenderRequest->Image, NextGroundTruthRequest);
-					VideoRecorder->IncPendingFrames();
-				}
-				ScenarioIdxPrev_ = NextGroundTruthRequest->Common.ScenarioIdx;
+				ScenarioChange = ScenarioIdxPrev_ < NextGroundTruthRequest->GetScenario().ScenarioIdx;
+				// blocks while the recording thread is behind, throttling the simulation to the encoder speed
+				if (!ScenarioChange) { VideoRecorder->AddFrame(NextRenderRequest->Image, NextGroundTruthRequest); }
+				ScenarioIdxPrev_ = NextGroundTruthRequest->GetScenario().ScenarioIdx;
 			}
 			RenderRequestQueue_.Pop();
 			GroundTruthRequestQueue_.Pop();
 		}
 		DMSSimConfig::UpdateDisplayedFrameTime(UnpausedTime - StartTime_);
-		if (GroundTruthStream_.is_open()) { DMSSimGroundTruthRecorder::AddFrame(GroundTruthStream_, UnpausedTime - StartTime_, DMSSimConfig::GetGroundTruthFrame()); }
+		if (GroundTruthWriter_) { GroundTruthWriter_->AddFrame(UnpausedTime - StartTime_, GroundTruth); }
 	}
 
 	//end of scenario, 
@@ -104,7 +108,12 @@ void UDMSSimRenderer::RenderFrame() {
 		VideoRecorder_->Stop();
 		VideoRecorder_ = nullptr;
 		CurrentFrame_ = 0;
-		if (GroundTruthStream_.is_open() && (ScenarioChange || !DMSSimConfig::IsRecording())) { GroundTruthStream_.close(); }
+		if (GroundTruthStream_.is_open() && (ScenarioChange || !DMSSimConfig::IsRecording())) {
+			// writes the queued rows before the file is closed
+			GroundTruthWriter_->Finalize();
+			GroundTruthWriter_.Reset();
+			GroundTruthStream_.close();
+		}
 	}
 
 	//start of scenario
@@ -118,21 +127,29 @@ void UDMSSimRenderer::RenderFrame() {
 			DMSSimConfig::GetCamera().GetFrameHeight(), 
 			DMSSimConfig::GetCamera().GetFrameRate(), 
 			DMSSimConfig::GetCamera().GetDepth16Bit(), 
-			DMSSimConfig::GetCamera().GetNIR()
+			DMSSimConfig::GetCamera().GetNIR(),
+			DMSSimConfig::GetFrameQueueCapacity()
 		));
 		VideoRecorders_.Emplace(VideoRecorder_);
 		StartTime_ = UnpausedTime;
+		if (FrameBufferPool_) {
+			FrameBufferPool_->Preallocate(DMSSimConfig::GetCamera().GetFrameWidth() * DMSSimConfig::GetCamera().GetFrameHeight(), DMSSimConfig::GetFrameQueueCapacity() + FRAME_BUFFERS_IN_FLIGHT);
+		}
 
-		if (!GroundTruthStream_.is_open() && DMSSimConfig::GetCurrentScenarioParser()->GetCamera().GetCsvOut()) {
+		const auto Sinks = DMSSimRecordingSinkRegistry::GetSelectedSinks(*DMSSimConfig::GetCurrentScenarioParser());
+		if (!GroundTruthStream_.is_open() && DMSSimRecordingSinkRegistry::IsSelected(Sinks, DMSSIM_SINK_CSV)) {
 			//DMSSimConfig::ResetGroundTruthData();
-			GroundTruthStream_.open(GetCsvFileName(), std::ios_base::out | std::ios_base::trunc);
-			DMSSimGroundTruthRecorder::AddHeader(GroundTruthStream_);
+			const bool Columnar = strcmp(DMSSimConfig::GetCamera().GetGroundTruthFormat(), "columnar") == 0;
+			const auto Format = Columnar ? DMSSimGroundTruthFormat::FileFormat::Columnar : DMSSimGroundTruthFormat::FileFormat::Csv;
+			GroundTruthStream_.open(GetCsvFileName(Format), std::ios_base::out | std::ios_base::trunc | (Columnar ? std::ios_base::binary : std::ios_base::openmode()));
+			GroundTruthWriter_ = MakeUnique<DMSSimGroundTruthWriter>(GroundTruthStream_, DEFAULT_GROUND_TRUTH_QUEUE_CAPACITY, Format);
 		}
 	}
 
 	//remove all runnables that have finished and stop recording, if all runnables are finished
 	VideoRecorders_.RemoveAll([](TSharedPtr<FRunnable> VideoRecorder) {	return static_cast<DMSSimVideoRecordingRunable*>(VideoRecorder.Get())->IsDone(); });
 	if (VideoRecorders_.Num() == 0) {
+		if (FrameBufferPool_) { FrameBufferPool_->LogStats(); }
 		World_ = nullptr;
 		FCoreDelegates::OnBeginFrame.RemoveAll(this);
 		FCoreDelegates::OnEndFrame.RemoveAll(this);
@@ -141,10 +158,10 @@ void UDMSSimRenderer::RenderFrame() {
 	}
 
 	//add new image, ground truth and parser requests
-	EnqueueRequests();
+	EnqueueRequests(GroundTruth);
 }
 
-void UDMSSimRenderer::EnqueueRequests() {
+void UDMSSimRenderer::EnqueueRequests(const DMSSimGroundTruthFramePool::FramePtr& GroundTruth) {
 	RenderTarget_->TargetGamma = GEngine->GetDisplayGamma();
 	FTextureRenderTargetResource* const RenderTargetRes = RenderTarget_->GameThread_GetRenderTargetResource();
 
@@ -156,12 +173,14 @@ void UDMSSimRenderer::EnqueueRequests() {
 	};
 
 	TSharedPtr<FDMSSimRenderRequest> RenderRequest(new FDMSSimRenderRequest);
+	const FIntPoint SurfaceSize = RenderTargetRes->GetSizeXY();
+	if (FrameBufferPool_) { RenderRequest->Image = FrameBufferPool_->Acquire(SurfaceSize.X * SurfaceSize.Y); }
 
 	// Setup GPU command
 	FReadSurfaceContext ReadSurfaceContext = {
 		RenderTargetRes,
 		&(*RenderRequest->Image),
-		FIntRect(0,0, RenderTargetRes->GetSizeXY().X, RenderTargetRes->GetSizeXY().Y),
+		FIntRect(0,0, SurfaceSize.X, SurfaceSize.Y),
 		FReadSurfaceDataFlags(RCM_UNorm, CubeFace_MAX)
 	};
 
@@ -179,19 +198,20 @@ void UDMSSimRenderer::EnqueueRequests() {
 	RenderRequest->RenderFence.BeginFence();
 	if (RenderRequest) {
 		RenderRequestQueue_.Enqueue(RenderRequest);
-		GroundTruthRequestQueue_.Enqueue(MakeShared<DMSSimGroundTruthFrame>(DMSSimConfig::GetGroundTruthFrame()));
+		GroundTruthRequestQueue_.Enqueue(GroundTruth);
 	}
 }
 
 std::wstring UDMSSimRenderer::GetVideoFileName() {
 	std::wstringstream ss;
-	ss << DMSSimConfig::GetFilePrefix()<< L"_Scenario_" << std::setw(4) << std::setfill(L'0') << (DMSSimConfig::GetGroundTruthFrame().Common.ScenarioIdx);
+	ss << DMSSimConfig::GetFilePrefix()<< L"_Scenario_" << std::setw(4) << std::setfill(L'0') << (DMSSimConfig::GetGroundTruthFrame().GetScenario().ScenarioIdx);
 	return ss.str();
 }
 
-std::wstring UDMSSimRenderer::GetCsvFileName() {
+std::wstring UDMSSimRenderer::GetCsvFileName(const DMSSimGroundTruthFormat::FileFormat Format) {
+	const char* const Extension = Format == DMSSimGroundTruthFormat::FileFormat::Columnar ? DMSSimGroundTruthFormat::COLUMNAR_EXTENSION : DMSSimGroundTruthFormat::CSV_EXTENSION;
 	std::wstringstream ss;
-	ss << DMSSimConfig::GetFilePrefix() << L"_Scenario_" << std::setw(4) << std::setfill(L'0') << (DMSSimConfig::GetGroundTruthFrame().Common.ScenarioIdx) << L".csv";
+	ss << DMSSimConfig::GetFilePrefix() << L"_Scenario_" << std::setw(4) << std::setfill(L'0') << (DMSSimConfig::GetGroundTruthFrame().GetScenario().ScenarioIdx) << Extension;
 	return ss.str();
 }
 
@@ -264,6 +284,8 @@ void UDMSSimRenderer::OnMapLoadFinished(UWorld* World) {
 	SceneCapture_->RegisterComponent();
 
 	if (FirstMap) {
+		FrameBufferPool_ = MakeUnique<DMSSimFrameBufferPool>(DMSSimConfig::GetFrameQueueCapacity() + FRAME_BUFFERS_IN_FLIGHT);
+		GroundTruthFramePool_ = MakeUnique<DMSSimGroundTruthFramePool>(DMSSimConfig::GetFrameQueueCapacity() + FRAME_BUFFERS_IN_FLIGHT + DEFAULT_GROUND_TRUTH_QUEUE_CAPACITY);
 		FCoreDelegates::OnBeginFrame.AddUObject(this, &UDMSSimRenderer::OnBeginFrame);
 		FCoreDelegates::OnEndFrame.AddUObject(this, &UDMSSimRenderer::OnEndFrame);
 		DMSSimConfig::SetCameraCallback([this](UCameraComponent* const Camera){ this->SetupCamera(Camera); });
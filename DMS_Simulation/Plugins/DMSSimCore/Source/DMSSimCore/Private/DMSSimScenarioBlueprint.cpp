@@ -35,7 +35,7 @@ public:
 			// Currently this will only allow to have one scenario file being loaded during editor play. Which is what is wanted.
 			if (FileManager.FileExists(*Path)) {
 				DMSSimLog::Info() << "Loading scenario: " << Path << FL;
-				DMSSimConfig::AddScenarioParser(CreateScenarioParser(*Path));
+				for (const auto& Scenario : CreateScenarioSweep(*Path)) { DMSSimConfig::AddScenarioParser(Scenario); }
 			} else if (FileManager.DirectoryExists(*Path)) {
 				DMSSimLog::Info() << "Loading all scenarios from directory: " << Path << FL;
 				DMSSimConfig::SetScenarioParsers(CreateScenarioParsers(*Path));
@@ -324,6 +324,9 @@ bool UDMSSimScenarioBlueprint::LoadDmsScenarioMulti(const FString& Path, const i
 		Scenario.Camera.BloomIntensity = Camera.GetBloomIntensity();
 		Scenario.Camera.FocusOffset = Camera.GetFocusOffset();
 		CarSpeed = Parser->GetCarSpeed();
+
+		// the ground truth constants of the scenario are created from Scenario by the first StoreDmsGroundTruthCommonData
+		DMSSimConfig::ResetGroundTruthScenario();
 	}
 	catch (const std::exception& e) {
 		ErrorMessage = e.what();
@@ -3,13 +3,21 @@
 #include "DMSSimParserBase.h"
 #include "DMSSimYamlObj.h"
 #include "DMSSimLog.h"
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <functional>
+#include <iterator>
+#include <memory>
 #include <regex>
 #include <sstream>
+#include <stdexcept>
 #include <stack>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 using namespace DMSSimParserBaseHelpers;
@@ -116,6 +124,7 @@ namespace {
 		case YamlObjTypeCamera:
 		case YamlObjTypeSteeringWheelColumn:
 		case YamlObjTypeIllumination:
+		case YamlObjTypeSweepPose:
 			return true;
 		default:
 			break;
@@ -170,11 +179,14 @@ namespace {
 		virtual float					GetEyeBoundingBoxWidthFactor() const override { return EyeBoundingBoxWidthFactor_; };
 		virtual float					GetEyeBoundingBoxHeightFactor() const override { return EyeBoundingBoxHeightFactor_; };
 		virtual float					GetEyeBoundingBoxDepth() const override { return EyeBoundingBoxDepth_; };
+		virtual size_t					GetSinkCount() const override { return Sinks_.size(); };
+		virtual const char*				GetSink(size_t SinkIndex) const override { return Sinks_.at(SinkIndex).c_str(); };
 
 		float							BoundingBoxPaddingFactor_Face_ = 0.0;
 		float							EyeBoundingBoxWidthFactor_ = 1.0;
 		float							EyeBoundingBoxHeightFactor_ = 1.0;
 		float							EyeBoundingBoxDepth_ = 1.0;
+		std::vector<std::string>		Sinks_;
 	};
 
 	class YamlSun : public YamlOrientationObj {
@@ -201,6 +213,8 @@ namespace {
 		FRotator				GetRotation() const override { return RotationFinal_; };
 		bool					GetMirrored() const override { return Mirrored_; };
 		float					GetFOV() const override { return FOV_; };
+		size_t					GetDistortionCount() const override { return Distortion_.size(); };
+		float					GetDistortion(size_t Index) const override { return Distortion_.at(Index); };
 		float					GetNoise() const override { return Noise_; };
 		float					GetBlur() const override { return Blur_; };
 		float					GetFocalDistance() const override { return FocalDistance_ * DMSSIM_M_TO_CM; };
@@ -214,6 +228,18 @@ namespace {
 		float					GetContrast() const override { return Contrast_; };
 		float					GetBloomIntensity() const override { return BloomIntensity_; };
 		float					GetFocusOffset() const override { return FocusOffset_; };
+		int						GetEncoderThreadCount() const override { return EncoderThreadCount_; };
+		const char*				GetEncoderThreadType() const override { return EncoderThreadType_.c_str(); };
+		const char*				GetEncoderPreset() const override { return EncoderPreset_.c_str(); };
+		const char*				GetEncoderTune() const override { return EncoderTune_.c_str(); };
+		int						GetEncoderLookahead() const override { return EncoderLookahead_; };
+		const char*				GetImageFormat() const override { return ImageFormat_.c_str(); };
+		int						GetPngCompression() const override { return PngCompression_; };
+		int						GetImageThreadCount() const override { return ImageThreadCount_; };
+		const char*				GetGroundTruthFormat() const override { return GroundTruthFormat_.c_str(); };
+		const char*				GetLabelMode() const override { return LabelMode_.c_str(); };
+		int						GetLabelThreadCount() const override { return LabelThreadCount_; };
+		float					GetLabelDeltaEpsilon() const override { return LabelDeltaEpsilon_; };
 
 		std::vector<unsigned>	Resolution_;
 		yaml_mark_t				ResolutionMark_ = {};
@@ -224,6 +250,8 @@ namespace {
 		bool                    VideoOut_ = false;
 		bool                    CsvOut_ = false;
 		float					FOV_ = DMSSIM_DEFAULT_FOV;
+		std::vector<float>		Distortion_;
+		yaml_mark_t				DistortionMark_ = {};
 		float					Noise_ = DMSSIM_DEFAULT_NOISE;
 		float					Blur_ = DMSSIM_DEFAULT_BLUR;
 		float					FocalDistance_ = -1.0f;
@@ -237,10 +265,23 @@ namespace {
 		float					Contrast_ = 1.0f;
 		float					BloomIntensity_ = 0.0f;
 		float					FocusOffset_ = 0.0f;
+		int						EncoderThreadCount_ = 0;
+		std::string				EncoderThreadType_ = DMSSIM_DEFAULT_ENCODER_THREAD_TYPE;
+		std::string				EncoderPreset_ = DMSSIM_DEFAULT_ENCODER_PRESET;
+		std::string				EncoderTune_;
+		int						EncoderLookahead_ = -1;
+		std::string				ImageFormat_ = DMSSIM_DEFAULT_IMAGE_FORMAT;
+		int						PngCompression_ = DMSSIM_DEFAULT_PNG_COMPRESSION;
+		int						ImageThreadCount_ = DMSSIM_DEFAULT_IMAGE_THREAD_COUNT;
+		std::string				GroundTruthFormat_ = DMSSIM_DEFAULT_GROUND_TRUTH_FORMAT;
+		std::string				LabelMode_ = DMSSIM_DEFAULT_LABEL_MODE;
+		int						LabelThreadCount_ = DMSSIM_DEFAULT_LABEL_THREAD_COUNT;
+		float					LabelDeltaEpsilon_ = DMSSIM_DEFAULT_LABEL_DELTA_EPSILON;
 	};
 
 	void YamlCamera::Recompute(const DMSSimCoordinateSpace& CoordinateSpace) {
 		if (!Resolution_.empty() && Resolution_.size() != 2) { ThrowExceptionWithLineN_Internal("Invalid number of resolution parameters. Must be 2, width and height.", ResolutionMark_); }
+		if (!Distortion_.empty() && Distortion_.size() != DMSSIM_DISTORTION_COEFFICIENT_COUNT) { ThrowExceptionWithLineN_Internal("Invalid number of distortion parameters. Must be 5, k1, k2, p1, p2 and k3.", DistortionMark_); }
 		YamlOrientationObj::Recompute(CoordinateSpace);
 	}
 
@@ -318,7 +359,7 @@ namespace {
 	};
 
 	void YamlBlendOutParameters::Validate() const {
-		if (!Defined_) { throw std::exception("Default blend out parameters not set"); }
+		if (!Defined_) { throw std::runtime_error("Default blend out parameters not set"); }
 		for (int i = 0; i < DMSSimAnimationChannelCount; ++i) {
 			const auto Parameter = Parameters_[i];
 			if (Parameter < DMSSIM_MIN_BLEND_OUT) {
@@ -601,6 +642,136 @@ namespace {
 		std::vector<YamlOccupantScenario> Occupants_;
 	};
 
+	constexpr double DMSSIM_SWEEP_RANGE_TOLERANCE = 1e-4; // of a step, "to" stays in the range despite the rounding of the floats
+
+	enum YamlSweepParameterType {
+		YamlSweepSunIntensity,
+		YamlSweepSunTemperature,
+		YamlSweepIlluminationIntensity,
+		YamlSweepCamera,
+		YamlSweepGlasses,
+		YamlSweepHeadgear,
+	};
+
+	struct YamlSweepParameterInfo {
+		YamlSweepParameterType Type;
+		const char*            Name;
+		float                  MinValue; // of the number parameters
+		float                  MaxValue;
+	};
+
+	const YamlSweepParameterInfo& GetSweepParameterInfo(const YamlSweepParameterType Type) {
+		static const YamlSweepParameterInfo SweepParameterInfos[] = {
+			{ YamlSweepSunIntensity,          "sun_intensity",          DMSSIM_MIN_ILLUMINATION_INTENSITY,   DMSSIM_MAX_ILLUMINATION_INTENSITY   },
+			{ YamlSweepSunTemperature,        "sun_temperature",        DMSSIM_MIN_ILLUMINATION_TEMPERATURE, DMSSIM_MAX_ILLUMINATION_TEMPERATURE },
+			{ YamlSweepIlluminationIntensity, "illumination_intensity", DMSSIM_MIN_ILLUMINATION_INTENSITY,   DMSSIM_MAX_ILLUMINATION_INTENSITY   },
+			{ YamlSweepCamera,                "camera",                 0.0f,                                0.0f                                },
+			{ YamlSweepGlasses,               "glasses",                0.0f,                                0.0f                                },
+			{ YamlSweepHeadgear,              "headgear",               0.0f,                                0.0f                                },
+		};
+
+		for (const auto& Info : SweepParameterInfos) {
+			if (Info.Type == Type) { return Info; }
+		}
+		assert(0);
+		return SweepParameterInfos[0];
+	}
+
+	class YamlSweepPose : public YamlOrientationObj {
+	public:
+		YamlSweepPose() : YamlOrientationObj(YamlObjTypeSweepPose) {}
+		virtual ~YamlSweepPose() {}
+	};
+
+	/**
+	 * A parameter of the sweep section, the values the scenarios of the sweep take.
+	 * The numbers are a list or a range of from, to and step, the accessories a list of names, where "none" removes the accessory,
+	 * the camera poses a list of blocks of location and rotation, the camera block gives the missing one.
+	 */
+	class YamlSweepParameter : public YamlObj {
+	public:
+		YamlSweepParameter(YamlSweepParameterType Type) : YamlObj(YamlObjTypeSweepParameter), Type_(Type) {}
+		virtual ~YamlSweepParameter() {}
+		virtual YamlObj* StartMapping(const yaml_event_t& Event) override;
+		bool IsNumber() const { return Type_ == YamlSweepSunIntensity || Type_ == YamlSweepSunTemperature || Type_ == YamlSweepIlluminationIntensity; }
+		size_t GetValueCount() const { return Type_ == YamlSweepCamera ? Poses_.size() : IsNumber() ? Numbers_.size() : Names_.size(); }
+		void Recompute(const DMSSimCoordinateSpace& CoordinateSpace, const YamlCamera& Camera);
+
+		YamlSweepParameterType     Type_;
+		std::vector<float>         Numbers_;
+		std::vector<std::string>   Names_;        // empty - "none"
+		std::vector<YamlSweepPose> Poses_;
+		bool                       Range_ = false;
+		float                      From_ = -1.0f; // the number parameters aren't negative, -1 - not set
+		float                      To_ = -1.0f;
+		float                      Step_ = -1.0f;
+		yaml_mark_t                StartMark_ = {};
+	};
+
+	YamlObj* YamlSweepParameter::StartMapping(const yaml_event_t& Event) {
+		if (Type_ == YamlSweepCamera && Sequence_) {
+			YamlSweepPose Pose;
+			Pose.LocationMark_ = Event.start_mark;
+			Pose.RotationMark_ = Event.start_mark;
+			Poses_.push_back(Pose);
+			return &Poses_.back();
+		}
+		if (IsNumber() && !Sequence_) { Range_ = true; }
+		return nullptr;
+	}
+
+	void YamlSweepParameter::Recompute(const DMSSimCoordinateSpace& CoordinateSpace, const YamlCamera& Camera) {
+		const std::string Name = GetSweepParameterInfo(Type_).Name;
+		if (Range_) {
+			if (From_ < 0.0f || To_ < 0.0f || Step_ <= 0.0f) { ThrowExceptionWithLineN_Internal(("Range of the " + Name + " sweep needs from, to and a positive step").c_str(), StartMark_); }
+			if (From_ > To_) { ThrowExceptionWithLineN_Internal(("Range of the " + Name + " sweep starts after its end").c_str(), StartMark_); }
+			const double Count = std::floor((double(To_) - From_) / Step_ + DMSSIM_SWEEP_RANGE_TOLERANCE) + 1.0;
+			if (Count > DMSSIM_MAX_SWEEP_SIZE) { ThrowExceptionWithLineN_Internal(("Too many values in the range of the " + Name + " sweep").c_str(), StartMark_); }
+			for (size_t i = 0; i < size_t(Count); ++i) { Numbers_.push_back(float(From_ + double(Step_) * i)); }
+		}
+		if (GetValueCount() == 0) { ThrowExceptionWithLineN_Internal(("Empty " + Name + " sweep").c_str(), StartMark_); }
+		for (auto& Pose : Poses_) {
+			if (Pose.Location_.empty()) { Pose.Location_ = Camera.Location_; }
+			if (Pose.Rotation_.empty()) { Pose.Rotation_ = Camera.Rotation_; }
+			Pose.Recompute(CoordinateSpace);
+		}
+	}
+
+	/**
+	 * The sweep section of a scenario, which makes the scenario a template of the scenarios of all combinations of the parameter values.
+	 * The scenarios are ordered like the digits of a number, the last parameter changes fastest.
+	 */
+	class YamlSweep : public YamlObj {
+	public:
+		YamlSweep() : YamlObj(YamlObjTypeSweep) {}
+		virtual ~YamlSweep() {}
+		size_t GetSize() const;
+		void Recompute(const DMSSimCoordinateSpace& CoordinateSpace, const YamlCamera& Camera);
+
+		std::vector<YamlSweepParameter> Parameters_;
+		yaml_mark_t                     StartMark_ = {};
+	};
+
+	size_t YamlSweep::GetSize() const {
+		if (Parameters_.empty()) { return 0; }
+		size_t Size = 1;
+		for (const auto& Parameter : Parameters_) { Size *= Parameter.GetValueCount(); }
+		return Size;
+	}
+
+	void YamlSweep::Recompute(const DMSSimCoordinateSpace& CoordinateSpace, const YamlCamera& Camera) {
+		size_t Size = 1;
+		for (auto& Parameter : Parameters_) {
+			Parameter.Recompute(CoordinateSpace, Camera);
+			Size *= Parameter.GetValueCount();
+			if (Size > DMSSIM_MAX_SWEEP_SIZE) { ThrowExceptionWithLineN_Internal("Too many scenarios in the sweep", StartMark_); }
+		}
+	}
+
+	bool IsSweepObj(YamlObj* const Obj) {
+		return Obj && (Obj->GetYamlType() == YamlObjTypeSweep || Obj->GetYamlType() == YamlObjTypeSweepParameter);
+	}
+
 	class DMSSimCoordinateSpaceObj: public YamlObj, public DMSSimCoordinateSpace {
 	public:
 		DMSSimCoordinateSpaceObj(): YamlObj(YamlObjTypeCoordinateSpace) {}
@@ -639,12 +810,225 @@ namespace {
 
 	DMSSimCoordinateSpaceObj DefaultCoordinateSpaceObj;
 
+	constexpr uint32_t DMSSIM_COMPILED_SCENARIO_MAGIC = 0x4E435344; // "DSCN", read back in another byte order it doesn't match
+
+	/**
+	 * @class CompiledScenarioArchive
+	 * @brief Flat binary of the scenario objects, written to a string or read from a buffer.
+	 * Like the FArchive of the engine, the same Serialize functions write and read, so the two directions can't diverge.
+	 * The numbers are stored as they are in memory, the strings and the vectors are prefixed by their size.
+	 * The reader only needs a contiguous buffer, e.g. a mapped file, and throws if the buffer is shorter than the objects.
+	 */
+	class CompiledScenarioArchive {
+	public:
+		explicit CompiledScenarioArchive(std::string& Out) : Out_(&Out) {}
+		CompiledScenarioArchive(const char* const Data, const size_t Size) : Data_(Data), Size_(Size) {}
+
+		bool IsLoading() const { return Out_ == nullptr; }
+		bool IsAtEnd() const { return Position_ == Size_; }
+
+		void Bytes(void* const Value, const size_t Size) {
+			if (!IsLoading()) {
+				Out_->append(static_cast<const char*>(Value), Size);
+				return;
+			}
+			CheckSize(Size);
+			memcpy(Value, Data_ + Position_, Size);
+			Position_ += Size;
+		}
+
+		/** Count of the elements of a vector, which are at least one byte each. */
+		uint32_t Count(const size_t Count) {
+			uint32_t Value = static_cast<uint32_t>(Count);
+			Bytes(&Value, sizeof(Value));
+			if (IsLoading()) { CheckSize(Value); }
+			return Value;
+		}
+
+	private:
+		void CheckSize(const size_t Size) const { if (Size > Size_ - Position_) { throw std::runtime_error("Truncated compiled scenario"); } }
+
+		std::string* Out_ = nullptr;
+		const char*  Data_ = nullptr;
+		size_t       Size_ = 0;
+		size_t       Position_ = 0;
+	};
+
+	template <class T>
+	void Serialize(CompiledScenarioArchive& Archive, T& Value) {
+		static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "Serialize of the number types");
+		Archive.Bytes(&Value, sizeof(Value));
+	}
+
+	void Serialize(CompiledScenarioArchive& Archive, bool& Value) {
+		uint8_t Byte = Value ? 1 : 0;
+		Archive.Bytes(&Byte, sizeof(Byte));
+		Value = Byte != 0;
+	}
+
+	void Serialize(CompiledScenarioArchive& Archive, std::string& Value) {
+		const uint32_t Size = Archive.Count(Value.size());
+		if (Archive.IsLoading()) { Value.resize(Size); }
+		if (Size > 0) { Archive.Bytes(&Value[0], Size); }
+	}
+
+	/** The elements of a loaded vector are copies of Prototype before they're read. */
+	template <class T>
+	void Serialize(CompiledScenarioArchive& Archive, std::vector<T>& Values, const T& Prototype = T()) {
+		const uint32_t Size = Archive.Count(Values.size());
+		if (Archive.IsLoading()) { Values.assign(Size, Prototype); }
+		for (auto& Value : Values) { Serialize(Archive, Value); }
+	}
+
+	void Serialize(CompiledScenarioArchive& Archive, FVector& Value) {
+		Serialize(Archive, Value.X);
+		Serialize(Archive, Value.Y);
+		Serialize(Archive, Value.Z);
+	}
+
+	void Serialize(CompiledScenarioArchive& Archive, FRotator& Value) {
+		Serialize(Archive, Value.Pitch);
+		Serialize(Archive, Value.Yaw);
+		Serialize(Archive, Value.Roll);
+	}
+
+	void Serialize(CompiledScenarioArchive& Archive, YamlOrientationObj& Obj) {
+		Serialize(Archive, Obj.Location_);
+		Serialize(Archive, Obj.Rotation_);
+		Serialize(Archive, Obj.PositionFinal_);
+		Serialize(Archive, Obj.RotationFinal_);
+	}
+
+	void Serialize(CompiledScenarioArchive& Archive, YamlCamera& Camera) {
+		Serialize(Archive, static_cast<YamlOrientationObj&>(Camera));
+		Serialize(Archive, Camera.Resolution_);
+		Serialize(Archive, Camera.FrameRate_);
+		Serialize(Archive, Camera.Depth16Bit_);
+		Serialize(Archive, Camera.NIR_);
+		Serialize(Archive, Camera.Mirrored_);
+		Serialize(Archive, Camera.VideoOut_);
+		Serialize(Archive, Camera.CsvOut_);
+		Serialize(Archive, Camera.FOV_);
+		Serialize(Archive, Camera.Distortion_);
+		Serialize(Archive, Camera.Noise_);
+		Serialize(Archive, Camera.Blur_);
+		Serialize(Archive, Camera.FocalDistance_);
+		Serialize(Archive, Camera.MinFStop_);
+		Serialize(Archive, Camera.MaxFStop_);
+		Serialize(Archive, Camera.DiaphragmBladeCount_);
+		Serialize(Archive, Camera.GrainIntensity_);
+		Serialize(Archive, Camera.GrainJitter_);
+		Serialize(Archive, Camera.Saturation_);
+		Serialize(Archive, Camera.Gamma_);
+		Serialize(Archive, Camera.Contrast_);
+		Serialize(Archive, Camera.BloomIntensity_);
+		Serialize(Archive, Camera.FocusOffset_);
+		Serialize(Archive, Camera.EncoderThreadCount_);
+		Serialize(Archive, Camera.EncoderThreadType_);
+		Serialize(Archive, Camera.EncoderPreset_);
+		Serialize(Archive, Camera.EncoderTune_);
+		Serialize(Archive, Camera.EncoderLookahead_);
+		Serialize(Archive, Camera.ImageFormat_);
+		Serialize(Archive, Camera.PngCompression_);
+		Serialize(Archive, Camera.ImageThreadCount_);
+		Serialize(Archive, Camera.GroundTruthFormat_);
+		Serialize(Archive, Camera.LabelMode_);
+		Serialize(Archive, Camera.LabelThreadCount_);
+		Serialize(Archive, Camera.LabelDeltaEpsilon_);
+	}
+
+	void Serialize(CompiledScenarioArchive& Archive, YamlIllumination& Illumination) {
+		Serialize(Archive, static_cast<YamlOrientationObj&>(Illumination));
+		Serialize(Archive, Illumination.Intensity_);
+		Serialize(Archive, Illumination.AttenuationRadius_);
+		Serialize(Archive, Illumination.SourceRadius_);
+		Serialize(Archive, Illumination.InnerConeAngle_);
+		Serialize(Archive, Illumination.OuterConeAngle_);
+	}
+
+	void Serialize(CompiledScenarioArchive& Archive, YamlOccupant& Occupant) {
+		Serialize(Archive, Occupant.Type_);
+		Serialize(Archive, Occupant.Character_);
+		Serialize(Archive, Occupant.Headgear_);
+		Serialize(Archive, Occupant.UpperCloth_);
+		Serialize(Archive, Occupant.Glasses_);
+		Serialize(Archive, Occupant.GlassesColor_);
+		Serialize(Archive, Occupant.GlassesOpacity_);
+		Serialize(Archive, Occupant.GlassesReflective_);
+		Serialize(Archive, Occupant.Mask_);
+		Serialize(Archive, Occupant.Scarf_);
+		Serialize(Archive, Occupant.Hair_);
+		Serialize(Archive, Occupant.Beard_);
+		Serialize(Archive, Occupant.Mustache_);
+		Serialize(Archive, Occupant.PupilSize_);
+		Serialize(Archive, Occupant.PupilBrightness_);
+		Serialize(Archive, Occupant.IrisSize_);
+		Serialize(Archive, Occupant.IrisBrightness_);
+		Serialize(Archive, Occupant.IrisBorderWidth_);
+		Serialize(Archive, Occupant.LimbusDarkAmount_);
+		Serialize(Archive, Occupant.IrisColor_);
+		Serialize(Archive, Occupant.ScleraBrightness_);
+		Serialize(Archive, Occupant.ScleraVeins_);
+		Serialize(Archive, Occupant.SkinWrinkles_);
+		Serialize(Archive, Occupant.SkinRoughness_);
+		Serialize(Archive, Occupant.SkinSpecularity_);
+		Serialize(Archive, Occupant.Height_);
+		Serialize(Archive, Occupant.Seat_.Offset_);
+	}
+
+	void Serialize(CompiledScenarioArchive& Archive, YamlAnimationPoint& Point) {
+		Serialize(Archive, Point.Time_);
+		Serialize(Archive, Point.Values_);
+	}
+
+	void Serialize(CompiledScenarioArchive& Archive, YamlMotion& Motion) {
+		Serialize(Archive, Motion.Animation_);
+		Serialize(Archive, Motion.Type_);
+		Serialize(Archive, Motion.Points_);
+		Serialize(Archive, Motion.StartPos_);
+		Serialize(Archive, Motion.EndPos_);
+		Serialize(Archive, Motion.Duration_);
+		Serialize(Archive, Motion.BlendOut_);
+	}
+
+	void Serialize(CompiledScenarioArchive& Archive, YamlAnimationChannel& Channel) {
+		Serialize(Archive, Channel.Type_);
+		Serialize(Archive, Channel.Motions_);
+	}
+
+	void Serialize(CompiledScenarioArchive& Archive, YamlAnimationSequence& Sequence) {
+		Serialize(Archive, Sequence.Name_);
+		Serialize(Archive, Sequence.Type_);
+		Serialize(Archive, Sequence.Motions_);
+		Serialize(Archive, Sequence.WithParameters_);
+	}
+
+	void Serialize(CompiledScenarioArchive& Archive, YamlOccupantScenario& Scenario) {
+		Serialize(Archive, Scenario.Type_);
+		Serialize(Archive, Scenario.Motions_);
+		Serialize(Archive, Scenario.Channels_);
+	}
+
+	void Serialize(CompiledScenarioArchive& Archive, YamlSweepPose& Pose) {
+		Serialize(Archive, static_cast<YamlOrientationObj&>(Pose));
+	}
+
+	void Serialize(CompiledScenarioArchive& Archive, YamlSweepParameter& Parameter) {
+		Serialize(Archive, Parameter.Type_);
+		Serialize(Archive, Parameter.Numbers_);
+		Serialize(Archive, Parameter.Names_);
+		Serialize(Archive, Parameter.Poses_);
+	}
+
 	class DMSSimScenarioParserImpl: public DMSSimScenarioParser, public DMSSimParserBase {
 	public:
 		DMSSimScenarioParserImpl() {}
 		virtual ~DMSSimScenarioParserImpl(){}
 
 		bool Initialize(const wchar_t* const FilePath, const DMSSimConfigParser& Config);
+		bool Initialize(const std::string& Scenario, const DMSSimConfigParser& Config);
+		void Serialize(CompiledScenarioArchive& Archive);
+		std::string Compile() const override;
 
 		//getter helper methods
 		unsigned GetVersionMajor() const override { return MajorVersion_; }
@@ -674,6 +1058,7 @@ namespace {
 		const DMSSimAnimationSequence& GetAnimationSequence(size_t Index) const override { return Animations_.Sequences_.at(Index); }
 		size_t GetOccupantScenarioCount() const override { return Scenario_.Occupants_.size(); }
 		const DMSSimOccupantScenario& GetOccupantScenario(size_t Index) const override { return Scenario_.Occupants_.at(Index); }
+		size_t GetSweepSize() const override { return Sweep_.GetSize(); }
 
 		//yaml event handlers
 		YamlObj* EventHandler_description(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
@@ -702,8 +1087,21 @@ namespace {
 		YamlObj* EventHandler_scale(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
 		YamlObj* EventHandler_mirrored(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
 		YamlObj* EventHandler_fov(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
+		YamlObj* EventHandler_distortion(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
 		YamlObj* EventHandler_video_out(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
 		YamlObj* EventHandler_csv_out(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
+		YamlObj* EventHandler_thread_count(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
+		YamlObj* EventHandler_thread_type(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
+		YamlObj* EventHandler_preset(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
+		YamlObj* EventHandler_tune(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
+		YamlObj* EventHandler_lookahead(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
+		YamlObj* EventHandler_image_format(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
+		YamlObj* EventHandler_png_compression(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
+		YamlObj* EventHandler_image_thread_count(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
+		YamlObj* EventHandler_gt_format(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
+		YamlObj* EventHandler_label_mode(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
+		YamlObj* EventHandler_label_thread_count(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
+		YamlObj* EventHandler_label_delta_epsilon(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
 		YamlObj* EventHandler_min_fstop(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
 		YamlObj* EventHandler_max_fstop(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
 		YamlObj* EventHandler_focal_distance(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
@@ -727,6 +1125,7 @@ namespace {
 		YamlObj* EventHandler_eye_bounding_box_width_factor(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
 		YamlObj* EventHandler_eye_bounding_box_height_factor(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
 		YamlObj* EventHandler_eye_bounding_box_depth(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
+		YamlObj* EventHandler_sinks(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
 		YamlObj* EventHandler_steering_wheel_column(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
 		YamlObj* EventHandler_is_camera_integrated(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
 		YamlObj* EventHandler_pitch_angle(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
@@ -795,6 +1194,11 @@ namespace {
 		YamlObj* EventHandler_right_hand(const yaml_event_t* Event, YamlObj* Obj, bool Enter) { return EventHandler_animation_channel(Event, Obj, Enter, DMSSimAnimationChannelRightHand); };
 		YamlObj* EventHandler_steering_wheel(const yaml_event_t* Event, YamlObj* Obj, bool Enter) { return EventHandler_animation_channel(Event, Obj, Enter, DMSSimAnimationChannelSteeringWheel); };
 		YamlObj* EventHandler_scenario(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
+		YamlObj* EventHandler_sweep(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
+		YamlObj* EventHandler_illumination_intensity(const yaml_event_t* Event, YamlObj* Obj, bool Enter);
+		YamlObj* EventHandler_from(const yaml_event_t* Event, YamlObj* Obj, bool Enter) { return EventHandler_sweep_range(Event, Obj, Enter, "from", &YamlSweepParameter::From_); };
+		YamlObj* EventHandler_to(const yaml_event_t* Event, YamlObj* Obj, bool Enter) { return EventHandler_sweep_range(Event, Obj, Enter, "to", &YamlSweepParameter::To_); };
+		YamlObj* EventHandler_step(const yaml_event_t* Event, YamlObj* Obj, bool Enter) { return EventHandler_sweep_range(Event, Obj, Enter, "step", &YamlSweepParameter::Step_); };
 
 	protected:
 		const char* FindFunction(const yaml_event_t& Event) const override;
@@ -815,6 +1219,11 @@ namespace {
 		YamlOccupants             Occupants_;
 		YamlAnimations            Animations_;
 		YamlScenario              Scenario_;
+		YamlSweep                 Sweep_;
+		bool                      IlluminationLocationAtCamera_ = false; // the illumination follows the camera poses of the sweep
+		bool                      IlluminationRotationAtCamera_ = false;
+
+		friend class DMSSimScenarioSweepView;
 
 		bool IsOccupantExits(FDMSSimOccupantType Type);
 		bool IsOccupantScenarioExits(FDMSSimOccupantType Type);
@@ -828,6 +1237,8 @@ namespace {
 
 		YamlObj* EventHandler_animation_parameter(const yaml_event_t* Event, YamlObj* Obj, bool Enter, const char* const Parameter, bool NoPause, const std::function<void(YamlMotion*, float)>& Setter, float MinValue, float MaxValue);
 		YamlObj* EventHandler_OccupantInternal(const yaml_event_t* Event, YamlObj* Obj, bool Enter, FDMSSimOccupantType Type, const char* Name);
+		YamlObj* EventHandler_sweep_parameter(const yaml_event_t* Event, YamlObj* Obj, bool Enter, YamlSweepParameterType Type);
+		YamlObj* EventHandler_sweep_range(const yaml_event_t* Event, YamlObj* Obj, bool Enter, const char* Name, float YamlSweepParameter::* Bound);
 
 		void ValidateParameters(const DMSSimConfigParser& Config);
 		const DMSSimCoordinateSpace* GetCoordinateSpace(const DMSSimConfigParser& Config) const;
@@ -845,7 +1256,7 @@ namespace {
 			const char* const    Name;
 			ProcessYamlEventFunc Func;
 		}
-		const EventHandlers[] = {
+		constexpr EventHandlers[] = {
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(version)
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(description)
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(environment)
@@ -873,8 +1284,21 @@ namespace {
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(scale)
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(mirrored)
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(fov)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(distortion)
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(video_out)
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(csv_out)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(thread_count)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(thread_type)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(preset)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(tune)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(lookahead)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(image_format)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(png_compression)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(image_thread_count)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(gt_format)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(label_mode)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(label_thread_count)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(label_delta_epsilon)
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(min_fstop)
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(max_fstop)
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(focal_distance)
@@ -898,6 +1322,7 @@ namespace {
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(eye_bounding_box_width_factor)
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(eye_bounding_box_height_factor)
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(eye_bounding_box_depth)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(sinks)
 
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(grain_intensity)
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(grain_jitter)
@@ -975,8 +1400,16 @@ namespace {
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(steering_wheel)
 
 			DMSSIM_DEFINE_YAML_EVENT_HANDLER(scenario)
+
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(sweep)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(illumination_intensity)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(from)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(to)
+			DMSSIM_DEFINE_YAML_EVENT_HANDLER(step)
 		};
 #undef DMSSIM_DEFINE_YAML_EVENT_HANDLER
+
+		constexpr DMSSimEventHandlerIndex<int(std::size(EventHandlers))> EventHandlerIndex(EventHandlers);
 	} // anonymous namespace
 
 	bool DMSSimScenarioParserImpl::Initialize(const wchar_t* const FilePath, const DMSSimConfigParser& Config) {
@@ -985,14 +1418,75 @@ namespace {
 		return Result;
 	}
 
+	bool DMSSimScenarioParserImpl::Initialize(const std::string& Scenario, const DMSSimConfigParser& Config) {
+		const bool Result = InitializeInternal(Scenario);
+		if (Result) { ValidateParameters(Config); }
+		return Result;
+	}
+
+	/** The state of the parser after ValidateParameters, which the getters return. */
+	void DMSSimScenarioParserImpl::Serialize(CompiledScenarioArchive& Archive) {
+		uint32_t Magic = DMSSIM_COMPILED_SCENARIO_MAGIC;
+		uint32_t Version = DMSSIM_SCENARIO_CACHE_VERSION;
+		::Serialize(Archive, Magic);
+		::Serialize(Archive, Version);
+		if (Magic != DMSSIM_COMPILED_SCENARIO_MAGIC || Version != DMSSIM_SCENARIO_CACHE_VERSION) { throw std::runtime_error("Not a compiled scenario of this version"); }
+
+		::Serialize(Archive, MajorVersion_);
+		::Serialize(Archive, MinorVersion_);
+		::Serialize(Archive, Description_);
+		::Serialize(Archive, Environment_);
+		::Serialize(Archive, RandomMovements_.Blinking_);
+		::Serialize(Archive, RandomMovements_.Smiling_);
+		::Serialize(Archive, RandomMovements_.Head_);
+		::Serialize(Archive, RandomMovements_.Body_);
+		::Serialize(Archive, RandomMovements_.Gaze_);
+		::Serialize(Archive, CoordinateSpace_.CarModel_);
+		::Serialize(Archive, CoordinateSpace_.Rotation_);
+		::Serialize(Archive, CoordinateSpace_.Translation_);
+		::Serialize(Archive, CoordinateSpace_.Scale_);
+		::Serialize(Archive, CoordinateSpace_.Custom_);
+		::Serialize(Archive, static_cast<YamlOrientationObj&>(Sun_));
+		::Serialize(Archive, Sun_.Intensity_);
+		::Serialize(Archive, Sun_.Temperature_);
+		::Serialize(Archive, Car_.Model_);
+		::Serialize(Archive, Car_.Speed_);
+		::Serialize(Archive, Camera_);
+		::Serialize(Archive, GroundTruthSettings_.BoundingBoxPaddingFactor_Face_);
+		::Serialize(Archive, GroundTruthSettings_.EyeBoundingBoxWidthFactor_);
+		::Serialize(Archive, GroundTruthSettings_.EyeBoundingBoxHeightFactor_);
+		::Serialize(Archive, GroundTruthSettings_.EyeBoundingBoxDepth_);
+		::Serialize(Archive, GroundTruthSettings_.Sinks_);
+		::Serialize(Archive, static_cast<YamlOrientationObj&>(SteeringWheelColumn_));
+		::Serialize(Archive, SteeringWheelColumn_.IsCameraIntegrated_);
+		::Serialize(Archive, SteeringWheelColumn_.PitchAngle_);
+		::Serialize(Archive, Illumination_);
+		::Serialize(Archive, ChannelsParameters_.BlendOutParameters_.Defined_);
+		for (auto& Parameter : ChannelsParameters_.BlendOutParameters_.Parameters_) { ::Serialize(Archive, Parameter); }
+		::Serialize(Archive, Occupants_.Occupants_, YamlOccupant(FDMSSimOccupantType::Driver));
+		::Serialize(Archive, Animations_.Sequences_);
+		::Serialize(Archive, Scenario_.Occupants_, YamlOccupantScenario(FDMSSimOccupantType::Driver));
+		::Serialize(Archive, Sweep_.Parameters_, YamlSweepParameter(YamlSweepSunIntensity));
+		::Serialize(Archive, IlluminationLocationAtCamera_);
+		::Serialize(Archive, IlluminationRotationAtCamera_);
+	}
+
+	std::string DMSSimScenarioParserImpl::Compile() const {
+		std::string Compiled;
+		CompiledScenarioArchive Archive(Compiled);
+		// the writing archive only reads the members
+		const_cast<DMSSimScenarioParserImpl*>(this)->Serialize(Archive);
+		return Compiled;
+	}
+
 	const char* DMSSimScenarioParserImpl::FindFunction(const yaml_event_t& Event) const {
-		const auto* const Info = FindEventHandlerEx(Event, EventHandlers);
+		const auto* const Info = FindEventHandlerEx(Event, EventHandlers, EventHandlerIndex);
 		if (Info) { return Info->Name; }
 		return nullptr;
 	}
 
 	YamlObj* DMSSimScenarioParserImpl::ProcessEvent(const char* FuncName, const yaml_event_t& Event, YamlObj* Obj, bool Enter) {
-		const auto* const Info = FindEventHandler(FuncName, EventHandlers);
+		const auto* const Info = FindEventHandler(FuncName, EventHandlers, EventHandlerIndex);
 		if (Info) { return (this->*Info->Func)(&Event, Obj, Enter); }
 		return nullptr;
 	}
@@ -1120,6 +1614,7 @@ namespace {
 	}
 
 	YamlObj* DMSSimScenarioParserImpl::EventHandler_sun_intensity(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (IsSweepObj(Obj)) { return EventHandler_sweep_parameter(Event, Obj, Enter, YamlSweepSunIntensity); }
 		if (!Obj || Obj->GetYamlType() != YamlObjTypeSun) { ThrowExceptionWithLineN("sun_intensity property belongs to sun block", Event); }
 		const auto Sun = static_cast<YamlSun*>(Obj);
 		if (!Enter) {
@@ -1131,6 +1626,7 @@ namespace {
 	}
 
 	YamlObj* DMSSimScenarioParserImpl::EventHandler_sun_temperature(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (IsSweepObj(Obj)) { return EventHandler_sweep_parameter(Event, Obj, Enter, YamlSweepSunTemperature); }
 		if (!Obj || Obj->GetYamlType() != YamlObjTypeSun) { ThrowExceptionWithLineN("sun_temperature property belongs to sun block", Event); }
 		const auto Sun = static_cast<YamlSun*>(Obj);
 		if (!Enter) {
@@ -1142,6 +1638,7 @@ namespace {
 	}
 
 	YamlObj* DMSSimScenarioParserImpl::EventHandler_camera(const yaml_event_t* Event, YamlObj* Obj, bool Enter){
+		if (IsSweepObj(Obj)) { return EventHandler_sweep_parameter(Event, Obj, Enter, YamlSweepCamera); }
 		if (Obj) { ThrowExceptionWithLineN("Camera block must be on the base level", Event); }
 		return &Camera_;
 	}
@@ -1286,6 +1783,16 @@ namespace {
 		return EventHandler_fov_internal(Event, Obj, Enter, "fov", [Obj](float Value) { static_cast<YamlCamera*>(Obj)->FOV_ = Value; });
 	}
 
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_distortion(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (!Obj || Obj->GetYamlType() != YamlObjTypeCamera) { ThrowExceptionWithLineN("distortion property belongs to camera block", Event); }
+		const auto Camera = static_cast<YamlCamera*>(Obj);
+		if (!Enter) {
+			Camera->DistortionMark_ = Event->start_mark;
+			Camera->Distortion_.push_back(ParseFloatEx(Event, Event->data.scalar.value, "distortion coefficient", -DMSSIM_MAX_DISTORTION_COEFFICIENT, DMSSIM_MAX_DISTORTION_COEFFICIENT));
+		}
+		return Camera;
+	}
+
 	YamlObj* DMSSimScenarioParserImpl::EventHandler_video_out(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
 		if (!Obj || Obj->GetYamlType() != YamlObjTypeCamera) { ThrowExceptionWithLineN("video out property belongs to camera block", Event); }
 		const auto Camera = static_cast<YamlCamera*>(Obj);
@@ -1312,6 +1819,127 @@ namespace {
 		return Camera;
 	}
 
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_thread_count(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (!Obj || Obj->GetYamlType() != YamlObjTypeCamera) { ThrowExceptionWithLineN("thread count property belongs to camera block", Event); }
+		const auto Camera = static_cast<YamlCamera*>(Obj);
+		if (!Enter) { Camera->EncoderThreadCount_ = ParseIntEx(Event, Event->data.scalar.value, "thread count", 0, DMSSIM_MAX_ENCODER_THREAD_COUNT); }
+		return Camera;
+	}
+
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_thread_type(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (!Obj || Obj->GetYamlType() != YamlObjTypeCamera) { ThrowExceptionWithLineN("thread type property belongs to camera block", Event); }
+		const auto Camera = static_cast<YamlCamera*>(Obj);
+		if (!Enter) {
+			const auto Value = reinterpret_cast<const char*>(Event->data.scalar.value);
+			if (strcmp(Value, "frame") != 0 && strcmp(Value, "slice") != 0) { ThrowExceptionWithLineN("Invalid thread type option value of the camera. Must be \"frame\" or \"slice\"", Event); }
+			Camera->EncoderThreadType_ = Value;
+		}
+		return Camera;
+	}
+
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_preset(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (!Obj || Obj->GetYamlType() != YamlObjTypeCamera) { ThrowExceptionWithLineN("preset property belongs to camera block", Event); }
+		const auto Camera = static_cast<YamlCamera*>(Obj);
+		if (!Enter) {
+			static const char* const Presets[] = { "ultrafast", "superfast", "veryfast", "faster", "fast", "medium", "slow", "slower", "veryslow", "placebo" };
+			const auto Value = reinterpret_cast<const char*>(Event->data.scalar.value);
+			if (std::none_of(std::begin(Presets), std::end(Presets), [Value](const char* Preset) { return strcmp(Value, Preset) == 0; })) {
+				ThrowExceptionWithLineN((std::string("Invalid encoder preset: ") + Value).c_str(), Event);
+			}
+			Camera->EncoderPreset_ = Value;
+		}
+		return Camera;
+	}
+
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_tune(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (!Obj || Obj->GetYamlType() != YamlObjTypeCamera) { ThrowExceptionWithLineN("tune property belongs to camera block", Event); }
+		const auto Camera = static_cast<YamlCamera*>(Obj);
+		if (!Enter) {
+			static const char* const Tunes[] = { "film", "animation", "grain", "stillimage", "psnr", "ssim", "fastdecode", "zerolatency" };
+			const auto Value = reinterpret_cast<const char*>(Event->data.scalar.value);
+			if (strcmp(Value, DMSSIM_TOKEN_NONE) == 0) { Camera->EncoderTune_.clear(); }
+			else if (std::none_of(std::begin(Tunes), std::end(Tunes), [Value](const char* Tune) { return strcmp(Value, Tune) == 0; })) {
+				ThrowExceptionWithLineN((std::string("Invalid encoder tune: ") + Value).c_str(), Event);
+			}
+			else { Camera->EncoderTune_ = Value; }
+		}
+		return Camera;
+	}
+
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_lookahead(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (!Obj || Obj->GetYamlType() != YamlObjTypeCamera) { ThrowExceptionWithLineN("lookahead property belongs to camera block", Event); }
+		const auto Camera = static_cast<YamlCamera*>(Obj);
+		if (!Enter) { Camera->EncoderLookahead_ = ParseIntEx(Event, Event->data.scalar.value, "lookahead", -1, DMSSIM_MAX_ENCODER_LOOKAHEAD); }
+		return Camera;
+	}
+
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_image_format(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (!Obj || Obj->GetYamlType() != YamlObjTypeCamera) { ThrowExceptionWithLineN("image format property belongs to camera block", Event); }
+		const auto Camera = static_cast<YamlCamera*>(Obj);
+		if (!Enter) {
+			const auto Value = reinterpret_cast<const char*>(Event->data.scalar.value);
+			if (strcmp(Value, "png") != 0 && strcmp(Value, "tiff") != 0 && strcmp(Value, "raw") != 0) {
+				ThrowExceptionWithLineN("Invalid image format option value of the camera. Must be \"png\", \"tiff\" or \"raw\"", Event);
+			}
+			Camera->ImageFormat_ = Value;
+		}
+		return Camera;
+	}
+
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_png_compression(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (!Obj || Obj->GetYamlType() != YamlObjTypeCamera) { ThrowExceptionWithLineN("png compression property belongs to camera block", Event); }
+		const auto Camera = static_cast<YamlCamera*>(Obj);
+		if (!Enter) { Camera->PngCompression_ = ParseIntEx(Event, Event->data.scalar.value, "png compression", 0, DMSSIM_MAX_PNG_COMPRESSION); }
+		return Camera;
+	}
+
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_image_thread_count(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (!Obj || Obj->GetYamlType() != YamlObjTypeCamera) { ThrowExceptionWithLineN("image thread count property belongs to camera block", Event); }
+		const auto Camera = static_cast<YamlCamera*>(Obj);
+		if (!Enter) { Camera->ImageThreadCount_ = ParseIntEx(Event, Event->data.scalar.value, "image thread count", 0, DMSSIM_MAX_IMAGE_THREAD_COUNT); }
+		return Camera;
+	}
+
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_gt_format(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (!Obj || Obj->GetYamlType() != YamlObjTypeCamera) { ThrowExceptionWithLineN("gt format property belongs to camera block", Event); }
+		const auto Camera = static_cast<YamlCamera*>(Obj);
+		if (!Enter) {
+			const auto Value = reinterpret_cast<const char*>(Event->data.scalar.value);
+			if (strcmp(Value, "csv") != 0 && strcmp(Value, "columnar") != 0) {
+				ThrowExceptionWithLineN("Invalid gt format option value of the camera. Must be \"csv\" or \"columnar\"", Event);
+			}
+			Camera->GroundTruthFormat_ = Value;
+		}
+		return Camera;
+	}
+
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_label_mode(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (!Obj || Obj->GetYamlType() != YamlObjTypeCamera) { ThrowExceptionWithLineN("label mode property belongs to camera block", Event); }
+		const auto Camera = static_cast<YamlCamera*>(Obj);
+		if (!Enter) {
+			const auto Value = reinterpret_cast<const char*>(Event->data.scalar.value);
+			if (strcmp(Value, "frame") != 0 && strcmp(Value, "stream") != 0) {
+				ThrowExceptionWithLineN("Invalid label mode option value of the camera. Must be \"frame\" or \"stream\"", Event);
+			}
+			Camera->LabelMode_ = Value;
+		}
+		return Camera;
+	}
+
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_label_thread_count(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (!Obj || Obj->GetYamlType() != YamlObjTypeCamera) { ThrowExceptionWithLineN("label thread count property belongs to camera block", Event); }
+		const auto Camera = static_cast<YamlCamera*>(Obj);
+		if (!Enter) { Camera->LabelThreadCount_ = ParseIntEx(Event, Event->data.scalar.value, "label thread count", 0, DMSSIM_MAX_LABEL_THREAD_COUNT); }
+		return Camera;
+	}
+
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_label_delta_epsilon(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (!Obj || Obj->GetYamlType() != YamlObjTypeCamera) { ThrowExceptionWithLineN("label delta epsilon property belongs to camera block", Event); }
+		const auto Camera = static_cast<YamlCamera*>(Obj);
+		if (!Enter) { Camera->LabelDeltaEpsilon_ = ParseFloatEx(Event, Event->data.scalar.value, "label delta epsilon", 0.0f, DMSSIM_MAX_LABEL_DELTA_EPSILON); }
+		return Camera;
+	}
+
 	YamlObj* DMSSimScenarioParserImpl::EventHandler_noise(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
 		if (!Obj || Obj->GetYamlType() != YamlObjTypeCamera) { ThrowExceptionWithLineN("noise property belongs to camera block", Event); }
 		const auto Camera = static_cast<YamlCamera*>(Obj);
@@ -1477,6 +2105,19 @@ namespace {
 		return GroundTruthSettings;
 	}
 
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_sinks(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (!Obj || Obj->GetYamlType() != YamlObjTypeGroundTruthSettings) { ThrowExceptionWithLineN("sinks property belongs to ground truth settings block", Event); }
+		const auto GroundTruthSettings = static_cast<YamlGroundTruthSettings*>(Obj);
+		if (!Enter) {
+			const auto Value = reinterpret_cast<const char*>(Event->data.scalar.value);
+			if (strlen(Value) == 0) { ThrowExceptionWithLineN("Empty sink name", Event); }
+			auto& Sinks = GroundTruthSettings->Sinks_;
+			if (std::find(Sinks.begin(), Sinks.end(), Value) != Sinks.end()) { ThrowExceptionWithLineN((std::string("Duplicate sink: ") + Value).c_str(), Event); }
+			Sinks.push_back(Value);
+		}
+		return GroundTruthSettings;
+	}
+
 	YamlObj* DMSSimScenarioParserImpl::EventHandler_diaphragm_blade_count(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
 		if (!Obj || Obj->GetYamlType() != YamlObjTypeCamera) { ThrowExceptionWithLineN("diaphragm blade count property belongs to camera block", Event); }
 		const auto Camera = static_cast<YamlCamera*>(Obj);
@@ -1623,6 +2264,7 @@ namespace {
 	}
 
 	YamlObj* DMSSimScenarioParserImpl::EventHandler_headgear(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (IsSweepObj(Obj)) { return EventHandler_sweep_parameter(Event, Obj, Enter, YamlSweepHeadgear); }
 		if (!Obj || Obj->GetYamlType() != YamlObjTypeOccupant) { ThrowExceptionWithLineN("headgear property belongs to the \"driver/passenger\" sections", Event); }
 		const auto Occupant = static_cast<YamlOccupant*>(Obj);
 		if (!Enter) {
@@ -1645,6 +2287,7 @@ namespace {
 	}
 
 	YamlObj* DMSSimScenarioParserImpl::EventHandler_glasses(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (IsSweepObj(Obj)) { return EventHandler_sweep_parameter(Event, Obj, Enter, YamlSweepGlasses); }
 		if (!Obj || Obj->GetYamlType() != YamlObjTypeOccupant) { ThrowExceptionWithLineN("glasses property belongs to the \"driver/passenger\" sections", Event); }
 		const auto Occupant = static_cast<YamlOccupant*>(Obj);
 		if (!Enter) {
@@ -2227,6 +2870,51 @@ namespace {
 		return &Scenario_;
 	}
 
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_sweep(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (!Enter) { ThrowExceptionWithLineN("sweep block needs parameters", Event); }
+		if (Obj) { ThrowExceptionWithLineN("sweep block must be on the base level", Event); }
+		Sweep_.StartMark_ = Event->start_mark;
+		return &Sweep_;
+	}
+
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_illumination_intensity(const yaml_event_t* Event, YamlObj* Obj, bool Enter) {
+		if (!IsSweepObj(Obj)) { ThrowExceptionWithLineN("illumination_intensity property belongs to sweep block", Event); }
+		return EventHandler_sweep_parameter(Event, Obj, Enter, YamlSweepIlluminationIntensity);
+	}
+
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_sweep_parameter(const yaml_event_t* Event, YamlObj* Obj, bool Enter, const YamlSweepParameterType Type) {
+		const auto& Info = GetSweepParameterInfo(Type);
+		if (Enter) {
+			if (Obj->GetYamlType() != YamlObjTypeSweep) { ThrowExceptionWithLineN((std::string(Info.Name) + " sweep parameter belongs to sweep block").c_str(), Event); }
+			for (const auto& Parameter : Sweep_.Parameters_) {
+				if (Parameter.Type_ == Type) { ThrowExceptionWithLineN((std::string("Duplicate ") + Info.Name + " sweep parameter").c_str(), Event); }
+			}
+			Sweep_.Parameters_.emplace_back(Type);
+			Sweep_.Parameters_.back().StartMark_ = Event->start_mark;
+			return &Sweep_.Parameters_.back();
+		}
+		assert(Obj->GetYamlType() == YamlObjTypeSweepParameter);
+		const auto Parameter = static_cast<YamlSweepParameter*>(Obj);
+		const auto Value = reinterpret_cast<const char*>(Event->data.scalar.value);
+		if (strlen(Value) == 0) { ThrowExceptionWithLineN((std::string("Empty ") + Info.Name + " sweep value").c_str(), Event); }
+		if (Type == YamlSweepCamera) { ThrowExceptionWithLineN("camera sweep values must be blocks of location and rotation", Event); }
+		if (Parameter->IsNumber()) { Parameter->Numbers_.push_back(ParseFloatEx(Event, Event->data.scalar.value, Info.Name, Info.MinValue, Info.MaxValue)); }
+		else { Parameter->Names_.push_back(strcmp(Value, DMSSIM_TOKEN_NONE) == 0 ? std::string() : std::string(Value)); }
+		return Parameter;
+	}
+
+	YamlObj* DMSSimScenarioParserImpl::EventHandler_sweep_range(const yaml_event_t* Event, YamlObj* Obj, bool Enter, const char* Name, float YamlSweepParameter::* Bound) {
+		if (!Obj || Obj->GetYamlType() != YamlObjTypeSweepParameter || !static_cast<YamlSweepParameter*>(Obj)->Range_) {
+			ThrowExceptionWithLineN((std::string(Name) + " property belongs to the range of a sweep parameter").c_str(), Event);
+		}
+		const auto Parameter = static_cast<YamlSweepParameter*>(Obj);
+		if (!Enter) {
+			const auto& Info = GetSweepParameterInfo(Parameter->Type_);
+			Parameter->*Bound = ParseFloatEx(Event, Event->data.scalar.value, Name, Info.MinValue, Info.MaxValue);
+		}
+		return Parameter;
+	}
+
 	void DMSSimScenarioParserImpl::ValidateParameters(const DMSSimConfigParser& Config) {
 		const auto CoordinateSpace = GetCoordinateSpace(Config);
 		CoordinateSpace_.Recompute();
@@ -2239,9 +2927,12 @@ namespace {
 		CoordinateSpace_.Rotation_ = CoordinateSpace_.Rotation_ * static_cast<float>(180.0f / PI);
 		Sun_.Recompute(CoordinateSpace_);
 		Camera_.Recompute(CoordinateSpace_);
-		if (Illumination_.Location_.empty()) { Illumination_.Location_ = Camera_.Location_; }
-		if (Illumination_.Rotation_.empty()) { Illumination_.Rotation_ = Camera_.Rotation_; }
+		IlluminationLocationAtCamera_ = Illumination_.Location_.empty();
+		IlluminationRotationAtCamera_ = Illumination_.Rotation_.empty();
+		if (IlluminationLocationAtCamera_) { Illumination_.Location_ = Camera_.Location_; }
+		if (IlluminationRotationAtCamera_) { Illumination_.Rotation_ = Camera_.Rotation_; }
 		Illumination_.Recompute(CoordinateSpace_);
+		Sweep_.Recompute(CoordinateSpace_, Camera_);
 		for (const auto& Occupant : Occupants_.Occupants_) { Occupant.Validate(); }
 		ChannelsParameters_.Validate();
 		Animations_.Validate();
@@ -2263,9 +2954,118 @@ namespace {
 			if (strcmp(CarName, Car_.Model_.c_str()) == 0) { return &CoordinateSpace; }
 			else if (strcmp(CarName, DMSSIM_DEFAULT_COORDINATE_SPACE_NAME) == 0) { DefaultCoordinateSpace = &CoordinateSpace; }
 		}
-		if (DefaultCoordinateSpace == nullptr) { throw std::exception((std::string("Unsupported coordinate space ") + Car_.Model_).c_str()); }
+		if (DefaultCoordinateSpace == nullptr) { throw std::runtime_error((std::string("Unsupported coordinate space ") + Car_.Model_).c_str()); }
 		return DefaultCoordinateSpace;
 	}
+
+	/**
+	 * @class DMSSimScenarioSweepView
+	 * @brief One scenario of the sweep section of a parsed scenario.
+	 * All scenarios of the sweep share the parsed scenario, a view only stores what the values of its parameters override:
+	 * the sun parameters, and copies of the camera, of the illumination or of the occupants if they're swept.
+	 */
+	class DMSSimScenarioSweepView : public DMSSimScenarioParser {
+	public:
+		DMSSimScenarioSweepView(const std::shared_ptr<const DMSSimScenarioParserImpl>& Base, size_t Index);
+		virtual ~DMSSimScenarioSweepView() {}
+
+		unsigned GetVersionMajor() const override { return Base_->GetVersionMajor(); }
+		unsigned GetVersionMinor() const override { return Base_->GetVersionMinor(); }
+		const char* GetDescription() const override { return Base_->GetDescription(); }
+		const char* GetEnvironment() const override { return Base_->GetEnvironment(); }
+		bool GetRandomBlinking() const override { return Base_->GetRandomBlinking(); }
+		bool GetRandomSmiling() const override { return Base_->GetRandomSmiling(); }
+		bool GetRandomHeadMovements() const override { return Base_->GetRandomHeadMovements(); }
+		bool GetRandomBodyMovements() const override { return Base_->GetRandomBodyMovements(); }
+		bool GetRandomGaze() const override { return Base_->GetRandomGaze(); }
+		const char* GetCarModel() const override { return Base_->GetCarModel(); }
+		float GetCarSpeed() const override { return Base_->GetCarSpeed(); }
+		FRotator GetSunRotation() const override { return Base_->GetSunRotation(); }
+		float GetSunIntensity() const override { return SunIntensity_; }
+		float GetSunTemperature() const override { return SunTemperature_; }
+		const DMSSimCoordinateSpace& GetCoordinateSpace() const override { return Base_->GetCoordinateSpace(); }
+		const DMSSimCamera& GetCamera() const override { return Camera_ ? *Camera_ : Base_->GetCamera(); }
+		const DMSSimSteeringWheelColumn& GetSteeringWheelColumn() const override { return Base_->GetSteeringWheelColumn(); }
+		const DMSSimGroundTruthSettings& GetGroundTruthSettings() const override { return Base_->GetGroundTruthSettings(); }
+		const DMSSimIllumination& GetCameraIllumination() const override { return Illumination_ ? *Illumination_ : Base_->GetCameraIllumination(); }
+		float GetDefaultBlendOut(DMSSimAnimationChannelType Channel) const override { return Base_->GetDefaultBlendOut(Channel); }
+		size_t GetOccupantCount() const override { return Base_->GetOccupantCount(); }
+		const DMSSimOccupant& GetOccupant(size_t OccupantIndex) const override { return Occupants_.empty() ? Base_->GetOccupant(OccupantIndex) : Occupants_.at(OccupantIndex); }
+		size_t GetAnimationSequenceCount() const override { return Base_->GetAnimationSequenceCount(); }
+		const DMSSimAnimationSequence& GetAnimationSequence(size_t Index) const override { return Base_->GetAnimationSequence(Index); }
+		size_t GetOccupantScenarioCount() const override { return Base_->GetOccupantScenarioCount(); }
+		const DMSSimOccupantScenario& GetOccupantScenario(size_t Index) const override { return Base_->GetOccupantScenario(Index); }
+		size_t GetSweepSize() const override { return 0; }
+		std::string Compile() const override { throw std::runtime_error("A scenario of a sweep can't be compiled, its parsed scenario can"); }
+
+	private:
+		YamlIllumination& GetIllumination();
+		std::vector<YamlOccupant>& GetOccupants();
+		void SetCameraPose(const YamlSweepPose& Pose);
+
+		std::shared_ptr<const DMSSimScenarioParserImpl> Base_;
+		float                             SunIntensity_;
+		float                             SunTemperature_;
+		std::unique_ptr<YamlCamera>       Camera_;       // nullptr - the camera of the parsed scenario
+		std::unique_ptr<YamlIllumination> Illumination_; // nullptr - the illumination of the parsed scenario
+		std::vector<YamlOccupant>         Occupants_;    // empty - the occupants of the parsed scenario
+	};
+
+	DMSSimScenarioSweepView::DMSSimScenarioSweepView(const std::shared_ptr<const DMSSimScenarioParserImpl>& Base, size_t Index)
+		: Base_(Base), SunIntensity_(Base->Sun_.Intensity_), SunTemperature_(Base->Sun_.Temperature_) {
+		const auto& Parameters = Base_->Sweep_.Parameters_;
+		for (auto Parameter = Parameters.rbegin(); Parameter != Parameters.rend(); ++Parameter) {
+			const size_t ValueIndex = Index % Parameter->GetValueCount();
+			Index /= Parameter->GetValueCount();
+			switch (Parameter->Type_) {
+			case YamlSweepSunIntensity:
+				SunIntensity_ = Parameter->Numbers_[ValueIndex];
+				break;
+			case YamlSweepSunTemperature:
+				SunTemperature_ = Parameter->Numbers_[ValueIndex];
+				break;
+			case YamlSweepIlluminationIntensity:
+				GetIllumination().Intensity_ = Parameter->Numbers_[ValueIndex];
+				break;
+			case YamlSweepCamera:
+				SetCameraPose(Parameter->Poses_[ValueIndex]);
+				break;
+			case YamlSweepGlasses:
+				for (auto& Occupant : GetOccupants()) { Occupant.Glasses_ = Parameter->Names_[ValueIndex]; }
+				break;
+			case YamlSweepHeadgear:
+				for (auto& Occupant : GetOccupants()) { Occupant.Headgear_ = Parameter->Names_[ValueIndex]; }
+				break;
+			}
+		}
+	}
+
+	YamlIllumination& DMSSimScenarioSweepView::GetIllumination() {
+		if (!Illumination_) { Illumination_ = std::make_unique<YamlIllumination>(Base_->Illumination_); }
+		return *Illumination_;
+	}
+
+	std::vector<YamlOccupant>& DMSSimScenarioSweepView::GetOccupants() {
+		if (Occupants_.empty()) { Occupants_ = Base_->Occupants_.Occupants_; }
+		return Occupants_;
+	}
+
+	/** The illumination at the camera in the scenario file moves with the camera. */
+	void DMSSimScenarioSweepView::SetCameraPose(const YamlSweepPose& Pose) {
+		Camera_ = std::make_unique<YamlCamera>(Base_->Camera_);
+		Camera_->Location_ = Pose.Location_;
+		Camera_->Rotation_ = Pose.Rotation_;
+		Camera_->PositionFinal_ = Pose.PositionFinal_;
+		Camera_->RotationFinal_ = Pose.RotationFinal_;
+		if (Base_->IlluminationLocationAtCamera_) {
+			GetIllumination().Location_ = Pose.Location_;
+			GetIllumination().PositionFinal_ = Pose.PositionFinal_;
+		}
+		if (Base_->IlluminationRotationAtCamera_) {
+			GetIllumination().Rotation_ = Pose.Rotation_;
+			GetIllumination().RotationFinal_ = Pose.RotationFinal_;
+		}
+	}
 } // anonymous namespace
 
 DMSSimScenarioParser* DMSSimScenarioParser::Create(const wchar_t* const FilePath, const DMSSimConfigParser& Config) {
@@ -2274,6 +3074,38 @@ DMSSimScenarioParser* DMSSimScenarioParser::Create(const wchar_t* const FilePath
 	return 	nullptr;
 }
 
+DMSSimScenarioParser* DMSSimScenarioParser::Create(const std::string& Scenario, const DMSSimConfigParser& Config) {
+	auto Parser = std::make_unique<DMSSimScenarioParserImpl>();
+	if (Parser->Initialize(Scenario, Config)) { return Parser.release(); }
+	return nullptr;
+}
+
+DMSSimScenarioParser* DMSSimScenarioParser::Load(const void* const Data, const size_t Size) {
+	auto Parser = std::make_unique<DMSSimScenarioParserImpl>();
+	CompiledScenarioArchive Archive(static_cast<const char*>(Data), Size);
+	try {
+		Parser->Serialize(Archive);
+		if (!Archive.IsAtEnd()) { return nullptr; }
+	}
+	catch (const std::runtime_error&) { return nullptr; }
+	return Parser.release();
+}
+
+std::vector<DMSSimScenarioParser*> DMSSimScenarioParser::ExpandSweep(DMSSimScenarioParser* const Parser) {
+	if (!Parser || Parser->GetSweepSize() == 0) { return { Parser }; }
+	// only the parsed scenarios have a sweep section, their views don't
+	const std::shared_ptr<const DMSSimScenarioParserImpl> Base(static_cast<DMSSimScenarioParserImpl*>(Parser));
+	const size_t Size = Base->GetSweepSize();
+	std::vector<std::unique_ptr<DMSSimScenarioParser>> Views;
+	Views.reserve(Size);
+	for (size_t i = 0; i < Size; ++i) { Views.push_back(std::make_unique<DMSSimScenarioSweepView>(Base, i)); }
+
+	std::vector<DMSSimScenarioParser*> Scenarios;
+	Scenarios.reserve(Size);
+	for (auto& View : Views) { Scenarios.push_back(View.release()); }
+	return Scenarios;
+}
+
 const DMSSimCoordinateSpace& DMSSimScenarioParser::GetDefaultCoordinateSpace() { return DefaultCoordinateSpaceObj; }
 
 const DMSSimCamera& DMSSimScenarioParser::GetDefaultCamera() { return DefaultCamera; }
@@ -2,6 +2,10 @@
 
 #include "DMSSimConfigParser.h"
 #include "DMSSimOccupantType.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 constexpr unsigned DMSSIM_DEFAULT_FRAME_WIDTH = 1312;
 constexpr unsigned DMSSIM_DEFAULT_FRAME_HEIGHT = 1008;
@@ -10,6 +14,8 @@ constexpr int      DMSSIM_MAX_RESOLUTION_DIMENSION = 8192;
 constexpr float DMSSIM_DEFAULT_FOV = 43.6f;
 constexpr float DMSSIM_MIN_FOV = 5.0f;
 constexpr float DMSSIM_MAX_FOV = 165.0f;
+constexpr int   DMSSIM_DISTORTION_COEFFICIENT_COUNT = 5; // k1, k2, p1, p2, k3 in the order of OpenCV and of the distortion_coeffs of the labels
+constexpr float DMSSIM_MAX_DISTORTION_COEFFICIENT = 10.0f;
 constexpr int   DMSSIM_DEFAULT_FRAME_RATE = 60;
 constexpr int   DMSSIM_MAX_FRAME_RATE = 120;
 
@@ -27,6 +33,23 @@ constexpr float DMSSIM_MAX_FSTOP = 100.0f;
 constexpr float DMSSIM_MIN_FOCAL_DISTANCE = 0.0f;
 constexpr float DMSSIM_MAX_FOCAL_DISTANCE = 10.0f;
 
+constexpr int DMSSIM_MAX_ENCODER_THREAD_COUNT = 64;
+constexpr int DMSSIM_MAX_ENCODER_LOOKAHEAD = 250;
+constexpr char DMSSIM_DEFAULT_ENCODER_PRESET[] = "slow";
+constexpr char DMSSIM_DEFAULT_ENCODER_THREAD_TYPE[] = "frame";
+
+constexpr char DMSSIM_DEFAULT_IMAGE_FORMAT[] = "png";
+constexpr char DMSSIM_DEFAULT_GROUND_TRUTH_FORMAT[] = "csv";
+constexpr char DMSSIM_DEFAULT_LABEL_MODE[] = "frame";
+constexpr int  DMSSIM_DEFAULT_LABEL_THREAD_COUNT = 2;
+constexpr int  DMSSIM_MAX_LABEL_THREAD_COUNT = 64;
+constexpr float DMSSIM_DEFAULT_LABEL_DELTA_EPSILON = 0.0f;
+constexpr float DMSSIM_MAX_LABEL_DELTA_EPSILON = 100.0f;
+constexpr int  DMSSIM_MAX_PNG_COMPRESSION = 9;
+constexpr int  DMSSIM_DEFAULT_PNG_COMPRESSION = 3;
+constexpr int  DMSSIM_DEFAULT_IMAGE_THREAD_COUNT = 0; // half of the cores, at most 8
+constexpr int  DMSSIM_MAX_IMAGE_THREAD_COUNT = 64;
+
 constexpr int DMSSIM_MIN_DIAPHRAGM_BLADE_COUNT = 1;
 constexpr int DMSSIM_MAX_DIAPHRAGM_BLADE_COUNT = 20;
 constexpr int DMSSIM_DEFAULT_DIAPHRAGM_BLADE_COUNT = 5;
@@ -59,6 +82,10 @@ constexpr float DMSSIM_MIN_GLASSES_OPACITY = 0.0f;
 constexpr float DMSSIM_MAX_GLASSES_OPACITY = 1.0f;
 constexpr float DMSSIM_DEFAULT_GLASSES_OPACITY = 0.2f;
 
+constexpr size_t DMSSIM_MAX_SWEEP_SIZE = 100000; // scenarios of the sweep section of a scenario file
+
+
+constexpr uint32_t DMSSIM_SCENARIO_CACHE_VERSION = 3; // must be increased with every change of the parser or of the compiled scenario format
 
 constexpr char DMSSIM_TOKEN_NONE[] = "none";
 
@@ -218,6 +245,8 @@ public:
 	virtual float					GetEyeBoundingBoxWidthFactor() const = 0;
 	virtual float					GetEyeBoundingBoxHeightFactor() const = 0;
 	virtual float					GetEyeBoundingBoxDepth() const = 0;
+	virtual size_t					GetSinkCount() const = 0;                // 0 - the outputs selected by video_out and csv_out of the camera
+	virtual const char*				GetSink(size_t SinkIndex) const = 0;     // name of a DMSSimRecordingSinkRegistry entry
 };
 
 
@@ -237,6 +266,8 @@ public:
 	virtual FRotator				GetRotation() const = 0;
 	virtual bool					GetMirrored() const = 0;
 	virtual float					GetFOV() const = 0;
+	virtual size_t					GetDistortionCount() const = 0;    // 0 - no lens distortion, DMSSIM_DISTORTION_COEFFICIENT_COUNT - Brown-Conrady model
+	virtual float					GetDistortion(size_t Index) const = 0;
 
 	virtual float					GetNoise() const = 0;
 	virtual float					GetBlur() const = 0;
@@ -253,6 +284,19 @@ public:
 	virtual float					GetContrast() const = 0;
 	virtual float					GetBloomIntensity() const = 0;
 	virtual float					GetFocusOffset() const = 0;
+
+	virtual int						GetEncoderThreadCount() const = 0; // 0 - chosen by the encoder
+	virtual const char*				GetEncoderThreadType() const = 0;  // "frame" or "slice"
+	virtual const char*				GetEncoderPreset() const = 0;
+	virtual const char*				GetEncoderTune() const = 0;        // empty - no tuning
+	virtual int						GetEncoderLookahead() const = 0;   // -1 - encoder default, also if omitted
+	virtual const char*				GetImageFormat() const = 0;        // "png", "tiff" or "raw", used if there is no video output
+	virtual int						GetPngCompression() const = 0;     // zlib level, 0 - 9
+	virtual int						GetImageThreadCount() const = 0;   // 0 - half of the cores, number of writer threads for the image output
+	virtual const char*				GetGroundTruthFormat() const = 0;  // "csv" or "columnar", used if there is csv output
+	virtual const char*				GetLabelMode() const = 0;          // "frame" - a json file per frame, "stream" - one json file per scenario
+	virtual int						GetLabelThreadCount() const = 0;   // 0 - labels serialized by the recording thread, number of label serialization threads
+	virtual float					GetLabelDeltaEpsilon() const = 0;  // max change of a label value the openlabel_delta sink doesn't write, 0 - every change
 };
 
 /**
@@ -310,6 +354,45 @@ public:
 	 */
 	static DMSSimScenarioParser* Create(const wchar_t* const FilePath, const DMSSimConfigParser& Config);
 
+	/**
+	 * Create Scenario Parser Object from the text of a scenario file
+	 *
+	 * @param[in] Scenario Content of a scenario file
+	 * @param[in] Config   Coordinate space configurations for different car models
+	 *
+	 * @return Parser object
+	 */
+	static DMSSimScenarioParser* Create(const std::string& Scenario, const DMSSimConfigParser& Config);
+
+	/**
+	 * The parsed and validated scenario as a compiled scenario, a flat binary Load turns back into an equal parser.
+	 * The binary is in the byte order of the machine and is only valid for DMSSIM_SCENARIO_CACHE_VERSION.
+	 */
+	virtual std::string Compile() const = 0;
+
+	/**
+	 * Create Scenario Parser Object from a compiled scenario, without the yaml parsing and the validation
+	 *
+	 * @param[in] Data Compiled scenario, e.g. a cache file read or mapped into memory
+	 * @param[in] Size Size of the compiled scenario in bytes
+	 *
+	 * @return Parser object, nullptr if the data isn't a compiled scenario of DMSSIM_SCENARIO_CACHE_VERSION
+	 */
+	static DMSSimScenarioParser* Load(const void* Data, size_t Size);
+
+	/** Number of scenarios the sweep section of the scenario expands into, 0 - no sweep section. */
+	virtual size_t GetSweepSize() const = 0;
+
+	/**
+	 * Expand the sweep section of a parsed scenario into its scenarios
+	 *
+	 * @param[in] Parser Parsed scenario, owned by the returned scenarios afterwards
+	 *
+	 * @return Scenarios of the sweep, which share the parsed scenario and only store the values of the swept parameters,
+	 *         the parser itself if the scenario has no sweep section
+	 */
+	static std::vector<DMSSimScenarioParser*> ExpandSweep(DMSSimScenarioParser* Parser);
+
 	static const DMSSimCoordinateSpace& GetDefaultCoordinateSpace();
 	static const DMSSimCamera& GetDefaultCamera();
 	static DMSSimBaseAnimationType GetChannelBaseAnimationType(DMSSimAnimationChannelType Channel);
@@ -1,17 +1,97 @@
 #include "DMSSimScenarioParserUtils.h"
 #include "DMSSimLog.h"
+#include "DMSSimUtils.h"
+#include "Async/ParallelFor.h"
 #include "GenericPlatform/GenericPlatformMisc.h"
 #include "Misc/Paths.h"
 #include "Templates/SharedPointer.h"
 #include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformTime.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <regex>
+#include <string>
 
 namespace {
 	constexpr char DMSSIM_DEFAULT_CONFIG_PATH[] = "DMSSIM_DEFAULT_CONFIG";
 	constexpr char DMSSIM_DEFAULT_CONFIG_NAME[] = "config.yml";
 	constexpr char DMSSIM_DEFAULT_CONFIG_FOLDER[] = "Plugins/DMSSimCore/Source/DMSSimCore/Public/";
+	constexpr char DMSSIM_SCENARIO_CACHE_PATH[] = "DMSSIM_SCENARIO_CACHE";
+	constexpr char DMSSIM_COMPILED_SCENARIO_EXTENSION[] = ".dmsscn";
+
+	/** A parsed config file and the hash of its content. */
+	struct ScenarioConfig {
+		TSharedPtr<DMSSimConfigParser> Parser;
+		uint64_t                       Hash = 0;
+	};
+
+	/** A parsed config file, reused while the file isn't modified. */
+	struct CachedConfig {
+		std::filesystem::file_time_type  WriteTime;
+		ScenarioConfig                   Config;
+	};
+
+	double GetMilliseconds(const double StartSeconds) { return (FPlatformTime::Seconds() - StartSeconds) * 1000.0; }
+
+	/** 64 bit FNV-1a of the bytes, continuing from Hash. */
+	uint64_t HashBytes(const void* const Data, const size_t Size, uint64_t Hash = 14695981039346656037ull) {
+		const auto* const Bytes = static_cast<const unsigned char*>(Data);
+		for (size_t i = 0; i < Size; ++i) { Hash = (Hash ^ Bytes[i]) * 1099511628211ull; }
+		return Hash;
+	}
+
+	std::string ReadFile(const std::filesystem::path& FilePath, const std::ios::openmode Mode) {
+		std::ifstream File(FilePath, std::ios::in | Mode);
+		return std::string((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+	}
+
+	/** The file name of the compiled scenario, the hash of the parser version, the scenario text and the config file. */
+	std::string GetCompiledScenarioName(const std::string& Scenario, const uint64_t ConfigHash) {
+		uint64_t Hash = HashBytes(&DMSSIM_SCENARIO_CACHE_VERSION, sizeof(DMSSIM_SCENARIO_CACHE_VERSION));
+		Hash = HashBytes(Scenario.data(), Scenario.size(), Hash);
+		Hash = HashBytes(&ConfigHash, sizeof(ConfigHash), Hash);
+		char Name[32] = {};
+		snprintf(Name, sizeof(Name), "%016llx", static_cast<unsigned long long>(Hash));
+		return std::string(Name) + DMSSIM_COMPILED_SCENARIO_EXTENSION;
+	}
+
+	/**
+	 * The compiled scenario is written to a temporary file, which replaces the cache file,
+	 * so the parallel loads and the other simulation processes only read complete compiled scenarios.
+	 * A cache that can't be written is logged, the scenario is still used.
+	 */
+	void WriteCompiledScenario(const std::filesystem::path& CachePath, const std::string& Compiled) {
+		std::error_code Error;
+		std::filesystem::create_directories(CachePath.parent_path(), Error);
+		static std::mutex Mutex;
+		static std::mt19937_64 Random(std::random_device{}());
+		auto TemporaryPath = CachePath;
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			TemporaryPath += "." + std::to_string(Random()) + ".tmp";
+		}
+		bool Written = false;
+		{
+			std::ofstream File(TemporaryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+			Written = File.write(Compiled.data(), Compiled.size()).good();
+		}
+		if (Written) { std::filesystem::rename(TemporaryPath, CachePath, Error); }
+		if (!Written || Error) {
+			DMSSimLog::Error() << "Failed to write the compiled scenario " << CachePath.wstring() << FL;
+			std::filesystem::remove(TemporaryPath, Error);
+		}
+	}
 } // anonymous namespace
 
-static TSharedPtr<DMSSimConfigParser> GetConfig(const FString& DirectoryPath) {
+static FString FindConfigPath(const FString& DirectoryPath) {
 	FString ConfigPath = "";
 
 	ConfigPath = FPaths::ConvertRelativePathToFull(DirectoryPath, DMSSIM_DEFAULT_CONFIG_NAME);
@@ -42,29 +122,78 @@ static TSharedPtr<DMSSimConfigParser> GetConfig(const FString& DirectoryPath) {
 	}
 
 	if (ConfigPath.IsEmpty()) { throw std::runtime_error("Could not find the configuration file"); }
+	return ConfigPath;
+}
+
+/** The config of the directory, parsed once for all scenarios and loads of the directory while the file doesn't change. */
+static ScenarioConfig GetConfig(const FString& DirectoryPath) {
+	static std::mutex Mutex;
+	static std::map<std::wstring, CachedConfig> Cache;
 
-	return TSharedPtr<DMSSimConfigParser>(DMSSimConfigParser::Create(*ConfigPath));
+	const auto ConfigPath = FStringToWide(FindConfigPath(DirectoryPath));
+	std::error_code Error;
+	const auto WriteTime = std::filesystem::last_write_time(std::filesystem::path(ConfigPath), Error);
+	std::lock_guard<std::mutex> Lock(Mutex);
+	const auto Cached = Cache.find(ConfigPath);
+	if (!Error && Cached != Cache.end() && Cached->second.WriteTime == WriteTime) { return Cached->second.Config; }
+
+	ScenarioConfig Config;
+	Config.Parser = MakeShareable(DMSSimConfigParser::Create(ConfigPath.c_str()));
+	const auto Content = ReadFile(std::filesystem::path(ConfigPath), std::ios::binary);
+	Config.Hash = HashBytes(Content.data(), Content.size());
+	if (!Error && Config.Parser) { Cache[ConfigPath] = CachedConfig{ WriteTime, Config }; }
+	return Config;
 }
 
-TSharedPtr<DMSSimScenarioParser> CreateScenarioParser(const FString& FilePath) {
-	const auto DirectoryPath = FPaths::GetPath(FilePath);
-	const auto Config = GetConfig(DirectoryPath);
-	return MakeShareable(DMSSimScenarioParser::Create(*FilePath, *Config));
+/**
+ * The scenario from its compiled scenario in the cache directory, or parsed and compiled into the cache directory on a miss.
+ * The scenario is parsed from the same text its compiled scenario is keyed by. Without a cache directory, the scenario is just parsed.
+ */
+static std::unique_ptr<DMSSimScenarioParser> ParseScenario(const FString& FilePath, const ScenarioConfig& Config, const FString& CacheDirectory) {
+	if (CacheDirectory.IsEmpty()) { return std::unique_ptr<DMSSimScenarioParser>(DMSSimScenarioParser::Create(*FilePath, *Config.Parser)); }
+
+	const auto Scenario = ReadFile(std::filesystem::path(FStringToWide(FilePath)), std::ios::in);
+	const auto CachePath = std::filesystem::path(FStringToWide(CacheDirectory)) / GetCompiledScenarioName(Scenario, Config.Hash);
+	const auto Compiled = ReadFile(CachePath, std::ios::binary);
+	if (!Compiled.empty()) {
+		std::unique_ptr<DMSSimScenarioParser> Parser(DMSSimScenarioParser::Load(Compiled.data(), Compiled.size()));
+		if (Parser) { return Parser; }
+		DMSSimLog::Info() << "Invalid compiled scenario " << CachePath.wstring() << ", the scenario is parsed again" << FL;
+	}
+
+	std::unique_ptr<DMSSimScenarioParser> Parser(DMSSimScenarioParser::Create(Scenario, *Config.Parser));
+	if (Parser) { WriteCompiledScenario(CachePath, Parser->Compile()); }
+	return Parser;
 }
 
-std::vector<TSharedPtr<DMSSimScenarioParser>> CreateScenarioParsers(const FString& DirectoryPath) {
-	const auto Config = GetConfig(DirectoryPath);
-	std::vector<TSharedPtr<DMSSimScenarioParser>> Result;
-	const auto FileVisitor = [&Result, &Config](const TCHAR* FilePath, bool bIsDirectory) -> bool {
+/** The scenarios of a parsed scenario, the scenarios of its sweep section or the scenario itself. */
+static std::vector<TSharedPtr<DMSSimScenarioParser>> ExpandScenario(std::unique_ptr<DMSSimScenarioParser> Parser) {
+	std::vector<TSharedPtr<DMSSimScenarioParser>> Scenarios;
+	if (!Parser) { return Scenarios; }
+	for (auto* const Scenario : DMSSimScenarioParser::ExpandSweep(Parser.release())) { Scenarios.push_back(MakeShareable(Scenario)); }
+	return Scenarios;
+}
+
+/** True if the file has a sweep section on the base level, e.g. "sweep:". */
+static bool HasSweepSection(const FString& FilePath) {
+	std::ifstream File{ std::filesystem::path(FStringToWide(FilePath)) };
+	static const std::regex SweepRegex("sweep\\s*:.*");
+	std::string Line;
+	while (std::getline(File, Line)) {
+		if (std::regex_match(Line, SweepRegex)) { return true; }
+	}
+	return false;
+}
+
+/** The files of the directory to load as scenarios, in the order of the directory iteration. */
+static std::vector<FString> GetScenarioFiles(const FString& DirectoryPath) {
+	std::vector<FString> Files;
+	const auto FileVisitor = [&Files](const TCHAR* FilePath, bool bIsDirectory) -> bool {
 		if (!bIsDirectory) {
 			if (FPaths::GetCleanFilename(FilePath) == FString(DMSSIM_DEFAULT_CONFIG_NAME)) {
 				DMSSimLog::Info() << "File with default config name detected in input folder, it's not loaded as scenario" << FL;
 			} else {
-				auto Parser = DMSSimScenarioParser::Create(FilePath, *Config);
-				if(Parser != nullptr) {
-					DMSSimLog::Info() << "Loaded scenario: " << FilePath << FL;
-					Result.push_back(MakeShareable(Parser));
-				}
+				Files.push_back(FilePath);
 			}
 		}
 		return true; // Continue iteration
@@ -73,5 +202,108 @@ std::vector<TSharedPtr<DMSSimScenarioParser>> CreateScenarioParsers(const FStrin
 	IPlatformFile& FileManager = FPlatformFileManager::Get().GetPlatformFile();
 	// Iterate over the directory
 	FileManager.IterateDirectory(*DirectoryPath, FileVisitor);
+	// the order of IterateDirectory depends on the platform, the scenarios run in the order of the file names
+	std::sort(Files.begin(), Files.end());
+	return Files;
+}
+
+TSharedPtr<DMSSimScenarioParser> DMSSimScenarioEntry::Get() {
+	if (!Parser_ && Config_) {
+		const double Start = FPlatformTime::Seconds();
+		auto Parser = ParseScenario(FilePath_, ScenarioConfig{ Config_, ConfigHash_ }, GetScenarioCacheDirectory());
+		if (!Parser) { throw std::runtime_error("Failed to parse scenario " + std::string(TCHAR_TO_UTF8(*FilePath_))); }
+		// the sweeps are expanded when the directory is indexed, a sweep section added since then would change the scenario indices
+		if (Parser->GetSweepSize() > 0) { throw std::runtime_error("Sweep section added to the indexed scenario " + std::string(TCHAR_TO_UTF8(*FilePath_))); }
+		Parser_ = MakeShareable(Parser.release());
+		DMSSimLog::Info() << "Loaded scenario: " << FilePath_ << " in " << GetMilliseconds(Start) << " ms" << FL;
+	}
+	return Parser_;
+}
+
+bool IsScenarioHeaderValid(const FString& FilePath) {
+	std::ifstream File{ std::filesystem::path(FStringToWide(FilePath)) };
+	std::string Line;
+	while (std::getline(File, Line)) {
+		const auto Begin = Line.find_first_not_of(" \t\r");
+		if (Begin == std::string::npos || Line[Begin] == '#' || Line.compare(Begin, 3, "---") == 0) { continue; }
+		// the version format of DMSSimParserBase::EventHandler_version
+		static const std::regex VersionRegex("version\\s*:\\s*\"?\\d{1}\\.\\d{1,2}\"?\\s*(#.*)?\\s*");
+		return std::regex_match(Line, VersionRegex);
+	}
+	return false;
+}
+
+FString GetScenarioCacheDirectory() { return FGenericPlatformMisc::GetEnvironmentVariable(*FString(DMSSIM_SCENARIO_CACHE_PATH)); }
+
+TSharedPtr<DMSSimScenarioParser> CreateScenarioParser(const FString& FilePath) { return CreateScenarioParser(FilePath, GetScenarioCacheDirectory()); }
+
+TSharedPtr<DMSSimScenarioParser> CreateScenarioParser(const FString& FilePath, const FString& CacheDirectory) {
+	const auto DirectoryPath = FPaths::GetPath(FilePath);
+	const auto Config = GetConfig(DirectoryPath);
+	return MakeShareable(ParseScenario(FilePath, Config, CacheDirectory).release());
+}
+
+std::vector<TSharedPtr<DMSSimScenarioParser>> CreateScenarioSweep(const FString& FilePath) {
+	const auto Config = GetConfig(FPaths::GetPath(FilePath));
+	return ExpandScenario(ParseScenario(FilePath, Config, GetScenarioCacheDirectory()));
+}
+
+std::vector<TSharedPtr<DMSSimScenarioParser>> CreateScenarioParsers(const FString& DirectoryPath) {
+	const double Start = FPlatformTime::Seconds();
+	const auto Config = GetConfig(DirectoryPath);
+	const auto Files = GetScenarioFiles(DirectoryPath);
+	const auto CacheDirectory = GetScenarioCacheDirectory();
+
+	std::vector<std::vector<TSharedPtr<DMSSimScenarioParser>>> Parsers(Files.size());
+	std::vector<std::exception_ptr> Errors(Files.size());
+	std::vector<double> ParseTimes(Files.size());
+	ParallelFor(int32(Files.size()), [&](const int32 i) {
+		const double ParseStart = FPlatformTime::Seconds();
+		try { Parsers[i] = ExpandScenario(ParseScenario(Files[i], Config, CacheDirectory)); }
+		catch (...) { Errors[i] = std::current_exception(); }
+		ParseTimes[i] = GetMilliseconds(ParseStart);
+	});
+
+	std::vector<TSharedPtr<DMSSimScenarioParser>> Result;
+	for (size_t i = 0; i < Files.size(); ++i) {
+		if (Errors[i]) {
+			DMSSimLog::Error() << "Failed to load scenario: " << Files[i] << FL;
+			std::rethrow_exception(Errors[i]);
+		}
+		if (!Parsers[i].empty()) {
+			DMSSimLog::Info() << "Loaded scenario: " << Files[i] << " in " << ParseTimes[i] << " ms" << FL;
+			if (Parsers[i].size() > 1) { DMSSimLog::Info() << "Expanded the sweep of " << Files[i] << " into " << Parsers[i].size() << " scenarios" << FL; }
+			Result.insert(Result.end(), Parsers[i].begin(), Parsers[i].end());
+		}
+	}
+	DMSSimLog::Info() << "Loaded " << Result.size() << " scenarios in " << GetMilliseconds(Start) << " ms" << FL;
+	return Result;
+}
+
+std::vector<DMSSimScenarioEntry> IndexScenarioParsers(const FString& DirectoryPath) {
+	const double Start = FPlatformTime::Seconds();
+	const auto Config = GetConfig(DirectoryPath);
+	const auto Files = GetScenarioFiles(DirectoryPath);
+
+	std::vector<char> Valid(Files.size());
+	std::vector<char> Sweep(Files.size());
+	ParallelFor(int32(Files.size()), [&](const int32 i) {
+		Valid[i] = IsScenarioHeaderValid(Files[i]);
+		Sweep[i] = Valid[i] && HasSweepSection(Files[i]);
+	});
+
+	std::vector<DMSSimScenarioEntry> Result;
+	for (size_t i = 0; i < Files.size(); ++i) {
+		if (!Valid[i]) { throw std::runtime_error("Scenario " + std::string(TCHAR_TO_UTF8(*Files[i])) + " doesn't start with a valid version"); }
+		if (!Sweep[i]) {
+			Result.emplace_back(Files[i], Config.Parser, Config.Hash);
+			continue;
+		}
+		// the number of scenarios of a sweep is only known after the parse
+		const auto Scenarios = ExpandScenario(ParseScenario(Files[i], Config, GetScenarioCacheDirectory()));
+		if (Scenarios.empty()) { throw std::runtime_error("Failed to parse scenario " + std::string(TCHAR_TO_UTF8(*Files[i]))); }
+		Result.insert(Result.end(), Scenarios.begin(), Scenarios.end());
+	}
+	DMSSimLog::Info() << "Indexed " << Result.size() << " scenarios in " << GetMilliseconds(Start) << " ms" << FL;
 	return Result;
 }
@@ -1,20 +1,76 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 #include "Containers/UnrealString.h"
 #include "DMSSimScenarioParser.h"
 
+/**
+ * @class DMSSimScenarioEntry
+ * @brief Scenario of a directory, parsed when the directory is loaded or, if the directory was only indexed, on the first Get.
+ */
+class DMSSimScenarioEntry {
+public:
+	DMSSimScenarioEntry(const TSharedPtr<DMSSimScenarioParser>& Parser) : Parser_(Parser) {}
+	DMSSimScenarioEntry(const FString& FilePath, const TSharedPtr<DMSSimConfigParser>& Config, uint64_t ConfigHash) : FilePath_(FilePath), Config_(Config), ConfigHash_(ConfigHash) {}
+
+	/** The parser of the scenario. An indexed scenario is parsed on the first call, which throws the errors of the parse. */
+	TSharedPtr<DMSSimScenarioParser> Get();
+
+	bool IsParsed() const { return Parser_.IsValid(); }
+	const FString& GetFilePath() const { return FilePath_; }
+
+private:
+	FString                          FilePath_;
+	TSharedPtr<DMSSimConfigParser>   Config_;
+	uint64_t                         ConfigHash_ = 0;
+	TSharedPtr<DMSSimScenarioParser> Parser_;
+};
+
+/**
+ * Directory of the compiled scenarios, taken from DMSSIM_SCENARIO_CACHE environment variable.
+ * Empty if it's not set, then the scenarios are parsed on every load.
+ */
+FString GetScenarioCacheDirectory();
+
 /**
  * Helper function to create scenario parser.
  * The configuration (coordinate space) file path is taken from DMSSIM_DEFAULT_CONFIG environment variable,
  * or from Plugins/DMSSimCore/Source/DMSSimCore/Public/config.yml if it's not set.
+ * The sweep section of the scenario isn't expanded, see CreateScenarioSweep.
  */
 TSharedPtr<DMSSimScenarioParser> CreateScenarioParser(const FString& FilePath);
 
+/**
+ * The scenarios of a scenario file, the scenarios its sweep section expands into or the scenario itself.
+ * The scenarios of a sweep share the parsed scenario, see DMSSimScenarioParser::ExpandSweep.
+ */
+std::vector<TSharedPtr<DMSSimScenarioParser>> CreateScenarioSweep(const FString& FilePath);
+
+/**
+ * CreateScenarioParser with a cache of compiled scenarios, see DMSSimScenarioParser::Compile.
+ * The compiled scenarios are keyed by the hash of the scenario file, the config file and DMSSIM_SCENARIO_CACHE_VERSION,
+ * on a hit the yaml parsing and the validation of the parameters are skipped. An empty CacheDirectory disables the cache.
+ */
+TSharedPtr<DMSSimScenarioParser> CreateScenarioParser(const FString& FilePath, const FString& CacheDirectory);
+
 /**
  * Helper function to create vector of scenario parsers.
  * The configuration (coordinate space) file path is taken from DMSSIM_DEFAULT_CONFIG environment variable,
  * or from Plugins/DMSSimCore/Source/DMSSimCore/Public/config.yml if it's not set.
+ * The files are parsed in parallel, the parsers are in the order of the file names. The first error in that order is thrown.
+ * The compiled scenarios of GetScenarioCacheDirectory are used, if it's set.
+ * A scenario with a sweep section is replaced by the scenarios of its sweep.
  */
-std::vector<TSharedPtr<DMSSimScenarioParser>> CreateScenarioParsers(const FString& DirectoryPath);
\ No newline at end of file
+std::vector<TSharedPtr<DMSSimScenarioParser>> CreateScenarioParsers(const FString& DirectoryPath);
+
+/**
+ * The scenarios of a directory like CreateScenarioParsers, but only their headers are validated,
+ * every scenario is parsed by DMSSimScenarioEntry::Get just before it runs.
+ * The scenarios with a sweep section are parsed and expanded right away, their scenario count is only known after the parse.
+ */
+std::vector<DMSSimScenarioEntry> IndexScenarioParsers(const FString& DirectoryPath);
+
+/** True if the first property of the file is a valid version, e.g. "version: 1.0". */
+bool IsScenarioHeaderValid(const FString& FilePath);
@@ -2,6 +2,8 @@
 #include "DMSSimUtils.h"
 #include "DMSSimConfig.h"
 #include "DMSSimLog.h"
+#include "DMSSimPixelConversion.h"
+#include "Async/ParallelFor.h"
 
 extern "C" {
 #include <libswscale/swscale.h>
@@ -20,10 +22,14 @@ public:
 	virtual ~DMSSimVideoEncoderImpl();
 	bool Initialize() override;
 	void AddFrame(const TArray<FColor>& PrevImage, const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, int FrameIdx) override;
+	void Finalize() override { Close(); }
 
 private:
 	void Close();
 
+	/** Writes all packets the encoder has ready, until it needs more input or reaches the end of the stream. */
+	void DrainPackets();
+
 	SwsContext*           ScaleContext_ = nullptr;
 	const AVOutputFormat* Format_ = nullptr;
 	AVFormatContext*      FormatContext_ = nullptr;
@@ -31,6 +37,9 @@ private:
 	const AVCodec*        Codec_ = nullptr;
 	AVCodecContext*       CodecContext_ = nullptr;
 	AVFrame*	          Frame_ = nullptr;
+	AVPacket*             Packet_ = nullptr;
+	size_t                NumFrames_ = 0;
+	size_t                NumPackets_ = 0;
 };
 
 DMSSimVideoEncoderImpl::~DMSSimVideoEncoderImpl() { Close(); }
@@ -46,7 +55,8 @@ bool DMSSimVideoEncoderImpl::Initialize() {
 	const std::wstring FileNameFull = FileName_ + L".avi";
 	const auto FileNameFullA = WideToNarrow(FileNameFull.c_str());
 	const size_t BitRate = 0.2 * FrameRate_ * DstWidth_ * DstHeight_;
-	ScaleContext_ = sws_getContext(SrcWidth_, SrcHeight_, AV_PIX_FMT_BGRA, DstWidth_, DstHeight_, AV_PIX_FMT_YUV420P, SWS_FAST_BILINEAR, NULL, NULL, NULL);
+	// the YUV420P kernel rounds the colors up to 1 LSB off from swscale, so the video is always converted by swscale
+	ScaleContext_ = CreateVideoScaleContext(SrcWidth_, SrcHeight_, DstWidth_, DstHeight_);
 	Format_ = av_guess_format(NULL, FileNameFullA.c_str(), NULL);
 	err_code = avformat_alloc_output_context2(&FormatContext_, Format_, NULL, FileNameFullA.c_str());
 	if (err_code < 0) {
@@ -58,8 +68,11 @@ bool DMSSimVideoEncoderImpl::Initialize() {
 	Codec_ = avcodec_find_encoder(AV_CODEC_ID_H264);
 	Stream_ = avformat_new_stream(FormatContext_, Codec_);
 
+	const DMSSimCamera& Camera = DMSSimConfig::GetCamera();
 	AVDictionary *dict = nullptr;
-	av_dict_set(&dict, "preset", "slow", 0);
+	av_dict_set(&dict, "preset", Camera.GetEncoderPreset(), 0);
+	if (*Camera.GetEncoderTune()) { av_dict_set(&dict, "tune", Camera.GetEncoderTune(), 0); }
+	if (Camera.GetEncoderLookahead() >= 0) { av_dict_set_int(&dict, "rc-lookahead", Camera.GetEncoderLookahead(), 0); }
 	av_dict_set_int(&dict, "crf", 10, 0);
 
 	CodecContext_ = avcodec_alloc_context3(Codec_);
@@ -71,6 +84,10 @@ bool DMSSimVideoEncoderImpl::Initialize() {
 	CodecContext_->gop_size = 10;
 	CodecContext_->max_b_frames = 1;
 	CodecContext_->pix_fmt = AV_PIX_FMT_YUV420P;
+	CodecContext_->thread_count = Camera.GetEncoderThreadCount();
+	CodecContext_->thread_type = (strcmp(Camera.GetEncoderThreadType(), "slice") == 0) ? FF_THREAD_SLICE : FF_THREAD_FRAME;
+	DMSSimLog::Info() << "DMSSimVideoEncoderImpl: preset " << Camera.GetEncoderPreset() << ", tune " << Camera.GetEncoderTune()
+		<< ", threads " << Camera.GetEncoderThreadCount() << " (" << Camera.GetEncoderThreadType() << "), lookahead " << Camera.GetEncoderLookahead() << FL;
 
 	if (FormatContext_->oformat->flags & AVFMT_GLOBALHEADER) // Some formats require a global header.
 	{ CodecContext_->flags |= AV_CODEC_FLAG_GLOBAL_HEADER; }
@@ -115,6 +132,12 @@ bool DMSSimVideoEncoderImpl::Initialize() {
 		return false;
 	}
 
+	Packet_ = av_packet_alloc();
+	if (!Packet_) {
+		DMSSimLog::Error() << "Initialize DMSSimVideoEncoderImpl: av_packet_alloc failed." << FL;
+		return false;
+	}
+
 	avcodec_parameters_to_context(CodecContext_, Stream_->codecpar);
 	return true;
 }
@@ -126,9 +149,9 @@ void DMSSimVideoEncoderImpl::AddFrame(const TArray<FColor>& PrevImage, const TSh
 	res = av_frame_make_writable(Frame_);
 	if (res < 0) { return; }
 
+	// From BGRA to YUV
 	const uint8_t* const ImagePlanes = reinterpret_cast<const uint8_t*>(PrevImage.GetData());
 	int inLinesize[] = { SrcWidth_ * sizeof(FColor) };
-	// From BGRA to YUV
 	sws_scale(ScaleContext_, &ImagePlanes, inLinesize, 0, SrcHeight_, Frame_->data, Frame_->linesize);
 
 	Frame_->pts = FrameIdx;
@@ -136,37 +159,35 @@ void DMSSimVideoEncoderImpl::AddFrame(const TArray<FColor>& PrevImage, const TSh
 	res = avcodec_send_frame(CodecContext_,  Frame_);
 	if (res < 0) {
 		av_strerror(res, error_buffer, sizeof(error_buffer) - 1);
+		DMSSimLog::Error() << "DMSSimVideoEncoderImpl: avcodec_send_frame failed: " << error_buffer << FL;
 		return;
 	}
+	++NumFrames_;
+	DrainPackets();
+}
 
-	AV_TIME_BASE;
-	AVPacket pkt;
-	av_init_packet(&pkt);
-	pkt.data = NULL;
-	pkt.size = 0;
-	pkt.flags |= AV_PKT_FLAG_KEY;
-	if (avcodec_receive_packet(CodecContext_, &pkt) == 0) {
-		res = av_interleaved_write_frame(FormatContext_, &pkt);
-		av_packet_unref(&pkt);
+void DMSSimVideoEncoderImpl::DrainPackets() {
+	for (;;) {
+		const int res = avcodec_receive_packet(CodecContext_, Packet_);
+		if (res == AVERROR(EAGAIN) || res == AVERROR_EOF) { return; }
+		if (res < 0) {
+			DMSSimLog::Error() << "DMSSimVideoEncoderImpl: avcodec_receive_packet err code: " << res << FL;
+			return;
+		}
+		av_packet_rescale_ts(Packet_, CodecContext_->time_base, Stream_->time_base);
+		Packet_->stream_index = Stream_->index;
+		// the muxer takes over the packet data and resets the packet
+		if (av_interleaved_write_frame(FormatContext_, Packet_) < 0) { DMSSimLog::Error() << "DMSSimVideoEncoderImpl: av_interleaved_write_frame failed" << FL; }
+		++NumPackets_;
 	}
-	return;
 }
 
 void DMSSimVideoEncoderImpl::Close() {
-	if (FormatContext_ && CodecContext_) {
-		AVPacket pkt;
-		av_init_packet(&pkt);
-		pkt.data = NULL;
-		pkt.size = 0;
-
-		for (;;) {
-			avcodec_send_frame(CodecContext_, NULL);
-			if (avcodec_receive_packet(CodecContext_, &pkt) == 0) {
-				av_interleaved_write_frame(FormatContext_, &pkt);
-				av_packet_unref(&pkt);
-			}
-			else { 	break; }
-		}
+	if (FormatContext_ && CodecContext_ && Packet_ && FormatContext_->pb) {
+		// flush the frames delayed by B-frames, lookahead and frame threading
+		avcodec_send_frame(CodecContext_, NULL);
+		DrainPackets();
+		DMSSimLog::Info() << "DMSSimVideoEncoderImpl: frames: " << NumFrames_ << ", packets: " << NumPackets_ << FL;
 
 		av_write_trailer(FormatContext_);
 		if (!(Format_->flags & AVFMT_NOFILE)) {
@@ -177,6 +198,7 @@ void DMSSimVideoEncoderImpl::Close() {
 		}
 	}
 
+	av_packet_free(&Packet_);
 	av_frame_free(&Frame_);
 	Frame_ = nullptr;
 	avcodec_free_context(&CodecContext_);
@@ -193,9 +215,67 @@ void DMSSimVideoEncoderImpl::Close() {
 }
 } // anonymous namespace
 
+SwsContext* DMSSimVideoEncoder::CreateVideoScaleContext(size_t SrcWidth, size_t SrcHeight, size_t DstWidth, size_t DstHeight) {
+	return sws_getContext(SrcWidth, SrcHeight, AV_PIX_FMT_BGRA, DstWidth, DstHeight, AV_PIX_FMT_YUV420P, SWS_FAST_BILINEAR, NULL, NULL, NULL);
+}
+
+bool DMSSimVideoEncoder::ConvertFrameUnscaled(const TArray<FColor>& Image, int PixelFormat, uint8* const Planes[], const int Linesizes[]) const {
+	if (!IsUnscaled() || Image.Num() < int64(SrcWidth_ * SrcHeight_)) { return false; }
+	if (PixelFormat != AV_PIX_FMT_GRAY8 && PixelFormat != AV_PIX_FMT_GRAY16LE) { return false; }
+
+	const uint8_t* const Src = reinterpret_cast<const uint8_t*>(Image.GetData());
+	const size_t SrcStride = SrcWidth_ * sizeof(FColor);
+	const int32 NumTiles = int32((SrcHeight_ + CONVERSION_TILE_ROWS - 1) / CONVERSION_TILE_ROWS);
+	ParallelFor(NumTiles, [&](int32 Tile) {
+		const size_t RowBegin = Tile * CONVERSION_TILE_ROWS;
+		const size_t RowEnd = FMath::Min(RowBegin + CONVERSION_TILE_ROWS, SrcHeight_);
+		switch (PixelFormat) {
+		case AV_PIX_FMT_GRAY8:
+			DMSSimPixelConversion::BGRAToGray8(Src, SrcStride, Planes[0], Linesizes[0], SrcWidth_, RowBegin, RowEnd);
+			break;
+		case AV_PIX_FMT_GRAY16LE:
+			DMSSimPixelConversion::BGRAToGray16LE(Src, SrcStride, Planes[0], Linesizes[0], SrcWidth_, RowBegin, RowEnd);
+			break;
+		}
+	});
+	return true;
+}
+
 TUniquePtr<DMSSimVideoEncoder> DMSSimVideoEncoder::CreateVideoEncoder(const std::wstring& FileName, size_t SrcWidth, size_t SrcHeight, size_t DstWidth, size_t DstHeight, size_t FrameRate, bool Depth16Bit, bool Nir) {
 	TUniquePtr<DMSSimVideoEncoder> Encoder = MakeUnique<DMSSimVideoEncoderImpl>(FileName, SrcWidth, SrcHeight, DstWidth, DstHeight, FrameRate, Depth16Bit, Nir);
 	if (Encoder && Encoder->Initialize()) { return Encoder; }
 	DMSSimLog::Error() << "CreateVideoEncoder fail" << FL;
 	return nullptr;
 }
+
+namespace {
+
+class DMSSimEncoderSink : public DMSSimRecordingSink
+{
+public:
+	explicit DMSSimEncoderSink(TUniquePtr<DMSSimVideoEncoder>&& Encoder) : Encoder_(MoveTemp(Encoder)) {}
+
+	void AddFrame(const TArray<FColor>& PrevImage, const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, const int FrameIdx) override {
+		Encoder_->AddFrame(PrevImage, PrevGroundTruth, GroundTruth, FrameIdx);
+	}
+	void Finalize() override { Encoder_->Finalize(); }
+
+private:
+	TUniquePtr<DMSSimVideoEncoder> Encoder_;
+};
+
+TUniquePtr<DMSSimRecordingSink> MakeEncoderSink(TUniquePtr<DMSSimVideoEncoder>&& Encoder) {
+	if (!Encoder) { return nullptr; }
+	return MakeUnique<DMSSimEncoderSink>(MoveTemp(Encoder));
+}
+
+} // anonymous namespace
+
+void DMSSimVideoEncoder::RegisterSinks(DMSSimRecordingSinkRegistry& Registry) {
+	Registry.Register(DMSSIM_SINK_VIDEO, [](const DMSSimRecordingSinkSettings& S) {
+		return MakeEncoderSink(CreateVideoEncoder(S.BaseFileName, S.SrcWidth, S.SrcHeight, S.DstWidth, S.DstHeight, S.FrameRate, S.Depth16Bit, S.Nir));
+	});
+	Registry.Register(DMSSIM_SINK_IMAGES, [](const DMSSimRecordingSinkSettings& S) {
+		return MakeEncoderSink(CreateVideoImageEncoder(S.BaseFileName, S.SrcWidth, S.SrcHeight, S.DstWidth, S.DstHeight, S.FrameRate, S.Depth16Bit, S.Nir));
+	});
+}
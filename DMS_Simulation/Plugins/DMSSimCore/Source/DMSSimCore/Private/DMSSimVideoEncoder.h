@@ -1,13 +1,16 @@
 #pragma once
 #include "DMSSimConfig.h"
+#include "DMSSimRecordingSink.h"
 #include "../Public/DMSSimRenderRequest.h"
 
+struct SwsContext;
+
 /**
  * @class DMSSimVideoEncoder
  * @brief Video recording object. It creates a video stream with specified parameters and has a method to add frames to the stream.
  * The stream is finalized on the DMSSimVideoEncoder object destruction. The video recorder is in fact a wrapper around of FFMPEG library.
  * The sizes of the input frames and of the target video stream don't necessarily match, because the support for the vertical FOV and camera distortion can require frame rescaling.
- * The rescaling is performed by FFMPEG.
+ * The rescaling is performed by FFMPEG. If no rescaling is needed, the NIR images are converted by the SIMD kernels of DMSSimPixelConversion.
  * The video is saved in AVI format with H264 codec.
  */
 class DMSSimVideoEncoder{
@@ -23,6 +26,12 @@ public:
 	virtual void AddFrame(const TArray<FColor>& PrevImage, const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, int FrameIdx) = 0;
 	virtual bool Initialize() = 0;
 
+	/**
+	 * Writes out all frames still buffered by the encoder and closes the output.
+	 * No frames can be added afterwards. Called on destruction, if it wasn't called explicitly.
+	 */
+	virtual void Finalize() {}
+
 	/**
 	 * Creates a video recording object
 	 *
@@ -38,7 +47,38 @@ public:
 	static TUniquePtr<DMSSimVideoEncoder> CreateVideoEncoder(const std::wstring& FileName, size_t SrcWidth, size_t SrcHeight, size_t DstWidth, size_t DstHeight, size_t FrameRate, bool Depth16Bit, bool Nir);
 	static TUniquePtr<DMSSimVideoEncoder> CreateVideoImageEncoder(const std::wstring& FileName, size_t SrcWidth, size_t SrcHeight, size_t DstWidth, size_t DstHeight, size_t FrameRate, bool Depth16Bit, bool Nir);
 
+	/**
+	 * Creates the libswscale contexts the encoders convert and rescale the BGRA frames with.
+	 * For NIR images of the same size the kernels of DMSSimPixelConversion replace the image context and must give the same output.
+	 *
+	 * @param[in] PixelFormat AVPixelFormat of the images, the video is always AV_PIX_FMT_YUV420P
+	 *
+	 * @return Context to be freed by sws_freeContext, nullptr on failure.
+	 */
+	static SwsContext* CreateVideoScaleContext(size_t SrcWidth, size_t SrcHeight, size_t DstWidth, size_t DstHeight);
+	static SwsContext* CreateImageScaleContext(size_t SrcWidth, size_t SrcHeight, size_t DstWidth, size_t DstHeight, int PixelFormat);
+
+	/** Registers the video and images sinks, which run the encoders created above. */
+	static void RegisterSinks(DMSSimRecordingSinkRegistry& Registry);
+
 protected:	
+	/** Height of the row tiles converted in parallel. */
+	static constexpr size_t CONVERSION_TILE_ROWS = 64;
+
+	bool IsUnscaled() const { return SrcWidth_ == DstWidth_ && SrcHeight_ == DstHeight_; }
+
+	/**
+	 * Converts the frame into the planes of the target pixel format, the frame is split into row tiles converted in parallel.
+	 *
+	 * @param[in] Image       BGRA pixels of the source frame
+	 * @param[in] PixelFormat AVPixelFormat of the target planes, AV_PIX_FMT_GRAY8 or AV_PIX_FMT_GRAY16LE
+	 * @param[in] Planes      Target planes
+	 * @param[in] Linesizes   Strides of the target planes in bytes
+	 *
+	 * @return false, if the pixel format is not supported or the source and target sizes differ.
+	 */
+	bool ConvertFrameUnscaled(const TArray<FColor>& Image, int PixelFormat, uint8* const Planes[], const int Linesizes[]) const;
+
 	const std::wstring&    FileName_;
 	size_t                SrcWidth_ = 0;
 	size_t                SrcHeight_ = 0;
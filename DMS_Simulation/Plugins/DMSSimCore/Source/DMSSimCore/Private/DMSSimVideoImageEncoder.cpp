@@ -1,18 +1,69 @@
 #include "DMSSimVideoEncoder.h"
+#include "DMSSimBoundedQueue.h"
 #include "DMSSimLog.h"
 #include "DMSSimUtils.h"
 #include "DMSSimConfig.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include <atomic>
+#include <cstdio>
+#include <iomanip>
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <vector>
 
 extern "C" {
 #include <libswscale/swscale.h>
 #include <libavcodec/avcodec.h>
 #include <libavutil/mathematics.h>
-#include <libavformat/avformat.h>
+#include <libavformat/avio.h>
 #include <libavutil/imgutils.h>
 #include <libavutil/opt.h>
 }
 
+namespace {
+enum class ImageFormat {
+	Png,
+	Tiff,
+	Raw,
+};
+
+constexpr int MAX_IMAGE_WRITER_THREADS = 8;
+constexpr int FRAMES_PER_IMAGE_WRITER = 2;
+
+ImageFormat ParseImageFormat(const char* Format) {
+	if (strcmp(Format, "tiff") == 0) { return ImageFormat::Tiff; }
+	if (strcmp(Format, "raw") == 0) { return ImageFormat::Raw; }
+	return ImageFormat::Png;
+}
+
+const wchar_t* GetImageExtension(ImageFormat Format) {
+	switch (Format) {
+	case ImageFormat::Tiff: return L".tiff";
+	case ImageFormat::Raw:  return L".raw";
+	default:                return L".png";
+	}
+}
+
+/** PNG stores 16 bit samples big endian, the little endian frames are swapped in place. */
+void SwapGray16Bytes(AVFrame* const Frame) {
+	for (int Y = 0; Y < Frame->height; ++Y) {
+		uint8_t* const Row = Frame->data[0] + Y * Frame->linesize[0];
+		for (int X = 0; X < Frame->width; ++X) { std::swap(Row[X * 2], Row[X * 2 + 1]); }
+	}
+}
+} // anonymous namespace
+
+/**
+ * @class DMSSimVideoImageEncoderImpl
+ * @brief Writes every frame into a separate image file <FileName>_<FrameIdx>.<png|tiff|raw>.
+ * The recording thread only converts the frame into a free AVFrame and queues it, the images are encoded and written by a pool of writer threads,
+ * each with its own codec context which lives as long as the encoder. The writers finish frames out of order,
+ * but every image is written into a temporary file first and renamed in the frame order, so the image files appear in order.
+ * The number of frames in flight is limited, AddFrame blocks while all frames are busy.
+ */
 class DMSSimVideoImageEncoderImpl : public DMSSimVideoEncoder {
 public:
 	DMSSimVideoImageEncoderImpl(const std::wstring& FileName, size_t SrcWidth, size_t SrcHeight, size_t DstWidth, size_t DstHeight, size_t FrameRate, bool Depth16Bit, bool Nir)
@@ -21,92 +72,272 @@ public:
 	virtual ~DMSSimVideoImageEncoderImpl();
 	bool Initialize() override;
 	void AddFrame(const TArray<FColor>& PrevImage, const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, int FrameIdx) override;
+	void Finalize() override { Close(); }
 
 private:
-	SwsContext*           ScaleContext_ = nullptr;
-	AVFormatContext*      FormatContext_ = nullptr;
-	AVStream*             Stream_ = nullptr;
-	const AVCodec*        Codec_ = nullptr;
-	AVCodecContext*       CodecContext_ = nullptr;
-	AVFrame*              Frame_ = nullptr;
-};	
-
-DMSSimVideoImageEncoderImpl::~DMSSimVideoImageEncoderImpl() {
-	av_frame_free(&Frame_);
+	struct WriteJob {
+		AVFrame*    Frame = nullptr;
+		int         FrameIdx = 0;
+		uint64      Sequence = 0;
+	};
+
+	class Writer : public FRunnable {
+	public:
+		explicit Writer(DMSSimVideoImageEncoderImpl& Owner) : Owner_(Owner) {}
+		virtual ~Writer();
+		bool Initialize();
+		uint32 Run() override;
+		void Join();
+
+	private:
+		bool Encode(AVFrame* Frame);
+		bool WriteFile(const std::string& FileName, AVFrame* Frame);
+
+		DMSSimVideoImageEncoderImpl& Owner_;
+		AVCodecContext*              CodecContext_ = nullptr;
+		AVPacket*                    Packet_ = nullptr;
+		FRunnableThread*             Thread_ = nullptr;
+	};
+
+	std::wstring GetImageFileName(int FrameIdx) const;
+	void Commit(uint64 Sequence, std::string&& TempFileName, std::string&& FileName);
+	void Close();
+
+	ImageFormat                              ImageFormat_ = ImageFormat::Png;
+	int                                      PngCompression_ = 0;
+	AVPixelFormat                            PixelFormat_ = AV_PIX_FMT_NONE;
+	SwsContext*                              ScaleContext_ = nullptr;
+	std::vector<AVFrame*>                    Frames_;
+	TUniquePtr<DMSSimBoundedQueue<AVFrame*>> FreeFrames_;
+	TUniquePtr<DMSSimBoundedQueue<WriteJob>> Jobs_;
+	std::vector<TUniquePtr<Writer>>          Writers_;
+	std::mutex                               CommitMutex_;
+	std::map<uint64, std::pair<std::string, std::string>> PendingCommits_;
+	uint64                                   NextCommit_ = 0;
+	uint64                                   NextSequence_ = 0;
+	std::atomic<uint64>                      BytesWritten_{ 0 };
+	std::atomic<int>                         Failures_{ 0 };
+	double                                   StartTime_ = 0.0;
+	bool                                     Closed_ = false;
+};
+
+DMSSimVideoImageEncoderImpl::Writer::~Writer() {
+	Join();
+	av_packet_free(&Packet_);
 	avcodec_free_context(&CodecContext_);
-	avformat_free_context(FormatContext_);
-	sws_freeContext(ScaleContext_);
-	Frame_ = nullptr;
-	CodecContext_ = nullptr;
-	Stream_ = nullptr;
-	Codec_ = nullptr;
-	FormatContext_ = nullptr;
-	ScaleContext_ = nullptr;
 }
 
-bool DMSSimVideoImageEncoderImpl::Initialize() {
-	Codec_ = avcodec_find_encoder(AV_CODEC_ID_TIFF);
-	CodecContext_ = avcodec_alloc_context3(Codec_);
-	if (!Codec_ || !CodecContext_) {
-		DMSSimLog::Info() << "fail at avcodec_find_encoder or avcodec_alloc_context3" << FL;
+bool DMSSimVideoImageEncoderImpl::Writer::Initialize() {
+	Packet_ = av_packet_alloc();
+	if (!Packet_) {
+		DMSSimLog::Info() << "fail at av_packet_alloc" << FL;
 		return false;
 	}
-	CodecContext_->codec_id = Codec_->id;
-	CodecContext_->codec_type = AVMEDIA_TYPE_VIDEO;
-	CodecContext_->width = DstWidth_;
-	CodecContext_->height = DstHeight_;
-	CodecContext_->time_base = AVRational{ 1, int(FrameRate_) };
-	CodecContext_->pix_fmt = Nir_? (Depth16Bit_ ? AV_PIX_FMT_GRAY16LE : AV_PIX_FMT_GRAY8) : AV_PIX_FMT_RGBA;
-	int err_code = avcodec_open2(CodecContext_, Codec_, nullptr);
+	if (Owner_.ImageFormat_ != ImageFormat::Raw) {
+		const AVCodec* const Codec = avcodec_find_encoder(Owner_.ImageFormat_ == ImageFormat::Png ? AV_CODEC_ID_PNG : AV_CODEC_ID_TIFF);
+		CodecContext_ = Codec ? avcodec_alloc_context3(Codec) : nullptr;
+		if (!Codec || !CodecContext_) {
+			DMSSimLog::Info() << "fail at avcodec_find_encoder or avcodec_alloc_context3" << FL;
+			return false;
+		}
+		CodecContext_->codec_type = AVMEDIA_TYPE_VIDEO;
+		CodecContext_->width = Owner_.DstWidth_;
+		CodecContext_->height = Owner_.DstHeight_;
+		CodecContext_->time_base = AVRational{ 1, int(Owner_.FrameRate_) };
+		CodecContext_->pix_fmt = (Owner_.ImageFormat_ == ImageFormat::Png && Owner_.PixelFormat_ == AV_PIX_FMT_GRAY16LE) ? AV_PIX_FMT_GRAY16BE : Owner_.PixelFormat_;
+		CodecContext_->compression_level = Owner_.PngCompression_;
+		// the writers run in parallel already
+		CodecContext_->thread_count = 1;
+		const int err_code = avcodec_open2(CodecContext_, Codec, nullptr);
+		if (0 != err_code) {
+			DMSSimLog::Info() << "fail at avcodec_open2 err code: " << err_code << FL;
+			return false;
+		}
+	}
+	Thread_ = FRunnableThread::Create(this, TEXT("DMS Sim Image Writer Thread"));
+	return Thread_ != nullptr;
+}
+
+void DMSSimVideoImageEncoderImpl::Writer::Join() {
+	if (!Thread_) { return; }
+	Thread_->WaitForCompletion();
+	delete Thread_;
+	Thread_ = nullptr;
+}
+
+uint32 DMSSimVideoImageEncoderImpl::Writer::Run() {
+	WriteJob Job;
+	while (Owner_.Jobs_->Pop(Job)) {
+		const std::string FileName = WideToNarrow(Owner_.GetImageFileName(Job.FrameIdx).c_str());
+		std::string TempFileName = FileName + ".part";
+		if (!WriteFile(TempFileName, Job.Frame)) {
+			++Owner_.Failures_;
+			std::remove(TempFileName.c_str());
+			TempFileName.clear();
+		}
+		Owner_.FreeFrames_->Push(std::move(Job.Frame));
+		Owner_.Commit(Job.Sequence, std::move(TempFileName), std::string(FileName));
+	}
+	return 0;
+}
+
+bool DMSSimVideoImageEncoderImpl::Writer::Encode(AVFrame* const Frame) {
+	if (CodecContext_->pix_fmt == AV_PIX_FMT_GRAY16BE) { SwapGray16Bytes(Frame); }
+	Frame->format = CodecContext_->pix_fmt;
+	int err_code = avcodec_send_frame(CodecContext_, Frame);
 	if (0 != err_code) {
-		DMSSimLog::Info() << "fail at avcodec_open2 err code: " << err_code << FL;
+		DMSSimLog::Info() << "fail at avcodec_send_frame err code: " << err_code << FL;
 		return false;
 	}
-	Frame_ = av_frame_alloc();
-	if (!Frame_) {
-		DMSSimLog::Info() << "fail at av_frame_alloc" << FL;
+	err_code = avcodec_receive_packet(CodecContext_, Packet_);
+	if (0 != err_code) {
+		DMSSimLog::Info() << "fail at avcodec_receive_packet err code: " << err_code << FL;
 		return false;
 	}
-	Frame_->format = CodecContext_->pix_fmt;
-	Frame_->width = CodecContext_->width;
-	Frame_->height = CodecContext_->height;
-	err_code = av_frame_get_buffer(Frame_, 32);
-	if (0 != err_code) {
-		DMSSimLog::Info() << "fail at av_frame_get_buffer err code: " << err_code << FL;
+	return true;
+}
+
+bool DMSSimVideoImageEncoderImpl::Writer::WriteFile(const std::string& FileName, AVFrame* const Frame) {
+	if (CodecContext_ && !Encode(Frame)) { return false; }
+
+	AVIOContext* Output = nullptr;
+	const int err_code = avio_open(&Output, FileName.c_str(), AVIO_FLAG_WRITE);
+	if (err_code < 0) {
+		DMSSimLog::Info() << "fail at avio_open err code: " << err_code << ", file: " << FileName << FL;
+		av_packet_unref(Packet_);
 		return false;
 	}
-	ScaleContext_ = sws_getContext(SrcWidth_, SrcHeight_, AV_PIX_FMT_BGRA, DstWidth_, DstHeight_, Nir_? (Depth16Bit_ ? AV_PIX_FMT_GRAY16LE : AV_PIX_FMT_GRAY8) : AV_PIX_FMT_RGBA, SWS_BILINEAR, NULL, NULL, NULL);
-	if (!ScaleContext_) {
-		DMSSimLog::Info() << "fail at sws_getContext" << FL;
+	uint64 Bytes = 0;
+	if (CodecContext_) {
+		avio_write(Output, Packet_->data, Packet_->size);
+		Bytes = Packet_->size;
+		av_packet_unref(Packet_);
+	}
+	else {
+		// uncompressed samples, row by row without the alignment padding of the frame
+		const int RowBytes = av_image_get_linesize(AVPixelFormat(Frame->format), Frame->width, 0);
+		for (int Y = 0; Y < Frame->height; ++Y) { avio_write(Output, Frame->data[0] + Y * Frame->linesize[0], RowBytes); }
+		Bytes = uint64(RowBytes) * Frame->height;
+	}
+	const bool Failed = Output->error < 0;
+	avio_closep(&Output);
+	if (Failed) {
+		DMSSimLog::Info() << "fail at avio_write, file: " << FileName << FL;
 		return false;
 	}
+	Owner_.BytesWritten_ += Bytes;
 	return true;
 }
 
-void DMSSimVideoImageEncoderImpl::AddFrame(const TArray<FColor>& PrevImage, const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, int FrameIdx) {
-	// Save the png file with zeropadded frame idx.
+DMSSimVideoImageEncoderImpl::~DMSSimVideoImageEncoderImpl() { Close(); }
+
+bool DMSSimVideoImageEncoderImpl::Initialize() {
+	const DMSSimCamera& Camera = DMSSimConfig::GetCamera();
+	ImageFormat_ = ParseImageFormat(Camera.GetImageFormat());
+	PngCompression_ = Camera.GetPngCompression();
+	PixelFormat_ = Nir_ ? (Depth16Bit_ ? AV_PIX_FMT_GRAY16LE : AV_PIX_FMT_GRAY8) : AV_PIX_FMT_RGBA;
+
+	// NIR frames of the same size are converted by the SIMD kernels
+	if (!Nir_ || !IsUnscaled()) {
+		ScaleContext_ = CreateImageScaleContext(SrcWidth_, SrcHeight_, DstWidth_, DstHeight_, PixelFormat_);
+		if (!ScaleContext_) {
+			DMSSimLog::Info() << "fail at sws_getContext" << FL;
+			return false;
+		}
+	}
+
+	const int NumWriters = Camera.GetImageThreadCount() > 0 ? Camera.GetImageThreadCount() :
+		FMath::Clamp(FPlatformMisc::NumberOfCores() / 2, 1, MAX_IMAGE_WRITER_THREADS);
+	const size_t NumFrames = size_t(NumWriters) * FRAMES_PER_IMAGE_WRITER;
+	FreeFrames_ = MakeUnique<DMSSimBoundedQueue<AVFrame*>>(NumFrames);
+	Jobs_ = MakeUnique<DMSSimBoundedQueue<WriteJob>>(NumFrames);
+	for (size_t i = 0; i < NumFrames; ++i) {
+		AVFrame* Frame = av_frame_alloc();
+		if (!Frame) {
+			DMSSimLog::Info() << "fail at av_frame_alloc" << FL;
+			return false;
+		}
+		Frames_.push_back(Frame);
+		Frame->format = PixelFormat_;
+		Frame->width = DstWidth_;
+		Frame->height = DstHeight_;
+		const int err_code = av_frame_get_buffer(Frame, 32);
+		if (0 != err_code) {
+			DMSSimLog::Info() << "fail at av_frame_get_buffer err code: " << err_code << FL;
+			return false;
+		}
+		FreeFrames_->Push(std::move(Frame));
+	}
+
+	for (int i = 0; i < NumWriters; ++i) {
+		Writers_.push_back(MakeUnique<Writer>(*this));
+		if (!Writers_.back()->Initialize()) { return false; }
+	}
+	DMSSimLog::Info() << "DMSSimVideoImageEncoderImpl: format " << Camera.GetImageFormat() << ", png compression " << PngCompression_
+		<< ", writers " << NumWriters << ", frames in flight " << NumFrames << FL;
+	return true;
+}
+
+std::wstring DMSSimVideoImageEncoderImpl::GetImageFileName(int FrameIdx) const {
+	// zeropadded frame idx
 	std::wstringstream ss;
-	ss << FileName_ << L"_" << std::setw(5) << std::setfill(L'0') << FrameIdx << L".png";
-	std::wstring FileNameFull = ss.str();
-	const auto FileNameFullA = WideToNarrow(FileNameFull.c_str());
-	const uint8_t* const ImagePlanes = reinterpret_cast<const uint8_t*>(PrevImage.GetData());
-	int inLinesize[] = { SrcWidth_ * sizeof(FColor) };
-	sws_scale(ScaleContext_, &ImagePlanes, inLinesize, 0, SrcHeight_, Frame_->data, Frame_->linesize);
-	if (0 != avformat_alloc_output_context2(&FormatContext_, nullptr, NULL, FileNameFullA.c_str())) { DMSSimLog::Info() << "fail at avformat_alloc_output_context2" << FL; }
-	Stream_ = avformat_new_stream(FormatContext_, Codec_);
-	if (!Stream_) { DMSSimLog::Info() << "fail at avformat_alloc_output_context2" << FL; }
-	if (0 != avcodec_parameters_from_context(Stream_->codecpar, CodecContext_)) { DMSSimLog::Info() << "fail at avcodec_parameters_from_context" << FL; }
-	if (0 != avio_open(&FormatContext_->pb, FileNameFullA.c_str(), AVIO_FLAG_WRITE)) { DMSSimLog::Info() << "fail at avio_open" << FL; }
-	if (0 != avformat_write_header(FormatContext_, nullptr)) { DMSSimLog::Info() << "fail at avformat_write_header" << FL; }
-	AVPacket pkt;
-	av_init_packet(&pkt);
-	pkt.data = nullptr;
-	pkt.size = 0;
-	if (0 != avcodec_send_frame(CodecContext_, Frame_)) { DMSSimLog::Info() << "fail at avcodec_send_frame" << FL; }
-	if (0 != avcodec_receive_packet(CodecContext_, &pkt)) { DMSSimLog::Info() << "fail at avcodec_receive_packet" << FL; }
-	if (0 != av_interleaved_write_frame(FormatContext_, &pkt)) { DMSSimLog::Info() << "fail at av_interleaved_write_frame" << FL; }
-	if (0 != av_write_trailer(FormatContext_)) { DMSSimLog::Info() << "fail at av_write_trailer" << FL; }
-	av_packet_unref(&pkt);
+	ss << FileName_ << L"_" << std::setw(5) << std::setfill(L'0') << FrameIdx << GetImageExtension(ImageFormat_);
+	return ss.str();
+}
+
+void DMSSimVideoImageEncoderImpl::AddFrame(const TArray<FColor>& PrevImage, const TSharedPtr<DMSSimGroundTruthFrame>& PrevGroundTruth, const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth, int FrameIdx) {
+	if (Closed_) { return; }
+	if (NextSequence_ == 0) { StartTime_ = FPlatformTime::Seconds(); }
+
+	AVFrame* Frame = nullptr;
+	if (!FreeFrames_->Pop(Frame)) { return; }
+	Frame->format = PixelFormat_;
+	if (!ScaleContext_) { ConvertFrameUnscaled(PrevImage, PixelFormat_, Frame->data, Frame->linesize); }
+	else {
+		const uint8_t* const ImagePlanes = reinterpret_cast<const uint8_t*>(PrevImage.GetData());
+		int inLinesize[] = { int(SrcWidth_ * sizeof(FColor)) };
+		sws_scale(ScaleContext_, &ImagePlanes, inLinesize, 0, SrcHeight_, Frame->data, Frame->linesize);
+	}
+	Jobs_->Push(WriteJob{ Frame, FrameIdx, NextSequence_++ });
+}
+
+void DMSSimVideoImageEncoderImpl::Commit(uint64 Sequence, std::string&& TempFileName, std::string&& FileName) {
+	std::lock_guard<std::mutex> Lock(CommitMutex_);
+	PendingCommits_.emplace(Sequence, std::make_pair(std::move(TempFileName), std::move(FileName)));
+	for (auto It = PendingCommits_.begin(); It != PendingCommits_.end() && It->first == NextCommit_; It = PendingCommits_.erase(It), ++NextCommit_) {
+		// an empty temporary name means the image could not be written
+		if (It->second.first.empty()) { continue; }
+		std::remove(It->second.second.c_str());
+		if (0 != std::rename(It->second.first.c_str(), It->second.second.c_str())) {
+			DMSSimLog::Info() << "fail at rename: " << It->second.first << FL;
+			++Failures_;
+		}
+	}
+}
+
+void DMSSimVideoImageEncoderImpl::Close() {
+	if (Closed_) { return; }
+	Closed_ = true;
+
+	if (Jobs_) { Jobs_->Close(); }
+	for (auto& ImageWriter : Writers_) { ImageWriter->Join(); }
+	Writers_.clear();
+
+	if (NextSequence_ > 0) {
+		const double Seconds = FMath::Max(FPlatformTime::Seconds() - StartTime_, 1e-6);
+		DMSSimLog::Info() << "DMSSimVideoImageEncoderImpl -- images: " << NextSequence_ << ", failed: " << Failures_.load()
+			<< ", " << NextSequence_ / Seconds << " images/s, " << BytesWritten_.load() / (Seconds * 1024.0 * 1024.0) << " MB/s"
+			<< ", recorder blocked: " << FreeFrames_->GetPopBlockedTime() << " s" << FL;
+	}
+
+	for (auto& Frame : Frames_) { av_frame_free(&Frame); }
+	Frames_.clear();
+	sws_freeContext(ScaleContext_);
+	ScaleContext_ = nullptr;
+}
+
+SwsContext* DMSSimVideoEncoder::CreateImageScaleContext(size_t SrcWidth, size_t SrcHeight, size_t DstWidth, size_t DstHeight, int PixelFormat) {
+	return sws_getContext(SrcWidth, SrcHeight, AV_PIX_FMT_BGRA, DstWidth, DstHeight, AVPixelFormat(PixelFormat), SWS_BILINEAR, NULL, NULL, NULL);
 }
 
 TUniquePtr<DMSSimVideoEncoder> DMSSimVideoEncoder::CreateVideoImageEncoder(const std::wstring& FileName, size_t SrcWidth, size_t SrcHeight, size_t DstWidth, size_t DstHeight, size_t FrameRate, bool Depth16Bit, bool Nir) {
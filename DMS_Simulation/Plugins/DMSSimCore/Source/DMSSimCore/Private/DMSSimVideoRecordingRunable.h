@@ -1,9 +1,12 @@
 #pragma once
 
-#include <Runtime\Core\Public\Math\Color.h>
+#include "CoreMinimal.h"
+#include <atomic>
 #include "DMSSimRenderRequest.h"
-#include "DMSSimVideoEncoder.h"
-#include "DMSSimImageLabeler.h"
+#include "DMSSimBoundedQueue.h"
+#include "DMSSimConfig.h"
+#include "DMSSimRecordingSink.h"
+#include "DMSSimLensRemap.h"
 #include "DMSSimLog.h"
 
 using ImagePtr = FDMSSimRenderRequest::ImagePtr;
@@ -11,38 +14,60 @@ using ImagePtr = FDMSSimRenderRequest::ImagePtr;
 /**
  * @class DMSSimVideoRecordingRunable
  * @brief Asynchronous worker that does actual video recording.
+ * Every frame is passed to the sinks the scenario selects from DMSSimRecordingSinkRegistry, the video or images and the labels.
+ * With a lens distortion in the scenario camera and the video or images selected, the frames are remapped with DMSSimLensRemap before they reach the sinks.
+ * Frames and their ground truth are passed in pairs through a bounded blocking queue,
+ * AddFrame blocks the caller while the queue is full, so the renderer cannot outrun the encoder.
+ * Without a sink to pass the frames to, no thread is started and the runnable is done from the start.
  */
 class DMSSimVideoRecordingRunable : public FRunnable
 {
 public:
-    DMSSimVideoRecordingRunable(std::wstring&& FileName, size_t SrcWidth, size_t SrcHeight, size_t DstWidth, size_t DstHeight, size_t FrameRate, bool Depth16Bit, bool Nir);
+    DMSSimVideoRecordingRunable(std::wstring&& FileName, size_t SrcWidth, size_t SrcHeight, size_t DstWidth, size_t DstHeight, size_t FrameRate, bool Depth16Bit, bool Nir, size_t QueueCapacity = DEFAULT_FRAME_QUEUE_CAPACITY);
     virtual ~DMSSimVideoRecordingRunable(){};
 
     bool Init() override { return true; };
     uint32 Run() override;
-    void Stop() override { Active_ = false; };
+    void Stop() override { FrameQueue_.Close(); };
     void Exit() override { Done_ = true; };
 
     bool IsDone() const { return Done_; };
+
+    /**
+     * Passes the frame and its ground truth to the recording thread.
+     * Blocks while the queue is full.
+     */
     void AddFrame(const ImagePtr& Frame, TSharedPtr<DMSSimGroundTruthFrame> GroundTruth) {
-        FrameQueue_.Enqueue(Frame);
-        GroundTruthQueue_.Enqueue(GroundTruth);
+        if (!Thread_) { return; }
+        ++PendingFrames_;
+        if (!FrameQueue_.Push(FrameEntry{ Frame, MoveTemp(GroundTruth) })) { --PendingFrames_; }
     };
-    void IncPendingFrames() { ++PendingFrames_; };
     int GetNumPendingFrames() { return PendingFrames_; }
 
+    /** Time in seconds the renderer spent waiting for a free slot in the queue. */
+    double GetProducerBlockedTime() const { return FrameQueue_.GetPushBlockedTime(); }
+
+    /** Time in seconds the recording thread spent waiting for new frames. */
+    double GetConsumerBlockedTime() const { return FrameQueue_.GetPopBlockedTime(); }
+
 private:
-    TQueue<ImagePtr>                                FrameQueue_;
-    TQueue<TSharedPtr<DMSSimGroundTruthFrame> >     GroundTruthQueue_;
+    struct FrameEntry {
+        ImagePtr                            Frame;
+        TSharedPtr<DMSSimGroundTruthFrame>  GroundTruth;
+    };
+
+    DMSSimBoundedQueue<FrameEntry>                  FrameQueue_;
     ImagePtr                                        PrevFrame_ = MakeShareable(new TArray<FColor>);
     TSharedPtr<DMSSimGroundTruthFrame>              PrevGroundTruth_ = nullptr;
     FRunnableThread*                                Thread_ = nullptr;
     const std::wstring                              BaseFileName_;
-    TUniquePtr<DMSSimVideoEncoder>                  Encoder_;
-    DMSSimImageLabelerImpl                          Labeler_;
-    DMSSimImageLabelerOldImpl                       LabelerOld_;
-    bool                                            Active_ = true;
-    bool                                            Done_ = false;
+    std::vector<TUniquePtr<DMSSimRecordingSink>>    Sinks_;
+    const size_t                                    SrcWidth_;
+    const size_t                                    SrcHeight_;
+    DMSSimCameraIntrinsics                          Intrinsics_;  // without distortion, if no sink uses the pixels
+    TSharedPtr<const DMSSimLensRemap>               Remap_;
+    TArray<FColor>                                  RemappedFrame_;
+    std::atomic<bool>                               Done_{ false };
     int                                             FrameIdx_ = 0;
-    int                                             PendingFrames_ = 0;
+    std::atomic<int>                                PendingFrames_{ 0 };
 };
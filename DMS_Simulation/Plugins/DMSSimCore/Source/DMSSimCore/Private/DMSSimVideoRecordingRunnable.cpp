@@ -2,49 +2,65 @@
 #include "DMSSimLog.h"
 #include "DMSSimConfig.h"
 
-DMSSimVideoRecordingRunable::DMSSimVideoRecordingRunable(std::wstring&& FileName, size_t SrcWidth, size_t SrcHeight, size_t DstWidth, size_t DstHeight, size_t FrameRate, bool Depth16Bit, bool Nir) :
+DMSSimVideoRecordingRunable::DMSSimVideoRecordingRunable(std::wstring&& FileName, size_t SrcWidth, size_t SrcHeight, size_t DstWidth, size_t DstHeight, size_t FrameRate, bool Depth16Bit, bool Nir, size_t QueueCapacity) :
+    FrameQueue_(QueueCapacity),
     BaseFileName_(std::move(FileName)),
-    Encoder_(DMSSimConfig::GetCurrentScenarioParser()->GetCamera().GetVideoOut() ?
-        DMSSimVideoEncoder::CreateVideoEncoder(BaseFileName_, SrcWidth, SrcHeight, DstWidth, DstHeight, FrameRate, Depth16Bit, Nir) :
-        DMSSimVideoEncoder::CreateVideoImageEncoder(BaseFileName_, SrcWidth, SrcHeight, DstWidth, DstHeight, FrameRate, Depth16Bit, Nir)),
-    Labeler_(BaseFileName_),
-    LabelerOld_(BaseFileName_)
+    SrcWidth_(SrcWidth),
+    SrcHeight_(SrcHeight)
 {
-    if (Encoder_) { Thread_ = FRunnableThread::Create(this, TEXT("DMS Sim Video Recording Thread")); }
+    const auto Scenario = DMSSimConfig::GetCurrentScenarioParser();
+    DMSSimRecordingSinkSettings Settings{ BaseFileName_, SrcWidth, SrcHeight, DstWidth, DstHeight, FrameRate, Depth16Bit, Nir };
+    Settings.LabelStream = strcmp(Scenario->GetCamera().GetLabelMode(), "stream") == 0;
+    Settings.LabelThreadCount = Scenario->GetCamera().GetLabelThreadCount();
+    Settings.LabelDeltaEpsilon = Scenario->GetCamera().GetLabelDeltaEpsilon();
+    const auto SinkNames = DMSSimRecordingSinkRegistry::GetSelectedSinks(*Scenario);
+    Sinks_ = DMSSimRecordingSinkRegistry::Get().CreateSinks(SinkNames, Settings);
+    // the rendered frames are pinhole images, the lens distortion is applied before the encoder, the labelers don't use the pixels
+    if (DMSSimRecordingSinkRegistry::IsSelected(SinkNames, DMSSIM_SINK_VIDEO) || DMSSimRecordingSinkRegistry::IsSelected(SinkNames, DMSSIM_SINK_IMAGES)) {
+        const auto& Camera = Scenario->GetCamera();
+        float Distortion[DMSSIM_DISTORTION_COEFFICIENT_COUNT] = {};
+        const bool HasDistortion = Camera.GetDistortionCount() == DMSSIM_DISTORTION_COEFFICIENT_COUNT;
+        for (size_t i = 0; HasDistortion && i < DMSSIM_DISTORTION_COEFFICIENT_COUNT; ++i) { Distortion[i] = Camera.GetDistortion(i); }
+        Intrinsics_ = DMSSimCameraIntrinsics::Create(unsigned(SrcWidth), unsigned(SrcHeight), Camera.GetFOV(), Camera.GetMirrored(), Distortion);
+    }
+    // with only the csv or no sink selected there's nothing to record here, the renderer must not wait for this runnable
+    if (Sinks_.empty()) { Done_ = true; }
+    else { Thread_ = FRunnableThread::Create(this, TEXT("DMS Sim Video Recording Thread")); }
 }
 
 uint32 DMSSimVideoRecordingRunable::Run() {
     DMSSimLog::Info() << "DMSSimVideoRecordingRunable  -- " << "Run" << FL;
-    while (Active_ || PendingFrames_) {
-        if (FrameQueue_.IsEmpty() || GroundTruthQueue_.IsEmpty()) {
-            FPlatformProcess::Sleep(0.01f);
-            continue;
-        }
-        while (!FrameQueue_.IsEmpty() && !GroundTruthQueue_.IsEmpty()) {
-            ImagePtr Frame;
-            TSharedPtr<DMSSimGroundTruthFrame> GroundTruth;
-            FrameQueue_.Peek(Frame);
-            GroundTruthQueue_.Peek(GroundTruth);
+    // computing the table of a new camera takes a while for large frames, so it's done here and not on the game thread
+    Remap_ = DMSSimLensRemap::Get(Intrinsics_, SrcWidth_, SrcHeight_);
+    FrameEntry Entry;
+    while (FrameQueue_.Pop(Entry)) {
+        const ImagePtr& Frame = Entry.Frame;
+        const TSharedPtr<DMSSimGroundTruthFrame>& GroundTruth = Entry.GroundTruth;
 
-            if (Frame && GroundTruth) {
-                if (PrevFrame_ && PrevGroundTruth_ && FrameIdx_ > 1) {
-                    // Because the occlusion of facial landmarks is lagging one frame behind, 
-                    // We need to wait for the second frame and apply its occlusion groundtruth to the previous frame 
-                    Labeler_.AddFrame(PrevGroundTruth_, GroundTruth, FrameIdx_);
-                    LabelerOld_.AddFrame(PrevGroundTruth_, GroundTruth, FrameIdx_);
-                    Encoder_->AddFrame(*PrevFrame_, PrevGroundTruth_, GroundTruth, FrameIdx_);
+        if (Frame && GroundTruth) {
+            if (PrevFrame_ && PrevGroundTruth_ && FrameIdx_ > 1) {
+                // Because the occlusion of facial landmarks is lagging one frame behind, 
+                // We need to wait for the second frame and apply its occlusion groundtruth to the previous frame 
+                const TArray<FColor>* Image = PrevFrame_.Get();
+                if (Remap_) {
+                    Remap_->Remap(*Image, RemappedFrame_);
+                    Image = &RemappedFrame_;
                 }
-
-                PrevFrame_ = Frame;
-                PrevGroundTruth_ = GroundTruth;
-                FrameQueue_.Pop();
-                GroundTruthQueue_.Pop();
-                FrameIdx_++;
-                PendingFrames_--;
+                for (auto& Sink : Sinks_) { Sink->AddFrame(*Image, PrevGroundTruth_, GroundTruth, FrameIdx_); }
             }
+
+            // the replaced frame buffer goes back to the renderer's frame buffer pool
+            PrevFrame_ = Frame;
+            PrevGroundTruth_ = GroundTruth;
+            FrameIdx_++;
         }
+        PendingFrames_--;
     }
-    Encoder_.Reset();
+    for (auto& Sink : Sinks_) { Sink->Finalize(); }
+    Sinks_.clear();
+    DMSSimLog::Info() << "DMSSimVideoRecordingRunable  -- " << "Frames: " << FrameIdx_
+        << ", renderer blocked: " << GetProducerBlockedTime() << " s"
+        << ", recorder blocked: " << GetConsumerBlockedTime() << " s" << FL;
     DMSSimLog::Info() << "DMSSimVideoRecordingRunable  -- " << "Exit " << FL;
     return 0;
 }
@@ -26,6 +26,9 @@ enum YamlObjType {
 	YamlObjTypeSeat,
 	YamlObjTypeCoordinateSpace,
 	YamlObjTypeTransformList,
+	YamlObjTypeSweep,
+	YamlObjTypeSweepParameter,
+	YamlObjTypeSweepPose,
 };
 
 /**
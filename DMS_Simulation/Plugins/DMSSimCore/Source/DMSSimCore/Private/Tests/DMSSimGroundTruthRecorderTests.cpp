@@ -1,5 +1,10 @@
+#include "DMSSimGroundTruthFramePool.h"
 #include "DMSSimGroundTruthRecorder.h"
+#include "DMSSimGroundTruthTransform.h"
+#include "DMSSimGroundTruthWriter.h"
+#include "DMSSimConstants.h"
 #include "Misc/AutomationTest.h"
+#include <cmath>
 #include <map>
 #include <sstream>
 #include <vector>
@@ -77,6 +82,76 @@ FString GetValue(const std::map<std::string, std::string>& ValueMap, const char*
 	return "";
 }
 
+/** A frame with a driver and a front passenger, the values change with the frame index. */
+DMSSimGroundTruthFrame MakeFrame(const int FrameIndex){
+	DMSSimGroundTruthFrame FrameCompound = {};
+	FrameCompound.Data.CarPosition_inWorld = { -98982.4141f + FrameIndex, -4934.33740f, 230.432068f };
+	FrameCompound.Data.CarRotation_inWorld = { -179.999954f, 0.5f * FrameIndex, -0.734222293f };
+
+	const FDMSSimOccupantType Occupants[] = { FDMSSimOccupantType::Driver, FDMSSimOccupantType::PassengerFront };
+	for (const auto OccupantType : Occupants)
+	{
+		auto& Frame = FrameCompound.Data.Occupants[static_cast<uint8>(OccupantType)];
+		const float Offset = 0.25f * FrameIndex + static_cast<uint8>(OccupantType);
+		Frame.Initialized = true;
+		Frame.NosePoint = { -99130.5156f + Offset, -4976.34912f, 127.815781f };
+		Frame.LEarPoint = { -99145.3125f, -4983.97168f + Offset, 129.771729f };
+		Frame.REarPoint = { -99145.0625f, -4968.49902f, 129.472290f + Offset };
+		Frame.LeftEyePoint = { -99134.9219f, -4979.76855f, 132.006348f };
+		Frame.RightEyePoint = { -99134.8750f, -4972.83301f, 131.928482f };
+		Frame.LeftGazeDirection_inCam = { 0.0f, -1.0f, 0.0f };
+		Frame.RightGazeDirection_inCam = { 1.0f, 0.0f, 0.0f };
+		Frame.LeftEyeOpening = 0.9f - 0.01f * FrameIndex;
+		Frame.RightEyeOpening = 0.8f + 0.01f * FrameIndex;
+		Frame.HorizontalMouthOpening = 3.02f + Offset;
+		Frame.VerticalMouthOpening = 2.57f;
+		Frame.FacialLandmarksVisible.SetNum(68);
+		Frame.FacialLandmarks3D_inCam.SetNum(68);
+		Frame.FacialLandmarks2D.SetNum(68);
+		Frame.FaceBoundingBox3D_inCam.SetNum(8);
+		for (int i = 0; i < 68; i++)
+		{
+			Frame.FacialLandmarksVisible[i] = (i + FrameIndex) % 3 != 0;
+			Frame.FacialLandmarks3D_inCam[i] = { -99134.9219f + i, -4979.76855f + Offset, 132.006348f };
+			Frame.FacialLandmarks2D[i] = { 100.0f + i, 200.0f + FrameIndex };
+		}
+	}
+	return FrameCompound;
+}
+
+/** A coordinate space with a rotation and a scale, unlike those of config.yml. */
+class RotatedCoordinateSpace : public DMSSimCoordinateSpace {
+public:
+	const char* GetCarModel() const override { return "Rotated"; }
+	FRotator GetRotation() const override { return FRotator(2.5f, -11.0f, 1.25f); }
+	FVector  GetTranslation() const override { return FVector(-1.411584f, 0.05f, -0.65192f); }
+	FVector  GetScale() const override { return FVector(1.02f, 0.97f, 1.0f); }
+};
+
+/** The conversion of a world point step by step, as the recorder did before DMSSimGroundTruthTransform. */
+FVector ConvertPointStepwise(const DMSSimCoordinateSpace& CoordinateSpace, const FRotator& CarRotation, const FVector& CarPosition, const FVector& Point) {
+	FVector NewPoint = CarRotation.UnrotateVector(Point - CarPosition);
+	NewPoint /= DMSSIM_M_TO_CM;
+	NewPoint /= CoordinateSpace.GetScale();
+	NewPoint = CoordinateSpace.GetRotation().UnrotateVector(NewPoint);
+	return NewPoint - CoordinateSpace.GetTranslation();
+}
+
+FVector ConvertDirectionStepwise(const DMSSimCoordinateSpace& CoordinateSpace, const FRotator& CarRotation, const FVector& Vector) {
+	FVector NewVector = CarRotation.UnrotateVector(Vector);
+	NewVector /= CoordinateSpace.GetScale();
+	NewVector = CoordinateSpace.GetRotation().UnrotateVector(NewVector);
+	NewVector.Normalize();
+	return NewVector;
+}
+
+constexpr float TRANSFORM_TOLERANCE = 1e-5f; // relative to values above 1
+
+bool IsNearlyEqual(const FVector& A, const FVector& B) {
+	const auto IsNear = [](const float Value, const float Expected) { return std::abs(Value - Expected) <= TRANSFORM_TOLERANCE * FMath::Max(1.0f, std::abs(Expected)); };
+	return IsNear(A.X, B.X) && IsNear(A.Y, B.Y) && IsNear(A.Z, B.Z);
+}
+
 } // anonymous namespace
 
 using namespace DMSSimGroundTruthRecorder;
@@ -87,7 +162,7 @@ bool DMSSimGroundTruthRecorderTest1::RunTest(const FString& Parameters)
 {
 	DMSSimGroundTruthFrame FrameCompound = {};
 	auto& CommonData = FrameCompound.Common;
-	auto& Frame = FrameCompound.Occupants[DMSSimOccupantDriver];
+	auto& Frame = FrameCompound.Data.Occupants[DMSSimOccupantDriver];
 
 	CommonData.CameraPoint = { -99077.5469, -4973.17334, 108.118126 };
 	CommonData.CarBase = { -98982.4141, -4936.76416, 41.0475311 };
@@ -134,7 +209,7 @@ bool DMSSimGroundTruthRecorderTest1::RunTest(const FString& Parameters)
 	Frame.LeftFootIndexPoint = { -69145.3125, -4183.97168, 119.771729 };
 	Frame.RightFootIndexPoint = { -79145.3125, -4083.97168, 169.771729 };
 
-	auto& Frame2 = FrameCompound.Occupants[DMSSimOccupantPassengerRearMiddle];
+	auto& Frame2 = FrameCompound.Data.Occupants[DMSSimOccupantPassengerRearMiddle];
 	Frame2.Initialized = true;
 	Frame2.EyesMiddlePointGlobal = { -99134.8984, -4976.30078, 131.967407 };
 	Frame2.LeftEyePoint = { -99134.9219, -4979.76855, 132.006348 };
@@ -374,11 +449,11 @@ bool DMSSimGroundTruthRecorderTest2::RunTest(const FString& Parameters)
 	UE_LOG(MyLogCategory, Log, TEXT("Starting test: DMSSimGroundTruthRecorderTest2"));
 
 	DMSSimGroundTruthFrame FrameCompound = {};
-	auto& CommonData = FrameCompound.Common;
-	auto& Frame = FrameCompound.Occupants[static_cast<uint8>(FDMSSimOccupantType::Driver)];
+	auto& FrameData = FrameCompound.Data;
+	auto& Frame = FrameData.Occupants[static_cast<uint8>(FDMSSimOccupantType::Driver)];
 
-	CommonData.CarPosition_inWorld = { -98982.4141, -4934.33740, 230.432068 };
-	CommonData.CarRotation_inWorld = { -179.999954, 0.00000000, -0.734222293 };
+	FrameData.CarPosition_inWorld = { -98982.4141, -4934.33740, 230.432068 };
+	FrameData.CarRotation_inWorld = { -179.999954, 0.00000000, -0.734222293 };
 
 	Frame.Initialized = true;
 	Frame.HeadOriginEyesCenter_inCam = { -99134.8984, -4976.30078, 131.967407 };
@@ -395,7 +470,7 @@ bool DMSSimGroundTruthRecorderTest2::RunTest(const FString& Parameters)
 	Frame.VerticalMouthOpening = 2.57;
 
 	// Needs to match the intialized column header (e.g. faciallandmarks_P3DX..)
-	for (auto& OccupantFrame : FrameCompound.Occupants)
+	for (auto& OccupantFrame : FrameData.Occupants)
 	{
 		OccupantFrame.FacialLandmarksVisible.SetNum(68);
 		OccupantFrame.FacialLandmarks3D_inCam.SetNum(68);
@@ -577,4 +652,143 @@ bool DMSSimGroundTruthRecorderTest2::RunTest(const FString& Parameters)
 	}
 	return true;
 }
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimGroundTruthRecorderTest3, "DMSSim.GroundTruthRecorder.Tests3", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool DMSSimGroundTruthRecorderTest3::RunTest(const FString& Parameters)
+{
+	// the writer thread must produce the same bytes as the synchronous recorder, with the rows in order
+	constexpr int FrameCount = 50;
+	std::vector<DMSSimGroundTruthFrame> Frames;
+	for (int i = 0; i < FrameCount; ++i) { Frames.push_back(MakeFrame(i)); }
+
+	std::stringstream SyncStream;
+	AddHeader(SyncStream);
+	for (int i = 0; i < FrameCount; ++i) { AddFrame(SyncStream, i / 30.0, Frames[i]); }
+
+	std::stringstream AsyncStream;
+	{
+		// a short queue, so the producer has to wait for the writer
+		DMSSimGroundTruthWriter Writer(AsyncStream, 2);
+		for (int i = 0; i < FrameCount; ++i) {
+			TestTrue(TEXT("GT Test 3 AddFrame"), Writer.AddFrame(i / 30.0, MakeShared<const DMSSimGroundTruthFrame, ESPMode::ThreadSafe>(Frames[i])));
+		}
+		Writer.Finalize();
+		TestFalse(TEXT("GT Test 3 AddFrame after Finalize"), Writer.AddFrame(0.0, MakeShared<const DMSSimGroundTruthFrame, ESPMode::ThreadSafe>(Frames[0])));
+	}
+
+	TestTrue(TEXT("GT Test 3 has rows"), SyncStream.str().size() > 0);
+	TestTrue(TEXT("GT Test 3 async output matches sync output"), AsyncStream.str() == SyncStream.str());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimGroundTruthRecorderTest4, "DMSSim.GroundTruthRecorder.Tests4", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool DMSSimGroundTruthRecorderTest4::RunTest(const FString& Parameters)
+{
+	// frames from the pool are recycled and record the same rows as the frames they were copied from
+	constexpr int FrameCount = 10;
+	auto Scenario = MakeShared<DMSSimGroundTruthScenarioConstants, ESPMode::ThreadSafe>();
+	Scenario->Camera.Position_inCar = { 0.2f, 0.0f, 1.1f };
+	const DMSSimGroundTruthScenarioConstantsPtr ScenarioPtr = Scenario;
+
+	std::stringstream SourceStream;
+	std::stringstream PooledStream;
+	DMSSimGroundTruthFramePool Pool(1);
+	for (int i = 0; i < FrameCount; ++i) {
+		DMSSimGroundTruthFrame Frame = MakeFrame(i);
+		Frame.Scenario = ScenarioPtr;
+		AddFrame(SourceStream, i / 30.0, Frame);
+		const auto Pooled = Pool.Acquire(Frame);
+		TestTrue(TEXT("GT Test 4 scenario is shared"), Pooled->Scenario == ScenarioPtr);
+		AddFrame(PooledStream, i / 30.0, *Pooled);
+	}
+
+	const auto Stats = Pool.GetStats();
+	TestEqual(TEXT("GT Test 4 pool misses"), int32(Stats.Misses), 1);
+	TestEqual(TEXT("GT Test 4 pool hits"), int32(Stats.Hits), FrameCount - 1);
+	TestTrue(TEXT("GT Test 4 pooled output matches"), PooledStream.str() == SourceStream.str());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimGroundTruthRecorderTest5, "DMSSim.GroundTruthRecorder.Tests5", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool DMSSimGroundTruthRecorderTest5::RunTest(const FString& Parameters)
+{
+	// the combined matrix of the frame converts the points like the separate steps
+	const RotatedCoordinateSpace CoordinateSpace;
+	DMSSimGroundTruthFrame Frame = MakeFrame(7);
+	// every occupant needs all landmark columns, so the row matches the header
+	for (auto& Occupant : Frame.Data.Occupants) {
+		Occupant.Initialized = true;
+		Occupant.FacialLandmarksVisible.SetNum(68);
+		Occupant.FacialLandmarks3D_inCam.SetNum(68);
+		Occupant.FacialLandmarks2D.SetNum(68);
+		Occupant.FaceBoundingBox3D_inCam.SetNum(8);
+	}
+	const auto& CarRotation = Frame.Data.CarRotation_inWorld;
+	const auto& CarPosition = Frame.Data.CarPosition_inWorld;
+	const auto Transform = DMSSimGroundTruthTransform::Create(CoordinateSpace, CarRotation, CarPosition);
+
+	const auto& Driver = Frame.Data.Occupants[static_cast<uint8>(FDMSSimOccupantType::Driver)];
+	std::vector<FVector> Points = { Driver.NosePoint, Driver.LEarPoint, Driver.REarPoint, Driver.LeftEyePoint, Driver.RightEyePoint, FVector(0.0f, 0.0f, 0.0f) };
+	for (const auto& Landmark : Driver.FacialLandmarks3D_inCam) { Points.push_back(Landmark); }
+	std::vector<float> X, Y, Z;
+	for (const auto& Point : Points) {
+		X.push_back(Point.X);
+		Y.push_back(Point.Y);
+		Z.push_back(Point.Z);
+	}
+	std::vector<float> OutX(Points.size()), OutY(Points.size()), OutZ(Points.size());
+	Transform.TransformPoints(X.data(), Y.data(), Z.data(), int32(Points.size()), OutX.data(), OutY.data(), OutZ.data());
+	bool PointsEqual = true;
+	bool BatchEqual = true;
+	for (size_t i = 0; i < Points.size(); ++i) {
+		const FVector Expected = ConvertPointStepwise(CoordinateSpace, CarRotation, CarPosition, Points[i]);
+		PointsEqual = PointsEqual && IsNearlyEqual(Transform.TransformPoint(Points[i]), Expected);
+		BatchEqual = BatchEqual && IsNearlyEqual(FVector(OutX[i], OutY[i], OutZ[i]), Expected);
+	}
+	TestTrue(TEXT("GT Test 5 points"), PointsEqual);
+	TestTrue(TEXT("GT Test 5 batched points"), BatchEqual);
+
+	const FVector Directions[] = { Driver.LeftGazeDirection_inCam, Driver.RightGazeDirection_inCam, FVector(0.3f, -0.4f, 0.866f) };
+	bool DirectionsEqual = true;
+	for (const auto& Direction : Directions) {
+		DirectionsEqual = DirectionsEqual && IsNearlyEqual(Transform.TransformDirection(Direction), ConvertDirectionStepwise(CoordinateSpace, CarRotation, Direction));
+	}
+	TestTrue(TEXT("GT Test 5 directions"), DirectionsEqual);
+
+	// the rows have the values of the separate steps with the coordinate space of the scenario
+	std::stringstream Stream;
+	AddHeader(Stream);
+	AddFrame(Stream, 0.1, Frame);
+	std::map<std::string, std::string> ValueMap;
+	LoadValueMap(Stream, ValueMap);
+	const FVector LeftEye = ConvertPointStepwise(DMSSimConfig::GetCoordinateSpace(), CarRotation, CarPosition, Driver.LeftEyePoint);
+	const FVector Recorded(std::stof(*GetValue(ValueMap, "s_DM_LeftEyePositionX")), std::stof(*GetValue(ValueMap, "s_DM_LeftEyePositionY")),
+		std::stof(*GetValue(ValueMap, "s_DM_LeftEyePositionZ")));
+	TestTrue(TEXT("GT Test 5 recorded point"), IsNearlyEqual(Recorded, LeftEye));
+	TestEqual(TEXT("GT Test 5 computed occupants"), int32(ComputeOccupants(0.1, Frame)), int32(sizeof(Frame.Data.Occupants) / sizeof(Frame.Data.Occupants[0])));
+
+	// with scenario constants, the coordinate space and the mirroring come from the frame, not from the current scenario
+	auto Scenario = MakeShared<DMSSimGroundTruthScenarioConstants, ESPMode::ThreadSafe>();
+	Scenario->CoordinateSpace = DMSSimGroundTruthCoordinateSpace(CoordinateSpace);
+	Frame.Scenario = Scenario;
+	std::stringstream ScenarioStream;
+	AddHeader(ScenarioStream);
+	AddFrame(ScenarioStream, 0.1, Frame);
+	Scenario->Camera.Mirrored = true;
+	AddFrame(ScenarioStream, 0.1, Frame);
+	std::map<std::string, std::string> ScenarioValueMap, MirroredValueMap;
+	LoadValueMap(ScenarioStream, ScenarioValueMap);
+	LoadValueMap(ScenarioStream, MirroredValueMap, 2);
+	const FVector RotatedLeftEye = ConvertPointStepwise(CoordinateSpace, CarRotation, CarPosition, Driver.LeftEyePoint);
+	const FVector ScenarioRecorded(std::stof(*GetValue(ScenarioValueMap, "s_DM_LeftEyePositionX")), std::stof(*GetValue(ScenarioValueMap, "s_DM_LeftEyePositionY")),
+		std::stof(*GetValue(ScenarioValueMap, "s_DM_LeftEyePositionZ")));
+	TestTrue(TEXT("GT Test 5 scenario coordinate space"), IsNearlyEqual(ScenarioRecorded, RotatedLeftEye));
+	const float Yaw = std::stof(*GetValue(ScenarioValueMap, "s_DM_HeadRotationYaw"));
+	const float MirroredYaw = std::stof(*GetValue(MirroredValueMap, "s_DM_HeadRotationYaw"));
+	TestTrue(TEXT("GT Test 5 scenario mirrored"), Yaw != 0.0f && FMath::Abs(Yaw + MirroredYaw) < 1e-5f);
+	return true;
+}
 #endif //WITH_DEV_AUTOMATION_TESTS
\ No newline at end of file
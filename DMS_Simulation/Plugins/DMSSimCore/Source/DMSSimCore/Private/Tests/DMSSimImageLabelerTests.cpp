@@ -0,0 +1,293 @@
+#include "DMSSimImageLabeler.h"
+#include "DMSSimLabelTestUtils.h"
+#include "DMSSimLabelWriter.h"
+#include "Misc/AutomationTest.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// The allocation hook replaces the global allocation functions, so it's only built into the standalone test executable,
+// never into the engine. libstdc++ and rapidjson allocate by operator new and malloc, both are counted.
+#if DMSSIM_ALLOCATION_HOOK && defined(__GLIBC__)
+#include <new>
+
+extern "C" {
+void* __libc_malloc(size_t Size);
+void* __libc_calloc(size_t Count, size_t Size);
+void* __libc_realloc(void* Memory, size_t Size);
+void __libc_free(void* Memory);
+}
+
+namespace {
+thread_local bool CountAllocations = false;
+thread_local int64 Allocations = 0;
+
+/** Counts the heap allocations of the calling thread during its lifetime. */
+class ScopedAllocationCount {
+public:
+	ScopedAllocationCount() : Start_(Allocations) { CountAllocations = true; }
+	~ScopedAllocationCount() { CountAllocations = false; }
+	int64 Get() const { return Allocations - Start_; }
+
+private:
+	const int64 Start_;
+};
+} // anonymous namespace
+
+extern "C" void* malloc(size_t Size) noexcept { Allocations += CountAllocations; return __libc_malloc(Size); }
+extern "C" void* calloc(size_t Count, size_t Size) noexcept { Allocations += CountAllocations; return __libc_calloc(Count, Size); }
+extern "C" void* realloc(void* Memory, size_t Size) noexcept { Allocations += CountAllocations; return __libc_realloc(Memory, Size); }
+extern "C" void free(void* Memory) noexcept { __libc_free(Memory); }
+
+void* operator new(std::size_t Size) {
+	Allocations += CountAllocations;
+	if (void* const Memory = __libc_malloc(Size > 0 ? Size : 1)) { return Memory; }
+	throw std::bad_alloc();
+}
+void operator delete(void* Memory) noexcept { __libc_free(Memory); }
+void operator delete(void* Memory, std::size_t) noexcept { __libc_free(Memory); }
+#endif
+
+namespace {
+
+constexpr int WARM_UP_FRAMES = 2;
+constexpr int STEADY_FRAMES = 20;
+constexpr int WRITER_FRAMES = 40;
+constexpr int WRITER_THREADS = 3;
+constexpr size_t WRITER_COMMIT_WINDOW = 4;
+constexpr int GOLDEN_FRAMES = 3;
+constexpr int NO_SCENARIO_FRAMES = 2;
+
+TSharedPtr<DMSSimGroundTruthFrame> MakeLabelFrame(const DMSSimGroundTruthScenarioConstantsPtr& Scenario, const int Seed) {
+	return DMSSimLabelTestUtils::MakeFrame(Scenario, [Seed](DMSSimGroundTruthOccupant& Driver) {
+		for (int i = 0; i < MAX_FACIAL_LANDMARKS; ++i) {
+			Driver.FacialLandmarksVisible[i] = (i + Seed) % 3 != 0;
+			Driver.FacialLandmarks2D[i] = FVector2D(float(10 * i + Seed), float(5 * i));
+		}
+		Driver.LeftEyeOpening = Driver.RightEyeOpening = 0.9f;
+	});
+}
+
+/** Two occupants with accessories and a placed camera, so every static label differs from its default. */
+DMSSimGroundTruthScenarioConstantsPtr MakeGoldenScenario() {
+	auto Scenario = MakeShared<DMSSimGroundTruthScenarioConstants, ESPMode::ThreadSafe>();
+	Scenario->Description = "golden scenario";
+	Scenario->Camera.Position_inCar = FVector(112.5f, -20.25f, 95.75f);
+	Scenario->Camera.Rotation_inCar = FRotator(-12.5f, 180.0f, 1.25f);
+	Scenario->Camera.FrameSize = FIntPoint(1280, 960);
+	Scenario->OccupantCount = 2;
+	FDMSSimOccupant Driver;
+	Driver.Type = FDMSSimOccupantType::Driver;
+	Driver.Character = TEXT("Ada");
+	Driver.Glasses.Model = 9;
+	Scenario->Occupants.Add(Driver);
+	FDMSSimOccupant Passenger;
+	Passenger.Type = FDMSSimOccupantType::PassengerFront;
+	Passenger.Character = TEXT("Omar");
+	Passenger.Headgear = 1;
+	Passenger.Mask = 4;
+	Scenario->Occupants.Add(Passenger);
+	return Scenario;
+}
+
+TSharedPtr<DMSSimGroundTruthFrame> MakeGoldenFrame(const DMSSimGroundTruthScenarioConstantsPtr& Scenario, const int Seed) {
+	auto Frame = MakeLabelFrame(Scenario, Seed);
+	auto& Passenger = Frame->Data.Occupants[static_cast<uint8>(FDMSSimOccupantType::PassengerFront)];
+	Passenger = Frame->Data.Occupants[static_cast<uint8>(FDMSSimOccupantType::Driver)];
+	for (int i = 0; i < MAX_FACIAL_LANDMARKS; ++i) { Passenger.FacialLandmarks2D[i] = FVector2D(700.25f + 2.5f * i, 300.75f - 0.5f * i + Seed); }
+	Passenger.HeadDirection_inCam = FVector(0.125f * Seed, 0.5f, -0.75f);
+	Passenger.HeadRotation_inCar = FRotator(2.5f, 10.0f - Seed, -1.5f);
+	Passenger.LeftEyeOpening = 1.1f;
+	Passenger.RightEyePupilVisibilityPerc = 0.0f;
+	return Frame;
+}
+
+/** Replaces the values of the timestamps, the only labels that depend on the time of the recording. */
+std::string MaskTimestamps(std::string Json) {
+	const std::string Key = "\"timestamp\":";
+	for (size_t Pos = Json.find(Key); Pos != std::string::npos; Pos = Json.find(Key, Pos + Key.size())) {
+		const size_t Begin = Json.find('"', Pos + Key.size());
+		const size_t End = Json.find('"', Begin + 1);
+		Json.replace(Begin + 1, End - Begin - 1, "TIMESTAMP");
+	}
+	return Json;
+}
+
+/** Compares the labels with the golden file, or rewrites the golden file if DMSSIM_UPDATE_GOLDEN is set. */
+bool MatchesGolden(const std::filesystem::path& Path, const char* const GoldenName) {
+	const std::string Json = MaskTimestamps(DMSSimLabelTestUtils::ReadFile(Path));
+	const auto GoldenPath = std::filesystem::path(DMSSIM_GOLDEN_DIR) / GoldenName;
+	if (std::getenv("DMSSIM_UPDATE_GOLDEN")) {
+		std::ofstream(GoldenPath, std::ios_base::out | std::ios_base::binary) << Json;
+	}
+	return !Json.empty() && Json == DMSSimLabelTestUtils::ReadFile(GoldenPath);
+}
+
+} // anonymous namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimImageLabelerTest1, "DMSSim.ImageLabeler.Tests1", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool DMSSimImageLabelerTest1::RunTest(const FString& Parameters)
+{
+	// once the label pool has grown to the size of a frame, the following frames don't allocate
+	const DMSSimGroundTruthScenarioConstantsPtr ScenarioPtr = DMSSimLabelTestUtils::MakeScenario();
+
+	const auto Directory = std::filesystem::temp_directory_path() / "DMSSimImageLabelerTest1";
+	std::filesystem::remove_all(Directory);
+	std::filesystem::create_directories(Directory);
+	const std::wstring BaseFileName = (Directory / "labels").wstring();
+
+	// the frames are made up front, so only the labeler runs while the allocations are counted
+	std::vector<TSharedPtr<DMSSimGroundTruthFrame>> SteadyFrames;
+	for (int i = 0; i <= STEADY_FRAMES; ++i) { SteadyFrames.push_back(MakeLabelFrame(ScenarioPtr, WARM_UP_FRAMES + i)); }
+
+	int64 WarmUpAllocatingFrames = 0;
+	int64 AllocatingFrames = 0;
+	int64 Frames = 0;
+	int64 SteadyAllocations = 0;
+	{
+		DMSSimImageLabelerImpl Labeler(BaseFileName, true);
+		for (int i = 0; i < WARM_UP_FRAMES; ++i) { Labeler.AddFrame(MakeLabelFrame(ScenarioPtr, i), MakeLabelFrame(ScenarioPtr, i + 1), i); }
+		WarmUpAllocatingFrames = Labeler.GetLabelPoolStats().AllocatingFrames;
+		{
+#if DMSSIM_ALLOCATION_HOOK && defined(__GLIBC__)
+			const ScopedAllocationCount Count;
+#endif
+			for (int i = 0; i < STEADY_FRAMES; ++i) { Labeler.AddFrame(SteadyFrames[i], SteadyFrames[i + 1], WARM_UP_FRAMES + i); }
+#if DMSSIM_ALLOCATION_HOOK && defined(__GLIBC__)
+			SteadyAllocations = Count.Get();
+#endif
+		}
+		Labeler.Finalize();
+		AllocatingFrames = Labeler.GetLabelPoolStats().AllocatingFrames;
+		Frames = Labeler.GetLabelPoolStats().Frames;
+	}
+
+	rapidjson::Document Document;
+	Document.Parse(DMSSimLabelTestUtils::ReadFile(Directory / "labels.json").c_str());
+	std::filesystem::remove_all(Directory);
+
+	TestEqual(TEXT("Labeler Test 1 frames"), int32(Frames), WARM_UP_FRAMES + STEADY_FRAMES);
+	TestEqual(TEXT("Labeler Test 1 allocating steady frames"), int32(AllocatingFrames - WarmUpAllocatingFrames), 0);
+	TestEqual(TEXT("Labeler Test 1 steady heap allocations"), int32(SteadyAllocations), 0);
+	TestFalse(TEXT("Labeler Test 1 json is valid"), Document.HasParseError());
+	TestTrue(TEXT("Labeler Test 1 json has the frames"), !Document.HasParseError() && Document["openlabel"]["frames"].MemberCount() == WARM_UP_FRAMES + STEADY_FRAMES);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimImageLabelerTest2, "DMSSim.ImageLabeler.Tests2", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool DMSSimImageLabelerTest2::RunTest(const FString& Parameters)
+{
+	// the frames serialized by the worker pool are written in the order they were added
+	const DMSSimGroundTruthScenarioConstantsPtr ScenarioPtr = DMSSimLabelTestUtils::MakeScenario();
+	const auto Directory = std::filesystem::temp_directory_path() / "DMSSimImageLabelerTest2";
+	std::filesystem::remove_all(Directory);
+	std::filesystem::create_directories(Directory);
+	const std::wstring BaseFileName = (Directory / "labels").wstring();
+
+	DMSSimLabelWriter::Stats Stats;
+	int WorkerCount = 0;
+	{
+		DMSSimLabelWriter Writer(BaseFileName, DMSSimLabelWriter::AllLabels, true, WRITER_THREADS, WRITER_COMMIT_WINDOW);
+		WorkerCount = Writer.GetWorkerCount();
+		for (int i = 0; i < WRITER_FRAMES; ++i) { Writer.AddFrame(MakeLabelFrame(ScenarioPtr, i), MakeLabelFrame(ScenarioPtr, i + 1), i); }
+		Writer.Finalize();
+		Stats = Writer.GetStats();
+	}
+
+	rapidjson::Document Document;
+	Document.Parse(DMSSimLabelTestUtils::ReadFile(Directory / "labels.json").c_str());
+	int OldFiles = 0;
+	for (const auto& Entry : std::filesystem::directory_iterator(Directory)) {
+		if (Entry.path().stem().string().find("_old") != std::string::npos) { ++OldFiles; }
+	}
+	std::filesystem::remove_all(Directory);
+
+	bool Ordered = !Document.HasParseError();
+	int FrameIdx = 0;
+	if (Ordered) {
+		for (const auto& Frame : Document["openlabel"]["frames"].GetObject()) { Ordered = Ordered && Frame.name.GetString() == std::to_string(FrameIdx++); }
+	}
+
+	TestEqual(TEXT("Labeler Test 2 workers"), WorkerCount, WRITER_THREADS);
+	TestEqual(TEXT("Labeler Test 2 frames"), int32(Stats.Frames), WRITER_FRAMES);
+	TestFalse(TEXT("Labeler Test 2 json is valid"), Document.HasParseError());
+	TestTrue(TEXT("Labeler Test 2 frames in order"), Ordered && FrameIdx == WRITER_FRAMES);
+	TestEqual(TEXT("Labeler Test 2 old label files"), OldFiles, WRITER_FRAMES);
+	TestTrue(TEXT("Labeler Test 2 queue depth within the window"), Stats.MaxQueueDepth <= WRITER_COMMIT_WINDOW && Stats.MaxCommitDepth < WRITER_COMMIT_WINDOW);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimImageLabelerTest3, "DMSSim.ImageLabeler.Tests3", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool DMSSimImageLabelerTest3::RunTest(const FString& Parameters)
+{
+	// the labels of both modes are the same as in the golden files, apart from the timestamps
+	const DMSSimGroundTruthScenarioConstantsPtr ScenarioPtr = MakeGoldenScenario();
+	const auto Directory = std::filesystem::temp_directory_path() / "DMSSimImageLabelerTest3";
+	std::filesystem::remove_all(Directory);
+	std::filesystem::create_directories(Directory);
+	const std::wstring FramesBaseName = (Directory / "frames").wstring();
+	const std::wstring StreamBaseName = (Directory / "stream").wstring();
+	{
+		DMSSimImageLabelerImpl FramesLabeler(FramesBaseName);
+		DMSSimImageLabelerImpl StreamLabeler(StreamBaseName, true);
+		for (int i = 0; i < GOLDEN_FRAMES; ++i) {
+			FramesLabeler.AddFrame(MakeGoldenFrame(ScenarioPtr, i), MakeGoldenFrame(ScenarioPtr, i + 1), i);
+			StreamLabeler.AddFrame(MakeGoldenFrame(ScenarioPtr, i), MakeGoldenFrame(ScenarioPtr, i + 1), i);
+		}
+	}
+
+	// the frame files only differ in their labels, the last one is compared to keep the golden files small
+	const std::string FrameName = "frames_0000" + std::to_string(GOLDEN_FRAMES - 1) + ".json";
+	const bool SameFrameFile = MatchesGolden(Directory / FrameName, FrameName.c_str());
+	const bool SameStream = MatchesGolden(Directory / "stream.json", "stream.json");
+	std::filesystem::remove_all(Directory);
+
+	TestTrue(TEXT("Labeler Test 3 frame file as the golden file"), SameFrameFile);
+	TestTrue(TEXT("Labeler Test 3 stream as the golden file"), SameStream);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimImageLabelerTest4, "DMSSim.ImageLabeler.Tests4", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool DMSSimImageLabelerTest4::RunTest(const FString& Parameters)
+{
+	// frames without a scenario, e.g. after the ground truth was reset, get the labels of the empty scenario, not fragments never built
+	const DMSSimGroundTruthScenarioConstantsPtr ScenarioPtr = DMSSimLabelTestUtils::MakeScenario();
+	const auto Directory = std::filesystem::temp_directory_path() / "DMSSimImageLabelerTest4";
+	std::filesystem::remove_all(Directory);
+	std::filesystem::create_directories(Directory);
+	const std::wstring FramesBaseName = (Directory / "frames").wstring();
+	const std::wstring StreamBaseName = (Directory / "stream").wstring();
+	{
+		DMSSimImageLabelerImpl FramesLabeler(FramesBaseName);
+		DMSSimImageLabelerImpl StreamLabeler(StreamBaseName, true);
+		for (int i = 0; i < 2 * NO_SCENARIO_FRAMES; ++i) {
+			const auto Scenario = i < NO_SCENARIO_FRAMES ? nullptr : ScenarioPtr;
+			FramesLabeler.AddFrame(MakeLabelFrame(Scenario, i), MakeLabelFrame(Scenario, i + 1), i);
+			StreamLabeler.AddFrame(MakeLabelFrame(Scenario, i), MakeLabelFrame(Scenario, i + 1), i);
+		}
+	}
+
+	int ValidFrameFiles = 0;
+	for (int i = 0; i < 2 * NO_SCENARIO_FRAMES; ++i) {
+		rapidjson::Document Document;
+		Document.Parse(DMSSimLabelTestUtils::ReadFile(Directory / ("frames_0000" + std::to_string(i) + ".json")).c_str());
+		ValidFrameFiles += !Document.HasParseError() && Document.HasMember("openlabel") && Document["openlabel"].HasMember("frames") ? 1 : 0;
+	}
+	rapidjson::Document Stream;
+	Stream.Parse(DMSSimLabelTestUtils::ReadFile(Directory / "stream.json").c_str());
+	std::filesystem::remove_all(Directory);
+
+	TestEqual(TEXT("Labeler Test 4 valid frame files"), ValidFrameFiles, 2 * NO_SCENARIO_FRAMES);
+	TestFalse(TEXT("Labeler Test 4 stream is valid"), Stream.HasParseError());
+	TestTrue(TEXT("Labeler Test 4 stream has the frames"), !Stream.HasParseError() && Stream["openlabel"]["frames"].MemberCount() == 2 * NO_SCENARIO_FRAMES);
+	return true;
+}
+#endif //WITH_DEV_AUTOMATION_TESTS
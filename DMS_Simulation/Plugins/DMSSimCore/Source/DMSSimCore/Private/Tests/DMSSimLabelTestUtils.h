@@ -0,0 +1,56 @@
+#pragma once
+#include "DMSSimConfig.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+/**
+ * @brief Ground truth of the label tests, shared by the labeler tests and the tests of the label tools.
+ */
+namespace DMSSimLabelTestUtils {
+
+/** A scenario with Ada as the only occupant, the driver. */
+inline DMSSimGroundTruthScenarioConstantsPtr MakeScenario() {
+	auto Scenario = MakeShared<DMSSimGroundTruthScenarioConstants, ESPMode::ThreadSafe>();
+	Scenario->OccupantCount = 1;
+	FDMSSimOccupant Driver;
+	Driver.Type = FDMSSimOccupantType::Driver;
+	Driver.Character = TEXT("Ada");
+	Scenario->Occupants.Add(Driver);
+	return Scenario;
+}
+
+/**
+ * A frame of the scenario with the driver initialized. The landmark arrays have their full sizes, the eye lids and pupils
+ * are visible, the rest of the labels are zero until SetDriver(DMSSimGroundTruthOccupant&) sets the values of the frame.
+ */
+template <typename TSetDriver>
+TSharedPtr<DMSSimGroundTruthFrame> MakeFrame(const DMSSimGroundTruthScenarioConstantsPtr& Scenario, TSetDriver&& SetDriver) {
+	auto Frame = MakeShared<DMSSimGroundTruthFrame, ESPMode::ThreadSafe>();
+	Frame->Scenario = Scenario;
+	auto& Driver = Frame->Data.Occupants[static_cast<uint8>(FDMSSimOccupantType::Driver)];
+	Driver.Initialized = true;
+	Driver.FacialLandmarksVisible.SetNum(MAX_FACIAL_LANDMARKS);
+	Driver.FacialLandmarks2D.SetNum(MAX_FACIAL_LANDMARKS);
+	Driver.FacialLandmarks3D_inCam.SetNum(MAX_FACIAL_LANDMARKS);
+	Driver.FaceBoundingBox3D_inCam.SetNum(FACE_BOUNDING_BOX_3D_CORNERS);
+	Driver.RightEyePupilLandmarks2D.SetNum(MAX_PUPIL_IRIS_LANDMARKS);
+	Driver.RightEyeIrisLandmarks2D.SetNum(MAX_PUPIL_IRIS_LANDMARKS);
+	Driver.LeftEyePupilLandmarks2D.SetNum(MAX_PUPIL_IRIS_LANDMARKS);
+	Driver.LeftEyeIrisLandmarks2D.SetNum(MAX_PUPIL_IRIS_LANDMARKS);
+	Driver.PupilIrisLandmarksVisible.SetNum(4 * MAX_PUPIL_IRIS_LANDMARKS);
+	Driver.LeftEyeLidVisibilityPerc = Driver.RightEyeLidVisibilityPerc = 0.95f;
+	Driver.LeftEyePupilVisibilityPerc = Driver.RightEyePupilVisibilityPerc = 0.8f;
+	SetDriver(Driver);
+	return Frame;
+}
+
+inline std::string ReadFile(const std::filesystem::path& Path) {
+	std::ifstream File(Path, std::ios_base::in | std::ios_base::binary);
+	std::stringstream Content;
+	Content << File.rdbuf();
+	return Content.str();
+}
+
+} // namespace DMSSimLabelTestUtils
@@ -0,0 +1,164 @@
+#include "DMSSimLandmarkProjection.h"
+#include "Misc/AutomationTest.h"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace {
+
+constexpr float PROJECTION_TOLERANCE = 1e-3f; // pixels
+constexpr int PROJECTION_POINTS = 300;      // more than one block of the batched functions
+const float LENS_DISTORTION[DMSSIM_DISTORTION_COEFFICIENT_COUNT] = { -0.28f, 0.09f, 0.0012f, -0.0007f, -0.015f };
+
+/** Points of a face 40 - 90 cm in front of the camera, like the ..._inCam landmarks. */
+void MakeFacePoints(const uint32_t Seed, std::vector<float>& X, std::vector<float>& Y, std::vector<float>& Z) {
+	std::mt19937 Random(Seed);
+	std::uniform_real_distribution<float> Depth(40.0f, 90.0f);
+	std::uniform_real_distribution<float> Side(-25.0f, 25.0f);
+	X.resize(PROJECTION_POINTS);
+	Y.resize(PROJECTION_POINTS);
+	Z.resize(PROJECTION_POINTS);
+	for (int i = 0; i < PROJECTION_POINTS; ++i) {
+		X[i] = Depth(Random);
+		Y[i] = Side(Random);
+		Z[i] = Side(Random);
+	}
+}
+
+float Distance(const FVector2D& A, const float U, const float V) { return std::hypot(A.X - U, A.Y - V); }
+
+/** Parses Ada.yml with the line added to its camera block, returns nullptr if it's invalid. */
+std::unique_ptr<DMSSimScenarioParser> ParseScenario(const std::filesystem::path& Directory, const char* const CameraLine) {
+	const auto FilePath = Directory / "Scenario.yml";
+	{
+		std::ifstream Source(std::filesystem::path(DMSSIM_SCENARIO_DIR) / "Ada.yml");
+		std::ofstream File(FilePath, std::ios_base::trunc);
+		std::string Line;
+		while (std::getline(Source, Line)) {
+			File << Line << "\n";
+			if (Line == "camera:") { File << CameraLine << "\n"; }
+		}
+	}
+	std::unique_ptr<DMSSimConfigParser> Config(DMSSimConfigParser::Create(DMSSIM_CONFIG_PATH));
+	if (!Config) { return nullptr; }
+	return std::unique_ptr<DMSSimScenarioParser>(DMSSimScenarioParser::Create(FilePath.wstring().c_str(), *Config));
+}
+
+} // anonymous namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimLandmarkProjectionTest1, "DMSSim.LandmarkProjection.Tests1", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+bool DMSSimLandmarkProjectionTest1::RunTest(const FString& Parameters)
+{
+	// Test 1: the batched projection and distortion give the points of the scalar ones
+	std::vector<float> X, Y, Z;
+	MakeFacePoints(7, X, Y, Z);
+	for (const bool Mirrored : { false, true }) {
+		const auto Intrinsics = DMSSimCameraIntrinsics::Create(1312, 1008, 43.6f, Mirrored, LENS_DISTORTION);
+		TestTrue(TEXT("Projection Test 1 distorted"), Intrinsics.Distorted);
+
+		std::vector<float> U(PROJECTION_POINTS), V(PROJECTION_POINTS);
+		DMSSimLandmarkProjection::ProjectPoints(Intrinsics, X.data(), Y.data(), Z.data(), PROJECTION_POINTS, U.data(), V.data());
+		float MaxProjectionError = 0.0f;
+		for (int i = 0; i < PROJECTION_POINTS; ++i) {
+			MaxProjectionError = FMath::Max(MaxProjectionError, Distance(DMSSimLandmarkProjection::ProjectPoint(Intrinsics, FVector(X[i], Y[i], Z[i])), U[i], V[i]));
+		}
+		TestTrue(TEXT("Projection Test 1 batched projection"), MaxProjectionError < PROJECTION_TOLERANCE);
+
+		// the pinhole pixels of the same points, moved by the distortion
+		const auto Pinhole = DMSSimCameraIntrinsics::Create(1312, 1008, 43.6f, Mirrored);
+		DMSSimLandmarkProjection::ProjectPoints(Pinhole, X.data(), Y.data(), Z.data(), PROJECTION_POINTS, U.data(), V.data());
+		std::vector<FVector2D> Pixels(PROJECTION_POINTS);
+		for (int i = 0; i < PROJECTION_POINTS; ++i) { Pixels[i] = FVector2D(U[i], V[i]); }
+		DMSSimLandmarkProjection::DistortPixels(Intrinsics, U.data(), V.data(), PROJECTION_POINTS);
+		float MaxDistortionError = 0.0f;
+		float MaxProjectedError = 0.0f;
+		for (int i = 0; i < PROJECTION_POINTS; ++i) {
+			MaxDistortionError = FMath::Max(MaxDistortionError, Distance(DMSSimLandmarkProjection::DistortPixel(Intrinsics, Pixels[i]), U[i], V[i]));
+			MaxProjectedError = FMath::Max(MaxProjectedError, Distance(DMSSimLandmarkProjection::ProjectPoint(Intrinsics, FVector(X[i], Y[i], Z[i])), U[i], V[i]));
+		}
+		TestTrue(TEXT("Projection Test 1 batched distortion"), MaxDistortionError < PROJECTION_TOLERANCE);
+		TestTrue(TEXT("Projection Test 1 distorted pinhole pixels"), MaxProjectedError < 0.01f);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimLandmarkProjectionTest2, "DMSSim.LandmarkProjection.Tests2", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+bool DMSSimLandmarkProjectionTest2::RunTest(const FString& Parameters)
+{
+	// Test 2: without distortion the points follow the matrix3x4 of the frame coordinate system of the labels (Y of ifcd_sdt is -Y)
+	const auto Intrinsics = DMSSimCameraIntrinsics::Create(1280, 960, 60.0f, false);
+	TestFalse(TEXT("Projection Test 2 not distorted"), Intrinsics.Distorted);
+	TestEqual(TEXT("Projection Test 2 principal point"), Intrinsics.Cx, 640.0f);
+	TestEqual(TEXT("Projection Test 2 focal length"), Intrinsics.FocalLength, float(640.0 / std::tan(FMath::DegreesToRadians(30.0))));
+
+	const FVector Point(60.0f, -12.5f, 7.25f);
+	const auto Pixel = DMSSimLandmarkProjection::ProjectPoint(Intrinsics, Point);
+	const float U = Intrinsics.Cx - Intrinsics.FocalLength * -Point.Y / Point.X;
+	const float V = Intrinsics.Cy - Intrinsics.FocalLength * Point.Z / Point.X;
+	TestTrue(TEXT("Projection Test 2 pinhole"), Distance(Pixel, U, V) < PROJECTION_TOLERANCE);
+	const auto Mirrored = DMSSimLandmarkProjection::ProjectPoint(DMSSimCameraIntrinsics::Create(1280, 960, 60.0f, true), Point);
+	TestTrue(TEXT("Projection Test 2 mirrored"), Distance(Mirrored, 1280.0f - U, V) < PROJECTION_TOLERANCE);
+	TestTrue(TEXT("Projection Test 2 behind the camera"), Distance(DMSSimLandmarkProjection::ProjectPoint(Intrinsics, FVector(-5.0f, 3.0f, 1.0f)), Intrinsics.Cx, Intrinsics.Cy) == 0.0f);
+	TestTrue(TEXT("Projection Test 2 pinhole pixel"), Distance(DMSSimLandmarkProjection::DistortPixel(Intrinsics, Pixel), Pixel.X, Pixel.Y) < PROJECTION_TOLERANCE);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimLandmarkProjectionTest3, "DMSSim.LandmarkProjection.Tests3", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+bool DMSSimLandmarkProjectionTest3::RunTest(const FString& Parameters)
+{
+	// Test 3: the labels of an occupant are projected like the single points, the distortion is read from the camera block
+	const auto Intrinsics = DMSSimCameraIntrinsics::Create(1312, 1008, 43.6f, true, LENS_DISTORTION);
+	std::vector<float> X, Y, Z;
+	MakeFacePoints(11, X, Y, Z);
+	DMSSimGroundTruthOccupant Occupant = {};
+	for (int i = 0; i < MAX_FACIAL_LANDMARKS; ++i) { Occupant.FacialLandmarks3D_inCam.Add(FVector(X[i], Y[i], Z[i])); }
+	for (int i = 0; i < MAX_PUPIL_IRIS_LANDMARKS; ++i) {
+		Occupant.RightEyePupilLandmarks2D.Add(FVector2D(500.0f + i, 400.0f + i));
+		Occupant.LeftEyeIrisLandmarks2D.Add(FVector2D(800.0f - i, 410.0f + i));
+	}
+	Occupant.FaceBoundingBox2D.Center = FVector2D(650.0f, 480.0f);
+	Occupant.FaceBoundingBox2D.Width = 420.0f;
+	Occupant.FaceBoundingBox2D.Height = 500.0f;
+	const auto Pinhole = Occupant;
+
+	DMSSimLandmarkProjection::ProjectOccupant(Intrinsics, Occupant);
+	TestEqual(TEXT("Projection Test 3 facial landmarks"), Occupant.FacialLandmarks2D.Num(), MAX_FACIAL_LANDMARKS);
+	float MaxError = 0.0f;
+	for (int i = 0; i < Occupant.FacialLandmarks2D.Num(); ++i) {
+		const auto Pixel = DMSSimLandmarkProjection::ProjectPoint(Intrinsics, Pinhole.FacialLandmarks3D_inCam[i]);
+		MaxError = FMath::Max(MaxError, Distance(Pixel, Occupant.FacialLandmarks2D[i].X, Occupant.FacialLandmarks2D[i].Y));
+	}
+	for (int i = 0; i < MAX_PUPIL_IRIS_LANDMARKS; ++i) {
+		const auto Pupil = DMSSimLandmarkProjection::DistortPixel(Intrinsics, Pinhole.RightEyePupilLandmarks2D[i]);
+		const auto Iris = DMSSimLandmarkProjection::DistortPixel(Intrinsics, Pinhole.LeftEyeIrisLandmarks2D[i]);
+		MaxError = FMath::Max(MaxError, Distance(Pupil, Occupant.RightEyePupilLandmarks2D[i].X, Occupant.RightEyePupilLandmarks2D[i].Y));
+		MaxError = FMath::Max(MaxError, Distance(Iris, Occupant.LeftEyeIrisLandmarks2D[i].X, Occupant.LeftEyeIrisLandmarks2D[i].Y));
+	}
+	TestTrue(TEXT("Projection Test 3 occupant landmarks"), MaxError < PROJECTION_TOLERANCE);
+	// the barrel distortion pulls the corners of the box towards the center
+	TestTrue(TEXT("Projection Test 3 face box"), Occupant.FaceBoundingBox2D.Width < Pinhole.FaceBoundingBox2D.Width && Occupant.FaceBoundingBox2D.Height < Pinhole.FaceBoundingBox2D.Height);
+	const auto TopLeft = DMSSimLandmarkProjection::DistortPixel(Intrinsics, FVector2D(440.0f, 230.0f));
+	const auto BottomRight = DMSSimLandmarkProjection::DistortPixel(Intrinsics, FVector2D(860.0f, 730.0f));
+	TestTrue(TEXT("Projection Test 3 face box corners"), Distance(Occupant.FaceBoundingBox2D.Center, (TopLeft.X + BottomRight.X) * 0.5f, (TopLeft.Y + BottomRight.Y) * 0.5f) < 1.0f);
+
+	const auto Directory = std::filesystem::temp_directory_path() / "DMSSimLandmarkProjectionTests";
+	std::filesystem::create_directories(Directory);
+	const auto Distorted = ParseScenario(Directory, "  distortion: [-0.28, 0.09, 0.0012, -0.0007, -0.015]");
+	bool InvalidRejected = false;
+	try { InvalidRejected = !ParseScenario(Directory, "  distortion: [-0.28, 0.09]"); }
+	catch (const std::exception&) { InvalidRejected = true; } // the parameters are validated after the parsing, the errors are thrown
+	const auto Default = ParseScenario(Directory, "");
+	TestTrue(TEXT("Projection Test 3 distortion parsed"), Distorted && DMSSimCameraIntrinsics::FromCamera(Distorted->GetCamera()).K1 == LENS_DISTORTION[0] &&
+		DMSSimCameraIntrinsics::FromCamera(Distorted->GetCamera()).K3 == LENS_DISTORTION[4]);
+	TestTrue(TEXT("Projection Test 3 distortion count"), InvalidRejected);
+	TestTrue(TEXT("Projection Test 3 no distortion"), Default && !DMSSimCameraIntrinsics::FromCamera(Default->GetCamera()).Distorted);
+	std::filesystem::remove_all(Directory);
+	return true;
+}
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,127 @@
+#include "DMSSimLensRemap.h"
+#include "Misc/AutomationTest.h"
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace {
+
+using DMSSimPixelConversion::SimdLevel;
+
+constexpr size_t REMAP_WIDTH = 203;  // not a multiple of the SIMD widths
+constexpr size_t REMAP_HEIGHT = 151; // more than two row tiles
+constexpr int REMAP_TOLERANCE = 2;   // of the 1/128 pixel fractions and the rounding
+const float LENS_DISTORTION[DMSSIM_DISTORTION_COEFFICIENT_COUNT] = { -0.28f, 0.09f, 0.0012f, -0.0007f, -0.015f };
+
+TArray<FColor> MakeFrame(const uint32_t Seed) {
+	TArray<FColor> Frame;
+	Frame.SetNumUninitialized(int32(REMAP_WIDTH * REMAP_HEIGHT));
+	std::mt19937 Random(Seed);
+	for (auto& Pixel : Frame) { Pixel = FColor(uint8(Random()), uint8(Random()), uint8(Random()), uint8(Random())); }
+	return Frame;
+}
+
+/** The bilinear interpolation of the frame at the undistorted position in floating point, black outside of the frame. */
+FColor RemapReference(const DMSSimCameraIntrinsics& Intrinsics, const TArray<FColor>& Frame, const size_t X, const size_t Y) {
+	const FVector2D Source = DMSSimLandmarkProjection::UndistortPixel(Intrinsics, FVector2D(float(X), float(Y)));
+	if (!(Source.X >= 0.0 && Source.Y >= 0.0 && Source.X <= REMAP_WIDTH - 1 && Source.Y <= REMAP_HEIGHT - 1)) { return FColor(0, 0, 0, 0); }
+	const size_t X0 = FMath::Min(size_t(Source.X), REMAP_WIDTH - 2);
+	const size_t Y0 = FMath::Min(size_t(Source.Y), REMAP_HEIGHT - 2);
+	const double Fx = Source.X - X0;
+	const double Fy = Source.Y - Y0;
+	const FColor* const P0 = &Frame[int32(Y0 * REMAP_WIDTH + X0)];
+	const FColor* const P1 = P0 + REMAP_WIDTH;
+	const auto Channel = [&](uint8 FColor::*Member) {
+		const double Top = P0[0].*Member * (1.0 - Fx) + P0[1].*Member * Fx;
+		const double Bottom = P1[0].*Member * (1.0 - Fx) + P1[1].*Member * Fx;
+		return uint8(std::lround(Top * (1.0 - Fy) + Bottom * Fy));
+	};
+	return FColor(Channel(&FColor::R), Channel(&FColor::G), Channel(&FColor::B), Channel(&FColor::A));
+}
+
+int MaxDifference(const FColor& A, const FColor& B) {
+	return FMath::Max(FMath::Max(std::abs(A.R - B.R), std::abs(A.G - B.G)), FMath::Max(std::abs(A.B - B.B), std::abs(A.A - B.A)));
+}
+
+} // anonymous namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimLensRemapTest1, "DMSSim.LensRemap.Tests1", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+bool DMSSimLensRemapTest1::RunTest(const FString& Parameters)
+{
+	// Test 1: the remap is the floating point bilinear interpolation at the undistorted pixels, for the scalar and the SIMD implementations
+	for (const bool Mirrored : { false, true }) {
+		const auto Intrinsics = DMSSimCameraIntrinsics::Create(REMAP_WIDTH, REMAP_HEIGHT, 60.0f, Mirrored, LENS_DISTORTION);
+		const DMSSimLensRemap Remap(Intrinsics, REMAP_WIDTH, REMAP_HEIGHT);
+		const auto Frame = MakeFrame(Mirrored ? 3 : 5);
+		TArray<FColor> Scalar;
+		Scalar.SetNumUninitialized(Frame.Num());
+		Remap.RemapRows(Frame.GetData(), Scalar.GetData(), 0, REMAP_HEIGHT, SimdLevel::Scalar);
+
+		int MaxError = 0;
+		size_t Invalid = 0;
+		for (size_t Y = 0; Y < REMAP_HEIGHT; ++Y) {
+			for (size_t X = 0; X < REMAP_WIDTH; ++X) {
+				MaxError = FMath::Max(MaxError, MaxDifference(Scalar[int32(Y * REMAP_WIDTH + X)], RemapReference(Intrinsics, Frame, X, Y)));
+				Invalid += Remap.GetEntry(X, Y).Valid ? 0 : 1;
+			}
+		}
+		TestTrue(TEXT("Remap Test 1 reference"), MaxError <= REMAP_TOLERANCE);
+		// only the corners of the barrel distortion come from outside of the rendered frame
+		TestTrue(TEXT("Remap Test 1 valid pixels"), Invalid < REMAP_WIDTH * REMAP_HEIGHT / 2);
+
+		for (int Level = int(SimdLevel::SSE41); Level <= int(DMSSimPixelConversion::GetSupportedSimdLevel()); ++Level) {
+			TArray<FColor> Simd;
+			Simd.SetNumUninitialized(Frame.Num());
+			Remap.RemapRows(Frame.GetData(), Simd.GetData(), 0, REMAP_HEIGHT, SimdLevel(Level));
+			bool Equal = true;
+			for (int32 i = 0; i < Frame.Num(); ++i) { Equal = Equal && Simd[i] == Scalar[i]; }
+			TestTrue(TEXT("Remap Test 1 SIMD"), Equal);
+		}
+
+		TArray<FColor> Tiled;
+		Remap.Remap(Frame, Tiled);
+		bool Equal = Tiled.Num() == Scalar.Num();
+		for (int32 i = 0; Equal && i < Frame.Num(); ++i) { Equal = Tiled[i] == Scalar[i]; }
+		TestTrue(TEXT("Remap Test 1 row tiles"), Equal);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimLensRemapTest2, "DMSSim.LensRemap.Tests2", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+bool DMSSimLensRemapTest2::RunTest(const FString& Parameters)
+{
+	// Test 2: the undistortion inverts the distortion, a camera without distortion copies the frame and gets no table
+	const auto Distorted = DMSSimCameraIntrinsics::Create(REMAP_WIDTH, REMAP_HEIGHT, 60.0f, false, LENS_DISTORTION);
+	float MaxRoundTripError = 0.0f;
+	for (size_t Y = 0; Y < REMAP_HEIGHT; Y += 10) {
+		for (size_t X = 0; X < REMAP_WIDTH; X += 10) {
+			const FVector2D Pixel{ float(X), float(Y) };
+			const FVector2D RoundTrip = DMSSimLandmarkProjection::DistortPixel(Distorted, DMSSimLandmarkProjection::UndistortPixel(Distorted, Pixel));
+			MaxRoundTripError = FMath::Max(MaxRoundTripError, float(std::hypot(RoundTrip.X - Pixel.X, RoundTrip.Y - Pixel.Y)));
+		}
+	}
+	TestTrue(TEXT("Remap Test 2 round trip"), MaxRoundTripError < 1e-2f);
+
+	const auto Pinhole = DMSSimCameraIntrinsics::Create(REMAP_WIDTH, REMAP_HEIGHT, 60.0f, false);
+	TestTrue(TEXT("Remap Test 2 no table"), DMSSimLensRemap::Get(Pinhole, REMAP_WIDTH, REMAP_HEIGHT) == nullptr);
+	const DMSSimLensRemap Identity(Pinhole, REMAP_WIDTH, REMAP_HEIGHT);
+	const auto Frame = MakeFrame(9);
+	for (int Level = int(SimdLevel::Scalar); Level <= int(DMSSimPixelConversion::GetSupportedSimdLevel()); ++Level) {
+		TArray<FColor> Copy;
+		Copy.SetNumUninitialized(Frame.Num());
+		Identity.RemapRows(Frame.GetData(), Copy.GetData(), 0, REMAP_HEIGHT, SimdLevel(Level));
+		bool Equal = true;
+		for (int32 i = 0; i < Frame.Num(); ++i) { Equal = Equal && Copy[i] == Frame[i]; }
+		TestTrue(TEXT("Remap Test 2 identity"), Equal);
+	}
+
+	// the scenarios of a camera share the table
+	const auto Table = DMSSimLensRemap::Get(Distorted, REMAP_WIDTH, REMAP_HEIGHT);
+	TestTrue(TEXT("Remap Test 2 table"), Table != nullptr && Table->IsFor(Distorted, REMAP_WIDTH, REMAP_HEIGHT));
+	TestTrue(TEXT("Remap Test 2 shared table"), DMSSimLensRemap::Get(Distorted, REMAP_WIDTH, REMAP_HEIGHT) == Table);
+	TestTrue(TEXT("Remap Test 2 new frame size"), DMSSimLensRemap::Get(Distorted, REMAP_WIDTH, REMAP_HEIGHT - 1) != Table);
+	return true;
+}
+#endif //WITH_DEV_AUTOMATION_TESTS
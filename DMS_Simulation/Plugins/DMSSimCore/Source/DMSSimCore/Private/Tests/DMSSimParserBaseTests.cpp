@@ -0,0 +1,101 @@
+#include "DMSSimParserBase.h"
+#include "DMSSimConfigParser.h"
+#include "DMSSimScenarioParser.h"
+#include "Misc/AutomationTest.h"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace {
+
+struct TestHandlerInfo {
+	const char* const Name;
+	int               Value;
+};
+
+constexpr TestHandlerInfo TestHandlers[] = {
+	{ "version", 0 }, { "rotation", 1 }, { "translation", 2 }, { "scale", 3 }, { "x_offset", 4 }, { "z_offset", 5 }, { "eye_gaze", 6 }, { "eyelids", 7 },
+};
+
+constexpr DMSSimEventHandlerIndex<int(std::size(TestHandlers))> TestHandlerIndex(TestHandlers);
+
+/** Ada.yml with the car speed replaced and the lines appended, parsed from a temporary file; the error message if it fails. */
+std::unique_ptr<DMSSimScenarioParser> ParseScenario(const char* const Speed, const char* const Appended, std::string& Error) {
+	std::ifstream Stream{ std::filesystem::path(DMSSIM_SCENARIO_DIR) / "Ada.yml" };
+	std::stringstream Text;
+	Text << Stream.rdbuf();
+	std::string Scenario = Text.str();
+	const auto SpeedPos = Scenario.find("speed: 60");
+	Scenario.replace(SpeedPos, 9, std::string("speed: ") + Speed);
+	Scenario += Appended;
+
+	const auto Path = std::filesystem::temp_directory_path() / "DMSSimParserBaseTest2.yml";
+	std::ofstream(Path, std::ios::binary) << Scenario;
+	const std::unique_ptr<DMSSimConfigParser> Config(DMSSimConfigParser::Create(DMSSIM_CONFIG_PATH));
+	std::unique_ptr<DMSSimScenarioParser> Parser;
+	try { Parser.reset(DMSSimScenarioParser::Create(Path.wstring().c_str(), *Config)); }
+	catch (const std::runtime_error& Exception) { Error = Exception.what(); }
+	std::filesystem::remove(Path);
+	return Parser;
+}
+
+bool IsParsedSpeed(const char* const Speed, const float Expected) {
+	std::string Error;
+	const auto Parser = ParseScenario(Speed, "", Error);
+	return Parser && std::abs(Parser->GetCarSpeed() - Expected) < 1e-4f;
+}
+
+bool IsInvalidNumber(const char* const Speed) {
+	std::string Error;
+	const auto Parser = ParseScenario(Speed, "", Error);
+	return !Parser && Error.find("Invalid number format of speed") != std::string::npos;
+}
+
+} // anonymous namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimParserBaseTest1, "DMSSim.ParserBase.Tests1", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+bool DMSSimParserBaseTest1::RunTest(const FString& Parameters)
+{
+	// Test 1: the compile time index finds every handler of the table and nothing else
+	bool AllFound = true;
+	for (int i = 0; i < int(std::size(TestHandlers)); ++i) {
+		const std::string Name(TestHandlers[i].Name); // not the pointer of the table
+		AllFound = AllFound && TestHandlerIndex.Find(Name.c_str(), TestHandlers) == i;
+	}
+	TestTrue(TEXT("Parser Test 1 handlers"), AllFound);
+	TestTrue(TEXT("Parser Test 1 unknown"), TestHandlerIndex.Find("mirrored", TestHandlers) == -1);
+	TestTrue(TEXT("Parser Test 1 prefix"), TestHandlerIndex.Find("rotatio", TestHandlers) == -1);
+	TestTrue(TEXT("Parser Test 1 suffix"), TestHandlerIndex.Find("scale_", TestHandlers) == -1);
+	TestTrue(TEXT("Parser Test 1 empty"), TestHandlerIndex.Find("", TestHandlers) == -1);
+	static_assert(DMSSimEventHandlerIndex<1>::GetKey("x_offset") >> 32 == 8, "the key starts with the length");
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimParserBaseTest2, "DMSSim.ParserBase.Tests2", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+bool DMSSimParserBaseTest2::RunTest(const FString& Parameters)
+{
+	// Test 2: the number formats of the stream extraction, and the end of the scenario and the syntax errors found with the line index
+	TestTrue(TEXT("Parser Test 2 integer"), IsParsedSpeed("60", 60.0f));
+	TestTrue(TEXT("Parser Test 2 fraction"), IsParsedSpeed("-12.5", -12.5f));
+	TestTrue(TEXT("Parser Test 2 plus"), IsParsedSpeed("+.5", 0.5f));
+	TestTrue(TEXT("Parser Test 2 exponent"), IsParsedSpeed("1.5e1", 15.0f));
+	TestTrue(TEXT("Parser Test 2 trailing characters"), IsInvalidNumber("60km"));
+	TestTrue(TEXT("Parser Test 2 two signs"), IsInvalidNumber("+-60"));
+	TestTrue(TEXT("Parser Test 2 not a number"), IsInvalidNumber("nan"));
+	TestTrue(TEXT("Parser Test 2 infinity"), IsInvalidNumber("inf"));
+	TestTrue(TEXT("Parser Test 2 out of range"), IsInvalidNumber("1e99"));
+
+	std::string Error;
+	TestTrue(TEXT("Parser Test 2 trailing comments"), ParseScenario("60", "\n# comment\n   \n  # indented comment", Error) != nullptr);
+	TestTrue(TEXT("Parser Test 2 syntax error"), ParseScenario("60: 1", "", Error) == nullptr
+		&& Error.rfind("Line 6: ", 0) == 0 && Error.find("Yaml syntax error after 1...") != std::string::npos);
+	return true;
+}
+#endif //WITH_DEV_AUTOMATION_TESTS
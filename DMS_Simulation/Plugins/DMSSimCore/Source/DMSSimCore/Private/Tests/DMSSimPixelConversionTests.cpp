@@ -0,0 +1,72 @@
+#include "DMSSimPixelConversion.h"
+#include "Misc/AutomationTest.h"
+#include <random>
+#include <vector>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace {
+using DMSSimPixelConversion::SimdLevel;
+
+struct ConvertedFrame {
+	std::vector<uint8_t> Gray8;
+	std::vector<uint8_t> Gray16;
+	std::vector<uint8_t> Y;
+	std::vector<uint8_t> U;
+	std::vector<uint8_t> V;
+};
+
+std::vector<uint8_t> MakeRandomFrame(size_t Width, size_t Height, uint32_t Seed) {
+	std::vector<uint8_t> Pixels(Width * Height * 4);
+	std::mt19937 Random(Seed);
+	for (auto& Value : Pixels) { Value = uint8_t(Random()); }
+	return Pixels;
+}
+
+/** Converts the frame split into row tiles of TileRows rows, like the encoders do. */
+ConvertedFrame Convert(const std::vector<uint8_t>& Src, size_t Width, size_t Height, size_t TileRows, SimdLevel Level) {
+	const size_t ChromaWidth = (Width + 1) / 2;
+	const size_t ChromaHeight = (Height + 1) / 2;
+	ConvertedFrame Frame;
+	Frame.Gray8.resize(Width * Height);
+	Frame.Gray16.resize(Width * Height * 2);
+	Frame.Y.resize(Width * Height);
+	Frame.U.resize(ChromaWidth * ChromaHeight);
+	Frame.V.resize(ChromaWidth * ChromaHeight);
+	for (size_t RowBegin = 0; RowBegin < Height; RowBegin += TileRows) {
+		const size_t RowEnd = FMath::Min(RowBegin + TileRows, Height);
+		DMSSimPixelConversion::BGRAToGray8(Src.data(), Width * 4, Frame.Gray8.data(), Width, Width, RowBegin, RowEnd, Level);
+		DMSSimPixelConversion::BGRAToGray16LE(Src.data(), Width * 4, Frame.Gray16.data(), Width * 2, Width, RowBegin, RowEnd, Level);
+		DMSSimPixelConversion::BGRAToYUV420P(Src.data(), Width * 4, Frame.Y.data(), Width, Frame.U.data(), ChromaWidth, Frame.V.data(), ChromaWidth,
+			Width, Height, RowBegin, RowEnd, Level);
+	}
+	return Frame;
+}
+
+} // anonymous namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimPixelConversionTest1, "DMSSim.PixelConversion.Tests1", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool DMSSimPixelConversionTest1::RunTest(const FString& Parameters)
+{
+	// SIMD kernels must be bit-exact with the scalar implementation, including the tails of rows and odd sizes
+	const SimdLevel Supported = DMSSimPixelConversion::GetSupportedSimdLevel();
+	const size_t Sizes[][2] = { { 1, 1 }, { 17, 3 }, { 33, 5 }, { 101, 9 }, { 2400, 66 } };
+	for (const auto& Size : Sizes) {
+		const auto Src = MakeRandomFrame(Size[0], Size[1], uint32_t(Size[0] * Size[1]));
+		const auto Reference = Convert(Src, Size[0], Size[1], Size[1], SimdLevel::Scalar);
+		for (const auto Level : { SimdLevel::SSE41, SimdLevel::AVX2 }) {
+			if (Level > Supported) { continue; }
+			const auto Frame = Convert(Src, Size[0], Size[1], 4, Level);
+			const FString Caption = FString(DMSSimPixelConversion::GetSimdLevelName(Level)) + TEXT(" ") + FString::FromInt(int32(Size[0])) + TEXT("x") + FString::FromInt(int32(Size[1]));
+			TestTrue(Caption + TEXT(" GRAY8"), Frame.Gray8 == Reference.Gray8);
+			TestTrue(Caption + TEXT(" GRAY16LE"), Frame.Gray16 == Reference.Gray16);
+			TestTrue(Caption + TEXT(" Y"), Frame.Y == Reference.Y);
+			TestTrue(Caption + TEXT(" U"), Frame.U == Reference.U);
+			TestTrue(Caption + TEXT(" V"), Frame.V == Reference.V);
+		}
+	}
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,165 @@
+#include "DMSSimRecordingSink.h"
+#include "DMSSimVideoRecordingRunable.h"
+#include "Misc/AutomationTest.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace {
+
+constexpr int SINK_FRAMES = 5;
+constexpr size_t SINK_FRAME_SIZE = 8;
+constexpr int SINK_DONE_TIMEOUT_MS = 10000;
+
+/** Parses the scenario file with the lines appended, returns nullptr if it's invalid. */
+std::unique_ptr<DMSSimScenarioParser> ParseScenario(const std::filesystem::path& Directory, const char* const AppendedLines) {
+	const auto FilePath = Directory / "Scenario.yml";
+	std::filesystem::copy_file(std::filesystem::path(DMSSIM_SCENARIO_DIR) / "Ada.yml", FilePath, std::filesystem::copy_options::overwrite_existing);
+	{
+		std::ofstream File(FilePath, std::ios_base::app);
+		File << "\n" << AppendedLines;
+	}
+	std::unique_ptr<DMSSimConfigParser> Config(DMSSimConfigParser::Create(DMSSIM_CONFIG_PATH));
+	if (!Config) { return nullptr; }
+	return std::unique_ptr<DMSSimScenarioParser>(DMSSimScenarioParser::Create(FilePath.wstring().c_str(), *Config));
+}
+
+TSharedPtr<DMSSimGroundTruthFrame> MakeSinkFrame(const DMSSimGroundTruthScenarioConstantsPtr& Scenario) {
+	auto Frame = MakeShared<DMSSimGroundTruthFrame, ESPMode::ThreadSafe>();
+	Frame->Scenario = Scenario;
+	return Frame;
+}
+
+class CountingSink : public DMSSimRecordingSink
+{
+public:
+	explicit CountingSink(int& Frames) : Frames_(Frames) {}
+	void AddFrame(const TArray<FColor>&, const TSharedPtr<DMSSimGroundTruthFrame>&, const TSharedPtr<DMSSimGroundTruthFrame>&, int) override { ++Frames_; }
+
+private:
+	int& Frames_;
+};
+
+/** Waits for the recording thread of the runnable to exit, false on timeout. */
+bool WaitUntilDone(const DMSSimVideoRecordingRunable& Recorder) {
+	for (int i = 0; i < SINK_DONE_TIMEOUT_MS && !Recorder.IsDone(); ++i) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+	return Recorder.IsDone();
+}
+
+} // anonymous namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimRecordingSinkTest1, "DMSSim.RecordingSink.Tests1", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool DMSSimRecordingSinkTest1::RunTest(const FString& Parameters)
+{
+	// without a sinks list the camera selects the outputs, with a list only the listed sinks are selected
+	const auto Directory = std::filesystem::temp_directory_path() / "DMSSimRecordingSinkTest1";
+	std::filesystem::remove_all(Directory);
+	std::filesystem::create_directories(Directory);
+	const auto Default = ParseScenario(Directory, "");
+	const auto Listed = ParseScenario(Directory, "ground_truth_settings:\n  sinks: [openlabel, csv]\n");
+	std::filesystem::remove_all(Directory);
+
+	const std::vector<std::string> DefaultSinks = { DMSSIM_SINK_IMAGES, DMSSIM_SINK_OPENLABEL, DMSSIM_SINK_OPENLABEL_OLD };
+	const std::vector<std::string> ListedSinks = { DMSSIM_SINK_OPENLABEL, DMSSIM_SINK_CSV };
+	TestTrue(TEXT("Sink Test 1 default sinks"), Default && DMSSimRecordingSinkRegistry::GetSelectedSinks(*Default) == DefaultSinks);
+	TestTrue(TEXT("Sink Test 1 listed sinks"), Listed && DMSSimRecordingSinkRegistry::GetSelectedSinks(*Listed) == ListedSinks);
+	TestTrue(TEXT("Sink Test 1 csv selected"), Listed && DMSSimRecordingSinkRegistry::IsSelected(DMSSimRecordingSinkRegistry::GetSelectedSinks(*Listed), DMSSIM_SINK_CSV));
+	TestFalse(TEXT("Sink Test 1 legacy labels not selected"), Listed && DMSSimRecordingSinkRegistry::IsSelected(DMSSimRecordingSinkRegistry::GetSelectedSinks(*Listed), DMSSIM_SINK_OPENLABEL_OLD));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimRecordingSinkTest2, "DMSSim.RecordingSink.Tests2", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool DMSSimRecordingSinkTest2::RunTest(const FString& Parameters)
+{
+	// only the selected sinks are created, a registered sink gets the frames without changes to the recorder
+	const auto Directory = std::filesystem::temp_directory_path() / "DMSSimRecordingSinkTest2";
+	std::filesystem::remove_all(Directory);
+	std::filesystem::create_directories(Directory);
+	const std::wstring BaseFileName = (Directory / "labels").wstring();
+
+	int CountedFrames = 0;
+	auto& Registry = DMSSimRecordingSinkRegistry::Get();
+	Registry.Register("test_counter", [&CountedFrames](const DMSSimRecordingSinkSettings&) -> TUniquePtr<DMSSimRecordingSink> { return MakeUnique<CountingSink>(CountedFrames); });
+
+	DMSSimRecordingSinkSettings Settings{ BaseFileName };
+	auto Sinks = Registry.CreateSinks({ DMSSIM_SINK_OPENLABEL, DMSSIM_SINK_CSV, "test_unknown", "test_counter" }, Settings);
+	const size_t SinkCount = Sinks.size();
+
+	const DMSSimGroundTruthScenarioConstantsPtr Scenario = MakeShared<DMSSimGroundTruthScenarioConstants, ESPMode::ThreadSafe>();
+	const TArray<FColor> Image;
+	for (int i = 0; i < SINK_FRAMES; ++i) {
+		for (auto& Sink : Sinks) { Sink->AddFrame(Image, MakeSinkFrame(Scenario), MakeSinkFrame(Scenario), i); }
+	}
+	for (auto& Sink : Sinks) { Sink->Finalize(); }
+	Sinks.clear();
+	Registry.Unregister("test_counter");
+
+	int LabelFiles = 0;
+	int OldLabelFiles = 0;
+	for (const auto& Entry : std::filesystem::directory_iterator(Directory)) {
+		++(Entry.path().stem().string().find("_old") != std::string::npos ? OldLabelFiles : LabelFiles);
+	}
+	std::filesystem::remove_all(Directory);
+
+	TestEqual(TEXT("Sink Test 2 created sinks"), int32(SinkCount), 2);
+	TestEqual(TEXT("Sink Test 2 counted frames"), CountedFrames, SINK_FRAMES);
+	TestEqual(TEXT("Sink Test 2 label files"), LabelFiles, SINK_FRAMES);
+	TestEqual(TEXT("Sink Test 2 no legacy label files"), OldLabelFiles, 0);
+	return true;
+}
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimRecordingSinkTest3, "DMSSim.RecordingSink.Tests3", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool DMSSimRecordingSinkTest3::RunTest(const FString& Parameters)
+{
+	// the csv is written by the renderer, a recorder without sink objects must be done at once, or the renderer never exits
+	const auto Directory = std::filesystem::temp_directory_path() / "DMSSimRecordingSinkTest3";
+	std::filesystem::remove_all(Directory);
+	std::filesystem::create_directories(Directory);
+	auto CsvOnly = ParseScenario(Directory, "ground_truth_settings:\n  sinks: [csv]\n");
+	auto Counted = ParseScenario(Directory, "ground_truth_settings:\n  sinks: [test_counter]\n");
+	if (!CsvOnly || !Counted) {
+		std::filesystem::remove_all(Directory);
+		AddError(TEXT("Sink Test 3 scenarios not parsed"));
+		return false;
+	}
+
+	int CountedFrames = 0;
+	auto& Registry = DMSSimRecordingSinkRegistry::Get();
+	Registry.Register("test_counter", [&CountedFrames](const DMSSimRecordingSinkSettings&) -> TUniquePtr<DMSSimRecordingSink> { return MakeUnique<CountingSink>(CountedFrames); });
+	const DMSSimGroundTruthScenarioConstantsPtr Scenario = MakeShared<DMSSimGroundTruthScenarioConstants, ESPMode::ThreadSafe>();
+
+	DMSSimConfig::SetCurrentScenarioParser(MakeShareable(CsvOnly.release()));
+	{
+		DMSSimVideoRecordingRunable Recorder((Directory / "csv").wstring(), SINK_FRAME_SIZE, SINK_FRAME_SIZE, SINK_FRAME_SIZE, SINK_FRAME_SIZE, 30, false, false);
+		TestTrue(TEXT("Sink Test 3 csv only recorder done"), Recorder.IsDone());
+		Recorder.AddFrame(MakeShareable(new TArray<FColor>), MakeSinkFrame(Scenario));
+		TestEqual(TEXT("Sink Test 3 csv only pending frames"), Recorder.GetNumPendingFrames(), 0);
+	}
+
+	DMSSimConfig::SetCurrentScenarioParser(MakeShareable(Counted.release()));
+	{
+		DMSSimVideoRecordingRunable Recorder((Directory / "counted").wstring(), SINK_FRAME_SIZE, SINK_FRAME_SIZE, SINK_FRAME_SIZE, SINK_FRAME_SIZE, 30, false, false);
+		TestFalse(TEXT("Sink Test 3 recorder running"), Recorder.IsDone());
+		for (int i = 0; i < SINK_FRAMES; ++i) {
+			const ImagePtr Frame = MakeShareable(new TArray<FColor>);
+			Frame->SetNumZeroed(int32(SINK_FRAME_SIZE * SINK_FRAME_SIZE));
+			Recorder.AddFrame(Frame, MakeSinkFrame(Scenario));
+		}
+		Recorder.Stop();
+		TestTrue(TEXT("Sink Test 3 recorder done after stop"), WaitUntilDone(Recorder));
+	}
+	DMSSimConfig::SetCurrentScenarioParser(nullptr);
+	Registry.Unregister("test_counter");
+	std::filesystem::remove_all(Directory);
+
+	// the first two frames only fill the occlusion look-ahead
+	TestEqual(TEXT("Sink Test 3 counted frames"), CountedFrames, SINK_FRAMES - 2);
+	return true;
+}
+#endif //WITH_DEV_AUTOMATION_TESTS
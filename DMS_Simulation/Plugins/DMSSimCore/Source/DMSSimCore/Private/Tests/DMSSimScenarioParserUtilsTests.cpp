@@ -0,0 +1,372 @@
+#include "DMSSimScenarioParserUtils.h"
+#include "Misc/AutomationTest.h"
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace {
+
+const char* const TEST_SCENARIOS[] = { "Ada.yml", "Gavin.yml", "Hana.yml", "Keiji.yml", "Maria.yml" };
+
+/** A directory with the test scenarios and the config, which isn't loaded as a scenario. */
+std::filesystem::path MakeScenarioDirectory(const char* const Name) {
+	const auto Directory = std::filesystem::temp_directory_path() / Name;
+	std::filesystem::remove_all(Directory);
+	std::filesystem::create_directories(Directory);
+	for (const auto* const Scenario : TEST_SCENARIOS) { std::filesystem::copy_file(std::filesystem::path(DMSSIM_SCENARIO_DIR) / Scenario, Directory / Scenario); }
+	std::filesystem::copy_file(DMSSIM_CONFIG_PATH, Directory / "config.yml");
+	return Directory;
+}
+
+/** The scenario parsed on its own, to compare the parsers of the directory with. */
+bool IsSameScenario(const DMSSimScenarioParser* const Parser, const char* const Name) {
+	const std::unique_ptr<DMSSimConfigParser> Config(DMSSimConfigParser::Create(DMSSIM_CONFIG_PATH));
+	const std::unique_ptr<DMSSimScenarioParser> Expected(DMSSimScenarioParser::Create((std::filesystem::path(DMSSIM_SCENARIO_DIR) / Name).wstring().c_str(), *Config));
+	if (!Parser || !Expected || Parser->GetOccupantCount() != Expected->GetOccupantCount() || Parser->GetOccupantCount() == 0) { return false; }
+	return Parser->GetCarSpeed() == Expected->GetCarSpeed()
+		&& Parser->GetAnimationSequenceCount() == Expected->GetAnimationSequenceCount()
+		&& strcmp(Parser->GetEnvironment(), Expected->GetEnvironment()) == 0
+		&& strcmp(Parser->GetOccupant(0).GetCharacter(), Expected->GetOccupant(0).GetCharacter()) == 0;
+}
+
+bool IsSame(const char* const A, const char* const B) { return (A == nullptr || B == nullptr) ? A == B : strcmp(A, B) == 0; }
+bool IsSame(const FVector& A, const FVector& B) { return A.X == B.X && A.Y == B.Y && A.Z == B.Z; }
+bool IsSame(const FRotator& A, const FRotator& B) { return A.Pitch == B.Pitch && A.Yaw == B.Yaw && A.Roll == B.Roll; }
+
+bool IsSame(const DMSSimMotion& A, const DMSSimMotion& B) {
+	bool Same = A.GetType() == B.GetType() && IsSame(A.GetAnimationName(), B.GetAnimationName()) && A.GetPointCount() == B.GetPointCount()
+		&& A.GetStartPos() == B.GetStartPos() && A.GetEndPos() == B.GetEndPos() && A.GetDuration() == B.GetDuration() && A.GetBlendOut() == B.GetBlendOut();
+	for (size_t i = 0; Same && i < A.GetPointCount(); ++i) {
+		Same = A.GetPoint(i).GetTime() == B.GetPoint(i).GetTime() && IsSame(A.GetPoint(i).GetPoint(), B.GetPoint(i).GetPoint());
+	}
+	return Same;
+}
+
+template <class T>
+bool IsSameMotions(const T& A, const T& B) {
+	bool Same = A.GetMotionCount() == B.GetMotionCount();
+	for (size_t i = 0; Same && i < A.GetMotionCount(); ++i) { Same = IsSame(A.GetMotion(i), B.GetMotion(i)); }
+	return Same;
+}
+
+bool IsSame(const DMSSimCamera& A, const DMSSimCamera& B) {
+	bool Same = A.GetNIR() == B.GetNIR() && A.GetVideoOut() == B.GetVideoOut() && A.GetCsvOut() == B.GetCsvOut() && A.GetDepth16Bit() == B.GetDepth16Bit()
+		&& A.GetFrameWidth() == B.GetFrameWidth() && A.GetFrameHeight() == B.GetFrameHeight() && A.GetFrameRate() == B.GetFrameRate()
+		&& IsSame(A.GetPosition(), B.GetPosition()) && IsSame(A.GetRotation(), B.GetRotation()) && A.GetMirrored() == B.GetMirrored() && A.GetFOV() == B.GetFOV()
+		&& A.GetDistortionCount() == B.GetDistortionCount() && A.GetNoise() == B.GetNoise() && A.GetBlur() == B.GetBlur()
+		&& A.GetFocalDistance() == B.GetFocalDistance() && A.GetDiaphragmBladeCount() == B.GetDiaphragmBladeCount() && A.GetMinFStop() == B.GetMinFStop() && A.GetMaxFStop() == B.GetMaxFStop()
+		&& A.GetGrainIntensity() == B.GetGrainIntensity() && A.GetGrainJitter() == B.GetGrainJitter() && A.GetSaturation() == B.GetSaturation() && A.GetGamma() == B.GetGamma()
+		&& A.GetContrast() == B.GetContrast() && A.GetBloomIntensity() == B.GetBloomIntensity() && A.GetFocusOffset() == B.GetFocusOffset()
+		&& A.GetEncoderThreadCount() == B.GetEncoderThreadCount() && IsSame(A.GetEncoderThreadType(), B.GetEncoderThreadType()) && IsSame(A.GetEncoderPreset(), B.GetEncoderPreset())
+		&& IsSame(A.GetEncoderTune(), B.GetEncoderTune()) && A.GetEncoderLookahead() == B.GetEncoderLookahead() && IsSame(A.GetImageFormat(), B.GetImageFormat())
+		&& A.GetPngCompression() == B.GetPngCompression() && A.GetImageThreadCount() == B.GetImageThreadCount() && IsSame(A.GetGroundTruthFormat(), B.GetGroundTruthFormat()) && IsSame(A.GetLabelMode(), B.GetLabelMode())
+		&& A.GetLabelThreadCount() == B.GetLabelThreadCount() && A.GetLabelDeltaEpsilon() == B.GetLabelDeltaEpsilon();
+	for (size_t i = 0; Same && i < A.GetDistortionCount(); ++i) { Same = A.GetDistortion(i) == B.GetDistortion(i); }
+	return Same;
+}
+
+bool IsSame(const DMSSimOccupant& A, const DMSSimOccupant& B) {
+	return A.GetType() == B.GetType() && IsSame(A.GetCharacter(), B.GetCharacter()) && IsSame(A.GetHeadgear(), B.GetHeadgear()) && IsSame(A.GetGlasses(), B.GetGlasses())
+		&& IsSame(A.GetUpperCloth(), B.GetUpperCloth()) && IsSame(A.GetGlassesColor(), B.GetGlassesColor()) && A.GetGlassesOpacity() == B.GetGlassesOpacity()
+		&& A.GetGlassesReflective() == B.GetGlassesReflective() && IsSame(A.GetMask(), B.GetMask()) && IsSame(A.GetScarf(), B.GetScarf()) && IsSame(A.GetHair(), B.GetHair())
+		&& IsSame(A.GetBeard(), B.GetBeard()) && IsSame(A.GetMustache(), B.GetMustache()) && A.GetPupilSize() == B.GetPupilSize() && A.GetPupilBrightness() == B.GetPupilBrightness()
+		&& A.GetIrisSize() == B.GetIrisSize() && A.GetIrisBrightness() == B.GetIrisBrightness() && A.GetIrisBorderWidth() == B.GetIrisBorderWidth()
+		&& A.GetLimbusDarkAmount() == B.GetLimbusDarkAmount() && IsSame(A.GetIrisColor(), B.GetIrisColor()) && A.GetScleraBrightness() == B.GetScleraBrightness()
+		&& A.GetScleraVeins() == B.GetScleraVeins() && A.GetSkinWrinkles() == B.GetSkinWrinkles() && A.GetSkinRoughness() == B.GetSkinRoughness()
+		&& A.GetSkinSpecularity() == B.GetSkinSpecularity() && A.GetHeight() == B.GetHeight() && IsSame(A.GetSeatOffset(), B.GetSeatOffset());
+}
+
+/** Every getter of the two scenarios returns the same value. */
+bool IsSame(const DMSSimScenarioParser& A, const DMSSimScenarioParser& B) {
+	const auto& IlluminationA = A.GetCameraIllumination();
+	const auto& IlluminationB = B.GetCameraIllumination();
+	const auto& SettingsA = A.GetGroundTruthSettings();
+	const auto& SettingsB = B.GetGroundTruthSettings();
+	bool Same = A.GetVersionMajor() == B.GetVersionMajor() && A.GetVersionMinor() == B.GetVersionMinor() && IsSame(A.GetDescription(), B.GetDescription())
+		&& IsSame(A.GetEnvironment(), B.GetEnvironment()) && A.GetRandomBlinking() == B.GetRandomBlinking() && A.GetRandomSmiling() == B.GetRandomSmiling()
+		&& A.GetRandomHeadMovements() == B.GetRandomHeadMovements() && A.GetRandomBodyMovements() == B.GetRandomBodyMovements() && A.GetRandomGaze() == B.GetRandomGaze()
+		&& IsSame(A.GetCarModel(), B.GetCarModel()) && A.GetCarSpeed() == B.GetCarSpeed() && IsSame(A.GetSunRotation(), B.GetSunRotation())
+		&& A.GetSunIntensity() == B.GetSunIntensity() && A.GetSunTemperature() == B.GetSunTemperature()
+		&& IsSame(A.GetCoordinateSpace().GetCarModel(), B.GetCoordinateSpace().GetCarModel()) && IsSame(A.GetCoordinateSpace().GetRotation(), B.GetCoordinateSpace().GetRotation())
+		&& IsSame(A.GetCoordinateSpace().GetTranslation(), B.GetCoordinateSpace().GetTranslation()) && IsSame(A.GetCoordinateSpace().GetScale(), B.GetCoordinateSpace().GetScale())
+		&& IsSame(A.GetCamera(), B.GetCamera())
+		&& A.GetSteeringWheelColumn().GetPitchAngle() == B.GetSteeringWheelColumn().GetPitchAngle()
+		&& A.GetSteeringWheelColumn().GetIsCameraIntegrated() == B.GetSteeringWheelColumn().GetIsCameraIntegrated()
+		&& SettingsA.GetBoundingBoxPaddingFactorFace() == SettingsB.GetBoundingBoxPaddingFactorFace() && SettingsA.GetEyeBoundingBoxWidthFactor() == SettingsB.GetEyeBoundingBoxWidthFactor()
+		&& SettingsA.GetEyeBoundingBoxHeightFactor() == SettingsB.GetEyeBoundingBoxHeightFactor() && SettingsA.GetEyeBoundingBoxDepth() == SettingsB.GetEyeBoundingBoxDepth()
+		&& SettingsA.GetSinkCount() == SettingsB.GetSinkCount()
+		&& IlluminationA.GetIntensity() == IlluminationB.GetIntensity() && IlluminationA.GetAttenuationRadius() == IlluminationB.GetAttenuationRadius()
+		&& IlluminationA.GetSourceRadius() == IlluminationB.GetSourceRadius() && IlluminationA.InnerConeAngle() == IlluminationB.InnerConeAngle()
+		&& IlluminationA.OuterConeAngle() == IlluminationB.OuterConeAngle() && IsSame(IlluminationA.GetPosition(), IlluminationB.GetPosition())
+		&& IsSame(IlluminationA.GetRotation(), IlluminationB.GetRotation())
+		&& A.GetOccupantCount() == B.GetOccupantCount() && A.GetAnimationSequenceCount() == B.GetAnimationSequenceCount()
+		&& A.GetOccupantScenarioCount() == B.GetOccupantScenarioCount();
+	for (size_t i = 0; Same && i < SettingsA.GetSinkCount(); ++i) { Same = IsSame(SettingsA.GetSink(i), SettingsB.GetSink(i)); }
+	for (int i = 0; Same && i < DMSSimAnimationChannelCount; ++i) {
+		Same = A.GetDefaultBlendOut(DMSSimAnimationChannelType(i)) == B.GetDefaultBlendOut(DMSSimAnimationChannelType(i));
+	}
+	for (size_t i = 0; Same && i < A.GetOccupantCount(); ++i) { Same = IsSame(A.GetOccupant(i), B.GetOccupant(i)); }
+	for (size_t i = 0; Same && i < A.GetAnimationSequenceCount(); ++i) {
+		const auto& SequenceA = A.GetAnimationSequence(i);
+		const auto& SequenceB = B.GetAnimationSequence(i);
+		Same = IsSame(SequenceA.GetName(), SequenceB.GetName()) && SequenceA.GetType() == SequenceB.GetType() && IsSameMotions(SequenceA, SequenceB);
+	}
+	for (size_t i = 0; Same && i < A.GetOccupantScenarioCount(); ++i) {
+		const auto& ScenarioA = A.GetOccupantScenario(i);
+		const auto& ScenarioB = B.GetOccupantScenario(i);
+		Same = ScenarioA.GetType() == ScenarioB.GetType() && IsSameMotions(ScenarioA, ScenarioB) && ScenarioA.GetChannelCount() == ScenarioB.GetChannelCount();
+		for (size_t j = 0; Same && j < ScenarioA.GetChannelCount(); ++j) {
+			Same = ScenarioA.GetChannel(j).GetType() == ScenarioB.GetChannel(j).GetType() && IsSameMotions(ScenarioA.GetChannel(j), ScenarioB.GetChannel(j));
+		}
+	}
+	return Same;
+}
+
+size_t GetFileCount(const std::filesystem::path& Directory) {
+	return size_t(std::distance(std::filesystem::directory_iterator(Directory), std::filesystem::directory_iterator()));
+}
+
+bool ThrowsRuntimeError(const std::function<void()>& Function) {
+	try { Function(); }
+	catch (const std::runtime_error&) { return true; }
+	return false;
+}
+
+std::string ReplaceAll(std::string Text, const std::string& From, const std::string& To) {
+	for (size_t Position = Text.find(From); Position != std::string::npos; Position = Text.find(From, Position + To.size())) { Text.replace(Position, From.size(), To); }
+	return Text;
+}
+
+/** The test scenario Ada.yml with a sweep section before its occupants, so the blocks after the sweep section are parsed too. */
+std::string MakeSweepScenario(const std::string& Sweep) {
+	std::ifstream File(std::filesystem::path(DMSSIM_SCENARIO_DIR) / "Ada.yml");
+	const std::string Scenario((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+	return ReplaceAll(Scenario, "\noccupants:", "\nsweep:\n" + Sweep + "\noccupants:");
+}
+
+} // anonymous namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimScenarioParserUtilsTest1, "DMSSim.ScenarioParserUtils.Tests1", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+bool DMSSimScenarioParserUtilsTest1::RunTest(const FString& Parameters)
+{
+	// Test 1: the parallel parse of a directory and the indexed directory give the scenarios in the order of the file names
+	const auto Directory = MakeScenarioDirectory("DMSSimScenarioParserUtilsTest1");
+	const FString DirectoryPath(Directory.wstring().c_str());
+
+	const auto Parsers = CreateScenarioParsers(DirectoryPath);
+	bool Same = Parsers.size() == std::size(TEST_SCENARIOS);
+	for (size_t i = 0; Same && i < Parsers.size(); ++i) { Same = IsSameScenario(Parsers[i].Get(), TEST_SCENARIOS[i]); }
+	TestTrue(TEXT("Scenario Utils Test 1 parallel parse"), Same);
+
+	auto Entries = IndexScenarioParsers(DirectoryPath);
+	bool Indexed = Entries.size() == std::size(TEST_SCENARIOS);
+	for (const auto& Entry : Entries) { Indexed = Indexed && !Entry.IsParsed(); }
+	TestTrue(TEXT("Scenario Utils Test 1 index"), Indexed);
+	Same = Entries.size() == std::size(TEST_SCENARIOS);
+	for (size_t i = 0; Same && i < Entries.size(); ++i) {
+		const auto Parser = Entries[i].Get();
+		Same = Entries[i].IsParsed() && Entries[i].Get() == Parser && IsSameScenario(Parser.Get(), TEST_SCENARIOS[i]);
+	}
+	TestTrue(TEXT("Scenario Utils Test 1 lazy parse"), Same);
+	std::filesystem::remove_all(Directory);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimScenarioParserUtilsTest2, "DMSSim.ScenarioParserUtils.Tests2", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+bool DMSSimScenarioParserUtilsTest2::RunTest(const FString& Parameters)
+{
+	// Test 2: the headers are validated when the directory is indexed, the rest of the scenario when it's parsed
+	const auto Directory = MakeScenarioDirectory("DMSSimScenarioParserUtilsTest2");
+	const FString DirectoryPath(Directory.wstring().c_str());
+	const auto WriteFile = [&Directory](const char* const Name, const char* const Text) { std::ofstream(Directory / Name, std::ios::binary) << Text; };
+
+	WriteFile("Header.yml", "# comment\n---\nversion: 1.0 # scenario version\n");
+	TestTrue(TEXT("Scenario Utils Test 2 header"), IsScenarioHeaderValid(FString((Directory / "Header.yml").wstring().c_str())));
+	WriteFile("Header.yml", "description: \"\"\nversion: 1.0\n");
+	TestFalse(TEXT("Scenario Utils Test 2 no header"), IsScenarioHeaderValid(FString((Directory / "Header.yml").wstring().c_str())));
+	TestTrue(TEXT("Scenario Utils Test 2 invalid header"), ThrowsRuntimeError([&]() { IndexScenarioParsers(DirectoryPath); }));
+	std::filesystem::remove(Directory / "Header.yml");
+
+	WriteFile("Zulu.yml", "version: 1.0\nunknown_property: 1\n");
+	auto Entries = IndexScenarioParsers(DirectoryPath);
+	TestTrue(TEXT("Scenario Utils Test 2 indexed"), Entries.size() == std::size(TEST_SCENARIOS) + 1);
+	TestTrue(TEXT("Scenario Utils Test 2 lazy error"), ThrowsRuntimeError([&]() { Entries.back().Get(); }));
+	TestTrue(TEXT("Scenario Utils Test 2 other scenarios"), Entries.front().Get().IsValid());
+	TestTrue(TEXT("Scenario Utils Test 2 parallel error"), ThrowsRuntimeError([&]() { CreateScenarioParsers(DirectoryPath); }));
+	std::filesystem::remove_all(Directory);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimScenarioParserUtilsTest3, "DMSSim.ScenarioParserUtils.Tests3", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+bool DMSSimScenarioParserUtilsTest3::RunTest(const FString& Parameters)
+{
+	// Test 3: the compiled scenarios of the cache give the scenarios of the yaml parsing, a changed or an invalid compiled scenario is parsed again
+	const auto Directory = MakeScenarioDirectory("DMSSimScenarioParserUtilsTest3");
+	for (const auto& Entry : std::filesystem::directory_iterator(DMSSIM_SCENARIO_DIR)) {
+		std::filesystem::copy_file(Entry.path(), Directory / Entry.path().filename(), std::filesystem::copy_options::skip_existing);
+	}
+	const auto CacheDirectory = std::filesystem::temp_directory_path() / "DMSSimScenarioParserUtilsTest3Cache";
+	std::filesystem::remove_all(CacheDirectory);
+	const FString CachePath(CacheDirectory.wstring().c_str());
+
+	std::vector<std::filesystem::path> Files;
+	for (const auto& Entry : std::filesystem::directory_iterator(Directory)) { if (Entry.path().filename() != "config.yml") { Files.push_back(Entry.path()); } }
+	bool Same = Files.size() > std::size(TEST_SCENARIOS);
+	for (const auto& File : Files) {
+		const FString FilePath(File.wstring().c_str());
+		const auto Parsed = CreateScenarioParser(FilePath, FString());
+		const auto Compiled = CreateScenarioParser(FilePath, CachePath);
+		const auto Loaded = CreateScenarioParser(FilePath, CachePath);
+		Same = Same && Parsed.IsValid() && Compiled.IsValid() && Loaded.IsValid() && IsSame(*Parsed, *Compiled) && IsSame(*Parsed, *Loaded);
+	}
+	TestTrue(TEXT("Scenario Utils Test 3 equal scenarios"), Same);
+	TestTrue(TEXT("Scenario Utils Test 3 compiled scenarios"), GetFileCount(CacheDirectory) == Files.size());
+
+	const auto Parser = CreateScenarioParser(FString(Files[0].wstring().c_str()), FString());
+	const auto Compiled = Parser->Compile();
+	const std::unique_ptr<DMSSimScenarioParser> Loaded(DMSSimScenarioParser::Load(Compiled.data(), Compiled.size()));
+	TestTrue(TEXT("Scenario Utils Test 3 load"), Loaded && IsSame(*Parser, *Loaded) && Loaded->Compile() == Compiled);
+	TestTrue(TEXT("Scenario Utils Test 3 truncated"), DMSSimScenarioParser::Load(Compiled.data(), Compiled.size() - 1) == nullptr);
+	TestTrue(TEXT("Scenario Utils Test 3 trailing bytes"), DMSSimScenarioParser::Load((Compiled + '\0').data(), Compiled.size() + 1) == nullptr);
+	TestTrue(TEXT("Scenario Utils Test 3 not compiled"), DMSSimScenarioParser::Load("version: 1.0\n", 13) == nullptr);
+
+	// a truncated cache file is replaced
+	for (const auto& Entry : std::filesystem::directory_iterator(CacheDirectory)) {
+		if (std::filesystem::file_size(Entry.path()) == Compiled.size()) { std::filesystem::resize_file(Entry.path(), Compiled.size() / 2); }
+	}
+	const auto Reparsed = CreateScenarioParser(FString(Files[0].wstring().c_str()), CachePath);
+	TestTrue(TEXT("Scenario Utils Test 3 invalid cache"), Reparsed.IsValid() && IsSame(*Parser, *Reparsed));
+	const auto Repaired = CreateScenarioParser(FString(Files[0].wstring().c_str()), CachePath);
+	TestTrue(TEXT("Scenario Utils Test 3 repaired cache"), Repaired.IsValid() && IsSame(*Parser, *Repaired) && GetFileCount(CacheDirectory) == Files.size());
+
+	std::ofstream(Files[0], std::ios::app) << "# changed\n";
+	CreateScenarioParser(FString(Files[0].wstring().c_str()), CachePath);
+	TestTrue(TEXT("Scenario Utils Test 3 changed scenario"), GetFileCount(CacheDirectory) == Files.size() + 1);
+	std::filesystem::remove_all(CacheDirectory);
+	std::filesystem::remove_all(Directory);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimScenarioParserUtilsTest4, "DMSSim.ScenarioParserUtils.Tests4", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+bool DMSSimScenarioParserUtilsTest4::RunTest(const FString& Parameters)
+{
+	// Test 4: a sweep section expands into the scenarios of all combinations of its values, each equal to the scenario with the values written in
+	const std::unique_ptr<DMSSimConfigParser> Config(DMSSimConfigParser::Create(DMSSIM_CONFIG_PATH));
+	const std::string Sweep =
+		"  sun_intensity: [100.0, 200.0]\n"
+		"  sun_temperature: { from: 4000, to: 6000, step: 1000 }\n"
+		"  camera:\n"
+		"    - location: [2.0, -0.3, 1.0]\n"
+		"    - rotation: [0.0, -0.3, 0.1]\n"
+		"  glasses: [none, glasses_1]\n";
+	const auto Scenario = MakeSweepScenario(Sweep);
+	std::unique_ptr<DMSSimScenarioParser> Parser(DMSSimScenarioParser::Create(Scenario, *Config));
+	TestTrue(TEXT("Scenario Utils Test 4 sweep size"), Parser && Parser->GetSweepSize() == 24);
+	const auto Compiled = Parser->Compile();
+	const auto Views = DMSSimScenarioParser::ExpandSweep(Parser.release());
+	std::vector<std::unique_ptr<DMSSimScenarioParser>> Scenarios(Views.begin(), Views.end());
+	TestTrue(TEXT("Scenario Utils Test 4 expanded"), Scenarios.size() == 24);
+
+	const char* const Intensities[] = { "100.0", "200.0" };
+	const char* const Temperatures[] = { "4000", "5000", "6000" };
+	const char* const Glasses[] = { "none", "glasses_1" };
+	std::ifstream File(std::filesystem::path(DMSSIM_SCENARIO_DIR) / "Ada.yml");
+	const std::string Ada((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+	bool Same = Scenarios.size() == 24;
+	for (size_t i = 0; Same && i < Scenarios.size(); ++i) {
+		// the last parameter changes fastest, the missing part of a camera pose and the illumination come from the camera block
+		auto Expected = ReplaceAll(Ada, "sun_intensity: 175.0", std::string("sun_intensity: ") + Intensities[i / 12]);
+		Expected = ReplaceAll(Expected, "sun_temperature: 5500.0", std::string("sun_temperature: ") + Temperatures[i / 4 % 3]);
+		Expected = ReplaceAll(Expected, i / 2 % 2 == 0 ? "location: [2.423, -0.36104, 1.183]" : "rotation: [0.0, -0.46249, 0.0]",
+			i / 2 % 2 == 0 ? "location: [2.0, -0.3, 1.0]" : "rotation: [0.0, -0.3, 0.1]");
+		Expected = ReplaceAll(Expected, "glasses: none", std::string("glasses: ") + Glasses[i % 2]);
+		const std::unique_ptr<DMSSimScenarioParser> ExpectedParser(DMSSimScenarioParser::Create(Expected, *Config));
+		Same = Scenarios[i]->GetSweepSize() == 0 && IsSame(*Scenarios[i], *ExpectedParser);
+	}
+	TestTrue(TEXT("Scenario Utils Test 4 overrides"), Same);
+	TestTrue(TEXT("Scenario Utils Test 4 shared scenario"), &Scenarios[0]->GetOccupantScenario(0) == &Scenarios[23]->GetOccupantScenario(0)
+		&& &Scenarios[0]->GetOccupant(0) != &Scenarios[1]->GetOccupant(0));
+	TestTrue(TEXT("Scenario Utils Test 4 view not compiled"), ThrowsRuntimeError([&]() { Scenarios[0]->Compile(); }));
+
+	const auto Loaded = DMSSimScenarioParser::ExpandSweep(DMSSimScenarioParser::Load(Compiled.data(), Compiled.size()));
+	std::vector<std::unique_ptr<DMSSimScenarioParser>> LoadedScenarios(Loaded.begin(), Loaded.end());
+	Same = LoadedScenarios.size() == Scenarios.size();
+	for (size_t i = 0; Same && i < Scenarios.size(); ++i) { Same = IsSame(*LoadedScenarios[i], *Scenarios[i]); }
+	TestTrue(TEXT("Scenario Utils Test 4 compiled sweep"), Same);
+
+	const auto Accessories = DMSSimScenarioParser::ExpandSweep(DMSSimScenarioParser::Create(MakeSweepScenario("  illumination_intensity: [1.5, 3.0]\n  headgear: cap_1\n"), *Config));
+	std::vector<std::unique_ptr<DMSSimScenarioParser>> AccessoryScenarios(Accessories.begin(), Accessories.end());
+	Same = AccessoryScenarios.size() == 2;
+	for (size_t i = 0; Same && i < AccessoryScenarios.size(); ++i) {
+		auto Expected = ReplaceAll(Ada, "intensity: 0.0", i == 0 ? "intensity: 1.5" : "intensity: 3.0");
+		Expected = ReplaceAll(Expected, "    glasses: none", "    headgear: cap_1\n    glasses: none");
+		const std::unique_ptr<DMSSimScenarioParser> ExpectedParser(DMSSimScenarioParser::Create(Expected, *Config));
+		Same = IsSame(*AccessoryScenarios[i], *ExpectedParser) && IsSame(AccessoryScenarios[i]->GetOccupant(1).GetHeadgear(), "cap_1");
+	}
+	TestTrue(TEXT("Scenario Utils Test 4 illumination and headgear"), Same);
+	const auto Single = DMSSimScenarioParser::ExpandSweep(DMSSimScenarioParser::Create(Ada, *Config));
+	TestTrue(TEXT("Scenario Utils Test 4 no sweep"), Single.size() == 1 && Single[0]->GetSweepSize() == 0);
+	delete Single[0];
+
+	const char* const InvalidSweeps[] = {
+		"  glasses: []\n",
+		"  sun_intensity: { from: 200, to: 100, step: 10 }\n",
+		"  sun_intensity: { from: 100, to: 200 }\n",
+		"  sun_intensity: { from: 100, to: 200, step: 0 }\n",
+		"  sun_intensity: { from: 0, to: 100000, step: 0.5 }\n",
+		"  sun_intensity: [1, 2]\n  sun_temperature: { from: 0, to: 12000, step: 0.2 }\n",
+		"  sun_intensity: [-1]\n",
+		"  glasses: [none]\n  glasses: [glasses_1]\n",
+		"  glasses: { from: 1, to: 2, step: 1 }\n",
+		"  camera: [front]\n",
+		"  fov: [40, 50]\n",
+	};
+	for (const auto* const Invalid : InvalidSweeps) {
+		TestTrue(TEXT("Scenario Utils Test 4 invalid sweep"), ThrowsRuntimeError([&]() { std::unique_ptr<DMSSimScenarioParser>(DMSSimScenarioParser::Create(MakeSweepScenario(Invalid), *Config)); }));
+	}
+
+	// the sweeps of a directory, the indexed directory parses the scenarios with a sweep right away
+	const auto Directory = MakeScenarioDirectory("DMSSimScenarioParserUtilsTest4");
+	const FString DirectoryPath(Directory.wstring().c_str());
+	std::ofstream(Directory / "Zulu.yml", std::ios::binary) << Scenario;
+	TestTrue(TEXT("Scenario Utils Test 4 file sweep"), CreateScenarioSweep(FString((Directory / "Zulu.yml").wstring().c_str())).size() == 24
+		&& CreateScenarioSweep(FString((Directory / TEST_SCENARIOS[0]).wstring().c_str())).size() == 1);
+	const auto Parsers = CreateScenarioParsers(DirectoryPath);
+	Same = Parsers.size() == std::size(TEST_SCENARIOS) + 24;
+	for (size_t i = 0; Same && i < 24; ++i) { Same = IsSame(*Parsers[std::size(TEST_SCENARIOS) + i], *Scenarios[i]); }
+	TestTrue(TEXT("Scenario Utils Test 4 directory"), Same);
+	auto Entries = IndexScenarioParsers(DirectoryPath);
+	Same = Entries.size() == std::size(TEST_SCENARIOS) + 24;
+	for (size_t i = 0; Same && i < Entries.size(); ++i) { Same = Entries[i].IsParsed() == (i >= std::size(TEST_SCENARIOS)); }
+	for (size_t i = 0; Same && i < 24; ++i) { Same = IsSame(*Entries[std::size(TEST_SCENARIOS) + i].Get(), *Scenarios[i]); }
+	TestTrue(TEXT("Scenario Utils Test 4 indexed directory"), Same);
+	std::filesystem::remove_all(Directory);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimScenarioParserUtilsTest5, "DMSSim.ScenarioParserUtils.Tests5", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+bool DMSSimScenarioParserUtilsTest5::RunTest(const FString& Parameters)
+{
+	// Test 5: the encoder lookahead is the encoder default if omitted or -1
+	const std::unique_ptr<DMSSimConfigParser> Config(DMSSimConfigParser::Create(DMSSIM_CONFIG_PATH));
+	std::ifstream File(std::filesystem::path(DMSSIM_SCENARIO_DIR) / "Ada.yml");
+	const std::string Ada((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+	const auto Lookahead = [&](const char* const Value) {
+		const std::unique_ptr<DMSSimScenarioParser> Parser(DMSSimScenarioParser::Create(ReplaceAll(Ada, "\n  framerate: 25", std::string("\n  framerate: 25\n  lookahead: ") + Value), *Config));
+		return Parser->GetCamera().GetEncoderLookahead();
+	};
+	TestEqual(TEXT("Scenario Utils Test 5 omitted"), std::unique_ptr<DMSSimScenarioParser>(DMSSimScenarioParser::Create(Ada, *Config))->GetCamera().GetEncoderLookahead(), -1);
+	TestEqual(TEXT("Scenario Utils Test 5 default"), Lookahead("-1"), -1);
+	TestEqual(TEXT("Scenario Utils Test 5 value"), Lookahead("40"), 40);
+	TestTrue(TEXT("Scenario Utils Test 5 invalid"), ThrowsRuntimeError([&]() { Lookahead("-2"); }));
+	return true;
+}
+#endif //WITH_DEV_AUTOMATION_TESTS
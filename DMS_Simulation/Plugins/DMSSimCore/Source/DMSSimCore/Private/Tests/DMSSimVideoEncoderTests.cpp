@@ -0,0 +1,130 @@
+#include "DMSSimVideoEncoder.h"
+#include "DMSSimConfig.h"
+#include "DMSSimUtils.h"
+#include "Misc/AutomationTest.h"
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace {
+/** Counts the packets of the first video stream in the file, -1 if the file can't be read. */
+int CountVideoPackets(const std::string& FileName) {
+	AVFormatContext* FormatContext = nullptr;
+	if (avformat_open_input(&FormatContext, FileName.c_str(), nullptr, nullptr) < 0) { return -1; }
+	int NumPackets = -1;
+	const int StreamIdx = av_find_best_stream(FormatContext, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+	if (StreamIdx >= 0) {
+		NumPackets = 0;
+		AVPacket* Packet = av_packet_alloc();
+		while (av_read_frame(FormatContext, Packet) >= 0) {
+			if (Packet->stream_index == StreamIdx) { ++NumPackets; }
+			av_packet_unref(Packet);
+		}
+		av_packet_free(&Packet);
+	}
+	avformat_close_input(&FormatContext);
+	return NumPackets;
+}
+} // anonymous namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimVideoEncoderTest1, "DMSSim.VideoEncoder.Tests1", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool DMSSimVideoEncoderTest1::RunTest(const FString& Parameters)
+{
+	// Every frame sent to the encoder must end up in the file, including the frames delayed by B-frames and frame threading
+	constexpr size_t Width = 320;
+	constexpr size_t Height = 240;
+	constexpr int NumFrames = 37;
+
+	const auto Directory = std::filesystem::temp_directory_path() / "DMSSimVideoEncoderTest1";
+	std::filesystem::remove_all(Directory);
+	std::filesystem::create_directories(Directory);
+	const std::wstring FileName = (Directory / "video").wstring();
+	const std::string FileNameFull = WideToNarrow((FileName + L".avi").c_str());
+
+	auto Encoder = DMSSimVideoEncoder::CreateVideoEncoder(FileName, Width, Height, Width, Height, 25, false, false);
+	TestTrue(TEXT("Encoder created"), Encoder.IsValid());
+	if (!Encoder) { return false; }
+
+	TArray<FColor> Image;
+	Image.SetNum(Width * Height);
+	for (int FrameIdx = 0; FrameIdx < NumFrames; ++FrameIdx) {
+		for (int32 i = 0; i < Image.Num(); ++i) { Image[i] = FColor(uint8((i + FrameIdx * 7) & 0xff), uint8((i / Width) & 0xff), uint8(FrameIdx * 5), 255); }
+		Encoder->AddFrame(Image, nullptr, nullptr, FrameIdx);
+	}
+	Encoder->Finalize();
+	Encoder.Reset();
+
+	TestEqual(TEXT("Packet count equals frame count"), CountVideoPackets(FileNameFull), NumFrames);
+	std::filesystem::remove_all(Directory);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimVideoEncoderTest2, "DMSSim.VideoEncoder.Tests2", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool DMSSimVideoEncoderTest2::RunTest(const FString& Parameters)
+{
+	// The image sequence writer must produce one PNG file per frame, named by the frame index, with no temporary files left over.
+	// Several writers are set, so the frames finish out of order on any machine.
+	constexpr size_t Width = 320;
+	constexpr size_t Height = 240;
+	constexpr int NumFrames = 23;
+
+	const std::unique_ptr<DMSSimConfigParser> Config(DMSSimConfigParser::Create(DMSSIM_CONFIG_PATH));
+	std::ifstream ScenarioFile(std::filesystem::path(DMSSIM_SCENARIO_DIR) / "Ada.yml");
+	std::string Scenario((std::istreambuf_iterator<char>(ScenarioFile)), std::istreambuf_iterator<char>());
+	Scenario.replace(Scenario.find("\n  framerate: 25"), 0, "\n  image_thread_count: 4");
+	DMSSimConfig::SetCurrentScenarioParser(MakeShareable(DMSSimScenarioParser::Create(Scenario, *Config)));
+	TestEqual(TEXT("Image writers"), DMSSimConfig::GetCamera().GetImageThreadCount(), 4);
+
+	const auto Directory = std::filesystem::temp_directory_path() / "DMSSimVideoEncoderTest2";
+	const std::wstring FileName = (Directory / "Frame").wstring();
+
+	for (const bool Nir : { false, true }) {
+		std::filesystem::remove_all(Directory);
+		std::filesystem::create_directories(Directory);
+		auto Encoder = DMSSimVideoEncoder::CreateVideoImageEncoder(FileName, Width, Height, Width, Height, 25, Nir, Nir);
+		TestTrue(TEXT("Encoder created"), Encoder.IsValid());
+		if (!Encoder) {
+			DMSSimConfig::SetCurrentScenarioParser(nullptr);
+			return false;
+		}
+
+		TArray<FColor> Image;
+		Image.SetNum(Width * Height);
+		for (int FrameIdx = 0; FrameIdx < NumFrames; ++FrameIdx) {
+			for (int32 i = 0; i < Image.Num(); ++i) { Image[i] = FColor(uint8((i + FrameIdx) & 0xff), uint8((i / Width) & 0xff), uint8(FrameIdx * 11), 255); }
+			Encoder->AddFrame(Image, nullptr, nullptr, FrameIdx);
+		}
+		Encoder->Finalize();
+		Encoder.Reset();
+
+		const auto NumFiles = std::distance(std::filesystem::directory_iterator(Directory), std::filesystem::directory_iterator());
+		TestEqual(TEXT("Number of files"), int32(NumFiles), NumFrames);
+		for (int FrameIdx = 0; FrameIdx < NumFrames; ++FrameIdx) {
+			std::ostringstream ImageName;
+			ImageName << "Frame_" << std::setw(5) << std::setfill('0') << FrameIdx << ".png";
+			const FString Caption(ImageName.str().c_str());
+			std::ifstream ImageFile(Directory / ImageName.str(), std::ios::binary);
+			char Signature[8] = {};
+			ImageFile.read(Signature, sizeof(Signature));
+			static const char PngSignature[] = { '\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n' };
+			TestTrue(Caption + TEXT(" exists"), ImageFile.is_open());
+			TestTrue(Caption + TEXT(" is a PNG file"), ImageFile.gcount() == sizeof(Signature) && memcmp(Signature, PngSignature, sizeof(Signature)) == 0);
+		}
+	}
+	DMSSimConfig::SetCurrentScenarioParser(nullptr);
+	std::filesystem::remove_all(Directory);
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
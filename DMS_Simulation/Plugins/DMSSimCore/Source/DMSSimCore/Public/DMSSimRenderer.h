@@ -5,6 +5,9 @@
 #include "UObject/Object.h"
 #include "DMSSimRenderRequest.h"
 #include "DMSSimConfig.h"
+#include "DMSSimFrameBufferPool.h"
+#include "DMSSimGroundTruthFramePool.h"
+#include "DMSSimGroundTruthWriter.h"
 #include "DMSSimRenderer.generated.h"
 
 class UWorld;
@@ -13,7 +16,7 @@ class UWorld;
  * @class UDMSSimRenderer
  * @brief The class is responsible for setting up the camera and rendering the scene into an offscreen surface.
  * Then the offscreen surface data is read and sent to VideoRecorder_, which, in its turn, saves frames into a video stream.
- * Besides this, the class stores ground truth data in a ground truth CSV file, GroundTruthStream_.
+ * Besides this, the class stores ground truth data in a ground truth CSV file, GroundTruthStream_, written by the GroundTruthWriter_ thread.
  * The object is automatically created at the start-up and terminates on the app exit.
  *
  * @var FDMSSimOccupant::World_                    Unreal World pointer
@@ -24,9 +27,12 @@ class UWorld;
  * @var FDMSSimOccupant::VideoRecorder_            Object with its own thread that does actual video stream generation from rendered frames
  * @var FDMSSimOccupant::VideoRecorders_           Vector of all active recording threads, each scenario has one thread
  * @var FDMSSimOccupant::GroundTruthStream_        File where ground truth signals are recorded
+ * @var FDMSSimOccupant::GroundTruthWriter_        Object with its own thread that formats the ground truth rows into GroundTruthStream_
  * @var FDMSSimOccupant::CurrentFrame_             Frame counter, used to skip some number of frames at the beginning of the simulation
  * @var FDMSSimOccupant::StartTime_                Time when the simulation has started
  * @var FDMSSimOccupant::CameraSetup_              Internal flag, true if camera was configured
+ * @var FDMSSimOccupant::FrameBufferPool_          Recyclable pixel buffers for the render requests
+ * @var FDMSSimOccupant::GroundTruthFramePool_     Recyclable ground truth frames for the ground truth writer and the labelers
  */
 UCLASS()
 class UDMSSimRenderer : public UObject
@@ -47,9 +53,12 @@ private:
 	TArray<TSharedPtr<FRunnable>>             VideoRecorders_;
 	int                                       ScenarioIdxPrev_ = -1;
 	std::ofstream                             GroundTruthStream_;
+	TUniquePtr<DMSSimGroundTruthWriter>       GroundTruthWriter_;
 	size_t                                    CurrentFrame_ = 0;
 	float                                     StartTime_ = 0.0f;
 	bool                                      CameraSetup_ = false;
+	TUniquePtr<DMSSimFrameBufferPool>         FrameBufferPool_;
+	TUniquePtr<DMSSimGroundTruthFramePool>    GroundTruthFramePool_;
 
 	/**
 	 * Initializes the renderer.
@@ -88,14 +97,15 @@ private:
 	/*
 	helper  function to initiate rendering of the current frame into an offscreen surface.
 	and enqueue image, groundtruth and parser to the request queues
+	GroundTruth is the snapshot of the frame RenderFrame took for the ground truth writer
 	*/
-	void EnqueueRequests();
+	void EnqueueRequests(const DMSSimGroundTruthFramePool::FramePtr& GroundTruth);
 
 	/*helper function to create vidoe/image file prefix*/
 	std::wstring GetVideoFileName();
 
-	/*helper function to create csv file prefix*/
-	std::wstring GetCsvFileName();
+	/*helper function to create the ground truth file name, .csv or .dmsgt*/
+	std::wstring GetCsvFileName(DMSSimGroundTruthFormat::FileFormat Format);
 
 	/*
 	 * Returns the number of frames in the render queue
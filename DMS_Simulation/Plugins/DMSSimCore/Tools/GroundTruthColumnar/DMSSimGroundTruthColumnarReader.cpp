@@ -0,0 +1,167 @@
+#include "DMSSimGroundTruthColumnarReader.h"
+#include <cstring>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace DMSSimGroundTruthFormat;
+
+DMSSimGroundTruthColumnarReader::DMSSimGroundTruthColumnarReader(const std::string& Path) {
+	if (Map(Path) && !Parse()) {
+		Columns_.clear();
+		RowGroups_.clear();
+		RowCount_ = 0;
+	}
+}
+
+DMSSimGroundTruthColumnarReader::~DMSSimGroundTruthColumnarReader() { Unmap(); }
+
+int DMSSimGroundTruthColumnarReader::FindColumn(const std::string& Name) const {
+	for (size_t i = 0; i < Columns_.size(); ++i) {
+		if (Columns_[i].Name == Name) { return static_cast<int>(i); }
+	}
+	return -1;
+}
+
+DMSSimGroundTruthColumnarReader::Span<float> DMSSimGroundTruthColumnarReader::GetFloatColumn(const size_t RowGroup, const size_t Column) const {
+	if (Columns_[Column].Type != ColumnType::Float32) { return {}; }
+	const auto Raw = GetRawColumn(RowGroup, Column);
+	return { reinterpret_cast<const float*>(Raw.Data), Raw.Size };
+}
+
+DMSSimGroundTruthColumnarReader::Span<int32_t> DMSSimGroundTruthColumnarReader::GetIntColumn(const size_t RowGroup, const size_t Column) const {
+	if (Columns_[Column].Type == ColumnType::Float32) { return {}; }
+	const auto Raw = GetRawColumn(RowGroup, Column);
+	return { reinterpret_cast<const int32_t*>(Raw.Data), Raw.Size };
+}
+
+DMSSimGroundTruthColumnarReader::Span<uint32_t> DMSSimGroundTruthColumnarReader::GetRawColumn(const size_t RowGroup, const size_t Column) const {
+	const auto& Group = RowGroups_[RowGroup];
+	return { Group.Data + Column * Group.RowCount, Group.RowCount };
+}
+
+bool DMSSimGroundTruthColumnarReader::Parse() {
+	FileHeader Header;
+	if (Size_ < sizeof(Header)) {
+		Error_ = "The file is too short for a ground truth file header";
+		return false;
+	}
+	std::memcpy(&Header, Data_, sizeof(Header));
+	if (std::memcmp(Header.Magic, COLUMNAR_MAGIC, sizeof(Header.Magic)) != 0) {
+		Error_ = "Not a columnar ground truth file";
+		return false;
+	}
+	if (Header.Version != COLUMNAR_VERSION) {
+		Error_ = "Unsupported columnar ground truth version " + std::to_string(Header.Version);
+		return false;
+	}
+
+	size_t Offset = sizeof(Header);
+	const size_t SchemaBegin = Offset;
+	Columns_.reserve(Header.ColumnCount);
+	for (uint32_t i = 0; i < Header.ColumnCount; ++i) {
+		ColumnHeader Info;
+		if (Size_ - Offset < sizeof(Info)) {
+			Error_ = "The schema of the file is truncated";
+			return false;
+		}
+		std::memcpy(&Info, Data_ + Offset, sizeof(Info));
+		Offset += sizeof(Info);
+		if (Size_ - Offset < Info.NameLength || Info.Type > static_cast<uint8_t>(ColumnType::TimeMs)) {
+			Error_ = "The schema of the file is invalid";
+			return false;
+		}
+		Columns_.push_back({ std::string(reinterpret_cast<const char*>(Data_ + Offset), Info.NameLength), static_cast<ColumnType>(Info.Type), Info.Group });
+		Offset += Info.NameLength;
+	}
+	Offset = SchemaBegin + AlignTo8(Offset - SchemaBegin);
+
+	// a row group that was cut off, e.g. by a crash of the simulation, ends the file
+	while (Offset < Size_) {
+		RowGroupHeader GroupHeader;
+		if (Size_ - Offset < sizeof(GroupHeader)) { break; }
+		std::memcpy(&GroupHeader, Data_ + Offset, sizeof(GroupHeader));
+		if (std::memcmp(GroupHeader.Magic, ROW_GROUP_MAGIC, sizeof(GroupHeader.Magic)) != 0) {
+			Error_ = "Invalid row group at offset " + std::to_string(Offset);
+			return false;
+		}
+		Offset += sizeof(GroupHeader);
+		const size_t GroupSize = size_t(GroupHeader.RowCount) * Columns_.size() * sizeof(uint32_t);
+		if (Size_ - Offset < GroupSize) { break; }
+		RowGroups_.push_back({ reinterpret_cast<const uint32_t*>(Data_ + Offset), GroupHeader.RowCount });
+		RowCount_ += GroupHeader.RowCount;
+		Offset += GroupSize;
+	}
+	return true;
+}
+
+#if defined(_WIN32)
+
+bool DMSSimGroundTruthColumnarReader::Map(const std::string& Path) {
+	const HANDLE File = CreateFileA(Path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (File == INVALID_HANDLE_VALUE) {
+		Error_ = "Can't open " + Path;
+		return false;
+	}
+	LARGE_INTEGER FileSize = {};
+	GetFileSizeEx(File, &FileSize);
+	Size_ = static_cast<size_t>(FileSize.QuadPart);
+	if (Size_ > 0) {
+		MappingHandle_ = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (MappingHandle_) { Data_ = static_cast<const unsigned char*>(MapViewOfFile(MappingHandle_, FILE_MAP_READ, 0, 0, 0)); }
+	}
+	CloseHandle(File);
+	if (!Data_) {
+		Error_ = "Can't map " + Path;
+		Unmap();
+		return false;
+	}
+	return true;
+}
+
+void DMSSimGroundTruthColumnarReader::Unmap() {
+	if (Data_) { UnmapViewOfFile(Data_); }
+	if (MappingHandle_) { CloseHandle(MappingHandle_); }
+	Data_ = nullptr;
+	MappingHandle_ = nullptr;
+	Size_ = 0;
+}
+
+#else
+
+bool DMSSimGroundTruthColumnarReader::Map(const std::string& Path) {
+	const int File = open(Path.c_str(), O_RDONLY);
+	if (File < 0) {
+		Error_ = "Can't open " + Path;
+		return false;
+	}
+	struct stat FileStat = {};
+	if (fstat(File, &FileStat) == 0 && FileStat.st_size > 0) {
+		Size_ = static_cast<size_t>(FileStat.st_size);
+		void* const Mapping = mmap(nullptr, Size_, PROT_READ, MAP_PRIVATE, File, 0);
+		if (Mapping != MAP_FAILED) { Data_ = static_cast<const unsigned char*>(Mapping); }
+	}
+	close(File);
+	if (!Data_) {
+		Error_ = "Can't map " + Path;
+		Size_ = 0;
+		return false;
+	}
+	return true;
+}
+
+void DMSSimGroundTruthColumnarReader::Unmap() {
+	if (Data_) { munmap(const_cast<unsigned char*>(Data_), Size_); }
+	Data_ = nullptr;
+	Size_ = 0;
+}
+
+#endif
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "DMSSimGroundTruthFormat.h"
+
+/**
+ * @class DMSSimGroundTruthColumnarReader
+ * @brief Reads a binary columnar ground truth file (*.dmsgt) written by DMSSimGroundTruthColumnarWriter.
+ * The file is memory-mapped, the column spans point into the mapping and stay valid as long as the reader exists.
+ * Only the C++ standard library and the OS file mapping are used, so the reader can be built into any training tool.
+ * The file is expected to be little endian, like the machines the simulation runs on.
+ */
+class DMSSimGroundTruthColumnarReader
+{
+public:
+	/** Values of a column in a row group, in the mapped file. */
+	template <typename T>
+	struct Span {
+		const T* Data = nullptr;
+		size_t   Size = 0;
+
+		const T* begin() const { return Data; }
+		const T* end() const { return Data + Size; }
+		const T& operator[](const size_t Index) const { return Data[Index]; }
+		bool empty() const { return Size == 0; }
+	};
+
+	/** Maps the file and reads the schema and the row group positions. Check IsValid, if it could be read. */
+	explicit DMSSimGroundTruthColumnarReader(const std::string& Path);
+	DMSSimGroundTruthColumnarReader(const DMSSimGroundTruthColumnarReader&) = delete;
+	DMSSimGroundTruthColumnarReader& operator=(const DMSSimGroundTruthColumnarReader&) = delete;
+	~DMSSimGroundTruthColumnarReader();
+
+	bool IsValid() const { return Error_.empty(); }
+	const std::string& GetError() const { return Error_; }
+
+	const std::vector<DMSSimGroundTruthFormat::ColumnInfo>& GetColumns() const { return Columns_; }
+
+	/** @return the index of the column, -1 if the file has no such column. */
+	int FindColumn(const std::string& Name) const;
+
+	uint64_t GetRowCount() const { return RowCount_; }
+	size_t GetRowGroupCount() const { return RowGroups_.size(); }
+	uint32_t GetRowGroupRowCount(const size_t RowGroup) const { return RowGroups_[RowGroup].RowCount; }
+
+	/** Values of a Float32 column, empty for columns of other types. */
+	Span<float> GetFloatColumn(size_t RowGroup, size_t Column) const;
+
+	/** Values of an Int32 or TimeMs column, empty for Float32 columns. */
+	Span<int32_t> GetIntColumn(size_t RowGroup, size_t Column) const;
+
+	/** Raw 32 bit values of a column of any type. */
+	Span<uint32_t> GetRawColumn(size_t RowGroup, size_t Column) const;
+
+	/** @return true for the value of a column that the frame didn't have, e.g. a landmark of an empty seat. */
+	bool IsMissing(const size_t Column, const uint32_t RawValue) const {
+		return Columns_[Column].Type == DMSSimGroundTruthFormat::ColumnType::Float32 ?
+			RawValue == DMSSimGroundTruthFormat::MISSING_FLOAT32_BITS : RawValue == static_cast<uint32_t>(DMSSimGroundTruthFormat::MISSING_INT32);
+	}
+
+private:
+	struct RowGroup {
+		const uint32_t* Data;      // the first value of the first column
+		uint32_t        RowCount;
+	};
+
+	bool Map(const std::string& Path);
+	void Unmap();
+	bool Parse();
+
+	const unsigned char*                             Data_ = nullptr;
+	size_t                                           Size_ = 0;
+	void*                                            MappingHandle_ = nullptr;  // Windows only
+	std::string                                      Error_;
+	std::vector<DMSSimGroundTruthFormat::ColumnInfo> Columns_;
+	std::vector<RowGroup>                            RowGroups_;
+	uint64_t                                         RowCount_ = 0;
+};
@@ -0,0 +1,190 @@
+#include "DMSSimGroundTruthConvert.h"
+#include <charconv>
+#include <unordered_map>
+#include <vector>
+#include "DMSSimGroundTruthColumnarReader.h"
+#include "DMSSimGroundTruthColumnarWriter.h"
+#include "DMSSimGroundTruthRecorder.h"
+
+using namespace DMSSimGroundTruthFormat;
+
+namespace {
+
+/** Columns [Begin, End) are written by the same CSV field group. */
+struct ColumnGroup {
+	size_t Begin;
+	size_t End;
+};
+
+std::vector<ColumnGroup> GetColumnGroups(const std::vector<ColumnInfo>& Columns) {
+	std::vector<ColumnGroup> Groups;
+	for (size_t i = 0; i < Columns.size(); ++i) {
+		if (Groups.empty() || Columns[i].Group != Columns[Groups.back().Begin].Group) { Groups.push_back({ i, i }); }
+		Groups.back().End = i + 1;
+	}
+	return Groups;
+}
+
+/** Splits a line of "value";"value";... into the values without the quotes. */
+void SplitCsvLine(const std::string& Line, std::vector<std::string>& Fields) {
+	Fields.clear();
+	size_t Begin = 0;
+	while (Begin <= Line.size()) {
+		size_t End = Line.find(';', Begin);
+		if (End == std::string::npos) { End = Line.size(); }
+		size_t FieldBegin = Begin;
+		size_t FieldEnd = End;
+		if (FieldEnd > FieldBegin && Line[FieldEnd - 1] == '\r') { --FieldEnd; }
+		if (FieldEnd - FieldBegin >= 2 && Line[FieldBegin] == '"' && Line[FieldEnd - 1] == '"') {
+			++FieldBegin;
+			--FieldEnd;
+		}
+		Fields.emplace_back(Line, FieldBegin, FieldEnd - FieldBegin);
+		Begin = End + 1;
+	}
+}
+
+bool ParseTime(const std::string& Text, int32_t& Milliseconds) {
+	int Hours = 0;
+	int Minutes = 0;
+	int Seconds = 0;
+	int Fraction = 0;
+	const char* Pos = Text.data();
+	const char* const End = Text.data() + Text.size();
+	for (int* const Part : { &Hours, &Minutes, &Seconds, &Fraction }) {
+		const auto Result = std::from_chars(Pos, End, *Part);
+		if (Result.ec != std::errc()) { return false; }
+		Pos = Result.ptr;
+		if (Part != &Fraction) {
+			if (Pos == End || (*Pos != ':' && *Pos != '.')) { return false; }
+			++Pos;
+		}
+	}
+	Milliseconds = ((Hours * 60 + Minutes) * 60 + Seconds) * 1000 + Fraction;
+	return Pos == End;
+}
+
+bool ParseValue(const std::string& Text, const ColumnType Type, uint32_t& Cell) {
+	const char* const End = Text.data() + Text.size();
+	if (Type == ColumnType::Float32) {
+		float Value = 0.0f;
+		const auto Result = std::from_chars(Text.data(), End, Value);
+		Cell = FloatToBits(Value);
+		return Result.ec == std::errc() && Result.ptr == End;
+	}
+	int32_t Value = 0;
+	if (Type == ColumnType::TimeMs) {
+		if (!ParseTime(Text, Value)) { return false; }
+	} else {
+		const auto Result = std::from_chars(Text.data(), End, Value);
+		if (Result.ec != std::errc() || Result.ptr != End) { return false; }
+	}
+	Cell = static_cast<uint32_t>(Value);
+	return true;
+}
+
+void AppendValue(std::string& Line, const ColumnType Type, const uint32_t Cell) {
+	char Text[MAX_VALUE_LENGTH];
+	char* End = Text;
+	switch (Type) {
+		case ColumnType::Float32: End = FormatFloat(Text, BitsToFloat(Cell)); break;
+		case ColumnType::TimeMs:  End = FormatTime(Text, static_cast<int32_t>(Cell)); break;
+		default:                  End = FormatInt(Text, static_cast<int32_t>(Cell)); break;
+	}
+	Line.append(Text, End);
+}
+
+} // anonymous namespace
+
+bool DMSSimGroundTruthConvert::CsvToColumnar(std::istream& Csv, std::ostream& Columnar, std::string& Error, const uint32_t RowGroupSize) {
+	std::unordered_map<std::string, const ColumnInfo*> RecorderColumns;
+	for (const ColumnInfo& Column : DMSSimGroundTruthRecorder::GetColumns()) { RecorderColumns.emplace(Column.Name, &Column); }
+
+	std::string Line;
+	std::vector<std::string> Fields;
+	if (!std::getline(Csv, Line)) {
+		Error = "The CSV has no header";
+		return false;
+	}
+	SplitCsvLine(Line, Fields);
+	std::vector<ColumnInfo> Columns;
+	for (const std::string& Name : Fields) {
+		const auto Found = RecorderColumns.find(Name);
+		if (Found == RecorderColumns.end()) {
+			Error = "Unknown ground truth column \"" + Name + "\"";
+			return false;
+		}
+		Columns.push_back(*Found->second);
+	}
+	const std::vector<ColumnGroup> Groups = GetColumnGroups(Columns);
+
+	DMSSimGroundTruthColumnarWriter Writer(Columnar, RowGroupSize);
+	Writer.WriteHeader(Columns);
+	for (size_t LineNumber = 2; std::getline(Csv, Line); ++LineNumber) {
+		if (Line.empty() || Line == "\r") { continue; }
+		SplitCsvLine(Line, Fields);
+		uint32_t* const Cells = Writer.BeginRow();
+		size_t Field = 0;
+		for (const ColumnGroup& Group : Groups) {
+			// a group without values is a single empty field
+			if (Field < Fields.size() && Fields[Field].empty()) {
+				++Field;
+				continue;
+			}
+			for (size_t Column = Group.Begin; Column < Group.End; ++Column, ++Field) {
+				if (Field >= Fields.size() || !ParseValue(Fields[Field], Columns[Column].Type, Cells[Column])) {
+					Error = "Line " + std::to_string(LineNumber) + " doesn't match the header at column \"" + Columns[Column].Name + "\"";
+					return false;
+				}
+			}
+		}
+		if (Field != Fields.size()) {
+			Error = "Line " + std::to_string(LineNumber) + " has more values than the header";
+			return false;
+		}
+		Writer.EndRow();
+	}
+	Writer.Flush();
+	return true;
+}
+
+void DMSSimGroundTruthConvert::ColumnarToCsv(const DMSSimGroundTruthColumnarReader& Reader, std::ostream& Csv) {
+	const std::vector<ColumnInfo>& Columns = Reader.GetColumns();
+	const std::vector<ColumnGroup> Groups = GetColumnGroups(Columns);
+
+	std::string Line;
+	for (const ColumnInfo& Column : Columns) {
+		if (!Line.empty()) { Line += ';'; }
+		Line += '"';
+		Line += Column.Name;
+		Line += '"';
+	}
+	Line += '\n';
+	Csv.write(Line.data(), static_cast<std::streamsize>(Line.size()));
+
+	std::vector<DMSSimGroundTruthColumnarReader::Span<uint32_t>> Values(Columns.size());
+	for (size_t RowGroup = 0; RowGroup < Reader.GetRowGroupCount(); ++RowGroup) {
+		for (size_t Column = 0; Column < Columns.size(); ++Column) { Values[Column] = Reader.GetRawColumn(RowGroup, Column); }
+		for (uint32_t Row = 0; Row < Reader.GetRowGroupRowCount(RowGroup); ++Row) {
+			Line.clear();
+			for (const ColumnGroup& Group : Groups) {
+				// the recorder writes the values of a group up to the last one the frame has
+				size_t End = Group.End;
+				while (End > Group.Begin && Reader.IsMissing(End - 1, Values[End - 1][Row])) { --End; }
+				if (End == Group.Begin) {
+					Line += Line.empty() ? "\"\"" : ";\"\"";
+					continue;
+				}
+				for (size_t Column = Group.Begin; Column < End; ++Column) {
+					if (!Line.empty()) { Line += ';'; }
+					Line += '"';
+					if (!Reader.IsMissing(Column, Values[Column][Row])) { AppendValue(Line, Columns[Column].Type, Values[Column][Row]); }
+					Line += '"';
+				}
+			}
+			Line += '\n';
+			Csv.write(Line.data(), static_cast<std::streamsize>(Line.size()));
+		}
+	}
+	Csv.flush();
+}
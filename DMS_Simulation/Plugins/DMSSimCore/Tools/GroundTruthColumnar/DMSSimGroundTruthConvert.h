@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include "DMSSimGroundTruthFormat.h"
+
+class DMSSimGroundTruthColumnarReader;
+
+/**
+ * @brief Conversion of the ground truth between the CSV and the binary columnar format.
+ * The column types of a CSV file are the ones of DMSSimGroundTruthRecorder, so the CSV must have been written by the same
+ * column table. Converting a CSV to the columnar format and back gives the same CSV. The other way round, the floats can differ
+ * in the last bit, the 8 significant digits of the CSV are not always enough to restore a float exactly.
+ */
+namespace DMSSimGroundTruthConvert {
+	/**
+	 * Reads a ground truth CSV and writes it in the binary columnar format.
+	 *
+	 * @param[out] Error The reason of the failure, e.g. an unknown column or a row that doesn't match the header
+	 * @return false, if the CSV can't be converted.
+	 */
+	bool CsvToColumnar(std::istream& Csv, std::ostream& Columnar, std::string& Error,
+		uint32_t RowGroupSize = DMSSimGroundTruthFormat::DEFAULT_ROW_GROUP_SIZE);
+
+	/**
+	 * Writes the rows of a binary columnar ground truth file as CSV, with the same text as DMSSimGroundTruthRecorder.
+	 */
+	void ColumnarToCsv(const DMSSimGroundTruthColumnarReader& Reader, std::ostream& Csv);
+} // namespace DMSSimGroundTruthConvert
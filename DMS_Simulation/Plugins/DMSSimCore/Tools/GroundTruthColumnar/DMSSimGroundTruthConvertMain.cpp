@@ -0,0 +1,57 @@
+// Converts ground truth files between the CSV and the binary columnar format, the direction is given by the input extension:
+//
+//   DMSSimGroundTruthConvert Sim_Scenario_0001.csv Sim_Scenario_0001.dmsgt
+//   DMSSimGroundTruthConvert Sim_Scenario_0001.dmsgt Sim_Scenario_0001.csv
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "DMSSimGroundTruthColumnarReader.h"
+#include "DMSSimGroundTruthConvert.h"
+
+namespace {
+bool EndsWith(const std::string& Text, const std::string& Suffix) {
+	return Text.size() >= Suffix.size() && Text.compare(Text.size() - Suffix.size(), Suffix.size(), Suffix) == 0;
+}
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+	if (argc != 3) {
+		std::fprintf(stderr, "Usage: %s <input.csv|input%s> <output>\n", argv[0], DMSSimGroundTruthFormat::COLUMNAR_EXTENSION);
+		return 2;
+	}
+	const std::string Input = argv[1];
+	const std::string Output = argv[2];
+
+	if (EndsWith(Input, DMSSimGroundTruthFormat::COLUMNAR_EXTENSION)) {
+		const DMSSimGroundTruthColumnarReader Reader(Input);
+		if (!Reader.IsValid()) {
+			std::fprintf(stderr, "%s: %s\n", Input.c_str(), Reader.GetError().c_str());
+			return 1;
+		}
+		std::ofstream Csv(Output, std::ios_base::out | std::ios_base::trunc);
+		DMSSimGroundTruthConvert::ColumnarToCsv(Reader, Csv);
+		if (!Csv) {
+			std::fprintf(stderr, "Can't write %s\n", Output.c_str());
+			return 1;
+		}
+		return 0;
+	}
+
+	std::ifstream Csv(Input);
+	if (!Csv) {
+		std::fprintf(stderr, "Can't open %s\n", Input.c_str());
+		return 1;
+	}
+	std::ofstream Columnar(Output, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+	std::string Error;
+	if (!DMSSimGroundTruthConvert::CsvToColumnar(Csv, Columnar, Error)) {
+		std::fprintf(stderr, "%s: %s\n", Input.c_str(), Error.c_str());
+		return 1;
+	}
+	if (!Columnar) {
+		std::fprintf(stderr, "Can't write %s\n", Output.c_str());
+		return 1;
+	}
+	return 0;
+}
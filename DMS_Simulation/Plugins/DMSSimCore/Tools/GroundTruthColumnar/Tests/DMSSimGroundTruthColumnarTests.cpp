@@ -0,0 +1,137 @@
+#include "DMSSimGroundTruthColumnarReader.h"
+#include "DMSSimGroundTruthColumnarWriter.h"
+#include "DMSSimGroundTruthConvert.h"
+#include "DMSSimGroundTruthRecorder.h"
+#include "DMSSimGroundTruthWriter.h"
+#include "Misc/AutomationTest.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace {
+
+constexpr int      FRAME_COUNT = 50;
+constexpr uint32_t ROW_GROUP_SIZE = 7;  // several row groups and a shorter last one
+
+/** A frame with a driver and a front passenger, the other seats are empty. */
+DMSSimGroundTruthFrame MakeFrame(const int FrameIndex) {
+	DMSSimGroundTruthFrame FrameCompound = {};
+	FrameCompound.Data.CarPosition_inWorld = { -98982.4141f + FrameIndex, -4934.33740f, 230.432068f };
+	FrameCompound.Data.CarRotation_inWorld = { -179.999954f, 0.5f * FrameIndex, -0.734222293f };
+
+	const FDMSSimOccupantType Occupants[] = { FDMSSimOccupantType::Driver, FDMSSimOccupantType::PassengerFront };
+	for (const auto OccupantType : Occupants) {
+		auto& Frame = FrameCompound.Data.Occupants[static_cast<uint8>(OccupantType)];
+		const float Offset = 0.25f * FrameIndex + static_cast<uint8>(OccupantType);
+		Frame.Initialized = true;
+		Frame.NosePoint = { -99130.5156f + Offset, -4976.34912f, 127.815781f };
+		Frame.LeftEyePoint = { -99134.9219f, -4979.76855f + Offset, 132.006348f };
+		Frame.RightEyePoint = { -99134.8750f, -4972.83301f, 131.928482f + Offset };
+		Frame.LeftEyeOpening = 0.9f - 0.01f * FrameIndex;
+		Frame.HorizontalMouthOpening = 3.02f + Offset;
+		Frame.FacialLandmarksVisible.SetNum(68);
+		Frame.FacialLandmarks3D_inCam.SetNum(68);
+		Frame.FacialLandmarks2D.SetNum(68);
+		Frame.FaceBoundingBox3D_inCam.SetNum(8);
+		for (int i = 0; i < 68; i++) {
+			Frame.FacialLandmarksVisible[i] = (i + FrameIndex) % 3 != 0;
+			Frame.FacialLandmarks3D_inCam[i] = { -99134.9219f + i, -4979.76855f + Offset, 132.006348f };
+			Frame.FacialLandmarks2D[i] = { 100.0f + i, 200.0f + FrameIndex };
+		}
+		for (int i = 0; i < 8; i++) { Frame.FaceBoundingBox3D_inCam[i] = { -99134.9219f + i, -4979.76855f, 132.006348f + Offset }; }
+		Frame.FaceBoundingBox2D = { { 300.0f + Offset, 400.0f }, 120.0f, 150.0f };
+	}
+	return FrameCompound;
+}
+
+void WriteFile(const std::string& Path, const std::string& Content) {
+	std::ofstream File(Path, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+	File.write(Content.data(), static_cast<std::streamsize>(Content.size()));
+}
+
+} // anonymous namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimGroundTruthColumnarTest, "DMSSim.GroundTruthColumnar.RoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool DMSSimGroundTruthColumnarTest::RunTest(const FString& Parameters)
+{
+	std::vector<DMSSimGroundTruthFrame> Frames;
+	for (int i = 0; i < FRAME_COUNT; ++i) { Frames.push_back(MakeFrame(i)); }
+
+	std::stringstream Csv;
+	DMSSimGroundTruthRecorder::AddHeader(Csv);
+	for (int i = 0; i < FRAME_COUNT; ++i) { DMSSimGroundTruthRecorder::AddFrame(Csv, i / 30.0, Frames[i]); }
+
+	std::stringstream Columnar;
+	{
+		DMSSimGroundTruthColumnarWriter Writer(Columnar, ROW_GROUP_SIZE);
+		DMSSimGroundTruthRecorder::AddHeader(Writer);
+		for (int i = 0; i < FRAME_COUNT; ++i) { DMSSimGroundTruthRecorder::AddFrame(Writer, i / 30.0, Frames[i]); }
+	}
+	const std::string Path = (std::filesystem::temp_directory_path() / (std::string("DMSSimGroundTruthColumnarTest") + DMSSimGroundTruthFormat::COLUMNAR_EXTENSION)).string();
+	WriteFile(Path, Columnar.str());
+
+	{
+		const DMSSimGroundTruthColumnarReader Reader(Path);
+		TestTrue(TEXT("Columnar file is valid"), Reader.IsValid());
+		TestEqual(TEXT("Row count"), static_cast<int32>(Reader.GetRowCount()), FRAME_COUNT);
+		TestEqual(TEXT("Row group count"), static_cast<int32>(Reader.GetRowGroupCount()), static_cast<int32>((FRAME_COUNT + ROW_GROUP_SIZE - 1) / ROW_GROUP_SIZE));
+		TestEqual(TEXT("Column count"), static_cast<int32>(Reader.GetColumns().size()), static_cast<int32>(DMSSimGroundTruthRecorder::GetColumns().size()));
+
+		// spans of typed columns, the time column holds milliseconds
+		const int TimeColumn = Reader.FindColumn("Time");
+		const int MouthColumn = Reader.FindColumn("s_DM_HorizontalMouthOpening");
+		const int LandmarkColumn = Reader.FindColumn("FacialLandmarks_1_u");
+		const int EmptySeatColumn = Reader.FindColumn("FacialLandmarks_1_x");
+		TestTrue(TEXT("Columns found"), TimeColumn >= 0 && MouthColumn >= 0 && LandmarkColumn >= 0 && EmptySeatColumn >= 0);
+		if (TimeColumn >= 0 && MouthColumn >= 0 && LandmarkColumn >= 0) {
+			const auto Time = Reader.GetIntColumn(1, TimeColumn);
+			TestEqual(TEXT("Time of row 8"), Time[1], DMSSimGroundTruthFormat::TimeToMilliseconds(8 / 30.0));
+			TestTrue(TEXT("Float column"), Reader.GetFloatColumn(0, MouthColumn).Size == ROW_GROUP_SIZE);
+			TestTrue(TEXT("Int column is not float"), Reader.GetFloatColumn(0, LandmarkColumn).empty());
+			TestEqual(TEXT("Landmark u of row 3"), Reader.GetIntColumn(0, LandmarkColumn)[3], 100);
+		}
+
+		std::stringstream CsvFromColumnar;
+		DMSSimGroundTruthConvert::ColumnarToCsv(Reader, CsvFromColumnar);
+		TestTrue(TEXT("Columnar to CSV gives the recorded CSV"), CsvFromColumnar.str() == Csv.str());
+	}
+
+	std::stringstream ColumnarFromCsv;
+	std::string Error;
+	Csv.seekg(0);
+	TestTrue(TEXT("CSV to columnar"), DMSSimGroundTruthConvert::CsvToColumnar(Csv, ColumnarFromCsv, Error, ROW_GROUP_SIZE));
+	TestEqual(TEXT("CSV to columnar size"), static_cast<int32>(ColumnarFromCsv.str().size()), static_cast<int32>(Columnar.str().size()));
+	// the CSV floats have 8 significant digits, so only the way back to the CSV is exact
+	WriteFile(Path, ColumnarFromCsv.str());
+	{
+		const DMSSimGroundTruthColumnarReader Reader(Path);
+		std::stringstream CsvRoundTrip;
+		DMSSimGroundTruthConvert::ColumnarToCsv(Reader, CsvRoundTrip);
+		TestTrue(TEXT("CSV to columnar and back gives the same CSV"), CsvRoundTrip.str() == Csv.str());
+	}
+
+	// the writer thread writes the same file as the recorder called directly
+	std::stringstream Expected;
+	{
+		DMSSimGroundTruthColumnarWriter Writer(Expected);
+		DMSSimGroundTruthRecorder::AddHeader(Writer);
+		for (int i = 0; i < FRAME_COUNT; ++i) { DMSSimGroundTruthRecorder::AddFrame(Writer, i / 30.0, Frames[i]); }
+	}
+	std::stringstream Threaded;
+	{
+		DMSSimGroundTruthWriter Writer(Threaded, 2, DMSSimGroundTruthFormat::FileFormat::Columnar);
+		for (int i = 0; i < FRAME_COUNT; ++i) { Writer.AddFrame(i / 30.0, MakeShared<const DMSSimGroundTruthFrame, ESPMode::ThreadSafe>(Frames[i])); }
+		Writer.Finalize();
+	}
+	TestTrue(TEXT("Writer thread output matches"), Threaded.str() == Expected.str());
+
+	std::remove(Path.c_str());
+	return true;
+}
+
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "DMSSimLabelFormat.h"
+
+/**
+ * @class DMSSimLabelCborReader
+ * @brief Reads the binary OpenLABEL file of DMSSimImageLabelerCborImpl and passes the values to a rapidjson handler,
+ * e.g. a Writer, which gives the json of the streaming mode, or a Document. Only the CBOR the labeler writes is read:
+ * strings of definite length, string references, keys of LABEL_KEYS, int32 and float32 typed arrays and no half precision floats.
+ * The data has to stay valid while the reader is used.
+ */
+class DMSSimLabelCborReader
+{
+public:
+	DMSSimLabelCborReader(const char* Data, size_t Size) :
+		Data_(reinterpret_cast<const uint8_t*>(Data)), Size_(Size) {}
+
+	/** Reads the next value, the self-described tag of the file is skipped. */
+	template <typename Handler>
+	bool ReadValue(Handler& Out) { return ReadItem(Out, 0); }
+
+	/** Reads the head of a map. Its keys are read with NextKey, its values with ReadValue. */
+	bool EnterMap();
+
+	/** Reads the key of the next member of the innermost map entered, false at its end or on an error. */
+	bool NextKey(std::string& Key);
+
+	bool AtEnd() const { return Pos_ == Size_; }
+	bool HasError() const { return !Error_.empty(); }
+	const std::string& GetError() const { return Error_; }
+
+private:
+	static constexpr int      MAX_DEPTH = 64;
+	static constexpr uint64_t INDEFINITE = UINT64_MAX;
+
+	struct StringValue {
+		uint8_t     Major = 0;
+		const char* Data = nullptr;
+		size_t      Length = 0;
+	};
+
+	bool Fail(const char* Message) {
+		if (Error_.empty()) { Error_ = std::string(Message) + " at byte " + std::to_string(Pos_); }
+		return false;
+	}
+
+	bool ReadHead(uint8_t& Major, uint8_t& Info, uint64_t& Argument);
+	bool PeekBreak();
+	bool ReadString(StringValue& String);
+	bool ReadString(StringValue& String, uint8_t Major, uint8_t Info, uint64_t Argument);
+	bool ReadKey(StringValue& Key);
+
+	template <typename Handler>
+	bool ReadItem(Handler& Out, int Depth);
+
+	template <typename Handler>
+	bool ReadTypedArray(Handler& Out, uint64_t Tag);
+
+	const uint8_t*                        Data_;
+	size_t                                Size_;
+	size_t                                Pos_ = 0;
+	std::string                           Error_;
+	std::vector<std::vector<StringValue>> Namespaces_; // string tables of the open stringref namespaces
+	std::vector<uint64_t>                 Maps_;       // members left in the maps entered, INDEFINITE for a map closed by a break
+};
+
+inline bool DMSSimLabelCborReader::ReadHead(uint8_t& Major, uint8_t& Info, uint64_t& Argument) {
+	if (Pos_ >= Size_) { return Fail("unexpected end of file"); }
+	const uint8_t Initial = Data_[Pos_++];
+	Major = Initial >> 5;
+	Info = Initial & 0x1F;
+	if (Info < DMSSimLabelFormat::INFO_UINT8 || Info == DMSSimLabelFormat::INFO_INDEFINITE) {
+		Argument = Info == DMSSimLabelFormat::INFO_INDEFINITE ? INDEFINITE : Info;
+		return true;
+	}
+	if (Info > DMSSimLabelFormat::INFO_UINT64) { return Fail("invalid additional information"); }
+	const size_t Length = size_t(1) << (Info - DMSSimLabelFormat::INFO_UINT8);
+	if (Size_ - Pos_ < Length) { return Fail("unexpected end of file"); }
+	Argument = 0;
+	for (size_t i = 0; i < Length; ++i) { Argument = (Argument << 8) | Data_[Pos_++]; }
+	return true;
+}
+
+inline bool DMSSimLabelCborReader::PeekBreak() {
+	if (Pos_ < Size_ && Data_[Pos_] == DMSSimLabelFormat::BREAK) {
+		++Pos_;
+		return true;
+	}
+	return false;
+}
+
+inline bool DMSSimLabelCborReader::ReadString(StringValue& String) {
+	uint8_t Major = 0, Info = 0;
+	uint64_t Argument = 0;
+	return ReadHead(Major, Info, Argument) && ReadString(String, Major, Info, Argument);
+}
+
+inline bool DMSSimLabelCborReader::ReadString(StringValue& String, const uint8_t Major, const uint8_t Info, const uint64_t Argument) {
+	if (Major == DMSSimLabelFormat::MAJOR_TAG && Argument == DMSSimLabelFormat::TAG_STRINGREF) {
+		uint8_t IndexMajor = 0, IndexInfo = 0;
+		uint64_t Index;
+		if (!ReadHead(IndexMajor, IndexInfo, Index)) { return false; }
+		if (IndexMajor != DMSSimLabelFormat::MAJOR_UNSIGNED || Namespaces_.empty() || Index >= Namespaces_.back().size()) {
+			return Fail("invalid string reference");
+		}
+		String = Namespaces_.back()[Index];
+		return true;
+	}
+	if (Major != DMSSimLabelFormat::MAJOR_TEXT && Major != DMSSimLabelFormat::MAJOR_BYTES) { return Fail("string expected"); }
+	if (Info == DMSSimLabelFormat::INFO_INDEFINITE) { return Fail("strings of indefinite length are not supported"); }
+	if (Argument > Size_ - Pos_) { return Fail("unexpected end of file"); }
+	String = StringValue{ Major, reinterpret_cast<const char*>(Data_ + Pos_), size_t(Argument) };
+	Pos_ += size_t(Argument);
+	if (!Namespaces_.empty() && DMSSimLabelFormat::IsStringReferenced(String.Length, Namespaces_.back().size())) {
+		Namespaces_.back().push_back(String);
+	}
+	return true;
+}
+
+inline bool DMSSimLabelCborReader::ReadKey(StringValue& Key) {
+	uint8_t Major = 0, Info = 0;
+	uint64_t Argument = 0;
+	if (!ReadHead(Major, Info, Argument)) { return false; }
+	if (Major == DMSSimLabelFormat::MAJOR_UNSIGNED) {
+		if (Argument >= DMSSimLabelFormat::LABEL_KEY_COUNT) { return Fail("unknown key index"); }
+		const std::string_view Name = DMSSimLabelFormat::LABEL_KEYS[Argument];
+		Key = StringValue{ DMSSimLabelFormat::MAJOR_TEXT, Name.data(), Name.size() };
+		return true;
+	}
+	if (!ReadString(Key, Major, Info, Argument)) { return false; }
+	return Key.Major == DMSSimLabelFormat::MAJOR_TEXT || Fail("text key expected");
+}
+
+inline bool DMSSimLabelCborReader::EnterMap() {
+	uint8_t Major = 0, Info = 0;
+	uint64_t Argument = 0;
+	if (!ReadHead(Major, Info, Argument)) { return false; }
+	if (Major == DMSSimLabelFormat::MAJOR_TAG && Argument == DMSSimLabelFormat::TAG_SELF_DESCRIBED) { return EnterMap(); }
+	if (Major != DMSSimLabelFormat::MAJOR_MAP) { return Fail("map expected"); }
+	Maps_.push_back(Argument);
+	return true;
+}
+
+inline bool DMSSimLabelCborReader::NextKey(std::string& Key) {
+	if (Maps_.empty() || HasError()) { return false; }
+	uint64_t& Remaining = Maps_.back();
+	if (Remaining == INDEFINITE ? PeekBreak() : Remaining == 0) {
+		Maps_.pop_back();
+		return false;
+	}
+	if (Remaining != INDEFINITE) { --Remaining; }
+	StringValue String;
+	if (!ReadKey(String)) { return false; }
+	Key.assign(String.Data, String.Length);
+	return true;
+}
+
+template <typename Handler>
+bool DMSSimLabelCborReader::ReadItem(Handler& Out, const int Depth) {
+	if (Depth > MAX_DEPTH) { return Fail("nested too deeply"); }
+	uint8_t Major = 0, Info = 0;
+	uint64_t Argument = 0;
+	if (!ReadHead(Major, Info, Argument)) { return false; }
+	switch (Major) {
+	case DMSSimLabelFormat::MAJOR_UNSIGNED:
+		return Out.Uint64(Argument) || Fail("rejected by the handler");
+	case DMSSimLabelFormat::MAJOR_NEGATIVE:
+		if (Argument > uint64_t(INT64_MAX)) { return Fail("integer out of range"); }
+		return Out.Int64(-1 - int64_t(Argument)) || Fail("rejected by the handler");
+	case DMSSimLabelFormat::MAJOR_BYTES:
+		return Fail("byte string outside of a typed array");
+	case DMSSimLabelFormat::MAJOR_TEXT: {
+		StringValue String;
+		if (!ReadString(String, Major, Info, Argument)) { return false; }
+		return Out.String(String.Data, static_cast<unsigned>(String.Length), true) || Fail("rejected by the handler");
+	}
+	case DMSSimLabelFormat::MAJOR_ARRAY: {
+		if (!Out.StartArray()) { return Fail("rejected by the handler"); }
+		unsigned Count = 0;
+		for (; Argument == INDEFINITE ? !PeekBreak() : Count < Argument; ++Count) {
+			if (!ReadItem(Out, Depth + 1)) { return false; }
+		}
+		return Out.EndArray(Count) || Fail("rejected by the handler");
+	}
+	case DMSSimLabelFormat::MAJOR_MAP: {
+		if (!Out.StartObject()) { return Fail("rejected by the handler"); }
+		unsigned Count = 0;
+		for (; Argument == INDEFINITE ? !PeekBreak() : Count < Argument; ++Count) {
+			StringValue Key;
+			if (!ReadKey(Key)) { return false; }
+			if (!Out.Key(Key.Data, static_cast<unsigned>(Key.Length), true)) { return Fail("rejected by the handler"); }
+			if (!ReadItem(Out, Depth + 1)) { return false; }
+		}
+		return Out.EndObject(Count) || Fail("rejected by the handler");
+	}
+	case DMSSimLabelFormat::MAJOR_TAG:
+		switch (Argument) {
+		case DMSSimLabelFormat::TAG_SELF_DESCRIBED:
+			return ReadItem(Out, Depth);
+		case DMSSimLabelFormat::TAG_STRINGREF_NAMESPACE: {
+			Namespaces_.emplace_back();
+			const bool Read = ReadItem(Out, Depth + 1);
+			Namespaces_.pop_back();
+			return Read;
+		}
+		case DMSSimLabelFormat::TAG_STRINGREF: {
+			StringValue String;
+			if (!ReadString(String, Major, Info, Argument)) { return false; }
+			if (String.Major != DMSSimLabelFormat::MAJOR_TEXT) { return Fail("byte string outside of a typed array"); }
+			return Out.String(String.Data, static_cast<unsigned>(String.Length), true) || Fail("rejected by the handler");
+		}
+		case DMSSimLabelFormat::TAG_INT32_ARRAY:
+		case DMSSimLabelFormat::TAG_FLOAT32_ARRAY:
+			return ReadTypedArray(Out, Argument);
+		default:
+			return Fail("unsupported tag");
+		}
+	default: // MAJOR_SIMPLE
+		switch (Info) {
+		case DMSSimLabelFormat::SIMPLE_FALSE & 0x1F: return Out.Bool(false) || Fail("rejected by the handler");
+		case DMSSimLabelFormat::SIMPLE_TRUE & 0x1F: return Out.Bool(true) || Fail("rejected by the handler");
+		case DMSSimLabelFormat::SIMPLE_NULL & 0x1F: return Out.Null() || Fail("rejected by the handler");
+		case DMSSimLabelFormat::FLOAT32 & 0x1F: {
+			const uint32_t Bits = static_cast<uint32_t>(Argument);
+			float Value;
+			std::memcpy(&Value, &Bits, sizeof(Value));
+			return Out.Double(Value) || Fail("rejected by the handler");
+		}
+		case DMSSimLabelFormat::FLOAT64 & 0x1F: {
+			double Value;
+			std::memcpy(&Value, &Argument, sizeof(Value));
+			return Out.Double(Value) || Fail("rejected by the handler");
+		}
+		default:
+			return Fail("unsupported simple value");
+		}
+	}
+}
+
+template <typename Handler>
+bool DMSSimLabelCborReader::ReadTypedArray(Handler& Out, const uint64_t Tag) {
+	StringValue Bytes;
+	if (!ReadString(Bytes)) { return false; }
+	if (Bytes.Major != DMSSimLabelFormat::MAJOR_BYTES || Bytes.Length % 4 != 0) { return Fail("invalid typed array"); }
+	if (!Out.StartArray()) { return Fail("rejected by the handler"); }
+	const auto* const Values = reinterpret_cast<const uint8_t*>(Bytes.Data);
+	const size_t Count = Bytes.Length / 4;
+	for (size_t i = 0; i < Count; ++i) {
+		const uint32_t Bits = uint32_t(Values[4 * i]) | uint32_t(Values[4 * i + 1]) << 8 | uint32_t(Values[4 * i + 2]) << 16 | uint32_t(Values[4 * i + 3]) << 24;
+		bool Accepted;
+		if (Tag == DMSSimLabelFormat::TAG_FLOAT32_ARRAY) {
+			float Value;
+			std::memcpy(&Value, &Bits, sizeof(Value));
+			Accepted = Out.Double(Value);
+		}
+		else { Accepted = Out.Int(static_cast<int>(static_cast<int32_t>(Bits))); }
+		if (!Accepted) { return Fail("rejected by the handler"); }
+	}
+	return Out.EndArray(static_cast<unsigned>(Count)) || Fail("rejected by the handler");
+}
@@ -0,0 +1,91 @@
+#include "DMSSimLabelConvert.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <utility>
+#include <vector>
+#include "DMSSimLabelCborReader.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+namespace DMSSimLabelConvert {
+
+bool CborToJson(const std::string& Cbor, std::ostream& Json, std::string& Error) {
+	DMSSimLabelCborReader Reader(Cbor.data(), Cbor.size());
+	rapidjson::OStreamWrapper Stream(Json);
+	rapidjson::Writer<rapidjson::OStreamWrapper> Writer(Stream);
+	if (!Reader.ReadValue(Writer)) {
+		Error = Reader.GetError();
+		return false;
+	}
+	if (!Reader.AtEnd()) {
+		Error = "data after the labels";
+		return false;
+	}
+	return true;
+}
+
+bool CborToFrameFiles(const std::string& Cbor, const std::string& BaseFileName, std::string& Error) {
+	DMSSimLabelCborReader Reader(Cbor.data(), Cbor.size());
+	std::string Key;
+	if (!Reader.EnterMap() || !Reader.NextKey(Key) || Key != "openlabel" || !Reader.EnterMap()) {
+		Error = Reader.HasError() ? Reader.GetError() : "openlabel expected";
+		return false;
+	}
+
+	// the sections of the scenario precede the frames
+	std::vector<std::pair<std::string, rapidjson::Document>> Sections;
+	while (Reader.NextKey(Key) && Key != "frames") {
+		rapidjson::Document Section;
+		auto Read = [&Reader](rapidjson::Document& Handler) { return Reader.ReadValue(Handler); };
+		Section.Populate(Read);
+		if (Reader.HasError()) { break; }
+		Sections.emplace_back(Key, std::move(Section));
+	}
+	if (Key != "frames" || !Reader.EnterMap()) {
+		Error = Reader.HasError() ? Reader.GetError() : "frames expected";
+		return false;
+	}
+
+	rapidjson::StringBuffer Json;
+	rapidjson::PrettyWriter<rapidjson::StringBuffer> Writer(Json);
+	std::string FrameKey;
+	while (Reader.NextKey(FrameKey)) {
+		Json.Clear();
+		Writer.Reset(Json);
+		Writer.StartObject();
+		Writer.Key("openlabel");
+		Writer.StartObject();
+		for (const auto& Section : Sections) {
+			Writer.Key(Section.first.c_str(), static_cast<rapidjson::SizeType>(Section.first.size()));
+			Section.second.Accept(Writer);
+		}
+		Writer.Key("frames");
+		Writer.StartObject();
+		Writer.Key("0");
+		if (!Reader.ReadValue(Writer)) { break; }
+		Writer.EndObject();
+		Writer.EndObject();
+		Writer.EndObject();
+
+		char FileName[16];
+		std::snprintf(FileName, sizeof(FileName), "_%05d.json", std::atoi(FrameKey.c_str()));
+		std::ofstream File(BaseFileName + FileName, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+		File.write(Json.GetString(), static_cast<std::streamsize>(Json.GetSize()));
+		if (!File) {
+			Error = "can't write " + BaseFileName + FileName;
+			return false;
+		}
+	}
+	if (Reader.HasError()) {
+		Error = Reader.GetError();
+		return false;
+	}
+	return true;
+}
+
+} // namespace DMSSimLabelConvert
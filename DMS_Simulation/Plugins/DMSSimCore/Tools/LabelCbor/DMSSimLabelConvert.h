@@ -0,0 +1,24 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+/**
+ * @brief Conversion of the binary OpenLABEL file (*.cbor) of DMSSimImageLabelerCborImpl to the json of DMSSimImageLabelerImpl.
+ * The json is the same byte for byte as the one the labeler writes for the same frames, as the floats are restored exactly.
+ */
+namespace DMSSimLabelConvert {
+	/**
+	 * Writes the labels as the single compact file of the streaming mode, label_mode: stream.
+	 *
+	 * @param[out] Error The reason of the failure, e.g. a truncated file
+	 * @return false, if the file can't be read.
+	 */
+	bool CborToJson(const std::string& Cbor, std::ostream& Json, std::string& Error);
+
+	/**
+	 * Writes the labels as the pretty printed files of the default mode, one <BaseFileName>_<FrameIdx>.json per frame
+	 * with the sections of the scenario repeated in every file.
+	 */
+	bool CborToFrameFiles(const std::string& Cbor, const std::string& BaseFileName, std::string& Error);
+} // namespace DMSSimLabelConvert
@@ -0,0 +1,47 @@
+// Converts the binary OpenLABEL file of the openlabel_cbor sink to the json of the labeler:
+//
+//   DMSSimLabelConvert Sim_Scenario_0001.cbor Sim_Scenario_0001.json          the file of label_mode: stream
+//   DMSSimLabelConvert --frames Sim_Scenario_0001.cbor Sim_Scenario_0001      Sim_Scenario_0001_00000.json, ... a file per frame
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "DMSSimLabelConvert.h"
+
+int main(int argc, char** argv) {
+	const bool Frames = argc == 4 && std::string(argv[1]) == "--frames";
+	if (argc != 3 && !Frames) {
+		std::fprintf(stderr, "Usage: %s [--frames] <input.cbor> <output.json|output base name>\n", argv[0]);
+		return 2;
+	}
+	const std::string Input = argv[Frames ? 2 : 1];
+	const std::string Output = argv[Frames ? 3 : 2];
+
+	std::ifstream File(Input, std::ios_base::in | std::ios_base::binary);
+	if (!File) {
+		std::fprintf(stderr, "Can't open %s\n", Input.c_str());
+		return 1;
+	}
+	std::stringstream Cbor;
+	Cbor << File.rdbuf();
+
+	std::string Error;
+	if (Frames) {
+		if (!DMSSimLabelConvert::CborToFrameFiles(Cbor.str(), Output, Error)) {
+			std::fprintf(stderr, "%s: %s\n", Input.c_str(), Error.c_str());
+			return 1;
+		}
+		return 0;
+	}
+	std::ofstream Json(Output, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+	if (!DMSSimLabelConvert::CborToJson(Cbor.str(), Json, Error)) {
+		std::fprintf(stderr, "%s: %s\n", Input.c_str(), Error.c_str());
+		return 1;
+	}
+	if (!Json) {
+		std::fprintf(stderr, "Can't write %s\n", Output.c_str());
+		return 1;
+	}
+	return 0;
+}
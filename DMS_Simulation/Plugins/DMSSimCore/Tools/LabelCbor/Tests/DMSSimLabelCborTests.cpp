@@ -0,0 +1,94 @@
+#include "DMSSimImageLabeler.h"
+#include "DMSSimLabelConvert.h"
+#include "DMSSimLabelWriter.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/DMSSimLabelTestUtils.h"
+#include <filesystem>
+#include <sstream>
+#include <string>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace {
+
+constexpr int FRAME_COUNT = 12;
+constexpr int WRITER_THREADS = 2;
+
+/** A driver with landmarks, directions and openings that differ per frame. */
+TSharedPtr<DMSSimGroundTruthFrame> MakeFrame(const DMSSimGroundTruthScenarioConstantsPtr& Scenario, const int FrameIndex) {
+	return DMSSimLabelTestUtils::MakeFrame(Scenario, [FrameIndex](DMSSimGroundTruthOccupant& Driver) {
+		const float Offset = 0.37f * FrameIndex;
+		for (int i = 0; i < MAX_FACIAL_LANDMARKS; ++i) {
+			Driver.FacialLandmarksVisible[i] = (i + FrameIndex) % 3 != 0;
+			Driver.FacialLandmarks2D[i] = FVector2D(310.4f + 3.1f * i + Offset, 220.7f - 1.3f * i);
+		}
+		for (int i = 0; i < MAX_PUPIL_IRIS_LANDMARKS; ++i) {
+			Driver.LeftEyePupilLandmarks2D[i] = FVector2D(400.2f + i, 250.9f + Offset);
+			Driver.RightEyePupilLandmarks2D[i] = FVector2D(350.6f + i, 251.3f - Offset);
+		}
+		Driver.HeadDirection_inCam = FVector(0.1f * FrameIndex, -0.25f, 1.0f / 3.0f);
+		Driver.HeadDirection_inCar = FVector(-0.9f, 0.1f + 0.01f * FrameIndex, 0.2f);
+		Driver.HeadRotation_inCam = FRotator(1.5f, -3.25f + Offset, 7.125f);
+		Driver.LeftGazeOrigin_inCam = FVector(-3.1f, 64.2f + Offset, 2.7f);
+		Driver.RightGazeOrigin_inCam = FVector(3.3f, 64.1f, 2.9f - Offset);
+		Driver.LeftEyeOpening = 0.9f - 0.01f * FrameIndex;
+		Driver.RightEyeOpening = 0.87f;
+		Driver.RightEyePupilVisibilityPerc = 0.1f * (FrameIndex % 10);
+	});
+}
+
+std::string FrameFileName(const std::filesystem::path& Directory, const char* const BaseName, const int FrameIndex) {
+	char Suffix[16];
+	std::snprintf(Suffix, sizeof(Suffix), "_%05d.json", FrameIndex);
+	return (Directory / (std::string(BaseName) + Suffix)).string();
+}
+
+} // anonymous namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimLabelCborTest, "DMSSim.LabelCbor.RoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool DMSSimLabelCborTest::RunTest(const FString& Parameters)
+{
+	const auto Directory = std::filesystem::temp_directory_path() / "DMSSimLabelCborTest";
+	std::filesystem::remove_all(Directory);
+	std::filesystem::create_directories(Directory);
+	const std::wstring StreamBaseName = (Directory / "stream").wstring();
+	const std::wstring FramesBaseName = (Directory / "frames").wstring();
+
+	// the json and the CBOR of the same frames, serialized by the worker pool
+	const DMSSimGroundTruthScenarioConstantsPtr Scenario = DMSSimLabelTestUtils::MakeScenario();
+	{
+		DMSSimLabelWriter Writer(StreamBaseName, DMSSimLabelWriter::OpenLabel | DMSSimLabelWriter::OpenLabelCbor, true, WRITER_THREADS);
+		for (int i = 0; i < FRAME_COUNT; ++i) { Writer.AddFrame(MakeFrame(Scenario, i), MakeFrame(Scenario, i + 1), i); }
+		Writer.Finalize();
+	}
+	{
+		DMSSimImageLabelerImpl Labeler(FramesBaseName);
+		for (int i = 0; i < FRAME_COUNT; ++i) { Labeler.AddFrame(MakeFrame(Scenario, i), MakeFrame(Scenario, i + 1), i); }
+	}
+	const std::string Json = DMSSimLabelTestUtils::ReadFile(Directory / "stream.json");
+	const std::string Cbor = DMSSimLabelTestUtils::ReadFile(Directory / (std::string("stream") + DMSSimLabelFormat::CBOR_EXTENSION));
+
+	std::stringstream JsonFromCbor;
+	std::string Error;
+	TestTrue(TEXT("CBOR to json"), DMSSimLabelConvert::CborToJson(Cbor, JsonFromCbor, Error));
+	TestTrue(TEXT("CBOR to json gives the streamed json"), !Json.empty() && JsonFromCbor.str() == Json);
+	TestTrue(TEXT("CBOR is less than half of the json"), !Cbor.empty() && Cbor.size() * 2 < Json.size());
+
+	TestTrue(TEXT("CBOR to frame files"), DMSSimLabelConvert::CborToFrameFiles(Cbor, (Directory / "converted").string(), Error));
+	int SameFrameFiles = 0;
+	for (int i = 0; i < FRAME_COUNT; ++i) {
+		const std::string Expected = DMSSimLabelTestUtils::ReadFile(FrameFileName(Directory, "frames", i));
+		SameFrameFiles += !Expected.empty() && DMSSimLabelTestUtils::ReadFile(FrameFileName(Directory, "converted", i)) == Expected;
+	}
+	TestEqual(TEXT("CBOR to frame files gives the json of every frame"), SameFrameFiles, FRAME_COUNT);
+
+	std::stringstream Truncated;
+	Error.clear();
+	TestFalse(TEXT("Truncated CBOR is rejected"), DMSSimLabelConvert::CborToJson(Cbor.substr(0, Cbor.size() / 2), Truncated, Error));
+	TestFalse(TEXT("Truncated CBOR error"), Error.empty());
+
+	std::filesystem::remove_all(Directory);
+	return true;
+}
+#endif //WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,34 @@
+// Reconstructs the frames of the delta OpenLABEL file of the openlabel_delta sink:
+//
+//   DMSSimLabelDeltaExpand Sim_Scenario_0001_delta.json Sim_Scenario_0001.json     every frame with all its labels
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "DMSSimLabelDeltaReader.h"
+
+int main(int argc, char** argv) {
+	if (argc != 3) {
+		std::fprintf(stderr, "Usage: %s <input_delta.json> <output.json>\n", argv[0]);
+		return 2;
+	}
+	const std::string Input = argv[1];
+	const std::string Output = argv[2];
+
+	std::ifstream File(Input, std::ios_base::in | std::ios_base::binary);
+	if (!File) {
+		std::fprintf(stderr, "Can't open %s\n", Input.c_str());
+		return 1;
+	}
+	std::stringstream Delta;
+	Delta << File.rdbuf();
+
+	std::string Error;
+	std::ofstream Json(Output, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+	if (!DMSSimLabelDeltaConvert::DeltaToJson(Delta.str(), Json, Error)) {
+		std::fprintf(stderr, "%s: %s\n", Input.c_str(), Error.c_str());
+		return 1;
+	}
+	return 0;
+}
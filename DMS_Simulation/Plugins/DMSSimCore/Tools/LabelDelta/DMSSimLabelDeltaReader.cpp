@@ -0,0 +1,178 @@
+#include "DMSSimLabelDeltaReader.h"
+#include <cstdlib>
+#include "DMSSimLabelDelta.h"
+
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/writer.h>
+
+namespace {
+
+template <typename TValue>
+bool IsSameMember(const TValue& Label, const rapidjson::Value& Other, const char* const Name) {
+	const auto Member = Label.FindMember(Name);
+	const auto OtherMember = Other.FindMember(Name);
+	if (Member == Label.MemberEnd() || OtherMember == Other.MemberEnd()) { return Member == Label.MemberEnd() && OtherMember == Other.MemberEnd(); }
+	return Member->value.IsString() && OtherMember->value.IsString() &&
+		std::string_view(Member->value.GetString(), Member->value.GetStringLength()) == std::string_view(OtherMember->value.GetString(), OtherMember->value.GetStringLength());
+}
+
+/** The member Name of the object, added as Default if it's missing. */
+DMSSimLabelDeltaReader::ViewValue& GetMember(DMSSimLabelDeltaReader::ViewValue& Object, const rapidjson::Value& Name, const rapidjson::Type Default, rapidjson::CrtAllocator& Allocator) {
+	auto Member = Object.FindMember(Name.GetString());
+	if (Member != Object.MemberEnd()) { return Member->value; }
+	Object.AddMember(DMSSimLabelDeltaReader::ViewValue(Name, Allocator), DMSSimLabelDeltaReader::ViewValue(Default), Allocator);
+	return (Object.MemberEnd() - 1)->value;
+}
+
+} // anonymous namespace
+
+bool DMSSimLabelDeltaReader::Open(const std::string& Json, std::string& Error) {
+	File_.Parse(Json.data(), Json.size());
+	if (File_.HasParseError() || !File_.IsObject()) {
+		Error = "no json at byte " + std::to_string(File_.GetErrorOffset());
+		return false;
+	}
+	const auto OpenLabel = File_.FindMember("openlabel");
+	if (OpenLabel == File_.MemberEnd() || !OpenLabel->value.IsObject()) {
+		Error = "openlabel expected";
+		return false;
+	}
+	const auto Metadata = OpenLabel->value.FindMember("metadata");
+	const auto Frames = OpenLabel->value.FindMember("frames");
+	if (Metadata == OpenLabel->value.MemberEnd() || !Metadata->value.IsObject() || !Metadata->value.HasMember(DMSSimLabelDelta::EPSILON_KEY)) {
+		Error = "no delta encoded labels, the metadata has no label_delta_epsilon";
+		return false;
+	}
+	if (Frames == OpenLabel->value.MemberEnd() || !Frames->value.IsObject()) {
+		Error = "frames expected";
+		return false;
+	}
+	Epsilon_ = Metadata->value[DMSSimLabelDelta::EPSILON_KEY].GetDouble();
+	NextFrame_ = Frames->value.MemberBegin();
+	EndFrame_ = Frames->value.MemberEnd();
+	FrameIndex_ = -1;
+
+	// the view starts with the labels of the objects, the frames only have them if they changed
+	View_.SetObject();
+	View_.AddMember("frame_properties", ViewValue(rapidjson::kObjectType), ViewAllocator_);
+	ViewValue ViewObjects(rapidjson::kObjectType);
+	const auto Objects = OpenLabel->value.FindMember("objects");
+	if (Objects != OpenLabel->value.MemberEnd() && Objects->value.IsObject()) {
+		for (const auto& Object : Objects->value.GetObject()) {
+			ViewValue ObjectData(rapidjson::kObjectType);
+			const auto Data = Object.value.FindMember("object_data");
+			if (Data != Object.value.MemberEnd() && Data->value.IsObject()) { ApplyLabels(ObjectData, Data->value); }
+			ViewValue ViewObject(rapidjson::kObjectType);
+			ViewObject.AddMember("object_data", ObjectData, ViewAllocator_);
+			ViewObjects.AddMember(ViewValue(Object.name, ViewAllocator_), ViewObject, ViewAllocator_);
+		}
+	}
+	View_.AddMember("objects", ViewObjects, ViewAllocator_);
+	return true;
+}
+
+bool DMSSimLabelDeltaReader::NextFrame() {
+	if (NextFrame_ == EndFrame_) { return false; }
+	const auto& Frame = *NextFrame_++;
+	FrameIndex_ = std::atoi(Frame.name.GetString());
+	if (!Frame.value.IsObject()) { return true; }
+
+	const auto Properties = Frame.value.FindMember("frame_properties");
+	if (Properties != Frame.value.MemberEnd() && Properties->value.IsObject()) {
+		auto& ViewProperties = View_["frame_properties"];
+		for (const auto& Property : Properties->value.GetObject()) {
+			GetMember(ViewProperties, Property.name, rapidjson::kNullType, ViewAllocator_) = ViewValue(Property.value, ViewAllocator_);
+		}
+	}
+
+	const auto Objects = Frame.value.FindMember("objects");
+	if (Objects != Frame.value.MemberEnd() && Objects->value.IsObject()) {
+		auto& ViewObjects = View_["objects"];
+		for (const auto& Object : Objects->value.GetObject()) {
+			const auto Data = Object.value.FindMember("object_data");
+			if (Data == Object.value.MemberEnd() || !Data->value.IsObject()) { continue; }
+			auto& ViewObject = GetMember(ViewObjects, Object.name, rapidjson::kObjectType, ViewAllocator_);
+			ApplyLabels(GetMember(ViewObject, rapidjson::Value("object_data"), rapidjson::kObjectType, ViewAllocator_), Data->value);
+		}
+	}
+	return true;
+}
+
+void DMSSimLabelDeltaReader::ApplyLabels(ViewValue& ObjectData, const rapidjson::Value& Changes) {
+	for (const auto& Typed : Changes.GetObject()) {
+		if (!Typed.value.IsArray()) { continue; }
+		auto& Labels = GetMember(ObjectData, Typed.name, rapidjson::kArrayType, ViewAllocator_);
+		for (const auto& Label : Typed.value.GetArray()) {
+			if (!Label.IsObject()) { continue; }
+			ViewValue* Existing = nullptr;
+			for (auto& Candidate : Labels.GetArray()) {
+				if (IsSameMember(Candidate, Label, "name") && IsSameMember(Candidate, Label, "coordinate_system")) {
+					Existing = &Candidate;
+					break;
+				}
+			}
+			if (!Existing) {
+				Labels.PushBack(ViewValue(Label, ViewAllocator_), ViewAllocator_);
+				continue;
+			}
+			const auto Value = Label.FindMember("val");
+			if (Value != Label.MemberEnd()) { GetMember(*Existing, Value->name, rapidjson::kNullType, ViewAllocator_) = ViewValue(Value->value, ViewAllocator_); }
+			const auto Attributes = Label.FindMember("attributes");
+			if (Attributes != Label.MemberEnd() && Attributes->value.IsObject()) {
+				ApplyAttributes(GetMember(*Existing, Attributes->name, rapidjson::kObjectType, ViewAllocator_), Attributes->value);
+			}
+		}
+	}
+}
+
+void DMSSimLabelDeltaReader::ApplyAttributes(ViewValue& Attributes, const rapidjson::Value& Changes) {
+	for (const auto& Typed : Changes.GetObject()) {
+		if (!Typed.value.IsArray()) { continue; }
+		auto& ViewTyped = GetMember(Attributes, Typed.name, rapidjson::kArrayType, ViewAllocator_);
+		for (const auto& Attribute : Typed.value.GetArray()) {
+			bool Replaced = false;
+			for (auto& Candidate : ViewTyped.GetArray()) {
+				if (!IsSameMember(Candidate, Attribute, "name")) { continue; }
+				Candidate = ViewValue(Attribute, ViewAllocator_);
+				Replaced = true;
+				break;
+			}
+			if (!Replaced) { ViewTyped.PushBack(ViewValue(Attribute, ViewAllocator_), ViewAllocator_); }
+		}
+	}
+}
+
+namespace DMSSimLabelDeltaConvert {
+
+bool DeltaToJson(const std::string& Delta, std::ostream& Json, std::string& Error) {
+	DMSSimLabelDeltaReader Reader;
+	if (!Reader.Open(Delta, Error)) { return false; }
+
+	rapidjson::OStreamWrapper Stream(Json);
+	rapidjson::Writer<rapidjson::OStreamWrapper> Writer(Stream);
+	Writer.StartObject();
+	Writer.Key("openlabel");
+	Writer.StartObject();
+	for (const auto& Section : Reader.GetOpenLabel().GetObject()) {
+		if (Section.name == "frames") { continue; }
+		Writer.Key(Section.name.GetString(), Section.name.GetStringLength());
+		Section.value.Accept(Writer);
+	}
+	Writer.Key("frames");
+	Writer.StartObject();
+	while (Reader.NextFrame()) {
+		const std::string Key = std::to_string(Reader.GetFrameIndex());
+		Writer.Key(Key.c_str(), static_cast<rapidjson::SizeType>(Key.size()));
+		Reader.GetFrame().Accept(Writer);
+	}
+	Writer.EndObject();
+	Writer.EndObject();
+	Writer.EndObject();
+	if (!Json) {
+		Error = "can't write the json";
+		return false;
+	}
+	return true;
+}
+
+} // namespace DMSSimLabelDeltaConvert
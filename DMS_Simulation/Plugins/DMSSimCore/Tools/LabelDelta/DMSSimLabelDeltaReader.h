@@ -0,0 +1,60 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+#include <rapidjson/allocators.h>
+#include <rapidjson/document.h>
+
+/**
+ * @class DMSSimLabelDeltaReader
+ * @brief Reconstructs the frames of the delta OpenLABEL file of DMSSimImageLabelerDeltaImpl, see DMSSimLabelDelta.h.
+ * The view of a frame has the frame properties and, for every object, the labels of its object data followed by the
+ * labels of the frames with the value they were last written with. Its values differ from the ones of the streamed json
+ * by at most the epsilon of the metadata. The frames are read in the order of the file.
+ */
+class DMSSimLabelDeltaReader
+{
+public:
+	using ViewValue = rapidjson::GenericValue<rapidjson::UTF8<>, rapidjson::CrtAllocator>;
+
+	/**
+	 * Parses the file, the reader is positioned before the first frame.
+	 * @param[out] Error The reason of the failure, e.g. a file that isn't delta encoded
+	 */
+	bool Open(const std::string& Json, std::string& Error);
+
+	/** Applies the changes of the next frame to the view, false after the last frame. */
+	bool NextFrame();
+
+	/** The key of the current frame, its index in the recording. */
+	int GetFrameIndex() const { return FrameIndex_; }
+
+	/** The current frame: { "frame_properties": ..., "objects": { "<i>": { "object_data": ... } } } */
+	const ViewValue& GetFrame() const { return View_; }
+
+	/** The sections of the file: metadata, coordinate_systems, streams, objects, frame_intervals. */
+	const rapidjson::Value& GetOpenLabel() const { return File_["openlabel"]; }
+
+	double GetEpsilon() const { return Epsilon_; }
+
+private:
+	void ApplyLabels(ViewValue& ObjectData, const rapidjson::Value& Changes);
+	void ApplyAttributes(ViewValue& Label, const rapidjson::Value& Changes);
+
+	rapidjson::Document                    File_;
+	rapidjson::CrtAllocator                ViewAllocator_; // the replaced values are freed, the view doesn't grow with the frames
+	ViewValue                              View_;
+	rapidjson::Value::ConstMemberIterator  NextFrame_;
+	rapidjson::Value::ConstMemberIterator  EndFrame_;
+	int                                    FrameIndex_ = -1;
+	double                                 Epsilon_ = 0.0;
+};
+
+namespace DMSSimLabelDeltaConvert {
+	/**
+	 * Writes the labels as the compact file of the streaming mode with the full view of every frame.
+	 * Unlike the streamed json, the frames also have the labels of the object data.
+	 */
+	bool DeltaToJson(const std::string& Delta, std::ostream& Json, std::string& Error);
+} // namespace DMSSimLabelDeltaConvert
@@ -0,0 +1,170 @@
+#include "DMSSimImageLabeler.h"
+#include "DMSSimLabelDeltaReader.h"
+#include "DMSSimLabelWriter.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/DMSSimLabelTestUtils.h"
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace {
+
+constexpr int FRAME_COUNT = 12;
+constexpr int WRITER_THREADS = 2;
+constexpr float EPSILON = 0.5f;
+
+/** A driver whose landmarks and directions move a little from frame to frame, the other labels stay the same. */
+TSharedPtr<DMSSimGroundTruthFrame> MakeFrame(const DMSSimGroundTruthScenarioConstantsPtr& Scenario, const int FrameIndex) {
+	return DMSSimLabelTestUtils::MakeFrame(Scenario, [FrameIndex](DMSSimGroundTruthOccupant& Driver) {
+		const float Offset = 0.37f * FrameIndex;
+		for (int i = 0; i < MAX_FACIAL_LANDMARKS; ++i) {
+			Driver.FacialLandmarksVisible[i] = i % 3 != 0 || FrameIndex < FRAME_COUNT / 2;
+			Driver.FacialLandmarks2D[i] = FVector2D(310.4f + 3.1f * i + Offset, 220.7f - 1.3f * i);
+			Driver.FacialLandmarks3D_inCam[i] = FVector(-4.2f + 0.1f * i, 60.3f, 1.7f - 0.05f * i);
+		}
+		for (int i = 0; i < MAX_PUPIL_IRIS_LANDMARKS; ++i) {
+			Driver.LeftEyePupilLandmarks2D[i] = FVector2D(400.2f + i, 250.9f + Offset);
+			Driver.RightEyePupilLandmarks2D[i] = FVector2D(350.6f + i, 251.3f);
+		}
+		Driver.HeadDirection_inCam = FVector(0.1f, -0.25f, 1.0f / 3.0f);
+		Driver.HeadDirection_inCar = FVector(-0.9f, 0.1f + 0.01f * FrameIndex, 0.2f);
+		Driver.HeadRotation_inCam = FRotator(1.5f, -3.25f + Offset, 7.125f);
+		Driver.LeftGazeOrigin_inCam = FVector(-3.1f, 64.2f, 2.7f);
+		Driver.RightGazeOrigin_inCam = FVector(3.3f, 64.1f, 2.9f);
+		Driver.LeftEyeOpening = Driver.RightEyeOpening = FrameIndex % 6 == 5 ? 0.1f : 0.87f;
+	});
+}
+
+/** Largest difference of the numbers of the values, infinity if anything else differs. */
+template <typename TValue>
+double MaxDifference(const rapidjson::Value& Expected, const TValue& Actual) {
+	constexpr double Different = std::numeric_limits<double>::infinity();
+	if (Expected.IsNumber() && Actual.IsNumber()) { return std::fabs(Expected.GetDouble() - Actual.GetDouble()); }
+	if (Expected.IsArray() && Actual.IsArray()) {
+		if (Expected.Size() != Actual.Size()) { return Different; }
+		double Max = 0.0;
+		for (rapidjson::SizeType i = 0; i < Expected.Size(); ++i) { Max = std::max(Max, MaxDifference(Expected[i], Actual[i])); }
+		return Max;
+	}
+	if (Expected.IsObject() && Actual.IsObject()) {
+		if (Expected.MemberCount() != Actual.MemberCount()) { return Different; }
+		double Max = 0.0;
+		for (const auto& Member : Expected.GetObject()) {
+			const auto Found = Actual.FindMember(Member.name.GetString());
+			if (Found == Actual.MemberEnd()) { return Different; }
+			Max = std::max(Max, MaxDifference(Member.value, Found->value));
+		}
+		return Max;
+	}
+	if (Expected.IsString() && Actual.IsString()) { return std::string(Expected.GetString()) == Actual.GetString() ? 0.0 : Different; }
+	return Expected.GetType() == Actual.GetType() && (Expected.IsNull() || (Expected.IsBool() && Expected.GetBool() == Actual.GetBool())) ? 0.0 : Different;
+}
+
+/** The labels of the objects by object, type, name and coordinate system. */
+template <typename TValue>
+void CollectLabels(const TValue& Objects, std::map<std::string, const TValue*>& Labels) {
+	for (const auto& Object : Objects.GetObject()) {
+		const auto Data = Object.value.FindMember("object_data");
+		if (Data == Object.value.MemberEnd()) { continue; }
+		for (const auto& Typed : Data->value.GetObject()) {
+			for (const auto& Label : Typed.value.GetArray()) {
+				std::string Key = std::string(Object.name.GetString()) + "/" + Typed.name.GetString() + "/" + Label["name"].GetString();
+				if (Label.HasMember("coordinate_system")) { Key += std::string("/") + Label["coordinate_system"].GetString(); }
+				Labels[Key] = &Label;
+			}
+		}
+	}
+}
+
+/**
+ * Reads the delta file and compares every frame with the one of the streamed json.
+ * @return the largest difference of a label value, infinity if a frame or label is missing
+ */
+double CompareFrames(const rapidjson::Document& Stream, const std::string& Delta, int& FrameCount) {
+	DMSSimLabelDeltaReader Reader;
+	std::string Error;
+	FrameCount = 0;
+	if (!Reader.Open(Delta, Error)) { return std::numeric_limits<double>::infinity(); }
+
+	std::map<std::string, const rapidjson::Value*> ObjectLabels;
+	CollectLabels(Stream["openlabel"]["objects"], ObjectLabels);
+	double Max = 0.0;
+	for (const auto& Frame : Stream["openlabel"]["frames"].GetObject()) {
+		if (!Reader.NextFrame() || Reader.GetFrameIndex() != std::atoi(Frame.name.GetString())) { return std::numeric_limits<double>::infinity(); }
+		++FrameCount;
+		std::map<std::string, const rapidjson::Value*> Expected = ObjectLabels;
+		CollectLabels(Frame.value["objects"], Expected);
+		std::map<std::string, const DMSSimLabelDeltaReader::ViewValue*> Actual;
+		CollectLabels(Reader.GetFrame()["objects"], Actual);
+		if (Expected.size() != Actual.size()) { return std::numeric_limits<double>::infinity(); }
+		for (const auto& Label : Expected) {
+			const auto Found = Actual.find(Label.first);
+			if (Found == Actual.end()) { return std::numeric_limits<double>::infinity(); }
+			Max = std::max(Max, MaxDifference(*Label.second, *Found->second));
+		}
+		// the timestamps are taken by every labeler on its own
+		const auto& Properties = Reader.GetFrame()["frame_properties"];
+		if (!Properties.HasMember("timestamp") || !Properties.HasMember("streams")) { return std::numeric_limits<double>::infinity(); }
+		Max = std::max(Max, MaxDifference(Frame.value["frame_properties"]["streams"], Properties["streams"]));
+	}
+	return Reader.NextFrame() ? std::numeric_limits<double>::infinity() : Max;
+}
+
+} // anonymous namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(DMSSimLabelDeltaTest, "DMSSim.LabelDelta.Reconstruct", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::SmokeFilter)
+
+bool DMSSimLabelDeltaTest::RunTest(const FString& Parameters)
+{
+	const auto Directory = std::filesystem::temp_directory_path() / "DMSSimLabelDeltaTest";
+	std::filesystem::remove_all(Directory);
+	std::filesystem::create_directories(Directory);
+	const std::wstring StreamBaseName = (Directory / "stream").wstring();
+	const std::wstring ApproximateBaseName = (Directory / "approximate").wstring();
+
+	// the streamed json and the exact delta of the same frames, serialized by the worker pool
+	const DMSSimGroundTruthScenarioConstantsPtr Scenario = DMSSimLabelTestUtils::MakeScenario();
+	{
+		DMSSimLabelWriter Writer(StreamBaseName, DMSSimLabelWriter::OpenLabel | DMSSimLabelWriter::OpenLabelDelta, true, WRITER_THREADS);
+		for (int i = 0; i < FRAME_COUNT; ++i) { Writer.AddFrame(MakeFrame(Scenario, i), MakeFrame(Scenario, i + 1), i); }
+		Writer.Finalize();
+	}
+	{
+		DMSSimImageLabelerDeltaImpl Labeler(ApproximateBaseName, EPSILON);
+		for (int i = 0; i < FRAME_COUNT; ++i) { Labeler.AddFrame(MakeFrame(Scenario, i), MakeFrame(Scenario, i + 1), i); }
+	}
+	const std::string Json = DMSSimLabelTestUtils::ReadFile(Directory / "stream.json");
+	const std::string Delta = DMSSimLabelTestUtils::ReadFile(Directory / (std::string("stream") + DMSSimLabelDelta::DELTA_SUFFIX + ".json"));
+	const std::string Approximate = DMSSimLabelTestUtils::ReadFile(Directory / (std::string("approximate") + DMSSimLabelDelta::DELTA_SUFFIX + ".json"));
+
+	rapidjson::Document Stream;
+	Stream.Parse(Json.data(), Json.size());
+	TestFalse(TEXT("Streamed json"), Stream.HasParseError());
+	if (Stream.HasParseError()) { return false; }
+
+	int FrameCount = 0;
+	TestEqual(TEXT("Delta frames are the streamed frames"), CompareFrames(Stream, Delta, FrameCount), 0.0);
+	TestEqual(TEXT("Delta frame count"), FrameCount, FRAME_COUNT);
+	const double MaxDifference = CompareFrames(Stream, Approximate, FrameCount);
+	TestTrue(TEXT("Delta frames within epsilon"), MaxDifference > 0.0 && MaxDifference <= EPSILON);
+	TestEqual(TEXT("Approximate delta frame count"), FrameCount, FRAME_COUNT);
+	TestTrue(TEXT("Delta is less than half of the json"), !Delta.empty() && Delta.size() * 2 < Json.size());
+	TestTrue(TEXT("Epsilon drops small changes"), !Approximate.empty() && Approximate.size() < Delta.size());
+
+	std::stringstream Expanded;
+	std::string Error;
+	TestTrue(TEXT("Delta to json"), DMSSimLabelDeltaConvert::DeltaToJson(Delta, Expanded, Error));
+	rapidjson::Document ExpandedJson;
+	ExpandedJson.Parse(Expanded.str().c_str());
+	TestTrue(TEXT("Expanded frames"), !ExpandedJson.HasParseError() && ExpandedJson["openlabel"]["frames"].MemberCount() == FRAME_COUNT);
+	TestFalse(TEXT("Streamed json is no delta"), DMSSimLabelDeltaConvert::DeltaToJson(Json, Expanded, Error));
+
+	std::filesystem::remove_all(Directory);
+	return true;
+}
+#endif //WITH_DEV_AUTOMATION_TESTS